@@ -0,0 +1,795 @@
+// Code generated by protoc-gen-go. DO NOT EDIT.
+// source: lte/protos/sessiond_state.proto
+
+package protos
+
+import (
+	fmt "fmt"
+	proto "github.com/golang/protobuf/proto"
+	timestamp "github.com/golang/protobuf/ptypes/timestamp"
+	math "math"
+)
+
+// Reference imports to suppress errors if they are not otherwise used.
+var _ = proto.Marshal
+var _ = fmt.Errorf
+var _ = math.Inf
+
+// This is a compile-time assertion to ensure that this generated file
+// is compatible with the proto package it is being compiled against.
+// A compilation error at this line likely means your copy of the
+// proto package needs to be updated.
+const _ = proto.ProtoPackageIsVersion3 // please upgrade the proto package
+
+// --------------------------------------------------------------------------
+// [sessiond] Credit of a charging grant or of a usage monitor
+// --------------------------------------------------------------------------
+type CreditRecord struct {
+	Reporting       bool            `protobuf:"varint,1,opt,name=reporting,proto3" json:"reporting,omitempty"`
+	CreditLimitType CreditLimitType `protobuf:"varint,2,opt,name=credit_limit_type,json=creditLimitType,proto3,enum=magma.lte.CreditLimitType" json:"credit_limit_type,omitempty"`
+	// Volume of each sessiond Bucket, indexed by the Bucket value
+	Buckets []uint64 `protobuf:"varint,3,rep,packed,name=buckets,proto3" json:"buckets,omitempty"`
+	// sessiond GrantTrackingType, -1 when unset
+	GrantTrackingType    int32         `protobuf:"varint,4,opt,name=grant_tracking_type,json=grantTrackingType,proto3" json:"grant_tracking_type,omitempty"`
+	ReceivedGrantedUnits *GrantedUnits `protobuf:"bytes,5,opt,name=received_granted_units,json=receivedGrantedUnits,proto3" json:"received_granted_units,omitempty"`
+	ReportLastCredit     bool          `protobuf:"varint,6,opt,name=report_last_credit,json=reportLastCredit,proto3" json:"report_last_credit,omitempty"`
+	TimeOfFirstUsage     uint64        `protobuf:"varint,7,opt,name=time_of_first_usage,json=timeOfFirstUsage,proto3" json:"time_of_first_usage,omitempty"`
+	TimeOfLastUsage      uint64        `protobuf:"varint,8,opt,name=time_of_last_usage,json=timeOfLastUsage,proto3" json:"time_of_last_usage,omitempty"`
+	// sessiond UsageRate
+	UsageRate            float64  `protobuf:"fixed64,9,opt,name=usage_rate,json=usageRate,proto3" json:"usage_rate,omitempty"`
+	UsageRateWindowStart uint64   `protobuf:"varint,10,opt,name=usage_rate_window_start,json=usageRateWindowStart,proto3" json:"usage_rate_window_start,omitempty"`
+	UsageRateWindowBytes uint64   `protobuf:"varint,11,opt,name=usage_rate_window_bytes,json=usageRateWindowBytes,proto3" json:"usage_rate_window_bytes,omitempty"`
+	XXX_NoUnkeyedLiteral struct{} `json:"-"`
+	XXX_unrecognized     []byte   `json:"-"`
+	XXX_sizecache        int32    `json:"-"`
+}
+
+func (m *CreditRecord) Reset()         { *m = CreditRecord{} }
+func (m *CreditRecord) String() string { return proto.CompactTextString(m) }
+func (*CreditRecord) ProtoMessage()    {}
+func (*CreditRecord) Descriptor() ([]byte, []int) {
+	return fileDescriptor_77a2e793a4c63ccd, []int{0}
+}
+
+func (m *CreditRecord) XXX_Unmarshal(b []byte) error {
+	return xxx_messageInfo_CreditRecord.Unmarshal(m, b)
+}
+func (m *CreditRecord) XXX_Marshal(b []byte, deterministic bool) ([]byte, error) {
+	return xxx_messageInfo_CreditRecord.Marshal(b, m, deterministic)
+}
+func (m *CreditRecord) XXX_Merge(src proto.Message) {
+	xxx_messageInfo_CreditRecord.Merge(m, src)
+}
+func (m *CreditRecord) XXX_Size() int {
+	return xxx_messageInfo_CreditRecord.Size(m)
+}
+func (m *CreditRecord) XXX_DiscardUnknown() {
+	xxx_messageInfo_CreditRecord.DiscardUnknown(m)
+}
+
+var xxx_messageInfo_CreditRecord proto.InternalMessageInfo
+
+func (m *CreditRecord) GetReporting() bool {
+	if m != nil {
+		return m.Reporting
+	}
+	return false
+}
+
+func (m *CreditRecord) GetCreditLimitType() CreditLimitType {
+	if m != nil {
+		return m.CreditLimitType
+	}
+	return CreditLimitType_FINITE
+}
+
+func (m *CreditRecord) GetBuckets() []uint64 {
+	if m != nil {
+		return m.Buckets
+	}
+	return nil
+}
+
+func (m *CreditRecord) GetGrantTrackingType() int32 {
+	if m != nil {
+		return m.GrantTrackingType
+	}
+	return 0
+}
+
+func (m *CreditRecord) GetReceivedGrantedUnits() *GrantedUnits {
+	if m != nil {
+		return m.ReceivedGrantedUnits
+	}
+	return nil
+}
+
+func (m *CreditRecord) GetReportLastCredit() bool {
+	if m != nil {
+		return m.ReportLastCredit
+	}
+	return false
+}
+
+func (m *CreditRecord) GetTimeOfFirstUsage() uint64 {
+	if m != nil {
+		return m.TimeOfFirstUsage
+	}
+	return 0
+}
+
+func (m *CreditRecord) GetTimeOfLastUsage() uint64 {
+	if m != nil {
+		return m.TimeOfLastUsage
+	}
+	return 0
+}
+
+func (m *CreditRecord) GetUsageRate() float64 {
+	if m != nil {
+		return m.UsageRate
+	}
+	return 0
+}
+
+func (m *CreditRecord) GetUsageRateWindowStart() uint64 {
+	if m != nil {
+		return m.UsageRateWindowStart
+	}
+	return 0
+}
+
+func (m *CreditRecord) GetUsageRateWindowBytes() uint64 {
+	if m != nil {
+		return m.UsageRateWindowBytes
+	}
+	return 0
+}
+
+type FinalActionRecord struct {
+	FinalAction          ChargingCredit_FinalAction `protobuf:"varint,1,opt,name=final_action,json=finalAction,proto3,enum=magma.lte.ChargingCredit_FinalAction" json:"final_action,omitempty"`
+	RedirectServer       *RedirectServer            `protobuf:"bytes,2,opt,name=redirect_server,json=redirectServer,proto3" json:"redirect_server,omitempty"`
+	RestrictRules        []string                   `protobuf:"bytes,3,rep,name=restrict_rules,json=restrictRules,proto3" json:"restrict_rules,omitempty"`
+	XXX_NoUnkeyedLiteral struct{}                   `json:"-"`
+	XXX_unrecognized     []byte                     `json:"-"`
+	XXX_sizecache        int32                      `json:"-"`
+}
+
+func (m *FinalActionRecord) Reset()         { *m = FinalActionRecord{} }
+func (m *FinalActionRecord) String() string { return proto.CompactTextString(m) }
+func (*FinalActionRecord) ProtoMessage()    {}
+func (*FinalActionRecord) Descriptor() ([]byte, []int) {
+	return fileDescriptor_77a2e793a4c63ccd, []int{1}
+}
+
+func (m *FinalActionRecord) XXX_Unmarshal(b []byte) error {
+	return xxx_messageInfo_FinalActionRecord.Unmarshal(m, b)
+}
+func (m *FinalActionRecord) XXX_Marshal(b []byte, deterministic bool) ([]byte, error) {
+	return xxx_messageInfo_FinalActionRecord.Marshal(b, m, deterministic)
+}
+func (m *FinalActionRecord) XXX_Merge(src proto.Message) {
+	xxx_messageInfo_FinalActionRecord.Merge(m, src)
+}
+func (m *FinalActionRecord) XXX_Size() int {
+	return xxx_messageInfo_FinalActionRecord.Size(m)
+}
+func (m *FinalActionRecord) XXX_DiscardUnknown() {
+	xxx_messageInfo_FinalActionRecord.DiscardUnknown(m)
+}
+
+var xxx_messageInfo_FinalActionRecord proto.InternalMessageInfo
+
+func (m *FinalActionRecord) GetFinalAction() ChargingCredit_FinalAction {
+	if m != nil {
+		return m.FinalAction
+	}
+	return ChargingCredit_TERMINATE
+}
+
+func (m *FinalActionRecord) GetRedirectServer() *RedirectServer {
+	if m != nil {
+		return m.RedirectServer
+	}
+	return nil
+}
+
+func (m *FinalActionRecord) GetRestrictRules() []string {
+	if m != nil {
+		return m.RestrictRules
+	}
+	return nil
+}
+
+// --------------------------------------------------------------------------
+// [sessiond] Gy credit of a session, keyed by rating group and service id
+// --------------------------------------------------------------------------
+type ChargingGrantRecord struct {
+	RatingGroup       uint32             `protobuf:"varint,1,opt,name=rating_group,json=ratingGroup,proto3" json:"rating_group,omitempty"`
+	ServiceIdentifier uint32             `protobuf:"varint,2,opt,name=service_identifier,json=serviceIdentifier,proto3" json:"service_identifier,omitempty"`
+	Credit            *CreditRecord      `protobuf:"bytes,3,opt,name=credit,proto3" json:"credit,omitempty"`
+	IsFinal           bool               `protobuf:"varint,4,opt,name=is_final,json=isFinal,proto3" json:"is_final,omitempty"`
+	FinalActionInfo   *FinalActionRecord `protobuf:"bytes,5,opt,name=final_action_info,json=finalActionInfo,proto3" json:"final_action_info,omitempty"`
+	// sessiond ReAuthState and ServiceState
+	ReauthState          uint32   `protobuf:"varint,6,opt,name=reauth_state,json=reauthState,proto3" json:"reauth_state,omitempty"`
+	ServiceState         uint32   `protobuf:"varint,7,opt,name=service_state,json=serviceState,proto3" json:"service_state,omitempty"`
+	ExpiryTime           int64    `protobuf:"varint,8,opt,name=expiry_time,json=expiryTime,proto3" json:"expiry_time,omitempty"`
+	Suspended            bool     `protobuf:"varint,9,opt,name=suspended,proto3" json:"suspended,omitempty"`
+	XXX_NoUnkeyedLiteral struct{} `json:"-"`
+	XXX_unrecognized     []byte   `json:"-"`
+	XXX_sizecache        int32    `json:"-"`
+}
+
+func (m *ChargingGrantRecord) Reset()         { *m = ChargingGrantRecord{} }
+func (m *ChargingGrantRecord) String() string { return proto.CompactTextString(m) }
+func (*ChargingGrantRecord) ProtoMessage()    {}
+func (*ChargingGrantRecord) Descriptor() ([]byte, []int) {
+	return fileDescriptor_77a2e793a4c63ccd, []int{2}
+}
+
+func (m *ChargingGrantRecord) XXX_Unmarshal(b []byte) error {
+	return xxx_messageInfo_ChargingGrantRecord.Unmarshal(m, b)
+}
+func (m *ChargingGrantRecord) XXX_Marshal(b []byte, deterministic bool) ([]byte, error) {
+	return xxx_messageInfo_ChargingGrantRecord.Marshal(b, m, deterministic)
+}
+func (m *ChargingGrantRecord) XXX_Merge(src proto.Message) {
+	xxx_messageInfo_ChargingGrantRecord.Merge(m, src)
+}
+func (m *ChargingGrantRecord) XXX_Size() int {
+	return xxx_messageInfo_ChargingGrantRecord.Size(m)
+}
+func (m *ChargingGrantRecord) XXX_DiscardUnknown() {
+	xxx_messageInfo_ChargingGrantRecord.DiscardUnknown(m)
+}
+
+var xxx_messageInfo_ChargingGrantRecord proto.InternalMessageInfo
+
+func (m *ChargingGrantRecord) GetRatingGroup() uint32 {
+	if m != nil {
+		return m.RatingGroup
+	}
+	return 0
+}
+
+func (m *ChargingGrantRecord) GetServiceIdentifier() uint32 {
+	if m != nil {
+		return m.ServiceIdentifier
+	}
+	return 0
+}
+
+func (m *ChargingGrantRecord) GetCredit() *CreditRecord {
+	if m != nil {
+		return m.Credit
+	}
+	return nil
+}
+
+func (m *ChargingGrantRecord) GetIsFinal() bool {
+	if m != nil {
+		return m.IsFinal
+	}
+	return false
+}
+
+func (m *ChargingGrantRecord) GetFinalActionInfo() *FinalActionRecord {
+	if m != nil {
+		return m.FinalActionInfo
+	}
+	return nil
+}
+
+func (m *ChargingGrantRecord) GetReauthState() uint32 {
+	if m != nil {
+		return m.ReauthState
+	}
+	return 0
+}
+
+func (m *ChargingGrantRecord) GetServiceState() uint32 {
+	if m != nil {
+		return m.ServiceState
+	}
+	return 0
+}
+
+func (m *ChargingGrantRecord) GetExpiryTime() int64 {
+	if m != nil {
+		return m.ExpiryTime
+	}
+	return 0
+}
+
+func (m *ChargingGrantRecord) GetSuspended() bool {
+	if m != nil {
+		return m.Suspended
+	}
+	return false
+}
+
+// --------------------------------------------------------------------------
+// [sessiond] Gx usage monitor of a session
+// --------------------------------------------------------------------------
+type MonitorRecord struct {
+	MonitoringKey        string          `protobuf:"bytes,1,opt,name=monitoring_key,json=monitoringKey,proto3" json:"monitoring_key,omitempty"`
+	Credit               *CreditRecord   `protobuf:"bytes,2,opt,name=credit,proto3" json:"credit,omitempty"`
+	Level                MonitoringLevel `protobuf:"varint,3,opt,name=level,proto3,enum=magma.lte.MonitoringLevel" json:"level,omitempty"`
+	XXX_NoUnkeyedLiteral struct{}        `json:"-"`
+	XXX_unrecognized     []byte          `json:"-"`
+	XXX_sizecache        int32           `json:"-"`
+}
+
+func (m *MonitorRecord) Reset()         { *m = MonitorRecord{} }
+func (m *MonitorRecord) String() string { return proto.CompactTextString(m) }
+func (*MonitorRecord) ProtoMessage()    {}
+func (*MonitorRecord) Descriptor() ([]byte, []int) {
+	return fileDescriptor_77a2e793a4c63ccd, []int{3}
+}
+
+func (m *MonitorRecord) XXX_Unmarshal(b []byte) error {
+	return xxx_messageInfo_MonitorRecord.Unmarshal(m, b)
+}
+func (m *MonitorRecord) XXX_Marshal(b []byte, deterministic bool) ([]byte, error) {
+	return xxx_messageInfo_MonitorRecord.Marshal(b, m, deterministic)
+}
+func (m *MonitorRecord) XXX_Merge(src proto.Message) {
+	xxx_messageInfo_MonitorRecord.Merge(m, src)
+}
+func (m *MonitorRecord) XXX_Size() int {
+	return xxx_messageInfo_MonitorRecord.Size(m)
+}
+func (m *MonitorRecord) XXX_DiscardUnknown() {
+	xxx_messageInfo_MonitorRecord.DiscardUnknown(m)
+}
+
+var xxx_messageInfo_MonitorRecord proto.InternalMessageInfo
+
+func (m *MonitorRecord) GetMonitoringKey() string {
+	if m != nil {
+		return m.MonitoringKey
+	}
+	return ""
+}
+
+func (m *MonitorRecord) GetCredit() *CreditRecord {
+	if m != nil {
+		return m.Credit
+	}
+	return nil
+}
+
+func (m *MonitorRecord) GetLevel() MonitoringLevel {
+	if m != nil {
+		return m.Level
+	}
+	return MonitoringLevel_SESSION_LEVEL
+}
+
+type BearerIDRecord struct {
+	// sessiond PolicyType
+	PolicyType           uint32   `protobuf:"varint,1,opt,name=policy_type,json=policyType,proto3" json:"policy_type,omitempty"`
+	RuleId               string   `protobuf:"bytes,2,opt,name=rule_id,json=ruleId,proto3" json:"rule_id,omitempty"`
+	BearerId             uint32   `protobuf:"varint,3,opt,name=bearer_id,json=bearerId,proto3" json:"bearer_id,omitempty"`
+	XXX_NoUnkeyedLiteral struct{} `json:"-"`
+	XXX_unrecognized     []byte   `json:"-"`
+	XXX_sizecache        int32    `json:"-"`
+}
+
+func (m *BearerIDRecord) Reset()         { *m = BearerIDRecord{} }
+func (m *BearerIDRecord) String() string { return proto.CompactTextString(m) }
+func (*BearerIDRecord) ProtoMessage()    {}
+func (*BearerIDRecord) Descriptor() ([]byte, []int) {
+	return fileDescriptor_77a2e793a4c63ccd, []int{4}
+}
+
+func (m *BearerIDRecord) XXX_Unmarshal(b []byte) error {
+	return xxx_messageInfo_BearerIDRecord.Unmarshal(m, b)
+}
+func (m *BearerIDRecord) XXX_Marshal(b []byte, deterministic bool) ([]byte, error) {
+	return xxx_messageInfo_BearerIDRecord.Marshal(b, m, deterministic)
+}
+func (m *BearerIDRecord) XXX_Merge(src proto.Message) {
+	xxx_messageInfo_BearerIDRecord.Merge(m, src)
+}
+func (m *BearerIDRecord) XXX_Size() int {
+	return xxx_messageInfo_BearerIDRecord.Size(m)
+}
+func (m *BearerIDRecord) XXX_DiscardUnknown() {
+	xxx_messageInfo_BearerIDRecord.DiscardUnknown(m)
+}
+
+var xxx_messageInfo_BearerIDRecord proto.InternalMessageInfo
+
+func (m *BearerIDRecord) GetPolicyType() uint32 {
+	if m != nil {
+		return m.PolicyType
+	}
+	return 0
+}
+
+func (m *BearerIDRecord) GetRuleId() string {
+	if m != nil {
+		return m.RuleId
+	}
+	return ""
+}
+
+func (m *BearerIDRecord) GetBearerId() uint32 {
+	if m != nil {
+		return m.BearerId
+	}
+	return 0
+}
+
+// --------------------------------------------------------------------------
+// [sessiond] Session, as marshaled by SessionState
+// --------------------------------------------------------------------------
+type SessionRecord struct {
+	// sessiond SessionFsmState
+	FsmState              uint32                     `protobuf:"varint,1,opt,name=fsm_state,json=fsmState,proto3" json:"fsm_state,omitempty"`
+	CommonContext         *CommonSessionContext      `protobuf:"bytes,2,opt,name=common_context,json=commonContext,proto3" json:"common_context,omitempty"`
+	RatSpecificContext    *RatSpecificContext        `protobuf:"bytes,3,opt,name=rat_specific_context,json=ratSpecificContext,proto3" json:"rat_specific_context,omitempty"`
+	ChargingGrants        []*ChargingGrantRecord     `protobuf:"bytes,4,rep,name=charging_grants,json=chargingGrants,proto3" json:"charging_grants,omitempty"`
+	Monitors              []*MonitorRecord           `protobuf:"bytes,5,rep,name=monitors,proto3" json:"monitors,omitempty"`
+	SessionLevelKey       string                     `protobuf:"bytes,6,opt,name=session_level_key,json=sessionLevelKey,proto3" json:"session_level_key,omitempty"`
+	Imsi                  string                     `protobuf:"bytes,7,opt,name=imsi,proto3" json:"imsi,omitempty"`
+	SessionId             string                     `protobuf:"bytes,8,opt,name=session_id,json=sessionId,proto3" json:"session_id,omitempty"`
+	LocalTeid             uint32                     `protobuf:"varint,9,opt,name=local_teid,json=localTeid,proto3" json:"local_teid,omitempty"`
+	SubscriberQuotaState  SubscriberQuotaUpdate_Type `protobuf:"varint,10,opt,name=subscriber_quota_state,json=subscriberQuotaState,proto3,enum=magma.lte.SubscriberQuotaUpdate_Type" json:"subscriber_quota_state,omitempty"`
+	CreateSessionResponse *CreateSessionResponse     `protobuf:"bytes,11,opt,name=create_session_response,json=createSessionResponse,proto3" json:"create_session_response,omitempty"`
+	TgppContext           *TgppContext               `protobuf:"bytes,12,opt,name=tgpp_context,json=tgppContext,proto3" json:"tgpp_context,omitempty"`
+	PdpStartTime          uint64                     `protobuf:"varint,13,opt,name=pdp_start_time,json=pdpStartTime,proto3" json:"pdp_start_time,omitempty"`
+	PdpEndTime            uint64                     `protobuf:"varint,14,opt,name=pdp_end_time,json=pdpEndTime,proto3" json:"pdp_end_time,omitempty"`
+	// EventTrigger to sessiond EventTriggerState
+	PendingEventTriggers map[int32]uint32     `protobuf:"bytes,15,rep,name=pending_event_triggers,json=pendingEventTriggers,proto3" json:"pending_event_triggers,omitempty" protobuf_key:"varint,1,opt,name=key,proto3" protobuf_val:"varint,2,opt,name=value,proto3"`
+	RevalidationTime     *timestamp.Timestamp `protobuf:"bytes,16,opt,name=revalidation_time,json=revalidationTime,proto3" json:"revalidation_time,omitempty"`
+	BearerIdByPolicy     []*BearerIDRecord    `protobuf:"bytes,17,rep,name=bearer_id_by_policy,json=bearerIdByPolicy,proto3" json:"bearer_id_by_policy,omitempty"`
+	StaticRuleIds        []string             `protobuf:"bytes,18,rep,name=static_rule_ids,json=staticRuleIds,proto3" json:"static_rule_ids,omitempty"`
+	DynamicRules         []*PolicyRule        `protobuf:"bytes,19,rep,name=dynamic_rules,json=dynamicRules,proto3" json:"dynamic_rules,omitempty"`
+	GyDynamicRules       []*PolicyRule        `protobuf:"bytes,20,rep,name=gy_dynamic_rules,json=gyDynamicRules,proto3" json:"gy_dynamic_rules,omitempty"`
+	RequestNumber        uint32               `protobuf:"varint,21,opt,name=request_number,json=requestNumber,proto3" json:"request_number,omitempty"`
+	XXX_NoUnkeyedLiteral struct{}             `json:"-"`
+	XXX_unrecognized     []byte               `json:"-"`
+	XXX_sizecache        int32                `json:"-"`
+}
+
+func (m *SessionRecord) Reset()         { *m = SessionRecord{} }
+func (m *SessionRecord) String() string { return proto.CompactTextString(m) }
+func (*SessionRecord) ProtoMessage()    {}
+func (*SessionRecord) Descriptor() ([]byte, []int) {
+	return fileDescriptor_77a2e793a4c63ccd, []int{5}
+}
+
+func (m *SessionRecord) XXX_Unmarshal(b []byte) error {
+	return xxx_messageInfo_SessionRecord.Unmarshal(m, b)
+}
+func (m *SessionRecord) XXX_Marshal(b []byte, deterministic bool) ([]byte, error) {
+	return xxx_messageInfo_SessionRecord.Marshal(b, m, deterministic)
+}
+func (m *SessionRecord) XXX_Merge(src proto.Message) {
+	xxx_messageInfo_SessionRecord.Merge(m, src)
+}
+func (m *SessionRecord) XXX_Size() int {
+	return xxx_messageInfo_SessionRecord.Size(m)
+}
+func (m *SessionRecord) XXX_DiscardUnknown() {
+	xxx_messageInfo_SessionRecord.DiscardUnknown(m)
+}
+
+var xxx_messageInfo_SessionRecord proto.InternalMessageInfo
+
+func (m *SessionRecord) GetFsmState() uint32 {
+	if m != nil {
+		return m.FsmState
+	}
+	return 0
+}
+
+func (m *SessionRecord) GetCommonContext() *CommonSessionContext {
+	if m != nil {
+		return m.CommonContext
+	}
+	return nil
+}
+
+func (m *SessionRecord) GetRatSpecificContext() *RatSpecificContext {
+	if m != nil {
+		return m.RatSpecificContext
+	}
+	return nil
+}
+
+func (m *SessionRecord) GetChargingGrants() []*ChargingGrantRecord {
+	if m != nil {
+		return m.ChargingGrants
+	}
+	return nil
+}
+
+func (m *SessionRecord) GetMonitors() []*MonitorRecord {
+	if m != nil {
+		return m.Monitors
+	}
+	return nil
+}
+
+func (m *SessionRecord) GetSessionLevelKey() string {
+	if m != nil {
+		return m.SessionLevelKey
+	}
+	return ""
+}
+
+func (m *SessionRecord) GetImsi() string {
+	if m != nil {
+		return m.Imsi
+	}
+	return ""
+}
+
+func (m *SessionRecord) GetSessionId() string {
+	if m != nil {
+		return m.SessionId
+	}
+	return ""
+}
+
+func (m *SessionRecord) GetLocalTeid() uint32 {
+	if m != nil {
+		return m.LocalTeid
+	}
+	return 0
+}
+
+func (m *SessionRecord) GetSubscriberQuotaState() SubscriberQuotaUpdate_Type {
+	if m != nil {
+		return m.SubscriberQuotaState
+	}
+	return SubscriberQuotaUpdate_VALID_QUOTA
+}
+
+func (m *SessionRecord) GetCreateSessionResponse() *CreateSessionResponse {
+	if m != nil {
+		return m.CreateSessionResponse
+	}
+	return nil
+}
+
+func (m *SessionRecord) GetTgppContext() *TgppContext {
+	if m != nil {
+		return m.TgppContext
+	}
+	return nil
+}
+
+func (m *SessionRecord) GetPdpStartTime() uint64 {
+	if m != nil {
+		return m.PdpStartTime
+	}
+	return 0
+}
+
+func (m *SessionRecord) GetPdpEndTime() uint64 {
+	if m != nil {
+		return m.PdpEndTime
+	}
+	return 0
+}
+
+func (m *SessionRecord) GetPendingEventTriggers() map[int32]uint32 {
+	if m != nil {
+		return m.PendingEventTriggers
+	}
+	return nil
+}
+
+func (m *SessionRecord) GetRevalidationTime() *timestamp.Timestamp {
+	if m != nil {
+		return m.RevalidationTime
+	}
+	return nil
+}
+
+func (m *SessionRecord) GetBearerIdByPolicy() []*BearerIDRecord {
+	if m != nil {
+		return m.BearerIdByPolicy
+	}
+	return nil
+}
+
+func (m *SessionRecord) GetStaticRuleIds() []string {
+	if m != nil {
+		return m.StaticRuleIds
+	}
+	return nil
+}
+
+func (m *SessionRecord) GetDynamicRules() []*PolicyRule {
+	if m != nil {
+		return m.DynamicRules
+	}
+	return nil
+}
+
+func (m *SessionRecord) GetGyDynamicRules() []*PolicyRule {
+	if m != nil {
+		return m.GyDynamicRules
+	}
+	return nil
+}
+
+func (m *SessionRecord) GetRequestNumber() uint32 {
+	if m != nil {
+		return m.RequestNumber
+	}
+	return 0
+}
+
+// --------------------------------------------------------------------------
+// [sessiond] Sessions of a subscriber, value of the sessiond:sessions hash.
+// Also the value of each field of the hash of a session, with the part of
+// the session the field holds.
+// --------------------------------------------------------------------------
+type SessionRecords struct {
+	// Encoding version, bumped when a change can't be read by older sessiond
+	Version  uint32           `protobuf:"varint,1,opt,name=version,proto3" json:"version,omitempty"`
+	Sessions []*SessionRecord `protobuf:"bytes,2,rep,name=sessions,proto3" json:"sessions,omitempty"`
+	// Sessions stored in a hash of their own, <sessions table>:<session id>,
+	// since version 2
+	SessionIds           []string `protobuf:"bytes,3,rep,name=session_ids,json=sessionIds,proto3" json:"session_ids,omitempty"`
+	XXX_NoUnkeyedLiteral struct{} `json:"-"`
+	XXX_unrecognized     []byte   `json:"-"`
+	XXX_sizecache        int32    `json:"-"`
+}
+
+func (m *SessionRecords) Reset()         { *m = SessionRecords{} }
+func (m *SessionRecords) String() string { return proto.CompactTextString(m) }
+func (*SessionRecords) ProtoMessage()    {}
+func (*SessionRecords) Descriptor() ([]byte, []int) {
+	return fileDescriptor_77a2e793a4c63ccd, []int{6}
+}
+
+func (m *SessionRecords) XXX_Unmarshal(b []byte) error {
+	return xxx_messageInfo_SessionRecords.Unmarshal(m, b)
+}
+func (m *SessionRecords) XXX_Marshal(b []byte, deterministic bool) ([]byte, error) {
+	return xxx_messageInfo_SessionRecords.Marshal(b, m, deterministic)
+}
+func (m *SessionRecords) XXX_Merge(src proto.Message) {
+	xxx_messageInfo_SessionRecords.Merge(m, src)
+}
+func (m *SessionRecords) XXX_Size() int {
+	return xxx_messageInfo_SessionRecords.Size(m)
+}
+func (m *SessionRecords) XXX_DiscardUnknown() {
+	xxx_messageInfo_SessionRecords.DiscardUnknown(m)
+}
+
+var xxx_messageInfo_SessionRecords proto.InternalMessageInfo
+
+func (m *SessionRecords) GetVersion() uint32 {
+	if m != nil {
+		return m.Version
+	}
+	return 0
+}
+
+func (m *SessionRecords) GetSessions() []*SessionRecord {
+	if m != nil {
+		return m.Sessions
+	}
+	return nil
+}
+
+func (m *SessionRecords) GetSessionIds() []string {
+	if m != nil {
+		return m.SessionIds
+	}
+	return nil
+}
+
+func init() {
+	proto.RegisterType((*CreditRecord)(nil), "magma.lte.CreditRecord")
+	proto.RegisterType((*FinalActionRecord)(nil), "magma.lte.FinalActionRecord")
+	proto.RegisterType((*ChargingGrantRecord)(nil), "magma.lte.ChargingGrantRecord")
+	proto.RegisterType((*MonitorRecord)(nil), "magma.lte.MonitorRecord")
+	proto.RegisterType((*BearerIDRecord)(nil), "magma.lte.BearerIDRecord")
+	proto.RegisterType((*SessionRecord)(nil), "magma.lte.SessionRecord")
+	proto.RegisterMapType((map[int32]uint32)(nil), "magma.lte.SessionRecord.PendingEventTriggersEntry")
+	proto.RegisterType((*SessionRecords)(nil), "magma.lte.SessionRecords")
+}
+
+func init() { proto.RegisterFile("lte/protos/sessiond_state.proto", fileDescriptor_77a2e793a4c63ccd) }
+
+var fileDescriptor_77a2e793a4c63ccd = []byte{
+	// 1396 bytes of a gzipped FileDescriptorProto
+	0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0xff, 0x8c, 0x56, 0xdf, 0x6f, 0x1b, 0x37,
+	0x12, 0x86, 0x2c, 0xff, 0x90, 0x46, 0xbf, 0x2c, 0xda, 0xb1, 0xd7, 0x4e, 0x72, 0xd6, 0xf9, 0x2e,
+	0x07, 0xe1, 0xee, 0x22, 0x1f, 0x7c, 0x77, 0xc0, 0x5d, 0x5e, 0x8a, 0x3a, 0x89, 0x1d, 0xa3, 0x49,
+	0x93, 0xd2, 0x0e, 0x5a, 0xb4, 0x0f, 0xc4, 0x6a, 0x77, 0xb4, 0x21, 0xb2, 0xda, 0xdd, 0x90, 0x94,
+	0x13, 0x3d, 0x16, 0xe8, 0x73, 0xdf, 0xfb, 0xde, 0x3f, 0xa6, 0x7f, 0x56, 0xc1, 0x21, 0x57, 0x5a,
+	0xc1, 0x6e, 0xd1, 0x27, 0x89, 0xdf, 0x7c, 0x33, 0x4b, 0xce, 0x7c, 0x9c, 0x21, 0x1c, 0xa5, 0x06,
+	0x4f, 0x0a, 0x95, 0x9b, 0x5c, 0x9f, 0x68, 0xd4, 0x5a, 0xe6, 0x59, 0x2c, 0xb4, 0x09, 0x0d, 0x8e,
+	0x08, 0x65, 0xcd, 0x69, 0x98, 0x4c, 0xc3, 0x51, 0x6a, 0xf0, 0xf0, 0xa0, 0xc2, 0x2d, 0xf2, 0x54,
+	0x46, 0xf3, 0x78, 0xec, 0x58, 0x87, 0x87, 0x55, 0x93, 0x2c, 0x30, 0x95, 0x19, 0xc6, 0xde, 0x36,
+	0xb8, 0xfd, 0x09, 0x31, 0x0d, 0xb3, 0x30, 0x41, 0xe5, 0x19, 0x47, 0x49, 0x9e, 0x27, 0xa9, 0x27,
+	0x8d, 0x67, 0x93, 0x13, 0x23, 0xa7, 0xa8, 0x4d, 0x38, 0x2d, 0x1c, 0xe1, 0xf8, 0xe7, 0x75, 0x68,
+	0x3f, 0x55, 0x18, 0x4b, 0xc3, 0x31, 0xca, 0x55, 0xcc, 0x1e, 0x40, 0x53, 0x61, 0x91, 0x2b, 0x23,
+	0xb3, 0x24, 0xa8, 0x0d, 0x6a, 0xc3, 0x06, 0x5f, 0x02, 0xec, 0x1c, 0xfa, 0x11, 0xb1, 0x45, 0x2a,
+	0xa7, 0xd2, 0x08, 0x33, 0x2f, 0x30, 0x58, 0x1b, 0xd4, 0x86, 0xdd, 0xd3, 0xc3, 0xd1, 0xe2, 0x3c,
+	0x23, 0x17, 0xf1, 0xa5, 0xa5, 0x5c, 0xcf, 0x0b, 0xe4, 0xbd, 0x68, 0x15, 0x60, 0x01, 0x6c, 0x8d,
+	0x67, 0xd1, 0x7b, 0x34, 0x3a, 0xa8, 0x0f, 0xea, 0xc3, 0x75, 0x5e, 0x2e, 0xd9, 0x08, 0x76, 0x12,
+	0x15, 0x66, 0x46, 0x18, 0x15, 0x46, 0xef, 0x65, 0x96, 0xb8, 0x6f, 0xac, 0x0f, 0x6a, 0xc3, 0x0d,
+	0xde, 0x27, 0xd3, 0xb5, 0xb7, 0x50, 0xa4, 0x57, 0xb0, 0xa7, 0x30, 0x42, 0x79, 0x83, 0xb1, 0x20,
+	0x2b, 0xc6, 0x62, 0x96, 0x49, 0xa3, 0x83, 0x8d, 0x41, 0x6d, 0xd8, 0x3a, 0xdd, 0xaf, 0x6c, 0xeb,
+	0xc2, 0xd9, 0xdf, 0x5a, 0x33, 0xdf, 0x2d, 0xdd, 0xaa, 0x28, 0xfb, 0x27, 0x30, 0x77, 0x5a, 0x91,
+	0x86, 0xda, 0x08, 0xb7, 0xef, 0x60, 0x93, 0xf2, 0xb0, 0xed, 0x2c, 0x2f, 0x43, 0x6d, 0xdc, 0x01,
+	0xd9, 0x63, 0xd8, 0xb1, 0x09, 0x15, 0xf9, 0x44, 0x4c, 0xa4, 0xd2, 0x46, 0xcc, 0x74, 0x98, 0x60,
+	0xb0, 0x35, 0xa8, 0x0d, 0xd7, 0xf9, 0xb6, 0x35, 0xbd, 0x9e, 0x9c, 0x5b, 0xc3, 0x5b, 0x8b, 0xb3,
+	0x7f, 0x00, 0x2b, 0xe9, 0x14, 0xdd, 0xb1, 0x1b, 0xc4, 0xee, 0x39, 0xb6, 0x0d, 0xee, 0xc8, 0x0f,
+	0x01, 0xc8, 0x2e, 0x54, 0x68, 0x30, 0x68, 0x0e, 0x6a, 0xc3, 0x1a, 0x6f, 0x12, 0xc2, 0x43, 0x83,
+	0xec, 0xbf, 0xb0, 0xbf, 0x34, 0x8b, 0x8f, 0x32, 0x8b, 0xf3, 0x8f, 0x56, 0x5e, 0xca, 0x04, 0x40,
+	0x01, 0x77, 0x17, 0xdc, 0xaf, 0xc9, 0x78, 0x65, 0x6d, 0x77, 0xbb, 0x8d, 0xe7, 0x06, 0x75, 0xd0,
+	0xba, 0xd3, 0xed, 0xcc, 0xda, 0x8e, 0x7f, 0xa9, 0x41, 0xff, 0x5c, 0x66, 0x61, 0xfa, 0x79, 0x64,
+	0x64, 0x9e, 0x79, 0xad, 0xbc, 0x80, 0xf6, 0xc4, 0x82, 0x22, 0x24, 0x94, 0xe4, 0xd2, 0x3d, 0x7d,
+	0x54, 0x15, 0xc2, 0xbb, 0x50, 0x25, 0x32, 0x4b, 0x5c, 0xbe, 0x46, 0xd5, 0x10, 0xad, 0xc9, 0x72,
+	0xc1, 0xce, 0xa0, 0x67, 0x19, 0x0a, 0x23, 0x23, 0x34, 0xaa, 0x1b, 0x54, 0xa4, 0xaa, 0xd6, 0xe9,
+	0x41, 0x25, 0x18, 0xf7, 0x8c, 0x2b, 0x22, 0xf0, 0xae, 0x5a, 0x59, 0xb3, 0x47, 0xd0, 0x55, 0xa8,
+	0x8d, 0x92, 0x91, 0x11, 0x6a, 0x96, 0xa2, 0x93, 0x56, 0x93, 0x77, 0x4a, 0x94, 0x5b, 0xf0, 0xf8,
+	0x87, 0x3a, 0xec, 0x94, 0xdb, 0xa2, 0xd2, 0xfb, 0xc3, 0xfc, 0x19, 0xda, 0x2a, 0xb4, 0x22, 0x17,
+	0x89, 0xca, 0x67, 0x05, 0x1d, 0xa6, 0xc3, 0x5b, 0x0e, 0xbb, 0xb0, 0x10, 0x7b, 0x0c, 0xcc, 0x6e,
+	0x4e, 0x46, 0x28, 0x64, 0x8c, 0x99, 0x91, 0x13, 0xe9, 0x37, 0xda, 0xe1, 0x7d, 0x6f, 0xb9, 0x5c,
+	0x18, 0xd8, 0x09, 0x6c, 0x7a, 0xfd, 0xd4, 0x6f, 0x49, 0xb1, 0x7a, 0xe7, 0xb8, 0xa7, 0xb1, 0x03,
+	0x68, 0x48, 0x2d, 0x28, 0x2f, 0x24, 0xf8, 0x06, 0xdf, 0x92, 0x9a, 0x72, 0xc6, 0x5e, 0x40, 0xbf,
+	0x9a, 0x6a, 0x21, 0xb3, 0x49, 0xee, 0x15, 0xfe, 0xa0, 0x12, 0xf6, 0x56, 0x8d, 0x78, 0xaf, 0x92,
+	0xe6, 0xcb, 0x6c, 0x92, 0xd3, 0x39, 0x31, 0x9c, 0x99, 0x77, 0xae, 0x19, 0x91, 0xb6, 0xed, 0x39,
+	0x09, 0xbb, 0xb2, 0x10, 0xfb, 0x0b, 0x74, 0xca, 0x73, 0x3a, 0xce, 0x16, 0x71, 0xda, 0x1e, 0x74,
+	0xa4, 0x23, 0x68, 0xe1, 0xa7, 0x42, 0xaa, 0xb9, 0xb0, 0xca, 0x25, 0x15, 0xd7, 0x39, 0x38, 0xe8,
+	0x5a, 0x4e, 0xd1, 0x76, 0x12, 0x3d, 0xd3, 0x05, 0x66, 0x31, 0xc6, 0xa4, 0xdf, 0x06, 0x5f, 0x02,
+	0xc7, 0x3f, 0xd5, 0xa0, 0xf3, 0x2a, 0xcf, 0xa4, 0xc9, 0x95, 0x2f, 0xc0, 0x23, 0xe8, 0x4e, 0x1d,
+	0x60, 0x8b, 0xf0, 0x1e, 0xe7, 0x54, 0x82, 0x26, 0xef, 0x2c, 0xd1, 0x2f, 0x70, 0x5e, 0xc9, 0xea,
+	0xda, 0x1f, 0xcb, 0xea, 0xbf, 0x60, 0x23, 0xc5, 0x1b, 0x4c, 0xa9, 0x0a, 0xab, 0x7d, 0xea, 0xd5,
+	0x22, 0xf2, 0x4b, 0xcb, 0xe0, 0x8e, 0x78, 0x9c, 0x40, 0xf7, 0x0c, 0x43, 0x85, 0xea, 0xf2, 0x99,
+	0xdf, 0xdb, 0x11, 0xb4, 0x5c, 0x5f, 0x76, 0xdd, 0xc8, 0x69, 0x03, 0x1c, 0x44, 0x6d, 0x68, 0x1f,
+	0xb6, 0xac, 0xe6, 0x84, 0x8c, 0x69, 0x5b, 0x4d, 0xbe, 0x69, 0x97, 0x97, 0x31, 0xbb, 0x0f, 0xcd,
+	0x31, 0xc5, 0xb2, 0xa6, 0x3a, 0xf9, 0x35, 0x1c, 0x70, 0x19, 0x1f, 0xff, 0x08, 0xd0, 0xb9, 0x72,
+	0x8d, 0xdb, 0x7f, 0xe8, 0x3e, 0x34, 0x27, 0x7a, 0xea, 0xd3, 0xee, 0x3e, 0xd3, 0x98, 0xe8, 0xa9,
+	0x4b, 0xf9, 0x39, 0x74, 0xa3, 0x7c, 0x3a, 0xcd, 0x33, 0x11, 0xe5, 0x99, 0xc1, 0x4f, 0x65, 0x0a,
+	0x8e, 0xaa, 0x29, 0x20, 0x82, 0x0f, 0xfa, 0xd4, 0xd1, 0x78, 0xc7, 0xb9, 0xf9, 0x25, 0x7b, 0x0d,
+	0xbb, 0x2a, 0x34, 0x42, 0x17, 0x18, 0xc9, 0x89, 0x8c, 0x16, 0xd1, 0x9c, 0x4c, 0x1f, 0x56, 0xaf,
+	0x5c, 0x68, 0xae, 0x3c, 0xab, 0x8c, 0xc5, 0xd4, 0x2d, 0x8c, 0x5d, 0x40, 0x2f, 0xf2, 0x57, 0xca,
+	0x35, 0x61, 0x1d, 0xac, 0x0f, 0xea, 0xc3, 0xd6, 0xe9, 0x9f, 0xee, 0xe8, 0x05, 0x95, 0x4b, 0xc7,
+	0xbb, 0x51, 0x15, 0xd4, 0xec, 0x3f, 0xd0, 0xf0, 0xd5, 0xb6, 0xfd, 0xdb, 0x46, 0x08, 0x6e, 0x97,
+	0xcb, 0xfb, 0x2e, 0x98, 0xec, 0xef, 0xd0, 0x2f, 0xc7, 0x1f, 0x15, 0x90, 0xc4, 0xb3, 0x49, 0x65,
+	0xe8, 0x79, 0x03, 0xd5, 0xd7, 0xca, 0x87, 0xc1, 0xba, 0x9c, 0x6a, 0x49, 0x92, 0x6e, 0x72, 0xfa,
+	0x6f, 0x5b, 0x6d, 0xe9, 0x2f, 0x63, 0x52, 0x72, 0x93, 0x37, 0x3d, 0x72, 0x19, 0x5b, 0x73, 0x9a,
+	0x47, 0x61, 0x2a, 0x0c, 0x4a, 0xa7, 0xe4, 0x0e, 0x6f, 0x12, 0x72, 0x8d, 0x32, 0x66, 0xdf, 0xc1,
+	0x9e, 0x9e, 0x8d, 0x75, 0xa4, 0xe4, 0x18, 0x95, 0xf8, 0x30, 0xcb, 0x4d, 0xe8, 0xeb, 0x07, 0xb7,
+	0xfa, 0xe1, 0xd5, 0x82, 0xf8, 0x95, 0xe5, 0xbd, 0x2d, 0x62, 0xfb, 0x1e, 0xa0, 0x19, 0xb9, 0xab,
+	0x57, 0x6d, 0xae, 0xe4, 0xdf, 0xc0, 0x7e, 0xa4, 0xd0, 0xf6, 0xea, 0x72, 0x87, 0x0a, 0x75, 0x91,
+	0x67, 0x1a, 0xa9, 0x5f, 0xb7, 0x4e, 0x07, 0xab, 0xf2, 0x0f, 0x0d, 0x2e, 0x04, 0xe5, 0x78, 0xfc,
+	0x5e, 0x74, 0x17, 0xcc, 0xfe, 0x0f, 0x6d, 0x93, 0x14, 0xc5, 0xa2, 0xf8, 0x6d, 0x0a, 0xb7, 0x57,
+	0x09, 0x77, 0x9d, 0x14, 0x45, 0x59, 0xf5, 0x96, 0x59, 0x2e, 0xd8, 0x5f, 0xa1, 0x5b, 0xc4, 0x85,
+	0x9b, 0x36, 0xee, 0xf6, 0x77, 0x68, 0x76, 0xb4, 0x8b, 0xb8, 0xa0, 0x31, 0x43, 0xf7, 0x7f, 0x00,
+	0x76, 0x2d, 0x30, 0x8b, 0x1d, 0xa7, 0x4b, 0x1c, 0x28, 0xe2, 0xe2, 0x79, 0x16, 0x13, 0xe3, 0x1d,
+	0xec, 0xd9, 0x6e, 0x60, 0x55, 0x83, 0x37, 0x48, 0x33, 0x5f, 0x26, 0x09, 0x2a, 0x1d, 0xf4, 0xa8,
+	0xf6, 0xa7, 0xd5, 0xcc, 0x55, 0xaf, 0xc9, 0xe8, 0x8d, 0x73, 0x7b, 0x6e, 0xbd, 0xae, 0xbd, 0xd3,
+	0xf3, 0xcc, 0xa8, 0x39, 0xdf, 0x2d, 0xee, 0x30, 0xb1, 0x0b, 0xe8, 0x2b, 0xbc, 0x09, 0x53, 0x19,
+	0x87, 0xd4, 0x3e, 0x69, 0x43, 0xdb, 0x74, 0xe2, 0xc3, 0x91, 0x7b, 0x23, 0x8d, 0xca, 0x37, 0xd2,
+	0xe8, 0xba, 0x7c, 0x23, 0xd9, 0x89, 0xbf, 0x74, 0xa2, 0x2d, 0xbf, 0x80, 0x9d, 0xc5, 0x75, 0x16,
+	0xe3, 0xb9, 0x70, 0x2d, 0x20, 0xe8, 0xd3, 0x7e, 0xab, 0xc3, 0x6a, 0xb5, 0x81, 0xf0, 0xed, 0xf2,
+	0xce, 0x9f, 0xcd, 0xdf, 0x90, 0x0b, 0xfb, 0x1b, 0xf4, 0xac, 0x4a, 0x64, 0x24, 0x7c, 0xe3, 0xd0,
+	0x01, 0x73, 0xf3, 0xca, 0xc1, 0x9c, 0xfa, 0x87, 0x66, 0x4f, 0xa0, 0x13, 0xcf, 0xb3, 0x70, 0xea,
+	0x89, 0x3a, 0xd8, 0xa1, 0x6f, 0xdd, 0xab, 0x7c, 0xcb, 0x45, 0xb4, 0x0e, 0xbc, 0xed, 0xb9, 0x34,
+	0xeb, 0xd8, 0x67, 0xb0, 0x9d, 0xcc, 0xc5, 0xaa, 0xfb, 0xee, 0xef, 0xb9, 0x77, 0x93, 0xf9, 0xb3,
+	0x6a, 0x00, 0x9a, 0xa9, 0x1f, 0x66, 0xa8, 0x8d, 0xc8, 0x66, 0xd3, 0x31, 0xaa, 0xe0, 0x1e, 0xc9,
+	0xbf, 0xe3, 0xd1, 0x2f, 0x09, 0x3c, 0xbc, 0x80, 0x83, 0xdf, 0xac, 0x08, 0xdb, 0x86, 0x7a, 0xd9,
+	0xcc, 0x37, 0xb8, 0xfd, 0xcb, 0x76, 0x61, 0xe3, 0x26, 0x4c, 0x67, 0xe8, 0x47, 0xa7, 0x5b, 0x3c,
+	0x59, 0xfb, 0x5f, 0xed, 0xf8, 0xfb, 0x1a, 0x74, 0x57, 0x2a, 0xad, 0xed, 0x53, 0xf1, 0x06, 0x95,
+	0x2e, 0xdf, 0x17, 0x1d, 0x5e, 0x2e, 0x6d, 0xb3, 0xf0, 0x97, 0x42, 0x07, 0x6b, 0xb7, 0x9a, 0xc5,
+	0x4a, 0x18, 0xbe, 0x60, 0xda, 0x56, 0xbe, 0xbc, 0xec, 0xe5, 0x1b, 0x01, 0x16, 0xb7, 0x5d, 0x9f,
+	0xdd, 0xff, 0xf6, 0x80, 0xa2, 0x9c, 0xd8, 0xd7, 0x75, 0x94, 0xe6, 0xb3, 0xf8, 0x24, 0xc9, 0xfd,
+	0x33, 0x7b, 0xbc, 0x49, 0xbf, 0xff, 0xfe, 0x35, 0x00, 0x00, 0xff, 0xff, 0x84, 0xf0, 0x36, 0xdc,
+	0xde, 0x0b, 0x00, 0x00,
+}
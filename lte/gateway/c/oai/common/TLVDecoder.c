@@ -29,6 +29,19 @@
 
 int errorCodeDecoder = 0;
 
+static tlv_decode_arena_t* _tlv_decode_arena = NULL;
+
+//------------------------------------------------------------------------------
+tlv_decode_arena_t* tlv_decode_arena_install(tlv_decode_arena_t* arena) {
+  tlv_decode_arena_t* previous = _tlv_decode_arena;
+
+  if (arena) {
+    arena->num_views = 0;
+  }
+  _tlv_decode_arena = arena;
+  return previous;
+}
+
 //------------------------------------------------------------------------------
 int decode_bstring(
     bstring* bstr, const uint16_t pdulen, const uint8_t* const buffer,
@@ -38,7 +51,15 @@ int decode_bstring(
   }
 
   if ((bstr) && (buffer)) {
-    *bstr = blk2bstr(buffer, pdulen);
+    if ((_tlv_decode_arena) &&
+        (_tlv_decode_arena->num_views < TLV_DECODE_ARENA_MAX_VIEWS)) {
+      struct tagbstring* view =
+          &_tlv_decode_arena->views[_tlv_decode_arena->num_views++];
+      blk2tbstr(*view, buffer, pdulen);
+      *bstr = view;
+    } else {
+      *bstr = blk2bstr(buffer, pdulen);
+    }
     return pdulen;
   } else {
     *bstr = NULL;
@@ -47,7 +68,19 @@ int decode_bstring(
 }
 
 //------------------------------------------------------------------------------
-bstring dump_bstring_xml(const bstring const bstr) {
+bstring tlv_decode_take_bstring(bstring* bstr) {
+  bstring taken = NULL;
+
+  if ((bstr) && (*bstr)) {
+    // views are write-protected (mlen <= 0), owned strings are not
+    taken = ((*bstr)->mlen > 0) ? *bstr : bstrcpy(*bstr);
+    *bstr = NULL;
+  }
+  return taken;
+}
+
+//------------------------------------------------------------------------------
+bstring dump_bstring_xml(const bstring bstr) {
   if (bstr) {
     int i;
 
@@ -44,11 +44,37 @@
 
 extern int errorCodeDecoder;
 
+/*
+ * Arena of octet string views for decode_bstring().
+ * While an arena is installed, decoded octet strings are write-protected
+ * bstrings pointing into the decoded buffer instead of heap copies: no
+ * allocation takes place, bdestroy() on them is a no-op, and they are only
+ * valid as long as both the decoded buffer and the arena are. A field that
+ * outlives the decoded message has to be taken with tlv_decode_take_bstring().
+ * Once the arena is full decode_bstring() falls back to heap copies.
+ * The installed arena is process-wide and unlocked: only one thread (the
+ * MME_APP task, which runs the NAS layer) may decode while one is installed,
+ * and its views are only valid until the next decode reinstalls it.
+ */
+#define TLV_DECODE_ARENA_MAX_VIEWS 32
+
+typedef struct tlv_decode_arena_s {
+  int num_views;
+  struct tagbstring views[TLV_DECODE_ARENA_MAX_VIEWS];
+} tlv_decode_arena_t;
+
+/* Installs arena (NULL for heap copies), returns the previous one */
+tlv_decode_arena_t* tlv_decode_arena_install(tlv_decode_arena_t* arena);
+
 int decode_bstring(
     bstring* octetstring, const uint16_t pdulen, const uint8_t* const buffer,
     const uint32_t buflen);
 
-bstring dump_bstring_xml(const bstring const bstr);
+/* Returns an owned copy of a decoded view, or hands an owned bstring over,
+ * and resets *bstr in both cases */
+bstring tlv_decode_take_bstring(bstring* bstr);
+
+bstring dump_bstring_xml(const bstring bstr);
 
 void tlv_decode_perror(void);
 
@@ -34,10 +34,20 @@
    \date 2017
    \email: lionel.gauthier@eurecom.fr
 */
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <signal.h>
+#include <spawn.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
 #include <stdarg.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include "bstrlib.h"
 #include "intertask_interface.h"
@@ -50,38 +60,365 @@
 #include "async_system_messages_types.h"
 #include "intertask_interface_types.h"
 #include "itti_types.h"
+#include "service303.h"
+
+#define HELPER_SHELL "/bin/sh"
+#define STATUS_MARKER "__async_system_status"
+#define HEREDOC_END "__ASYNC_SYSTEM_EOF__"
+#define IPTABLES_RESTORE "iptables-restore --noflush"
+#define PROC_SYS "/proc/sys/"
+#define MAX_OUTPUT_LINE 512
+
+extern char** environ;
 
 static void async_system_exit(void);
 
 task_zmq_ctx_t async_system_task_zmq_ctx;
 
+// Push socket used by the other threads, which may not have their own
+static task_zmq_ctx_t async_system_client_zmq_ctx;
+static pthread_mutex_t async_system_client_lock = PTHREAD_MUTEX_INITIALIZER;
+static bool async_system_started;
+
+static async_system_executor_t async_system_executor;
+
+// iptables command of a batch waiting for its table's transaction
+typedef struct iptables_rule_s {
+  int index;
+  bstring table;
+  bstring rule;
+} iptables_rule_t;
+
+//------------------------------------------------------------------------------
+int async_system_executor_start(async_system_executor_t* executor) {
+  char* argv[] = {HELPER_SHELL, "-s", NULL};
+  posix_spawn_file_actions_t actions;
+  int fds[2];
+  int rc = 0;
+
+  if (!executor->iptables_restore) {
+    executor->iptables_restore = IPTABLES_RESTORE;
+  }
+  // A socket rather than pipes, to write with MSG_NOSIGNAL
+  if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) < 0) {
+    OAILOG_ERROR(
+        LOG_ASYNC_SYSTEM, "socketpair() failed: %s\n", strerror(errno));
+    return RETURNerror;
+  }
+  posix_spawn_file_actions_init(&actions);
+  posix_spawn_file_actions_adddup2(&actions, fds[1], STDIN_FILENO);
+  posix_spawn_file_actions_adddup2(&actions, fds[1], STDOUT_FILENO);
+  posix_spawn_file_actions_adddup2(&actions, fds[1], STDERR_FILENO);
+  rc = posix_spawn(
+      &executor->pid, HELPER_SHELL, &actions, NULL, argv, environ);
+  posix_spawn_file_actions_destroy(&actions);
+  close(fds[1]);
+  if (rc) {
+    OAILOG_ERROR(
+        LOG_ASYNC_SYSTEM, "Cannot start %s: %s\n", HELPER_SHELL, strerror(rc));
+    close(fds[0]);
+    return RETURNerror;
+  }
+  executor->fd  = fds[0];
+  executor->out = fdopen(fds[0], "r");
+  increment_counter("async_system_helper_started", 1, NO_LABELS);
+  return RETURNok;
+}
+
+//------------------------------------------------------------------------------
+void async_system_executor_stop(async_system_executor_t* executor) {
+  if (executor->out) {
+    // The helper shell exits on end of file
+    fclose(executor->out);
+    executor->out = NULL;
+    waitpid(executor->pid, NULL, 0);
+  }
+}
+
+//------------------------------------------------------------------------------
+static int _write_all(int fd, const char* data, size_t len) {
+  while (len) {
+    ssize_t written = send(fd, data, len, MSG_NOSIGNAL);
+
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      return RETURNerror;
+    }
+    data += written;
+    len -= written;
+  }
+  return RETURNok;
+}
+
+//------------------------------------------------------------------------------
+// Runs script in the helper shell and returns the exit status of its last
+// command, -1 when the helper shell is gone (it is then restarted). Without
+// a helper shell, script is run by system() as before.
+static int _run_script(
+    async_system_executor_t* executor, const_bstring script) {
+  char line[MAX_OUTPUT_LINE];
+  bstring request = NULL;
+  int rc          = RETURNerror;
+
+  if (!executor->out) {
+    rc = system(bdata((bstring) script));
+    return WIFEXITED(rc) ? WEXITSTATUS(rc) : -1;
+  }
+  request =
+      bformat("%s\necho " STATUS_MARKER " $?\n", bdata((bstring) script));
+  rc = _write_all(executor->fd, bdata(request), blength(request));
+  bdestroy_wrapper(&request);
+  if (rc == RETURNok) {
+    while (fgets(line, sizeof(line), executor->out)) {
+      if (!strncmp(line, STATUS_MARKER " ", sizeof(STATUS_MARKER))) {
+        return atoi(line + sizeof(STATUS_MARKER));
+      }
+      // Output of the commands, mostly their errors
+      OAILOG_INFO(LOG_ASYNC_SYSTEM, "%s", line);
+    }
+  }
+  OAILOG_ERROR(LOG_ASYNC_SYSTEM, "Helper shell exited, restarting it\n");
+  async_system_executor_stop(executor);
+  async_system_executor_start(executor);
+  return -1;
+}
+
+//------------------------------------------------------------------------------
+static void _count(const char* executor, int status) {
+  increment_counter(
+      "async_system_commands", 1, 2, "executor", executor, "result",
+      status ? "failure" : "success");
+}
+
+//------------------------------------------------------------------------------
+// sysctl -w key=value, with the value written to /proc/sys/key
+static bool _run_sysctl(const char* command, int* status) {
+  char path[256];
+  const char* key   = command + strlen("sysctl -w ");
+  const char* value = strchr(key, '=');
+  size_t key_len    = value ? (size_t)(value - key) : 0;
+  int fd            = -1;
+
+  if (strncmp(command, "sysctl -w ", strlen("sysctl -w ")) || !key_len ||
+      strchr(value, ' ') || sizeof(PROC_SYS) + key_len > sizeof(path)) {
+    return false;
+  }
+  value++;
+  memcpy(path, PROC_SYS, sizeof(PROC_SYS) - 1);
+  for (size_t i = 0; i < key_len; i++) {
+    path[sizeof(PROC_SYS) - 1 + i] = key[i] == '.' ? '/' : key[i];
+  }
+  path[sizeof(PROC_SYS) - 1 + key_len] = '\0';
+  fd = open(path, O_WRONLY | O_CLOEXEC);
+  *status =
+      fd < 0 || write(fd, value, strlen(value)) != (ssize_t) strlen(value);
+  if (fd >= 0) {
+    close(fd);
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+// Splits "iptables [-t table] rule" into table and rule, NULL when command
+// is not an iptables command iptables-restore can take as is
+static bstring _iptables_rule(const char* command, bstring* table) {
+  struct bstrList* words = NULL;
+  bstring rule           = NULL;
+  bstring args           = NULL;
+
+  if (strncmp(command, "iptables ", strlen("iptables ")) ||
+      strpbrk(command, "\"'\\$`;|&<>")) {
+    return NULL;
+  }
+  args  = bfromcstr(command + strlen("iptables "));
+  words = bsplit(args, ' ');
+  bdestroy_wrapper(&args);
+  rule   = bfromcstr("");
+  *table = bfromcstr("filter");
+  for (int i = 0; i < words->qty; i++) {
+    if (!blength(words->entry[i])) {
+      continue;
+    }
+    if (biseqcstr(words->entry[i], "-t") ||
+        biseqcstr(words->entry[i], "--table")) {
+      while (++i < words->qty && !blength(words->entry[i])) {
+      }
+      if (i < words->qty) {
+        bassign(*table, words->entry[i]);
+      }
+      continue;
+    }
+    if (blength(rule)) {
+      bconchar(rule, ' ');
+    }
+    bconcat(rule, words->entry[i]);
+  }
+  bstrListDestroy(words);
+  return rule;
+}
+//------------------------------------------------------------------------------
+// One transaction with the rules of table among nb_rules
+static int _restore(
+    async_system_executor_t* executor, iptables_rule_t* rules, int nb_rules,
+    const_bstring table) {
+  bstring script = bformat(
+      "%s <<'" HEREDOC_END "'\n*%s\n", executor->iptables_restore,
+      bdata((bstring) table));
+  int status = 0;
+
+  for (int i = 0; i < nb_rules; i++) {
+    if (rules[i].table && biseq(rules[i].table, table)) {
+      bconcat(script, rules[i].rule);
+      bconchar(script, '\n');
+    }
+  }
+  bcatcstr(script, "COMMIT\n" HEREDOC_END);
+  status = _run_script(executor, script);
+  bdestroy_wrapper(&script);
+  return status;
+}
+
+//------------------------------------------------------------------------------
+// Runs the pending iptables rules, one transaction per table
+static void _flush_iptables_rules(
+    async_system_executor_t* executor, iptables_rule_t* rules, int nb_rules,
+    int* statuses) {
+  for (int i = 0; i < nb_rules; i++) {
+    bstring table = rules[i].table;
+    int status    = 0;
+
+    if (!table) {
+      continue;
+    }
+    status = _restore(executor, &rules[i], nb_rules - i, table);
+    if (status) {
+      OAILOG_WARNING(
+          LOG_ASYNC_SYSTEM,
+          "iptables-restore failed for table %s, replaying its rules one by "
+          "one\n",
+          bdata(table));
+    }
+    for (int j = i; j < nb_rules; j++) {
+      if (!rules[j].table || !biseq(rules[j].table, table)) {
+        continue;
+      }
+      if (status) {
+        statuses[rules[j].index] = _restore(executor, &rules[j], 1, table);
+      } else {
+        statuses[rules[j].index] = 0;
+      }
+      _count("iptables_restore", statuses[rules[j].index]);
+      bdestroy_wrapper(&rules[j].rule);
+      if (j != i) {
+        bdestroy_wrapper(&rules[j].table);
+      }
+    }
+    bdestroy_wrapper(&table);
+    rules[i].table = NULL;
+  }
+}
+
+//------------------------------------------------------------------------------
+int async_system_executor_run(
+    async_system_executor_t* executor, const_bstring batch, int* statuses,
+    int nb_statuses) {
+  struct bstrList* lines = bsplit(batch, '\n');
+  iptables_rule_t* rules = NULL;
+  int nb_rules           = 0;
+  int nb_commands        = 0;
+
+  if (!lines) {
+    return 0;
+  }
+  rules = calloc(lines->qty, sizeof(*rules));
+  for (int i = 0; i < lines->qty && nb_commands < nb_statuses; i++) {
+    const char* command = NULL;
+    int index           = nb_commands;
+    bstring table       = NULL;
+    bstring rule        = NULL;
+
+    btrimws(lines->entry[i]);
+    if (!blength(lines->entry[i])) {
+      continue;
+    }
+    command = bdata(lines->entry[i]);
+    nb_commands++;
+    if ((rule = _iptables_rule(command, &table))) {
+      rules[nb_rules++] = (iptables_rule_t){index, table, rule};
+      continue;
+    }
+    // Anything else may depend on the rules before it
+    _flush_iptables_rules(executor, rules, nb_rules, statuses);
+    nb_rules = 0;
+    if (!strcmp(command, "sync")) {
+      sync();
+      statuses[index] = 0;
+      _count("direct", 0);
+    } else if (_run_sysctl(command, &statuses[index])) {
+      _count("direct", statuses[index]);
+    } else {
+      bstring script = bformat("%s </dev/null", command);
+
+      statuses[index] = _run_script(executor, script);
+      bdestroy_wrapper(&script);
+      _count("shell", statuses[index]);
+    }
+  }
+  _flush_iptables_rules(executor, rules, nb_rules, statuses);
+  free(rules);
+  bstrListDestroy(lines);
+  return nb_commands;
+}
+
+//------------------------------------------------------------------------------
+static void _handle_command(itti_async_system_command_t* command) {
+  int nb_statuses = 1;
+  int* statuses   = NULL;
+  int nb_commands = 0;
+  int64_t start   = zclock_usecs();
+
+  for (int i = 0; i < blength(command->system_command); i++) {
+    nb_statuses += bchar(command->system_command, i) == '\n';
+  }
+  statuses    = calloc(nb_statuses, sizeof(*statuses));
+  nb_commands = async_system_executor_run(
+      &async_system_executor, command->system_command, statuses, nb_statuses);
+  observe_histogram(
+      "async_system_batch_latency_ms",
+      (double) (zclock_usecs() - start) / 1000, NO_LABELS, NO_BOUNDARIES);
+  OAILOG_DEBUG(
+      LOG_ASYNC_SYSTEM, "Ran %d commands in %" PRId64 " us\n", nb_commands,
+      zclock_usecs() - start);
+
+  for (int i = 0; i < nb_commands; i++) {
+    if (!statuses[i]) {
+      continue;
+    }
+    OAILOG_ERROR(
+        LOG_ASYNC_SYSTEM, "ERROR in system command %d of %s: %d\n", i + 1,
+        bdata(command->system_command), statuses[i]);
+    if (command->is_abort_on_error) {
+      free(statuses);
+      bdestroy_wrapper(&command->system_command);
+      exit(-1);  // may be not exit
+    }
+  }
+  free(statuses);
+}
+
 static int handle_message(zloop_t* loop, zsock_t* reader, void* arg) {
-  int rc              = 0;
   zframe_t* msg_frame = zframe_recv(reader);
   assert(msg_frame);
   MessageDef* received_message_p = (MessageDef*) zframe_data(msg_frame);
 
   switch (ITTI_MSG_ID(received_message_p)) {
     case ASYNC_SYSTEM_COMMAND: {
-      rc = 0;
       OAILOG_DEBUG(
-          LOG_ASYNC_SYSTEM, "C system() call: %s\n",
-          bdata(ASYNC_SYSTEM_COMMAND(received_message_p).system_command));
-      rc = system(
+          LOG_ASYNC_SYSTEM, "Commands: %s\n",
           bdata(ASYNC_SYSTEM_COMMAND(received_message_p).system_command));
-
-      if (rc) {
-        OAILOG_ERROR(
-            LOG_ASYNC_SYSTEM, "ERROR in system command %s: %d\n",
-            bdata(ASYNC_SYSTEM_COMMAND(received_message_p).system_command), rc);
-        if (ASYNC_SYSTEM_COMMAND(received_message_p).is_abort_on_error) {
-          bdestroy_wrapper(
-              &ASYNC_SYSTEM_COMMAND(received_message_p).system_command);
-          exit(-1);  // may be not exit
-        }
-        bdestroy_wrapper(
-            &ASYNC_SYSTEM_COMMAND(received_message_p).system_command);
-      }
+      _handle_command(&ASYNC_SYSTEM_COMMAND(received_message_p));
     } break;
 
     case TERMINATE_MESSAGE: {
@@ -104,10 +441,10 @@ static int handle_message(zloop_t* loop, zsock_t* reader, void* arg) {
 
 //------------------------------------------------------------------------------
 static void* async_system_thread(__attribute__((unused)) void* args_p) {
-  itti_mark_task_ready(TASK_ASYNC_SYSTEM);
   init_task_context(
       TASK_ASYNC_SYSTEM, (task_id_t[]){}, 0, handle_message,
       &async_system_task_zmq_ctx);
+  itti_mark_task_ready(TASK_ASYNC_SYSTEM);
 
   zloop_start(async_system_task_zmq_ctx.event_loop);
   async_system_exit();
@@ -117,16 +454,73 @@ static void* async_system_thread(__attribute__((unused)) void* args_p) {
 //------------------------------------------------------------------------------
 int async_system_init(void) {
   OAI_FPRINTF_INFO("Initializing ASYNC_SYSTEM\n");
+  if (async_system_executor_start(&async_system_executor) != RETURNok) {
+    OAILOG_WARNING(
+        LOG_ASYNC_SYSTEM,
+        "No ASYNC_SYSTEM helper shell, running commands with system()\n");
+  }
   if (itti_create_task(TASK_ASYNC_SYSTEM, &async_system_thread, NULL) < 0) {
     perror("pthread_create");
     OAILOG_ALERT(
         LOG_ASYNC_SYSTEM, "Initializing ASYNC_SYSTEM task interface: ERROR\n");
     return RETURNerror;
   }
+  init_task_context(
+      TASK_ASYNC_SYSTEM, (task_id_t[]){TASK_ASYNC_SYSTEM}, 1, NULL,
+      &async_system_client_zmq_ctx);
+  async_system_started = true;
   OAI_FPRINTF_INFO("Initializing ASYNC_SYSTEM Done\n");
   return RETURNok;
 }
 
+//------------------------------------------------------------------------------
+int async_system_batch_add(bstring* batch, char* format, ...) {
+  va_list args;
+  int rv = 0;
+
+  if (!*batch) {
+    *batch = bfromcstralloc(1024, "");
+  } else if (blength(*batch)) {
+    bconchar(*batch, '\n');
+  }
+  va_start(args, format);
+  rv = bvcformata(*batch, 1024, format, args);  // big number, see bvcformata
+  va_end(args);
+  if (rv != BSTR_OK) {
+    OAILOG_ERROR(LOG_ASYNC_SYSTEM, "Error while formatting system command");
+    return RETURNerror;
+  }
+  return RETURNok;
+}
+
+//------------------------------------------------------------------------------
+int async_system_batch_send(
+    int sender_itti_task, bool is_abort_on_error, bstring* batch) {
+  MessageDef* message_p = NULL;
+  int rv                = 0;
+
+  if (!*batch) {
+    return RETURNok;
+  }
+  if (!async_system_started) {
+    OAILOG_ERROR(
+        LOG_ASYNC_SYSTEM, "ASYNC_SYSTEM not started, dropping %s\n",
+        bdata(*batch));
+    bdestroy_wrapper(batch);
+    return RETURNerror;
+  }
+  message_p = itti_alloc_new_message(sender_itti_task, ASYNC_SYSTEM_COMMAND);
+  AssertFatal(message_p, "itti_alloc_new_message Failed");
+  ASYNC_SYSTEM_COMMAND(message_p).system_command    = *batch;
+  ASYNC_SYSTEM_COMMAND(message_p).is_abort_on_error = is_abort_on_error;
+  *batch                                            = NULL;
+  pthread_mutex_lock(&async_system_client_lock);
+  rv = send_msg_to_task(
+      &async_system_client_zmq_ctx, TASK_ASYNC_SYSTEM, message_p);
+  pthread_mutex_unlock(&async_system_client_lock);
+  return rv;
+}
+
 //------------------------------------------------------------------------------
 int async_system_command(
     int sender_itti_task, bool is_abort_on_error, char* format, ...) {
@@ -139,23 +533,18 @@ int async_system_command(
   rv = bvcformata(bstr, 1024, format, args);  // big number, see bvcformata
   va_end(args);
 
-  if (NULL == bstr) {
+  if (NULL == bstr || rv != BSTR_OK) {
+    bdestroy_wrapper(&bstr);
     OAILOG_ERROR(LOG_ASYNC_SYSTEM, "Error while formatting system command");
     return RETURNerror;
   }
-  MessageDef* message_p = NULL;
-  message_p = itti_alloc_new_message(sender_itti_task, ASYNC_SYSTEM_COMMAND);
-  AssertFatal(message_p, "itti_alloc_new_message Failed");
-  ASYNC_SYSTEM_COMMAND(message_p).system_command    = bstr;
-  ASYNC_SYSTEM_COMMAND(message_p).is_abort_on_error = is_abort_on_error;
-  rv                                                = send_msg_to_task(
-      &async_system_task_zmq_ctx, TASK_ASYNC_SYSTEM, message_p);
-  return rv;
+  return async_system_batch_send(sender_itti_task, is_abort_on_error, &bstr);
 }
 
 //------------------------------------------------------------------------------
 void async_system_exit(void) {
   destroy_task_context(&async_system_task_zmq_ctx);
+  async_system_executor_stop(&async_system_executor);
   OAI_FPRINTF_INFO("TASK_ASYNC_SYSTEM terminated");
   pthread_exit(NULL);
 }
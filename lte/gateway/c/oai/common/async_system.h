@@ -41,9 +41,57 @@
 #define FILE_ASYNC_SYSTEM_SEEN
 
 #include <stdbool.h>
+#include <stdio.h>
+#include <sys/types.h>
 
+#include "bstrlib.h"
+
+/*
+ * TASK_ASYNC_SYSTEM runs commands through one long-lived helper shell
+ * instead of a system() call each:
+ * - sync and sysctl -w are done directly with sync(2) and /proc/sys,
+ * - consecutive iptables commands of a batch are grouped per table into one
+ *   iptables-restore --noflush transaction. When a transaction fails its
+ *   rules are replayed one per transaction to get the status of each,
+ * - any other command is run by the helper shell.
+ * When the helper shell cannot be spawned, each script is run by system().
+ */
+typedef struct async_system_executor_s {
+  pid_t pid;
+  int fd;    /* stdin, stdout and stderr of the helper shell */
+  FILE* out; /* read side of fd */
+  /* Command reading an iptables-restore transaction on its stdin */
+  const char* iptables_restore;
+} async_system_executor_t;
+
+/* Starts TASK_ASYNC_SYSTEM. Until it is started, commands are dropped */
 int async_system_init(void);
+
+/* Sends one command, formatted as by printf */
 int async_system_command(
     int sender_itti_task, bool is_abort_on_error, char* format, ...);
 
-#endif /* FILE_SHARED_TS_LOG_SEEN */
+/* Appends one command, formatted as by printf, to *batch */
+int async_system_batch_add(bstring* batch, char* format, ...);
+
+/*
+ * Sends the commands appended to *batch in one message and takes ownership
+ * of it. They run in order, except that iptables commands for different
+ * tables may be reordered within a run of iptables commands.
+ */
+int async_system_batch_send(
+    int sender_itti_task, bool is_abort_on_error, bstring* batch);
+
+int async_system_executor_start(async_system_executor_t* executor);
+
+void async_system_executor_stop(async_system_executor_t* executor);
+
+/*
+ * Runs the commands of batch, one per line, and writes the exit status of
+ * each in statuses. Returns the number of commands, at most nb_statuses.
+ */
+int async_system_executor_run(
+    async_system_executor_t* executor, const_bstring batch, int* statuses,
+    int nb_statuses);
+
+#endif /* FILE_ASYNC_SYSTEM_SEEN */
@@ -337,6 +337,15 @@ typedef struct {
   struct apn_configuration_s apn_configuration[MAX_APN_PER_UE];
 } apn_config_profile_t;
 
+/* APN configuration profile of a UE context: apn_configuration holds the
+ * nb_apns configurations of the subscription only */
+typedef struct {
+  context_identifier_t context_identifier;
+  all_apn_conf_ind_t all_apn_conf_ind;
+  uint8_t nb_apns;
+  struct apn_configuration_s* apn_configuration;
+} ue_apn_config_profile_t;
+
 typedef struct {
   subscriber_status_t subscriber_status;
   char msisdn[MSISDN_LENGTH + 1];
@@ -351,7 +360,7 @@ typedef struct {
 
 typedef struct authentication_info_s {
   uint8_t nb_of_vectors;
-  eutran_vector_t eutran_vector[MAX_EPS_AUTH_VECTORS];
+  eutran_vector_t eutran_vector[MAX_EPS_AUTH_VECTORS_PER_AIR];
 } authentication_info_t;
 
 typedef enum {
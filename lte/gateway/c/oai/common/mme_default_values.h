@@ -78,6 +78,40 @@
 
 #define RELATIVE_CAPACITY (15)
 
+/*******************************************************************************
+ * MME overload control
+ ******************************************************************************/
+
+#define MME_APP_QUEUE_LATENCY_HIGH_MS (200)
+#define MME_APP_QUEUE_LATENCY_LOW_MS (50)
+#define S6A_QUEUE_LATENCY_HIGH_MS (200)
+#define S6A_QUEUE_LATENCY_LOW_MS (50)
+#define OUTSTANDING_PROCEDURES_HIGH (0)  ///< Disabled
+#define OUTSTANDING_PROCEDURES_LOW (0)
+#define S6A_AIR_RATE (0)  ///< AIR per second, 0 for no pacing
+
+/*******************************************************************************
+ * Eviction of idle UE contexts to the data store
+ ******************************************************************************/
+
+#define UE_EVICTION_IDLE_TIME_SEC (0)  ///< Disabled
+#define UE_EVICTION_MAX_PER_SWEEP (100)
+
+/*******************************************************************************
+ * Authentication vectors kept from one AIR for the next attaches
+ ******************************************************************************/
+
+#define AUTH_VECTOR_CACHE_MAX_UES (0)  ///< Disabled
+#define AUTH_VECTOR_CACHE_VECTORS_PER_AIR (3)
+#define AUTH_VECTOR_CACHE_TTL_SEC (1800)
+
+/*******************************************************************************
+ * Latency trace of the UE procedures
+ ******************************************************************************/
+
+#define PROCEDURE_TRACE_SAMPLE_RATE (1000)  ///< One trace dumped every 1000
+#define PROCEDURE_TRACE_FILE "/var/log/mme_procedure_trace.json"
+
 /*******************************************************************************
  * GRPC Service Constants
  ******************************************************************************/
@@ -0,0 +1,427 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file procedure_trace.c
+  \brief Latency trace of the UE procedures across the MME tasks
+*/
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/queue.h>
+#include <czmq.h>
+
+#include "bstrlib.h"
+#include "common_defs.h"
+#include "dynamic_memory_check.h"
+#include "hashtable.h"
+#include "log.h"
+#include "procedure_trace.h"
+#include "service303.h"
+
+#define USEC_PER_MSEC 1000
+/* Traces of procedures that never end (lost messages, abandoned UEs) */
+#define TRACE_TIMEOUT_USEC (60 * 1000000)
+#define TRACE_MAX_ACTIVE 100000
+#define TRACE_MAX_KEYS 4
+#define TRACE_MAX_SPANS 32
+
+typedef struct trace_span_s {
+  trace_stage_t stage;
+  int64_t start_usec;
+  int64_t end_usec;
+} trace_span_t;
+
+typedef struct trace_record_s {
+  trace_key_t keys[TRACE_MAX_KEYS];
+  uint8_t nb_keys;
+  trace_procedure_t procedure;
+  bool sampled;
+  int64_t start_usec;
+  int64_t open_usec[TRACE_STAGE_MAX]; /* Start of the open spans, or 0 */
+  int64_t stage_usec[TRACE_STAGE_MAX];
+  uint8_t nb_spans;
+  trace_span_t spans[TRACE_MAX_SPANS]; /* First ones, for the dump */
+  TAILQ_ENTRY(trace_record_s) entries;
+} trace_record_t;
+
+static const char* const _procedure_names[TRACE_PROCEDURE_MAX] = {
+    "none", "attach", "service_request", "tau", "detach", "dedicated_bearer",
+};
+
+static const char* const _stage_names[TRACE_STAGE_MAX] = {
+    "s1ap",      "nas",        "s6a_air", "s6a_ulr", "spgw",
+    "sessiond",  "mobilityd",  "gtp_tunnel", "enb",  "state_write",
+};
+
+static pthread_mutex_t _lock = PTHREAD_MUTEX_INITIALIZER;
+/* Written under _lock, read without it to skip the lock when disabled */
+static bool _enabled;
+static uint32_t _sample_rate;
+static uint64_t _nb_traced;
+static FILE* _file;
+static hash_table_t* _records; /* By key, one entry per key of a record */
+static TAILQ_HEAD(trace_records_s, trace_record_s)
+    _by_start = TAILQ_HEAD_INITIALIZER(_by_start);
+static uint32_t _nb_records;
+static __thread int64_t _task_message_usec;
+
+//------------------------------------------------------------------------------
+// The records are freed through _by_start, the table only references them
+static void _no_free(void** record) {}
+
+//------------------------------------------------------------------------------
+const char* procedure_trace_procedure_name(trace_procedure_t procedure) {
+  return procedure < TRACE_PROCEDURE_MAX ? _procedure_names[procedure] : "?";
+}
+
+//------------------------------------------------------------------------------
+const char* procedure_trace_stage_name(trace_stage_t stage) {
+  return stage < TRACE_STAGE_MAX ? _stage_names[stage] : "?";
+}
+
+//------------------------------------------------------------------------------
+// Takes _lock when tracing is enabled, procedure_trace_exit() may disable it
+// between the unlocked check and the lock
+static bool _lock_if_enabled(void) {
+  if (!__atomic_load_n(&_enabled, __ATOMIC_RELAXED)) {
+    return false;
+  }
+  pthread_mutex_lock(&_lock);
+  if (!_enabled) {
+    pthread_mutex_unlock(&_lock);
+    return false;
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+int procedure_trace_init(const procedure_trace_config_t* config) {
+  if (!config->enabled) {
+    return RETURNok;
+  }
+  pthread_mutex_lock(&_lock);
+  _sample_rate = config->sample_rate;
+  _records     = hashtable_create(
+      TRACE_MAX_ACTIVE, NULL, _no_free, bfromcstr("procedure_trace"));
+  if (!_records) {
+    pthread_mutex_unlock(&_lock);
+    return RETURNerror;
+  }
+  _records->log_enabled = false;
+  if (_sample_rate && config->file) {
+    _file = fopen(bdata(config->file), "a");
+    if (!_file) {
+      OAILOG_ERROR(
+          LOG_UTIL, "Cannot open procedure trace file %s\n",
+          bdata(config->file));
+    }
+  }
+  __atomic_store_n(&_enabled, true, __ATOMIC_RELAXED);
+  pthread_mutex_unlock(&_lock);
+  return RETURNok;
+}
+
+//------------------------------------------------------------------------------
+static trace_record_t* _find(trace_key_t key) {
+  void* record = NULL;
+
+  if (hashtable_get(_records, key, &record) != HASH_TABLE_OK) {
+    return NULL;
+  }
+  return (trace_record_t*) record;
+}
+
+//------------------------------------------------------------------------------
+static void _unlink(trace_record_t* record) {
+  void* unused = NULL;
+  uint8_t i    = 0;
+
+  for (i = 0; i < record->nb_keys; i++) {
+    hashtable_remove(_records, record->keys[i], &unused);
+  }
+  TAILQ_REMOVE(&_by_start, record, entries);
+  _nb_records--;
+}
+
+static void _release(trace_record_t* record) {
+  _unlink(record);
+  free(record);
+}
+
+//------------------------------------------------------------------------------
+static void _expire(int64_t now_usec) {
+  trace_record_t* record = NULL;
+
+  while ((record = TAILQ_FIRST(&_by_start)) &&
+         now_usec - record->start_usec > TRACE_TIMEOUT_USEC) {
+    increment_counter(
+        "mme_procedure_trace", 1, 2, "procedure",
+        procedure_trace_procedure_name(record->procedure), "result",
+        "expired");
+    _release(record);
+  }
+}
+
+//------------------------------------------------------------------------------
+static void _add_span(
+    trace_record_t* record, trace_stage_t stage, int64_t start_usec,
+    int64_t end_usec) {
+  if (start_usec > end_usec) {
+    return;
+  }
+  record->stage_usec[stage] += end_usec - start_usec;
+  if (record->nb_spans < TRACE_MAX_SPANS) {
+    record->spans[record->nb_spans++] =
+        (trace_span_t){stage, start_usec, end_usec};
+  }
+}
+
+//------------------------------------------------------------------------------
+static void _set_procedure(
+    trace_record_t* record, trace_procedure_t procedure) {
+  record->procedure = procedure;
+  record->sampled   = _sample_rate && (_nb_traced++ % _sample_rate == 0);
+}
+
+//------------------------------------------------------------------------------
+void procedure_trace_start(trace_key_t key, trace_procedure_t procedure) {
+  int64_t now_usec       = 0;
+  trace_record_t* record = NULL;
+
+  if (!_lock_if_enabled()) {
+    return;
+  }
+  now_usec = zclock_usecs();
+  _expire(now_usec);
+  if ((record = _find(key))) {
+    if (record->procedure == TRACE_PROCEDURE_NONE) {
+      _set_procedure(record, procedure);
+    }
+    pthread_mutex_unlock(&_lock);
+    return;
+  }
+  if (_nb_records >= TRACE_MAX_ACTIVE) {
+    pthread_mutex_unlock(&_lock);
+    increment_counter(
+        "mme_procedure_trace", 1, 2, "procedure",
+        procedure_trace_procedure_name(procedure), "result", "dropped");
+    return;
+  }
+  if (!(record = calloc(1, sizeof(*record)))) {
+    pthread_mutex_unlock(&_lock);
+    return;
+  }
+  record->keys[0] = key;
+  record->nb_keys = 1;
+  // The procedure started when the message that starts it was sent
+  record->start_usec = _task_message_usec && _task_message_usec < now_usec ?
+                           _task_message_usec :
+                           now_usec;
+  if (procedure != TRACE_PROCEDURE_NONE) {
+    _set_procedure(record, procedure);
+  }
+  hashtable_insert(_records, key, record);
+  TAILQ_INSERT_TAIL(&_by_start, record, entries);
+  _nb_records++;
+  pthread_mutex_unlock(&_lock);
+}
+
+//------------------------------------------------------------------------------
+void procedure_trace_alias(trace_key_t key, trace_key_t alias) {
+  trace_record_t* record = NULL;
+  trace_record_t* stale  = NULL;
+
+  if (key == alias || !_lock_if_enabled()) {
+    return;
+  }
+  if ((record = _find(key)) && record->nb_keys < TRACE_MAX_KEYS) {
+    if ((stale = _find(alias)) != record) {
+      if (stale) {
+        _release(stale);
+      }
+      record->keys[record->nb_keys++] = alias;
+      hashtable_insert(_records, alias, record);
+    }
+  }
+  pthread_mutex_unlock(&_lock);
+}
+
+//------------------------------------------------------------------------------
+void procedure_trace_span_start(trace_key_t key, trace_stage_t stage) {
+  trace_record_t* record = NULL;
+
+  if (!_lock_if_enabled()) {
+    return;
+  }
+  if ((record = _find(key))) {
+    record->open_usec[stage] = zclock_usecs();
+  }
+  pthread_mutex_unlock(&_lock);
+}
+
+//------------------------------------------------------------------------------
+void procedure_trace_span_end(trace_key_t key, trace_stage_t stage) {
+  trace_record_t* record = NULL;
+
+  if (!_lock_if_enabled()) {
+    return;
+  }
+  if ((record = _find(key)) && record->open_usec[stage]) {
+    _add_span(record, stage, record->open_usec[stage], zclock_usecs());
+    record->open_usec[stage] = 0;
+  }
+  pthread_mutex_unlock(&_lock);
+}
+
+//------------------------------------------------------------------------------
+void procedure_trace_task_message(int64_t timestamp_usec) {
+  _task_message_usec = timestamp_usec;
+}
+
+//------------------------------------------------------------------------------
+void procedure_trace_task_span(trace_key_t key, trace_stage_t stage) {
+  trace_record_t* record = NULL;
+
+  if (!_task_message_usec || !_lock_if_enabled()) {
+    return;
+  }
+  if ((record = _find(key))) {
+    _add_span(record, stage, _task_message_usec, zclock_usecs());
+  }
+  pthread_mutex_unlock(&_lock);
+}
+
+//------------------------------------------------------------------------------
+static void _dump(const trace_record_t* record, int64_t end_usec) {
+  uint8_t i = 0;
+
+  fprintf(
+      _file, "{\"procedure\":\"%s\",\"start_usec\":%" PRId64
+             ",\"latency_usec\":%" PRId64,
+      procedure_trace_procedure_name(record->procedure), record->start_usec,
+      end_usec - record->start_usec);
+  for (i = 0; i < record->nb_keys; i++) {
+    switch (record->keys[i] >> 62) {
+      case 0:
+        fprintf(_file, ",\"imsi\":\"%015" PRIu64 "\"", record->keys[i]);
+        break;
+      case 1:
+        fprintf(
+            _file, ",\"mme_ue_s1ap_id\":%" PRIu32,
+            (uint32_t) record->keys[i]);
+        break;
+      default:
+        break;
+    }
+  }
+  fprintf(_file, ",\"spans\":[");
+  for (i = 0; i < record->nb_spans; i++) {
+    fprintf(
+        _file, "%s{\"stage\":\"%s\",\"offset_usec\":%" PRId64
+               ",\"duration_usec\":%" PRId64 "}",
+        i ? "," : "", procedure_trace_stage_name(record->spans[i].stage),
+        record->spans[i].start_usec - record->start_usec,
+        record->spans[i].end_usec - record->spans[i].start_usec);
+  }
+  fprintf(_file, "]}\n");
+  fflush(_file);
+}
+
+//------------------------------------------------------------------------------
+static void _report(const trace_record_t* record, int64_t end_usec) {
+  const char* procedure = procedure_trace_procedure_name(record->procedure);
+  trace_stage_t stage   = TRACE_STAGE_S1AP;
+
+  observe_histogram(
+      "mme_procedure_latency_ms",
+      (double) (end_usec - record->start_usec) / USEC_PER_MSEC, 1,
+      "procedure", procedure, 11, 1., 5., 10., 25., 50., 100., 250., 500.,
+      1000., 2500., 5000.);
+  for (stage = TRACE_STAGE_S1AP; stage < TRACE_STAGE_MAX; stage++) {
+    if (record->stage_usec[stage]) {
+      observe_histogram(
+          "mme_procedure_stage_latency_ms",
+          (double) record->stage_usec[stage] / USEC_PER_MSEC, 2,
+          "procedure", procedure, "stage", procedure_trace_stage_name(stage),
+          9, 0.1, 0.5, 1., 5., 10., 50., 100., 500., 1000.);
+    }
+  }
+  increment_counter(
+      "mme_procedure_trace", 1, 2, "procedure", procedure, "result",
+      "completed");
+}
+
+//------------------------------------------------------------------------------
+void procedure_trace_end(trace_key_t key, trace_procedure_t procedure) {
+  int64_t now_usec       = 0;
+  trace_record_t* record = NULL;
+
+  if (!_lock_if_enabled()) {
+    return;
+  }
+  now_usec = zclock_usecs();
+  if ((record = _find(key)) && record->procedure == procedure) {
+    _unlink(record);
+    if (record->sampled && _file) {
+      _dump(record, now_usec);
+    }
+    pthread_mutex_unlock(&_lock);
+    // Reported out of the lock, the metrics have their own
+    _report(record, now_usec);
+    free(record);
+    return;
+  }
+  pthread_mutex_unlock(&_lock);
+}
+
+//------------------------------------------------------------------------------
+void procedure_trace_abort(trace_key_t key) {
+  trace_record_t* record = NULL;
+
+  if (!_lock_if_enabled()) {
+    return;
+  }
+  if ((record = _find(key))) {
+    _release(record);
+  }
+  pthread_mutex_unlock(&_lock);
+}
+
+//------------------------------------------------------------------------------
+void procedure_trace_exit(void) {
+  trace_record_t* record = NULL;
+
+  if (!_lock_if_enabled()) {
+    return;
+  }
+  __atomic_store_n(&_enabled, false, __ATOMIC_RELAXED);
+  while ((record = TAILQ_FIRST(&_by_start))) {
+    _release(record);
+  }
+  hashtable_destroy(_records);
+  _records = NULL;
+  if (_file) {
+    fclose(_file);
+    _file = NULL;
+  }
+  pthread_mutex_unlock(&_lock);
+}
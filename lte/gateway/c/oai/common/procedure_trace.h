@@ -0,0 +1,119 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file procedure_trace.h
+  \brief Latency trace of the UE procedures across the MME tasks
+
+  A trace follows one procedure of one UE (attach, service request, TAU,
+  detach, dedicated bearer) and accumulates the time spent in each stage
+  (S1AP decode, NAS, S6a, SPGW, sessiond, mobilityd, ...). Stages are
+  recorded by the tasks they run in, under whatever key the task knows the
+  UE by: the eNB UE S1AP id before the MME allocates its own id, the
+  mme_ue_s1ap_id afterwards and the IMSI in S6A, SPGW and PCEF. Keys of the
+  same UE are aliased to each other as soon as they are known together.
+
+  When the procedure ends its total and per stage latencies are observed in
+  service303 histograms, and one trace every sample_rate is written in full
+  as a line of JSON to the trace file.
+*/
+
+#ifndef FILE_PROCEDURE_TRACE_SEEN
+#define FILE_PROCEDURE_TRACE_SEEN
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "bstrlib.h"
+
+typedef uint64_t trace_key_t;
+
+/* Key spaces, the IMSI being under 2^50 */
+#define TRACE_KEY_IMSI(imsi64) ((trace_key_t)(imsi64))
+#define TRACE_KEY_MME_UE_S1AP_ID(mme_ue_s1ap_id)                               \
+  ((((trace_key_t) 1) << 62) | (uint32_t)(mme_ue_s1ap_id))
+#define TRACE_KEY_ENB_S1AP_ID(enb_s1ap_id_key)                                 \
+  ((((trace_key_t) 2) << 62) | (uint64_t)(enb_s1ap_id_key))
+
+typedef enum {
+  TRACE_PROCEDURE_NONE = 0,
+  TRACE_PROCEDURE_ATTACH,
+  TRACE_PROCEDURE_SERVICE_REQUEST,
+  TRACE_PROCEDURE_TAU,
+  TRACE_PROCEDURE_DETACH,
+  TRACE_PROCEDURE_DEDICATED_BEARER,
+  TRACE_PROCEDURE_MAX,
+} trace_procedure_t;
+
+typedef enum {
+  TRACE_STAGE_S1AP = 0,     /* S1AP decoding, TASK_S1AP */
+  TRACE_STAGE_NAS,          /* NAS processing, TASK_MME_APP */
+  TRACE_STAGE_S6A_AIR,      /* Authentication Information Request to answer */
+  TRACE_STAGE_S6A_ULR,      /* Update Location Request to answer */
+  TRACE_STAGE_SPGW,         /* S11 request to response */
+  TRACE_STAGE_SESSIOND,     /* PCEF CreateSession gRPC */
+  TRACE_STAGE_MOBILITYD,    /* UE IP address allocation gRPC */
+  TRACE_STAGE_GTP_TUNNEL,   /* GTP-U tunnel setup in the datapath */
+  TRACE_STAGE_ENB,          /* Initial context setup request to response */
+  TRACE_STAGE_STATE_WRITE,  /* UE state written to the data store */
+  TRACE_STAGE_MAX,
+} trace_stage_t;
+
+typedef struct procedure_trace_config_s {
+  bool enabled;
+  uint32_t sample_rate; /* Dump one trace every sample_rate, 0 for none */
+  bstring file;         /* Where the sampled traces are dumped */
+} procedure_trace_config_t;
+
+int procedure_trace_init(const procedure_trace_config_t* config);
+
+/* Stops tracing, the tasks may keep calling the functions below meanwhile */
+void procedure_trace_exit(void);
+
+/*
+ * Starts tracing a procedure under key. A trace started with
+ * TRACE_PROCEDURE_NONE collects stages until the procedure is known, and a
+ * procedure started while another one runs for the same UE is not traced.
+ */
+void procedure_trace_start(trace_key_t key, trace_procedure_t procedure);
+
+/* Makes alias a key of the trace of key, the trace of alias is dropped */
+void procedure_trace_alias(trace_key_t key, trace_key_t alias);
+
+/* Stage that starts in one message and ends in another */
+void procedure_trace_span_start(trace_key_t key, trace_stage_t stage);
+
+void procedure_trace_span_end(trace_key_t key, trace_stage_t stage);
+
+/*
+ * The ITTI task sets the send time of the message it handles, after which
+ * procedure_trace_task_span() records the stage from that time to now
+ */
+void procedure_trace_task_message(int64_t timestamp_usec);
+
+void procedure_trace_task_span(trace_key_t key, trace_stage_t stage);
+
+/* Ends the trace of key when it traces procedure */
+void procedure_trace_end(trace_key_t key, trace_procedure_t procedure);
+
+/* Drops the trace of key, if any, without reporting it */
+void procedure_trace_abort(trace_key_t key);
+
+const char* procedure_trace_procedure_name(trace_procedure_t procedure);
+
+const char* procedure_trace_stage_name(trace_stage_t stage);
+
+#endif /* FILE_PROCEDURE_TRACE_SEEN */
@@ -17,6 +17,8 @@
 
 #include "redis_client.h"
 
+#include <future>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -115,6 +117,43 @@ int RedisClient::write_proto(const std::string& key, const Message& proto_msg) {
   return RETURNok;
 }
 
+int RedisClient::write_new_protos(
+    const std::vector<std::pair<std::string, const Message*>>& key_protos) {
+  if (!is_connected()) {
+    return RETURNerror;
+  }
+
+  // Serialize them all first, queued commands would go with the next commit
+  std::vector<std::string> str_values(key_protos.size());
+  for (size_t i = 0; i < key_protos.size(); i++) {
+    std::string inner_val;
+    if (serialize(*key_protos[i].second, inner_val) != RETURNok) {
+      return RETURNerror;
+    }
+    orc8r::RedisState wrapper_proto = orc8r::RedisState();
+    wrapper_proto.set_serialized_msg(inner_val);
+    wrapper_proto.set_version(1);
+    if (serialize(wrapper_proto, str_values[i]) != RETURNok) {
+      return RETURNerror;
+    }
+  }
+
+  std::vector<std::future<cpp_redis::reply>> db_write_futs;
+  for (size_t i = 0; i < key_protos.size(); i++) {
+    db_write_futs.push_back(
+        db_client_->set(key_protos[i].first, str_values[i]));
+  }
+  db_client_->sync_commit();
+
+  int rc = RETURNok;
+  for (auto& db_write_fut : db_write_futs) {
+    if (db_write_fut.get().is_error()) {
+      rc = RETURNerror;
+    }
+  }
+  return rc;
+}
+
 int RedisClient::read_proto(const std::string& key, Message& proto_msg) {
   orc8r::RedisState wrapper_proto = orc8r::RedisState();
   if (read_redis_state(key, wrapper_proto) != RETURNok) {
@@ -18,6 +18,8 @@
 #pragma once
 
 #include <string>
+#include <utility>
+#include <vector>
 
 #include <cpp_redis/cpp_redis>
 #include <google/protobuf/message.h>
@@ -62,6 +64,17 @@ class RedisClient {
   int write_proto(
       const std::string& key, const google::protobuf::Message& proto_msg);
 
+  /**
+   * Writes protobuf objects to redis in a single round trip. The keys are
+   * written as new ones, at version 1, without reading their current version
+   * @param key_protos keys and the protobuf objects to write to them
+   * @return response code of operation, an error if any write failed
+   */
+  int write_new_protos(
+      const std::vector<
+          std::pair<std::string, const google::protobuf::Message*>>&
+          key_protos);
+
   /**
    * Reads value from redis mapped to key and returns proto object
    * @param key
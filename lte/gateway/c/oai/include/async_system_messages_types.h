@@ -41,7 +41,7 @@
 #define ASYNC_SYSTEM_COMMAND(mSGpTR) (mSGpTR)->ittiMsg.async_system_command
 
 typedef struct itti_async_system_command_s {
-  bstring system_command;
+  bstring system_command; /* One or more commands, one per line */
   bool is_abort_on_error;
 } itti_async_system_command_t;
 
@@ -0,0 +1,108 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file mme_app_auth_vector_cache.h
+  \brief Authentication vectors kept from one AIR for the next attaches
+*/
+
+#ifndef FILE_MME_APP_AUTH_VECTOR_CACHE_SEEN
+#define FILE_MME_APP_AUTH_VECTOR_CACHE_SEEN
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <sys/queue.h>
+
+#include "3gpp_33.401.h"
+#include "common_types.h"
+#include "hashtable.h"
+#include "intertask_interface.h"
+#include "mme_config.h"
+#include "security_types.h"
+
+#define AUTH_VECTOR_CACHE_MAX_VECTORS                                          \
+  (MAX_EPS_AUTH_VECTORS_PER_AIR - MAX_EPS_AUTH_VECTORS)
+
+/*
+ * Vectors of one IMSI that no UE context ever held, in the order of the AIA.
+ * The HSS gives the vectors of one answer increasing SQNs: they are handed
+ * out oldest first and only once.
+ */
+typedef struct cached_auth_vectors_s {
+  imsi64_t imsi64;
+  int64_t stored_usec;
+  uint8_t nb_vectors;
+  uint8_t next; /* Oldest vector not handed out */
+  eutran_vector_t vector[AUTH_VECTOR_CACHE_MAX_VECTORS];
+  TAILQ_ENTRY(cached_auth_vectors_s) lru_entries;
+} cached_auth_vectors_t;
+
+typedef struct auth_vector_cache_s {
+  const auth_vector_cache_config_t* config;
+  hash_table_t* imsis; /* imsi64 -> cached_auth_vectors_t */
+  /* Most recently stored or used first */
+  TAILQ_HEAD(cached_auth_vectors_lru_s, cached_auth_vectors_s) lru;
+  uint32_t nb_ues;
+} auth_vector_cache_t;
+
+typedef enum {
+  AUTH_VECTOR_CACHE_HIT = 0,
+  AUTH_VECTOR_CACHE_MISS,
+  AUTH_VECTOR_CACHE_EXPIRED,
+} auth_vector_cache_result_t;
+
+void auth_vector_cache_init(
+    auth_vector_cache_t* cache, const auth_vector_cache_config_t* config);
+
+void auth_vector_cache_free(auth_vector_cache_t* cache);
+
+/*
+ * Keeps the vectors of an AIA in place of the ones kept for the IMSI, which
+ * have lower SQNs, evicting the least recently used IMSI when full
+ */
+void auth_vector_cache_put(
+    auth_vector_cache_t* cache, imsi64_t imsi64, uint8_t nb_vectors,
+    const eutran_vector_t* vectors, int64_t now_usec);
+
+/* Hands out the oldest vector kept for the IMSI, if not older than the TTL */
+auth_vector_cache_result_t auth_vector_cache_take(
+    auth_vector_cache_t* cache, imsi64_t imsi64, eutran_vector_t* vector,
+    int64_t now_usec);
+
+/* Forgets the vectors of the IMSI, reason is the metric label */
+void auth_vector_cache_drop(
+    auth_vector_cache_t* cache, imsi64_t imsi64, const char* reason);
+
+/*
+ * TASK_MME_APP side. The cache is consulted before each AIR: a hit answers
+ * the AIR with an S6A_AUTH_INFO_ANS to TASK_MME_APP itself, a miss asks the
+ * HSS for auth_vector_cache_config_t.vectors_per_air vectors.
+ */
+void mme_app_auth_vector_cache_start(void);
+
+void mme_app_auth_vector_cache_stop(void);
+
+/* Returns true when the AIR was answered from the cache and freed */
+bool mme_app_auth_vector_cache_answer_air(MessageDef* message_p);
+
+/* Keeps the vectors of an AIA that the UE context does not hold */
+void mme_app_auth_vector_cache_store(
+    imsi64_t imsi64, uint8_t nb_vectors, const eutran_vector_t* vectors);
+
+/* The kept vectors of the IMSI may have fallen behind the SQN of the USIM */
+void mme_app_auth_vector_cache_invalidate(imsi64_t imsi64, const char* reason);
+
+#endif /* FILE_MME_APP_AUTH_VECTOR_CACHE_SEEN */
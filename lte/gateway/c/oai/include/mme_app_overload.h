@@ -0,0 +1,87 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file mme_app_overload.h
+  \brief MME overload control, 3GPP TS 23.401 section 4.3.7.4.1
+*/
+
+#ifndef FILE_MME_APP_OVERLOAD_SEEN
+#define FILE_MME_APP_OVERLOAD_SEEN
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "intertask_interface.h"
+#include "mme_config.h"
+
+/* Period of the overload evaluation, also the AIR release granularity */
+#define MME_APP_OVERLOAD_TIMER_MS 100
+
+/*
+ * The MME is overloaded when any signal enabled in overload_config_t reaches
+ * its high watermark, and stays overloaded until all of them are back under
+ * their low watermark.
+ */
+typedef struct mme_app_overload_s {
+  const overload_config_t* config;
+  bool overloaded;
+  uint32_t procedures; /* Attach and TAU procedures running */
+  /* Latest samples, in microseconds */
+  int64_t mme_app_latency_usec;
+  int64_t s6a_latency_usec;
+  /* AIR token bucket, in thousandths of a token */
+  uint64_t air_tokens;
+  int64_t air_refill_usec;
+} mme_app_overload_t;
+
+void mme_app_overload_init(
+    mme_app_overload_t* overload, const overload_config_t* config,
+    int64_t now_usec);
+
+/* Returns true when the MME entered or left overload */
+bool mme_app_overload_update(
+    mme_app_overload_t* overload, int64_t mme_app_latency_usec,
+    int64_t s6a_latency_usec);
+
+/* Takes the token of one AIR, false when the AIR has to be deferred */
+bool mme_app_overload_take_air_token(
+    mme_app_overload_t* overload, int64_t now_usec);
+
+/*
+ * T3346 value for one rejected UE, spread over [t3346 / 2, 3 * t3346 / 2]
+ * so that the back-offs of UEs rejected together do not expire together,
+ * 3GPP TS 24.301 section 5.3.9
+ */
+uint32_t mme_app_overload_spread_t3346(uint32_t t3346_sec, uint32_t random);
+
+/*
+ * TASK_MME_APP side: NAS reports its procedures and sends its AIRs through
+ * these, a periodic timer on the MME_APP loop updates the state
+ */
+void mme_app_overload_start(task_zmq_ctx_t* task_zmq_ctx);
+
+void mme_app_overload_stop(task_zmq_ctx_t* task_zmq_ctx);
+
+void mme_app_overload_procedure_started(void);
+
+void mme_app_overload_procedure_ended(void);
+
+bool mme_app_overload_reject_attach(void);
+
+void mme_app_overload_send_air(MessageDef* message_p);
+
+#endif /* FILE_MME_APP_OVERLOAD_SEEN */
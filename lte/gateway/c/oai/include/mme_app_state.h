@@ -58,6 +58,14 @@ void put_mme_ue_state(mme_app_desc_t* mme_app_desc_p, imsi64_t imsi64);
 // Deletes entry for UE MME state on db
 void delete_mme_ue_state(imsi64_t imsi64);
 
+// Writes the UE MME states of UEs evicted from memory to db, in one round trip
+int put_evicted_mme_ue_states(
+    const ue_mm_context_t* const* ue_contexts, int nb_ue_contexts);
+// Reads back the state of an evicted UE into a zeroed UE context
+int get_evicted_mme_ue_state(imsi64_t imsi64, ue_mm_context_t* ue_context);
+// Deletes entry for evicted UE MME state on db
+void delete_evicted_mme_ue_state(imsi64_t imsi64);
+
 #ifdef __cplusplus
 }
 #endif
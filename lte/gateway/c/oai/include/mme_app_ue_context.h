@@ -334,15 +334,26 @@ typedef struct sgs_context_s {
  * according to 3GPP TS.23.401 #5.7.2
  */
 typedef struct ue_mm_context_s {
+  /* Keys of the UE context maps and states first, they are read by every
+   * procedure. Parts only some UEs use are allocated when needed */
+  /* MME UE S1AP ID, Unique identity the UE within MME */
+  mme_ue_s1ap_id_t mme_ue_s1ap_id;
+  /* eNB UE S1AP ID,  Unique identity the UE within eNodeB */
+  enb_ue_s1ap_id_t enb_ue_s1ap_id : 24;
+  /* enb_s1ap_id_key = enb-ue-s1ap-id <24 bits> | enb-id <8 bits> */
+  enb_s1ap_id_key_t enb_s1ap_id_key;
+  teid_t mme_teid_s11;
+  /* SCTP assoc id */
+  sctp_assoc_id_t sctp_assoc_id_key;
+  mm_state_t mm_state;
+  ecm_state_t ecm_state;
+  enum s1cause ue_context_rel_cause;
+
   /* msisdn: The basic MSISDN of the UE. The presence is dictated by its storage
    *         in the HSS, set by S6A UPDATE LOCATION ANSWER
    */
   bstring msisdn;
 
-  enum s1cause ue_context_rel_cause;
-  mm_state_t mm_state;
-  ecm_state_t ecm_state;
-
   /* Last known E-UTRAN cell, set by nas_attach_req_t */
   ecgi_t e_utran_cgi;
 
@@ -354,8 +365,9 @@ typedef struct ue_mm_context_s {
   /* TODO: add csg_membership */
   /* TODO Access mode: Access mode of last known ECGI when the UE was active */
 
-  /* apn_config_profile: set by S6A UPDATE LOCATION ANSWER */
-  apn_config_profile_t apn_config_profile;
+  /* apn_config_profile: set by S6A UPDATE LOCATION ANSWER, see
+   * mme_app_set_apn_config_profile() */
+  ue_apn_config_profile_t apn_config_profile;
 
   /* charging_characteristics: set by S6A UPDATE LOCATION ANSWER */
   charging_characteristics_t default_charging_characteristics;
@@ -372,17 +384,6 @@ typedef struct ue_mm_context_s {
    *           subscriber's profile. See TS 23.003 [9] clause 9.1.2 for more
    */
   bstring apn_oi_replacement;
-  teid_t mme_teid_s11;
-  /* SCTP assoc id */
-  sctp_assoc_id_t sctp_assoc_id_key;
-
-  /* eNB UE S1AP ID,  Unique identity the UE within eNodeB */
-  enb_ue_s1ap_id_t enb_ue_s1ap_id : 24;
-  /* enb_s1ap_id_key = enb-ue-s1ap-id <24 bits> | enb-id <8 bits> */
-  enb_s1ap_id_key_t enb_s1ap_id_key;
-
-  /* MME UE S1AP ID, Unique identity the UE within MME */
-  mme_ue_s1ap_id_t mme_ue_s1ap_id;
 
   /* Subscribed UE-AMBR: The Maximum Aggregated uplink and downlink MBR values
    *           to be shared across all Non-GBR bearers according to the
@@ -420,6 +421,11 @@ typedef struct ue_mm_context_s {
    */
   struct mme_app_timer_t implicit_detach_timer;
   time_t time_implicit_detach_timer_started;
+  /* time_ecm_idle_started: Set when UE moves to idle state, the context can
+   * be evicted to the data store after some idle time, see
+   * mme_app_ue_eviction.h
+   */
+  time_t time_ecm_idle_started;
   /* Initial Context Setup Procedure Guard timer */
   struct mme_app_timer_t initial_context_setup_rsp_timer;
   time_t time_ics_rsp_timer_started;
@@ -472,8 +478,16 @@ typedef struct mme_ue_context_s {
   hash_table_uint64_ts_t*
       enb_ue_s1ap_id_ue_context_htbl;             // data is mme_ue_s1ap_id_t
   obj_hash_table_uint64_t* guti_ue_context_htbl;  // data is mme_ue_s1ap_id_t
+  /* Lookup index of the GUTIs of guti_ue_context_htbl by their S-TMSI part,
+   * see MME_APP_S_TMSI_KEY(). Not persisted, rebuilt from the GUTI table */
+  hash_table_uint64_ts_t* s_tmsi_ue_context_htbl;  // data is mme_ue_s1ap_id_t
 } mme_ue_context_t;
 
+/* Key of s_tmsi_ue_context_htbl: the MMEC over the M-TMSI. The PLMN and
+ * MMEGI of the GUTI are checked on the UE context found */
+#define MME_APP_S_TMSI_KEY(mme_code, m_tmsi)                                   \
+  ((((uint64_t)(mme_code)) << 32) | (uint32_t)(m_tmsi))
+
 /** \brief Retrieve an UE context by selecting the provided IMSI
  * \param imsi Imsi to find in UE map
  * @returns an UE context matching the IMSI or NULL if the context doesn't
@@ -514,6 +528,39 @@ ue_mm_context_t* mme_ue_context_exists_enb_ue_s1ap_id(
 ue_mm_context_t* mme_ue_context_exists_guti(
     mme_ue_context_t* const mme_ue_context, const guti_t* const guti);
 
+/** \brief Retrieve an UE context by selecting the provided S-TMSI
+ * \param s_tmsi The S-TMSI sent by the UE
+ * @returns an UE context matching the S-TMSI or NULL if the context doesn't
+ *exists
+ **/
+ue_mm_context_t* mme_ue_context_exists_s_tmsi(
+    mme_ue_context_t* const mme_ue_context, const s_tmsi_t* const s_tmsi);
+
+/** \brief Check that the MME config serves a GUMMEI, before looking up a GUTI
+ * \param gummei The GUMMEI of the GUTI
+ * @returns true if a GUMMEI of the MME config has the PLMN, MME group id and
+ *MME code
+ **/
+bool mme_app_is_served_gummei(const gummei_t* const gummei);
+
+/** \brief Check that the MME config serves an S-TMSI, which carries no PLMN
+ *nor MME group id
+ * \param plmn The PLMN of the TAI the S-TMSI was received in
+ * \param s_tmsi The S-TMSI sent by the UE
+ * @returns true if a GUMMEI of the MME config has the PLMN and MME code
+ **/
+bool mme_app_is_served_s_tmsi(
+    const plmn_t* const plmn, const s_tmsi_t* const s_tmsi);
+
+/* Add and remove a GUTI of guti_ue_context_htbl in s_tmsi_ue_context_htbl */
+void mme_app_s_tmsi_index_insert(
+    mme_ue_context_t* const mme_ue_context, const guti_t* const guti,
+    const mme_ue_s1ap_id_t mme_ue_s1ap_id);
+
+void mme_app_s_tmsi_index_remove(
+    mme_ue_context_t* const mme_ue_context, const guti_t* const guti,
+    const mme_ue_s1ap_id_t mme_ue_s1ap_id);
+
 /** \brief Move the content of a context to another context
  * \param dst            The destination context
  * \param src            The source context
@@ -577,6 +624,13 @@ ue_mm_context_t* mme_create_new_ue_context(void);
 
 void mme_app_ue_context_free_content(ue_mm_context_t* const mme_ue_context_p);
 
+/** \brief Replace the APN configuration profile of a UE context with a copy
+ * of the nb_apns configurations of apn_config_profile
+ **/
+void mme_app_set_apn_config_profile(
+    ue_mm_context_t* const ue_context_p,
+    const apn_config_profile_t* const apn_config_profile);
+
 /**
  * Release memory allocated by MmeNasStateManager through MmeNasStateConverter
  * and NasStateConverter for each UE context, this is called by
@@ -0,0 +1,94 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file mme_app_ue_eviction.h
+  \brief Eviction of the contexts of idle UEs to the data store
+*/
+
+#ifndef FILE_MME_APP_UE_EVICTION_SEEN
+#define FILE_MME_APP_UE_EVICTION_SEEN
+
+#include <stdbool.h>
+#include <sys/queue.h>
+#include <time.h>
+
+#include "common_types.h"
+#include "intertask_interface.h"
+#include "mme_app_ue_context.h"
+
+/* Period of the eviction sweep */
+#define MME_APP_UE_EVICTION_TIMER_MS 1000
+/* UEs written to the data store in one round trip by the sweep */
+#define MME_APP_UE_EVICTION_BATCH_SIZE 64
+
+/*
+ * What stays in memory of an evicted UE. The IMSI, GUTI and S11 TEID maps
+ * of mme_ue_context_t keep pointing at its mme_ue_s1ap_id, and the lookups
+ * by IMSI, S11 TEID, S-TMSI or GUTI read the context back. Lookups by
+ * mme_ue_s1ap_id or eNB UE S1AP id see an evicted UE as unknown.
+ */
+typedef struct mme_app_evicted_ue_s {
+  mme_ue_s1ap_id_t mme_ue_s1ap_id;
+  teid_t mme_teid_s11;
+  imsi64_t imsi64;
+  guti_t guti;
+  time_t evicted_at;
+  /* Earliest expiry of the mobile reachability and implicit detach timers,
+   * the context is read back then to run it. 0 when none is running */
+  time_t wake_at;
+  bool hss_reset; /* S6a reset received while evicted */
+  TAILQ_ENTRY(mme_app_evicted_ue_s) wake_entries;
+} mme_app_evicted_ue_t;
+
+/*
+ * Only registered ECM-IDLE UEs without any procedure or procedure timer
+ * running are evicted, the state converters do not carry these
+ */
+bool mme_app_ue_is_evictable(const ue_mm_context_t* ue_context_p);
+
+/* Returns the earliest expiry of the idle mode timers, 0 for none */
+time_t mme_app_ue_eviction_wake_time(const ue_mm_context_t* ue_context_p);
+
+/*
+ * TASK_MME_APP side: a periodic timer on the MME_APP loop evicts the UEs
+ * idle for longer than ue_eviction_config_t.idle_time_sec
+ */
+void mme_app_ue_eviction_start(task_zmq_ctx_t* task_zmq_ctx);
+
+void mme_app_ue_eviction_stop(task_zmq_ctx_t* task_zmq_ctx);
+
+/*
+ * One run of the periodic timer: reads back the evicted UEs whose idle mode
+ * timers expire by now, then evicts the UEs due by now
+ */
+void mme_app_ue_eviction_sweep(time_t now);
+
+/* Called when the UE moves to ECM_IDLE */
+void mme_app_ue_eviction_ue_idle(ue_mm_context_t* ue_context_p);
+
+/*
+ * Reads back the context of an evicted UE and puts it back in the UE state
+ * table, NULL if the UE is not evicted. Timers that expired meanwhile are
+ * run from the MME_APP loop, not from the caller. Called by the keyed
+ * lookups of mme_app_context.c and by the sweep.
+ */
+ue_mm_context_t* mme_app_ue_rehydrate(mme_ue_s1ap_id_t mme_ue_s1ap_id);
+
+/* HSS restarted: evicted UEs send an ULR on their next connection */
+void mme_app_ue_eviction_hss_reset(void);
+
+#endif /* FILE_MME_APP_UE_EVICTION_SEEN */
@@ -46,6 +46,7 @@
 #include "3gpp_23.003.h"
 #include "3gpp_24.008.h"
 #include "log.h"
+#include "procedure_trace.h"
 #include "service303.h"
 
 /* Currently supporting max 5 GUMMEI's in the mme configuration */
@@ -122,6 +123,8 @@
 #define MME_CONFIG_STRING_IPV4_ADDRESS_FOR_S11_MME                             \
   "MME_IPV4_ADDRESS_FOR_S11_MME"
 #define MME_CONFIG_STRING_MME_PORT_FOR_S11 "MME_PORT_FOR_S11_MME"
+#define MME_CONFIG_STRING_MME_RECEIVE_SOCKETS_FOR_S11                          \
+  "MME_RECEIVE_SOCKETS_FOR_S11_MME"
 #define MME_CONFIG_STRING_SGW_INTERFACE_NAME_FOR_S11                           \
   "SGW_INTERFACE_NAME_FOR_S11"
 #define MME_CONFIG_STRING_SGW_IPV4_ADDRESS_FOR_S11 "SGW_IPV4_ADDRESS_FOR_S11"
@@ -142,6 +145,7 @@
 #define MME_CONFIG_STRING_NAS_T3486_TIMER "T3486"
 #define MME_CONFIG_STRING_NAS_T3489_TIMER "T3489"
 #define MME_CONFIG_STRING_NAS_T3495_TIMER "T3495"
+#define MME_CONFIG_STRING_NAS_T3346_TIMER "T3346"
 #define MME_CONFIG_STRING_NAS_FORCE_REJECT_TAU "FORCE_REJECT_TAU"
 #define MME_CONFIG_STRING_NAS_FORCE_REJECT_SR "FORCE_REJECT_SR"
 #define MME_CONFIG_STRING_NAS_DISABLE_ESM_INFORMATION_PROCEDURE                \
@@ -155,6 +159,45 @@
 #define MME_CONFIG_STRING_NAS_APN_CORRECTION_MAP_APN_OVERRIDE                  \
   "APN_CORRECTION_MAP_APN_OVERRIDE"
 
+#define MME_CONFIG_STRING_OVERLOAD_CONFIG "OVERLOAD"
+#define MME_CONFIG_STRING_MME_APP_QUEUE_LATENCY_HIGH                           \
+  "MME_APP_QUEUE_LATENCY_HIGH"
+#define MME_CONFIG_STRING_MME_APP_QUEUE_LATENCY_LOW "MME_APP_QUEUE_LATENCY_LOW"
+#define MME_CONFIG_STRING_S6A_QUEUE_LATENCY_HIGH "S6A_QUEUE_LATENCY_HIGH"
+#define MME_CONFIG_STRING_S6A_QUEUE_LATENCY_LOW "S6A_QUEUE_LATENCY_LOW"
+#define MME_CONFIG_STRING_OUTSTANDING_PROCEDURES_HIGH                          \
+  "OUTSTANDING_PROCEDURES_HIGH"
+#define MME_CONFIG_STRING_OUTSTANDING_PROCEDURES_LOW                           \
+  "OUTSTANDING_PROCEDURES_LOW"
+#define MME_CONFIG_STRING_OVERLOAD_ACTION "OVERLOAD_ACTION"
+#define MME_CONFIG_STRING_OVERLOAD_ACTION_REJECT_NON_EMERGENCY_MO_DT           \
+  "REJECT_NON_EMERGENCY_MO_DT"
+#define MME_CONFIG_STRING_OVERLOAD_ACTION_REJECT_RRC_CR_SIGNALLING             \
+  "REJECT_RRC_CR_SIGNALLING"
+#define MME_CONFIG_STRING_OVERLOAD_ACTION_PERMIT_EMERGENCY_AND_MT_ONLY         \
+  "PERMIT_EMERGENCY_AND_MT_ONLY"
+#define MME_CONFIG_STRING_OVERLOAD_ACTION_PERMIT_HIGH_PRIORITY_AND_MT_ONLY     \
+  "PERMIT_HIGH_PRIORITY_AND_MT_ONLY"
+#define MME_CONFIG_STRING_OVERLOAD_ACTION_REJECT_DELAY_TOLERANT_ACCESS         \
+  "REJECT_DELAY_TOLERANT_ACCESS"
+#define MME_CONFIG_STRING_TRAFFIC_LOAD_REDUCTION "TRAFFIC_LOAD_REDUCTION"
+#define MME_CONFIG_STRING_S6A_AIR_RATE "S6A_AIR_RATE"
+#define MME_CONFIG_STRING_S6A_AIR_BURST "S6A_AIR_BURST"
+
+#define MME_CONFIG_STRING_UE_EVICTION_CONFIG "UE_EVICTION"
+#define MME_CONFIG_STRING_UE_EVICTION_IDLE_TIME "IDLE_TIME"
+#define MME_CONFIG_STRING_UE_EVICTION_MAX_PER_SWEEP "MAX_PER_SWEEP"
+
+#define MME_CONFIG_STRING_AUTH_VECTOR_CACHE_CONFIG "AUTH_VECTOR_CACHE"
+#define MME_CONFIG_STRING_AUTH_VECTOR_CACHE_MAX_UES "MAX_UES"
+#define MME_CONFIG_STRING_AUTH_VECTOR_CACHE_VECTORS_PER_AIR "VECTORS_PER_AIR"
+#define MME_CONFIG_STRING_AUTH_VECTOR_CACHE_TTL "TTL"
+
+#define MME_CONFIG_STRING_PROCEDURE_TRACE_CONFIG "PROCEDURE_TRACE"
+#define MME_CONFIG_STRING_PROCEDURE_TRACE_ENABLED "ENABLED"
+#define MME_CONFIG_STRING_PROCEDURE_TRACE_SAMPLE_RATE "SAMPLE_RATE"
+#define MME_CONFIG_STRING_PROCEDURE_TRACE_FILE "FILE"
+
 #define MME_CONFIG_STRING_SGW_CONFIG "S-GW"
 
 #define MME_CONFIG_STRING_SGS_CONFIG "SGS"
@@ -227,6 +270,8 @@ typedef struct ip_s {
   struct in6_addr s11_mme_v6;
   int netmask_s11;
   uint16_t port_s11;
+  /* Sockets sharing port_s11 through SO_REUSEPORT, each with its reader */
+  uint8_t nb_receive_sockets_s11;
 } ip_t;
 
 typedef struct s6a_config_s {
@@ -262,6 +307,7 @@ typedef struct nas_config_s {
   uint32_t t3486_sec;
   uint32_t t3489_sec;
   uint32_t t3495_sec;
+  uint32_t t3346_sec;
   // non standard features
   bool force_reject_tau;
   bool force_reject_sr;
@@ -279,6 +325,33 @@ typedef struct sgs_config_s {
   uint32_t ts13_sec;
 } sgs_config_t;
 
+/* Watermarks of 0 disable the signal, an AIR rate of 0 disables pacing */
+typedef struct overload_config_s {
+  uint32_t mme_app_latency_high_ms;
+  uint32_t mme_app_latency_low_ms;
+  uint32_t s6a_latency_high_ms;
+  uint32_t s6a_latency_low_ms;
+  uint32_t procedures_high;
+  uint32_t procedures_low;
+  uint8_t overload_action;        /* OVERLOAD_ACTION_* of 3GPP TS 36.413 */
+  uint8_t traffic_load_reduction; /* Percentage, 1..99, 0 to omit it */
+  uint32_t air_rate;              /* AIR per second */
+  uint32_t air_burst;             /* AIR sent at once, defaults to air_rate */
+} overload_config_t;
+
+/* An idle time of 0 keeps every UE context in memory */
+typedef struct ue_eviction_config_s {
+  uint32_t idle_time_sec; /* ECM-IDLE time before a UE context is evicted */
+  uint32_t max_per_sweep; /* UE contexts evicted at most each second */
+} ue_eviction_config_t;
+
+/* A size of 0 disables the cache, AIRs then ask for MAX_EPS_AUTH_VECTORS */
+typedef struct auth_vector_cache_config_s {
+  uint32_t max_ues;         /* IMSIs with vectors kept */
+  uint32_t vectors_per_air; /* 2..MAX_EPS_AUTH_VECTORS_PER_AIR */
+  uint32_t ttl_sec;         /* Age after which kept vectors are not used */
+} auth_vector_cache_config_t;
+
 #define MME_CONFIG_MAX_SGW 16
 typedef struct e_dns_config_s {
   int nb_sgw_entries;
@@ -329,6 +402,10 @@ typedef struct mme_config_s {
   itti_config_t itti_config;
   nas_config_t nas_config;
   sgs_config_t sgs_config;
+  overload_config_t overload_config;
+  ue_eviction_config_t ue_eviction_config;
+  auth_vector_cache_config_t auth_vector_cache_config;
+  procedure_trace_config_t procedure_trace_config;
   log_config_t log_config;
   e_dns_config_t e_dns_emulation;
 
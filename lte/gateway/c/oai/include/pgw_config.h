@@ -55,6 +55,7 @@
 #define PGW_CONFIG_STRING_DEFAULT_DNS_SEC_IPV4_ADDRESS                         \
   "DEFAULT_DNS_SEC_IPV4_ADDRESS"
 #define PGW_CONFIG_STRING_UE_MTU "UE_MTU"
+#define PGW_CONFIG_STRING_UE_IP_LEASE_POOL_SIZE "UE_IP_LEASE_POOL_SIZE"
 #define PGW_CONFIG_STRING_GTPV1U_REALIZATION "GTPV1U_REALIZATION"
 #define PGW_CONFIG_STRING_NO_GTP_KERNEL_AVAILABLE "NO_GTP_KERNEL_AVAILABLE"
 #define PGW_CONFIG_STRING_GTP_KERNEL_MODULE "GTP_KERNEL_MODULE"
@@ -116,6 +117,8 @@ typedef struct pgw_config_s {
   bool force_push_pco;
   uint16_t ue_mtu;
   bool enable_nat;
+  // UE IPv4 addresses reserved from mobilityd per APN, 0 when disabled
+  uint32_t ue_ip_lease_pool_size;
 
   struct {
     bool enabled;
@@ -118,3 +118,5 @@ MESSAGE_DEF(
 MESSAGE_DEF(
     S1AP_REMOVE_STALE_UE_CONTEXT, itti_s1ap_remove_stale_ue_context_t,
     s1ap_remove_stale_ue_context)
+MESSAGE_DEF(S1AP_OVERLOAD_START, itti_s1ap_overload_t, s1ap_overload_start)
+MESSAGE_DEF(S1AP_OVERLOAD_STOP, itti_s1ap_overload_t, s1ap_overload_stop)
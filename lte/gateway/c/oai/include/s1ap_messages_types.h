@@ -80,6 +80,8 @@
   (mSGpTR)->ittiMsg.s1ap_path_switch_request_failure
 #define S1AP_REMOVE_STALE_UE_CONTEXT(mSGpTR)                                   \
   (mSGpTR)->ittiMsg.s1ap_remove_stale_ue_context
+#define S1AP_OVERLOAD_START(mSGpTR) (mSGpTR)->ittiMsg.s1ap_overload_start
+#define S1AP_OVERLOAD_STOP(mSGpTR) (mSGpTR)->ittiMsg.s1ap_overload_stop
 
 // NOT a ITTI message
 typedef struct s1ap_initial_ue_message_s {
@@ -350,4 +352,9 @@ typedef struct itti_s1ap_path_switch_request_failure_s {
   enb_ue_s1ap_id_t enb_ue_s1ap_id : 24;
   mme_ue_s1ap_id_t mme_ue_s1ap_id;
 } itti_s1ap_path_switch_request_failure_t;
+
+typedef struct itti_s1ap_overload_s {
+  uint8_t overload_action;        /* OVERLOAD_ACTION_*, 3GPP TS 36.413 */
+  uint8_t traffic_load_reduction; /* Percentage, 0 when not signalled */
+} itti_s1ap_overload_t;
 #endif /* FILE_S1AP_MESSAGES_TYPES_SEEN */
@@ -59,6 +59,13 @@
 #define SGW_CONFIG_STRING_OVS_UPLINK_PORT_NUM "UPLINK_PORT_NUM"
 #define SGW_CONFIG_STRING_OVS_UPLINK_MAC "UPLINK_MAC"
 #define SGW_CONFIG_STRING_OVS_MULTI_TUNNEL "MULTI_TUNNEL"
+#define SGW_CONFIG_STRING_OVS_PAGING_SUPPRESSION_WINDOW                        \
+  "PAGING_SUPPRESSION_WINDOW"
+#define SGW_CONFIG_STRING_OVS_PAGING_RATE "PAGING_RATE"
+#define SGW_CONFIG_STRING_OVS_PAGING_BURST "PAGING_BURST"
+
+// Seconds between pagings of one UE IP, also its packet-in clamping time
+#define OVS_PAGING_SUPPRESSION_WINDOW_DEFAULT 30
 
 #define SPGW_ABORT_ON_ERROR true
 #define SPGW_WARN_ON_ERROR false
@@ -72,6 +79,9 @@ typedef struct ovs_config_s {
   int uplink_port_num;
   bstring uplink_mac;
   bool multi_tunnel;
+  uint32_t paging_suppression_window;
+  uint32_t paging_rate;  // pagings per second, 0 for no limit
+  uint32_t paging_burst;
 } ovs_config_t;
 
 typedef struct sgw_config_s {
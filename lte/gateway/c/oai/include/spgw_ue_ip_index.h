@@ -0,0 +1,76 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*
+ * Index of the addresses allocated to UEs by IMSI, for paging. The SPGW task
+ * keeps it up to date and the OpenFlow controller thread reads it, so it is
+ * kept out of spgw_state_t, whose accessor is only safe on the SPGW task.
+ */
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <netinet/in.h>
+
+#include "common_types.h"
+
+// Creates the index, before the SPGW state is read from the data store
+int spgw_ue_ip_index_init(void);
+// Frees the index
+void spgw_ue_ip_index_exit(void);
+
+/**
+ * Indexes the UE addresses of a PDN connection by IMSI for paging
+ * @param paa addresses allocated to the UE
+ * @param imsi64
+ */
+void spgw_add_ue_ip_imsi(const paa_t* paa, imsi64_t imsi64);
+
+/**
+ * Removes the UE addresses of a PDN connection from the paging index, unless
+ * they were allocated to another IMSI since
+ * @param paa addresses allocated to the UE
+ * @param imsi64
+ */
+void spgw_remove_ue_ip_imsi(const paa_t* paa, imsi64_t imsi64);
+
+/**
+ * Looks up the IMSI a UE address is allocated to, without leaving the process
+ * @return RETURNok when found, RETURNerror otherwise
+ */
+int spgw_get_imsi_from_ue_ipv4(const struct in_addr* ue_ipv4, imsi64_t* imsi64);
+int spgw_get_imsi_from_ue_ipv6(
+    const struct in6_addr* ue_ipv6, imsi64_t* imsi64);
+
+/**
+ * Resolves the IMSI a UE address is allocated to for paging, asking mobilityd
+ * for the addresses missing from the index
+ * @param ue_ipv4
+ * @param imsi64 (out)
+ * @param from_mobilityd (out) whether the index missed
+ * @return RETURNok when found, the mobilityd error otherwise
+ */
+int spgw_resolve_imsi_from_ue_ipv4(
+    const struct in_addr* ue_ipv4, imsi64_t* imsi64, bool* from_mobilityd);
+
+#ifdef __cplusplus
+}
+#endif
@@ -33,6 +33,8 @@ typedef struct {
   struct in_addr* in_addr;
   struct in6_addr* in6_addr;
   uint16_t port;
+  /* Sockets sharing a non zero port, all but the first read by a thread */
+  uint8_t nb_receive_sockets;
 } udp_init_t;
 
 typedef struct {
@@ -1212,6 +1212,7 @@ typedef enum gprs_common_ie_e {
   GPRS_C_TIMER_3423_VALUE_IEI          = 0x59, /* 0x59 = 89 */
   GPRS_C_TIMER_3412_VALUE_IEI          = 0x5A, /* 0x5A = 90 */
   GPRS_C_TIMER_3412_EXTENDED_VALUE_IEI = 0x5E, /* 0x5E = 94 */
+  GPRS_C_TIMER_3346_VALUE_IEI          = 0x5F, /* 0x5F = 95 */
 } gprs_common_ie_t;
 
 //------------------------------------------------------------------------------
@@ -1236,4 +1237,18 @@ int decode_gprs_timer_ie(
     gprs_timer_t* gprstimer, uint8_t iei, uint8_t* buffer, const uint32_t len);
 long gprs_timer_value(gprs_timer_t* gprstimer);
 
+//------------------------------------------------------------------------------
+// 10.5.7.4 GPRS Timer 2
+//------------------------------------------------------------------------------
+// Same value octet as GPRS Timer, carried in a TLV (T3346, T3402 in rejects)
+#define GPRS_TIMER2_IE_TYPE 4
+#define GPRS_TIMER2_IE_MIN_LENGTH 3
+#define GPRS_TIMER2_IE_MAX_LENGTH 3
+
+int encode_gprs_timer2_ie(
+    gprs_timer_t* gprstimer, uint8_t iei, uint8_t* buffer, const uint32_t len);
+int decode_gprs_timer2_ie(
+    gprs_timer_t* gprstimer, uint8_t iei, uint8_t* buffer, const uint32_t len);
+void gprs_timer_set_seconds(gprs_timer_t* gprstimer, uint32_t seconds);
+
 #endif /* FILE_3GPP_24_008_SEEN */
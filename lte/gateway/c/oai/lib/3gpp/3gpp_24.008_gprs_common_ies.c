@@ -97,3 +97,69 @@ int encode_gprs_timer_ie(
 long gprs_timer_value(gprs_timer_t* gprstimer) {
   return (gprstimer->timervalue * _gprs_timer_unit[gprstimer->unit]);
 }
+
+//------------------------------------------------------------------------------
+// 10.5.7.4 GPRS Timer 2
+//------------------------------------------------------------------------------
+int decode_gprs_timer2_ie(
+    gprs_timer_t* gprstimer, uint8_t iei, uint8_t* buffer, const uint32_t len) {
+  int decoded = 0;
+
+  if (iei > 0) {
+    CHECK_PDU_POINTER_AND_LENGTH_DECODER(
+        buffer, GPRS_TIMER2_IE_MIN_LENGTH, len);
+    CHECK_IEI_DECODER(iei, *buffer);
+    decoded++;
+  } else {
+    CHECK_PDU_POINTER_AND_LENGTH_DECODER(
+        buffer, GPRS_TIMER2_IE_MIN_LENGTH - 1, len);
+  }
+
+  // Length of the contents, always 1
+  if (*(buffer + decoded) != 1) {
+    return TLV_VALUE_DOESNT_MATCH;
+  }
+  decoded++;
+  gprstimer->unit       = (*(buffer + decoded) >> 5) & 0x7;
+  gprstimer->timervalue = *(buffer + decoded) & 0x1f;
+  decoded++;
+  return decoded;
+}
+
+//------------------------------------------------------------------------------
+int encode_gprs_timer2_ie(
+    gprs_timer_t* gprstimer, uint8_t iei, uint8_t* buffer, const uint32_t len) {
+  uint32_t encoded = 0;
+
+  CHECK_PDU_POINTER_AND_LENGTH_ENCODER(buffer, GPRS_TIMER2_IE_MIN_LENGTH, len);
+
+  if (iei > 0) {
+    *buffer = iei;
+    encoded++;
+  }
+
+  *(buffer + encoded) = 1;
+  encoded++;
+  *(buffer + encoded) =
+      0x00 | ((gprstimer->unit & 0x7) << 5) | (gprstimer->timervalue & 0x1f);
+  encoded++;
+  return encoded;
+}
+
+//------------------------------------------------------------------------------
+// Coarsest unit that keeps the value, rounded up so a backoff never shrinks
+void gprs_timer_set_seconds(gprs_timer_t* gprstimer, uint32_t seconds) {
+  if (seconds == 0) {
+    gprstimer->unit       = GPRS_TIMER_UNIT_0S;
+    gprstimer->timervalue = 0;
+  } else if (seconds <= 31 * 2) {
+    gprstimer->unit       = GPRS_TIMER_UNIT_2S;
+    gprstimer->timervalue = (seconds + 1) / 2;
+  } else if (seconds <= 31 * 60) {
+    gprstimer->unit       = GPRS_TIMER_UNIT_60S;
+    gprstimer->timervalue = (seconds + 59) / 60;
+  } else {
+    gprstimer->unit       = GPRS_TIMER_UNIT_360S;
+    gprstimer->timervalue = seconds < 31 * 360 ? (seconds + 359) / 360 : 31;
+  }
+}
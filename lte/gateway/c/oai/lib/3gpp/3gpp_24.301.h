@@ -288,6 +288,7 @@ typedef struct ue_security_capability_s {
 #define T3450_DEFAULT_VALUE 6
 #define T3460_DEFAULT_VALUE 6
 #define T3470_DEFAULT_VALUE 6
+#define T3346_DEFAULT_VALUE 60 /* Sent to the UE, network dependent */
 
 //------------------------------------------------------------------------------
 // 10.3 Timers of EPS session management
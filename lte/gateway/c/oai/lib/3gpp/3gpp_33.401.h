@@ -43,6 +43,7 @@
 #define EEA0_ALG_ID 0b000
 #define EEA1_128_ALG_ID 0b001
 #define EEA2_128_ALG_ID 0b010
+#define EEA3_128_ALG_ID 0b011
 
 //------------------------------------------------------------------------------
 // 5.1.4.2 Algorithm Identifier Values
@@ -50,6 +51,7 @@
 #define EIA0_ALG_ID 0b000
 #define EIA1_128_ALG_ID 0b001
 #define EIA2_128_ALG_ID 0b010
+#define EIA3_128_ALG_ID 0b011
 
 //------------------------------------------------------------------------------
 // 6.1.2 Distribution of authentication data from HSS to serving network
@@ -68,4 +70,10 @@
  */
 #define MAX_EPS_AUTH_VECTORS 1
 
+/*
+ * Vectors the MME asks for at most in one AIR, 3GPP TS 29.272. The ones
+ * beyond MAX_EPS_AUTH_VECTORS are kept for the next attaches of the UE.
+ */
+#define MAX_EPS_AUTH_VECTORS_PER_AIR 5
+
 #endif /* FILE_3GPP_33_401_SEEN */
@@ -138,6 +138,14 @@ typedef struct e_rab_to_be_switched_in_downlink_list_s {
   e_rab_switched_in_downlink_item_t item[MAX_NO_OF_E_RABS];
 } e_rab_to_be_switched_in_downlink_list_t;
 
+// 9.2.3.20 Overload Action
+// Signalling an eNB has to reject while the MME is overloaded
+#define OVERLOAD_ACTION_REJECT_NON_EMERGENCY_MO_DT 0
+#define OVERLOAD_ACTION_REJECT_RRC_CR_SIGNALLING 1
+#define OVERLOAD_ACTION_PERMIT_EMERGENCY_AND_MT_ONLY 2
+#define OVERLOAD_ACTION_PERMIT_HIGH_PRIORITY_AND_MT_ONLY 3
+#define OVERLOAD_ACTION_REJECT_DELAY_TOLERANT_ACCESS 4
+
 #include "S1ap_Cause.h"
 
 typedef struct e_rab_item_s {
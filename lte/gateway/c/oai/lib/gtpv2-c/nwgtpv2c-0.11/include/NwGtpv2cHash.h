@@ -0,0 +1,112 @@
+/*----------------------------------------------------------------------------*
+ *                                                                            *
+ *                              n w - g t p v 2 c                             *
+ *    G P R S   T u n n e l i n g    P r o t o c o l   v 2 c    S t a c k     *
+ *                                                                            *
+ *                                                                            *
+ * Copyright (c) 2010-2011 Amit Chawre                                        *
+ * All rights reserved.                                                       *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in the     *
+ *    documentation and/or other materials provided with the distribution.    *
+ * 3. The name of the author may not be used to endorse or promote products   *
+ *    derived from this software without specific prior written permission.   *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR       *
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.    *
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,           *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT   *
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,  *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY      *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT        *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF   *
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.          *
+ *----------------------------------------------------------------------------*/
+
+#ifndef __NW_GTPV2C_HASH_H__
+#define __NW_GTPV2C_HASH_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "NwTypes.h"
+#include "NwError.h"
+
+/**
+ * @file NwGtpv2cHash.h
+ * @brief Intrusive chained hash table indexing the tunnels and the
+ * outstanding transactions of a gtpv2c stack.
+ *
+ * Objects embed a nw_gtpv2c_hash_node_t and set its hash before insertion or
+ * lookup. The table doubles its buckets when it holds more nodes than
+ * buckets, so lookups stay O(1) whatever the number of UEs.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct nw_gtpv2c_hash_node_s {
+  struct nw_gtpv2c_hash_node_s* next;
+  uint32_t hash;
+} nw_gtpv2c_hash_node_t;
+
+/**
+ * Returns non zero when both nodes carry the same key
+ */
+typedef int (*nw_gtpv2c_hash_equal_t)(
+    const nw_gtpv2c_hash_node_t* a, const nw_gtpv2c_hash_node_t* b);
+
+typedef struct nw_gtpv2c_hash_s {
+  nw_gtpv2c_hash_node_t** buckets;
+  uint32_t mask; /**< Number of buckets - 1, a power of 2 - 1 */
+  uint32_t count;
+  nw_gtpv2c_hash_equal_t equal;
+} nw_gtpv2c_hash_t;
+
+#define NW_GTPV2C_HASH_ENTRY(_node, _type, _member)                            \
+  ((_node) ? (_type*) ((char*) (_node) -offsetof(_type, _member)) : NULL)
+
+nw_rc_t nwGtpv2cHashInit(
+    nw_gtpv2c_hash_t* thiz, uint32_t nbBuckets, nw_gtpv2c_hash_equal_t equal);
+
+void nwGtpv2cHashFinalize(nw_gtpv2c_hash_t* thiz);
+
+/**
+ * Hash of a 32 bits key and an address of addrLen bytes
+ */
+uint32_t nwGtpv2cHashKey(uint32_t key, const void* addr, size_t addrLen);
+
+nw_gtpv2c_hash_node_t* nwGtpv2cHashFind(
+    nw_gtpv2c_hash_t* thiz, const nw_gtpv2c_hash_node_t* key);
+
+/**
+ * Inserts node unless a node with the same key is already in the table.
+ * @return The node already in the table, NULL when node was inserted.
+ */
+nw_gtpv2c_hash_node_t* nwGtpv2cHashInsert(
+    nw_gtpv2c_hash_t* thiz, nw_gtpv2c_hash_node_t* node);
+
+/**
+ * @return node, NULL when it was not in the table.
+ */
+nw_gtpv2c_hash_node_t* nwGtpv2cHashRemove(
+    nw_gtpv2c_hash_t* thiz, nw_gtpv2c_hash_node_t* node);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NW_GTPV2C_HASH_H__ */
+
+/*--------------------------------------------------------------------------*
+ *                      E N D     O F    F I L E                            *
+ *--------------------------------------------------------------------------*/
@@ -0,0 +1,83 @@
+/*----------------------------------------------------------------------------*
+ *                                                                            *
+ *                              n w - g t p v 2 c                             *
+ *    G P R S   T u n n e l i n g    P r o t o c o l   v 2 c    S t a c k     *
+ *                                                                            *
+ *                                                                            *
+ * Copyright (c) 2010-2011 Amit Chawre                                        *
+ * All rights reserved.                                                       *
+ *                                                                            *
+ * Redistribution and use in source and binary forms, with or without         *
+ * modification, are permitted provided that the following conditions         *
+ * are met:                                                                   *
+ *                                                                            *
+ * 1. Redistributions of source code must retain the above copyright          *
+ *    notice, this list of conditions and the following disclaimer.           *
+ * 2. Redistributions in binary form must reproduce the above copyright       *
+ *    notice, this list of conditions and the following disclaimer in the     *
+ *    documentation and/or other materials provided with the distribution.    *
+ * 3. The name of the author may not be used to endorse or promote products   *
+ *    derived from this software without specific prior written permission.   *
+ *                                                                            *
+ * THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR       *
+ * IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES  *
+ * OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.    *
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,           *
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT   *
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,  *
+ * DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY      *
+ * THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT        *
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF   *
+ * THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.          *
+ *----------------------------------------------------------------------------*/
+
+#ifndef __NW_GTPV2C_POOL_H__
+#define __NW_GTPV2C_POOL_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @file NwGtpv2cPool.h
+ * @brief Fixed size object pools of a gtpv2c stack.
+ *
+ * Objects are carved out of chunks of objsPerChunk objects and go back to a
+ * free list when released, so that tunnels, transactions, messages and
+ * timers cost no malloc once the stack reached its working set. Chunks are
+ * only freed with the pool.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct nw_gtpv2c_pool_s {
+  size_t objSize;
+  uint32_t objsPerChunk;
+  void* freeList; /**< Linked through the first word of free objects */
+  void* chunks;   /**< Linked through the first word of each chunk    */
+  uint32_t nbChunks;
+} nw_gtpv2c_pool_t;
+
+void nwGtpv2cPoolInit(
+    nw_gtpv2c_pool_t* thiz, size_t objSize, uint32_t objsPerChunk);
+
+void nwGtpv2cPoolFinalize(nw_gtpv2c_pool_t* thiz);
+
+/**
+ * @return A zeroed object the first time it is handed out, afterwards the
+ * object as it was released but for its first word. NULL when out of memory.
+ */
+void* nwGtpv2cPoolAlloc(nw_gtpv2c_pool_t* thiz);
+
+void nwGtpv2cPoolFree(nw_gtpv2c_pool_t* thiz, void* obj);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NW_GTPV2C_POOL_H__ */
+
+/*--------------------------------------------------------------------------*
+ *                      E N D     O F    F I L E                            *
+ *--------------------------------------------------------------------------*/
@@ -46,6 +46,8 @@
 #include "NwGtpv2cIe.h"
 #include "NwGtpv2cMsg.h"
 #include "NwGtpv2cMsgIeParseInfo.h"
+#include "NwGtpv2cHash.h"
+#include "NwGtpv2cPool.h"
 #include "NwGtpv2cTunnel.h"
 
 /**
@@ -86,6 +88,39 @@ extern "C" {
     }                                                                          \
   } while (0)
 
+/*--------------------------------------------------------------------------*
+ * Timeout Info Type Definition
+ *--------------------------------------------------------------------------*/
+
+/**
+ * gtpv2c timeout info
+ */
+
+typedef struct nw_gtpv2c_timeout_info_s {
+  nw_gtpv2c_stack_handle_t hStack;
+  uint64_t expiryTick;
+  uint32_t tmrType;
+  void* timeoutArg;
+  nw_rc_t (*timeoutCallbackFunc)(void*);
+  nw_gtpv2c_timer_handle_t hTimer;
+  LIST_ENTRY(nw_gtpv2c_timeout_info_s)
+  timerWheelEntry; /**< Timer wheel slot or due timers list */
+} nw_gtpv2c_timeout_info_t;
+
+/**
+ * Timer wheel: the stack runs a single ULP timer, every
+ * NW_GTPV2C_TIMER_TICK_MS while stack timers are pending, and keeps its own
+ * timers in NW_GTPV2C_TIMER_WHEEL_SLOTS slots indexed by their expiry tick.
+ * Timers further away than a turn of the wheel stay in their slot for more
+ * turns. Starting and stopping a timer is O(1) whatever the number of
+ * outstanding transactions.
+ */
+
+#define NW_GTPV2C_TIMER_TICK_MS (100)
+#define NW_GTPV2C_TIMER_WHEEL_SLOTS (1024)
+
+LIST_HEAD(nw_gtpv2c_timer_list_s, nw_gtpv2c_timeout_info_s);
+
 /*--------------------------------------------------------------------------*
  *  G T P V 2 C   S T A C K   O B J E C T   T Y P E    D E F I N I T I O N  *
  *--------------------------------------------------------------------------*/
@@ -107,37 +142,23 @@ typedef struct nw_gtpv2c_stack_s {
   uint32_t restartCounter;
 
   nw_gtpv2c_msg_ie_parse_info_t* pGtpv2cMsgIeParseInfo[NW_GTP_MSG_END];
-  struct nw_gtpv2c_timeout_info_s* activeTimerInfo;
-
-  RB_HEAD(NwGtpv2cTunnelMap, nw_gtpv2c_tunnel_s) tunnelMap;
-  RB_HEAD(NwGtpv2cOutstandingTxSeqNumTrxnMap, nw_gtpv2c_trxn_s)
-  outstandingTxSeqNumMap;
-  RB_HEAD(NwGtpv2cOutstandingRxSeqNumTrxnMap, nw_gtpv2c_trxn_s)
-  outstandingRxSeqNumMap;
-  RB_HEAD(NwGtpv2cActiveTimerList, nw_gtpv2c_timeout_info_s) activeTimerList;
-  NwPtrT hTmrMinHeap;
-} nw_gtpv2c_stack_t;
-
-/*--------------------------------------------------------------------------*
- * Timeout Info Type Definition
- *--------------------------------------------------------------------------*/
-
-/**
- * gtpv2c timeout info
- */
 
-typedef struct nw_gtpv2c_timeout_info_s {
-  nw_gtpv2c_stack_handle_t hStack;
-  struct timeval tvTimeout;
-  uint32_t tmrType;
-  void* timeoutArg;
-  nw_rc_t (*timeoutCallbackFunc)(void*);
-  nw_gtpv2c_timer_handle_t hTimer;
-  RB_ENTRY(nw_gtpv2c_timeout_info_s)
-  activeTimerListRbtNode; /**< RB Tree Data Structure Node        */
-  uint32_t timerMinHeapIndex;
-  struct nw_gtpv2c_timeout_info_s* next;
-} nw_gtpv2c_timeout_info_t;
+  nw_gtpv2c_hash_t tunnelMap;
+  nw_gtpv2c_hash_t outstandingTxSeqNumMap;
+  nw_gtpv2c_hash_t outstandingRxSeqNumMap;
+
+  nw_gtpv2c_pool_t tunnelPool;
+  nw_gtpv2c_pool_t trxnPool;
+  nw_gtpv2c_pool_t msgPool;
+  nw_gtpv2c_pool_t timeoutInfoPool;
+
+  struct nw_gtpv2c_timer_list_s timerWheel[NW_GTPV2C_TIMER_WHEEL_SLOTS];
+  struct nw_gtpv2c_timer_list_s dueTimers;
+  uint64_t timerWheelTick; /**< Last tick processed */
+  uint32_t nbTimers;       /**< Timers in the wheel or due */
+  nw_gtpv2c_timeout_info_t tickTimeoutInfo; /**< Arg of the ULP timer */
+  bool tickTimerRunning;
+} nw_gtpv2c_stack_t;
 
 /*---------------------------------------------------------------------------
  * GTPv2c Message Container Definition
@@ -168,7 +189,6 @@ typedef struct nw_gtpv2c_msg_s {
   uint8_t* pIe[NW_GTPV2C_IE_TYPE_MAXIMUM][NW_GTPV2C_IE_INSTANCE_MAXIMUM];
   uint8_t msgBuf[NW_GTPV2C_MAX_MSG_LEN];
   nw_gtpv2c_stack_handle_t hStack;
-  struct nw_gtpv2c_msg_s* next;
 } nw_gtpv2c_msg_t;
 
 /**
@@ -196,11 +216,8 @@ typedef struct nw_gtpv2c_trxn_s {
   nw_gtpv2c_tunnel_handle_t hTunnel; /**< Handle to local tunnel context     */
   nw_gtpv2c_ulp_trxn_handle_t hUlpTrxn; /**< Handle to ULP tunnel context */
   uint8_t trx_flags; /**< Flags in the trx to be signalized back. */
-  RB_ENTRY(nw_gtpv2c_trxn_s)
-  outstandingTxSeqNumMapRbtNode; /**< RB Tree Data Structure Node        */
-  RB_ENTRY(nw_gtpv2c_trxn_s)
-  outstandingRxSeqNumMapRbtNode; /**< RB Tree Data Structure Node        */
-  struct nw_gtpv2c_trxn_s* next;
+  nw_gtpv2c_hash_node_t outstandingTxSeqNumMapNode;
+  nw_gtpv2c_hash_node_t outstandingRxSeqNumMapNode;
 } nw_gtpv2c_trxn_t;
 
 /**
@@ -218,18 +235,41 @@ typedef struct NwGtpv2cPathS {
   RB_ENTRY(NwGtpv2cPathS) pathMapRbtNode;
 } NwGtpv2cPathT;
 
-RB_PROTOTYPE(
-    NwGtpv2cTunnelMap, nw_gtpv2c_tunnel_s, tunnelMapRbtNode,
-    nwGtpv2cCompareTunnel)
-RB_PROTOTYPE(
-    NwGtpv2cOutstandingTxSeqNumTrxnMap, nw_gtpv2c_trxn_s,
-    outstandingTxSeqNumMapRbtNode, nwGtpv2cCompareSeqNum)
-RB_PROTOTYPE(
-    NwGtpv2cOutstandingRxSeqNumTrxnMap, nw_gtpv2c_trxn_s,
-    outstandingRxSeqNumMapRbtNode, nwGtpv2cCompareSeqNum)
-RB_PROTOTYPE(
-    NwGtpv2cActiveTimerList, nw_gtpv2c_timeout_info_s, activeTimerListRbtNode,
-    nwGtpv2cCompareOutstandingTxRexmitTime)
+/**
+ * Tunnels by local TEID and peer address
+ */
+
+nw_gtpv2c_tunnel_t* nwGtpv2cTunnelMapFind(
+    nw_gtpv2c_stack_t* thiz, nw_gtpv2c_tunnel_t* key);
+
+nw_gtpv2c_tunnel_t* nwGtpv2cTunnelMapInsert(
+    nw_gtpv2c_stack_t* thiz, nw_gtpv2c_tunnel_t* pTunnel);
+
+nw_gtpv2c_tunnel_t* nwGtpv2cTunnelMapRemove(
+    nw_gtpv2c_stack_t* thiz, nw_gtpv2c_tunnel_t* pTunnel);
+
+/**
+ * Outstanding requests sent, by sequence number and peer address
+ */
+
+nw_gtpv2c_trxn_t* nwGtpv2cOutstandingTxSeqNumTrxnMapFind(
+    nw_gtpv2c_stack_t* thiz, nw_gtpv2c_trxn_t* key);
+
+nw_gtpv2c_trxn_t* nwGtpv2cOutstandingTxSeqNumTrxnMapInsert(
+    nw_gtpv2c_stack_t* thiz, nw_gtpv2c_trxn_t* pTrxn);
+
+nw_gtpv2c_trxn_t* nwGtpv2cOutstandingTxSeqNumTrxnMapRemove(
+    nw_gtpv2c_stack_t* thiz, nw_gtpv2c_trxn_t* pTrxn);
+
+/**
+ * Outstanding requests received, by sequence number, peer address and port
+ */
+
+nw_gtpv2c_trxn_t* nwGtpv2cOutstandingRxSeqNumTrxnMapInsert(
+    nw_gtpv2c_stack_t* thiz, nw_gtpv2c_trxn_t* pTrxn);
+
+nw_gtpv2c_trxn_t* nwGtpv2cOutstandingRxSeqNumTrxnMapRemove(
+    nw_gtpv2c_stack_t* thiz, nw_gtpv2c_trxn_t* pTrxn);
 
 /**
  * Start Timer with ULP Timer Manager
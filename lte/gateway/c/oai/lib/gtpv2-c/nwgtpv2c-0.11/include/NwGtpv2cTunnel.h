@@ -38,11 +38,11 @@
 #include <stdlib.h>
 #include <string.h>
 
-#include "tree.h"
 #include "NwTypes.h"
 #include "NwUtils.h"
 #include "NwError.h"
 #include "NwGtpv2c.h"
+#include "NwGtpv2cHash.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -58,9 +58,7 @@ typedef struct nw_gtpv2c_tunnel_s {
   } ipAddrRemote;
 
   nw_gtpv2c_ulp_tunnel_handle_t hUlpTunnel;
-  RB_ENTRY(nw_gtpv2c_tunnel_s)
-  tunnelMapRbtNode; /**< RB Tree Data Structure Node        */
-  struct nw_gtpv2c_tunnel_s* next;
+  nw_gtpv2c_hash_node_t tunnelMapNode;
 } nw_gtpv2c_tunnel_t;
 
 nw_gtpv2c_tunnel_t* nwGtpv2cTunnelNew(
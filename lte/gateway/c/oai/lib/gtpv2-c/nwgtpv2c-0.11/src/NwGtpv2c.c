@@ -36,6 +36,7 @@
 #include <string.h>
 #include <inttypes.h>
 #include <stdbool.h>
+#include <time.h>
 
 #include "bstrlib.h"
 
@@ -51,38 +52,6 @@
 #include "gcc_diag.h"
 #include "log.h"
 
-#ifdef _NWGTPV2C_HAVE_TIMERADD
-#define NW_GTPV2C_TIMER_ADD(tvp, uvp, vvp) timeradd((tvp), (uvp), (vvp))
-#define NW_GTPV2C_TIMER_SUB(tvp, uvp, vvp) timersub((tvp), (uvp), (vvp))
-#define NW_GTPV2C_TIMER_CMP_P(a, b, CMP) timercmp(a, b, CMP)
-#else
-
-#define NW_GTPV2C_TIMER_ADD(tvp, uvp, vvp)                                     \
-  do {                                                                         \
-    (vvp)->tv_sec  = (tvp)->tv_sec + (uvp)->tv_sec;                            \
-    (vvp)->tv_usec = (tvp)->tv_usec + (uvp)->tv_usec;                          \
-    if ((vvp)->tv_usec >= 1000000) {                                           \
-      (vvp)->tv_sec++;                                                         \
-      (vvp)->tv_usec -= 1000000;                                               \
-    }                                                                          \
-  } while (0)
-
-#define NW_GTPV2C_TIMER_SUB(tvp, uvp, vvp)                                     \
-  do {                                                                         \
-    (vvp)->tv_sec  = (tvp)->tv_sec - (uvp)->tv_sec;                            \
-    (vvp)->tv_usec = (tvp)->tv_usec - (uvp)->tv_usec;                          \
-    if ((vvp)->tv_usec < 0) {                                                  \
-      (vvp)->tv_sec--;                                                         \
-      (vvp)->tv_usec += 1000000;                                               \
-    }                                                                          \
-  } while (0)
-
-#define NW_GTPV2C_TIMER_CMP_P(a, b, CMP)                                       \
-  (((a)->tv_sec == (b)->tv_sec) ? ((a)->tv_usec CMP(b)->tv_usec) :             \
-                                  ((a)->tv_sec CMP(b)->tv_sec))
-
-#endif
-
 #define NW_GTPV2C_INIT_MSG_IE_PARSE_INFO(__thiz, __msgType)                    \
   do {                                                                         \
     __thiz->pGtpv2cMsgIeParseInfo[__msgType] = nwGtpv2cMsgIeParseInfoNew(      \
@@ -95,120 +64,11 @@
 extern "C" {
 #endif
 
-static nw_gtpv2c_timeout_info_t* gpGtpv2cTimeoutInfoPool = NULL;
-
-typedef struct {
-  int currSize;
-  int maxSize;
-  nw_gtpv2c_timeout_info_t** pHeap;
-} NwGtpv2cTmrMinHeapT;
-
-#define NW_HEAP_PARENT_INDEX(__child) (((__child) -1) / 2)
-
-NwGtpv2cTmrMinHeapT* nwGtpv2cTmrMinHeapNew(int maxSize) {
-  NwGtpv2cTmrMinHeapT* thiz =
-      (NwGtpv2cTmrMinHeapT*) malloc(sizeof(NwGtpv2cTmrMinHeapT));
-
-  if (thiz) {
-    thiz->currSize = 0;
-    thiz->maxSize  = maxSize;
-    thiz->pHeap    = (nw_gtpv2c_timeout_info_t**) malloc(
-        maxSize * sizeof(nw_gtpv2c_timeout_info_t*));
-  }
-
-  return thiz;
-}
-
-void nwGtpv2cTmrMinHeapDelete(NwGtpv2cTmrMinHeapT* thiz) {
-  free_wrapper((void**) &thiz->pHeap);
-  free_wrapper((void**) &thiz);
-}
-
-static nw_rc_t nwGtpv2cTmrMinHeapInsert(
-    NwGtpv2cTmrMinHeapT* thiz, nw_gtpv2c_timeout_info_t* pTimerEvent) {
-  int holeIndex = thiz->currSize++;
-
-  NW_ASSERT(thiz->currSize < thiz->maxSize);
-
-  while ((holeIndex > 0) &&
-         NW_GTPV2C_TIMER_CMP_P(
-             &(thiz->pHeap[NW_HEAP_PARENT_INDEX(holeIndex)])->tvTimeout,
-             &(pTimerEvent->tvTimeout), >)) {
-    thiz->pHeap[holeIndex] = thiz->pHeap[NW_HEAP_PARENT_INDEX(holeIndex)];
-    thiz->pHeap[holeIndex]->timerMinHeapIndex = holeIndex;
-    holeIndex                                 = NW_HEAP_PARENT_INDEX(holeIndex);
-  }
-
-  thiz->pHeap[holeIndex]         = pTimerEvent;
-  pTimerEvent->timerMinHeapIndex = holeIndex;
-  return holeIndex;
-}
-
-#define NW_MIN_HEAP_INDEX_INVALID (0xFFFFFFFF)
-static nw_rc_t nwGtpv2cTmrMinHeapRemove(
-    NwGtpv2cTmrMinHeapT* thiz, int minHeapIndex) {
-  nw_gtpv2c_timeout_info_t* pTimerEvent = NULL;
-  int holeIndex                         = minHeapIndex;
-  int minChild = 0, maxChild = 0;
-
-  if (minHeapIndex == NW_MIN_HEAP_INDEX_INVALID) return NW_FAILURE;
-
-  if (minHeapIndex < thiz->currSize) {
-    thiz->pHeap[minHeapIndex]->timerMinHeapIndex = NW_MIN_HEAP_INDEX_INVALID;
-    thiz->currSize--;
-    pTimerEvent = thiz->pHeap[thiz->currSize];
-    holeIndex   = minHeapIndex;
-    minChild    = (2 * holeIndex) + 1;
-    maxChild    = minChild + 1;
-
-    while ((maxChild) <= thiz->currSize) {
-      if (NW_GTPV2C_TIMER_CMP_P(
-              &(thiz->pHeap[minChild]->tvTimeout),
-              &(thiz->pHeap[maxChild]->tvTimeout), >))
-        minChild = maxChild;
-
-      if (NW_GTPV2C_TIMER_CMP_P(
-              &(pTimerEvent->tvTimeout), &(thiz->pHeap[minChild]->tvTimeout),
-              <)) {
-        break;
-      }
-
-      thiz->pHeap[holeIndex]                    = thiz->pHeap[minChild];
-      thiz->pHeap[holeIndex]->timerMinHeapIndex = holeIndex;
-      holeIndex                                 = minChild;
-      minChild                                  = (2 * holeIndex) + 1;
-      maxChild                                  = minChild + 1;
-    }
-
-    while ((holeIndex > 0) &&
-           NW_GTPV2C_TIMER_CMP_P(
-               &((thiz->pHeap[NW_HEAP_PARENT_INDEX(holeIndex)])->tvTimeout),
-               &(pTimerEvent->tvTimeout), >)) {
-      thiz->pHeap[holeIndex] = thiz->pHeap[NW_HEAP_PARENT_INDEX(holeIndex)];
-      thiz->pHeap[holeIndex]->timerMinHeapIndex = holeIndex;
-      holeIndex = NW_HEAP_PARENT_INDEX(holeIndex);
-    }
-
-    if (holeIndex < thiz->currSize) {
-      thiz->pHeap[holeIndex]         = pTimerEvent;
-      pTimerEvent->timerMinHeapIndex = holeIndex;
-    }
-
-    thiz->pHeap[thiz->currSize] = NULL;
-    return NW_OK;
-  }
-
-  return NW_FAILURE;
-}
+/* Objects carved per chunk by the stack pools */
+#define NW_GTPV2C_POOL_CHUNK_OBJS (256)
+#define NW_GTPV2C_MSG_POOL_CHUNK_OBJS (16)
+#define NW_GTPV2C_MAP_INITIAL_BUCKETS (1024)
 
-static nw_gtpv2c_timeout_info_t* nwGtpv2cTmrMinHeapPeek(
-    NwGtpv2cTmrMinHeapT* thiz) {
-  if (thiz->currSize) {
-    return thiz->pHeap[0];
-  }
-
-  return NULL;
-}
 /*--------------------------------------------------------------------------*
                       P R I V A T E    F U N C T I O N S
   --------------------------------------------------------------------------*/
@@ -347,184 +207,159 @@ static void nwGtpv2cDisplayBanner(nw_gtpv2c_stack_t* thiz) {
 }
 
 /*---------------------------------------------------------------------------
-   Tunnel RBTree Search Data Structure
+   Tunnel and Transaction Hash Tables
   --------------------------------------------------------------------------*/
 
 /**
-  Comparator funtion for comparing two sequence number transactions.
-
-  @param[in] a: Pointer to session a.
-  @param[in] b: Pointer to session b.
-  @return  An integer greater than, equal to or less than zero according to
-  whether the object pointed to by a is greater than, equal to or less than the
-  object pointed to by b.
+  Hash of a key and of the peer address, the port is not part of it.
 */
+static inline uint32_t nwGtpv2cHashPeer(
+    uint32_t key, const struct sockaddr* peer) {
+  if (peer->sa_family == AF_INET) {
+    return nwGtpv2cHashKey(
+        key, &((const struct sockaddr_in*) peer)->sin_addr,
+        sizeof(struct in_addr));
+  }
+  DevAssert(peer->sa_family == AF_INET6);
+  return nwGtpv2cHashKey(
+      key, &((const struct sockaddr_in6*) peer)->sin6_addr,
+      sizeof(struct in6_addr));
+}
 
-static inline int32_t nwGtpv2cCompareTunnel(
-    struct nw_gtpv2c_tunnel_s* a, struct nw_gtpv2c_tunnel_s* b) {
-  if (a->teid > b->teid) return 1;
-
-  if (a->teid < b->teid) return -1;
-
-  /** Compare the sa_family. */
-  if (((struct sockaddr*) &a->ipAddrRemote)->sa_family >
-      ((struct sockaddr*) &b->ipAddrRemote)->sa_family)
-    return 1;
-
-  if (((struct sockaddr*) &a->ipAddrRemote)->sa_family <
-      ((struct sockaddr*) &b->ipAddrRemote)->sa_family)
-    return -1;
-
-  /** compare the address. */
-  if (((struct sockaddr*) &a->ipAddrRemote)->sa_family == AF_INET) {
-    if (((struct sockaddr_in*) &a->ipAddrRemote)->sin_addr.s_addr >
-        ((struct sockaddr_in*) &b->ipAddrRemote)->sin_addr.s_addr)
-      return 1;
+static inline int nwGtpv2cIsSamePeer(
+    const struct sockaddr* a, const struct sockaddr* b) {
+  if (a->sa_family != b->sa_family) return 0;
 
-    if (((struct sockaddr_in*) &a->ipAddrRemote)->sin_addr.s_addr <
-        ((struct sockaddr_in*) &b->ipAddrRemote)->sin_addr.s_addr)
-      return -1;
-  } else {
-    DevAssert(((struct sockaddr*) &a->ipAddrRemote)->sa_family == AF_INET6);
-    /** Should return 1 if a is bigger. */
-    return memcmp(
-        ((struct sockaddr_in6*) &a->ipAddrRemote)->sin6_addr.s6_addr,
-        ((struct sockaddr_in6*) &b->ipAddrRemote)->sin6_addr.s6_addr, 16);
+  if (a->sa_family == AF_INET) {
+    return ((const struct sockaddr_in*) a)->sin_addr.s_addr ==
+           ((const struct sockaddr_in*) b)->sin_addr.s_addr;
   }
+  return memcmp(
+             ((const struct sockaddr_in6*) a)->sin6_addr.s6_addr,
+             ((const struct sockaddr_in6*) b)->sin6_addr.s6_addr, 16) == 0;
+}
 
-  return 0;
+static int nwGtpv2cIsSameTunnel(
+    const nw_gtpv2c_hash_node_t* a, const nw_gtpv2c_hash_node_t* b) {
+  const nw_gtpv2c_tunnel_t* ta =
+      NW_GTPV2C_HASH_ENTRY(a, nw_gtpv2c_tunnel_t, tunnelMapNode);
+  const nw_gtpv2c_tunnel_t* tb =
+      NW_GTPV2C_HASH_ENTRY(b, nw_gtpv2c_tunnel_t, tunnelMapNode);
+
+  return ta->teid == tb->teid &&
+         nwGtpv2cIsSamePeer(
+             (const struct sockaddr*) &ta->ipAddrRemote,
+             (const struct sockaddr*) &tb->ipAddrRemote);
 }
 
-RB_GENERATE(
-    NwGtpv2cTunnelMap, nw_gtpv2c_tunnel_s, tunnelMapRbtNode,
-    nwGtpv2cCompareTunnel)
+static int nwGtpv2cIsSameOutstandingTxSeqNumTrxn(
+    const nw_gtpv2c_hash_node_t* a, const nw_gtpv2c_hash_node_t* b) {
+  const nw_gtpv2c_trxn_t* ta =
+      NW_GTPV2C_HASH_ENTRY(a, nw_gtpv2c_trxn_t, outstandingTxSeqNumMapNode);
+  const nw_gtpv2c_trxn_t* tb =
+      NW_GTPV2C_HASH_ENTRY(b, nw_gtpv2c_trxn_t, outstandingTxSeqNumMapNode);
+
+  return ta->seqNum == tb->seqNum &&
+         nwGtpv2cIsSamePeer(
+             (const struct sockaddr*) &ta->peer_ip,
+             (const struct sockaddr*) &tb->peer_ip);
+}
 
-/*---------------------------------------------------------------------------
-   Transaction RBTree Search Data Structure
-  --------------------------------------------------------------------------*/
-/**
-  Comparator funtion for comparing two outstancing TX transactions.
+static int nwGtpv2cIsSameOutstandingRxSeqNumTrxn(
+    const nw_gtpv2c_hash_node_t* a, const nw_gtpv2c_hash_node_t* b) {
+  const nw_gtpv2c_trxn_t* ta =
+      NW_GTPV2C_HASH_ENTRY(a, nw_gtpv2c_trxn_t, outstandingRxSeqNumMapNode);
+  const nw_gtpv2c_trxn_t* tb =
+      NW_GTPV2C_HASH_ENTRY(b, nw_gtpv2c_trxn_t, outstandingRxSeqNumMapNode);
+
+  return ta->seqNum == tb->seqNum && ta->peerPort == tb->peerPort &&
+         nwGtpv2cIsSamePeer(
+             (const struct sockaddr*) &ta->peer_ip,
+             (const struct sockaddr*) &tb->peer_ip);
+}
 
-  @param[in] a: Pointer to session a.
-  @param[in] b: Pointer to session b.
-  @return  An integer greater than, equal to or less than zero according to
-  whether the object pointed to by a is greater than, equal to or less than the
-  object pointed to by b.
-*/
-static inline int32_t nwGtpv2cCompareOutstandingTxSeqNumTrxn(
-    struct nw_gtpv2c_trxn_s* a, struct nw_gtpv2c_trxn_s* b) {
-  if (a->seqNum > b->seqNum) return 1;
-
-  if (a->seqNum < b->seqNum) return -1;
-
-  /** Compare the sa_family. */
-  if (((struct sockaddr*) &a->peer_ip)->sa_family >
-      ((struct sockaddr*) &b->peer_ip)->sa_family)
-    return 1;
-
-  if (((struct sockaddr*) &a->peer_ip)->sa_family <
-      ((struct sockaddr*) &b->peer_ip)->sa_family)
-    return -1;
-
-  /** compare the address. */
-  if (((struct sockaddr*) &a->peer_ip)->sa_family == AF_INET) {
-    if (((struct sockaddr_in*) &a->peer_ip)->sin_addr.s_addr >
-        ((struct sockaddr_in*) &b->peer_ip)->sin_addr.s_addr)
-      return 1;
-
-    if (((struct sockaddr_in*) &a->peer_ip)->sin_addr.s_addr <
-        ((struct sockaddr_in*) &b->peer_ip)->sin_addr.s_addr)
-      return -1;
-  } else {
-    DevAssert(((struct sockaddr*) &a->peer_ip)->sa_family == AF_INET6);
-    /** Should return 1 if a is bigger. */
-    return memcmp(
-        ((struct sockaddr_in6*) &a->peer_ip)->sin6_addr.s6_addr,
-        ((struct sockaddr_in6*) &b->peer_ip)->sin6_addr.s6_addr, 16);
-  }
+nw_gtpv2c_tunnel_t* nwGtpv2cTunnelMapFind(
+    nw_gtpv2c_stack_t* thiz, nw_gtpv2c_tunnel_t* key) {
+  nw_gtpv2c_hash_node_t* node = NULL;
 
-  return 0;
+  key->tunnelMapNode.hash =
+      nwGtpv2cHashPeer(key->teid, (struct sockaddr*) &key->ipAddrRemote);
+  node = nwGtpv2cHashFind(&thiz->tunnelMap, &key->tunnelMapNode);
+  return NW_GTPV2C_HASH_ENTRY(node, nw_gtpv2c_tunnel_t, tunnelMapNode);
 }
 
-RB_GENERATE(
-    NwGtpv2cOutstandingTxSeqNumTrxnMap, nw_gtpv2c_trxn_s,
-    outstandingTxSeqNumMapRbtNode, nwGtpv2cCompareOutstandingTxSeqNumTrxn)
+nw_gtpv2c_tunnel_t* nwGtpv2cTunnelMapInsert(
+    nw_gtpv2c_stack_t* thiz, nw_gtpv2c_tunnel_t* pTunnel) {
+  nw_gtpv2c_hash_node_t* node = NULL;
 
-/**
-  Comparator funtion for comparing outstanding RX transactions.
+  pTunnel->tunnelMapNode.hash = nwGtpv2cHashPeer(
+      pTunnel->teid, (struct sockaddr*) &pTunnel->ipAddrRemote);
+  node = nwGtpv2cHashInsert(&thiz->tunnelMap, &pTunnel->tunnelMapNode);
+  return NW_GTPV2C_HASH_ENTRY(node, nw_gtpv2c_tunnel_t, tunnelMapNode);
+}
 
-  @param[in] a: Pointer to session a.
-  @param[in] b: Pointer to session b.
-  @return  An integer greater than, equal to or less than zero according to
-  whether the object pointed to by a is greater than, equal to or less than the
-  object pointed to by b.
-*/
-static inline int32_t nwGtpv2cCompareOutstandingRxSeqNumTrxn(
-    struct nw_gtpv2c_trxn_s* a, struct nw_gtpv2c_trxn_s* b) {
-  if (a->seqNum > b->seqNum) return 1;
-
-  if (a->seqNum < b->seqNum) return -1;
-  /** Compare the sa_family. */
-  if (((struct sockaddr*) &a->peer_ip)->sa_family >
-      ((struct sockaddr*) &b->peer_ip)->sa_family)
-    return 1;
-
-  if (((struct sockaddr*) &a->peer_ip)->sa_family <
-      ((struct sockaddr*) &b->peer_ip)->sa_family)
-    return -1;
-
-  /** compare the address. */
-  if (((struct sockaddr*) &a->peer_ip)->sa_family == AF_INET) {
-    if (((struct sockaddr_in*) &a->peer_ip)->sin_addr.s_addr >
-        ((struct sockaddr_in*) &b->peer_ip)->sin_addr.s_addr)
-      return 1;
-
-    if (((struct sockaddr_in*) &a->peer_ip)->sin_addr.s_addr <
-        ((struct sockaddr_in*) &b->peer_ip)->sin_addr.s_addr)
-      return -1;
-  } else {
-    DevAssert(((struct sockaddr*) &a->peer_ip)->sa_family == AF_INET6);
-    /** Should return 1 if a is bigger. */
-    return memcmp(
-        ((struct sockaddr_in6*) &a->peer_ip)->sin6_addr.s6_addr,
-        ((struct sockaddr_in6*) &b->peer_ip)->sin6_addr.s6_addr, 16);
-  }
+nw_gtpv2c_tunnel_t* nwGtpv2cTunnelMapRemove(
+    nw_gtpv2c_stack_t* thiz, nw_gtpv2c_tunnel_t* pTunnel) {
+  nw_gtpv2c_hash_node_t* node =
+      nwGtpv2cHashRemove(&thiz->tunnelMap, &pTunnel->tunnelMapNode);
 
-  if (a->peerPort > b->peerPort) return 1;
+  return NW_GTPV2C_HASH_ENTRY(node, nw_gtpv2c_tunnel_t, tunnelMapNode);
+}
 
-  if (a->peerPort < b->peerPort) return -1;
+nw_gtpv2c_trxn_t* nwGtpv2cOutstandingTxSeqNumTrxnMapFind(
+    nw_gtpv2c_stack_t* thiz, nw_gtpv2c_trxn_t* key) {
+  nw_gtpv2c_hash_node_t* node = NULL;
 
-  return 0;
+  key->outstandingTxSeqNumMapNode.hash =
+      nwGtpv2cHashPeer(key->seqNum, (struct sockaddr*) &key->peer_ip);
+  node = nwGtpv2cHashFind(
+      &thiz->outstandingTxSeqNumMap, &key->outstandingTxSeqNumMapNode);
+  return NW_GTPV2C_HASH_ENTRY(
+      node, nw_gtpv2c_trxn_t, outstandingTxSeqNumMapNode);
 }
 
-RB_GENERATE(
-    NwGtpv2cOutstandingRxSeqNumTrxnMap, nw_gtpv2c_trxn_s,
-    outstandingRxSeqNumMapRbtNode, nwGtpv2cCompareOutstandingRxSeqNumTrxn)
+nw_gtpv2c_trxn_t* nwGtpv2cOutstandingTxSeqNumTrxnMapInsert(
+    nw_gtpv2c_stack_t* thiz, nw_gtpv2c_trxn_t* pTrxn) {
+  nw_gtpv2c_hash_node_t* node = NULL;
 
-/*---------------------------------------------------------------------------
-   Timer RB-tree data structure.
-  --------------------------------------------------------------------------*/
-/**
-  Comparator funtion for comparing two outstancing TX transactions.
+  pTrxn->outstandingTxSeqNumMapNode.hash =
+      nwGtpv2cHashPeer(pTrxn->seqNum, (struct sockaddr*) &pTrxn->peer_ip);
+  node = nwGtpv2cHashInsert(
+      &thiz->outstandingTxSeqNumMap, &pTrxn->outstandingTxSeqNumMapNode);
+  return NW_GTPV2C_HASH_ENTRY(
+      node, nw_gtpv2c_trxn_t, outstandingTxSeqNumMapNode);
+}
 
-  @param[in] a: Pointer to session a.
-  @param[in] b: Pointer to session b.
-  @return  An integer greater than, equal to or less than zero according to
-  whether the object pointed to by a is greater than, equal to or less than the
-  object pointed to by b.
-*/
-static inline int32_t nwGtpv2cCompareOutstandingTxRexmitTime(
-    struct nw_gtpv2c_timeout_info_s* a, struct nw_gtpv2c_timeout_info_s* b) {
-  if (NW_GTPV2C_TIMER_CMP_P(&a->tvTimeout, &b->tvTimeout, >)) return 1;
+nw_gtpv2c_trxn_t* nwGtpv2cOutstandingTxSeqNumTrxnMapRemove(
+    nw_gtpv2c_stack_t* thiz, nw_gtpv2c_trxn_t* pTrxn) {
+  nw_gtpv2c_hash_node_t* node = nwGtpv2cHashRemove(
+      &thiz->outstandingTxSeqNumMap, &pTrxn->outstandingTxSeqNumMapNode);
 
-  if (NW_GTPV2C_TIMER_CMP_P(&a->tvTimeout, &b->tvTimeout, <)) return -1;
+  return NW_GTPV2C_HASH_ENTRY(
+      node, nw_gtpv2c_trxn_t, outstandingTxSeqNumMapNode);
+}
 
-  return 0;
+nw_gtpv2c_trxn_t* nwGtpv2cOutstandingRxSeqNumTrxnMapInsert(
+    nw_gtpv2c_stack_t* thiz, nw_gtpv2c_trxn_t* pTrxn) {
+  nw_gtpv2c_hash_node_t* node = NULL;
+
+  pTrxn->outstandingRxSeqNumMapNode.hash = nwGtpv2cHashPeer(
+      pTrxn->seqNum ^ (pTrxn->peerPort << 16),
+      (struct sockaddr*) &pTrxn->peer_ip);
+  node = nwGtpv2cHashInsert(
+      &thiz->outstandingRxSeqNumMap, &pTrxn->outstandingRxSeqNumMapNode);
+  return NW_GTPV2C_HASH_ENTRY(
+      node, nw_gtpv2c_trxn_t, outstandingRxSeqNumMapNode);
 }
 
-RB_GENERATE(
-    NwGtpv2cActiveTimerList, nw_gtpv2c_timeout_info_s, activeTimerListRbtNode,
-    nwGtpv2cCompareOutstandingTxRexmitTime)
+nw_gtpv2c_trxn_t* nwGtpv2cOutstandingRxSeqNumTrxnMapRemove(
+    nw_gtpv2c_stack_t* thiz, nw_gtpv2c_trxn_t* pTrxn) {
+  nw_gtpv2c_hash_node_t* node = nwGtpv2cHashRemove(
+      &thiz->outstandingRxSeqNumMap, &pTrxn->outstandingRxSeqNumMapNode);
+
+  return NW_GTPV2C_HASH_ENTRY(
+      node, nw_gtpv2c_trxn_t, outstandingRxSeqNumMapNode);
+}
 
 /**
    Send msg to peer via data request to UDP Entity
@@ -631,7 +466,7 @@ static nw_rc_t nwGtpv2cCreateLocalTunnel(
   pTunnel = nwGtpv2cTunnelNew(thiz, teid, fa, hUlpTunnel);
 
   if (pTunnel) {
-    pCollision = RB_INSERT(NwGtpv2cTunnelMap, &(thiz->tunnelMap), pTunnel);
+    pCollision = nwGtpv2cTunnelMapInsert(thiz, pTunnel);
 
     if (pCollision) {
       rc = nwGtpv2cTunnelDelete(thiz, pTunnel);
@@ -667,8 +502,7 @@ static nw_rc_t nwGtpv2cDeleteLocalTunnel(
 
   OAILOG_FUNC_IN(LOG_GTPV2C);
 
-  pTunnel = RB_REMOVE(
-      NwGtpv2cTunnelMap, &(thiz->tunnelMap), (nw_gtpv2c_tunnel_t*) hTunnel);
+  pTunnel = nwGtpv2cTunnelMapRemove(thiz, (nw_gtpv2c_tunnel_t*) hTunnel);
   NW_ASSERT(pTunnel == (nw_gtpv2c_tunnel_t*) hTunnel);
 
   inet_ntop(
@@ -723,9 +557,8 @@ static nw_rc_t nwGtpv2cHandleUlpInitialReq(
               sizeof(struct sockaddr_in) :
               sizeof(struct sockaddr_in6));
 
-      pLocalTunnel = RB_FIND(NwGtpv2cTunnelMap, &(thiz->tunnelMap), &keyTunnel);
+      pLocalTunnel = nwGtpv2cTunnelMapFind(thiz, &keyTunnel);
       if (!pLocalTunnel) {
-        pLocalTunnel = RB_MIN(NwGtpv2cTunnelMap, &(thiz->tunnelMap));
         OAILOG_WARNING(
             LOG_GTPV2C,
             "Request message received on non-existent teid 0x%x received! "
@@ -783,9 +616,7 @@ static nw_rc_t nwGtpv2cHandleUlpInitialReq(
 
       // Insert into search tree
 
-      pTrxn = RB_INSERT(
-          NwGtpv2cOutstandingTxSeqNumTrxnMap, &(thiz->outstandingTxSeqNumMap),
-          pTrxn);
+      pTrxn = nwGtpv2cOutstandingTxSeqNumTrxnMapInsert(thiz, pTrxn);
       NW_ASSERT(pTrxn == NULL);
     } else {
       rc = nwGtpv2cTrxnDelete(&pTrxn);
@@ -841,9 +672,7 @@ static nw_rc_t nwGtpv2cHandleUlpTriggeredReq(
 
       // Insert into search tree
 
-      RB_INSERT(
-          NwGtpv2cOutstandingTxSeqNumTrxnMap, &(thiz->outstandingTxSeqNumMap),
-          pTrxn);
+      nwGtpv2cOutstandingTxSeqNumTrxnMapInsert(thiz, pTrxn);
 
       if (!pUlpReq->u_api_info.triggeredReqInfo.hTunnel) {
         rc = nwGtpv2cCreateLocalTunnel(
@@ -949,7 +778,7 @@ static nw_rc_t nwGtpv2cHandleUlpTriggeredRsp(
             sizeof(struct sockaddr_in) :
             sizeof(struct sockaddr_in6));
 
-    pLocalTunnel = RB_FIND(NwGtpv2cTunnelMap, &(thiz->tunnelMap), &keyTunnel);
+    pLocalTunnel = nwGtpv2cTunnelMapFind(thiz, &keyTunnel);
     char ip[INET6_ADDRSTRLEN];
     inet_ntop(
         AF_INET, (void*) &pReqTrxn->peer_ip, ip,
@@ -1008,9 +837,7 @@ static nw_rc_t nwGtpv2cHandleUlpTriggeredAck(
 
   /** A transaction of the initial request (cmd) for the triggered request
    * should exist. */
-  pAckTrxn = RB_FIND(
-      NwGtpv2cOutstandingTxSeqNumTrxnMap, &(thiz->outstandingTxSeqNumMap),
-      &keyTrxn);
+  pAckTrxn = nwGtpv2cOutstandingTxSeqNumTrxnMapFind(thiz, &keyTrxn);
 
   if (pAckTrxn) {
     OAILOG_INFO(
@@ -1078,7 +905,7 @@ static nw_rc_t nwGtpv2cHandleUlpCreateLocalTunnel(
       pUlpReq->u_api_info.createLocalTunnelInfo.peerIp,
       pUlpReq->u_api_info.triggeredRspInfo.hUlpTunnel);
   NW_ASSERT(pTunnel);
-  pCollision = RB_INSERT(NwGtpv2cTunnelMap, &(thiz->tunnelMap), pTunnel);
+  pCollision = nwGtpv2cTunnelMapInsert(thiz, pTunnel);
 
   if (pCollision) {
     rc = nwGtpv2cTunnelDelete(thiz, pTunnel);
@@ -1222,7 +1049,7 @@ static nw_rc_t nwGtpv2cHandleUlpFindLocalTunnel(
       (((struct sockaddr*) &keyTunnel.ipAddrRemote)->sa_family == AF_INET) ?
           sizeof(struct sockaddr_in) :
           sizeof(struct sockaddr_in6));
-  pLocalTunnel = RB_FIND(NwGtpv2cTunnelMap, &(thiz->tunnelMap), &keyTunnel);
+  pLocalTunnel = nwGtpv2cTunnelMapFind(thiz, &keyTunnel);
   pUlpReq->u_api_info.findLocalTunnelInfo.hTunnel =
       (nw_gtpv2c_tunnel_handle_t) pLocalTunnel;
 
@@ -1309,7 +1136,7 @@ static nw_rc_t nwGtpv2cHandleInitialReq(
         (void*) &keyTunnel.ipAddrRemote, peerIp,
         (peerIp->sa_family == AF_INET) ? sizeof(struct sockaddr_in) :
                                          sizeof(struct sockaddr_in6));
-    pLocalTunnel = RB_FIND(NwGtpv2cTunnelMap, &(thiz->tunnelMap), &keyTunnel);
+    pLocalTunnel = nwGtpv2cTunnelMapFind(thiz, &keyTunnel);
 
     if (!pLocalTunnel) {
       OAILOG_WARNING(
@@ -1393,18 +1220,14 @@ static nw_rc_t nwGtpv2cHandleTriggeredReq(
 
   /** A transaction of the initial request (cmd) for the triggered request
    * should exist. */
-  pTrxn = RB_FIND(
-      NwGtpv2cOutstandingTxSeqNumTrxnMap, &(thiz->outstandingTxSeqNumMap),
-      &keyTrxn);
+  pTrxn = nwGtpv2cOutstandingTxSeqNumTrxnMapFind(thiz, &keyTrxn);
 
   if (pTrxn) {
     /**
      * We remove the transaction of the initial request and create a new
      * transaction the the received triggered request.
      */
-    RB_REMOVE(
-        NwGtpv2cOutstandingTxSeqNumTrxnMap, &(thiz->outstandingTxSeqNumMap),
-        pTrxn);
+    nwGtpv2cOutstandingTxSeqNumTrxnMapRemove(thiz, pTrxn);
     rc = nwGtpv2cTrxnDelete(&pTrxn);
     NW_ASSERT(NW_OK == rc);
   } else {
@@ -1423,7 +1246,7 @@ static nw_rc_t nwGtpv2cHandleTriggeredReq(
         (void*) &keyTunnel.ipAddrRemote, peerIp,
         (peerIp->sa_family == AF_INET) ? sizeof(struct sockaddr_in) :
                                          sizeof(struct sockaddr_in6));
-    pLocalTunnel = RB_FIND(NwGtpv2cTunnelMap, &(thiz->tunnelMap), &keyTunnel);
+    pLocalTunnel = nwGtpv2cTunnelMapFind(thiz, &keyTunnel);
 
     if (!pLocalTunnel) {
       OAILOG_WARNING(
@@ -1496,9 +1319,7 @@ static nw_rc_t nwGtpv2cHandleTriggeredRsp(
       "%x.\n",
       msgType, msgBufLen, keyTrxn.seqNum);
 
-  pTrxn = RB_FIND(
-      NwGtpv2cOutstandingTxSeqNumTrxnMap, &(thiz->outstandingTxSeqNumMap),
-      &keyTrxn);
+  pTrxn = nwGtpv2cOutstandingTxSeqNumTrxnMapFind(thiz, &keyTrxn);
   uint8_t trx_flags = 0;
   if (pTrxn) {
     uint32_t hUlpTunnel;
@@ -1567,9 +1388,7 @@ static nw_rc_t nwGtpv2cHandleTriggeredRsp(
           "%x in conclusion (not late response). \n",
           msgType, keyTrxn.seqNum);
       /** Remove the transaction. */
-      RB_REMOVE(
-          NwGtpv2cOutstandingTxSeqNumTrxnMap, &(thiz->outstandingTxSeqNumMap),
-          pTrxn);
+      nwGtpv2cOutstandingTxSeqNumTrxnMapRemove(thiz, pTrxn);
       rc = nwGtpv2cTrxnDelete(&pTrxn);
       NW_ASSERT(NW_OK == rc);
       remove = false;
@@ -1614,13 +1433,33 @@ nw_rc_t nwGtpv2cInitialize(
     thiz->id     = (uint32_t) thiz;
     thiz->seqNum = ((uint32_t) thiz) & 0x0000FFFF;
     OAI_GCC_DIAG_ON("-Wpointer-to-int-cast");
-    RB_INIT(&(thiz->tunnelMap));
-    RB_INIT(&(thiz->outstandingTxSeqNumMap));
-    RB_INIT(&(thiz->outstandingRxSeqNumMap));
-    RB_INIT(&(thiz->activeTimerList));
-    OAI_GCC_DIAG_OFF("-Wpointer-to-int-cast");
-    thiz->hTmrMinHeap = (NwPtrT) nwGtpv2cTmrMinHeapNew(10000);
-    OAI_GCC_DIAG_ON("-Wpointer-to-int-cast");
+    rc = nwGtpv2cHashInit(
+        &thiz->tunnelMap, NW_GTPV2C_MAP_INITIAL_BUCKETS, nwGtpv2cIsSameTunnel);
+    NW_ASSERT(NW_OK == rc);
+    rc = nwGtpv2cHashInit(
+        &thiz->outstandingTxSeqNumMap, NW_GTPV2C_MAP_INITIAL_BUCKETS,
+        nwGtpv2cIsSameOutstandingTxSeqNumTrxn);
+    NW_ASSERT(NW_OK == rc);
+    rc = nwGtpv2cHashInit(
+        &thiz->outstandingRxSeqNumMap, NW_GTPV2C_MAP_INITIAL_BUCKETS,
+        nwGtpv2cIsSameOutstandingRxSeqNumTrxn);
+    NW_ASSERT(NW_OK == rc);
+    nwGtpv2cPoolInit(
+        &thiz->tunnelPool, sizeof(nw_gtpv2c_tunnel_t),
+        NW_GTPV2C_POOL_CHUNK_OBJS);
+    nwGtpv2cPoolInit(
+        &thiz->trxnPool, sizeof(nw_gtpv2c_trxn_t), NW_GTPV2C_POOL_CHUNK_OBJS);
+    nwGtpv2cPoolInit(
+        &thiz->msgPool, sizeof(nw_gtpv2c_msg_t),
+        NW_GTPV2C_MSG_POOL_CHUNK_OBJS);
+    nwGtpv2cPoolInit(
+        &thiz->timeoutInfoPool, sizeof(nw_gtpv2c_timeout_info_t),
+        NW_GTPV2C_POOL_CHUNK_OBJS);
+    for (int slot = 0; slot < NW_GTPV2C_TIMER_WHEEL_SLOTS; slot++) {
+      LIST_INIT(&thiz->timerWheel[slot]);
+    }
+    LIST_INIT(&thiz->dueTimers);
+    thiz->tickTimeoutInfo.hStack = (nw_gtpv2c_stack_handle_t) thiz;
     NW_GTPV2C_INIT_MSG_IE_PARSE_INFO(thiz, NW_GTP_ECHO_RSP);
 
     // For S11 interface
@@ -1676,6 +1515,8 @@ nw_rc_t nwGtpv2cInitialize(
 */
 
 nw_rc_t nwGtpv2cFinalize(NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle) {
+  nw_gtpv2c_stack_t* thiz = NULL;
+
   if (!hGtpcStackHandle) return NW_FAILURE;
 
   nwGtpv2cMsgIeParseInfoDelete(((nw_gtpv2c_stack_t*) hGtpcStackHandle)
@@ -1792,11 +1633,18 @@ nw_rc_t nwGtpv2cFinalize(NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle) {
       ((nw_gtpv2c_stack_t*) hGtpcStackHandle)
           ->pGtpv2cMsgIeParseInfo[NW_GTP_IDENTIFICATION_RSP]);
 
-  OAI_GCC_DIAG_OFF("-Wint-to-pointer-cast");
-  nwGtpv2cTmrMinHeapDelete(
-      (NwGtpv2cTmrMinHeapT*) ((nw_gtpv2c_stack_t*) hGtpcStackHandle)
-          ->hTmrMinHeap);
-  OAI_GCC_DIAG_ON("-Wint-to-pointer-cast");
+  thiz = (nw_gtpv2c_stack_t*) hGtpcStackHandle;
+  if (thiz->tickTimerRunning) {
+    thiz->tmrMgr.tmrStopCallback(
+        thiz->tmrMgr.tmrMgrHandle, thiz->tickTimeoutInfo.hTimer);
+  }
+  nwGtpv2cHashFinalize(&thiz->tunnelMap);
+  nwGtpv2cHashFinalize(&thiz->outstandingTxSeqNumMap);
+  nwGtpv2cHashFinalize(&thiz->outstandingRxSeqNumMap);
+  nwGtpv2cPoolFinalize(&thiz->tunnelPool);
+  nwGtpv2cPoolFinalize(&thiz->trxnPool);
+  nwGtpv2cPoolFinalize(&thiz->msgPool);
+  nwGtpv2cPoolFinalize(&thiz->timeoutInfoPool);
   free_wrapper((void**) &hGtpcStackHandle);
   return NW_OK;
 }
@@ -2101,139 +1949,93 @@ nw_rc_t nwGtpv2cProcessUlpReq(
   OAILOG_FUNC_RETURN(LOG_GTPV2C, rc);
 }
 
+/*---------------------------------------------------------------------------
+   Timer Wheel
+  --------------------------------------------------------------------------*/
+
+static uint64_t nwGtpv2cTimerNowMs(void) {
+  struct timespec ts = {0};
+
+  NW_ASSERT(clock_gettime(CLOCK_MONOTONIC, &ts) == 0);
+  return (uint64_t) ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+/**
+   Arm the ULP timer for the next tick of the wheel
+*/
+static nw_rc_t nwGtpv2cStartTickTimer(nw_gtpv2c_stack_t* thiz) {
+  nw_rc_t rc = thiz->tmrMgr.tmrStartCallback(
+      thiz->tmrMgr.tmrMgrHandle, 0, NW_GTPV2C_TIMER_TICK_MS * 1000,
+      NW_GTPV2C_TMR_TYPE_ONE_SHOT, (void*) &thiz->tickTimeoutInfo,
+      &thiz->tickTimeoutInfo.hTimer);
+
+  thiz->tickTimerRunning = (NW_OK == rc);
+  return rc;
+}
+
 /**
    Process Timer timeout Request from Timer ULP Manager
 */
 
-nw_rc_t nwGtpv2cProcessTimeoutOld(void* arg) {
-  nw_rc_t rc                                 = NW_FAILURE;
+nw_rc_t nwGtpv2cProcessTimeout(void* arg) {
+  nw_rc_t rc                                 = NW_OK;
   nw_gtpv2c_stack_t* thiz                    = NULL;
   nw_gtpv2c_timeout_info_t* timeoutInfo      = (nw_gtpv2c_timeout_info_t*) arg;
   nw_gtpv2c_timeout_info_t* pNextTimeoutInfo = NULL;
-  struct timeval tv                          = {0};
+  struct nw_gtpv2c_timer_list_s* slot        = NULL;
+  nw_rc_t (*timeoutCallbackFunc)(void*)      = NULL;
+  void* timeoutArg                           = NULL;
+  uint64_t nowTick                           = 0;
+  uint64_t lastTick                          = 0;
+  uint64_t tick                              = 0;
 
   NW_ASSERT(timeoutInfo != NULL);
-  thiz =
-      (nw_gtpv2c_stack_t*) (((nw_gtpv2c_timeout_info_t*) timeoutInfo)->hStack);
+  thiz = (nw_gtpv2c_stack_t*) (timeoutInfo->hStack);
   NW_ASSERT(thiz != NULL);
   OAILOG_FUNC_IN(LOG_GTPV2C);
 
-  if (thiz->activeTimerInfo == timeoutInfo) {
-    thiz->activeTimerInfo = NULL;
-    RB_REMOVE(NwGtpv2cActiveTimerList, &(thiz->activeTimerList), timeoutInfo);
-    timeoutInfo->next       = gpGtpv2cTimeoutInfoPool;
-    gpGtpv2cTimeoutInfoPool = timeoutInfo;
-    rc = ((timeoutInfo)->timeoutCallbackFunc)(timeoutInfo->timeoutArg);
-  } else {
+  if (timeoutInfo != &thiz->tickTimeoutInfo || !thiz->tickTimerRunning) {
     OAILOG_WARNING(
         LOG_GTPV2C,
-        "Received timeout event from ULP for non-existent timeoutInfo 0x%p and "
-        "activeTimer 0x%p!\n",
-        timeoutInfo, thiz->activeTimerInfo);
+        "Received timeout event from ULP for non-existent timeoutInfo 0x%p!\n",
+        timeoutInfo);
     OAILOG_FUNC_RETURN(LOG_GTPV2C, NW_OK);
   }
-
-  NW_ASSERT(gettimeofday(&tv, NULL) == 0);
-
-  for ((timeoutInfo) =
-           RB_MIN(NwGtpv2cActiveTimerList, &(thiz->activeTimerList));
-       (timeoutInfo) != NULL;) {
-    if (NW_GTPV2C_TIMER_CMP_P(&timeoutInfo->tvTimeout, &tv, >)) break;
-
-    pNextTimeoutInfo =
-        RB_NEXT(NwGtpv2cActiveTimerList, &(thiz->activeTimerList), timeoutInfo);
-    RB_REMOVE(NwGtpv2cActiveTimerList, &(thiz->activeTimerList), timeoutInfo);
-    timeoutInfo->next       = gpGtpv2cTimeoutInfoPool;
-    gpGtpv2cTimeoutInfoPool = timeoutInfo;
-    rc          = ((timeoutInfo)->timeoutCallbackFunc)(timeoutInfo->timeoutArg);
-    timeoutInfo = pNextTimeoutInfo;
-  }
-
-  // activeTimerInfo may be reset by the timeoutCallbackFunc call above
-  if (thiz->activeTimerInfo == NULL) {
-    timeoutInfo = RB_MIN(NwGtpv2cActiveTimerList, &(thiz->activeTimerList));
-
-    if (timeoutInfo) {
-      NW_GTPV2C_TIMER_SUB(&timeoutInfo->tvTimeout, &tv, &tv);
-      rc = thiz->tmrMgr.tmrStartCallback(
-          thiz->tmrMgr.tmrMgrHandle, tv.tv_sec, tv.tv_usec,
-          timeoutInfo->tmrType, (void*) timeoutInfo, &timeoutInfo->hTimer);
-      NW_ASSERT(NW_OK == rc);
-      thiz->activeTimerInfo = timeoutInfo;
+  thiz->tickTimerRunning = false;
+
+  // Visit the slots of the ticks elapsed since the last run, every slot once
+  // when the run is late by more than a turn of the wheel
+  nowTick  = nwGtpv2cTimerNowMs() / NW_GTPV2C_TIMER_TICK_MS;
+  lastTick = thiz->timerWheelTick + NW_GTPV2C_TIMER_WHEEL_SLOTS;
+  if (lastTick > nowTick) lastTick = nowTick;
+
+  for (tick = thiz->timerWheelTick + 1; tick <= lastTick; tick++) {
+    slot = &thiz->timerWheel[tick % NW_GTPV2C_TIMER_WHEEL_SLOTS];
+    for (timeoutInfo = LIST_FIRST(slot); timeoutInfo;
+         timeoutInfo = pNextTimeoutInfo) {
+      pNextTimeoutInfo = LIST_NEXT(timeoutInfo, timerWheelEntry);
+      if (timeoutInfo->expiryTick <= nowTick) {
+        LIST_REMOVE(timeoutInfo, timerWheelEntry);
+        LIST_INSERT_HEAD(&thiz->dueTimers, timeoutInfo, timerWheelEntry);
+      }
     }
   }
-
-  OAILOG_FUNC_RETURN(LOG_GTPV2C, rc);
-}
-
-nw_rc_t nwGtpv2cProcessTimeout(void* arg) {
-  nw_rc_t rc                            = NW_FAILURE;
-  nw_gtpv2c_stack_t* thiz               = NULL;
-  nw_gtpv2c_timeout_info_t* timeoutInfo = (nw_gtpv2c_timeout_info_t*) arg;
-  struct timeval tv                     = {0};
-
-  NW_ASSERT(timeoutInfo != NULL);
-  thiz = (nw_gtpv2c_stack_t*) (timeoutInfo->hStack);
-  NW_ASSERT(thiz != NULL);
-  OAILOG_FUNC_IN(LOG_GTPV2C);
-
-  if (thiz->activeTimerInfo == timeoutInfo) {
-    thiz->activeTimerInfo = NULL;
-    OAI_GCC_DIAG_OFF("-Wint-to-pointer-cast");
-    rc = nwGtpv2cTmrMinHeapRemove(
-        (NwGtpv2cTmrMinHeapT*) thiz->hTmrMinHeap,
-        timeoutInfo->timerMinHeapIndex);
-    OAI_GCC_DIAG_ON("-Wint-to-pointer-cast");
-    timeoutInfo->next       = gpGtpv2cTimeoutInfoPool;
-    gpGtpv2cTimeoutInfoPool = timeoutInfo;
-    rc = ((timeoutInfo)->timeoutCallbackFunc)(timeoutInfo->timeoutArg);
-  } else {
-    OAILOG_WARNING(
-        LOG_GTPV2C,
-        "Received timeout event from ULP for "
-        "non-existent timeoutInfo 0x%p and activeTimer 0x%p!\n",
-        timeoutInfo, thiz->activeTimerInfo);
-    OAILOG_FUNC_RETURN(LOG_GTPV2C, NW_OK);
-  }
-
-  NW_ASSERT(gettimeofday(&tv, NULL) == 0);
-  OAI_GCC_DIAG_OFF("-Wint-to-pointer-cast");
-  timeoutInfo =
-      nwGtpv2cTmrMinHeapPeek((NwGtpv2cTmrMinHeapT*) thiz->hTmrMinHeap);
-  OAI_GCC_DIAG_ON("-Wint-to-pointer-cast");
-
-  while ((timeoutInfo) != NULL) {
-    if (NW_GTPV2C_TIMER_CMP_P(&timeoutInfo->tvTimeout, &tv, >)) break;
-
-    OAI_GCC_DIAG_OFF("-Wint-to-pointer-cast");
-    rc = nwGtpv2cTmrMinHeapRemove(
-        (NwGtpv2cTmrMinHeapT*) thiz->hTmrMinHeap,
-        timeoutInfo->timerMinHeapIndex);
-    OAI_GCC_DIAG_ON(int - to - pointer - cast);
-    timeoutInfo->next       = gpGtpv2cTimeoutInfoPool;
-    gpGtpv2cTimeoutInfoPool = timeoutInfo;
-    rc = ((timeoutInfo)->timeoutCallbackFunc)(timeoutInfo->timeoutArg);
-    OAI_GCC_DIAG_OFF("-Wint-to-pointer-cast");
-    timeoutInfo =
-        nwGtpv2cTmrMinHeapPeek((NwGtpv2cTmrMinHeapT*) thiz->hTmrMinHeap);
-    OAI_GCC_DIAG_ON("-Wint-to-pointer-cast");
+  if (nowTick > thiz->timerWheelTick) thiz->timerWheelTick = nowTick;
+
+  // Callbacks start and stop timers, due ones included, so take them one by
+  // one from the list
+  while ((timeoutInfo = LIST_FIRST(&thiz->dueTimers))) {
+    LIST_REMOVE(timeoutInfo, timerWheelEntry);
+    thiz->nbTimers--;
+    timeoutCallbackFunc = timeoutInfo->timeoutCallbackFunc;
+    timeoutArg          = timeoutInfo->timeoutArg;
+    nwGtpv2cPoolFree(&thiz->timeoutInfoPool, timeoutInfo);
+    rc = timeoutCallbackFunc(timeoutArg);
   }
 
-  // activeTimerInfo may be reset by the timeoutCallbackFunc call above
-  if (thiz->activeTimerInfo == NULL) {
-    OAI_GCC_DIAG_OFF("-Wint-to-pointer-cast");
-    timeoutInfo =
-        nwGtpv2cTmrMinHeapPeek((NwGtpv2cTmrMinHeapT*) thiz->hTmrMinHeap);
-    OAI_GCC_DIAG_ON("-Wint-to-pointer-cast");
-
-    if (timeoutInfo) {
-      NW_GTPV2C_TIMER_SUB(&timeoutInfo->tvTimeout, &tv, &tv);
-      rc = thiz->tmrMgr.tmrStartCallback(
-          thiz->tmrMgr.tmrMgrHandle, tv.tv_sec, tv.tv_usec,
-          timeoutInfo->tmrType, (void*) timeoutInfo, &timeoutInfo->hTimer);
-      NW_ASSERT(NW_OK == rc);
-      thiz->activeTimerInfo = timeoutInfo;
-    }
+  if (thiz->nbTimers && !thiz->tickTimerRunning) {
+    rc = nwGtpv2cStartTickTimer(thiz);
+    NW_ASSERT(NW_OK == rc);
   }
 
   OAILOG_FUNC_RETURN(LOG_GTPV2C, rc);
@@ -2248,161 +2050,46 @@ nw_rc_t nwGtpv2cStartTimer(
     uint32_t tmrType, nw_rc_t (*timeoutCallbackFunc)(void*),
     void* timeoutCallbackArg, nw_gtpv2c_timer_handle_t* phTimer) {
   nw_rc_t rc                            = NW_OK;
-  struct timeval tv                     = {0};
   nw_gtpv2c_timeout_info_t* timeoutInfo = NULL;
+  uint64_t nowMs                        = 0;
+  uint64_t expiryMs                     = 0;
 
+  NW_ASSERT(thiz != NULL);
   OAILOG_FUNC_IN(LOG_GTPV2C);
 
-  if (gpGtpv2cTimeoutInfoPool) {
-    timeoutInfo             = gpGtpv2cTimeoutInfoPool;
-    gpGtpv2cTimeoutInfoPool = gpGtpv2cTimeoutInfoPool->next;
-  } else {
-    NW_GTPV2C_MALLOC(
-        thiz, sizeof(nw_gtpv2c_timeout_info_t), timeoutInfo,
-        nw_gtpv2c_timeout_info_t*);
+  timeoutInfo = (nw_gtpv2c_timeout_info_t*) nwGtpv2cPoolAlloc(
+      &thiz->timeoutInfoPool);
+  if (!timeoutInfo) {
+    *phTimer = (nw_gtpv2c_timer_handle_t) 0;
+    OAILOG_FUNC_RETURN(LOG_GTPV2C, NW_FAILURE);
   }
 
-  if (timeoutInfo) {
-    timeoutInfo->tmrType             = tmrType;
-    timeoutInfo->timeoutArg          = timeoutCallbackArg;
-    timeoutInfo->timeoutCallbackFunc = timeoutCallbackFunc;
-    timeoutInfo->hStack              = (nw_gtpv2c_stack_handle_t) thiz;
-    NW_ASSERT(gettimeofday(&tv, NULL) == 0);
-    NW_ASSERT(gettimeofday(&timeoutInfo->tvTimeout, NULL) == 0);
-    timeoutInfo->tvTimeout.tv_sec  = timeoutSec;
-    timeoutInfo->tvTimeout.tv_usec = timeoutUsec;
-    NW_GTPV2C_TIMER_ADD(&tv, &timeoutInfo->tvTimeout, &timeoutInfo->tvTimeout);
-    OAI_GCC_DIAG_OFF("-Wint-to-pointer-cast");
-    rc = nwGtpv2cTmrMinHeapInsert(
-        (NwGtpv2cTmrMinHeapT*) thiz->hTmrMinHeap, timeoutInfo);
-    OAI_GCC_DIAG_ON("-Wint-to-pointer-cast");
-#if 0
-
-      do {
-        collision = RB_INSERT (NwGtpv2cActiveTimerList, &(thiz->activeTimerList), timeoutInfo);
-
-        if (!collision)
-          break;
-
-        OAILOG_WARNING (LOG_GTPV2C,  "timer collision!\n");
-        timeoutInfo->tvTimeout.tv_usec++;       /* HACK: In case there is a collision, schedule this event 1 usec later */
-
-        if (timeoutInfo->tvTimeout.tv_usec > (999999 /*1000000 - 1 */ )) {
-          timeoutInfo->tvTimeout.tv_usec = 0;
-          timeoutInfo->tvTimeout.tv_sec++;
-        }
-      } while (1);
-
-#endif
-
-    if (thiz->activeTimerInfo) {
-      if (NW_GTPV2C_TIMER_CMP_P(
-              &(thiz->activeTimerInfo->tvTimeout), &(timeoutInfo->tvTimeout),
-              >)) {
-        //          OAILOG_DEBUG (LOG_GTPV2C, "Stopping active timer 0x%"
-        //          PRIxPTR " for info 0x%p!\n", thiz->activeTimerInfo->hTimer,
-        //          thiz->activeTimerInfo);
-        rc = thiz->tmrMgr.tmrStopCallback(
-            thiz->tmrMgr.tmrMgrHandle, thiz->activeTimerInfo->hTimer);
-        NW_ASSERT(NW_OK == rc);
-      } else {
-        OAILOG_DEBUG(
-            LOG_GTPV2C, "Already Started timer 0x%" PRIxPTR " for info 0x%p!\n",
-            thiz->activeTimerInfo->hTimer, thiz->activeTimerInfo);
-        *phTimer = (nw_gtpv2c_timer_handle_t) timeoutInfo;
-        OAILOG_FUNC_RETURN(LOG_GTPV2C, NW_OK);
-      }
-    }
+  timeoutInfo->tmrType             = tmrType;
+  timeoutInfo->timeoutArg          = timeoutCallbackArg;
+  timeoutInfo->timeoutCallbackFunc = timeoutCallbackFunc;
+  timeoutInfo->hStack              = (nw_gtpv2c_stack_handle_t) thiz;
+  timeoutInfo->hTimer              = (nw_gtpv2c_timer_handle_t) timeoutInfo;
 
-    rc = thiz->tmrMgr.tmrStartCallback(
-        thiz->tmrMgr.tmrMgrHandle, timeoutSec, timeoutUsec, tmrType,
-        (void*) timeoutInfo, &timeoutInfo->hTimer);
-    OAILOG_DEBUG(
-        LOG_GTPV2C, "Started timer 0x%" PRIxPTR " for info 0x%p!\n",
-        timeoutInfo->hTimer, timeoutInfo);
-    NW_ASSERT(NW_OK == rc);
-    thiz->activeTimerInfo = timeoutInfo;
+  nowMs = nwGtpv2cTimerNowMs();
+  if (!thiz->nbTimers) {
+    // The wheel did not turn while empty
+    thiz->timerWheelTick = nowMs / NW_GTPV2C_TIMER_TICK_MS;
   }
-
-  *phTimer = (nw_gtpv2c_timer_handle_t) timeoutInfo;
-  OAILOG_FUNC_RETURN(LOG_GTPV2C, rc);
-}
-
-nw_rc_t nwGtpv2cStartTimerOld(
-    nw_gtpv2c_stack_t* thiz, uint32_t timeoutSec, uint32_t timeoutUsec,
-    uint32_t tmrType, nw_rc_t (*timeoutCallbackFunc)(void*),
-    void* timeoutCallbackArg, nw_gtpv2c_timer_handle_t* phTimer) {
-  nw_rc_t rc = NW_OK;
-  struct timeval tv;
-  nw_gtpv2c_timeout_info_t* timeoutInfo;
-  nw_gtpv2c_timeout_info_t* collision;
-
-  NW_ASSERT(thiz != NULL);
-  OAILOG_FUNC_IN(LOG_GTPV2C);
-
-  if (gpGtpv2cTimeoutInfoPool) {
-    timeoutInfo             = gpGtpv2cTimeoutInfoPool;
-    gpGtpv2cTimeoutInfoPool = gpGtpv2cTimeoutInfoPool->next;
-  } else {
-    NW_GTPV2C_MALLOC(
-        thiz, sizeof(nw_gtpv2c_timeout_info_t), timeoutInfo,
-        nw_gtpv2c_timeout_info_t*);
+  // Never fire early: round up to the next tick
+  expiryMs = nowMs + (uint64_t) timeoutSec * 1000 + timeoutUsec / 1000;
+  timeoutInfo->expiryTick =
+      (expiryMs + NW_GTPV2C_TIMER_TICK_MS - 1) / NW_GTPV2C_TIMER_TICK_MS;
+  if (timeoutInfo->expiryTick <= thiz->timerWheelTick) {
+    timeoutInfo->expiryTick = thiz->timerWheelTick + 1;
   }
+  LIST_INSERT_HEAD(
+      &thiz->timerWheel[timeoutInfo->expiryTick % NW_GTPV2C_TIMER_WHEEL_SLOTS],
+      timeoutInfo, timerWheelEntry);
+  thiz->nbTimers++;
 
-  if (timeoutInfo) {
-    timeoutInfo->tmrType             = tmrType;
-    timeoutInfo->timeoutArg          = timeoutCallbackArg;
-    timeoutInfo->timeoutCallbackFunc = timeoutCallbackFunc;
-    timeoutInfo->hStack              = (nw_gtpv2c_stack_handle_t) thiz;
-    NW_ASSERT(gettimeofday(&tv, NULL) == 0);
-    NW_ASSERT(gettimeofday(&timeoutInfo->tvTimeout, NULL) == 0);
-    timeoutInfo->tvTimeout.tv_sec  = timeoutSec;
-    timeoutInfo->tvTimeout.tv_usec = timeoutUsec;
-    NW_GTPV2C_TIMER_ADD(&tv, &timeoutInfo->tvTimeout, &timeoutInfo->tvTimeout);
-
-    do {
-      collision = RB_INSERT(
-          NwGtpv2cActiveTimerList, &(thiz->activeTimerList), timeoutInfo);
-
-      if (!collision) break;
-
-      OAILOG_WARNING(LOG_GTPV2C, "timer collision!\n");
-      timeoutInfo->tvTimeout.tv_usec++; /* HACK: In case there is a collision,
-                                           schedule this event 1 usec later */
-
-      if (timeoutInfo->tvTimeout.tv_usec > (999999 /*1000000 - 1 */)) {
-        timeoutInfo->tvTimeout.tv_usec = 0;
-        timeoutInfo->tvTimeout.tv_sec++;
-      }
-    } while (1);
-
-    if (thiz->activeTimerInfo) {
-      if (NW_GTPV2C_TIMER_CMP_P(
-              &(thiz->activeTimerInfo->tvTimeout), &(timeoutInfo->tvTimeout),
-              >)) {
-        OAILOG_DEBUG(
-            LOG_GTPV2C, "Stopping active timer 0x%" PRIxPTR " for info 0x%p!\n",
-            thiz->activeTimerInfo->hTimer, thiz->activeTimerInfo);
-        rc = thiz->tmrMgr.tmrStopCallback(
-            thiz->tmrMgr.tmrMgrHandle, thiz->activeTimerInfo->hTimer);
-        NW_ASSERT(NW_OK == rc);
-      } else {
-        OAILOG_DEBUG(
-            LOG_GTPV2C, "Already Started timer 0x%" PRIxPTR " for info 0x%p!\n",
-            thiz->activeTimerInfo->hTimer, thiz->activeTimerInfo);
-        *phTimer = (nw_gtpv2c_timer_handle_t) timeoutInfo;
-        OAILOG_FUNC_RETURN(LOG_GTPV2C, NW_OK);
-      }
-    }
-
-    rc = thiz->tmrMgr.tmrStartCallback(
-        thiz->tmrMgr.tmrMgrHandle, timeoutSec, timeoutUsec, tmrType,
-        (void*) timeoutInfo, &timeoutInfo->hTimer);
-    OAILOG_DEBUG(
-        LOG_GTPV2C, "Started timer 0x%" PRIxPTR " for info 0x%p!\n",
-        timeoutInfo->hTimer, timeoutInfo);
+  if (!thiz->tickTimerRunning) {
+    rc = nwGtpv2cStartTickTimer(thiz);
     NW_ASSERT(NW_OK == rc);
-    thiz->activeTimerInfo = timeoutInfo;
   }
 
   *phTimer = (nw_gtpv2c_timer_handle_t) timeoutInfo;
@@ -2414,115 +2101,17 @@ nw_rc_t nwGtpv2cStartTimerOld(
 */
 nw_rc_t nwGtpv2cStopTimer(
     nw_gtpv2c_stack_t* thiz, nw_gtpv2c_timer_handle_t hTimer) {
-  nw_rc_t rc = NW_OK;
-  struct timeval tv;
-  nw_gtpv2c_timeout_info_t* timeoutInfo;
-
-  NW_ASSERT(thiz != NULL);
-  OAILOG_FUNC_IN(LOG_GTPV2C);
-  timeoutInfo = (nw_gtpv2c_timeout_info_t*) hTimer;
-  OAI_GCC_DIAG_OFF("-Wint-to-pointer-cast");
-  rc = nwGtpv2cTmrMinHeapRemove(
-      (NwGtpv2cTmrMinHeapT*) thiz->hTmrMinHeap, timeoutInfo->timerMinHeapIndex);
-  OAI_GCC_DIAG_ON("-Wint-to-pointer-cast");
-  timeoutInfo->next       = gpGtpv2cTimeoutInfoPool;
-  gpGtpv2cTimeoutInfoPool = timeoutInfo;
-  //    OAILOG_DEBUG (LOG_GTPV2C, "Stopping active timer 0x%" PRIxPTR " for info
-  //    0x%p!\n", timeoutInfo->hTimer, timeoutInfo);
-
-  if (thiz->activeTimerInfo == timeoutInfo) {
-    OAILOG_DEBUG(
-        LOG_GTPV2C, "Stopping active timer 0x%" PRIxPTR " for info 0x%p!\n",
-        timeoutInfo->hTimer, timeoutInfo);
-    rc = thiz->tmrMgr.tmrStopCallback(
-        thiz->tmrMgr.tmrMgrHandle, timeoutInfo->hTimer);
-    thiz->activeTimerInfo = NULL;
-    if (NW_OK != rc) {
-      OAILOG_ERROR(
-          LOG_GTPV2C,
-          "Stopping active timer 0x%" PRIxPTR " for info 0x%p failed!\n",
-          timeoutInfo->hTimer, timeoutInfo);
-    } else
-      OAILOG_INFO(
-          LOG_GTPV2C, "Stopped active timer 0x%" PRIxPTR " for info 0x%p!\n",
-          timeoutInfo->hTimer, timeoutInfo);
-    OAI_GCC_DIAG_OFF("-Wint-to-pointer-cast");
-    timeoutInfo =
-        nwGtpv2cTmrMinHeapPeek((NwGtpv2cTmrMinHeapT*) thiz->hTmrMinHeap);
-    OAI_GCC_DIAG_ON("-Wint-to-pointer-cast");
-
-    if (timeoutInfo) {
-      NW_ASSERT(gettimeofday(&tv, NULL) == 0);
-
-      if (NW_GTPV2C_TIMER_CMP_P(&timeoutInfo->tvTimeout, &tv, <)) {
-        thiz->activeTimerInfo = timeoutInfo;
-        rc                    = nwGtpv2cProcessTimeout(timeoutInfo);
-        NW_ASSERT(NW_OK == rc);
-      } else {
-        NW_GTPV2C_TIMER_SUB(&timeoutInfo->tvTimeout, &tv, &tv);
-        rc = thiz->tmrMgr.tmrStartCallback(
-            thiz->tmrMgr.tmrMgrHandle, tv.tv_sec, tv.tv_usec,
-            timeoutInfo->tmrType, (void*) timeoutInfo, &timeoutInfo->hTimer);
-        NW_ASSERT(NW_OK == rc);
-        OAILOG_DEBUG(
-            LOG_GTPV2C, "Started timer 0x%" PRIxPTR " for info 0x%p!\n",
-            timeoutInfo->hTimer, timeoutInfo);
-        thiz->activeTimerInfo = timeoutInfo;
-      }
-    }
-  }
-
-  OAILOG_FUNC_RETURN(LOG_GTPV2C, rc);
-}
-
-nw_rc_t nwGtpv2cStopTimerOld(
-    nw_gtpv2c_stack_t* thiz, nw_gtpv2c_timer_handle_t hTimer) {
-  nw_rc_t rc = NW_OK;
-  struct timeval tv;
-  nw_gtpv2c_timeout_info_t* timeoutInfo;
+  nw_gtpv2c_timeout_info_t* timeoutInfo = NULL;
 
   NW_ASSERT(thiz != NULL);
   OAILOG_FUNC_IN(LOG_GTPV2C);
   timeoutInfo = (nw_gtpv2c_timeout_info_t*) hTimer;
-  RB_REMOVE(NwGtpv2cActiveTimerList, &(thiz->activeTimerList), timeoutInfo);
-  timeoutInfo->next       = gpGtpv2cTimeoutInfoPool;
-  gpGtpv2cTimeoutInfoPool = timeoutInfo;
-  OAILOG_DEBUG(
-      LOG_GTPV2C, "Stopping active timer 0x%" PRIxPTR " for info 0x%p!\n",
-      timeoutInfo->hTimer, timeoutInfo);
-
-  if (thiz->activeTimerInfo == timeoutInfo) {
-    OAILOG_DEBUG(
-        LOG_GTPV2C, "Stopping active timer 0x%" PRIxPTR " for info 0x%p!\n",
-        timeoutInfo->hTimer, timeoutInfo);
-    rc = thiz->tmrMgr.tmrStopCallback(
-        thiz->tmrMgr.tmrMgrHandle, timeoutInfo->hTimer);
-    thiz->activeTimerInfo = NULL;
-    NW_ASSERT(NW_OK == rc);
-    timeoutInfo = RB_MIN(NwGtpv2cActiveTimerList, &(thiz->activeTimerList));
-
-    if (timeoutInfo) {
-      NW_ASSERT(gettimeofday(&tv, NULL) == 0);
-
-      if (NW_GTPV2C_TIMER_CMP_P(&timeoutInfo->tvTimeout, &tv, <)) {
-        thiz->activeTimerInfo = timeoutInfo;
-        rc                    = nwGtpv2cProcessTimeout(timeoutInfo);
-        NW_ASSERT(NW_OK == rc);
-      } else {
-        NW_GTPV2C_TIMER_SUB(&timeoutInfo->tvTimeout, &tv, &tv);
-        rc = thiz->tmrMgr.tmrStartCallback(
-            thiz->tmrMgr.tmrMgrHandle, tv.tv_sec, tv.tv_usec,
-            timeoutInfo->tmrType, (void*) timeoutInfo, &timeoutInfo->hTimer);
-        NW_ASSERT(NW_OK == rc);
-        OAILOG_DEBUG(
-            LOG_GTPV2C, "Started timer 0x%" PRIxPTR " for info 0x%p!\n",
-            timeoutInfo->hTimer, timeoutInfo);
-        thiz->activeTimerInfo = timeoutInfo;
-      }
-    }
-  }
-
-  OAILOG_FUNC_RETURN(LOG_GTPV2C, rc);
+  // In a wheel slot or due, the tick timer stops by itself once no timer is
+  // left
+  LIST_REMOVE(timeoutInfo, timerWheelEntry);
+  thiz->nbTimers--;
+  nwGtpv2cPoolFree(&thiz->timeoutInfoPool, timeoutInfo);
+  OAILOG_FUNC_RETURN(LOG_GTPV2C, NW_OK);
 }
 
 #ifdef __cplusplus
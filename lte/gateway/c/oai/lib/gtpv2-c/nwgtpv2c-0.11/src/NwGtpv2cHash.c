@@ -0,0 +1,160 @@
+/*----------------------------------------------------------------------------*
+ *                                                                            *
+                                n w - g t p v 2 c
+      G P R S   T u n n e l i n g    P r o t o c o l   v 2 c    S t a c k
+ *                                                                            *
+ *                                                                            *
+   Copyright (c) 2010-2011 Amit Chawre
+   All rights reserved.
+ *                                                                            *
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+ *                                                                            *
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+   3. The name of the author may not be used to endorse or promote products
+      derived from this software without specific prior written permission.
+ *                                                                            *
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ----------------------------------------------------------------------------*/
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "NwTypes.h"
+#include "NwError.h"
+#include "NwGtpv2cHash.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*--------------------------------------------------------------------------*
+                     P R I V A T E      F U N C T I O N S
+  --------------------------------------------------------------------------*/
+
+static nw_rc_t nwGtpv2cHashResize(nw_gtpv2c_hash_t* thiz, uint32_t nbBuckets) {
+  nw_gtpv2c_hash_node_t** buckets = NULL;
+  nw_gtpv2c_hash_node_t* node     = NULL;
+  nw_gtpv2c_hash_node_t* next     = NULL;
+  uint32_t i                      = 0;
+  uint32_t index                  = 0;
+
+  buckets = (nw_gtpv2c_hash_node_t**) calloc(nbBuckets, sizeof(*buckets));
+  if (!buckets) return NW_FAILURE;
+
+  for (i = 0; thiz->buckets && i <= thiz->mask; i++) {
+    for (node = thiz->buckets[i]; node; node = next) {
+      next           = node->next;
+      index          = node->hash & (nbBuckets - 1);
+      node->next     = buckets[index];
+      buckets[index] = node;
+    }
+  }
+  free(thiz->buckets);
+  thiz->buckets = buckets;
+  thiz->mask    = nbBuckets - 1;
+  return NW_OK;
+}
+
+/*--------------------------------------------------------------------------*
+                        P U B L I C    F U N C T I O N S
+  --------------------------------------------------------------------------*/
+
+nw_rc_t nwGtpv2cHashInit(
+    nw_gtpv2c_hash_t* thiz, uint32_t nbBuckets, nw_gtpv2c_hash_equal_t equal) {
+  uint32_t size = 1;
+
+  while (size < nbBuckets) size <<= 1;
+  memset(thiz, 0, sizeof(*thiz));
+  thiz->equal = equal;
+  return nwGtpv2cHashResize(thiz, size);
+}
+
+void nwGtpv2cHashFinalize(nw_gtpv2c_hash_t* thiz) {
+  free(thiz->buckets);
+  memset(thiz, 0, sizeof(*thiz));
+}
+
+uint32_t nwGtpv2cHashKey(uint32_t key, const void* addr, size_t addrLen) {
+  const uint8_t* bytes = (const uint8_t*) addr;
+  uint32_t hash        = 2166136261u ^ key;
+  size_t i             = 0;
+
+  // FNV-1a over the address, then the murmur3 finalizer to spread the low
+  // bits used as bucket index
+  for (i = 0; i < addrLen; i++) {
+    hash = (hash ^ bytes[i]) * 16777619u;
+  }
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6bu;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35u;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+nw_gtpv2c_hash_node_t* nwGtpv2cHashFind(
+    nw_gtpv2c_hash_t* thiz, const nw_gtpv2c_hash_node_t* key) {
+  nw_gtpv2c_hash_node_t* node = thiz->buckets[key->hash & thiz->mask];
+
+  for (; node; node = node->next) {
+    if (node->hash == key->hash && thiz->equal(node, key)) return node;
+  }
+  return NULL;
+}
+
+nw_gtpv2c_hash_node_t* nwGtpv2cHashInsert(
+    nw_gtpv2c_hash_t* thiz, nw_gtpv2c_hash_node_t* node) {
+  nw_gtpv2c_hash_node_t* collision = nwGtpv2cHashFind(thiz, node);
+  nw_gtpv2c_hash_node_t** bucket   = NULL;
+
+  if (collision) return collision;
+
+  if (thiz->count > thiz->mask) {
+    // Keeps the old buckets when out of memory, chains only get longer
+    nwGtpv2cHashResize(thiz, (thiz->mask + 1) << 1);
+  }
+  bucket     = &thiz->buckets[node->hash & thiz->mask];
+  node->next = *bucket;
+  *bucket    = node;
+  thiz->count++;
+  return NULL;
+}
+
+nw_gtpv2c_hash_node_t* nwGtpv2cHashRemove(
+    nw_gtpv2c_hash_t* thiz, nw_gtpv2c_hash_node_t* node) {
+  nw_gtpv2c_hash_node_t** link = &thiz->buckets[node->hash & thiz->mask];
+
+  for (; *link; link = &(*link)->next) {
+    if (*link == node) {
+      *link      = node->next;
+      node->next = NULL;
+      thiz->count--;
+      return node;
+    }
+  }
+  return NULL;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/*--------------------------------------------------------------------------*
+                        E N D     O F    F I L E
+  --------------------------------------------------------------------------*/
@@ -53,12 +53,6 @@
 extern "C" {
 #endif
 
-/*----------------------------------------------------------------------------*
-                       P R I V A T E     F U N C T I O N S
-  ----------------------------------------------------------------------------*/
-
-static nw_gtpv2c_msg_t* gpGtpv2cMsgPool = NULL;
-
 /*----------------------------------------------------------------------------*
                          P U B L I C   F U N C T I O N S
   ----------------------------------------------------------------------------*/
@@ -71,13 +65,7 @@ nw_rc_t nwGtpv2cMsgNew(
   nw_gtpv2c_msg_t* pMsg;
   NW_ASSERT(pStack);
 
-  if (gpGtpv2cMsgPool) {
-    pMsg            = gpGtpv2cMsgPool;
-    gpGtpv2cMsgPool = gpGtpv2cMsgPool->next;
-  } else {
-    NW_GTPV2C_MALLOC(pStack, sizeof(nw_gtpv2c_msg_t), pMsg, nw_gtpv2c_msg_t*);
-    OAILOG_DEBUG(LOG_GTPV2C, "ALLOCATED NEW MESSAGE %p!\n", pMsg);
-  }
+  pMsg = (nw_gtpv2c_msg_t*) nwGtpv2cPoolAlloc(&pStack->msgPool);
 
   if (pMsg) {
     pMsg->version     = NW_GTP_VERSION;
@@ -104,12 +92,7 @@ nw_rc_t nwGtpv2cMsgFromBufferNew(
 
   NW_ASSERT(pStack);
 
-  if (gpGtpv2cMsgPool) {
-    pMsg            = gpGtpv2cMsgPool;
-    gpGtpv2cMsgPool = gpGtpv2cMsgPool->next;
-  } else {
-    NW_GTPV2C_MALLOC(pStack, sizeof(nw_gtpv2c_msg_t), pMsg, nw_gtpv2c_msg_t*);
-  }
+  pMsg = (nw_gtpv2c_msg_t*) nwGtpv2cPoolAlloc(&pStack->msgPool);
 
   if (pMsg) {
     *phMsg = (nw_gtpv2c_msg_handle_t) pMsg;
@@ -139,12 +122,14 @@ nw_rc_t nwGtpv2cMsgFromBufferNew(
 nw_rc_t nwGtpv2cMsgDelete(
     NW_IN nw_gtpv2c_stack_handle_t hGtpcStackHandle,
     NW_IN nw_gtpv2c_msg_handle_t hMsg) {
+  nw_gtpv2c_msg_t* pMsg = (nw_gtpv2c_msg_t*) hMsg;
+
   OAILOG_DEBUG(LOG_GTPV2C, "Purging message 0x%" PRIxPTR "!\n", hMsg);
-  ((nw_gtpv2c_msg_t*) hMsg)->next = gpGtpv2cMsgPool;
-  gpGtpv2cMsgPool                 = (nw_gtpv2c_msg_t*) hMsg;
-  OAILOG_DEBUG(
-      LOG_GTPV2C, "Message pool %p! Next element %p !\n", gpGtpv2cMsgPool,
-      gpGtpv2cMsgPool->next);
+  // Back to the pool of the stack that created the message
+  nwGtpv2cPoolFree(
+      &((nw_gtpv2c_stack_t*) (pMsg->hStack ? pMsg->hStack : hGtpcStackHandle))
+           ->msgPool,
+      pMsg);
 
   return NW_OK;
 }
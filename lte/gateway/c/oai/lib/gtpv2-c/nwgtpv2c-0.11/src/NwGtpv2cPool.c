@@ -0,0 +1,121 @@
+/*----------------------------------------------------------------------------*
+ *                                                                            *
+                                n w - g t p v 2 c
+      G P R S   T u n n e l i n g    P r o t o c o l   v 2 c    S t a c k
+ *                                                                            *
+ *                                                                            *
+   Copyright (c) 2010-2011 Amit Chawre
+   All rights reserved.
+ *                                                                            *
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+ *                                                                            *
+   1. Redistributions of source code must retain the above copyright
+      notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+      notice, this list of conditions and the following disclaimer in the
+      documentation and/or other materials provided with the distribution.
+   3. The name of the author may not be used to endorse or promote products
+      derived from this software without specific prior written permission.
+ *                                                                            *
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+  ----------------------------------------------------------------------------*/
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "NwGtpv2cPool.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Keeps the objects of a chunk aligned as malloc would */
+#define NW_GTPV2C_POOL_ALIGN (2 * sizeof(void*))
+#define NW_GTPV2C_POOL_ROUND(_size)                                            \
+  (((_size) + NW_GTPV2C_POOL_ALIGN - 1) & ~(NW_GTPV2C_POOL_ALIGN - 1))
+
+/*--------------------------------------------------------------------------*
+                     P R I V A T E      F U N C T I O N S
+  --------------------------------------------------------------------------*/
+
+static int nwGtpv2cPoolGrow(nw_gtpv2c_pool_t* thiz) {
+  char* chunk = NULL;
+  char* obj   = NULL;
+  uint32_t i  = 0;
+
+  chunk = (char*) calloc(
+      1, NW_GTPV2C_POOL_ALIGN + (size_t) thiz->objsPerChunk * thiz->objSize);
+  if (!chunk) return 0;
+
+  *(void**) chunk = thiz->chunks;
+  thiz->chunks    = chunk;
+  thiz->nbChunks++;
+  // Hand out the objects in address order
+  for (i = thiz->objsPerChunk; i > 0; i--) {
+    obj            = chunk + NW_GTPV2C_POOL_ALIGN + (i - 1) * thiz->objSize;
+    *(void**) obj  = thiz->freeList;
+    thiz->freeList = obj;
+  }
+  return 1;
+}
+
+/*--------------------------------------------------------------------------*
+                        P U B L I C    F U N C T I O N S
+  --------------------------------------------------------------------------*/
+
+void nwGtpv2cPoolInit(
+    nw_gtpv2c_pool_t* thiz, size_t objSize, uint32_t objsPerChunk) {
+  memset(thiz, 0, sizeof(*thiz));
+  thiz->objSize      = NW_GTPV2C_POOL_ROUND(objSize);
+  thiz->objsPerChunk = objsPerChunk ? objsPerChunk : 1;
+}
+
+void nwGtpv2cPoolFinalize(nw_gtpv2c_pool_t* thiz) {
+  void* chunk = NULL;
+
+  while ((chunk = thiz->chunks)) {
+    thiz->chunks = *(void**) chunk;
+    free(chunk);
+  }
+  thiz->freeList = NULL;
+  thiz->nbChunks = 0;
+}
+
+void* nwGtpv2cPoolAlloc(nw_gtpv2c_pool_t* thiz) {
+  void* obj = NULL;
+
+  if (!thiz->freeList && !nwGtpv2cPoolGrow(thiz)) return NULL;
+
+  obj            = thiz->freeList;
+  thiz->freeList = *(void**) obj;
+  // Fresh objects are zeroed, do not leave the free list link behind
+  *(void**) obj = NULL;
+  return obj;
+}
+
+void nwGtpv2cPoolFree(nw_gtpv2c_pool_t* thiz, void* obj) {
+  if (!obj) return;
+
+  *(void**) obj  = thiz->freeList;
+  thiz->freeList = obj;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+/*--------------------------------------------------------------------------*
+                        E N D     O F    F I L E
+  --------------------------------------------------------------------------*/
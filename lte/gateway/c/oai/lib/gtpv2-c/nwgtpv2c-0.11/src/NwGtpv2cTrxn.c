@@ -54,8 +54,6 @@
 extern "C" {
 #endif
 
-static nw_gtpv2c_trxn_t* gpGtpv2cTrxnPool = NULL;
-
 /*--------------------------------------------------------------------------*
                      P R I V A T E      F U N C T I O N S
   --------------------------------------------------------------------------*/
@@ -93,9 +91,7 @@ static nw_rc_t nwGtpv2cTrxnPeerRspWaitTimeout(void* arg) {
         "Transaction transaction %p (seqNo=0x%x) was acknowledged. Removing "
         "for timeout. \n",
         thiz, thiz->seqNum);
-    RB_REMOVE(
-        NwGtpv2cOutstandingTxSeqNumTrxnMap, &(pStack->outstandingTxSeqNumMap),
-        thiz);
+    nwGtpv2cOutstandingTxSeqNumTrxnMapRemove(pStack, thiz);
     rc = nwGtpv2cTrxnDelete(&thiz);
     return rc;
   }
@@ -107,7 +103,7 @@ static nw_rc_t nwGtpv2cTrxnPeerRspWaitTimeout(void* arg) {
     memcpy(
         (void*) &keyTunnel.ipAddrRemote, (void*) &thiz->peer_ip,
         sizeof(thiz->peer_ip));
-    pLocalTunnel = RB_FIND(NwGtpv2cTunnelMap, &(pStack->tunnelMap), &keyTunnel);
+    pLocalTunnel = nwGtpv2cTunnelMapFind(pStack, &keyTunnel);
     if (pLocalTunnel) {
       rc = nwGtpv2cTrxnSendMsgRetransmission(thiz);
       NW_ASSERT(NW_OK == rc);
@@ -120,9 +116,7 @@ static nw_rc_t nwGtpv2cTrxnPeerRspWaitTimeout(void* arg) {
           "Tunnel for local-TEID 0x%x is removed for request transaction %p "
           "(seqNo=0x%x)! Removing the trx and ignoring timeout. \n",
           thiz->teidLocal, thiz, thiz->seqNum);
-      RB_REMOVE(
-          NwGtpv2cOutstandingTxSeqNumTrxnMap, &(pStack->outstandingTxSeqNumMap),
-          thiz);
+      nwGtpv2cOutstandingTxSeqNumTrxnMapRemove(pStack, thiz);
       rc = nwGtpv2cTrxnDelete(&thiz);
     }
   } else {
@@ -143,9 +137,7 @@ static nw_rc_t nwGtpv2cTrxnPeerRspWaitTimeout(void* arg) {
     /** Set the flags. */
     ulpApi.u_api_info.rspFailureInfo.trx_flags = thiz->trx_flags;
     OAILOG_ERROR(LOG_GTPV2C, "N3 retries expired for transaction %p\n", thiz);
-    RB_REMOVE(
-        NwGtpv2cOutstandingTxSeqNumTrxnMap, &(pStack->outstandingTxSeqNumMap),
-        thiz);
+    nwGtpv2cOutstandingTxSeqNumTrxnMapRemove(pStack, thiz);
     rc = nwGtpv2cTrxnDelete(&thiz);
     rc = pStack->ulp.ulpReqCallback(pStack->ulp.hUlp, &ulpApi);
   }
@@ -168,9 +160,7 @@ static nw_rc_t nwGtpv2cTrxnDuplicateRequestWaitTimeout(void* arg) {
       "%d\n",
       thiz, thiz->seqNum);
   thiz->hRspTmr = 0;
-  RB_REMOVE(
-      NwGtpv2cOutstandingRxSeqNumTrxnMap, &(pStack->outstandingRxSeqNumMap),
-      thiz);
+  nwGtpv2cOutstandingRxSeqNumTrxnMapRemove(pStack, thiz);
   rc = nwGtpv2cTrxnDelete(&thiz);
   NW_ASSERT(NW_OK == rc);
   return rc;
@@ -240,19 +230,12 @@ static nw_rc_t nwGtpv2cTrxnStopPeerRspTimer(nw_gtpv2c_trxn_t* thiz) {
 nw_gtpv2c_trxn_t* nwGtpv2cTrxnNew(NW_IN nw_gtpv2c_stack_t* thiz) {
   nw_gtpv2c_trxn_t* pTrxn;
 
-  if (gpGtpv2cTrxnPool) {
-    pTrxn            = gpGtpv2cTrxnPool;
-    gpGtpv2cTrxnPool = gpGtpv2cTrxnPool->next;
-  } else {
-    NW_GTPV2C_MALLOC(thiz, sizeof(nw_gtpv2c_trxn_t), pTrxn, nw_gtpv2c_trxn_t*);
-  }
+  pTrxn = (nw_gtpv2c_trxn_t*) nwGtpv2cPoolAlloc(&thiz->trxnPool);
 
   if (pTrxn) {
     OAILOG_DEBUG(
-        LOG_GTPV2C,
-        "Created not trx without seqNum as transaction %p. Head %p, Next %p\n",
-        pTrxn, gpGtpv2cTrxnPool,
-        (gpGtpv2cTrxnPool) ? gpGtpv2cTrxnPool->next : NULL);
+        LOG_GTPV2C, "Created not trx without seqNum as transaction %p\n",
+        pTrxn);
 
     pTrxn->pStack     = thiz;
     pTrxn->pMsg       = NULL;
@@ -281,19 +264,11 @@ nw_gtpv2c_trxn_t* nwGtpv2cTrxnWithSeqNumNew(
     NW_IN nw_gtpv2c_stack_t* thiz, NW_IN uint32_t seqNum) {
   nw_gtpv2c_trxn_t* pTrxn;
 
-  if (gpGtpv2cTrxnPool) {
-    pTrxn            = gpGtpv2cTrxnPool;
-    gpGtpv2cTrxnPool = gpGtpv2cTrxnPool->next;
-  } else {
-    NW_GTPV2C_MALLOC(thiz, sizeof(nw_gtpv2c_trxn_t), pTrxn, nw_gtpv2c_trxn_t*);
-  }
+  pTrxn = (nw_gtpv2c_trxn_t*) nwGtpv2cPoolAlloc(&thiz->trxnPool);
 
   if (pTrxn) {
     OAILOG_DEBUG(
-        LOG_GTPV2C,
-        "Created new trx with seqNum %p as transaction %u. Head %p, Next %p\n",
-        pTrxn, seqNum, gpGtpv2cTrxnPool,
-        (gpGtpv2cTrxnPool) ? gpGtpv2cTrxnPool->next : NULL);
+        LOG_GTPV2C, "Created new trx %p with seqNum %u\n", pTrxn, seqNum);
 
     pTrxn->pStack     = thiz;
     pTrxn->pMsg       = NULL;
@@ -328,17 +303,10 @@ nw_gtpv2c_trxn_t* nwGtpv2cTrxnOutstandingRxNew(
 
   // todo: ipv6 for retransmission1
 
-  if (gpGtpv2cTrxnPool) {
-    pTrxn            = gpGtpv2cTrxnPool;
-    gpGtpv2cTrxnPool = gpGtpv2cTrxnPool->next;
-  } else {
-    NW_GTPV2C_MALLOC(thiz, sizeof(nw_gtpv2c_trxn_t), pTrxn, nw_gtpv2c_trxn_t*);
-  }
+  pTrxn = (nw_gtpv2c_trxn_t*) nwGtpv2cPoolAlloc(&thiz->trxnPool);
 
   if (pTrxn) {
-    OAILOG_DEBUG(
-        LOG_GTPV2C, "Received new Rx transaction %p, Head %p, Next %p\n", pTrxn,
-        gpGtpv2cTrxnPool, (gpGtpv2cTrxnPool) ? gpGtpv2cTrxnPool->next : NULL);
+    OAILOG_DEBUG(LOG_GTPV2C, "Received new Rx transaction %p\n", pTrxn);
 
     pTrxn->pStack     = thiz;
     pTrxn->maxRetries = 2;
@@ -352,9 +320,7 @@ nw_gtpv2c_trxn_t* nwGtpv2cTrxnOutstandingRxNew(
     pTrxn->pMsg     = NULL;
     pTrxn->hRspTmr  = 0;
     pTrxn->pt_trx   = false;
-    pCollision      = RB_INSERT(
-        NwGtpv2cOutstandingRxSeqNumTrxnMap, &(thiz->outstandingRxSeqNumMap),
-        pTrxn);
+    pCollision      = nwGtpv2cOutstandingRxSeqNumTrxnMapInsert(thiz, pTrxn);
 
     if (pCollision) {
       OAILOG_WARNING(
@@ -423,17 +389,10 @@ nw_rc_t nwGtpv2cTrxnDelete(NW_INOUT nw_gtpv2c_trxn_t** pthiz) {
   }
 
   OAILOG_DEBUG(
-      LOG_GTPV2C,
-      "Purging  transaction %p with seqNum %d. (before) Head %p, Next %p. \n",
-      thiz, thiz->seqNum, gpGtpv2cTrxnPool,
-      (gpGtpv2cTrxnPool) ? gpGtpv2cTrxnPool->next : 0);
-  thiz->next       = gpGtpv2cTrxnPool;
-  gpGtpv2cTrxnPool = thiz;
-  *pthiz           = NULL;
-
-  OAILOG_DEBUG(
-      LOG_GTPV2C, "After purging  transaction %p, Head %p, Next %p\n", thiz,
-      gpGtpv2cTrxnPool, (gpGtpv2cTrxnPool) ? gpGtpv2cTrxnPool->next : NULL);
+      LOG_GTPV2C, "Purging  transaction %p with seqNum %d.\n", thiz,
+      thiz->seqNum);
+  nwGtpv2cPoolFree(&pStack->trxnPool, thiz);
+  *pthiz = NULL;
 
   return rc;
 }
@@ -209,6 +209,11 @@ hashtable_rc_t hashtable_ts_get(
     __attribute__((hot));
 hashtable_rc_t hashtable_ts_resize(
     hash_table_ts_t* const hashtbl, const hash_size_t size);
+/*
+ * Multiplicative (Fibonacci) hash for keys packing several fields, where
+ * the default identity hash modulo the table size only sees the low bits
+ */
+hash_size_t hashtable_uint64_mix_hashfunc(const hash_key_t key);
 hash_table_uint64_ts_t* hashtable_uint64_ts_init(
     hash_table_uint64_ts_t* const hashtbl, const hash_size_t size,
     hash_size_t (*hashfunc)(const hash_key_t), bstring display_name_p);
@@ -67,6 +67,12 @@ static inline hash_size_t def_hashfunc(const uint64_t keyP) {
   return (hash_size_t) keyP;
 }
 
+//------------------------------------------------------------------------------
+hash_size_t hashtable_uint64_mix_hashfunc(const hash_key_t keyP) {
+  // 2^64 / golden ratio, the high half of the product mixes all the key bits
+  return (hash_size_t)((keyP * 0x9e3779b97f4a7c15ULL) >> 32);
+}
+
 //------------------------------------------------------------------------------
 /*
    Initialization
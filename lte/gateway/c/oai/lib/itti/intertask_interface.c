@@ -115,6 +115,19 @@ typedef struct itti_desc_s {
 
 static itti_desc_t itti_desc;
 
+/* Messages received after this long with no other message get a fresh
+   average, an idle queue has no latency */
+#define ITTI_QUEUE_LATENCY_MAX_AGE_USEC 1000000
+
+/* Smoothed time messages spend queued for each task, in usec. Written by the
+   task itself, read by any other one */
+typedef struct itti_queue_latency_s {
+  int64_t latency_usec;
+  int64_t updated_usec;
+} itti_queue_latency_t;
+
+static itti_queue_latency_t itti_queue_latency[TASK_MAX];
+
 int send_msg_to_task(
     task_zmq_ctx_t* task_zmq_ctx_p, task_id_t destination_task_id,
     MessageDef* message) {
@@ -124,6 +137,7 @@ int send_msg_to_task(
       itti_get_message_name(message->ittiMsgHeader.messageId),
       itti_get_task_name(destination_task_id));
 
+  message->ittiMsgHeader.timestamp = zclock_usecs();
   // TODO: can we use zframe_frommem to avoid memcopy
   zframe_t* frame = zframe_new(
       message, sizeof(MessageHeader) + message->ittiMsgHeader.ittiMsgSize);
@@ -138,6 +152,7 @@ int send_msg_to_task(
 }
 
 void send_broadcast_msg(task_zmq_ctx_t* task_zmq_ctx_p, MessageDef* message) {
+  message->ittiMsgHeader.timestamp = zclock_usecs();
   zframe_t* frame = zframe_new(
       message, sizeof(MessageHeader) + message->ittiMsgHeader.ittiMsgSize);
   assert(frame);
@@ -270,6 +285,7 @@ static MessageDef* itti_alloc_new_message_sized(
   new_msg->ittiMsgHeader.originTaskId = origin_task_id;
   new_msg->ittiMsgHeader.ittiMsgSize  = size;
   new_msg->ittiMsgHeader.imsi         = 0;
+  new_msg->ittiMsgHeader.timestamp    = 0;
 
   return new_msg;
 }
@@ -390,6 +406,38 @@ imsi64_t itti_get_associated_imsi(MessageDef* msg) {
   return msg != NULL ? msg->ittiMsgHeader.imsi : 0;
 }
 
+void itti_update_queue_latency(task_id_t task_id, const MessageDef* message) {
+  itti_queue_latency_t* queue = &itti_queue_latency[task_id];
+  int64_t now_usec            = zclock_usecs();
+  int64_t latency_usec        = 0;
+  int64_t updated_usec        = 0;
+
+  if (message->ittiMsgHeader.timestamp == 0) {
+    return;
+  }
+  latency_usec = __atomic_load_n(&queue->latency_usec, __ATOMIC_RELAXED);
+  updated_usec = __atomic_load_n(&queue->updated_usec, __ATOMIC_RELAXED);
+  if (now_usec - updated_usec > ITTI_QUEUE_LATENCY_MAX_AGE_USEC) {
+    latency_usec = 0;
+  }
+  // EWMA with a weight of 1/8 for the new sample
+  latency_usec +=
+      (now_usec - message->ittiMsgHeader.timestamp - latency_usec) / 8;
+  __atomic_store_n(&queue->latency_usec, latency_usec, __ATOMIC_RELAXED);
+  __atomic_store_n(&queue->updated_usec, now_usec, __ATOMIC_RELAXED);
+}
+
+int64_t itti_get_queue_latency(task_id_t task_id) {
+  itti_queue_latency_t* queue = &itti_queue_latency[task_id];
+  int64_t updated_usec =
+      __atomic_load_n(&queue->updated_usec, __ATOMIC_RELAXED);
+
+  if (zclock_usecs() - updated_usec > ITTI_QUEUE_LATENCY_MAX_AGE_USEC) {
+    return 0;
+  }
+  return __atomic_load_n(&queue->latency_usec, __ATOMIC_RELAXED);
+}
+
 void itti_wait_tasks_end(task_zmq_ctx_t* task_ctx) {
   int end = 0;
   int thread_id;
@@ -184,6 +184,20 @@ MessageDef* itti_alloc_new_message(
  */
 imsi64_t itti_get_associated_imsi(MessageDef* msg);
 
+/** \brief Account the time a received message spent in the queue of a task,
+ * to be called by the task when it handles the message
+ \param task_id Receiving task ID
+ \param message Received message
+ **/
+void itti_update_queue_latency(task_id_t task_id, const MessageDef* message);
+
+/** \brief Smoothed time messages spend in the queue of a task, 0 when the
+ * task did not receive any message recently
+ \param task_id Task ID
+ @returns Latency in microseconds
+ **/
+int64_t itti_get_queue_latency(task_id_t task_id);
+
 /** \brief handle signals and wait for all threads to join when the process
  *complete. This function should be called from the main thread after having
  *created all ITTI tasks.
@@ -128,6 +128,7 @@ typedef struct MessageHeader_s {
   task_id_t destinationTaskId; /**< ID of the destination task */
   instance_t instance;         /**< Task instance for virtualization */
   imsi64_t imsi;               /** IMSI associated to sender task */
+  int64_t timestamp;           /**< Time the message was sent, in usec */
 
   MessageHeaderSize
       ittiMsgSize; /**< Message size (not including header size) */
@@ -18,8 +18,11 @@
 #include "MobilityClientAPI.h"
 
 #include <grpcpp/security/credentials.h>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
+#include <memory>
+#include <mutex>
 #include <string>
 
 #include "conversions.h"
@@ -27,10 +30,12 @@
 #include "pcef_handlers.h"
 #include "service303.h"
 #include "spgw_types.h"
+#include "spgw_ue_ip_index.h"
 #include "intertask_interface.h"
 #include "common_types.h"
 
 #include "MobilityServiceClient.h"
+#include "UeIpLeasePool.h"
 
 using grpc::Channel;
 using grpc::ChannelCredentials;
@@ -40,6 +45,8 @@ using grpc::Status;
 using magma::lte::AllocateIPAddressResponse;
 using magma::lte::IPAddress;
 using magma::lte::MobilityServiceClient;
+using magma::lte::SubscriberIPTable;
+using magma::lte::UeIpLeasePool;
 
 extern task_zmq_ctx_t spgw_app_task_zmq_ctx;
 
@@ -60,6 +67,147 @@ handle_allocate_ipv4v6_address_status(
     const char* pdn_type,
     itti_sgi_create_end_point_response_t sgi_create_endpoint_resp);
 
+// Set by ue_ip_lease_pool_init() when enabled, used from the SPGW task and
+// the gRPC response thread
+static std::unique_ptr<UeIpLeasePool> lease_pool;
+static std::mutex lease_pool_mutex;
+
+static void refill_lease_pool(const std::string& apn) {
+  std::vector<std::string> lease_ids;
+  {
+    std::lock_guard<std::mutex> lock(lease_pool_mutex);
+    lease_ids = lease_pool->leases_to_reserve(apn);
+  }
+  for (const auto& lease_id : lease_ids) {
+    increment_counter("ue_ip_lease_pool_rpc", 1, 1, "rpc", "allocate");
+    MobilityServiceClient::getInstance().AllocateIPv4AddressAsync(
+        lease_id, apn,
+        [apn, lease_id](
+            const Status& status, AllocateIPAddressResponse ip_msg) {
+          std::lock_guard<std::mutex> lock(lease_pool_mutex);
+          if (!status.ok() || ip_msg.ip_list_size() == 0) {
+            OAILOG_ERROR(
+                LOG_UTIL, "Failed to reserve UE IP lease %s for apn <%s>\n",
+                lease_id.c_str(), apn.c_str());
+            lease_pool->reserved(apn, nullptr);
+            return;
+          }
+          UeIpLeasePool::Lease lease;
+          lease.lease_id = lease_id;
+          memcpy(
+              &lease.addr, ip_msg.ip_list(0).address().c_str(),
+              sizeof(in_addr));
+          lease.vlan = ip_msg.vlan();
+          lease_pool->reserved(apn, &lease);
+          set_gauge(
+              "ue_ip_lease_pool_free", lease_pool->free_leases(apn), 1, "apn",
+              apn.c_str());
+        });
+  }
+}
+
+/*
+ * Answers the allocation from a free lease, on the calling thread
+ * @return false when the pool is disabled or the APN has no free lease
+ */
+static bool allocate_ipv4_from_lease_pool(
+    const char* subscriber_id, const char* apn,
+    const std::function<void(Status, AllocateIPAddressResponse)>& callback) {
+  UeIpLeasePool::Lease lease;
+  bool taken = false;
+  {
+    std::lock_guard<std::mutex> lock(lease_pool_mutex);
+    if (!lease_pool) {
+      return false;
+    }
+    taken = lease_pool->take(apn, subscriber_id, &lease);
+  }
+  increment_counter("ue_ip_lease_pool", 1, 1, "result", taken ? "hit" : "miss");
+  refill_lease_pool(apn);
+  if (!taken) {
+    return false;
+  }
+
+  AllocateIPAddressResponse ip_msg;
+  IPAddress* ip = ip_msg.add_ip_list();
+  ip->set_version(IPAddress::IPV4);
+  ip->set_address(&lease.addr, sizeof(struct in_addr));
+  ip_msg.set_vlan(lease.vlan);
+  callback(Status::OK, ip_msg);
+  return true;
+}
+
+/*
+ * Takes the address back in the pool when it is one of its leases, and
+ * releases in mobilityd the free leases above the pool high watermark
+ * @return false when the address is not a lease
+ */
+static bool release_ipv4_to_lease_pool(
+    const char* apn, const struct in_addr* addr) {
+  std::vector<UeIpLeasePool::Lease> leases;
+  {
+    std::lock_guard<std::mutex> lock(lease_pool_mutex);
+    if (!lease_pool || !lease_pool->give_back(apn, *addr)) {
+      return false;
+    }
+    leases = lease_pool->leases_to_release(apn);
+    set_gauge(
+        "ue_ip_lease_pool_free", lease_pool->free_leases(apn), 1, "apn", apn);
+  }
+  for (const auto& lease : leases) {
+    increment_counter("ue_ip_lease_pool_rpc", 1, 1, "rpc", "release");
+    MobilityServiceClient::getInstance().ReleaseIPv4Address(
+        lease.lease_id, apn, lease.addr);
+  }
+  return true;
+}
+
+void ue_ip_lease_pool_init(uint32_t pool_size) {
+  SubscriberIPTable table;
+  uint32_t adopted = 0;
+
+  if (!pool_size) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(lease_pool_mutex);
+  lease_pool.reset(new UeIpLeasePool(pool_size));
+
+  // Leases of the previous run are still allocated in mobilityd
+  if (MobilityServiceClient::getInstance().GetSubscriberIPTable(&table)) {
+    // Lease IDs of the previous run would be allocated again
+    OAILOG_ERROR(
+        LOG_UTIL,
+        "Failed to read the leases of a previous run from mobilityd, UE IP "
+        "lease pool disabled\n");
+    lease_pool.reset();
+    return;
+  }
+  for (const auto& entry : table.entries()) {
+    if (!UeIpLeasePool::is_lease_id(entry.sid().id()) ||
+        entry.ip().version() != IPAddress::IPV4) {
+      continue;
+    }
+    UeIpLeasePool::Lease lease;
+    imsi64_t imsi64 = INVALID_IMSI64;
+    lease.lease_id  = entry.sid().id();
+    memcpy(&lease.addr, entry.ip().address().c_str(), sizeof(in_addr));
+    bool in_use =
+        spgw_get_imsi_from_ue_ipv4(&lease.addr, &imsi64) == RETURNok;
+    if (in_use) {
+      char imsi[IMSI_BCD_DIGITS_MAX + 1] = {0};
+      IMSI64_TO_STRING(imsi64, imsi, IMSI_BCD_DIGITS_MAX);
+      lease.subscriber_id = imsi;
+    }
+    lease_pool->adopt(entry.apn(), lease, in_use);
+    adopted++;
+  }
+  OAILOG_INFO(
+      LOG_UTIL,
+      "UE IP lease pool of %u addresses per APN, %u leases taken over, %u of "
+      "them in use\n",
+      pool_size, adopted, lease_pool->leased());
+}
+
 int get_assigned_ipv4_block(
     int index, struct in_addr* netaddr, uint32_t* netmask) {
   int status = MobilityServiceClient::getInstance().GetAssignedIPv4Block(
@@ -73,45 +221,55 @@ int pgw_handle_allocate_ipv4_address(
     const char* pdn_type, spgw_state_t* spgw_state,
     s_plus_p_gw_eps_bearer_context_information_t* new_bearer_ctxt_info_p,
     s5_create_session_response_t s5_response) {
-  MobilityServiceClient::getInstance().AllocateIPv4AddressAsync(
-      subscriber_id, apn,
-      [=, &s5_response](
-          const Status& status, AllocateIPAddressResponse ip_msg) {
-        std::string ipv4_addr_str;
-        if (ip_msg.ip_list_size() > 0) {
-          ipv4_addr_str = ip_msg.ip_list(0).address();
-        }
-        memcpy(addr, ipv4_addr_str.c_str(), sizeof(in_addr));
-        int vlan      = atoi(ip_msg.vlan().c_str());
-        auto sgi_resp = handle_allocate_ipv4_address_status(
-            status, *addr, vlan, subscriber_id, apn, pdn_type,
-            sgi_create_endpoint_resp);
+  auto start          = std::chrono::steady_clock::now();
+  auto handle_address = [=, &s5_response](
+                            const Status& status,
+                            AllocateIPAddressResponse ip_msg) {
+    observe_histogram(
+        "ue_ip_allocation_latency_ms",
+        std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start)
+            .count(),
+        NO_LABELS, 6, 0.1, 1., 5., 10., 50., 100.);
+    std::string ipv4_addr_str;
+    if (ip_msg.ip_list_size() > 0) {
+      ipv4_addr_str = ip_msg.ip_list(0).address();
+    }
+    memcpy(addr, ipv4_addr_str.c_str(), sizeof(in_addr));
+    int vlan      = atoi(ip_msg.vlan().c_str());
+    auto sgi_resp = handle_allocate_ipv4_address_status(
+        status, *addr, vlan, subscriber_id, apn, pdn_type,
+        sgi_create_endpoint_resp);
 
-        if (sgi_resp.status == SGI_STATUS_OK) {
-          // create session in PCEF and return
-          s5_create_session_request_t session_req = {0};
-          session_req.context_teid  = sgi_create_endpoint_resp.context_teid;
-          session_req.eps_bearer_id = sgi_create_endpoint_resp.eps_bearer_id;
-          char ip_str[INET_ADDRSTRLEN];
-          inet_ntop(AF_INET, &(addr->s_addr), ip_str, INET_ADDRSTRLEN);
-          struct pcef_create_session_data session_data;
-          get_session_req_data(
-              spgw_state,
-              &new_bearer_ctxt_info_p->sgw_eps_bearer_context_information
-                   .saved_message,
-              &session_data);
-          pcef_create_session(
-              spgw_state, subscriber_id, ip_str, NULL, &session_data, sgi_resp,
-              session_req, new_bearer_ctxt_info_p);
-          OAILOG_FUNC_OUT(LOG_PGW_APP);
-        }
+    if (sgi_resp.status == SGI_STATUS_OK) {
+      // create session in PCEF and return
+      s5_create_session_request_t session_req = {0};
+      session_req.context_teid  = sgi_create_endpoint_resp.context_teid;
+      session_req.eps_bearer_id = sgi_create_endpoint_resp.eps_bearer_id;
+      char ip_str[INET_ADDRSTRLEN];
+      inet_ntop(AF_INET, &(addr->s_addr), ip_str, INET_ADDRSTRLEN);
+      struct pcef_create_session_data session_data;
+      get_session_req_data(
+          spgw_state,
+          &new_bearer_ctxt_info_p->sgw_eps_bearer_context_information
+               .saved_message,
+          &session_data);
+      pcef_create_session(
+          spgw_state, subscriber_id, ip_str, NULL, &session_data, sgi_resp,
+          session_req, new_bearer_ctxt_info_p);
+      OAILOG_FUNC_OUT(LOG_PGW_APP);
+    }
 
-        s5_response.eps_bearer_id = sgi_create_endpoint_resp.eps_bearer_id;
-        s5_response.context_teid  = sgi_create_endpoint_resp.context_teid;
-        handle_s5_create_session_response(
-            spgw_state, new_bearer_ctxt_info_p, s5_response);
-        OAILOG_FUNC_OUT(LOG_PGW_APP);
-      });
+    s5_response.eps_bearer_id = sgi_create_endpoint_resp.eps_bearer_id;
+    s5_response.context_teid  = sgi_create_endpoint_resp.context_teid;
+    handle_s5_create_session_response(
+        spgw_state, new_bearer_ctxt_info_p, s5_response);
+    OAILOG_FUNC_OUT(LOG_PGW_APP);
+  };
+  if (!allocate_ipv4_from_lease_pool(subscriber_id, apn, handle_address)) {
+    MobilityServiceClient::getInstance().AllocateIPv4AddressAsync(
+        subscriber_id, apn, handle_address);
+  }
   return 0;
 }
 
@@ -158,6 +316,9 @@ static itti_sgi_create_end_point_response_t handle_allocate_ipv4_address_status(
 
 int release_ipv4_address(
     const char* subscriber_id, const char* apn, const struct in_addr* addr) {
+  if (release_ipv4_to_lease_pool(apn, addr)) {
+    return 0;
+  }
   int status = MobilityServiceClient::getInstance().ReleaseIPv4Address(
       subscriber_id, apn, *addr);
   return status;
@@ -173,8 +334,20 @@ int get_ipv4_address_for_subscriber(
 int get_subscriber_id_from_ipv4(
     const struct in_addr* addr, char** subscriber_id) {
   std::string subscriber_id_str;
+  {
+    // mobilityd only knows the lease ID of the pooled addresses
+    std::lock_guard<std::mutex> lock(lease_pool_mutex);
+    if (lease_pool && lease_pool->find_subscriber(*addr, &subscriber_id_str)) {
+      *subscriber_id = strdup(subscriber_id_str.c_str());
+      return 0;
+    }
+  }
   int status = MobilityServiceClient::getInstance().GetSubscriberIDFromIPv4(
       *addr, &subscriber_id_str);
+  if (!status && UeIpLeasePool::is_lease_id(subscriber_id_str)) {
+    // A free lease, or one of a previous run: no UE holds it
+    return grpc::StatusCode::NOT_FOUND;
+  }
   if (!subscriber_id_str.empty()) {
     *subscriber_id = strdup(subscriber_id_str.c_str());
   }
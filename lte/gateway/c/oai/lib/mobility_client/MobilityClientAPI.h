@@ -47,6 +47,22 @@ extern "C" {
 #define RPC_STATUS_UNAVAILABLE 14
 #define RPC_STATUS_DATA_LOSS 15
 
+/*
+ * Start the in-process pool of UE IPv4 addresses reserved from mobilityd.
+ * IPv4 PDNs then get their address from the pool, refilled in the background,
+ * and give it back to the pool on release.
+ *
+ * The reserved addresses are allocated to lease subscriber IDs in mobilityd:
+ * per subscriber static IPs and APN VLANs from subscriberdb are not applied
+ * to them.
+ *
+ * Called once the SPGW state is restored from the data store: the leases of a
+ * previous run that its sessions hold stay in use.
+ *
+ * @param pool_size: free addresses kept per APN, 0 to keep the pool disabled
+ */
+void ue_ip_lease_pool_init(uint32_t pool_size);
+
 /*
  * Get the address and netmask of an assigned IPv4 block
  *
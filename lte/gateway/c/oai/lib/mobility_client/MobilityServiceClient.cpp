@@ -247,6 +247,18 @@ int MobilityServiceClient::GetSubscriberIDFromIPv4(
   return 0;
 }
 
+int MobilityServiceClient::GetSubscriberIPTable(SubscriberIPTable* table) {
+  ClientContext context;
+  Void request;
+  Status status = stub_->GetSubscriberIPTable(&context, request, table);
+  if (!status.ok()) {
+    std::cout << "GetSubscriberIPTable fails with code " << status.error_code()
+              << ", msg: " << status.error_message() << std::endl;
+    return status.error_code();
+  }
+  return 0;
+}
+
 void MobilityServiceClient::AllocateIPAddressRPC(
     const AllocateIPRequest& request,
     const std::function<void(Status, AllocateIPAddressResponse)>& callback) {
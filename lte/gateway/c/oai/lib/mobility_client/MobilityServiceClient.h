@@ -163,6 +163,13 @@ class MobilityServiceClient : public GRPCReceiver {
    */
   int GetSubscriberIDFromIPv4(const struct in_addr& addr, std::string* imsi);
 
+  /*
+   * Get the subscriber to IP table of mobilityd
+   * @param table (out): all the allocated IPs with their subscriber and APN
+   * @return 0 on success, the gRPC error code otherwise
+   */
+  int GetSubscriberIPTable(SubscriberIPTable* table);
+
  public:
   static MobilityServiceClient& getInstance();
 
@@ -0,0 +1,133 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#include "UeIpLeasePool.h"
+
+#include <cstdlib>
+#include <cstring>
+
+namespace magma {
+namespace lte {
+
+UeIpLeasePool::UeIpLeasePool(uint32_t size) : size_(size), next_lease_seq_(0) {}
+
+bool UeIpLeasePool::take(
+    const std::string& apn, const std::string& subscriber_id, Lease* lease) {
+  auto it = apns_.find(apn);
+  if (it == apns_.end() || it->second.free.empty()) {
+    return false;
+  }
+  *lease = it->second.free.front();
+  it->second.free.pop_front();
+  lease->subscriber_id        = subscriber_id;
+  leased_[lease->addr.s_addr] = *lease;
+  return true;
+}
+
+bool UeIpLeasePool::give_back(
+    const std::string& apn, const struct in_addr& addr) {
+  auto it = leased_.find(addr.s_addr);
+  if (it == leased_.end()) {
+    return false;
+  }
+  // Back of the queue: the address of a UE that just left is used last
+  it->second.subscriber_id.clear();
+  apns_[apn].free.push_back(it->second);
+  leased_.erase(it);
+  return true;
+}
+
+bool UeIpLeasePool::find_subscriber(
+    const struct in_addr& addr, std::string* subscriber_id) const {
+  auto it = leased_.find(addr.s_addr);
+  if (it == leased_.end()) {
+    return false;
+  }
+  *subscriber_id = it->second.subscriber_id;
+  return true;
+}
+
+std::vector<std::string> UeIpLeasePool::leases_to_reserve(
+    const std::string& apn) {
+  std::vector<std::string> lease_ids;
+  ApnPool& pool      = apns_[apn];
+  uint32_t available = pool.free.size() + pool.pending;
+
+  if (!enabled() || available > size_ / 2) {
+    return lease_ids;
+  }
+  for (; available < size_; available++) {
+    lease_ids.push_back(LEASE_ID_PREFIX + std::to_string(next_lease_seq_++));
+    pool.pending++;
+  }
+  return lease_ids;
+}
+
+void UeIpLeasePool::reserved(const std::string& apn, const Lease* lease) {
+  ApnPool& pool = apns_[apn];
+
+  if (pool.pending) {
+    pool.pending--;
+  }
+  if (lease) {
+    pool.free.push_back(*lease);
+  }
+}
+
+std::vector<UeIpLeasePool::Lease> UeIpLeasePool::leases_to_release(
+    const std::string& apn) {
+  std::vector<Lease> leases;
+  auto it = apns_.find(apn);
+
+  if (it == apns_.end() || it->second.free.size() <= 2 * size_) {
+    return leases;
+  }
+  while (it->second.free.size() > size_) {
+    leases.push_back(it->second.free.back());
+    it->second.free.pop_back();
+  }
+  return leases;
+}
+
+void UeIpLeasePool::adopt(
+    const std::string& apn, const Lease& lease, bool in_use) {
+  uint64_t seq = strtoull(
+      lease.lease_id.c_str() + strlen(LEASE_ID_PREFIX), nullptr, 10);
+
+  if (seq >= next_lease_seq_) {
+    next_lease_seq_ = seq + 1;
+  }
+  if (in_use) {
+    leased_[lease.addr.s_addr] = lease;
+  } else {
+    apns_[apn].free.push_back(lease);
+    apns_[apn].free.back().subscriber_id.clear();
+  }
+}
+
+bool UeIpLeasePool::is_lease_id(const std::string& subscriber_id) {
+  return subscriber_id.compare(
+             0, strlen(LEASE_ID_PREFIX), LEASE_ID_PREFIX) == 0;
+}
+
+uint32_t UeIpLeasePool::free_leases(const std::string& apn) const {
+  auto it = apns_.find(apn);
+  return it == apns_.end() ? 0 : it->second.free.size();
+}
+
+}  // namespace lte
+}  // namespace magma
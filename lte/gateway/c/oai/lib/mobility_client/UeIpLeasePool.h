@@ -0,0 +1,127 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#pragma once
+
+#include <netinet/in.h>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace magma {
+namespace lte {
+
+/*
+ * UE IPv4 addresses reserved from mobilityd ahead of the attaches, per APN.
+ * Each address is allocated in mobilityd to a lease subscriber ID of its own,
+ * then handed to UEs and taken back in-process, so that an attach does not
+ * wait for an AllocateIPAddress round trip.
+ *
+ * mobilityd keeps mapping a leased address to its lease ID, so the UE a
+ * lease is handed to is only known here: look it up with find_subscriber()
+ * before asking mobilityd.
+ *
+ * The pool only decides: the caller makes the RPCs it asks for and locks
+ * around it.
+ */
+class UeIpLeasePool {
+ public:
+  // Subscriber ID prefix of the addresses the pool holds in mobilityd
+  static constexpr const char* LEASE_ID_PREFIX = "LEASE";
+
+  struct Lease {
+    std::string lease_id;
+    struct in_addr addr;  // network byte order
+    std::string vlan;
+    // Subscriber the lease is handed to, empty while it is free
+    std::string subscriber_id;
+  };
+
+  /**
+   * @param size: free leases kept per APN. The pool reserves up to size
+   * leases when half of them are gone, and releases the leases given back
+   * above twice size. 0 disables the pool
+   */
+  explicit UeIpLeasePool(uint32_t size);
+
+  bool enabled() const { return size_ > 0; }
+
+  /**
+   * Takes a free lease of the APN for a UE
+   * @return false when the APN has no free lease
+   */
+  bool take(
+      const std::string& apn, const std::string& subscriber_id, Lease* lease);
+
+  /**
+   * Gives back the address of a UE
+   * @return false when the address is not a lease of the pool
+   */
+  bool give_back(const std::string& apn, const struct in_addr& addr);
+
+  /**
+   * Leases to reserve from mobilityd for the APN, each with its lease ID.
+   * They are accounted as pending until reserved() is called for them
+   */
+  std::vector<std::string> leases_to_reserve(const std::string& apn);
+
+  /**
+   * Answer of a reservation, lease is nullptr when it failed
+   */
+  void reserved(const std::string& apn, const Lease* lease);
+
+  /**
+   * Free leases above twice the pool size, to release in mobilityd. They are
+   * removed from the pool
+   */
+  std::vector<Lease> leases_to_release(const std::string& apn);
+
+  /**
+   * Subscriber a lease is handed to
+   * @return false when the address is not leased to a UE
+   */
+  bool find_subscriber(
+      const struct in_addr& addr, std::string* subscriber_id) const;
+
+  /**
+   * Takes over a lease found in mobilityd after a restart
+   * @param in_use: a restored session of lease.subscriber_id holds the address
+   */
+  void adopt(const std::string& apn, const Lease& lease, bool in_use);
+
+  static bool is_lease_id(const std::string& subscriber_id);
+
+  uint32_t free_leases(const std::string& apn) const;
+
+  uint32_t leased() const { return leased_.size(); }
+
+ private:
+  struct ApnPool {
+    std::deque<Lease> free;
+    uint32_t pending = 0;
+  };
+
+  const uint32_t size_;
+  uint64_t next_lease_seq_;
+  std::unordered_map<std::string, ApnPool> apns_;
+  // Leases handed to UEs, by address
+  std::unordered_map<uint32_t, Lease> leased_;
+};
+
+}  // namespace lte
+}  // namespace magma
@@ -0,0 +1,501 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#include "OvsdbClient.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <folly/json.h>
+
+extern "C" {
+#include "log.h"
+}
+
+using folly::dynamic;
+
+namespace openflow {
+
+namespace {
+
+const char* const DATABASE   = "Open_vSwitch";
+const char* const MONITOR_ID = "interfaces";
+// ofport of an interface OVS failed to add
+const int64_t OFPORT_ERROR = -1;
+const std::chrono::seconds RECONNECT_INTERVAL(1);
+
+// ofport column, an integer or an empty set until OVS assigns one
+int64_t parse_ofport(const dynamic* ofport) {
+  return ofport && ofport->isInt() ? ofport->asInt() : 0;
+}
+
+}  // namespace
+
+JsonRpcStream::JsonRpcStream() {
+  reset();
+}
+
+void JsonRpcStream::reset() {
+  buffer_.clear();
+  scanned_   = 0;
+  depth_     = 0;
+  in_string_ = false;
+  escaped_   = false;
+}
+
+void JsonRpcStream::feed(
+    const char* data, size_t len, std::vector<std::string>* messages) {
+  size_t start = 0;
+
+  buffer_.append(data, len);
+  for (; scanned_ < buffer_.size(); scanned_++) {
+    char c = buffer_[scanned_];
+    if (in_string_) {
+      if (escaped_) {
+        escaped_ = false;
+      } else if (c == '\\') {
+        escaped_ = true;
+      } else if (c == '"') {
+        in_string_ = false;
+      }
+    } else if (c == '"') {
+      in_string_ = true;
+    } else if (c == '{' || c == '[') {
+      depth_++;
+    } else if ((c == '}' || c == ']') && --depth_ == 0) {
+      messages->push_back(buffer_.substr(start, scanned_ + 1 - start));
+      start = scanned_ + 1;
+    } else if (depth_ < 0) {
+      // Not JSON, drop what was read so far
+      depth_ = 0;
+      start  = scanned_ + 1;
+    }
+  }
+  buffer_.erase(0, start);
+  scanned_ -= start;
+}
+
+OvsdbClient::OvsdbClient(const std::string& socket_path)
+    : socket_path_(socket_path),
+      running_(false),
+      fd_(-1),
+      monitored_(false),
+      next_id_(1),
+      monitor_request_id_(0) {}
+
+OvsdbClient::~OvsdbClient() {
+  stop();
+}
+
+bool OvsdbClient::start(std::chrono::milliseconds timeout) {
+  running_ = true;
+  thread_  = std::thread(&OvsdbClient::run, this);
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  return cv_.wait_for(lock, timeout, [this] { return monitored_; });
+}
+
+void OvsdbClient::stop() {
+  if (!running_) {
+    return;
+  }
+  running_ = false;
+  {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (fd_ >= 0) {
+      // Wakes the connection thread up from recv()
+      shutdown(fd_, SHUT_RDWR);
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cv_.notify_all();
+  }
+  thread_.join();
+  disconnect();
+}
+
+void OvsdbClient::run() {
+  JsonRpcStream stream;
+  std::vector<std::string> messages;
+  char buffer[4096];
+
+  while (running_) {
+    if (fd_ < 0) {
+      if (!connect_and_monitor()) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait_for(lock, RECONNECT_INTERVAL, [this] { return !running_; });
+        continue;
+      }
+      stream.reset();
+    }
+    ssize_t n = recv(fd_, buffer, sizeof(buffer), 0);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      if (running_) {
+        OAILOG_ERROR(LOG_GTPV1U, "Lost connection to OVSDB, reconnecting\n");
+      }
+      disconnect();
+      continue;
+    }
+    messages.clear();
+    stream.feed(buffer, n, &messages);
+    for (const auto& message : messages) {
+      handle_message(message);
+    }
+  }
+}
+
+bool OvsdbClient::connect_and_monitor() {
+  struct sockaddr_un addr = {0};
+  int fd                  = socket(AF_UNIX, SOCK_STREAM, 0);
+
+  if (fd < 0) {
+    return false;
+  }
+  addr.sun_family = AF_UNIX;
+  strncpy(addr.sun_path, socket_path_.c_str(), sizeof(addr.sun_path) - 1);
+  if (connect(fd, (struct sockaddr*) &addr, sizeof(addr)) < 0) {
+    OAILOG_DEBUG(
+        LOG_GTPV1U, "Could not connect to OVSDB at %s: %s\n",
+        socket_path_.c_str(), strerror(errno));
+    close(fd);
+    return false;
+  }
+  {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    fd_ = fd;
+  }
+
+  // The reply loads the cache, the updates keep it current
+  dynamic columns          = dynamic::array("name", "ofport");
+  dynamic monitor_requests = dynamic::object(
+      "Interface", dynamic::object("columns", columns));
+  dynamic request = dynamic::object("method", "monitor")(
+      "params", dynamic::array(DATABASE, MONITOR_ID, monitor_requests));
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    monitor_request_id_ = next_id_++;
+    request["id"]       = monitor_request_id_;
+  }
+  if (!send(request)) {
+    disconnect();
+    return false;
+  }
+  OAILOG_INFO(LOG_GTPV1U, "Connected to OVSDB at %s\n", socket_path_.c_str());
+  return true;
+}
+
+void OvsdbClient::disconnect() {
+  {
+    std::lock_guard<std::mutex> lock(write_mutex_);
+    if (fd_ >= 0) {
+      close(fd_);
+      fd_ = -1;
+    }
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  monitored_ = false;
+  cv_.notify_all();
+}
+
+bool OvsdbClient::send(const dynamic& message) {
+  std::string json = folly::toJson(message);
+  size_t sent      = 0;
+
+  std::lock_guard<std::mutex> lock(write_mutex_);
+  if (fd_ < 0) {
+    return false;
+  }
+  while (sent < json.size()) {
+    ssize_t n =
+        ::send(fd_, json.data() + sent, json.size() - sent, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    sent += n;
+  }
+  return true;
+}
+
+bool OvsdbClient::call(
+    const std::string& method, const dynamic& params,
+    std::chrono::milliseconds timeout, dynamic* result) {
+  int64_t id = 0;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!monitored_) {
+      return false;
+    }
+    id           = next_id_++;
+    replies_[id] = nullptr;
+  }
+  bool sent = send(
+      dynamic::object("method", method)("params", params)("id", id));
+
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (sent) {
+    cv_.wait_for(lock, timeout, [this, id] {
+      return !replies_[id].isNull() || !monitored_;
+    });
+  }
+  dynamic reply = std::move(replies_[id]);
+  replies_.erase(id);
+  lock.unlock();
+
+  if (reply.isNull()) {
+    OAILOG_ERROR(LOG_GTPV1U, "OVSDB %s got no reply\n", method.c_str());
+    return false;
+  }
+  const dynamic* error = reply.get_ptr("error");
+  if (error && !error->isNull()) {
+    OAILOG_ERROR(
+        LOG_GTPV1U, "OVSDB %s failed: %s\n", method.c_str(),
+        folly::toJson(*error).c_str());
+    return false;
+  }
+  const dynamic* reply_result = reply.get_ptr("result");
+  if (!reply_result) {
+    return false;
+  }
+  *result = *reply_result;
+  return true;
+}
+
+void OvsdbClient::handle_message(const std::string& json) {
+  dynamic message;
+  try {
+    message = folly::parseJson(json);
+  } catch (const std::exception& e) {
+    OAILOG_ERROR(LOG_GTPV1U, "Invalid OVSDB message: %s\n", e.what());
+    return;
+  }
+  if (!message.isObject()) {
+    return;
+  }
+
+  const dynamic* method = message.get_ptr("method");
+  if (method && method->isString()) {
+    const dynamic* params = message.get_ptr("params");
+    const dynamic* id     = message.get_ptr("id");
+    if (*method == "echo" && params && id) {
+      // Keepalive of the server
+      send(dynamic::object("result", *params)("error", nullptr)("id", *id));
+    } else if (
+        *method == "update" && params && params->isArray() &&
+        params->size() == 2 && (*params)[1].isObject()) {
+      const dynamic* interfaces = (*params)[1].get_ptr("Interface");
+      if (interfaces) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        update_interfaces(*interfaces);
+        cv_.notify_all();
+      }
+    }
+    return;
+  }
+
+  const dynamic* id = message.get_ptr("id");
+  if (!id || !id->isInt()) {
+    return;
+  }
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (id->asInt() == monitor_request_id_) {
+    const dynamic* result = message.get_ptr("result");
+    if (!result || !result->isObject()) {
+      OAILOG_ERROR(
+          LOG_GTPV1U, "OVSDB monitor failed: %s\n", json.c_str());
+      return;
+    }
+    ofports_.clear();
+    names_.clear();
+    const dynamic* interfaces = result->get_ptr("Interface");
+    if (interfaces) {
+      update_interfaces(*interfaces);
+    }
+    monitored_ = true;
+    cv_.notify_all();
+    OAILOG_INFO(
+        LOG_GTPV1U, "Monitoring %lu OVS interfaces\n", ofports_.size());
+    return;
+  }
+  auto it = replies_.find(id->asInt());
+  if (it != replies_.end()) {
+    it->second = std::move(message);
+    cv_.notify_all();
+  }
+}
+
+void OvsdbClient::update_interfaces(const dynamic& table_update) {
+  if (!table_update.isObject()) {
+    return;
+  }
+  for (const auto& row : table_update.items()) {
+    if (!row.first.isString() || !row.second.isObject()) {
+      continue;
+    }
+    const std::string& uuid = row.first.getString();
+    const dynamic* new_row  = row.second.get_ptr("new");
+    if (new_row && new_row->isObject()) {
+      const dynamic* name = new_row->get_ptr("name");
+      if (name && name->isString()) {
+        names_[uuid]                 = name->getString();
+        ofports_[name->getString()] = parse_ofport(new_row->get_ptr("ofport"));
+      }
+      continue;
+    }
+    // Deleted row
+    auto it = names_.find(uuid);
+    if (it != names_.end()) {
+      ofports_.erase(it->second);
+      names_.erase(it);
+    }
+  }
+}
+
+uint32_t OvsdbClient::get_ofport(const std::string& name) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = ofports_.find(name);
+  return it != ofports_.end() && it->second > 0 ? it->second : 0;
+}
+
+uint32_t OvsdbClient::wait_ofport(
+    const std::string& name, std::chrono::milliseconds timeout) {
+  std::unique_lock<std::mutex> lock(mutex_);
+  cv_.wait_for(lock, timeout, [this, &name] {
+    auto it = ofports_.find(name);
+    return it != ofports_.end() && it->second != 0;
+  });
+  auto it = ofports_.find(name);
+  if (it == ofports_.end() || it->second <= 0) {
+    if (it != ofports_.end() && it->second == OFPORT_ERROR) {
+      OAILOG_ERROR(
+          LOG_GTPV1U, "OVS failed to add interface %s\n", name.c_str());
+    }
+    return 0;
+  }
+  return it->second;
+}
+
+uint32_t OvsdbClient::add_tunnel_port(
+    const std::string& bridge, const std::string& name, const std::string& type,
+    const std::string& remote_ip, std::chrono::milliseconds timeout) {
+  uint32_t ofport = get_ofport(name);
+  if (ofport) {
+    return ofport;
+  }
+
+  dynamic options = dynamic::array(
+      "map", dynamic::array(
+                 dynamic::array("remote_ip", remote_ip),
+                 dynamic::array("key", "flow")));
+  dynamic ops = dynamic::array(
+      DATABASE,
+      // Fails right away when the interface exists, as --may-exist
+      dynamic::object("op", "wait")("table", "Interface")("timeout", 0)(
+          "where", dynamic::array(dynamic::array("name", "==", name)))(
+          "columns", dynamic::array("name"))("until", "==")(
+          "rows", dynamic::array()),
+      dynamic::object("op", "insert")("table", "Interface")(
+          "uuid-name", "iface")(
+          "row", dynamic::object("name", name)("type", type)(
+                     "options", options)),
+      dynamic::object("op", "insert")("table", "Port")("uuid-name", "port")(
+          "row", dynamic::object("name", name)(
+                     "interfaces", dynamic::array("named-uuid", "iface"))),
+      dynamic::object("op", "mutate")("table", "Bridge")(
+          "where", dynamic::array(dynamic::array("name", "==", bridge)))(
+          "mutations", dynamic::array(dynamic::array(
+                           "ports", "insert",
+                           dynamic::array("named-uuid", "port")))),
+      // Makes ovs-vswitchd reconfigure, as ovs-vsctl does
+      dynamic::object("op", "mutate")("table", "Open_vSwitch")(
+          "where", dynamic::array())(
+          "mutations",
+          dynamic::array(dynamic::array("next_cfg", "+=", 1))));
+  dynamic result;
+  if (!call("transact", ops, timeout, &result) || !result.isArray() ||
+      result.empty() || !result[0].isObject()) {
+    return 0;
+  }
+  // A failed wait means the interface exists, its port is on the way then
+  if (!result[0].get_ptr("error")) {
+    for (const auto& op_result : result) {
+      if (op_result.isObject() && op_result.get_ptr("error")) {
+        OAILOG_ERROR(
+            LOG_GTPV1U, "Could not add OVS port %s: %s\n", name.c_str(),
+            folly::toJson(op_result).c_str());
+        return 0;
+      }
+    }
+    const dynamic* count =
+        result.size() > 3 && result[3].isObject() ? result[3].get_ptr("count")
+                                                  : nullptr;
+    if (!count || *count == 0) {
+      OAILOG_ERROR(
+          LOG_GTPV1U, "Could not add OVS port %s: no bridge %s\n",
+          name.c_str(), bridge.c_str());
+      return 0;
+    }
+  }
+  return wait_ofport(name, timeout);
+}
+
+bool OvsdbClient::has_interface_type(
+    const std::string& type, std::chrono::milliseconds timeout) {
+  dynamic ops = dynamic::array(
+      DATABASE, dynamic::object("op", "select")("table", "Open_vSwitch")(
+                    "where", dynamic::array())(
+                    "columns", dynamic::array("iface_types")));
+  dynamic result;
+  if (!call("transact", ops, timeout, &result) || !result.isArray() ||
+      result.empty() || !result[0].isObject()) {
+    return false;
+  }
+  const dynamic* rows = result[0].get_ptr("rows");
+  if (!rows || !rows->isArray()) {
+    return false;
+  }
+  for (const auto& row : *rows) {
+    const dynamic* types =
+        row.isObject() ? row.get_ptr("iface_types") : nullptr;
+    if (!types) {
+      continue;
+    }
+    // A set of one type is the type itself, others are ["set", [types]]
+    if (*types == type) {
+      return true;
+    }
+    if (types->isArray() && types->size() == 2 && (*types)[1].isArray()) {
+      for (const auto& iface_type : (*types)[1]) {
+        if (iface_type == type) {
+          return true;
+        }
+      }
+    }
+  }
+  return false;
+}
+
+}  // namespace openflow
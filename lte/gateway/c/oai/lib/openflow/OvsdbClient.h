@@ -0,0 +1,153 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <folly/dynamic.h>
+
+namespace openflow {
+
+/**
+ * Splits the JSON-RPC stream of an OVSDB connection into its messages, which
+ * are JSON objects sent back to back with no delimiter (RFC 7047 section 4)
+ */
+class JsonRpcStream {
+ public:
+  JsonRpcStream();
+
+  /**
+   * Adds the bytes read from the connection, and appends the messages they
+   * complete
+   */
+  void feed(const char* data, size_t len, std::vector<std::string>* messages);
+
+  void reset();
+
+ private:
+  std::string buffer_;
+  size_t scanned_;
+  int depth_;
+  bool in_string_;
+  bool escaped_;
+};
+
+/**
+ * OVSDB JSON-RPC client on the local ovsdb-server unix socket. It monitors
+ * the name and ofport of the Interface table and keeps them in a cache
+ * updated by the server notifications, so that looking up the OpenFlow port
+ * of an interface does not go to OVSDB. It reconnects in the background
+ * when the connection drops, the cache being reloaded on the new monitor.
+ */
+class OvsdbClient {
+ public:
+  explicit OvsdbClient(const std::string& socket_path);
+
+  ~OvsdbClient();
+
+  /**
+   * Starts the connection thread
+   * @return false when the Interface table is not loaded within timeout, the
+   *         thread keeps trying to connect
+   */
+  bool start(std::chrono::milliseconds timeout);
+
+  void stop();
+
+  /**
+   * @return OpenFlow port of the interface, 0 when unknown
+   */
+  uint32_t get_ofport(const std::string& name);
+
+  /**
+   * Waits for OVS to assign an OpenFlow port to the interface
+   * @return the port, 0 on timeout or when OVS failed to add the interface
+   */
+  uint32_t wait_ofport(
+      const std::string& name, std::chrono::milliseconds timeout);
+
+  /**
+   * Adds a flow based tunnel port of one interface to the bridge, in one
+   * transaction, unless an interface of that name exists
+   * @return OpenFlow port of the interface, 0 on failure or timeout
+   */
+  uint32_t add_tunnel_port(
+      const std::string& bridge, const std::string& name,
+      const std::string& type, const std::string& remote_ip,
+      std::chrono::milliseconds timeout);
+
+  /**
+   * @return whether the switch supports the interface type
+   */
+  bool has_interface_type(
+      const std::string& type, std::chrono::milliseconds timeout);
+
+ private:
+  const std::string socket_path_;
+
+  std::thread thread_;
+  std::atomic<bool> running_;
+  // Written by the connection thread only, with write_mutex_ held
+  int fd_;
+  // Serializes the writes of the caller threads and the connection thread
+  std::mutex write_mutex_;
+
+  // Everything below is guarded by mutex_, cv_ signals the replies and the
+  // cache updates
+  std::mutex mutex_;
+  std::condition_variable cv_;
+  bool monitored_;
+  int64_t next_id_;
+  int64_t monitor_request_id_;
+  // Replies by request id, null until they arrive
+  std::unordered_map<int64_t, folly::dynamic> replies_;
+  // Interface ofports by name, names by row uuid
+  std::unordered_map<std::string, int64_t> ofports_;
+  std::unordered_map<std::string, std::string> names_;
+
+  void run();
+
+  bool connect_and_monitor();
+
+  void disconnect();
+
+  bool send(const folly::dynamic& message);
+
+  /**
+   * Sends the request and waits for its result
+   * @return false on timeout, disconnection or error reply
+   */
+  bool call(
+      const std::string& method, const folly::dynamic& params,
+      std::chrono::milliseconds timeout, folly::dynamic* result);
+
+  void handle_message(const std::string& json);
+
+  // With mutex_ held
+  void update_interfaces(const folly::dynamic& table_update);
+};
+
+}  // namespace openflow
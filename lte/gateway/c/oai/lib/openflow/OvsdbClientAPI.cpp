@@ -0,0 +1,62 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#include "OvsdbClientAPI.h"
+
+#include <chrono>
+#include <memory>
+
+#include "OvsdbClient.h"
+
+using openflow::OvsdbClient;
+
+namespace {
+
+const std::chrono::seconds OVSDB_CONNECT_TIMEOUT(5);
+const std::chrono::seconds OVSDB_TRANSACT_TIMEOUT(5);
+
+std::unique_ptr<OvsdbClient> ovsdb_client;
+
+}  // namespace
+
+int ovsdb_client_init(const char* socket_path) {
+  ovsdb_client.reset(new OvsdbClient(socket_path));
+  return ovsdb_client->start(OVSDB_CONNECT_TIMEOUT) ? 0 : -1;
+}
+
+void ovsdb_client_exit(void) {
+  ovsdb_client.reset();
+}
+
+uint32_t ovsdb_client_get_ofport(const char* name) {
+  return ovsdb_client ? ovsdb_client->get_ofport(name) : 0;
+}
+
+uint32_t ovsdb_client_add_tunnel_port(
+    const char* bridge, const char* name, const char* type,
+    const char* remote_ip) {
+  if (!ovsdb_client) {
+    return 0;
+  }
+  return ovsdb_client->add_tunnel_port(
+      bridge, name, type, remote_ip, OVSDB_TRANSACT_TIMEOUT);
+}
+
+bool ovsdb_client_has_interface_type(const char* type) {
+  return ovsdb_client &&
+         ovsdb_client->has_interface_type(type, OVSDB_TRANSACT_TIMEOUT);
+}
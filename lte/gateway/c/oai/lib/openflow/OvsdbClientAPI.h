@@ -0,0 +1,66 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#ifndef FILE_OVSDB_CLIENT_API_SEEN
+#define FILE_OVSDB_CLIENT_API_SEEN
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OVSDB_SOCKET_PATH "/var/run/openvswitch/db.sock"
+
+/*
+ * Connect to the local ovsdb-server and start caching the OpenFlow ports of
+ * the OVS interfaces. The client keeps connecting in the background when
+ * OVSDB is not reachable.
+ *
+ * @return 0 once the ports are cached, -1 when they could not be loaded yet
+ */
+int ovsdb_client_init(const char* socket_path);
+
+void ovsdb_client_exit(void);
+
+/*
+ * @return OpenFlow port of the interface from the cache, 0 when unknown
+ */
+uint32_t ovsdb_client_get_ofport(const char* name);
+
+/*
+ * Add a flow based tunnel port to the bridge unless it exists, as
+ * ovs-vsctl --may-exist add-port, and wait for its OpenFlow port
+ *
+ * @return OpenFlow port of the interface, 0 on failure
+ */
+uint32_t ovsdb_client_add_tunnel_port(
+    const char* bridge, const char* name, const char* type,
+    const char* remote_ip);
+
+/*
+ * @return whether the switch supports the interface type, false when OVSDB
+ * could not tell
+ */
+bool ovsdb_client_has_interface_type(const char* type);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* FILE_OVSDB_CLIENT_API_SEEN */
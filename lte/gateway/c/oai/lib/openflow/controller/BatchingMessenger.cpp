@@ -0,0 +1,208 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#include "BatchingMessenger.h"
+
+extern "C" {
+#include "log.h"
+#include "service303.h"
+}
+
+using namespace fluid_msg;
+
+namespace openflow {
+
+namespace {
+
+struct FlushRequest {
+  const BatchingMessenger* messenger;
+  fluid_base::OFConnection* ofconn;
+};
+
+}  // namespace
+
+BatchingMessenger::BatchingMessenger(uint32_t max_batch_size)
+    : max_batch_size_(max_batch_size), next_xid_(1) {}
+
+void BatchingMessenger::send_of_msg(
+    OFMsg& of_msg, fluid_base::OFConnection* ofconn) const {
+  bool schedule_flush = false;
+  {
+    std::lock_guard<std::mutex> lock(batches_mutex_);
+    auto it = pending_.find(ofconn);
+    if (it == pending_.end()) {
+      Batch batch = {ofconn, next_xid_++, 0, false};
+      // xid 0 is left out on wrap around
+      if (!next_xid_) {
+        next_xid_ = 1;
+      }
+      it             = pending_.emplace(ofconn, std::move(batch)).first;
+      schedule_flush = true;
+    }
+    Batch& batch = it->second;
+    of_msg.xid(batch.xid);
+    uint8_t* buffer = of_msg.pack();
+    batch.buffer.insert(
+        batch.buffer.end(), buffer, buffer + of_msg.length());
+    OFMsg::free_buffer(buffer);
+    batch.nb_msgs++;
+  }
+  if (schedule_flush) {
+    // Runs after the events already queued in the loop, which add their
+    // messages to the batch
+    ofconn->add_immediate_event(
+        flush_callback,
+        std::make_shared<FlushRequest>(FlushRequest{this, ofconn}));
+  }
+}
+
+void BatchingMessenger::on_batch_completion(
+    fluid_base::OFConnection* ofconn, std::function<void(bool)> cb) const {
+  {
+    std::lock_guard<std::mutex> lock(batches_mutex_);
+    auto it = pending_.find(ofconn);
+    if (it != pending_.end()) {
+      it->second.callbacks.push_back(std::move(cb));
+      if (it->second.nb_msgs >= max_batch_size_) {
+        write_batch(ofconn);
+      }
+      return;
+    }
+  }
+  cb(true);
+}
+
+void BatchingMessenger::flush(fluid_base::OFConnection* ofconn) const {
+  std::lock_guard<std::mutex> lock(batches_mutex_);
+  write_batch(ofconn);
+}
+
+void* BatchingMessenger::flush_callback(std::shared_ptr<void> data) {
+  auto request = std::static_pointer_cast<FlushRequest>(data);
+  request->messenger->flush(request->ofconn);
+  return nullptr;
+}
+
+void BatchingMessenger::write_batch(fluid_base::OFConnection* ofconn) const {
+  auto it = pending_.find(ofconn);
+  if (it == pending_.end()) {
+    return;
+  }
+  Batch batch = std::move(it->second);
+  pending_.erase(it);
+
+  of13::BarrierRequest barrier(batch.xid);
+  uint8_t* buffer = barrier.pack();
+  batch.buffer.insert(batch.buffer.end(), buffer, buffer + barrier.length());
+  OFMsg::free_buffer(buffer);
+  write(ofconn, batch.buffer.data(), batch.buffer.size());
+  observe_histogram(
+      "openflow_batch_size", batch.nb_msgs, NO_LABELS, 6, 1., 4., 16., 64.,
+      256., 1024.);
+
+  batch.buffer.clear();
+  batch.buffer.shrink_to_fit();
+  in_flight_.emplace(batch.xid, std::move(batch));
+}
+
+void BatchingMessenger::write(
+    fluid_base::OFConnection* ofconn, uint8_t* data, size_t len) const {
+  ofconn->send(data, len);
+}
+
+void BatchingMessenger::event_callback(
+    const ControllerEvent& ev, const OpenflowMessenger& messenger) {
+  switch (ev.get_type()) {
+    case EVENT_BARRIER_REPLY:
+      handle_barrier_reply(
+          static_cast<const BarrierReplyEvent&>(ev).get_xid());
+      break;
+    case EVENT_ERROR:
+      handle_error(static_cast<const ErrorEvent&>(ev).get_xid());
+      break;
+    case EVENT_SWITCH_DOWN:
+      handle_switch_down(ev.get_connection());
+      break;
+    default:
+      break;
+  }
+}
+
+void BatchingMessenger::handle_barrier_reply(uint32_t xid) {
+  complete(xid, true);
+}
+
+void BatchingMessenger::handle_error(uint32_t xid) {
+  std::lock_guard<std::mutex> lock(batches_mutex_);
+  auto it = in_flight_.find(xid);
+  if (it != in_flight_.end()) {
+    it->second.failed = true;
+  }
+}
+
+void BatchingMessenger::complete(uint32_t xid, bool success) {
+  Batch batch;
+  {
+    std::lock_guard<std::mutex> lock(batches_mutex_);
+    auto it = in_flight_.find(xid);
+    if (it == in_flight_.end()) {
+      return;
+    }
+    batch = std::move(it->second);
+    in_flight_.erase(it);
+  }
+  success = success && !batch.failed;
+  if (!success) {
+    OAILOG_ERROR(
+        LOG_GTPV1U, "Openflow batch xid %u of %u messages failed\n", xid,
+        batch.nb_msgs);
+  }
+  increment_counter(
+      "openflow_batch", 1, 1, "result", success ? "success" : "failure");
+  for (const auto& cb : batch.callbacks) {
+    cb(success);
+  }
+}
+
+void BatchingMessenger::handle_switch_down(fluid_base::OFConnection* ofconn) {
+  std::vector<uint32_t> xids;
+  {
+    std::lock_guard<std::mutex> lock(batches_mutex_);
+    // Nothing written for the batch being filled, it goes in flight to fail
+    // with the others
+    auto it = pending_.find(ofconn);
+    if (it != pending_.end()) {
+      in_flight_.emplace(it->second.xid, std::move(it->second));
+      pending_.erase(it);
+    }
+    for (const auto& batch : in_flight_) {
+      if (batch.second.ofconn == ofconn) {
+        xids.push_back(batch.first);
+      }
+    }
+  }
+  for (auto xid : xids) {
+    complete(xid, false);
+  }
+}
+
+uint32_t BatchingMessenger::batches_in_flight() const {
+  std::lock_guard<std::mutex> lock(batches_mutex_);
+  return in_flight_.size();
+}
+
+}  // namespace openflow
@@ -0,0 +1,122 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#pragma once
+
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "OpenflowController.h"
+
+namespace openflow {
+
+/**
+ * Messenger coalescing the messages sent on a connection into batches: a
+ * batch is packed into one buffer, written at once from the event loop and
+ * closed by a barrier request. The switch processes a batch in order and
+ * answers its barrier once done with it, every message of the batch carrying
+ * the batch xid, so a batch completes on its barrier reply and fails when
+ * any of its messages got an error back.
+ *
+ * Batches are not atomic: OpenFlow 1.4 bundles are not available on the
+ * OpenFlow 1.3 connection to OVS, so the flows of a failed batch that
+ * succeeded stay installed.
+ *
+ * The messenger registers as an application for barrier replies, errors and
+ * switch down events.
+ */
+class BatchingMessenger : public DefaultMessenger, public Application {
+ public:
+  // Messages after which a batch is written without waiting for the loop
+  static const uint32_t DEFAULT_MAX_BATCH_SIZE = 512;
+
+  explicit BatchingMessenger(uint32_t max_batch_size = DEFAULT_MAX_BATCH_SIZE);
+
+  /**
+   * Adds the message to the batch being filled for the connection, which is
+   * written on the next event loop iteration
+   */
+  void send_of_msg(
+      fluid_msg::OFMsg& of_msg, fluid_base::OFConnection* ofconn) const;
+
+  /**
+   * Calls cb with the result of the batch holding the messages sent so far
+   * on the connection, right away with true when none is waiting to be
+   * written. Ends an external event: the batch is written when full
+   *
+   * @param cb - called from the event loop, false when a message of the
+   *             batch failed or the switch disconnected before answering
+   */
+  void on_batch_completion(
+      fluid_base::OFConnection* ofconn, std::function<void(bool)> cb) const;
+
+  /**
+   * Writes the batch being filled for the connection, with its barrier
+   */
+  void flush(fluid_base::OFConnection* ofconn) const;
+
+  void event_callback(
+      const ControllerEvent& ev, const OpenflowMessenger& messenger);
+
+  // Completes the batch of the barrier request
+  void handle_barrier_reply(uint32_t xid);
+
+  // Fails the batch of the message, when it is still waiting for its barrier
+  void handle_error(uint32_t xid);
+
+  // Fails every batch of the connection
+  void handle_switch_down(fluid_base::OFConnection* ofconn);
+
+  uint32_t batches_in_flight() const;
+
+ protected:
+  // Writes packed messages on the connection
+  virtual void write(
+      fluid_base::OFConnection* ofconn, uint8_t* data, size_t len) const;
+
+ private:
+  struct Batch {
+    fluid_base::OFConnection* ofconn;
+    uint32_t xid;
+    uint32_t nb_msgs;
+    bool failed;
+    std::vector<uint8_t> buffer;
+    std::vector<std::function<void(bool)>> callbacks;
+  };
+
+  const uint32_t max_batch_size_;
+
+  // send_of_msg() is const in OpenflowMessenger, the batches are not, and
+  // are used from the controller worker threads
+  mutable std::mutex batches_mutex_;
+  mutable uint32_t next_xid_;
+  // Batch being filled, by connection
+  mutable std::unordered_map<fluid_base::OFConnection*, Batch> pending_;
+  // Batches written and waiting for their barrier reply, by xid
+  mutable std::unordered_map<uint32_t, Batch> in_flight_;
+
+  static void* flush_callback(std::shared_ptr<void> data);
+
+  // Writes the batch of the connection, with batches_mutex_ held
+  void write_batch(fluid_base::OFConnection* ofconn) const;
+
+  void complete(uint32_t xid, bool success);
+};
+
+}  // namespace openflow
@@ -72,6 +72,7 @@ ErrorEvent::ErrorEvent(
     fluid_base::OFConnection* ofconn, const struct ofp_error_msg* error_msg)
     : error_type_(ntohs(error_msg->type)),
       error_code_(ntohs(error_msg->code)),
+      xid_(ntohl(error_msg->header.xid)),
       ControllerEvent(ofconn, EVENT_ERROR) {}
 
 const uint16_t ErrorEvent::get_error_type() const {
@@ -82,6 +83,24 @@ const uint16_t ErrorEvent::get_error_code() const {
   return error_code_;
 }
 
+const uint32_t ErrorEvent::get_xid() const {
+  return xid_;
+}
+
+BarrierReplyEvent::BarrierReplyEvent(
+    fluid_base::OFConnection* ofconn, fluid_base::OFHandler& ofhandler,
+    const void* data, const size_t len)
+    : DataEvent(ofconn, ofhandler, data, len, EVENT_BARRIER_REPLY) {}
+
+const uint32_t BarrierReplyEvent::get_xid() const {
+  return ntohl(reinterpret_cast<const struct ofp_header*>(get_data())->xid);
+}
+
+MultipartReplyEvent::MultipartReplyEvent(
+    fluid_base::OFConnection* ofconn, fluid_base::OFHandler& ofhandler,
+    const void* data, const size_t len)
+    : DataEvent(ofconn, ofhandler, data, len, EVENT_MULTIPART_REPLY) {}
+
 ExternalEvent::ExternalEvent(const ControllerEventType type)
     : ControllerEvent(NULL, type) {}
 
@@ -206,6 +225,16 @@ const uint32_t AddGTPTunnelEvent::get_gtp_portno() const {
   return gtp_portno_;
 }
 
+ReconcileGTPTunnelsEvent::ReconcileGTPTunnelsEvent(
+    std::vector<std::shared_ptr<AddGTPTunnelEvent>> tunnels)
+    : tunnels_(std::move(tunnels)),
+      ExternalEvent(EVENT_RECONCILE_GTP_TUNNELS) {}
+
+const std::vector<std::shared_ptr<AddGTPTunnelEvent>>&
+ReconcileGTPTunnelsEvent::get_tunnels() const {
+  return tunnels_;
+}
+
 DeleteGTPTunnelEvent::DeleteGTPTunnelEvent(
     const struct in_addr ue_ip, struct in6_addr* ue_ipv6, const uint32_t in_tei,
     const struct ip_flow_dl* dl_flow, uint32_t gtp_port_no)
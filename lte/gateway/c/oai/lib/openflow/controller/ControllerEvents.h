@@ -18,6 +18,8 @@
 #pragma once
 
 #include <arpa/inet.h>
+#include <memory>
+#include <vector>
 #include <fluid/OFServer.hh>
 #include <fluid/ofcommon/openflow-common.hh>
 #include "gtpv1u.h"
@@ -37,6 +39,9 @@ enum ControllerEventType {
   EVENT_FORWARD_DATA_ON_GTP_TUNNEL,
   EVENT_ADD_PAGING_RULE,
   EVENT_DELETE_PAGING_RULE,
+  EVENT_BARRIER_REPLY,
+  EVENT_MULTIPART_REPLY,
+  EVENT_RECONCILE_GTP_TUNNELS,
 };
 
 /**
@@ -120,10 +125,34 @@ class ErrorEvent : public ControllerEvent {
 
   const uint16_t get_error_type() const;
   const uint16_t get_error_code() const;
+  // Transaction id of the message that failed
+  const uint32_t get_xid() const;
 
  private:
   const uint16_t error_type_;
   const uint16_t error_code_;
+  const uint32_t xid_;
+};
+
+class BarrierReplyEvent : public DataEvent {
+ public:
+  BarrierReplyEvent(
+      fluid_base::OFConnection* ofconn, fluid_base::OFHandler& ofhandler,
+      const void* data, const size_t len);
+
+  // Transaction id of the barrier request
+  const uint32_t get_xid() const;
+};
+
+/**
+ * Event triggered by a reply to a multipart request, like the flow stats
+ * request. Replies larger than a message are split in several events
+ */
+class MultipartReplyEvent : public DataEvent {
+ public:
+  MultipartReplyEvent(
+      fluid_base::OFConnection* ofconn, fluid_base::OFHandler& ofhandler,
+      const void* data, const size_t len);
 };
 
 /*
@@ -205,6 +234,21 @@ class AddGTPTunnelEvent : public ExternalEvent {
   const uint32_t gtp_portno_;
 };
 
+/*
+ * Event triggered by SPGW after a restart with persisted state, with the
+ * tunnels of the bearers it restored
+ */
+class ReconcileGTPTunnelsEvent : public ExternalEvent {
+ public:
+  ReconcileGTPTunnelsEvent(
+      std::vector<std::shared_ptr<AddGTPTunnelEvent>> tunnels);
+
+  const std::vector<std::shared_ptr<AddGTPTunnelEvent>>& get_tunnels() const;
+
+ private:
+  const std::vector<std::shared_ptr<AddGTPTunnelEvent>> tunnels_;
+};
+
 /*
  * Event triggered by SPGW to remove a GTP tunnel for a UE on detach
  */
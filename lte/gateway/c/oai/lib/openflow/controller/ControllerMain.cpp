@@ -16,6 +16,7 @@
  */
 
 #include "OpenflowController.h"
+#include "BatchingMessenger.h"
 #include "PagingApplication.h"
 #include "BaseApplication.h"
 #include "ControllerMain.h"
@@ -30,12 +31,20 @@ static const int OFP_LOCAL   = 65534;
 static const int OF13P_LOCAL = 0xfffffffe;
 
 namespace {
+std::shared_ptr<openflow::BatchingMessenger> messenger(
+    new openflow::BatchingMessenger());
 openflow::OpenflowController ctrl(
-    CONTROLLER_ADDR, CONTROLLER_PORT, NUM_WORKERS, false);
+    CONTROLLER_ADDR, CONTROLLER_PORT, NUM_WORKERS, false, messenger);
+openflow_controller_tunnel_cb tunnel_cb = nullptr;
+// Tunnels waiting for openflow_controller_reconcile_gtp_tunnels
+std::vector<std::shared_ptr<openflow::AddGTPTunnelEvent>> reconciled_tunnels;
 }
 
 int start_of_controller(bool persist_state) {
-  static openflow::PagingApplication paging_app;
+  static openflow::PagingApplication paging_app(
+      spgw_config.sgw_config.ovs_config.paging_suppression_window,
+      spgw_config.sgw_config.ovs_config.paging_rate,
+      spgw_config.sgw_config.ovs_config.paging_burst);
   static openflow::BaseApplication base_app(persist_state);
   int uplink_port_num_ = OF13P_LOCAL;  // default is LOCAL port.
 
@@ -54,6 +63,9 @@ int start_of_controller(bool persist_state) {
       spgw_config.sgw_config.ovs_config.internal_sampling_port_num,
       spgw_config.sgw_config.ovs_config.internal_sampling_fwd_tbl_num,
       uplink_port_num_);
+  ctrl.register_for_event(messenger.get(), openflow::EVENT_BARRIER_REPLY);
+  ctrl.register_for_event(messenger.get(), openflow::EVENT_ERROR);
+  ctrl.register_for_event(messenger.get(), openflow::EVENT_SWITCH_DOWN);
   // Base app registers first, because it deletes/creates default flow
   ctrl.register_for_event(&base_app, openflow::EVENT_SWITCH_UP);
   ctrl.register_for_event(&base_app, openflow::EVENT_ERROR);
@@ -66,6 +78,9 @@ int start_of_controller(bool persist_state) {
   ctrl.register_for_event(&gtp_app, openflow::EVENT_DELETE_GTP_TUNNEL);
   ctrl.register_for_event(&gtp_app, openflow::EVENT_DISCARD_DATA_ON_GTP_TUNNEL);
   ctrl.register_for_event(&gtp_app, openflow::EVENT_FORWARD_DATA_ON_GTP_TUNNEL);
+  ctrl.register_for_event(&gtp_app, openflow::EVENT_RECONCILE_GTP_TUNNELS);
+  ctrl.register_for_event(&gtp_app, openflow::EVENT_MULTIPART_REPLY);
+  ctrl.register_for_event(&gtp_app, openflow::EVENT_SWITCH_DOWN);
   ctrl.start();
   OAILOG_INFO(LOG_GTPV1U, "Started openflow controller\n");
 #define CONNECTION_WAIT_TIME 300
@@ -79,6 +94,33 @@ int stop_of_controller(void) {
   OAILOG_FUNC_RETURN(LOG_GTPV1U, RETURNok);
 }
 
+void openflow_controller_set_tunnel_cb(openflow_controller_tunnel_cb cb) {
+  tunnel_cb = cb;
+}
+
+/**
+ * Reports the result of the flows of a GTP tunnel event once the switch
+ * answered for its batch
+ */
+static void report_tunnel_flows(
+    std::shared_ptr<openflow::ExternalEvent> external_event, bool success) {
+  if (!tunnel_cb) {
+    return;
+  }
+  if (external_event->get_type() == openflow::EVENT_ADD_GTP_TUNNEL) {
+    auto add_tunnel =
+        std::static_pointer_cast<openflow::AddGTPTunnelEvent>(external_event);
+    tunnel_cb(
+        true, add_tunnel->get_in_tei(), add_tunnel->get_imsi().c_str(),
+        success);
+  } else if (external_event->get_type() == openflow::EVENT_DELETE_GTP_TUNNEL) {
+    auto del_tunnel =
+        std::static_pointer_cast<openflow::DeleteGTPTunnelEvent>(
+            external_event);
+    tunnel_cb(false, del_tunnel->get_in_tei(), nullptr, success);
+  }
+}
+
 /**
  * This callback is called from the event loop itself to dispatch an external
  * event to all registered applications
@@ -86,6 +128,11 @@ int stop_of_controller(void) {
 static void* external_event_callback(std::shared_ptr<void> data) {
   auto external_event = std::static_pointer_cast<openflow::ExternalEvent>(data);
   ctrl.dispatch_event(*external_event);
+  // The flows of the event are written with the batch they went to
+  messenger->on_batch_completion(
+      external_event->get_connection(), [external_event](bool success) {
+        report_tunnel_flows(external_event, success);
+      });
 }
 
 int openflow_controller_add_gtp_tunnel(
@@ -106,6 +153,30 @@ int openflow_controller_add_gtp_tunnel(
   OAILOG_FUNC_RETURN(LOG_GTPV1U, RETURNok);
 }
 
+int openflow_controller_add_reconciled_gtp_tunnel(
+    struct in_addr ue, struct in6_addr* ue_ipv6, int vlan, struct in_addr enb,
+    uint32_t i_tei, uint32_t o_tei, const char* imsi,
+    struct ip_flow_dl* flow_dl, uint32_t flow_precedence_dl,
+    uint32_t gtp_portno) {
+  if (flow_dl) {
+    reconciled_tunnels.push_back(std::make_shared<openflow::AddGTPTunnelEvent>(
+        ue, ue_ipv6, vlan, enb, i_tei, o_tei, imsi, flow_dl, flow_precedence_dl,
+        gtp_portno));
+  } else {
+    reconciled_tunnels.push_back(std::make_shared<openflow::AddGTPTunnelEvent>(
+        ue, ue_ipv6, vlan, enb, i_tei, o_tei, imsi, gtp_portno));
+  }
+  OAILOG_FUNC_RETURN(LOG_GTPV1U, RETURNok);
+}
+
+int openflow_controller_reconcile_gtp_tunnels(void) {
+  auto reconcile = std::make_shared<openflow::ReconcileGTPTunnelsEvent>(
+      std::move(reconciled_tunnels));
+  reconciled_tunnels.clear();
+  ctrl.inject_external_event(reconcile, external_event_callback);
+  OAILOG_FUNC_RETURN(LOG_GTPV1U, RETURNok);
+}
+
 int openflow_controller_del_gtp_tunnel(
     struct in_addr ue, struct in6_addr* ue_ipv6, uint32_t i_tei,
     struct ip_flow_dl* flow_dl, uint32_t gtp_portno) {
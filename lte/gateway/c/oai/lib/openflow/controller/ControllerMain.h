@@ -27,6 +27,16 @@ extern "C" {
 
 int start_of_controller(bool persist_state);
 
+/*
+ * Result of the flows of a GTP tunnel add (add true) or delete, called from
+ * the controller thread once the switch answered for them. imsi is NULL on
+ * delete
+ */
+typedef void (*openflow_controller_tunnel_cb)(
+    bool add, uint32_t i_tei, const char* imsi, bool success);
+
+void openflow_controller_set_tunnel_cb(openflow_controller_tunnel_cb cb);
+
 int stop_of_controller(void);
 
 int openflow_controller_add_gtp_tunnel(
@@ -35,6 +45,21 @@ int openflow_controller_add_gtp_tunnel(
     struct ip_flow_dl* flow_dl, uint32_t flow_precedence_dl,
     uint32_t gtp_portno);
 
+/*
+ * Reconciliation of the tunnel flows of the switch after a restart with
+ * persisted state: each tunnel of the restored bearers is added with
+ * openflow_controller_add_reconciled_gtp_tunnel, then
+ * openflow_controller_reconcile_gtp_tunnels installs the missing ones and
+ * deletes the flows of the tunnels that are gone
+ */
+int openflow_controller_add_reconciled_gtp_tunnel(
+    struct in_addr ue, struct in6_addr* ue_ipv6, int vlan, struct in_addr enb,
+    uint32_t i_tei, uint32_t o_tei, const char* imsi,
+    struct ip_flow_dl* flow_dl, uint32_t flow_precedence_dl,
+    uint32_t gtp_portno);
+
+int openflow_controller_reconcile_gtp_tunnels(void);
+
 int openflow_controller_del_gtp_tunnel(
     struct in_addr ue, struct in6_addr* ue_ipv6, uint32_t i_tei,
     struct ip_flow_dl* flow_dl, uint32_t gtp_portno);
@@ -17,6 +17,8 @@
 
 #include <netinet/ip.h>
 #include <arpa/inet.h>
+#include <endian.h>
+#include <string.h>
 #include <string>
 
 #include "GTPApplication.h"
@@ -26,6 +28,7 @@
 extern "C" {
 #include "log.h"
 #include "bstrlib.h"
+#include "service303.h"
 }
 
 using namespace fluid_msg;
@@ -35,6 +38,15 @@ namespace openflow {
 const std::string GTPApplication::GTP_PORT_MAC = "02:00:00:00:00:01";
 const std::uint16_t OFPVID_PRESENT             = 0x1000;
 
+// Offsets in the OpenFlow 1.3 multipart reply and flow stats
+const size_t MULTIPART_TYPE_OFFSET      = 8;
+const size_t MULTIPART_FLAGS_OFFSET     = 10;
+const size_t MULTIPART_REPLY_LEN        = 16;
+const size_t FLOW_STATS_TABLE_OFFSET    = 2;
+const size_t FLOW_STATS_PRIORITY_OFFSET = 12;
+const size_t FLOW_STATS_COOKIE_OFFSET   = 24;
+const size_t FLOW_STATS_MATCH_OFFSET    = 48;
+
 GTPApplication::GTPApplication(
     const std::string& uplink_mac, uint32_t gtp_port_num, uint32_t mtr_port_num,
     uint32_t internal_sampling_port_num, uint32_t internal_sampling_fwd_tbl_num,
@@ -50,13 +62,12 @@ void GTPApplication::event_callback(
     const ControllerEvent& ev, const OpenflowMessenger& messenger) {
   if (ev.get_type() == EVENT_ADD_GTP_TUNNEL) {
     auto add_tunnel_event = static_cast<const AddGTPTunnelEvent&>(ev);
-    add_uplink_tunnel_flow(add_tunnel_event, messenger);
-    add_downlink_tunnel_flow(add_tunnel_event, messenger, uplink_port_num_);
-    add_downlink_tunnel_flow(add_tunnel_event, messenger, mtr_port_num_);
-    add_downlink_arp_flow(add_tunnel_event, messenger, uplink_port_num_);
-    add_downlink_arp_flow(add_tunnel_event, messenger, mtr_port_num_);
+    mark_changed(add_tunnel_event.get_in_tei(), add_tunnel_event.get_ue_ip());
+    add_tunnel_flows(add_tunnel_event, messenger);
+    add_arp_flows(add_tunnel_event, messenger);
   } else if (ev.get_type() == EVENT_DELETE_GTP_TUNNEL) {
     auto del_tunnel_event = static_cast<const DeleteGTPTunnelEvent&>(ev);
+    mark_changed(del_tunnel_event.get_in_tei(), del_tunnel_event.get_ue_ip());
     delete_uplink_tunnel_flow(del_tunnel_event, messenger);
     delete_downlink_tunnel_flow(del_tunnel_event, messenger, uplink_port_num_);
     delete_downlink_tunnel_flow(del_tunnel_event, messenger, mtr_port_num_);
@@ -80,9 +91,42 @@ void GTPApplication::event_callback(
     install_internal_pkt_fwd_flow(
         ev.get_connection(), messenger, internal_sampling_port_num_,
         internal_sampling_fwd_tbl_num_);
+  } else if (ev.get_type() == EVENT_RECONCILE_GTP_TUNNELS) {
+    start_reconciliation(
+        static_cast<const ReconcileGTPTunnelsEvent&>(ev), messenger);
+  } else if (ev.get_type() == EVENT_MULTIPART_REPLY) {
+    const auto& reply = static_cast<const MultipartReplyEvent&>(ev);
+    handle_flow_stats_reply(
+        ev.get_connection(), reply.get_data(), reply.get_length(), messenger);
+  } else if (ev.get_type() == EVENT_SWITCH_DOWN && reconciliation_) {
+    OAILOG_ERROR(
+        LOG_GTPV1U,
+        "Switch disconnected, GTP tunnel reconciliation aborted\n");
+    reconciliation_.reset();
   }
 }
 
+uint64_t GTPApplication::tunnel_cookie(uint32_t in_tei) {
+  return (uint64_t) in_tei << 32 | TUNNEL_COOKIE_TYPE;
+}
+
+uint64_t GTPApplication::arp_cookie(const struct in_addr& ue_ip) {
+  return (uint64_t) ue_ip.s_addr << 32 | ARP_COOKIE_TYPE;
+}
+
+void GTPApplication::add_tunnel_flows(
+    const AddGTPTunnelEvent& ev, const OpenflowMessenger& messenger) {
+  add_uplink_tunnel_flow(ev, messenger);
+  add_downlink_tunnel_flow(ev, messenger, uplink_port_num_);
+  add_downlink_tunnel_flow(ev, messenger, mtr_port_num_);
+}
+
+void GTPApplication::add_arp_flows(
+    const AddGTPTunnelEvent& ev, const OpenflowMessenger& messenger) {
+  add_downlink_arp_flow(ev, messenger, uplink_port_num_);
+  add_downlink_arp_flow(ev, messenger, mtr_port_num_);
+}
+
 void GTPApplication::install_internal_pkt_fwd_flow(
     fluid_base::OFConnection* ofconn, const OpenflowMessenger& messenger,
     uint32_t port, uint32_t next_table) {
@@ -131,6 +175,7 @@ void GTPApplication::add_uplink_tunnel_flow(
       convert_precedence_to_priority(ev.get_dl_flow_precedence());
   of13::FlowMod uplink_fm =
       messenger.create_default_flow_mod(0, of13::OFPFC_ADD, flow_priority);
+  uplink_fm.cookie(tunnel_cookie(ev.get_in_tei()));
   add_uplink_match(uplink_fm, ev.get_gtp_portno(), ev.get_in_tei());
 
   // Set eth src and dst
@@ -175,6 +220,7 @@ void GTPApplication::delete_uplink_tunnel_flow(
   // match all ports and groups
   uplink_fm.out_port(of13::OFPP_ANY);
   uplink_fm.out_group(of13::OFPG_ANY);
+  uplink_fm.cookie(tunnel_cookie(ev.get_in_tei()));
 
   add_uplink_match(uplink_fm, ev.get_gtp_portno(), ev.get_in_tei());
 
@@ -321,6 +367,7 @@ void GTPApplication::add_downlink_tunnel_flow_action(
     of13::FlowMod downlink_fm) {
   auto imsi = IMSIEncoder::compact_imsi(ev.get_imsi());
   of13::ApplyActions apply_dl_inst;
+  downlink_fm.cookie(tunnel_cookie(ev.get_in_tei()));
 
   // Set outgoing tunnel id and tunnel destination ip
   of13::SetFieldAction set_out_tunnel(new of13::TUNNELId(ev.get_out_tei()));
@@ -413,6 +460,7 @@ void GTPApplication::add_downlink_arp_flow_action(
     of13::FlowMod downlink_fm) {
   auto imsi = IMSIEncoder::compact_imsi(ev.get_imsi());
   of13::ApplyActions apply_dl_inst;
+  downlink_fm.cookie(arp_cookie(ev.get_ue_ip()));
 
   // add imsi to packet metadata to pass to other tables
   add_imsi_metadata(apply_dl_inst, imsi);
@@ -449,6 +497,7 @@ void GTPApplication::delete_downlink_tunnel_flow_ipv4(
   // match all ports and groups
   downlink_fm.out_port(of13::OFPP_ANY);
   downlink_fm.out_group(of13::OFPG_ANY);
+  downlink_fm.cookie(tunnel_cookie(ev.get_in_tei()));
 
   add_downlink_match(downlink_fm, ev.get_ue_ip(), port_number);
   messenger.send_of_msg(downlink_fm, ev.get_connection());
@@ -462,6 +511,7 @@ void GTPApplication::delete_downlink_tunnel_flow_ded_brr(
   // match all ports and groups
   downlink_fm.out_port(of13::OFPP_ANY);
   downlink_fm.out_group(of13::OFPG_ANY);
+  downlink_fm.cookie(tunnel_cookie(ev.get_in_tei()));
 
   add_ded_brr_dl_match(downlink_fm, ev.get_dl_flow(), port_number);
   messenger.send_of_msg(downlink_fm, ev.get_connection());
@@ -475,6 +525,7 @@ void GTPApplication::delete_downlink_tunnel_flow_ipv6(
   // match all ports and groups
   downlink_fm.out_port(of13::OFPP_ANY);
   downlink_fm.out_group(of13::OFPG_ANY);
+  downlink_fm.cookie(tunnel_cookie(ev.get_in_tei()));
 
   add_downlink_match_ipv6(
       downlink_fm, ev.get_ue_info().get_ipv6(), port_number);
@@ -506,6 +557,7 @@ void GTPApplication::delete_downlink_arp_flow(
   // match all ports and groups
   downlink_fm.out_port(of13::OFPP_ANY);
   downlink_fm.out_group(of13::OFPG_ANY);
+  downlink_fm.cookie(arp_cookie(ev.get_ue_ip()));
 
   add_downlink_arp_match(downlink_fm, ev.get_ue_ip(), port_number);
 
@@ -586,6 +638,204 @@ void GTPApplication::forward_downlink_tunnel_flow(
   messenger.send_of_msg(downlink_fm, ev.get_connection());
 }
 
+static uint16_t read_u16(const uint8_t* data) {
+  uint16_t value;
+  memcpy(&value, data, sizeof(value));
+  return ntohs(value);
+}
+
+static uint64_t read_u64(const uint8_t* data) {
+  uint64_t value;
+  memcpy(&value, data, sizeof(value));
+  return be64toh(value);
+}
+
+/*
+ * Flows of the GTP tunnels and ARP flows match on a tunnel id or on a UE
+ * address, unlike the other flows of table 0
+ */
+static bool is_tunnel_flow(of13::FlowMod& fm) {
+  return fm.get_oxm_field(of13::OFPXMT_OFB_TUNNEL_ID) != nullptr ||
+         fm.get_oxm_field(of13::OFPXMT_OFB_IPV4_DST) != nullptr ||
+         fm.get_oxm_field(of13::OFPXMT_OFB_IPV6_DST) != nullptr ||
+         fm.get_oxm_field(of13::OFPXMT_OFB_ARP_TPA) != nullptr;
+}
+
+void GTPApplication::mark_changed(
+    uint32_t in_tei, const struct in_addr& ue_ip) {
+  if (reconciliation_) {
+    reconciliation_->changed_teis.insert(in_tei);
+    reconciliation_->changed_ue_ips.insert(ue_ip.s_addr);
+  }
+}
+
+void GTPApplication::start_reconciliation(
+    const ReconcileGTPTunnelsEvent& ev, const OpenflowMessenger& messenger) {
+  reconciliation_.reset(new Reconciliation());
+  reconciliation_->start = std::chrono::steady_clock::now();
+  for (const auto& tunnel : ev.get_tunnels()) {
+    // The tunnel events are not dispatched by the controller
+    tunnel->set_of_connection(ev.get_connection());
+    reconciliation_->tunnels[tunnel->get_in_tei()].push_back(tunnel);
+    reconciliation_->arp_tunnels.emplace(tunnel->get_ue_ip().s_addr, tunnel);
+  }
+  OAILOG_INFO(
+      LOG_GTPV1U, "Reconciling %lu GTP tunnels with the switch flows\n",
+      reconciliation_->tunnels.size());
+
+  // Every flow of table 0, whatever its cookie
+  of13::MultipartRequestFlow request(
+      0, 0, 0, of13::OFPP_ANY, of13::OFPG_ANY, 0, 0);
+  messenger.send_of_msg(request, ev.get_connection());
+  // The barrier reply comes after the last part of the reply
+  messenger.on_batch_completion(ev.get_connection(), [this](bool success) {
+    if (!success && reconciliation_) {
+      OAILOG_ERROR(
+          LOG_GTPV1U, "Flow stats request failed, reconciliation aborted\n");
+      reconciliation_.reset();
+    }
+  });
+}
+
+void GTPApplication::handle_flow_stats_reply(
+    fluid_base::OFConnection* ofconn, const uint8_t* data, size_t len,
+    const OpenflowMessenger& messenger) {
+  if (!reconciliation_ || len < MULTIPART_REPLY_LEN ||
+      read_u16(data + MULTIPART_TYPE_OFFSET) != of13::OFPMP_FLOW) {
+    return;
+  }
+  size_t offset = MULTIPART_REPLY_LEN;
+  while (offset + FLOW_STATS_MATCH_OFFSET <= len) {
+    const uint8_t* stats = data + offset;
+    uint16_t length      = read_u16(stats);
+    if (length < FLOW_STATS_MATCH_OFFSET || offset + length > len) {
+      OAILOG_ERROR(LOG_GTPV1U, "Malformed flow stats reply\n");
+      break;
+    }
+    offset += length;
+    if (stats[FLOW_STATS_TABLE_OFFSET] != 0) {
+      continue;
+    }
+
+    uint64_t cookie   = read_u64(stats + FLOW_STATS_COOKIE_OFFSET);
+    uint16_t priority = read_u16(stats + FLOW_STATS_PRIORITY_OFFSET);
+    if ((cookie & COOKIE_TYPE_MASK) == TUNNEL_COOKIE_TYPE) {
+      reconciliation_->installed_teis.insert(cookie >> 32);
+    } else if ((cookie & COOKIE_TYPE_MASK) == ARP_COOKIE_TYPE) {
+      reconciliation_->installed_ue_ips.insert(cookie >> 32);
+    } else if (cookie == 0 && priority >= DEFAULT_PRIORITY) {
+      of13::Match match;
+      match.unpack(const_cast<uint8_t*>(stats + FLOW_STATS_MATCH_OFFSET));
+      of13::FlowMod legacy_fm = messenger.create_default_flow_mod(
+          0, of13::OFPFC_DELETE_STRICT, priority);
+      legacy_fm.out_port(of13::OFPP_ANY);
+      legacy_fm.out_group(of13::OFPG_ANY);
+      legacy_fm.match(match);
+      if (is_tunnel_flow(legacy_fm)) {
+        reconciliation_->legacy_flows.push_back(legacy_fm);
+      }
+    }
+  }
+
+  if (read_u16(data + MULTIPART_FLAGS_OFFSET) & of13::OFPMPF_REPLY_MORE) {
+    return;
+  }
+  finish_reconciliation(ofconn, messenger);
+}
+
+void GTPApplication::delete_flows_by_cookie(
+    fluid_base::OFConnection* ofconn, const OpenflowMessenger& messenger,
+    uint64_t cookie) {
+  of13::FlowMod fm =
+      messenger.create_default_flow_mod(0, of13::OFPFC_DELETE, 0);
+  // match all ports and groups
+  fm.out_port(of13::OFPP_ANY);
+  fm.out_group(of13::OFPG_ANY);
+  fm.cookie(cookie);
+  messenger.send_of_msg(fm, ofconn);
+}
+
+void GTPApplication::finish_reconciliation(
+    fluid_base::OFConnection* ofconn, const OpenflowMessenger& messenger) {
+  std::unique_ptr<Reconciliation> reconciliation = std::move(reconciliation_);
+  auto failed_batches = std::make_shared<uint32_t>(0);
+  auto count_failure  = [failed_batches](bool success) {
+    if (!success) {
+      (*failed_batches)++;
+    }
+  };
+  uint32_t kept    = 0;
+  uint32_t added   = 0;
+  uint32_t deleted = 0;
+
+  // Tunnels changed during the reconciliation already got their flows from
+  // SPGW. Each tunnel ends a batch once full
+  for (const auto& tunnel : reconciliation->tunnels) {
+    if (reconciliation->changed_teis.count(tunnel.first)) {
+      continue;
+    }
+    if (reconciliation->installed_teis.count(tunnel.first)) {
+      kept++;
+      continue;
+    }
+    for (const auto& ev : tunnel.second) {
+      add_tunnel_flows(*ev, messenger);
+    }
+    messenger.on_batch_completion(ofconn, count_failure);
+    added++;
+  }
+  for (const auto& ue : reconciliation->arp_tunnels) {
+    if (!reconciliation->changed_ue_ips.count(ue.first) &&
+        !reconciliation->installed_ue_ips.count(ue.first)) {
+      add_arp_flows(*ue.second, messenger);
+      messenger.on_batch_completion(ofconn, count_failure);
+    }
+  }
+  for (uint32_t in_tei : reconciliation->installed_teis) {
+    if (!reconciliation->changed_teis.count(in_tei) &&
+        !reconciliation->tunnels.count(in_tei)) {
+      delete_flows_by_cookie(ofconn, messenger, tunnel_cookie(in_tei));
+      messenger.on_batch_completion(ofconn, count_failure);
+      deleted++;
+    }
+  }
+  for (uint32_t ue_ip : reconciliation->installed_ue_ips) {
+    if (!reconciliation->changed_ue_ips.count(ue_ip) &&
+        !reconciliation->arp_tunnels.count(ue_ip)) {
+      struct in_addr addr;
+      addr.s_addr = ue_ip;
+      delete_flows_by_cookie(ofconn, messenger, arp_cookie(addr));
+      messenger.on_batch_completion(ofconn, count_failure);
+    }
+  }
+  // After the adds, which replaced the legacy flows still in use
+  for (auto& legacy_fm : reconciliation->legacy_flows) {
+    messenger.send_of_msg(legacy_fm, ofconn);
+    messenger.on_batch_completion(ofconn, count_failure);
+  }
+
+  increment_counter("openflow_reconciled_tunnels", kept, 1, "action", "kept");
+  increment_counter("openflow_reconciled_tunnels", added, 1, "action", "added");
+  increment_counter(
+      "openflow_reconciled_tunnels", deleted, 1, "action", "deleted");
+  auto start       = reconciliation->start;
+  size_t nb_legacy = reconciliation->legacy_flows.size();
+  messenger.on_batch_completion(ofconn, [=](bool success) {
+    auto duration_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                           std::chrono::steady_clock::now() - start)
+                           .count();
+    if (!success) {
+      (*failed_batches)++;
+    }
+    OAILOG_INFO(
+        LOG_GTPV1U,
+        "GTP tunnel reconciliation done in %ld ms: %u tunnels kept, %u added, "
+        "%u deleted, %lu legacy flows deleted, %u batches failed\n",
+        (long) duration_ms, kept, added, deleted, nb_legacy, *failed_batches);
+    set_gauge("openflow_reconciliation_duration_ms", duration_ms, NO_LABELS);
+  });
+}
+
 // Precedence in TFT and flow rule priority in OVS are inversely
 // related. Rules with a low precedence value takes precedence,
 // where 0 has the highest precedence. In OVS rules with high
@@ -19,6 +19,12 @@
 
 #include <gmp.h>  // gross but necessary to link spgw_config.h
 
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
 #include "OpenflowController.h"
 #include "gtpv1u.h"
 
@@ -27,6 +33,11 @@ namespace openflow {
 /**
  * GTPApplication handles external callbacks to add/delete tunnel flows for a
  * UE when it connects
+ *
+ * The flows of a tunnel carry its cookie, and the ARP flows of a UE the
+ * cookie of its IPv4 address, so that after a restart with persisted state
+ * the flows of table 0 can be reconciled with the tunnels of the SPGW state
+ * without touching the tunnels that are already in place.
  */
 class GTPApplication : public Application {
  public:
@@ -35,6 +46,36 @@ class GTPApplication : public Application {
       uint32_t mtr_port_num, uint32_t internal_sampling_port_num,
       uint32_t internal_sampling_fwd_tbl_num, uint32_t uplink_port_num);
 
+  /**
+   * Cookie of the flows of a GTP tunnel, with its TEI in the upper 32 bits
+   */
+  static uint64_t tunnel_cookie(uint32_t in_tei);
+
+  /**
+   * Cookie of the ARP flows of a UE, shared by the tunnels of its bearers,
+   * with its IPv4 address in the upper 32 bits
+   */
+  static uint64_t arp_cookie(const struct in_addr& ue_ip);
+
+  /**
+   * Starts reconciling table 0 with the tunnels of the event: the flows of
+   * the table are requested, and diffed with the tunnels once received
+   */
+  void start_reconciliation(
+      const ReconcileGTPTunnelsEvent& ev, const OpenflowMessenger& messenger);
+
+  /**
+   * Handles a part of the flow stats reply to the reconciliation request.
+   * Once the last part is in, tunnels missing from the switch are added,
+   * flows of tunnels absent from the SPGW state are deleted, and the
+   * tunnels already in place are left alone
+   *
+   * @param data - the multipart reply message, OpenFlow header included
+   */
+  void handle_flow_stats_reply(
+      fluid_base::OFConnection* ofconn, const uint8_t* data, size_t len,
+      const OpenflowMessenger& messenger);
+
  private:
   /**
    * Main callback event required by inherited Application class. Whenever
@@ -145,6 +186,38 @@ class GTPApplication : public Application {
   static const std::string GTP_PORT_MAC;
   static const uint16_t NEXT_TABLE   = 1;
   static const uint32_t LOW_PRIORITY = 0;
+  // Lower 32 bits of the tunnel and ARP cookies, clear of the bits of the
+  // discard flow cookies
+  static const uint64_t TUNNEL_COOKIE_TYPE = 0x4;
+  static const uint64_t ARP_COOKIE_TYPE    = 0x8;
+  static const uint64_t COOKIE_TYPE_MASK   = 0xffffffff;
+
+  /**
+   * State of a reconciliation, from the flow stats request to the last part
+   * of its reply
+   */
+  struct Reconciliation {
+    std::chrono::steady_clock::time_point start;
+    // Tunnels of the SPGW state by TEI, a dedicated bearer has one event
+    // per packet filter
+    std::unordered_map<
+        uint32_t, std::vector<std::shared_ptr<AddGTPTunnelEvent>>>
+        tunnels;
+    // A tunnel of each UE IPv4 address, to add the ARP flows of the UE
+    std::unordered_map<uint32_t, std::shared_ptr<AddGTPTunnelEvent>>
+        arp_tunnels;
+    // TEIs and UE addresses with flows in the switch
+    std::unordered_set<uint32_t> installed_teis;
+    std::unordered_set<uint32_t> installed_ue_ips;
+    // Deletes of the tunnel flows installed without cookie by an older
+    // version, sent once the tunnels are added back with their cookie
+    std::vector<of13::FlowMod> legacy_flows;
+    // TEIs and UE addresses SPGW changed after the flows were requested,
+    // which the reply may not reflect
+    std::unordered_set<uint32_t> changed_teis;
+    std::unordered_set<uint32_t> changed_ue_ips;
+  };
+  std::unique_ptr<Reconciliation> reconciliation_;
 
   const std::string uplink_mac_;
   const uint32_t gtp0_port_num_;
@@ -187,6 +260,24 @@ class GTPApplication : public Application {
   void delete_downlink_tunnel_flow_ded_brr(
       const DeleteGTPTunnelEvent& ev, const OpenflowMessenger& messenger,
       uint32_t port_number);
+
+  void add_tunnel_flows(
+      const AddGTPTunnelEvent& ev, const OpenflowMessenger& messenger);
+
+  void add_arp_flows(
+      const AddGTPTunnelEvent& ev, const OpenflowMessenger& messenger);
+
+  void delete_flows_by_cookie(
+      fluid_base::OFConnection* ofconn, const OpenflowMessenger& messenger,
+      uint64_t cookie);
+
+  /*
+   * Records the tunnel and UE an event changes during a reconciliation
+   */
+  void mark_changed(uint32_t in_tei, const struct in_addr& ue_ip);
+
+  void finish_reconciliation(
+      fluid_base::OFConnection* ofconn, const OpenflowMessenger& messenger);
 };
 
 }  // namespace openflow
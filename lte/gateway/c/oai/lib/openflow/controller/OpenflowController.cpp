@@ -78,6 +78,10 @@ void OpenflowController::message_callback(
         "Send signal that Controller is connected to switch to all waiting "
         "threads \n");
     dispatch_event(SwitchUpEvent(ofconn, *this, data, len));
+  } else if (type == OFPT_BARRIER_REPLY_TYPE) {
+    dispatch_event(BarrierReplyEvent(ofconn, *this, data, len));
+  } else if (type == OFPT_MULTIPART_REPLY_TYPE) {
+    dispatch_event(MultipartReplyEvent(ofconn, *this, data, len));
   } else if (type == OFPT_ERROR) {
     dispatch_event(
         ErrorEvent(ofconn, reinterpret_cast<struct ofp_error_msg*>(data)));
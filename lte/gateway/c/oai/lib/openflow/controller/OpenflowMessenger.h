@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <functional>
+
 #include <fluid/of10msg.hh>
 #include <fluid/of13msg.hh>
 #include <fluid/OFServer.hh>
@@ -48,6 +50,18 @@ class OpenflowMessenger {
    */
   virtual void send_of_msg(
       fluid_msg::OFMsg& of_msg, fluid_base::OFConnection* ofconn) const {}
+
+  /**
+   * Calls cb once the messages sent so far on the connection are processed
+   * by the switch. Messages are sent right away here, so cb is called
+   * right away with true
+   *
+   * @param cb - called with false when a message failed
+   */
+  virtual void on_batch_completion(
+      fluid_base::OFConnection* ofconn, std::function<void(bool)> cb) const {
+    cb(true);
+  }
 };
 
 /**
@@ -17,12 +17,14 @@
 
 #include <netinet/ip.h>
 #include <arpa/inet.h>
+#include <chrono>
 #include "OpenflowController.h"
 #include "PagingApplication.h"
 #include "MobilityClientAPI.h"
 
 extern "C" {
 #include "log.h"
+#include "service303.h"
 #include "sgw_paging.h"
 }
 
@@ -38,6 +40,16 @@ uint32_t prefix2mask(int prefix) {
   }
 }
 
+PagingApplication::PagingApplication(
+    uint32_t suppression_window, uint32_t paging_rate, uint32_t paging_burst)
+    : suppression_window_(suppression_window),
+      paging_rate_(paging_rate),
+      paging_bucket_size_(
+          (paging_burst ? paging_burst : paging_rate) * PAGING_TOKEN),
+      purged_at_ms_(0),
+      paging_tokens_(paging_bucket_size_),
+      refilled_at_ms_(0) {}
+
 void PagingApplication::event_callback(
     const ControllerEvent& ev, const OpenflowMessenger& messenger) {
   if (ev.get_type() == EVENT_PACKET_IN) {
@@ -57,17 +69,94 @@ void PagingApplication::event_callback(
   }
 }
 
+bool PagingApplication::take_paging_token(int64_t now_ms) {
+  if (!paging_rate_) {
+    return true;
+  }
+  if (now_ms > refilled_at_ms_) {
+    paging_tokens_ += (uint64_t)(now_ms - refilled_at_ms_) * paging_rate_;
+    refilled_at_ms_ = now_ms;
+    if (paging_tokens_ > paging_bucket_size_) {
+      paging_tokens_ = paging_bucket_size_;
+    }
+  }
+  if (paging_tokens_ < PAGING_TOKEN) {
+    return false;
+  }
+  paging_tokens_ -= PAGING_TOKEN;
+  return true;
+}
+
+PagingApplication::PagingDecision PagingApplication::decide_paging(
+    uint32_t ue_ip, int64_t now_ms) {
+  const int64_t window_ms = (int64_t) suppression_window_ * 1000;
+  std::lock_guard<std::mutex> lock(paging_mutex_);
+
+  // Forget the UE IPs out of their window once per window
+  if (now_ms - purged_at_ms_ >= window_ms) {
+    for (auto it = paged_at_ms_.begin(); it != paged_at_ms_.end();) {
+      if (now_ms - it->second >= window_ms) {
+        it = paged_at_ms_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+    purged_at_ms_ = now_ms;
+  }
+
+  auto paged = paged_at_ms_.find(ue_ip);
+  if (paged != paged_at_ms_.end() && now_ms - paged->second < window_ms) {
+    return SUPPRESS;
+  }
+  if (!take_paging_token(now_ms)) {
+    return RATE_LIMIT;
+  }
+  paged_at_ms_[ue_ip] = now_ms;
+  return PAGE;
+}
+
+void PagingApplication::reset_paging(uint32_t ue_ip) {
+  std::lock_guard<std::mutex> lock(paging_mutex_);
+  paged_at_ms_.erase(ue_ip);
+}
+
 void PagingApplication::handle_paging_message(
     fluid_base::OFConnection* ofconn, uint8_t* data,
     const OpenflowMessenger& messenger) {
-  // send paging request to MME
   struct ip* ip_header = (struct ip*) (data + ETH_HEADER_LENGTH);
   struct in_addr dest_ip;
   memcpy(&dest_ip, &ip_header->ip_dst, sizeof(struct in_addr));
-  char* dest_ip_str = inet_ntoa(dest_ip);
-  OAILOG_DEBUG(
-      LOG_GTPV1U, "Initiating paging procedure for IP %s\n", dest_ip_str);
-  sgw_send_paging_request(&dest_ip);
+  char* dest_ip_str    = inet_ntoa(dest_ip);
+  int clamping_timeout = suppression_window_;
+  auto now             = std::chrono::steady_clock::now().time_since_epoch();
+
+  switch (decide_paging(
+      dest_ip.s_addr,
+      std::chrono::duration_cast<std::chrono::milliseconds>(now).count())) {
+    case PAGE:
+      // send paging request to MME
+      OAILOG_DEBUG(
+          LOG_GTPV1U, "Initiating paging procedure for IP %s\n", dest_ip_str);
+      increment_counter("spgw_paging_packet_in", 1, 1, "result", "paged");
+      sgw_send_paging_request(&dest_ip);
+      break;
+    case SUPPRESS:
+      // Packets that reached the switch before the clamping flow, the UE is
+      // already being paged and the clamping flow is in place
+      OAILOG_DEBUG(
+          LOG_GTPV1U, "Suppressed paging for IP %s, paged recently\n",
+          dest_ip_str);
+      increment_counter("spgw_paging_packet_in", 1, 1, "result", "suppressed");
+      return;
+    case RATE_LIMIT:
+      OAILOG_DEBUG(
+          LOG_GTPV1U, "Paging rate limit reached, deferred paging for IP %s\n",
+          dest_ip_str);
+      increment_counter(
+          "spgw_paging_packet_in", 1, 1, "result", "rate_limited");
+      clamping_timeout = RATE_LIMIT_CLAMPING_TIMEOUT;
+      break;
+  }
 
   /*
    * Clamp on this ip for configured amount of time
@@ -78,7 +167,7 @@ void PagingApplication::handle_paging_message(
    */
   of13::FlowMod fm =
       messenger.create_default_flow_mod(0, of13::OFPFC_ADD, MID_PRIORITY + 1);
-  fm.hard_timeout(CLAMPING_TIMEOUT);
+  fm.hard_timeout(clamping_timeout);
   of13::EthType type_match(IP_ETH_TYPE);
   fm.add_oxm_field(type_match);
 
@@ -110,6 +199,8 @@ void PagingApplication::add_paging_flow(
   fm.add_instruction(inst);
 
   messenger.send_of_msg(fm, ev.get_connection());
+  // The UE went idle again, its next downlink packet pages it
+  reset_paging(ue_ip.s_addr);
   // Convert to string for logging
   char ip_str[INET_ADDRSTRLEN];
   inet_ntop(AF_INET, &(ue_ip.s_addr), ip_str, INET_ADDRSTRLEN);
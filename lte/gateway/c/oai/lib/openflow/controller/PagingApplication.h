@@ -17,16 +17,68 @@
 
 #pragma once
 
+#include <mutex>
+#include <unordered_map>
+
 #include "OpenflowController.h"
 
 namespace openflow {
 #define ETH_HEADER_LENGTH 14
 
 class PagingApplication : public Application {
+ public:
+  static const int CLAMPING_TIMEOUT = 30;  // seconds
+
+  /**
+   * @param suppression_window (in) - seconds after paging a UE IP during
+   *   which its packet-ins do not page it again, also the clamping timeout
+   * @param paging_rate (in) - pagings per second over all UEs, 0 for no limit
+   * @param paging_burst (in) - pagings allowed at once above the rate, the
+   *   rate when 0
+   */
+  PagingApplication(
+      uint32_t suppression_window = CLAMPING_TIMEOUT, uint32_t paging_rate = 0,
+      uint32_t paging_burst = 0);
+
+  enum PagingDecision {
+    PAGE,
+    SUPPRESS,    // paged less than the suppression window ago
+    RATE_LIMIT,  // over the global paging rate, retried after a short clamp
+  };
+
+  /**
+   * Decides whether a packet-in for an idle UE IP starts a paging procedure
+   *
+   * @param ue_ip (in) - destination IP of the packet, network byte order
+   * @param now_ms (in) - monotonic time of the packet-in
+   */
+  PagingDecision decide_paging(uint32_t ue_ip, int64_t now_ms);
+
  private:
   static const int MID_PRIORITY = 5;
-  // TODO: move to config file
-  static const int CLAMPING_TIMEOUT = 30;  // seconds
+  // Clamping timeout of a rate limited UE IP, seconds
+  static const int RATE_LIMIT_CLAMPING_TIMEOUT = 1;
+  // A paging token in thousandths, refilled by paging_rate_ per millisecond
+  static const uint64_t PAGING_TOKEN = 1000;
+
+  const uint32_t suppression_window_;
+  const uint32_t paging_rate_;
+  const uint64_t paging_bucket_size_;
+
+  // Packet-ins reach the application from the controller worker threads
+  std::mutex paging_mutex_;
+  // UE IP to the time it was last paged
+  std::unordered_map<uint32_t, int64_t> paged_at_ms_;
+  int64_t purged_at_ms_;
+  uint64_t paging_tokens_;
+  int64_t refilled_at_ms_;
+
+  /**
+   * Forgets a UE IP, so that the next packet-in for it pages right away
+   */
+  void reset_paging(uint32_t ue_ip);
+
+  bool take_paging_token(int64_t now_ms);
   /**
    * Main callback event required by inherited Application class. Whenever
    * the controller gets an event like packet in or switch up, it will pass
@@ -40,7 +92,9 @@ class PagingApplication : public Application {
   /**
    * Handles downlink data intended for a UE in idle mode, then forwards the
    * paging request to SPGW. After initiating the paging process, it also clamps
-   * on the destination IP, to prevent multiple packet-in messages
+   * on the destination IP, to prevent multiple packet-in messages. Packet-ins
+   * already on their way when the clamp is installed are suppressed, and
+   * pagings over the global rate are retried after a short clamp
    *
    * @param ofconn (in) - given connection to OVS switch
    * @param data (in) - the ethernet packet received by the switch
@@ -30,12 +30,20 @@
 #include "lte/protos/subscriberdb.pb.h"
 #include "spgw_types.h"
 
-extern "C" {}
+extern "C" {
+#include "procedure_trace.h"
+}
 
 #define ULI_DATA_SIZE 13
 
 static char _convert_digit_to_char(char digit);
 
+static trace_key_t _trace_key(const std::string& imsi) {
+  imsi64_t imsi64 = 0;
+  IMSI_STRING_TO_IMSI64(imsi.c_str(), &imsi64);
+  return TRACE_KEY_IMSI(imsi64);
+}
+
 static void create_session_response(
     spgw_state_t* state, const std::string& imsi, const std::string& apn,
     itti_sgi_create_end_point_response_t sgi_response,
@@ -47,6 +55,7 @@ static void create_session_response(
   s5_response.sgi_create_endpoint_resp     = sgi_response;
   s5_response.failure_cause                = S5_OK;
 
+  procedure_trace_span_end(_trace_key(imsi), TRACE_STAGE_SESSIOND);
   if (!status.ok()) {
     if ((sgi_response.paa.pdn_type == IPv4) ||
         (sgi_response.paa.pdn_type == IPv4_AND_v6)) {
@@ -136,6 +145,9 @@ void pcef_create_session(
       &sreq);
 
   auto apn = std::string(session_data->apn);
+  // The UE IP address allocation ends with the creation of the session
+  procedure_trace_span_end(_trace_key(imsi_str), TRACE_STAGE_MOBILITYD);
+  procedure_trace_span_start(_trace_key(imsi_str), TRACE_STAGE_SESSIOND);
   // call the `CreateSession` gRPC method and execute the inline function
   magma::PCEFClient::create_session(
       sreq,
@@ -42,7 +42,7 @@ void copy_charging_characteristics(
 
 void convert_proto_msg_to_itti_s6a_auth_info_ans(
     AuthenticationInformationAnswer msg, s6a_auth_info_ans_t* itti_msg) {
-  if (msg.eutran_vectors_size() > MAX_EPS_AUTH_VECTORS) {
+  if (msg.eutran_vectors_size() > MAX_EPS_AUTH_VECTORS_PER_AIR) {
     std::cout << "[ERROR] Number of eutran auth vectors received is:"
               << msg.eutran_vectors_size() << std::endl;
     return;
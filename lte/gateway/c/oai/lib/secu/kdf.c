@@ -17,26 +17,84 @@
 
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
 #include <nettle/hmac.h>
 
+#include "assertions.h"
 #include "security_types.h"
 #include "secu_defs.h"
-#include "dynamic_memory_check.h"
 
 void kdf(
     const uint8_t* key, const unsigned key_len, uint8_t* s,
     const unsigned s_len, uint8_t* out, const unsigned out_len) {
-  struct hmac_sha256_ctx* ctx = calloc(1, sizeof(struct hmac_sha256_ctx));
+  struct hmac_sha256_ctx ctx;
 
-  // memset (&ctx, 0, sizeof (ctx));
-  hmac_sha256_set_key(ctx, key_len, key);
-  hmac_sha256_update(ctx, s_len, s);
-  hmac_sha256_digest(ctx, out_len, out);
-  free_wrapper((void**) &ctx);
+  hmac_sha256_set_key(&ctx, key_len, key);
+  hmac_sha256_update(&ctx, s_len, s);
+  hmac_sha256_digest(&ctx, out_len, out);
+  memset(&ctx, 0, sizeof(ctx));
+}
+
+/*!
+   @brief Key the KDF context with KASME, computing the HMAC-SHA-256 inner and
+   outer states once. Nothing is done if the context is already keyed with this
+   KASME.
+   @param[in] ctx KDF context of the EPS security context
+   @param[in] kasme_32 256 bits KASME
+*/
+void kdf_context_set_key(
+    kdf_context_t* const ctx, const uint8_t* const kasme_32) {
+  DevAssert(ctx != NULL);
+  DevAssert(kasme_32 != NULL);
+
+  if (ctx->ready && !memcmp(ctx->key, kasme_32, KDF_CONTEXT_KEY_SIZE)) {
+    return;
+  }
+  hmac_sha256_set_key(&ctx->hmac, KDF_CONTEXT_KEY_SIZE, kasme_32);
+  memcpy(ctx->key, kasme_32, KDF_CONTEXT_KEY_SIZE);
+  ctx->ready = true;
+}
+
+/*!
+   @brief Wipe the key material held by the KDF context.
+   @param[in] ctx KDF context of the EPS security context
+*/
+void kdf_context_clear(kdf_context_t* const ctx) {
+  DevAssert(ctx != NULL);
+  memset(ctx, 0, sizeof(*ctx));
+}
+
+/*!
+   @brief 3GPP TS 33.220 Annex B.2 KDF keyed with the KASME of the context. The
+   HMAC states are restored by each digest, so the context stays keyed.
+   @param[in] ctx Keyed KDF context
+   @param[in] s Input string S
+   @param[in] s_len Length of S
+   @param[out] out Derived key
+   @param[in] out_len Length of the derived key, at most 32
+*/
+void kdf_with_context(
+    kdf_context_t* const ctx, const uint8_t* const s, const unsigned s_len,
+    uint8_t* const out, const unsigned out_len) {
+  DevAssert(ctx != NULL);
+  DevAssert(ctx->ready);
+
+  hmac_sha256_update(&ctx->hmac, s_len, s);
+  hmac_sha256_digest(&ctx->hmac, out_len, out);
 }
 
 int derive_keNB(
     const uint8_t* kasme_32, const uint32_t nas_count, uint8_t* keNB) {
+  kdf_context_t ctx = {0};
+
+  kdf_context_set_key(&ctx, kasme_32);
+  derive_keNB_with_context(&ctx, nas_count, keNB);
+  kdf_context_clear(&ctx);
+  return 0;
+}
+
+int derive_keNB_with_context(
+    kdf_context_t* const ctx, const uint32_t nas_count, uint8_t* keNB) {
   uint8_t s[7] = {0};
 
   // FC
@@ -49,26 +107,53 @@ int derive_keNB(
   // Length of NAS count
   s[5] = 0x00;
   s[6] = 0x04;
-  kdf(kasme_32, 32, s, 7, keNB, 32);
+  kdf_with_context(ctx, s, 7, keNB, 32);
   return 0;
 }
 
 int derive_NH(
     const uint8_t* kasme_32, const uint8_t* syncInput, uint8_t* next_hop,
     uint8_t* next_hop_chaining_count) {
+  kdf_context_t ctx = {0};
+
+  kdf_context_set_key(&ctx, kasme_32);
+  derive_NH_chain(&ctx, syncInput, 1, next_hop, next_hop_chaining_count);
+  kdf_context_clear(&ctx);
+  return 0;
+}
+
+/*!
+   @brief Derive the next num_hops NH of the chain (3GPP TS 33.401 Annex A.4),
+   each one taking the previous NH as SYNC-input.
+   @param[in] ctx KDF context keyed with KASME
+   @param[in] syncInput SYNC-input of the first NH: KeNB or the current NH
+   @param[in] num_hops Number of NH to derive
+   @param[out] next_hops num_hops consecutive 256 bits NH, the last one being
+   the most recent. May start at syncInput.
+   @param[in,out] next_hop_chaining_count NCC, advanced by num_hops
+*/
+int derive_NH_chain(
+    kdf_context_t* const ctx, const uint8_t* syncInput,
+    const unsigned num_hops, uint8_t* next_hops,
+    uint8_t* next_hop_chaining_count) {
   uint8_t s[35] = {0};
 
   // FC
   s[0] = FC_NH;
-  memcpy(s + 1, syncInput, 32);
   /* length of syncInput */
   s[33] = 0x00;
   s[34] = 0x20;
-  /* update next hop chaining count */
-  *next_hop_chaining_count += 1;
-  if (*next_hop_chaining_count >= 8) {
-    *next_hop_chaining_count = 0;
+  for (unsigned i = 0; i < num_hops; i++) {
+    memcpy(s + 1, syncInput, 32);
+    kdf_with_context(ctx, s, 35, next_hops, 32);
+    syncInput = next_hops;
+    next_hops += 32;
+    /* update next hop chaining count */
+    *next_hop_chaining_count += 1;
+    if (*next_hop_chaining_count >= 8) {
+      *next_hop_chaining_count = 0;
+    }
   }
-  kdf(kasme_32, 32, s, 35, next_hop, 32);
+  memset(s, 0, sizeof(s));
   return 0;
 }
@@ -38,6 +38,21 @@
 int derive_key_nas(
     algorithm_type_dist_t nas_alg_type, uint8_t nas_enc_alg_id,
     const uint8_t* kasme_32, uint8_t* knas) {
+  kdf_context_t ctx = {0};
+
+  kdf_context_set_key(&ctx, kasme_32);
+  derive_key_nas_with_context(&ctx, nas_alg_type, nas_enc_alg_id, knas);
+  kdf_context_clear(&ctx);
+  return 0;
+}
+
+/*!
+   @brief Same as derive_key_nas(), from a KDF context already keyed with
+   kasme.
+*/
+int derive_key_nas_with_context(
+    kdf_context_t* const ctx, algorithm_type_dist_t nas_alg_type,
+    uint8_t nas_enc_alg_id, uint8_t* knas) {
   uint8_t s[7]    = {0};
   uint8_t out[32] = {0};
 
@@ -66,8 +81,8 @@ int derive_key_nas(
   // OAILOG_TRACE (LOG_NAS, "FC %d nas_alg_type distinguisher %d
   // nas_enc_alg_identity %d\n", FC_ALG_KEY_DER, nas_alg_type, nas_enc_alg_id);
   // OAILOG_STREAM_HEX(OAILOG_LEVEL_TRACE, LOG_NAS, "s:", s, 7);
-  // OAILOG_STREAM_HEX(OAILOG_LEVEL_TRACE, LOG_NAS, "kasme_32:", kasme_32, 32);
-  kdf(kasme_32, 32, &s[0], 7, &out[0], 32);
+  // OAILOG_STREAM_HEX(OAILOG_LEVEL_TRACE, LOG_NAS, "kasme_32:", ctx->key, 32);
+  kdf_with_context(ctx, &s[0], 7, &out[0], 32);
   memcpy(knas, &out[31 - 16 + 1], 16);
   return 0;
 }
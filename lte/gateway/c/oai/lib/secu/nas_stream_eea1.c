@@ -24,45 +24,45 @@
 #include "conversions.h"
 #include "secu_defs.h"
 #include "snow3g.h"
-#include "dynamic_memory_check.h"
 
+/* Number of keystream words generated at once on the stack */
+#define EEA1_KS_CHUNK_WORDS 16
+
+/*!
+   @brief 128-EEA1 ciphering of a NAS message. The keystream is generated in
+   chunks on the stack and the message is left untouched.
+   @param[in] stream_cipher Structure containing various variables to setup
+   encoding
+   @param[out] out Ciphered (or deciphered) message, may be the same buffer as
+   stream_cipher->message
+*/
 int nas_stream_encrypt_eea1(
     nas_stream_cipher_t* const stream_cipher, uint8_t* const out) {
   snow_3g_context_t snow_3g_context;
-  int n;
-  int i             = 0;
-  uint32_t zero_bit = 0;
-  // uint32_t                                byte_length;
-  uint32_t* KS;
+  uint32_t KS[EEA1_KS_CHUNK_WORDS];
   uint32_t K[4], IV[4];
+  uint32_t zero_bit    = 0;
+  uint32_t byte_length = 0;
+  uint32_t offset      = 0;
 
   DevAssert(stream_cipher != NULL);
   DevAssert(stream_cipher->key != NULL);
   DevAssert(stream_cipher->key_length == 16);
   DevAssert(out != NULL);
-  n        = (stream_cipher->blength + 31) / 32;
-  zero_bit = stream_cipher->blength & 0x7;
-  // byte_length = stream_cipher->blength >> 3;
-  memset(&snow_3g_context, 0, sizeof(snow_3g_context));
+  zero_bit    = stream_cipher->blength & 0x7;
+  byte_length = (stream_cipher->blength + 7) >> 3;
   /*
    * Initialisation
    */
   /*
    * Load the confidentiality key for SNOW 3G initialization as in section
-   * 3.4.
+   * 3.4: K[3] = key[0]||key[1]||...||key[31], with key[0] the most significant
+   * bit of key, down to K[0] = key[96]||key[97]||...||key[127]
    */
-  memcpy(
-      K + 3, stream_cipher->key + 0,
-      4);                                   /*K[3] = key[0]; we assume
-                                             * K[3]=key[0]||key[1]||...||key[31] , with key[0] the
-                                             * * * * most important bit of key */
-  memcpy(K + 2, stream_cipher->key + 4, 4); /*K[2] = key[1]; */
-  memcpy(K + 1, stream_cipher->key + 8, 4); /*K[1] = key[2]; */
-  memcpy(
-      K + 0, stream_cipher->key + 12,
-      4); /*K[0] = key[3]; we assume
-           * K[0]=key[96]||key[97]||...||key[127] , with key[127] the
-           * * * * least important bit of key */
+  memcpy(K + 3, stream_cipher->key + 0, 4);
+  memcpy(K + 2, stream_cipher->key + 4, 4);
+  memcpy(K + 1, stream_cipher->key + 8, 4);
+  memcpy(K + 0, stream_cipher->key + 12, 4);
   K[3] = hton_int32(K[3]);
   K[2] = hton_int32(K[2]);
   K[1] = hton_int32(K[1]);
@@ -78,42 +78,29 @@ int nas_stream_encrypt_eea1(
   IV[1] = IV[3];
   IV[0] = IV[2];
   /*
-   * Run SNOW 3G algorithm to generate sequence of key stream bits KS
+   * Run SNOW 3G algorithm to generate sequence of key stream bits KS and
+   * exclusive-OR the input data with it to generate the output bit stream
    */
   snow3g_initialize(K, IV, &snow_3g_context);
-  KS = (uint32_t*) calloc(1, 4 * n);
-  snow3g_generate_key_stream(n, (uint32_t*) KS, &snow_3g_context);
 
-  if (zero_bit > 0) {
-    KS[n - 1] = KS[n - 1] & (uint32_t)(0xFFFFFFFF << (8 - zero_bit));
-  }
+  while (offset < byte_length) {
+    uint32_t chunk_length = byte_length - offset;
+    uint32_t n            = 0;
 
-  for (i = 0; i < n; i++) {
-    KS[i] = hton_int32(KS[i]);
-  }
+    if (chunk_length > sizeof(KS)) chunk_length = sizeof(KS);
+    n = (chunk_length + 3) >> 2;
+    snow3g_generate_key_stream(n, KS, &snow_3g_context);
 
-  /*
-   * Exclusive-OR the input data with keystream to generate the output bit
-   * stream
-   */
-  for (i = 0; i < n * 4; i++) {
-    stream_cipher->message[i] ^= *(((uint8_t*) KS) + i);
+    for (uint32_t i = 0; i < chunk_length; i++) {
+      out[offset + i] = stream_cipher->message[offset + i] ^
+                        (uint8_t)(KS[i >> 2] >> (24 - ((i & 0x3) << 3)));
+    }
+    offset += chunk_length;
   }
 
-  int ceil_index = 0;
-
-  if (zero_bit > 0) {
-    ceil_index = (stream_cipher->blength + 7) >> 3;
-    stream_cipher->message[ceil_index - 1] =
-        stream_cipher->message[ceil_index - 1] &
-        (uint8_t)(0xFF << (8 - zero_bit));
-  }
-
-  free_wrapper((void**) &KS);
-  memcpy(out, stream_cipher->message, n * 4);
-
   if (zero_bit > 0) {
-    out[ceil_index - 1] = stream_cipher->message[ceil_index - 1];
+    out[byte_length - 1] =
+        out[byte_length - 1] & (uint8_t)(0xFF << (8 - zero_bit));
   }
 
   return 0;
@@ -25,47 +25,69 @@
 #include "assertions.h"
 #include "conversions.h"
 #include "secu_defs.h"
-#include "dynamic_memory_check.h"
 
-int nas_stream_encrypt_eea2(
+/*!
+   @brief 128-EEA2 ciphering of a NAS message with the AES key schedule kept in
+   the key cache, without heap allocation.
+   @param[in] cache Key cache of the EPS security context, re-keyed if it does
+   not hold the schedule of stream_cipher->key
+   @param[in] stream_cipher Structure containing various variables to setup
+   encoding
+   @param[out] out Ciphered (or deciphered) message, may be the same buffer as
+   stream_cipher->message
+*/
+int nas_stream_encrypt_eea2_cached(
+    nas_stream_key_cache_t* const cache,
     nas_stream_cipher_t* const stream_cipher, uint8_t* const out) {
-  uint8_t m[16];
+  uint8_t m[NAS_STREAM_BLOCK_SIZE] = {0};
   uint32_t local_count;
-  void* ctx;
-  uint8_t* data;
   uint32_t zero_bit = 0;
   uint32_t byte_length;
 
+  DevAssert(cache != NULL);
   DevAssert(stream_cipher != NULL);
+  DevAssert(stream_cipher->key != NULL);
+  DevAssert(stream_cipher->key_length == NAS_STREAM_KEY_SIZE);
   DevAssert(out != NULL);
   zero_bit    = stream_cipher->blength & 0x7;
   byte_length = stream_cipher->blength >> 3;
 
   if (zero_bit > 0) byte_length += 1;
 
-  ctx         = malloc(nettle_aes128.context_size);
-  data        = calloc(1, byte_length);
+  nas_stream_key_cache_set_eea2_key(cache, stream_cipher->key);
+
   local_count = hton_int32(stream_cipher->count);
-  memset(m, 0, sizeof(m));
   memcpy(&m[0], &local_count, 4);
   m[4] = ((stream_cipher->bearer & 0x1F) << 3) |
          ((stream_cipher->direction & 0x01) << 2);
   /*
    * Other bits are 0
    */
-  nettle_aes128.set_encrypt_key(
-      ctx, stream_cipher->key_length, stream_cipher->key);
-
   nettle_ctr_crypt(
-      ctx, nettle_aes128.encrypt, nettle_aes128.block_size, m, byte_length,
-      data, stream_cipher->message);
+      &cache->eea2_aes, (nettle_cipher_func*) aes128_encrypt,
+      NAS_STREAM_BLOCK_SIZE, m, byte_length, out, stream_cipher->message);
 
   if (zero_bit > 0)
-    data[byte_length - 1] =
-        data[byte_length - 1] & (uint8_t)(0xFF << (8 - zero_bit));
+    out[byte_length - 1] =
+        out[byte_length - 1] & (uint8_t)(0xFF << (8 - zero_bit));
 
-  memcpy(out, data, byte_length);
-  free_wrapper((void**) &data);
-  free_wrapper((void**) &ctx);
   return 0;
 }
+
+/*!
+   @brief 128-EEA2 ciphering of a NAS message with a one-time key schedule.
+   Prefer nas_stream_encrypt_eea2_cached() when a security context is at hand.
+   @param[in] stream_cipher Structure containing various variables to setup
+   encoding
+   @param[out] out Ciphered (or deciphered) message
+*/
+int nas_stream_encrypt_eea2(
+    nas_stream_cipher_t* const stream_cipher, uint8_t* const out) {
+  nas_stream_key_cache_t cache = {0};
+  int rc                       = 0;
+
+  rc = nas_stream_encrypt_eea2_cached(&cache, stream_cipher, out);
+
+  nas_stream_key_cache_clear(&cache);
+  return rc;
+}
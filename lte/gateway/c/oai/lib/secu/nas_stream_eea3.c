@@ -0,0 +1,87 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "assertions.h"
+#include "secu_defs.h"
+#include "zuc.h"
+
+/* Number of keystream words generated at once on the stack */
+#define EEA3_KS_CHUNK_WORDS 16
+
+/*!
+   @brief 128-EEA3 ciphering of a NAS message, see Specification of the 3GPP
+   Confidentiality and Integrity Algorithms 128-EEA3 & 128-EIA3. Document 1:
+   128-EEA3 and 128-EIA3 Specification, section 3.
+   @param[in] stream_cipher Structure containing various variables to setup
+   encoding
+   @param[out] out Ciphered (or deciphered) message, may be the same buffer as
+   stream_cipher->message
+*/
+int nas_stream_encrypt_eea3(
+    nas_stream_cipher_t* const stream_cipher, uint8_t* const out) {
+  zuc_context_t zuc_context;
+  uint32_t KS[EEA3_KS_CHUNK_WORDS];
+  uint8_t IV[16]       = {0};
+  uint32_t zero_bit    = 0;
+  uint32_t byte_length = 0;
+  uint32_t offset      = 0;
+
+  DevAssert(stream_cipher != NULL);
+  DevAssert(stream_cipher->key != NULL);
+  DevAssert(stream_cipher->key_length == 16);
+  DevAssert(out != NULL);
+  zero_bit    = stream_cipher->blength & 0x7;
+  byte_length = (stream_cipher->blength + 7) >> 3;
+  /*
+   * IV = COUNT || BEARER || DIRECTION || 0^26, twice (section 3.3)
+   */
+  IV[0] = (uint8_t)(stream_cipher->count >> 24);
+  IV[1] = (uint8_t)(stream_cipher->count >> 16);
+  IV[2] = (uint8_t)(stream_cipher->count >> 8);
+  IV[3] = (uint8_t)(stream_cipher->count);
+  IV[4] = ((stream_cipher->bearer & 0x1F) << 3) |
+          ((stream_cipher->direction & 0x01) << 2);
+  memcpy(&IV[8], &IV[0], 8);
+
+  zuc_initialize(stream_cipher->key, IV, &zuc_context);
+
+  while (offset < byte_length) {
+    uint32_t chunk_length = byte_length - offset;
+    uint32_t n            = 0;
+
+    if (chunk_length > sizeof(KS)) chunk_length = sizeof(KS);
+    n = (chunk_length + 3) >> 2;
+    zuc_generate_key_stream(n, KS, &zuc_context);
+
+    for (uint32_t i = 0; i < chunk_length; i++) {
+      out[offset + i] = stream_cipher->message[offset + i] ^
+                        (uint8_t)(KS[i >> 2] >> (24 - ((i & 0x3) << 3)));
+    }
+    offset += chunk_length;
+  }
+
+  if (zero_bit > 0) {
+    out[byte_length - 1] =
+        out[byte_length - 1] & (uint8_t)(0xFF << (8 - zero_bit));
+  }
+
+  return 0;
+}
@@ -17,7 +17,6 @@
 
 #include <stdint.h>
 #include <string.h>
-#include <math.h>  // double ceil(double x);
 
 #include "secu_defs.h"
 #include "conversions.h"
@@ -36,8 +35,6 @@ int nas_stream_encrypt_eia1(
    Input V: a 64-bit input.
    Input c: a 64-bit input.
    Output : a 64-bit output.
-   A 64-bit memory is allocated which is to be free_wrapperd by the calling
-   function.
    See section 4.3.2 for details.
 */
 uint64_t MUL64x(uint64_t V, uint64_t c) {
@@ -52,15 +49,11 @@ uint64_t MUL64x(uint64_t V, uint64_t c) {
    Input i: a positive integer.
    Input c: a 64-bit input.
    Output : a 64-bit output.
-   A 64-bit memory is allocated which is to be free_wrapperd by the calling
-  function.
    See section 4.3.3 for details.
 */
 uint64_t MUL64xPOW(uint64_t V, uint32_t i, uint64_t c) {
-  if (i == 0)
-    return V;
-  else
-    return MUL64x(MUL64xPOW(V, i - 1, c), c);
+  while (i-- > 0) V = MUL64x(V, c);
+  return V;
 }
 
 /* MUL64.
@@ -68,34 +61,62 @@ uint64_t MUL64xPOW(uint64_t V, uint32_t i, uint64_t c) {
    Input P: a 64-bit input.
    Input c: a 64-bit input.
    Output : a 64-bit output.
-   A 64-bit memory is allocated which is to be free_wrapperd by the calling
-   function.
-   See section 4.3.4 for details.
+   See section 4.3.4 for details. V.x^i is obtained from V.x^(i-1) instead of
+   being recomputed from V for each bit of P.
 */
 uint64_t MUL64(uint64_t V, uint64_t P, uint64_t c) {
   uint64_t result = 0;
   int i           = 0;
 
   for (i = 0; i < 64; i++) {
-    if ((P >> i) & 0x1) result ^= MUL64xPOW(V, i, c);
+    if ((P >> i) & 0x1) result ^= V;
+    V = MUL64x(V, c);
   }
 
   return result;
 }
 
-/* mask32bit.
-  Input n: an integer in 1-32.
-  Output : a 32 bit mask.
-  Prepares a 32 bit mask with required number of 1 bits on the MSB side.
+/* Multiplication by a fixed P.
+   Input V: a 64-bit input.
+   Input P_pow: P.x^i for 0 <= i < 64, see _eia1_mul_table().
+   Output : V.P, as MUL64(V, P, c) does, in one XOR per set bit of V.
 */
-uint32_t mask32bit(int n) {
-  uint32_t mask = 0x0;
+static uint64_t _eia1_mul(uint64_t V, const uint64_t P_pow[64]) {
+  uint64_t result = 0;
 
-  if (n % 32 == 0) return 0xffffffff;
+  while (V) {
+    int i = __builtin_ctzll(V);
+
+    result ^= P_pow[i];
+    V &= V - 1;
+  }
+  return result;
+}
 
-  while (n--) mask = (mask >> 1) ^ 0x80000000;
+static void _eia1_mul_table(uint64_t P, uint64_t c, uint64_t P_pow[64]) {
+  for (int i = 0; i < 64; i++) {
+    P_pow[i] = P;
+    P        = MUL64x(P, c);
+  }
+}
 
-  return mask;
+/* Load the 64-bit block i of the message, as a big endian word, without
+   reading past the last byte of the message and with the bits beyond
+   blength set to 0.
+*/
+static uint64_t _eia1_message_block(
+    const uint8_t* const message, uint32_t blength, uint32_t i) {
+  uint64_t block       = 0;
+  uint32_t byte_length = (blength + 7) >> 3;
+
+  for (uint32_t j = 0; j < 8; j++) {
+    block <<= 8;
+    if (8 * i + j < byte_length) block |= message[8 * i + j];
+  }
+  if (64 * (i + 1) > blength) {
+    block &= ~(0xFFFFFFFFFFFFFFFFULL >> (blength - 64 * i));
+  }
+  return block;
 }
 
 /*!
@@ -108,36 +129,23 @@ int nas_stream_encrypt_eia1(
     nas_stream_cipher_t* const stream_cipher, uint8_t const out[4]) {
   snow_3g_context_t snow_3g_context;
   uint32_t K[4], IV[4], z[5];
-  int i          = 0, D;
+  uint32_t i     = 0, D;
   uint32_t MAC_I = 0;
   uint64_t EVAL;
-  uint64_t V;
   uint64_t P;
   uint64_t Q;
   uint64_t c;
-  uint64_t M_D_2;
-  int rem_bits;
-  uint32_t mask = 0;
-  uint32_t* message;
-
-  message =
-      (uint32_t*)
-          stream_cipher->message; /* To operate 32 bit message internally. */
+  uint64_t P_pow[64];
+
   /*
-   * Load the Integrity Key for SNOW3G initialization as in section 4.4.
+   * Load the Integrity Key for SNOW3G initialization as in section 4.4:
+   * K[3] = key[0]||key[1]||...||key[31], with key[0] the most significant bit
+   * of key, down to K[0] = key[96]||key[97]||...||key[127]
    */
-  memcpy(
-      K + 3, stream_cipher->key + 0,
-      4);                                   /*K[3] = key[0]; we assume
-                                             * K[3]=key[0]||key[1]||...||key[31] , with key[0] the
-                                             * * * * most important bit of key */
-  memcpy(K + 2, stream_cipher->key + 4, 4); /*K[2] = key[1]; */
-  memcpy(K + 1, stream_cipher->key + 8, 4); /*K[1] = key[2]; */
-  memcpy(
-      K + 0, stream_cipher->key + 12,
-      4); /*K[0] = key[3]; we assume
-           * K[0]=key[96]||key[97]||...||key[127] , with key[127] the
-           * * * * least important bit of key */
+  memcpy(K + 3, stream_cipher->key + 0, 4);
+  memcpy(K + 2, stream_cipher->key + 4, 4);
+  memcpy(K + 1, stream_cipher->key + 8, 4);
+  memcpy(K + 0, stream_cipher->key + 12, 4);
   K[3] = hton_int32(K[3]);
   K[2] = hton_int32(K[2]);
   K[1] = hton_int32(K[1]);
@@ -152,70 +160,32 @@ int nas_stream_encrypt_eia1(
           ((uint32_t)(stream_cipher->direction) << 31);
   IV[0] = ((((uint32_t) stream_cipher->bearer) & 0x0000001F) << 27) ^
           ((uint32_t)(stream_cipher->direction & 0x00000001) << 15);
-  // printf ("K:\n");
-  // hexprint(K, 16);
-  // printf ("K[0]:%08X\n",K[0]);
-  // printf ("K[1]:%08X\n",K[1]);
-  // printf ("K[2]:%08X\n",K[2]);
-  // printf ("K[3]:%08X\n",K[3]);
-  // printf ("IV:\n");
-  // hexprint(IV, 16);
-  // printf ("IV[0]:%08X\n",IV[0]);
-  // printf ("IV[1]:%08X\n",IV[1]);
-  // printf ("IV[2]:%08X\n",IV[2]);
-  // printf ("IV[3]:%08X\n",IV[3]);
   z[0] = z[1] = z[2] = z[3] = z[4] = 0;
   /*
    * Run SNOW 3G to produce 5 keystream words z_1, z_2, z_3, z_4 and z_5.
    */
   snow3g_initialize(K, IV, &snow_3g_context);
   snow3g_generate_key_stream(5, z, &snow_3g_context);
-  // printf ("z[0]:%08X\n",z[0]);
-  // printf ("z[1]:%08X\n",z[1]);
-  // printf ("z[2]:%08X\n",z[2]);
-  // printf ("z[3]:%08X\n",z[3]);
-  // printf ("z[4]:%08X\n",z[4]);
   P = ((uint64_t) z[0] << 32) | (uint64_t) z[1];
   Q = ((uint64_t) z[2] << 32) | (uint64_t) z[3];
-  // printf ("P:%16lX\n",P);
-  // printf ("Q:%16lX\n",Q);
   /*
    * Calculation
    */
-  D = ceil(stream_cipher->blength / 64.0) + 1;
-  // printf ("D:%d\n",D);
+  D    = ((stream_cipher->blength + 63) / 64) + 1;
   EVAL = 0;
   c    = 0x1b;
+  _eia1_mul_table(P, c, P_pow);
 
   /*
-   * for 0 <= i <= D-3
-   */
-  for (i = 0; i < D - 2; i++) {
-    V    = EVAL ^ ((uint64_t) hton_int32(message[2 * i]) << 32 |
-                (uint64_t) hton_int32(message[2 * i + 1]));
-    EVAL = MUL64(V, P, c);
-    // printf ("Mi: %16X %16X\tEVAL:
-    // %16lX\n",hton_int32(message[2*i]),hton_int32(message[2*i+1]), EVAL);
-  }
-
-  /*
-   * for D-2
+   * for 0 <= i <= D-2, the last block being padded with 0 bits
    */
-  rem_bits = stream_cipher->blength % 64;
-
-  if (rem_bits == 0) rem_bits = 64;
-
-  mask = mask32bit(rem_bits % 32);
-
-  if (rem_bits > 32) {
-    M_D_2 = ((uint64_t) hton_int32(message[2 * (D - 2)]) << 32) |
-            (uint64_t)(hton_int32(message[2 * (D - 2) + 1]) & mask);
-  } else {
-    M_D_2 = ((uint64_t) hton_int32(message[2 * (D - 2)]) & mask) << 32;
+  for (i = 0; i + 1 < D; i++) {
+    EVAL = _eia1_mul(
+        EVAL ^ _eia1_message_block(
+                   stream_cipher->message, stream_cipher->blength, i),
+        P_pow);
   }
 
-  V    = EVAL ^ M_D_2;
-  EVAL = MUL64(V, P, c);
   /*
    * for D-1
    */
@@ -225,7 +195,6 @@ int nas_stream_encrypt_eia1(
    */
   EVAL  = MUL64(EVAL, Q, c);
   MAC_I = (uint32_t)(EVAL >> 32) ^ z[4];
-  // printf ("MAC_I:%16X\n",MAC_I);
   MAC_I = hton_int32(MAC_I);
   memcpy((void*) out, &MAC_I, 4);
   return 0;
@@ -19,67 +19,120 @@
 #include <stdio.h>
 #include <stdint.h>
 #include <string.h>
-#include <openssl/cmac.h>
-#include <openssl/evp.h>
-#include <openssl/ossl_typ.h>
+#include <nettle/aes.h>
 
 #include "secu_defs.h"
 #include "assertions.h"
 #include "conversions.h"
-#include "dynamic_memory_check.h"
 #include "log.h"
 
 /*!
-   @brief Create integrity cmac t for a given message.
+   @brief Copy len bytes at offset of the EIA2 input M = COUNT || BEARER ||
+   DIRECTION || 0^26 || MESSAGE, without building M in memory.
+*/
+static void _eia2_fetch(
+    uint8_t* dst, const uint8_t header[8], const uint8_t* const message,
+    uint32_t offset, uint32_t len) {
+  while ((len > 0) && (offset < 8)) {
+    *dst++ = header[offset++];
+    len--;
+  }
+  if (len > 0) memcpy(dst, &message[offset - 8], len);
+}
+
+/*!
+   @brief Create integrity cmac t for a given message with the AES key schedule
+   and CMAC subkeys kept in the key cache, without heap allocation.
+   @param[in] cache Key cache of the EPS security context, re-keyed if it does
+   not hold the schedule of stream_cipher->key
    @param[in] stream_cipher Structure containing various variables to setup
    encoding
    @param[out] out For EIA2 the output string is 32 bits long
 */
-int nas_stream_encrypt_eia2(
+int nas_stream_encrypt_eia2_cached(
+    nas_stream_key_cache_t* const cache,
     nas_stream_cipher_t* const stream_cipher, uint8_t const out[4]) {
-  uint8_t* m               = NULL;
-  uint32_t local_count     = 0;
-  size_t size              = 4;
-  uint8_t data[16]         = {0};
-  CMAC_CTX* cmac_ctx       = NULL;
-  const EVP_CIPHER* cipher = EVP_aes_128_cbc();
-  uint32_t zero_bit        = 0;
-  uint32_t m_length;
+  uint8_t header[8]                    = {0};
+  uint8_t block[NAS_STREAM_BLOCK_SIZE] = {0};
+  uint8_t x[NAS_STREAM_BLOCK_SIZE]     = {0};
+  uint32_t local_count                 = 0;
+  uint32_t zero_bit                    = 0;
+  uint32_t m_length                    = 0;
+  uint32_t total_length                = 0;
+  uint32_t offset                      = 0;
+  uint32_t last_length                 = 0;
+  const uint8_t* subkey                = NULL;
 
+  DevAssert(cache != NULL);
   DevAssert(stream_cipher != NULL);
   DevAssert(stream_cipher->key != NULL);
-  DevAssert(stream_cipher->key_length > 0);
+  DevAssert(stream_cipher->key_length == NAS_STREAM_KEY_SIZE);
   DevAssert(out != NULL);
   zero_bit = stream_cipher->blength & 0x7;
   m_length = stream_cipher->blength >> 3;
 
   if (zero_bit > 0) m_length += 1;
 
+  nas_stream_key_cache_set_eia2_key(cache, stream_cipher->key);
+
   local_count = hton_int32(stream_cipher->count);
-  m           = calloc(1, m_length + 8);
-  memcpy(&m[0], &local_count, 4);
-  m[4] = ((stream_cipher->bearer & 0x1F) << 3) |
-         ((stream_cipher->direction & 0x01) << 2);
-  memcpy(&m[8], stream_cipher->message, m_length);
+  memcpy(&header[0], &local_count, 4);
+  header[4] = ((stream_cipher->bearer & 0x1F) << 3) |
+              ((stream_cipher->direction & 0x01) << 2);
+  total_length = m_length + 8;
 
   OAILOG_TRACE(
-      LOG_NAS, "Byte length: %u, Zero bits: %u:\n", m_length + 8, zero_bit);
-  OAILOG_STREAM_HEX(OAILOG_LEVEL_TRACE, LOG_NAS, "m:", m, m_length + 8);
-  OAILOG_STREAM_HEX(
-      OAILOG_LEVEL_TRACE, LOG_NAS, "Key:", stream_cipher->key,
-      stream_cipher->key_length);
+      LOG_NAS, "Byte length: %u, Zero bits: %u:\n", total_length, zero_bit);
   OAILOG_STREAM_HEX(
       OAILOG_LEVEL_TRACE, LOG_NAS, "Message:", stream_cipher->message,
       m_length);
 
-  cmac_ctx = CMAC_CTX_new();
-  CMAC_Init(
-      cmac_ctx, stream_cipher->key, stream_cipher->key_length, cipher, NULL);
-  CMAC_Update(cmac_ctx, m, m_length + 8);
-  CMAC_Final(cmac_ctx, data, &size);
-  CMAC_CTX_free(cmac_ctx);
-  OAILOG_STREAM_HEX(OAILOG_LEVEL_TRACE, LOG_NAS, "Out:", data, size);
-  memcpy((void*) out, data, 4);
-  free_wrapper((void**) &m);
+  /*
+   * AES-CMAC (RFC 4493) over M: all complete blocks but the last one are
+   * chained with AES-CBC, the last one is XORed with subkey K1 if complete,
+   * or padded and XORed with subkey K2 otherwise.
+   */
+  for (offset = 0; total_length - offset > NAS_STREAM_BLOCK_SIZE;
+       offset += NAS_STREAM_BLOCK_SIZE) {
+    _eia2_fetch(
+        block, header, stream_cipher->message, offset, NAS_STREAM_BLOCK_SIZE);
+    for (int i = 0; i < NAS_STREAM_BLOCK_SIZE; i++) x[i] ^= block[i];
+    aes128_encrypt(&cache->eia2_aes, NAS_STREAM_BLOCK_SIZE, x, x);
+  }
+  last_length = total_length - offset;
+  memset(block, 0, sizeof(block));
+  _eia2_fetch(block, header, stream_cipher->message, offset, last_length);
+  if (last_length == NAS_STREAM_BLOCK_SIZE) {
+    subkey = cache->eia2_k1;
+  } else {
+    block[last_length] = 0x80;
+    subkey             = cache->eia2_k2;
+  }
+  for (int i = 0; i < NAS_STREAM_BLOCK_SIZE; i++) {
+    x[i] ^= block[i] ^ subkey[i];
+  }
+  aes128_encrypt(&cache->eia2_aes, NAS_STREAM_BLOCK_SIZE, x, x);
+
+  OAILOG_STREAM_HEX(OAILOG_LEVEL_TRACE, LOG_NAS, "Out:", x, 4);
+  memcpy((void*) out, x, 4);
   return 0;
 }
+
+/*!
+   @brief Create integrity cmac t for a given message with a one-time key
+   schedule. Prefer nas_stream_encrypt_eia2_cached() when a security context is
+   at hand.
+   @param[in] stream_cipher Structure containing various variables to setup
+   encoding
+   @param[out] out For EIA2 the output string is 32 bits long
+*/
+int nas_stream_encrypt_eia2(
+    nas_stream_cipher_t* const stream_cipher, uint8_t const out[4]) {
+  nas_stream_key_cache_t cache = {0};
+  int rc                       = 0;
+
+  rc = nas_stream_encrypt_eia2_cached(&cache, stream_cipher, out);
+
+  nas_stream_key_cache_clear(&cache);
+  return rc;
+}
@@ -0,0 +1,119 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "assertions.h"
+#include "secu_defs.h"
+#include "zuc.h"
+
+/* 32 bits of keystream starting at bit b (0 <= b < 32) of z0 || z1 */
+static inline uint32_t _eia3_key_word(uint32_t z0, uint32_t z1, uint32_t b) {
+  return b ? ((z0 << b) | (z1 >> (32 - b))) : z0;
+}
+
+/*!
+   @brief Create integrity cmac t for a given message with 128-EIA3, see
+   Specification of the 3GPP Confidentiality and Integrity Algorithms 128-EEA3
+   & 128-EIA3. Document 1: 128-EEA3 and 128-EIA3 Specification, section 4.
+   The keystream is produced word by word while the message is consumed, so
+   nothing is allocated whatever the message length.
+   @param[in] stream_cipher Structure containing various variables to setup
+   encoding
+   @param[out] out For EIA3 the output string is 32 bits long
+*/
+int nas_stream_encrypt_eia3(
+    nas_stream_cipher_t* const stream_cipher, uint8_t const out[4]) {
+  zuc_context_t zuc_context;
+  uint8_t IV[16]       = {0};
+  uint32_t z0          = 0;
+  uint32_t z1          = 0;
+  uint32_t T           = 0;
+  uint32_t z_length    = 0;
+  uint32_t byte_length = 0;
+  uint32_t MAC_I       = 0;
+
+  DevAssert(stream_cipher != NULL);
+  DevAssert(stream_cipher->key != NULL);
+  DevAssert(stream_cipher->key_length == 16);
+  DevAssert(out != NULL);
+  byte_length = (stream_cipher->blength + 7) >> 3;
+  /*
+   * IV, section 4.3
+   */
+  IV[0]  = (uint8_t)(stream_cipher->count >> 24);
+  IV[1]  = (uint8_t)(stream_cipher->count >> 16);
+  IV[2]  = (uint8_t)(stream_cipher->count >> 8);
+  IV[3]  = (uint8_t)(stream_cipher->count);
+  IV[4]  = (stream_cipher->bearer & 0x1F) << 3;
+  IV[8]  = IV[0] ^ ((stream_cipher->direction & 0x01) << 7);
+  IV[9]  = IV[1];
+  IV[10] = IV[2];
+  IV[11] = IV[3];
+  IV[12] = IV[4];
+  IV[14] = (stream_cipher->direction & 0x01) << 7;
+
+  zuc_initialize(stream_cipher->key, IV, &zuc_context);
+  zuc_generate_key_stream(1, &z0, &zuc_context);
+  zuc_generate_key_stream(1, &z1, &zuc_context);
+  z_length = z0;
+
+  /*
+   * T is the XOR of the keystream words z_i for every bit i set in the
+   * message; z0 || z1 hold the keystream from bit 32 * w onwards
+   */
+  for (uint32_t w = 0; 32 * w < stream_cipher->blength; w++) {
+    uint32_t bits = stream_cipher->blength - 32 * w;
+    uint32_t m    = 0;
+
+    if (bits > 32) bits = 32;
+    for (uint32_t j = 0; j < 4; j++) {
+      m <<= 8;
+      if (4 * w + j < byte_length) m |= stream_cipher->message[4 * w + j];
+    }
+    if (bits < 32) m &= ~(0xFFFFFFFF >> bits);
+
+    while (m) {
+      uint32_t b = __builtin_clz(m);
+
+      T ^= _eia3_key_word(z0, z1, b);
+      m &= ~(0x80000000 >> b);
+    }
+
+    if (32 * w + bits == stream_cipher->blength) {
+      z_length = (bits == 32) ? z1 : _eia3_key_word(z0, z1, bits);
+    }
+    z0 = z1;
+    zuc_generate_key_stream(1, &z1, &zuc_context);
+  }
+
+  /*
+   * T = T xor z_LENGTH, MAC = T xor z_32(L-1), L = ceil(LENGTH / 32) + 2
+   */
+  T ^= z_length;
+  MAC_I = T ^ z1;
+  {
+    uint8_t* mac = (uint8_t*) out;
+
+    mac[0] = (uint8_t)(MAC_I >> 24);
+    mac[1] = (uint8_t)(MAC_I >> 16);
+    mac[2] = (uint8_t)(MAC_I >> 8);
+    mac[3] = (uint8_t)(MAC_I);
+  }
+  return 0;
+}
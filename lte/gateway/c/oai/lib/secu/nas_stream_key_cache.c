@@ -0,0 +1,113 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <nettle/aes.h>
+
+#include "assertions.h"
+#include "secu_defs.h"
+
+/*!
+   @brief Derive an AES-CMAC subkey (RFC 4493 section 2.3): shift the input
+   left by one bit and conditionally XOR the result with Rb.
+   @param[in] in 128 bits block
+   @param[out] out 128 bits subkey
+*/
+static void _cmac_derive_subkey(
+    const uint8_t in[NAS_STREAM_BLOCK_SIZE],
+    uint8_t out[NAS_STREAM_BLOCK_SIZE]) {
+  const uint8_t msb = in[0] & 0x80;
+
+  for (int i = 0; i < NAS_STREAM_BLOCK_SIZE; i++) {
+    out[i] = (uint8_t)(in[i] << 1);
+    if (i < NAS_STREAM_BLOCK_SIZE - 1) out[i] |= in[i + 1] >> 7;
+  }
+  if (msb) out[NAS_STREAM_BLOCK_SIZE - 1] ^= 0x87;
+}
+
+/*!
+   @brief Expand KNASenc into the AES key schedule used by 128-EEA2. Nothing is
+   done if the cache already holds the schedule of this key.
+   @param[in] cache Key cache of the EPS security context
+   @param[in] knas_enc 128 bits NAS ciphering key
+*/
+void nas_stream_key_cache_set_eea2_key(
+    nas_stream_key_cache_t* const cache, const uint8_t* const knas_enc) {
+  DevAssert(cache != NULL);
+  DevAssert(knas_enc != NULL);
+
+  if (cache->eea2_ready &&
+      !memcmp(cache->eea2_key, knas_enc, NAS_STREAM_KEY_SIZE)) {
+    return;
+  }
+  aes128_set_encrypt_key(&cache->eea2_aes, knas_enc);
+  memcpy(cache->eea2_key, knas_enc, NAS_STREAM_KEY_SIZE);
+  cache->eea2_ready = true;
+}
+
+/*!
+   @brief Expand KNASint into the AES key schedule and CMAC subkeys K1, K2
+   used by 128-EIA2. Nothing is done if the cache already holds the schedule of
+   this key.
+   @param[in] cache Key cache of the EPS security context
+   @param[in] knas_int 128 bits NAS integrity key
+*/
+void nas_stream_key_cache_set_eia2_key(
+    nas_stream_key_cache_t* const cache, const uint8_t* const knas_int) {
+  uint8_t l[NAS_STREAM_BLOCK_SIZE] = {0};
+
+  DevAssert(cache != NULL);
+  DevAssert(knas_int != NULL);
+
+  if (cache->eia2_ready &&
+      !memcmp(cache->eia2_key, knas_int, NAS_STREAM_KEY_SIZE)) {
+    return;
+  }
+  aes128_set_encrypt_key(&cache->eia2_aes, knas_int);
+  // L = AES-128(K, 0^128)
+  aes128_encrypt(&cache->eia2_aes, NAS_STREAM_BLOCK_SIZE, l, l);
+  _cmac_derive_subkey(l, cache->eia2_k1);
+  _cmac_derive_subkey(cache->eia2_k1, cache->eia2_k2);
+  memcpy(cache->eia2_key, knas_int, NAS_STREAM_KEY_SIZE);
+  cache->eia2_ready = true;
+  memset(l, 0, sizeof(l));
+}
+
+/*!
+   @brief Prepare the key cache of an EPS security context once its NAS keys
+   have been derived.
+   @param[in] cache Key cache of the EPS security context
+   @param[in] knas_enc 128 bits NAS ciphering key
+   @param[in] knas_int 128 bits NAS integrity key
+*/
+void nas_stream_key_cache_init(
+    nas_stream_key_cache_t* const cache, const uint8_t* const knas_enc,
+    const uint8_t* const knas_int) {
+  nas_stream_key_cache_clear(cache);
+  nas_stream_key_cache_set_eea2_key(cache, knas_enc);
+  nas_stream_key_cache_set_eia2_key(cache, knas_int);
+}
+
+/*!
+   @brief Wipe the key material held by the cache.
+   @param[in] cache Key cache of the EPS security context
+*/
+void nas_stream_key_cache_clear(nas_stream_key_cache_t* const cache) {
+  DevAssert(cache != NULL);
+  memset(cache, 0, sizeof(*cache));
+}
@@ -18,7 +18,10 @@
 #ifndef FILE_SECU_DEFS_SEEN
 #define FILE_SECU_DEFS_SEEN
 
+#include <stdbool.h>
 #include <stdint.h>
+#include <nettle/aes.h>
+#include <nettle/hmac.h>
 
 #include "security_types.h"
 
@@ -40,6 +43,42 @@ int derive_NH(
     const uint8_t* kasme_32, const uint8_t* syncInput, uint8_t* next_hop,
     uint8_t* next_hop_chaining_count);
 
+/*
+ * HMAC-SHA-256 state keyed with a KASME, kept alongside the EPS security
+ * context so that KNASenc, KNASint, KeNB and the NH chain are all derived
+ * from it without re-keying HMAC for each key.
+ * The context remembers the KASME it was keyed with and re-keys itself when
+ * it is handed a different one.
+ */
+#define KDF_CONTEXT_KEY_SIZE 32
+
+typedef struct kdf_context_s {
+  bool ready;
+  uint8_t key[KDF_CONTEXT_KEY_SIZE];
+  struct hmac_sha256_ctx hmac;
+} kdf_context_t;
+
+void kdf_context_set_key(
+    kdf_context_t* const ctx, const uint8_t* const kasme_32);
+
+void kdf_context_clear(kdf_context_t* const ctx);
+
+void kdf_with_context(
+    kdf_context_t* const ctx, const uint8_t* const s, const unsigned s_len,
+    uint8_t* const out, const unsigned out_len);
+
+int derive_keNB_with_context(
+    kdf_context_t* const ctx, const uint32_t nas_count, uint8_t* keNB);
+
+int derive_key_nas_with_context(
+    kdf_context_t* const ctx, algorithm_type_dist_t nas_alg_type,
+    uint8_t nas_enc_alg_id, uint8_t* knas);
+
+int derive_NH_chain(
+    kdf_context_t* const ctx, const uint8_t* syncInput,
+    const unsigned num_hops, uint8_t* next_hops,
+    uint8_t* next_hop_chaining_count);
+
 #define derive_key_nas_enc(aLGiD, kASME, kNAS)                                 \
   derive_key_nas(NAS_ENC_ALG, aLGiD, kASME, kNAS)
 
@@ -72,6 +111,41 @@ typedef struct {
   uint32_t blength;
 } nas_stream_cipher_t;
 
+/*
+ * Expanded key material for 128-EEA2/128-EIA2, kept alongside the NAS keys of
+ * an EPS security context so that ciphering and integrity protection of each
+ * NAS message run without re-keying AES or allocating memory.
+ * The cache remembers the keys it was expanded from and re-keys itself when
+ * it is handed a different key, so a stale cache is never used.
+ */
+#define NAS_STREAM_KEY_SIZE 16
+#define NAS_STREAM_BLOCK_SIZE 16
+
+typedef struct nas_stream_key_cache_s {
+  /* 128-EEA2: AES-CTR key schedule for KNASenc */
+  bool eea2_ready;
+  uint8_t eea2_key[NAS_STREAM_KEY_SIZE];
+  struct aes128_ctx eea2_aes;
+  /* 128-EIA2: AES-CMAC key schedule and subkeys K1/K2 for KNASint */
+  bool eia2_ready;
+  uint8_t eia2_key[NAS_STREAM_KEY_SIZE];
+  struct aes128_ctx eia2_aes;
+  uint8_t eia2_k1[NAS_STREAM_BLOCK_SIZE];
+  uint8_t eia2_k2[NAS_STREAM_BLOCK_SIZE];
+} nas_stream_key_cache_t;
+
+void nas_stream_key_cache_init(
+    nas_stream_key_cache_t* const cache, const uint8_t* const knas_enc,
+    const uint8_t* const knas_int);
+
+void nas_stream_key_cache_clear(nas_stream_key_cache_t* const cache);
+
+void nas_stream_key_cache_set_eea2_key(
+    nas_stream_key_cache_t* const cache, const uint8_t* const knas_enc);
+
+void nas_stream_key_cache_set_eia2_key(
+    nas_stream_key_cache_t* const cache, const uint8_t* const knas_int);
+
 int nas_stream_encrypt_eea1(
     nas_stream_cipher_t* const stream_cipher, uint8_t* const out);
 
@@ -84,4 +158,18 @@ int nas_stream_encrypt_eea2(
 int nas_stream_encrypt_eia2(
     nas_stream_cipher_t* const stream_cipher, uint8_t const out[4]);
 
+int nas_stream_encrypt_eea3(
+    nas_stream_cipher_t* const stream_cipher, uint8_t* const out);
+
+int nas_stream_encrypt_eia3(
+    nas_stream_cipher_t* const stream_cipher, uint8_t const out[4]);
+
+int nas_stream_encrypt_eea2_cached(
+    nas_stream_key_cache_t* const cache,
+    nas_stream_cipher_t* const stream_cipher, uint8_t* const out);
+
+int nas_stream_encrypt_eia2_cached(
+    nas_stream_key_cache_t* const cache,
+    nas_stream_cipher_t* const stream_cipher, uint8_t const out[4]);
+
 #endif /* FILE_SECU_DEFS_SEEN */
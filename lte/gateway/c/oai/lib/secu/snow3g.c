@@ -15,26 +15,24 @@
  *      contact@openairinterface.org
  */
 
+#include <pthread.h>
 #include <stdint.h>
 
 #include "rijndael.h"
 #include "snow3g.h"
 
-static uint8_t _MULx(uint8_t V, uint8_t c);
-static uint8_t _MULxPOW(uint8_t V, uint8_t i, uint8_t c);
-static uint32_t _MULalpha(uint8_t c);
-static uint32_t _DIValpha(uint8_t c);
-static uint32_t _S1(uint32_t w);
-static uint32_t _S2(uint32_t w);
-static void _snow3g_clock_LFSR_initialization_mode(
-    uint32_t F, snow_3g_context_t* s3g_ctx_pP);
-static void _snow3g_clock_LFSR_key_stream_mode(
-    snow_3g_context_t* snow_3g_context_pP);
-static uint32_t _snow3g_clock_fsm(snow_3g_context_t* snow_3g_context_pP);
-void snow3g_initialize(
-    uint32_t k[4], uint32_t IV[4], snow_3g_context_t* snow_3g_context_pP);
-void snow3g_generate_key_stream(
-    uint32_t n, uint32_t* ks, snow_3g_context_t* snow_3g_context_pP);
+/*
+ * The reference implementation recomputed MULalpha/DIValpha with a recursive
+ * MULxPOW and both S-Boxes byte by byte at every clock. They only depend on a
+ * byte of their input, so they are tabulated once: MULalpha/DIValpha become
+ * one lookup each and S1/S2 four lookups each (S-Box and MixColumn merged,
+ * like AES T-tables).
+ */
+static uint32_t _mul_alpha[256];
+static uint32_t _div_alpha[256];
+static uint32_t _s1_t[4][256];
+static uint32_t _s2_t[4][256];
+static pthread_once_t _snow3g_tables_once = PTHREAD_ONCE_INIT;
 
 /* _MULx.
   Input V: an 8-bit input.
@@ -60,151 +58,95 @@ static uint8_t _MULx(uint8_t V, uint8_t c) {
 */
 
 static uint8_t _MULxPOW(uint8_t V, uint8_t i, uint8_t c) {
-  if (i == 0)
-    return V;
-  else
-    return _MULx(_MULxPOW(V, i - 1, c), c);
+  while (i-- > 0) V = _MULx(V, c);
+  return V;
 }
 
-/* The function _MULalpha.
-  Input c: 8-bit input.
-  Output : 32-bit output.
-  maps 8 bits to 32 bits.
+/* Table of a S-Box followed by the MixColumn of section 3.3.1/3.3.2.
+  Input sbox: SR for S1, SQ for S2.
+  Input c: 0x1b for S1, 0x69 for S2.
+  Output t: t[j][x] is the contribution of input byte j (0 being the most
+  significant) valued x to the 32-bit output of the S-Box.
 */
 
-static uint32_t _MULalpha(uint8_t c) {
-  return (
-      (((uint32_t) _MULxPOW(c, 23, 0xa9)) << 24) |
-      (((uint32_t) _MULxPOW(c, 245, 0xa9)) << 16) |
-      (((uint32_t) _MULxPOW(c, 48, 0xa9)) << 8) |
-      (((uint32_t) _MULxPOW(c, 239, 0xa9))));
+static void _snow3g_init_sbox_table(
+    const uint8_t sbox[256], uint8_t c, uint32_t t[4][256]) {
+  for (int x = 0; x < 256; x++) {
+    uint32_t a  = sbox[x];
+    uint32_t a2 = _MULx(sbox[x], c);
+    uint32_t a3 = a2 ^ a;
+
+    t[0][x] = (a2 << 24) | (a3 << 16) | (a << 8) | a;
+    t[1][x] = (a << 24) | (a2 << 16) | (a3 << 8) | a;
+    t[2][x] = (a << 24) | (a << 16) | (a2 << 8) | a3;
+    t[3][x] = (a3 << 24) | (a << 16) | (a << 8) | a2;
+  }
 }
 
-/* The function DIV alpha.
-  Input c: 8-bit input.
-  Output : 32-bit output.
-  maps 8 bits to 32 bit.
-*/
-
-static uint32_t _DIValpha(uint8_t c) {
-  return (
-      (((uint32_t) _MULxPOW(c, 16, 0xa9)) << 24) |
-      (((uint32_t) _MULxPOW(c, 39, 0xa9)) << 16) |
-      (((uint32_t) _MULxPOW(c, 6, 0xa9)) << 8) |
-      (((uint32_t) _MULxPOW(c, 64, 0xa9))));
+static void _snow3g_init_tables(void) {
+  for (int x = 0; x < 256; x++) {
+    uint8_t c = (uint8_t) x;
+
+    /* MULalpha, see section 3.4.2 */
+    _mul_alpha[x] = (((uint32_t) _MULxPOW(c, 23, 0xa9)) << 24) |
+                    (((uint32_t) _MULxPOW(c, 245, 0xa9)) << 16) |
+                    (((uint32_t) _MULxPOW(c, 48, 0xa9)) << 8) |
+                    (((uint32_t) _MULxPOW(c, 239, 0xa9)));
+    /* DIValpha, see section 3.4.3 */
+    _div_alpha[x] = (((uint32_t) _MULxPOW(c, 16, 0xa9)) << 24) |
+                    (((uint32_t) _MULxPOW(c, 39, 0xa9)) << 16) |
+                    (((uint32_t) _MULxPOW(c, 6, 0xa9)) << 8) |
+                    (((uint32_t) _MULxPOW(c, 64, 0xa9)));
+  }
+  _snow3g_init_sbox_table(SR, 0x1b, _s1_t);
+  _snow3g_init_sbox_table(SQ, 0x69, _s2_t);
 }
 
 /* The 32x32-bit S-Box S1
   Input: a 32-bit input.
   Output: a 32-bit output of S1 box.
-  The S-Box S1 maps a 32-bit input to a 32-bit output.
-  w = w0 || w1 || w2 || w3 the 32-bit input with w0 the most and w3 the least
-  significant byte. S1(w)= r0 || r1 || r2 || r3 with r0 the most and r3 the
-  least significant byte.
+  See section 3.3.1.
 */
 
-static uint32_t _S1(uint32_t w) {
-  uint8_t r0 = 0, r1 = 0, r2 = 0, r3 = 0;
-  uint8_t srw0 = SR[(uint8_t)((w >> 24) & 0xff)];
-  uint8_t srw1 = SR[(uint8_t)((w >> 16) & 0xff)];
-  uint8_t srw2 = SR[(uint8_t)((w >> 8) & 0xff)];
-  uint8_t srw3 = SR[(uint8_t)((w) &0xff)];
-
-  r0 = ((_MULx(srw0, 0x1b)) ^ (srw1) ^ (srw2) ^ ((_MULx(srw3, 0x1b)) ^ srw3));
-  r1 = (((_MULx(srw0, 0x1b)) ^ srw0) ^ (_MULx(srw1, 0x1b)) ^ (srw2) ^ (srw3));
-  r2 = ((srw0) ^ ((_MULx(srw1, 0x1b)) ^ srw1) ^ (_MULx(srw2, 0x1b)) ^ (srw3));
-  r3 = ((srw0) ^ (srw1) ^ ((_MULx(srw2, 0x1b)) ^ srw2) ^ (_MULx(srw3, 0x1b)));
-  return (
-      (((uint32_t) r0) << 24) | (((uint32_t) r1) << 16) |
-      (((uint32_t) r2) << 8) | (((uint32_t) r3)));
+static inline uint32_t _S1(uint32_t w) {
+  return _s1_t[0][(w >> 24) & 0xff] ^ _s1_t[1][(w >> 16) & 0xff] ^
+         _s1_t[2][(w >> 8) & 0xff] ^ _s1_t[3][w & 0xff];
 }
 
 /* The 32x32-bit S-Box S2
   Input: a 32-bit input.
   Output: a 32-bit output of S2 box.
-  The S-Box S2 maps a 32-bit input to a 32-bit output.
-  Let w = w0 || w1 || w2 || w3 the 32-bit input with w0 the most and w3 the
-  least significant byte. Let S2(w)= r0 || r1 || r2 || r3 with r0 the most and
-  r3 the least significant byte.
+  See section 3.3.2.
 */
 
-static uint32_t _S2(uint32_t w) {
-  uint8_t r0 = 0, r1 = 0, r2 = 0, r3 = 0;
-  uint8_t sqw0 = SQ[(uint8_t)((w >> 24) & 0xff)];
-  uint8_t sqw1 = SQ[(uint8_t)((w >> 16) & 0xff)];
-  uint8_t sqw2 = SQ[(uint8_t)((w >> 8) & 0xff)];
-  uint8_t sqw3 = SQ[(uint8_t)((w) &0xff)];
-
-  r0 = ((_MULx(sqw0, 0x69)) ^ (sqw1) ^ (sqw2) ^ ((_MULx(sqw3, 0x69)) ^ sqw3));
-  r1 = (((_MULx(sqw0, 0x69)) ^ sqw0) ^ (_MULx(sqw1, 0x69)) ^ (sqw2) ^ (sqw3));
-  r2 = ((sqw0) ^ ((_MULx(sqw1, 0x69)) ^ sqw1) ^ (_MULx(sqw2, 0x69)) ^ (sqw3));
-  r3 = ((sqw0) ^ (sqw1) ^ ((_MULx(sqw2, 0x69)) ^ sqw2) ^ (_MULx(sqw3, 0x69)));
-  return (
-      (((uint32_t) r0) << 24) | (((uint32_t) r1) << 16) |
-      (((uint32_t) r2) << 8) | (((uint32_t) r3)));
+static inline uint32_t _S2(uint32_t w) {
+  return _s2_t[0][(w >> 24) & 0xff] ^ _s2_t[1][(w >> 16) & 0xff] ^
+         _s2_t[2][(w >> 8) & 0xff] ^ _s2_t[3][w & 0xff];
 }
 
-/* Clocking LFSR in initialization mode.
+/*
+ * The LFSR is a circular buffer: cell s_i lives at LFSR_S[(head + i) & 15].
+ * Clocking it writes the new s15 over the old s0 and advances head, instead of
+ * moving all sixteen words.
+ */
+#define SNOW3G_S(cTx, i) ((cTx)->LFSR_S[((cTx)->head + (i)) & 0xf])
+
+/* Clocking LFSR.
   LFSR Registers S0 to S15 are updated as the LFSR receives a single clock.
-  Input F: a 32-bit word comes from output of FSM.
-  See section 3.4.4.
+  Input F: a 32-bit word coming from the output of the FSM in initialization
+  mode (see section 3.4.4), 0 in keystream mode (see section 3.4.5).
 */
 
-static void _snow3g_clock_LFSR_initialization_mode(
-    uint32_t F, snow_3g_context_t* s3g_ctx_pP) {
-  uint32_t v =
-      (((s3g_ctx_pP->LFSR_S0 << 8) & 0xffffff00) ^
-       (_MULalpha((uint8_t)((s3g_ctx_pP->LFSR_S0 >> 24) & 0xff))) ^
-       (s3g_ctx_pP->LFSR_S2) ^ ((s3g_ctx_pP->LFSR_S11 >> 8) & 0x00ffffff) ^
-       (_DIValpha((uint8_t)((s3g_ctx_pP->LFSR_S11) & 0xff))) ^ (F));
-
-  s3g_ctx_pP->LFSR_S0  = s3g_ctx_pP->LFSR_S1;
-  s3g_ctx_pP->LFSR_S1  = s3g_ctx_pP->LFSR_S2;
-  s3g_ctx_pP->LFSR_S2  = s3g_ctx_pP->LFSR_S3;
-  s3g_ctx_pP->LFSR_S3  = s3g_ctx_pP->LFSR_S4;
-  s3g_ctx_pP->LFSR_S4  = s3g_ctx_pP->LFSR_S5;
-  s3g_ctx_pP->LFSR_S5  = s3g_ctx_pP->LFSR_S6;
-  s3g_ctx_pP->LFSR_S6  = s3g_ctx_pP->LFSR_S7;
-  s3g_ctx_pP->LFSR_S7  = s3g_ctx_pP->LFSR_S8;
-  s3g_ctx_pP->LFSR_S8  = s3g_ctx_pP->LFSR_S9;
-  s3g_ctx_pP->LFSR_S9  = s3g_ctx_pP->LFSR_S10;
-  s3g_ctx_pP->LFSR_S10 = s3g_ctx_pP->LFSR_S11;
-  s3g_ctx_pP->LFSR_S11 = s3g_ctx_pP->LFSR_S12;
-  s3g_ctx_pP->LFSR_S12 = s3g_ctx_pP->LFSR_S13;
-  s3g_ctx_pP->LFSR_S13 = s3g_ctx_pP->LFSR_S14;
-  s3g_ctx_pP->LFSR_S14 = s3g_ctx_pP->LFSR_S15;
-  s3g_ctx_pP->LFSR_S15 = v;
-}
+static inline void _snow3g_clock_LFSR(
+    uint32_t F, snow_3g_context_t* snow_3g_context_pP) {
+  uint32_t s0  = SNOW3G_S(snow_3g_context_pP, 0);
+  uint32_t s11 = SNOW3G_S(snow_3g_context_pP, 11);
+  uint32_t v   = (s0 << 8) ^ _mul_alpha[s0 >> 24] ^
+               SNOW3G_S(snow_3g_context_pP, 2) ^ (s11 >> 8) ^
+               _div_alpha[s11 & 0xff] ^ F;
 
-/* Clocking LFSR in keystream mode.
-  LFSR Registers S0 to S15 are updated as the LFSR receives a single clock.
-  See section 3.4.5.
-*/
-static void _snow3g_clock_LFSR_key_stream_mode(
-    snow_3g_context_t* snow_3g_context_pP) {
-  uint32_t v =
-      (((snow_3g_context_pP->LFSR_S0 << 8) & 0xffffff00) ^
-       (_MULalpha((uint8_t)((snow_3g_context_pP->LFSR_S0 >> 24) & 0xff))) ^
-       (snow_3g_context_pP->LFSR_S2) ^
-       ((snow_3g_context_pP->LFSR_S11 >> 8) & 0x00ffffff) ^
-       (_DIValpha((uint8_t)((snow_3g_context_pP->LFSR_S11) & 0xff))));
-
-  snow_3g_context_pP->LFSR_S0  = snow_3g_context_pP->LFSR_S1;
-  snow_3g_context_pP->LFSR_S1  = snow_3g_context_pP->LFSR_S2;
-  snow_3g_context_pP->LFSR_S2  = snow_3g_context_pP->LFSR_S3;
-  snow_3g_context_pP->LFSR_S3  = snow_3g_context_pP->LFSR_S4;
-  snow_3g_context_pP->LFSR_S4  = snow_3g_context_pP->LFSR_S5;
-  snow_3g_context_pP->LFSR_S5  = snow_3g_context_pP->LFSR_S6;
-  snow_3g_context_pP->LFSR_S6  = snow_3g_context_pP->LFSR_S7;
-  snow_3g_context_pP->LFSR_S7  = snow_3g_context_pP->LFSR_S8;
-  snow_3g_context_pP->LFSR_S8  = snow_3g_context_pP->LFSR_S9;
-  snow_3g_context_pP->LFSR_S9  = snow_3g_context_pP->LFSR_S10;
-  snow_3g_context_pP->LFSR_S10 = snow_3g_context_pP->LFSR_S11;
-  snow_3g_context_pP->LFSR_S11 = snow_3g_context_pP->LFSR_S12;
-  snow_3g_context_pP->LFSR_S12 = snow_3g_context_pP->LFSR_S13;
-  snow_3g_context_pP->LFSR_S13 = snow_3g_context_pP->LFSR_S14;
-  snow_3g_context_pP->LFSR_S14 = snow_3g_context_pP->LFSR_S15;
-  snow_3g_context_pP->LFSR_S15 = v;
+  SNOW3G_S(snow_3g_context_pP, 0) = v;
+  snow_3g_context_pP->head        = (snow_3g_context_pP->head + 1) & 0xf;
 }
 
 /* Clocking FSM.
@@ -213,13 +155,13 @@ static void _snow3g_clock_LFSR_key_stream_mode(
   See Section 3.4.6.
 */
 
-static uint32_t _snow3g_clock_fsm(snow_3g_context_t* snow_3g_context_pP) {
-  uint32_t F = ((snow_3g_context_pP->LFSR_S15 + snow_3g_context_pP->FSM_R1) &
-                0xffffffff) ^
-               snow_3g_context_pP->FSM_R2;
-  uint32_t r = (snow_3g_context_pP->FSM_R2 +
-                (snow_3g_context_pP->FSM_R3 ^ snow_3g_context_pP->LFSR_S5)) &
-               0xffffffff;
+static inline uint32_t _snow3g_clock_fsm(
+    snow_3g_context_t* snow_3g_context_pP) {
+  uint32_t F =
+      (SNOW3G_S(snow_3g_context_pP, 15) + snow_3g_context_pP->FSM_R1) ^
+      snow_3g_context_pP->FSM_R2;
+  uint32_t r = snow_3g_context_pP->FSM_R2 +
+               (snow_3g_context_pP->FSM_R3 ^ SNOW3G_S(snow_3g_context_pP, 5));
 
   snow_3g_context_pP->FSM_R3 = _S2(snow_3g_context_pP->FSM_R2);
   snow_3g_context_pP->FSM_R2 = _S1(snow_3g_context_pP->FSM_R1);
@@ -239,30 +181,38 @@ void snow3g_initialize(
   uint8_t i  = 0;
   uint32_t F = 0x0;
 
-  snow_3g_context_pP->LFSR_S15 = k[3] ^ IV[0];
-  snow_3g_context_pP->LFSR_S14 = k[2];
-  snow_3g_context_pP->LFSR_S13 = k[1];
-  snow_3g_context_pP->LFSR_S12 = k[0] ^ IV[1];
-  snow_3g_context_pP->LFSR_S11 = k[3] ^ 0xffffffff;
-  snow_3g_context_pP->LFSR_S10 = k[2] ^ 0xffffffff ^ IV[2];
-  snow_3g_context_pP->LFSR_S9  = k[1] ^ 0xffffffff ^ IV[3];
-  snow_3g_context_pP->LFSR_S8  = k[0] ^ 0xffffffff;
-  snow_3g_context_pP->LFSR_S7  = k[3];
-  snow_3g_context_pP->LFSR_S6  = k[2];
-  snow_3g_context_pP->LFSR_S5  = k[1];
-  snow_3g_context_pP->LFSR_S4  = k[0];
-  snow_3g_context_pP->LFSR_S3  = k[3] ^ 0xffffffff;
-  snow_3g_context_pP->LFSR_S2  = k[2] ^ 0xffffffff;
-  snow_3g_context_pP->LFSR_S1  = k[1] ^ 0xffffffff;
-  snow_3g_context_pP->LFSR_S0  = k[0] ^ 0xffffffff;
-  snow_3g_context_pP->FSM_R1   = 0x0;
-  snow_3g_context_pP->FSM_R2   = 0x0;
-  snow_3g_context_pP->FSM_R3   = 0x0;
+  pthread_once(&_snow3g_tables_once, _snow3g_init_tables);
+
+  snow_3g_context_pP->head       = 0;
+  snow_3g_context_pP->LFSR_S[15] = k[3] ^ IV[0];
+  snow_3g_context_pP->LFSR_S[14] = k[2];
+  snow_3g_context_pP->LFSR_S[13] = k[1];
+  snow_3g_context_pP->LFSR_S[12] = k[0] ^ IV[1];
+  snow_3g_context_pP->LFSR_S[11] = k[3] ^ 0xffffffff;
+  snow_3g_context_pP->LFSR_S[10] = k[2] ^ 0xffffffff ^ IV[2];
+  snow_3g_context_pP->LFSR_S[9]  = k[1] ^ 0xffffffff ^ IV[3];
+  snow_3g_context_pP->LFSR_S[8]  = k[0] ^ 0xffffffff;
+  snow_3g_context_pP->LFSR_S[7]  = k[3];
+  snow_3g_context_pP->LFSR_S[6]  = k[2];
+  snow_3g_context_pP->LFSR_S[5]  = k[1];
+  snow_3g_context_pP->LFSR_S[4]  = k[0];
+  snow_3g_context_pP->LFSR_S[3]  = k[3] ^ 0xffffffff;
+  snow_3g_context_pP->LFSR_S[2]  = k[2] ^ 0xffffffff;
+  snow_3g_context_pP->LFSR_S[1]  = k[1] ^ 0xffffffff;
+  snow_3g_context_pP->LFSR_S[0]  = k[0] ^ 0xffffffff;
+  snow_3g_context_pP->FSM_R1     = 0x0;
+  snow_3g_context_pP->FSM_R2     = 0x0;
+  snow_3g_context_pP->FSM_R3     = 0x0;
 
   for (i = 0; i < 32; i++) {
     F = _snow3g_clock_fsm(snow_3g_context_pP);
-    _snow3g_clock_LFSR_initialization_mode(F, snow_3g_context_pP);
+    _snow3g_clock_LFSR(F, snow_3g_context_pP);
   }
+
+  _snow3g_clock_fsm(
+      snow_3g_context_pP); /* Clock FSM once. Discard the output. */
+  _snow3g_clock_LFSR(
+      0, snow_3g_context_pP); /* Clock LFSR in keystream mode once. */
 }
 
 /*  Generation of Keystream.
@@ -278,17 +228,12 @@ void snow3g_generate_key_stream(
   uint32_t t = 0;
   uint32_t F = 0x0;
 
-  _snow3g_clock_fsm(
-      snow_3g_context_pP); /* Clock FSM once. Discard the output. */
-  _snow3g_clock_LFSR_key_stream_mode(
-      snow_3g_context_pP); /* Clock LFSR in keystream mode once. */
-
   for (t = 0; t < n; t++) {
-    F     = _snow3g_clock_fsm(snow_3g_context_pP); /* STEP 1 */
-    ks[t] = F ^ snow_3g_context_pP->LFSR_S0;       /* STEP 2 */
+    F     = _snow3g_clock_fsm(snow_3g_context_pP);  /* STEP 1 */
+    ks[t] = F ^ SNOW3G_S(snow_3g_context_pP, 0);    /* STEP 2 */
     /*
      * Note that ks[t] corresponds to z_{t+1} in section 4.2
      */
-    _snow3g_clock_LFSR_key_stream_mode(snow_3g_context_pP); /* STEP 3 */
+    _snow3g_clock_LFSR(0, snow_3g_context_pP); /* STEP 3 */
   }
 }
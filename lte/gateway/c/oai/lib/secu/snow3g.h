@@ -32,22 +32,11 @@
 #include <stdint.h>
 
 typedef struct snow_3g_context_s {
-  uint32_t LFSR_S0;
-  uint32_t LFSR_S1;
-  uint32_t LFSR_S2;
-  uint32_t LFSR_S3;
-  uint32_t LFSR_S4;
-  uint32_t LFSR_S5;
-  uint32_t LFSR_S6;
-  uint32_t LFSR_S7;
-  uint32_t LFSR_S8;
-  uint32_t LFSR_S9;
-  uint32_t LFSR_S10;
-  uint32_t LFSR_S11;
-  uint32_t LFSR_S12;
-  uint32_t LFSR_S13;
-  uint32_t LFSR_S14;
-  uint32_t LFSR_S15;
+  /* LFSR : sixteen 32-bit cells S0..S15, kept as a circular buffer where
+   * S_i is LFSR_S[(head + i) % 16]
+   */
+  uint32_t LFSR_S[16];
+  uint32_t head;
 
   /* FSM : The Finite State Machine has three 32-bit registers R1, R2 and R3.
    */
@@ -65,6 +54,8 @@ void snow3g_initialize(
     uint32_t k[4], uint32_t IV[4], snow_3g_context_t* snow_3g_context_pP);
 
 /* Generation of Keystream.
+ * Successive calls continue the same keystream, so it can be produced in
+ * chunks.
  * input n: number of 32-bit words of keystream.
  * input z: space for the generated keystream, assumes
  * memory is allocated already.
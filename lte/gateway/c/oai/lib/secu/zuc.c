@@ -0,0 +1,225 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#include <stdint.h>
+
+#include "zuc.h"
+
+/* The S-boxes S0 and S1, see section 3.4.2 */
+static const uint8_t _S0[256] = {
+    0x3e, 0x72, 0x5b, 0x47, 0xca, 0xe0, 0x00, 0x33,
+    0x04, 0xd1, 0x54, 0x98, 0x09, 0xb9, 0x6d, 0xcb,
+    0x7b, 0x1b, 0xf9, 0x32, 0xaf, 0x9d, 0x6a, 0xa5,
+    0xb8, 0x2d, 0xfc, 0x1d, 0x08, 0x53, 0x03, 0x90,
+    0x4d, 0x4e, 0x84, 0x99, 0xe4, 0xce, 0xd9, 0x91,
+    0xdd, 0xb6, 0x85, 0x48, 0x8b, 0x29, 0x6e, 0xac,
+    0xcd, 0xc1, 0xf8, 0x1e, 0x73, 0x43, 0x69, 0xc6,
+    0xb5, 0xbd, 0xfd, 0x39, 0x63, 0x20, 0xd4, 0x38,
+    0x76, 0x7d, 0xb2, 0xa7, 0xcf, 0xed, 0x57, 0xc5,
+    0xf3, 0x2c, 0xbb, 0x14, 0x21, 0x06, 0x55, 0x9b,
+    0xe3, 0xef, 0x5e, 0x31, 0x4f, 0x7f, 0x5a, 0xa4,
+    0x0d, 0x82, 0x51, 0x49, 0x5f, 0xba, 0x58, 0x1c,
+    0x4a, 0x16, 0xd5, 0x17, 0xa8, 0x92, 0x24, 0x1f,
+    0x8c, 0xff, 0xd8, 0xae, 0x2e, 0x01, 0xd3, 0xad,
+    0x3b, 0x4b, 0xda, 0x46, 0xeb, 0xc9, 0xde, 0x9a,
+    0x8f, 0x87, 0xd7, 0x3a, 0x80, 0x6f, 0x2f, 0xc8,
+    0xb1, 0xb4, 0x37, 0xf7, 0x0a, 0x22, 0x13, 0x28,
+    0x7c, 0xcc, 0x3c, 0x89, 0xc7, 0xc3, 0x96, 0x56,
+    0x07, 0xbf, 0x7e, 0xf0, 0x0b, 0x2b, 0x97, 0x52,
+    0x35, 0x41, 0x79, 0x61, 0xa6, 0x4c, 0x10, 0xfe,
+    0xbc, 0x26, 0x95, 0x88, 0x8a, 0xb0, 0xa3, 0xfb,
+    0xc0, 0x18, 0x94, 0xf2, 0xe1, 0xe5, 0xe9, 0x5d,
+    0xd0, 0xdc, 0x11, 0x66, 0x64, 0x5c, 0xec, 0x59,
+    0x42, 0x75, 0x12, 0xf5, 0x74, 0x9c, 0xaa, 0x23,
+    0x0e, 0x86, 0xab, 0xbe, 0x2a, 0x02, 0xe7, 0x67,
+    0xe6, 0x44, 0xa2, 0x6c, 0xc2, 0x93, 0x9f, 0xf1,
+    0xf6, 0xfa, 0x36, 0xd2, 0x50, 0x68, 0x9e, 0x62,
+    0x71, 0x15, 0x3d, 0xd6, 0x40, 0xc4, 0xe2, 0x0f,
+    0x8e, 0x83, 0x77, 0x6b, 0x25, 0x05, 0x3f, 0x0c,
+    0x30, 0xea, 0x70, 0xb7, 0xa1, 0xe8, 0xa9, 0x65,
+    0x8d, 0x27, 0x1a, 0xdb, 0x81, 0xb3, 0xa0, 0xf4,
+    0x45, 0x7a, 0x19, 0xdf, 0xee, 0x78, 0x34, 0x60,
+};
+
+static const uint8_t _S1[256] = {
+    0x55, 0xc2, 0x63, 0x71, 0x3b, 0xc8, 0x47, 0x86,
+    0x9f, 0x3c, 0xda, 0x5b, 0x29, 0xaa, 0xfd, 0x77,
+    0x8c, 0xc5, 0x94, 0x0c, 0xa6, 0x1a, 0x13, 0x00,
+    0xe3, 0xa8, 0x16, 0x72, 0x40, 0xf9, 0xf8, 0x42,
+    0x44, 0x26, 0x68, 0x96, 0x81, 0xd9, 0x45, 0x3e,
+    0x10, 0x76, 0xc6, 0xa7, 0x8b, 0x39, 0x43, 0xe1,
+    0x3a, 0xb5, 0x56, 0x2a, 0xc0, 0x6d, 0xb3, 0x05,
+    0x22, 0x66, 0xbf, 0xdc, 0x0b, 0xfa, 0x62, 0x48,
+    0xdd, 0x20, 0x11, 0x06, 0x36, 0xc9, 0xc1, 0xcf,
+    0xf6, 0x27, 0x52, 0xbb, 0x69, 0xf5, 0xd4, 0x87,
+    0x7f, 0x84, 0x4c, 0xd2, 0x9c, 0x57, 0xa4, 0xbc,
+    0x4f, 0x9a, 0xdf, 0xfe, 0xd6, 0x8d, 0x7a, 0xeb,
+    0x2b, 0x53, 0xd8, 0x5c, 0xa1, 0x14, 0x17, 0xfb,
+    0x23, 0xd5, 0x7d, 0x30, 0x67, 0x73, 0x08, 0x09,
+    0xee, 0xb7, 0x70, 0x3f, 0x61, 0xb2, 0x19, 0x8e,
+    0x4e, 0xe5, 0x4b, 0x93, 0x8f, 0x5d, 0xdb, 0xa9,
+    0xad, 0xf1, 0xae, 0x2e, 0xcb, 0x0d, 0xfc, 0xf4,
+    0x2d, 0x46, 0x6e, 0x1d, 0x97, 0xe8, 0xd1, 0xe9,
+    0x4d, 0x37, 0xa5, 0x75, 0x5e, 0x83, 0x9e, 0xab,
+    0x82, 0x9d, 0xb9, 0x1c, 0xe0, 0xcd, 0x49, 0x89,
+    0x01, 0xb6, 0xbd, 0x58, 0x24, 0xa2, 0x5f, 0x38,
+    0x78, 0x99, 0x15, 0x90, 0x50, 0xb8, 0x95, 0xe4,
+    0xd0, 0x91, 0xc7, 0xce, 0xed, 0x0f, 0xb4, 0x6f,
+    0xa0, 0xcc, 0xf0, 0x02, 0x4a, 0x79, 0xc3, 0xde,
+    0xa3, 0xef, 0xea, 0x51, 0xe6, 0x6b, 0x18, 0xec,
+    0x1b, 0x2c, 0x80, 0xf7, 0x74, 0xe7, 0xff, 0x21,
+    0x5a, 0x6a, 0x54, 0x1e, 0x41, 0x31, 0x92, 0x35,
+    0xc4, 0x33, 0x07, 0x0a, 0xba, 0x7e, 0x0e, 0x34,
+    0x88, 0xb1, 0x98, 0x7c, 0xf3, 0x3d, 0x60, 0x6c,
+    0x7b, 0xca, 0xd3, 0x1f, 0x32, 0x65, 0x04, 0x28,
+    0x64, 0xbe, 0x85, 0x9b, 0x2f, 0x59, 0x8a, 0xd7,
+    0xb0, 0x25, 0xac, 0xaf, 0x12, 0x03, 0xe2, 0xf2,
+};
+
+/* The constant D used for key loading, see section 3.5.1 */
+static const uint32_t _D[16] = {
+    0x44D7, 0x26BC, 0x626B, 0x135E, 0x5789, 0x35E2, 0x7135, 0x09AF,
+    0x4D78, 0x2F13, 0x6BC4, 0x1AF1, 0x5E26, 0x3C4D, 0x789A, 0x47AC,
+};
+
+#define ZUC_S(cTx, i) ((cTx)->LFSR_S[((cTx)->head + (i)) & 0xf])
+
+/* Addition modulo 2^31 - 1, see section 3.2 */
+static inline uint32_t _add_mod(uint32_t a, uint32_t b) {
+  uint32_t c = a + b;
+
+  return (c & 0x7FFFFFFF) + (c >> 31);
+}
+
+/* Multiplication by 2^k modulo 2^31 - 1, a 31-bit left rotation */
+static inline uint32_t _mul_pow2_mod(uint32_t a, uint32_t k) {
+  return ((a << k) | (a >> (31 - k))) & 0x7FFFFFFF;
+}
+
+static inline uint32_t _rot(uint32_t a, uint32_t k) {
+  return (a << k) | (a >> (32 - k));
+}
+
+/* The linear transforms L1 and L2, see section 3.4.2 */
+static inline uint32_t _L1(uint32_t X) {
+  return X ^ _rot(X, 2) ^ _rot(X, 10) ^ _rot(X, 18) ^ _rot(X, 24);
+}
+
+static inline uint32_t _L2(uint32_t X) {
+  return X ^ _rot(X, 8) ^ _rot(X, 14) ^ _rot(X, 22) ^ _rot(X, 30);
+}
+
+/* The 32x32 S-box S = (S0, S1, S0, S1), see section 3.4.2 */
+static inline uint32_t _S(uint32_t X) {
+  return ((uint32_t) _S0[X >> 24] << 24) |
+         ((uint32_t) _S1[(X >> 16) & 0xff] << 16) |
+         ((uint32_t) _S0[(X >> 8) & 0xff] << 8) | (uint32_t) _S1[X & 0xff];
+}
+
+/* Clocking LFSR.
+  Input u: 31-bit word coming from the output of F in initialization mode
+  (see section 3.2.1), 0 in working mode (see section 3.2.2).
+*/
+static inline void _zuc_clock_LFSR(uint32_t u, zuc_context_t* zuc_context_pP) {
+  uint32_t v = ZUC_S(zuc_context_pP, 0);
+
+  v = _add_mod(v, _mul_pow2_mod(ZUC_S(zuc_context_pP, 0), 8));
+  v = _add_mod(v, _mul_pow2_mod(ZUC_S(zuc_context_pP, 4), 20));
+  v = _add_mod(v, _mul_pow2_mod(ZUC_S(zuc_context_pP, 10), 21));
+  v = _add_mod(v, _mul_pow2_mod(ZUC_S(zuc_context_pP, 13), 17));
+  v = _add_mod(v, _mul_pow2_mod(ZUC_S(zuc_context_pP, 15), 15));
+  v = _add_mod(v, u);
+  if (v == 0) v = 0x7FFFFFFF;
+
+  ZUC_S(zuc_context_pP, 0) = v;
+  zuc_context_pP->head     = (zuc_context_pP->head + 1) & 0xf;
+}
+
+/* Bit reorganization, see section 3.3. Only X0, X1 and X2 feed F, X3 is
+  returned for the keystream.
+*/
+static inline uint32_t _zuc_bit_reorganization(
+    zuc_context_t* zuc_context_pP, uint32_t X[3]) {
+  X[0] = ((ZUC_S(zuc_context_pP, 15) & 0x7FFF8000) << 1) |
+         (ZUC_S(zuc_context_pP, 14) & 0xFFFF);
+  X[1] = ((ZUC_S(zuc_context_pP, 11) & 0xFFFF) << 16) |
+         (ZUC_S(zuc_context_pP, 9) >> 15);
+  X[2] = ((ZUC_S(zuc_context_pP, 7) & 0xFFFF) << 16) |
+         (ZUC_S(zuc_context_pP, 5) >> 15);
+  return ((ZUC_S(zuc_context_pP, 2) & 0xFFFF) << 16) |
+         (ZUC_S(zuc_context_pP, 0) >> 15);
+}
+
+/* The nonlinear function F, see section 3.4 */
+static inline uint32_t _zuc_F(
+    zuc_context_t* zuc_context_pP, const uint32_t X[3]) {
+  uint32_t W  = (X[0] ^ zuc_context_pP->F_R1) + zuc_context_pP->F_R2;
+  uint32_t W1 = zuc_context_pP->F_R1 + X[1];
+  uint32_t W2 = zuc_context_pP->F_R2 ^ X[2];
+
+  zuc_context_pP->F_R1 = _S(_L1((W1 << 16) | (W2 >> 16)));
+  zuc_context_pP->F_R2 = _S(_L2((W2 << 16) | (W1 >> 16)));
+  return W;
+}
+
+/*  Initialization.
+    Input k[16]: 128-bit key.
+    Input iv[16]: 128-bit initialization vector.
+    Output: The LFSR and F are initialized for key generation.
+    See Section 3.6.1.
+*/
+void zuc_initialize(
+    const uint8_t k[16], const uint8_t iv[16], zuc_context_t* zuc_context_pP) {
+  uint32_t X[3];
+
+  zuc_context_pP->head = 0;
+  for (int i = 0; i < 16; i++) {
+    zuc_context_pP->LFSR_S[i] =
+        ((uint32_t) k[i] << 23) | (_D[i] << 8) | (uint32_t) iv[i];
+  }
+  zuc_context_pP->F_R1 = 0;
+  zuc_context_pP->F_R2 = 0;
+
+  for (int i = 0; i < 32; i++) {
+    _zuc_bit_reorganization(zuc_context_pP, X);
+    _zuc_clock_LFSR(_zuc_F(zuc_context_pP, X) >> 1, zuc_context_pP);
+  }
+
+  /* First clock of the working stage, its output is discarded */
+  _zuc_bit_reorganization(zuc_context_pP, X);
+  _zuc_F(zuc_context_pP, X);
+  _zuc_clock_LFSR(0, zuc_context_pP);
+}
+
+/*  Generation of Keystream.
+    input n: number of 32-bit words of keystream.
+    input z: space for the generated keystream, assumes
+    memory is allocated already.
+    output: generated keystream which is filled in z
+    See section 3.6.2.
+*/
+void zuc_generate_key_stream(
+    uint32_t n, uint32_t* z, zuc_context_t* zuc_context_pP) {
+  uint32_t X[3];
+
+  for (uint32_t t = 0; t < n; t++) {
+    uint32_t X3 = _zuc_bit_reorganization(zuc_context_pP, X);
+
+    z[t] = _zuc_F(zuc_context_pP, X) ^ X3;
+    _zuc_clock_LFSR(0, zuc_context_pP);
+  }
+}
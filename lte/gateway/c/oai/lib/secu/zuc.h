@@ -0,0 +1,60 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file zuc.h
+ * \brief ZUC stream cipher, core of 128-EEA3 and 128-EIA3
+ * \note Specification of the 3GPP Confidentiality and Integrity Algorithms
+ * 128-EEA3 & 128-EIA3. Document 2: ZUC Specification
+ */
+#ifndef FILE_ZUC_SEEN
+#define FILE_ZUC_SEEN
+
+#include <stdint.h>
+
+typedef struct zuc_context_s {
+  /* LFSR : sixteen 31-bit cells S0..S15, kept as a circular buffer where
+   * S_i is LFSR_S[(head + i) % 16]
+   */
+  uint32_t LFSR_S[16];
+  uint32_t head;
+
+  /* F : The nonlinear function F has two 32-bit memory cells R1 and R2.
+   */
+  uint32_t F_R1;
+  uint32_t F_R2;
+} zuc_context_t;
+
+/* Initialization.
+ * Input k[16]: 128-bit key.
+ * Input iv[16]: 128-bit initialization vector.
+ * Output: The LFSR and F are initialized for key generation.
+ */
+void zuc_initialize(
+    const uint8_t k[16], const uint8_t iv[16], zuc_context_t* zuc_context_pP);
+
+/* Generation of Keystream.
+ * Successive calls continue the same keystream, so it can be produced in
+ * chunks.
+ * input n: number of 32-bit words of keystream.
+ * input z: space for the generated keystream, assumes
+ * memory is allocated already.
+ * output: generated keystream which is filled in z
+ */
+void zuc_generate_key_stream(
+    uint32_t n, uint32_t* z, zuc_context_t* zuc_context_pP);
+
+#endif
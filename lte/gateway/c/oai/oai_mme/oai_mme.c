@@ -29,6 +29,7 @@
 
 #include "dynamic_memory_check.h"
 #include "assertions.h"
+#include "async_system.h"
 #include "log.h"
 #include "mme_config.h"
 #include "shared_ts_log.h"
@@ -45,6 +46,7 @@
 #include "ha_defs.h"
 #include "oai_mme.h"
 #include "pid_file.h"
+#include "procedure_trace.h"
 #include "service303_message_utils.h"
 #include "bstrlib.h"
 #include "intertask_interface.h"
@@ -81,6 +83,7 @@ static int main_init(void) {
 }
 
 static void main_exit(void) {
+  procedure_trace_exit();
   destroy_task_context(&main_zmq_ctx);
 }
 
@@ -119,12 +122,14 @@ int main(int argc, char* argv[]) {
   // Intialize loggers and configured log levels.
   OAILOG_LOG_CONFIGURE(&mme_config.log_config);
   CHECK_INIT_RETURN(service303_init(&(mme_config.service303_config)));
+  CHECK_INIT_RETURN(procedure_trace_init(&mme_config.procedure_trace_config));
 
   event_client_init();
 
   CHECK_INIT_RETURN(mme_app_init(&mme_config));
   CHECK_INIT_RETURN(sctp_init(&mme_config));
 #if EMBEDDED_SGW
+  CHECK_INIT_RETURN(async_system_init());
   CHECK_INIT_RETURN(spgw_app_init(&spgw_config, mme_config.use_stateless));
 #else
   CHECK_INIT_RETURN(udp_init());
@@ -26,34 +26,20 @@
 #include "log.h"
 #include "gtpv1u.h"
 #include "ControllerMain.h"
+#include "OvsdbClientAPI.h"
 #include "3gpp_23.003.h"
 #include "spgw_config.h"
+#include "conversions.h"
+#include "intertask_interface.h"
 
 extern struct gtp_tunnel_ops gtp_tunnel_ops;
+extern task_zmq_ctx_t spgw_app_task_zmq_ctx;
 
 // Tunnel port related functionality
 static const char* ovs_gtp_type;
 
 #define MAX_GTP_PORT_NAME_LENGTH 15
 
-#define INIT_GTP_TABLE_SIZE 64
-#define MAX_GTP_TABLE_SIZE 1024
-
-struct gtp_portno {
-  // GTP port name is limited at 14 char
-  char name[MAX_GTP_PORT_NAME_LENGTH];
-  // zero port number is unknown port
-  uint32_t portno;
-};
-
-struct gtp_portno_record {
-  struct gtp_portno* arr;
-  int allocated;
-  int size;
-};
-
-static struct gtp_portno_record gtp_portno_rec;
-
 /**
  * Generate GTP port name from eNodeB IP address
  */
@@ -64,123 +50,9 @@ static void ip_addr_to_gtp_port_name(struct in_addr enb_addr, char name[]) {
   assert(rc > 0);
 }
 
-static uint32_t search_portno_records(char* name) {
-  int i;
-  for (i = 0; i < gtp_portno_rec.allocated; i++) {
-    if (!strncmp(name, gtp_portno_rec.arr[i].name, MAX_GTP_PORT_NAME_LENGTH)) {
-      return gtp_portno_rec.arr[i].portno;
-    }
-  }
-  return 0;
-}
-
 /**
- * Implements basic port number map with linear seach.
- */
-static void add_portno_rec(char* port_name, uint32_t portno) {
-  if (gtp_portno_rec.allocated == gtp_portno_rec.size) {
-    int new_size = gtp_portno_rec.size * 2;
-    if (new_size > MAX_GTP_TABLE_SIZE) {
-      // in case of unpected increase in table size, flush
-      // all records.
-      new_size = INIT_GTP_TABLE_SIZE;
-    }
-    struct gtp_portno* new_arr = calloc(new_size, sizeof(struct gtp_portno));
-    if (!new_arr) {
-      return;
-    }
-    if (new_size > gtp_portno_rec.size) {
-      // In case of table size increase copy existing records.
-      memcpy(
-          new_arr, gtp_portno_rec.arr,
-          sizeof(gtp_portno_rec.arr[0]) * gtp_portno_rec.size);
-    } else {
-      // Flush all records if size resets to init-size.
-      gtp_portno_rec.allocated = 0;
-    }
-    free(gtp_portno_rec.arr);
-    gtp_portno_rec.arr  = new_arr;
-    gtp_portno_rec.size = new_size;
-  }
-  // Now we shld have space to add new port.
-  int i;
-
-  for (i = 0; i < gtp_portno_rec.size; i++) {
-    struct gtp_portno* rec = &gtp_portno_rec.arr[i];
-
-    if (!rec->portno) {
-      strncpy(rec->name, port_name, MAX_GTP_PORT_NAME_LENGTH);
-      rec->portno = portno;
-      gtp_portno_rec.allocated++;
-      return;
-    }
-  }
-  // port number caching is best effort.
-}
-
-/**
- * Read GTP tunnel port number from OVSDB.
- */
-static uint32_t get_gtp_port_no(char port_name[]) {
-  FILE* fp;
-  uint32_t port_no = 0;
-  char ovsdb_dump[256];
-
-  /* Open the command for reading. */
-  fp = popen("sudo ovsdb-client dump Interface name ofport", "r");
-  if (fp == NULL) {
-    OAILOG_ERROR(LOG_GTPV1U, "could not read ovsdb");
-    return 0;
-  }
-
-  /* Read the output a line at a time - output it. */
-  while (fgets(ovsdb_dump, sizeof(ovsdb_dump), fp) != NULL) {
-    OAILOG_DEBUG(LOG_GTPV1U, "ovsdb: %s\n", ovsdb_dump);
-    char* p = strstr(ovsdb_dump, port_name);
-    if (p) {
-      int len = strlen(port_name);
-      // ovsdb dump has port number after portname separated by whitespaces.
-      port_no = atoi(&p[len + 1]);
-      break;
-    }
-  }
-
-  pclose(fp);
-  return port_no;
-}
-
-/**
- * Create GTP tunnel using OVS tool
- */
-static uint32_t create_gtp_port(struct in_addr enb_addr, char port_name[]) {
-  char gtp_port_create[512];
-  int rc;
-  rc = snprintf(
-      gtp_port_create, sizeof(gtp_port_create),
-      "sudo ovs-vsctl --may-exist add-port gtp_br0 %s -- set Interface %s "
-      "type=%s "
-      "options:remote_ip=%s options:key=flow",
-      port_name, port_name, ovs_gtp_type, inet_ntoa(enb_addr));
-  if (rc < 0) {
-    OAILOG_ERROR(LOG_GTPV1U, "gtp-port create: format error %d", rc);
-    return rc;
-  }
-  rc = system(gtp_port_create);
-  if (rc != 0) {
-    // ignore failures. we can always fallback to gtp0 for GTP tunnel traffic.
-    OAILOG_ERROR(
-        LOG_GTPV1U, "gtp port create: [%s] failed: %d", gtp_port_create, rc);
-  } else {
-    OAILOG_DEBUG(
-        LOG_GTPV1U, "gtp port create done: for ENB: %s ", inet_ntoa(enb_addr));
-  }
-
-  return get_gtp_port_no(port_name);
-}
-
-/**
- * seach port in cached table. otherwise create tunnel and
- * retrieve port number from OVSDB.
+ * Look the port up in the OVSDB client cache, otherwise create the tunnel
+ * port and wait for OVS to number it.
  */
 static uint32_t find_gtp_port_no(struct in_addr enb_addr) {
   if (!spgw_config.sgw_config.ovs_config.multi_tunnel) {
@@ -193,35 +65,45 @@ static uint32_t find_gtp_port_no(struct in_addr enb_addr) {
   char port_name[MAX_GTP_PORT_NAME_LENGTH];
   ip_addr_to_gtp_port_name(enb_addr, port_name);
 
-  uint32_t portno = search_portno_records(port_name);
+  uint32_t portno = ovsdb_client_get_ofport(port_name);
   if (portno) {
     return portno;
   }
 
-  portno = create_gtp_port(enb_addr, port_name);
-  add_portno_rec(port_name, portno);
+  portno = ovsdb_client_add_tunnel_port(
+      bdata(spgw_config.sgw_config.ovs_config.bridge_name), port_name,
+      ovs_gtp_type, inet_ntoa(enb_addr));
+  if (!portno) {
+    // we can always fallback to gtp0 for GTP tunnel traffic.
+    OAILOG_ERROR(
+        LOG_GTPV1U, "gtp port create failed for ENB: %s, using gtp0\n",
+        inet_ntoa(enb_addr));
+  } else {
+    OAILOG_DEBUG(
+        LOG_GTPV1U, "gtp port create done: for ENB: %s port %u\n",
+        inet_ntoa(enb_addr), portno);
+  }
   return portno;
 }
 
 /**
- * Initialize GTP port table for caching GTP tunnel port numbers.
+ * Connect to OVSDB, which caches the GTP tunnel port numbers.
  */
 static void openflow_multi_tunnel_init(void) {
-  char* probe_gtp_type = "sudo ovs-vsctl list Open_vSwitch | grep gtpu";
+  if (ovsdb_client_init(OVSDB_SOCKET_PATH) < 0) {
+    OAILOG_ERROR(
+        LOG_GTPV1U, "Could not connect to OVSDB at %s, retrying\n",
+        OVSDB_SOCKET_PATH);
+  }
 
   // OVS GTP tunnel type has changed upstream, for better compatibility
   // detect it on initilization.
-  int rc = system(probe_gtp_type);
-  if (rc != 0) {
-    ovs_gtp_type = strdup("gtp");
+  if (ovsdb_client_has_interface_type("gtpu")) {
+    ovs_gtp_type = "gtpu";
   } else {
-    ovs_gtp_type = strdup("gtpu");
+    ovs_gtp_type = "gtp";
   }
   OAILOG_INFO(LOG_GTPV1U, "Using GTP type: %s", ovs_gtp_type);
-
-  gtp_portno_rec.arr = calloc(INIT_GTP_TABLE_SIZE, sizeof(struct gtp_portno));
-  assert(gtp_portno_rec.arr != NULL);
-  gtp_portno_rec.size = INIT_GTP_TABLE_SIZE;
 }
 
 // tunnel flows
@@ -230,12 +112,44 @@ int openflow_uninit(void) {
   if ((ret = stop_of_controller()) < 0) {
     OAILOG_ERROR(LOG_GTPV1U, "Could not stop openflow controller on uninit\n");
   }
+  if (spgw_config.sgw_config.ovs_config.multi_tunnel) {
+    ovsdb_client_exit();
+  }
   return ret;
 }
 
+/**
+ * Reports the flows of a tunnel to SPGW once the switch answered for them,
+ * called from the controller thread
+ */
+static void openflow_tunnel_flows_done(
+    bool add, uint32_t i_tei, const char* imsi, bool success) {
+  MessageDef* message_p = itti_alloc_new_message(
+      TASK_SPGW_APP,
+      add ? GTPV1U_CREATE_TUNNEL_RESP : GTPV1U_DELETE_TUNNEL_RESP);
+  imsi64_t imsi64 = INVALID_IMSI64;
+
+  if (!message_p) {
+    return;
+  }
+  if (imsi) {
+    IMSI_STRING_TO_IMSI64(imsi, &imsi64);
+  }
+  if (add) {
+    message_p->ittiMsg.gtpv1uCreateTunnelResp.status   = success ? 0 : 0xFF;
+    message_p->ittiMsg.gtpv1uCreateTunnelResp.S1u_teid = i_tei;
+  } else {
+    message_p->ittiMsg.gtpv1uDeleteTunnelResp.status   = success ? 0 : 0xFF;
+    message_p->ittiMsg.gtpv1uDeleteTunnelResp.S1u_teid = i_tei;
+  }
+  message_p->ittiMsgHeader.imsi = imsi64;
+  send_msg_to_task(&spgw_app_task_zmq_ctx, TASK_SPGW_APP, message_p);
+}
+
 int openflow_init(
     struct in_addr* ue_net, uint32_t mask, int mtu, int* fd0, int* fd1u,
     bool persist_state) {
+  openflow_controller_set_tunnel_cb(openflow_tunnel_flows_done);
   AssertFatal(
       start_of_controller(persist_state) >= 0,
       "Could not start openflow controller\n");
@@ -258,6 +172,21 @@ int openflow_add_tunnel(
       flow_precedence_dl, gtp_portno);
 }
 
+int openflow_reconcile_add_tunnel(
+    struct in_addr ue, struct in6_addr* ue_ipv6, int vlan, struct in_addr enb,
+    uint32_t i_tei, uint32_t o_tei, Imsi_t imsi, struct ip_flow_dl* flow_dl,
+    uint32_t flow_precedence_dl) {
+  uint32_t gtp_portno = find_gtp_port_no(enb);
+
+  return openflow_controller_add_reconciled_gtp_tunnel(
+      ue, ue_ipv6, vlan, enb, i_tei, o_tei, (const char*) imsi.digit, flow_dl,
+      flow_precedence_dl, gtp_portno);
+}
+
+int openflow_reconcile_tunnels(void) {
+  return openflow_controller_reconcile_gtp_tunnels();
+}
+
 int openflow_del_tunnel(
     struct in_addr enb, struct in_addr ue, struct in6_addr* ue_ipv6,
     uint32_t i_tei, uint32_t o_tei, struct ip_flow_dl* flow_dl) {
@@ -352,6 +281,8 @@ static const struct gtp_tunnel_ops openflow_ops = {
     .delete_paging_rule     = openflow_delete_paging_rule,
     .send_end_marker        = openflow_send_end_marker,
     .get_dev_name           = openflow_get_dev_name,
+    .reconcile_add_tunnel   = openflow_reconcile_add_tunnel,
+    .reconcile_tunnels      = openflow_reconcile_tunnels,
 };
 
 const struct gtp_tunnel_ops* gtp_tunnel_ops_init_openflow(void) {
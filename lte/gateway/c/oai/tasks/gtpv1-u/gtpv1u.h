@@ -129,6 +129,15 @@ struct ip_flow_dl {
  * int (*send_end_marker) (struct in_addr enb, uint32_t i_tei);
  *        @enb: eNB IP address
  *        @i_tei: RX GTP Tunnel ID
+ *
+ * int (*reconcile_add_tunnel)(struct in_addr ue, ...);
+ *     Same arguments as add_tunnel. Collects a tunnel of the state restored
+ *     after a restart, NULL when the datapath keeps no tunnel across
+ *     restarts.
+ *
+ * int (*reconcile_tunnels)(void);
+ *     Installs the collected tunnels missing from the datapath and removes
+ *     the tunnels of the datapath that were not collected.
  */
 struct gtp_tunnel_ops {
   int (*init)(
@@ -153,6 +162,11 @@ struct gtp_tunnel_ops {
   int (*delete_paging_rule)(struct in_addr ue);
   int (*send_end_marker)(struct in_addr enbode, uint32_t i_tei);
   const char* (*get_dev_name)(void);
+  int (*reconcile_add_tunnel)(
+      struct in_addr ue, struct in6_addr* ue_ipv6, int vlan, struct in_addr enb,
+      uint32_t i_tei, uint32_t o_tei, Imsi_t imsi, struct ip_flow_dl* flow_dl,
+      uint32_t flow_precedence_dl);
+  int (*reconcile_tunnels)(void);
 };
 
 #if ENABLE_OPENFLOW
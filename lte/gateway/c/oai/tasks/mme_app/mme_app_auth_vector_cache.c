@@ -0,0 +1,261 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file mme_app_auth_vector_cache.c
+  \brief Authentication vectors kept from one AIR for the next attaches
+
+  The UE context holds MAX_EPS_AUTH_VECTORS vectors and loses them on detach,
+  so that each attach waits for an AIR round trip to the HSS. With the cache
+  enabled the AIRs ask for more vectors, and the ones the UE context does not
+  hold are kept per IMSI, least recently used IMSI out first, to answer the
+  next AIR of the UE without the HSS.
+
+  The MME cannot read the SQN of a vector, so kept vectors are only used
+  while they are likely to be fresh for the USIM, 3GPP TS 33.102 Annex C:
+  they are handed out in the order of the HSS and only once, never after a
+  newer AIA for the IMSI, a re-synchronisation or a Cancel Location, and not
+  after auth_vector_cache_config_t.ttl_sec.
+*/
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/queue.h>
+
+#include "log.h"
+#include "bstrlib.h"
+#include "common_defs.h"
+#include "conversions.h"
+#include "hashtable.h"
+#include "intertask_interface.h"
+#include "mme_app_auth_vector_cache.h"
+#include "mme_app_defs.h"
+#include "mme_config.h"
+#include "s6a_messages_types.h"
+#include "service303.h"
+
+#define USEC_PER_SEC 1000000
+
+static auth_vector_cache_t _cache;
+
+//------------------------------------------------------------------------------
+// Entries are owned by the LRU list
+static void _no_free(void** entry) {}
+
+//------------------------------------------------------------------------------
+static void _remove(
+    auth_vector_cache_t* cache, cached_auth_vectors_t* entry,
+    const char* reason) {
+  void* unused = NULL;
+
+  if (reason && entry->next < entry->nb_vectors) {
+    increment_counter(
+        "mme_auth_vector_cache_dropped_vectors",
+        entry->nb_vectors - entry->next, 1, "reason", reason);
+  }
+  hashtable_remove(cache->imsis, entry->imsi64, &unused);
+  TAILQ_REMOVE(&cache->lru, entry, lru_entries);
+  cache->nb_ues--;
+  set_gauge("mme_auth_vector_cache_ues", cache->nb_ues, NO_LABELS);
+  // Vectors carry KASME
+  memset(entry, 0, sizeof(*entry));
+  free(entry);
+}
+
+//------------------------------------------------------------------------------
+static cached_auth_vectors_t* _find(
+    const auth_vector_cache_t* cache, imsi64_t imsi64) {
+  void* entry = NULL;
+
+  if (!cache->imsis ||
+      hashtable_get(cache->imsis, imsi64, &entry) != HASH_TABLE_OK) {
+    return NULL;
+  }
+  return (cached_auth_vectors_t*) entry;
+}
+
+//------------------------------------------------------------------------------
+static bool _expired(
+    const auth_vector_cache_t* cache, const cached_auth_vectors_t* entry,
+    int64_t now_usec) {
+  return now_usec - entry->stored_usec >=
+         (int64_t) cache->config->ttl_sec * USEC_PER_SEC;
+}
+
+//------------------------------------------------------------------------------
+void auth_vector_cache_init(
+    auth_vector_cache_t* cache, const auth_vector_cache_config_t* config) {
+  memset(cache, 0, sizeof(*cache));
+  cache->config = config;
+  TAILQ_INIT(&cache->lru);
+  if (!config->max_ues) {
+    return;
+  }
+  cache->imsis = hashtable_create(
+      config->max_ues, NULL, _no_free, bfromcstr("auth_vector_cache"));
+  cache->imsis->log_enabled = false;
+}
+
+//------------------------------------------------------------------------------
+void auth_vector_cache_free(auth_vector_cache_t* cache) {
+  cached_auth_vectors_t* entry = NULL;
+
+  while ((entry = TAILQ_FIRST(&cache->lru))) {
+    _remove(cache, entry, NULL);
+  }
+  if (cache->imsis) {
+    hashtable_destroy(cache->imsis);
+    cache->imsis = NULL;
+  }
+}
+
+//------------------------------------------------------------------------------
+void auth_vector_cache_put(
+    auth_vector_cache_t* cache, imsi64_t imsi64, uint8_t nb_vectors,
+    const eutran_vector_t* vectors, int64_t now_usec) {
+  cached_auth_vectors_t* entry = NULL;
+
+  if (!cache->imsis || !nb_vectors) {
+    return;
+  }
+  if ((entry = _find(cache, imsi64))) {
+    _remove(cache, entry, "replaced");
+  }
+  // Make room at the least recently used end, expired entries met there go
+  // even when there is room
+  while ((entry = TAILQ_LAST(&cache->lru, cached_auth_vectors_lru_s)) &&
+         (cache->nb_ues >= cache->config->max_ues ||
+          _expired(cache, entry, now_usec))) {
+    _remove(
+        cache, entry,
+        _expired(cache, entry, now_usec) ? "expired" : "evicted");
+  }
+
+  if (nb_vectors > AUTH_VECTOR_CACHE_MAX_VECTORS) {
+    nb_vectors = AUTH_VECTOR_CACHE_MAX_VECTORS;
+  }
+  entry              = calloc(1, sizeof(*entry));
+  entry->imsi64      = imsi64;
+  entry->stored_usec = now_usec;
+  entry->nb_vectors  = nb_vectors;
+  memcpy(entry->vector, vectors, nb_vectors * sizeof(eutran_vector_t));
+  hashtable_insert(cache->imsis, imsi64, entry);
+  TAILQ_INSERT_HEAD(&cache->lru, entry, lru_entries);
+  cache->nb_ues++;
+  set_gauge("mme_auth_vector_cache_ues", cache->nb_ues, NO_LABELS);
+}
+
+//------------------------------------------------------------------------------
+auth_vector_cache_result_t auth_vector_cache_take(
+    auth_vector_cache_t* cache, imsi64_t imsi64, eutran_vector_t* vector,
+    int64_t now_usec) {
+  cached_auth_vectors_t* entry = _find(cache, imsi64);
+
+  if (!entry) {
+    increment_counter("mme_auth_vector_cache", 1, 1, "result", "miss");
+    return AUTH_VECTOR_CACHE_MISS;
+  }
+  if (_expired(cache, entry, now_usec)) {
+    _remove(cache, entry, "expired");
+    increment_counter("mme_auth_vector_cache", 1, 1, "result", "expired");
+    return AUTH_VECTOR_CACHE_EXPIRED;
+  }
+
+  *vector = entry->vector[entry->next];
+  memset(&entry->vector[entry->next], 0, sizeof(eutran_vector_t));
+  entry->next++;
+  if (entry->next == entry->nb_vectors) {
+    _remove(cache, entry, NULL);
+  } else {
+    TAILQ_REMOVE(&cache->lru, entry, lru_entries);
+    TAILQ_INSERT_HEAD(&cache->lru, entry, lru_entries);
+  }
+  increment_counter("mme_auth_vector_cache", 1, 1, "result", "hit");
+  return AUTH_VECTOR_CACHE_HIT;
+}
+
+//------------------------------------------------------------------------------
+void auth_vector_cache_drop(
+    auth_vector_cache_t* cache, imsi64_t imsi64, const char* reason) {
+  cached_auth_vectors_t* entry = _find(cache, imsi64);
+
+  if (entry) {
+    _remove(cache, entry, reason);
+  }
+}
+
+//------------------------------------------------------------------------------
+void mme_app_auth_vector_cache_start(void) {
+  auth_vector_cache_init(&_cache, &mme_config.auth_vector_cache_config);
+}
+
+//------------------------------------------------------------------------------
+void mme_app_auth_vector_cache_stop(void) {
+  auth_vector_cache_free(&_cache);
+}
+
+//------------------------------------------------------------------------------
+bool mme_app_auth_vector_cache_answer_air(MessageDef* message_p) {
+  s6a_auth_info_req_t* air = &S6A_AUTH_INFO_REQ(message_p);
+  imsi64_t imsi64          = INVALID_IMSI64;
+  MessageDef* answer_p     = NULL;
+  s6a_auth_info_ans_t* aia = NULL;
+
+  if (!_cache.imsis) {
+    return false;
+  }
+  IMSI_STRING_TO_IMSI64(air->imsi, &imsi64);
+  air->nb_of_vectors = _cache.config->vectors_per_air;
+  // The HSS moves its SQN past the kept vectors to re-synchronise
+  if (air->re_synchronization) {
+    auth_vector_cache_drop(&_cache, imsi64, "resync");
+    return false;
+  }
+
+  answer_p = itti_alloc_new_message(TASK_MME_APP, S6A_AUTH_INFO_ANS);
+  aia      = &S6A_AUTH_INFO_ANS(answer_p);
+  if (auth_vector_cache_take(
+          &_cache, imsi64, &aia->auth_info.eutran_vector[0], zclock_usecs()) !=
+      AUTH_VECTOR_CACHE_HIT) {
+    free(answer_p);
+    return false;
+  }
+  OAILOG_DEBUG(
+      LOG_MME_APP, "Answering AIR of IMSI " IMSI_64_FMT " from cache\n",
+      imsi64);
+  memcpy(aia->imsi, air->imsi, sizeof(aia->imsi));
+  aia->imsi_length             = air->imsi_length;
+  aia->result.present          = S6A_RESULT_BASE;
+  aia->result.choice.base      = DIAMETER_SUCCESS;
+  aia->auth_info.nb_of_vectors = 1;
+  answer_p->ittiMsgHeader.imsi = imsi64;
+  send_msg_to_task(&mme_app_task_zmq_ctx, TASK_MME_APP, answer_p);
+  free(message_p);
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void mme_app_auth_vector_cache_store(
+    imsi64_t imsi64, uint8_t nb_vectors, const eutran_vector_t* vectors) {
+  auth_vector_cache_put(&_cache, imsi64, nb_vectors, vectors, zclock_usecs());
+}
+
+//------------------------------------------------------------------------------
+void mme_app_auth_vector_cache_invalidate(imsi64_t imsi64, const char* reason) {
+  auth_vector_cache_drop(&_cache, imsi64, reason);
+}
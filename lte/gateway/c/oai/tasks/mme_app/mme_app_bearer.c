@@ -73,6 +73,7 @@
 #include "secu_defs.h"
 #include "esm_proc.h"
 #include "mme_app_pdn_context.h"
+#include "procedure_trace.h"
 
 #if EMBEDDED_SGW
 #define TASK_SPGW TASK_SPGW_APP
@@ -255,13 +256,13 @@ int _send_pcrf_bearer_actv_rsp(
       "Sending create_dedicated_bearer_rsp to SGW with EBI %u s1u teid %u\n",
       ebi, bc->s_gw_fteid_s1u.teid);
   send_msg_to_task(&mme_app_task_zmq_ctx, TASK_SPGW, message_p);
+  procedure_trace_end(
+      TRACE_KEY_MME_UE_S1AP_ID(ue_context_p->mme_ue_s1ap_id),
+      TRACE_PROCEDURE_DEDICATED_BEARER);
   OAILOG_FUNC_RETURN(LOG_MME_APP, RETURNok);
 }
 
 //---------------------------------------------------------------------------
-static bool mme_app_construct_guti(
-    const plmn_t* const plmn_p, const s_tmsi_t* const s_tmsi_p,
-    guti_t* const guti_p);
 static void notify_s1ap_new_ue_mme_s1ap_id_association(
     struct ue_mm_context_s* ue_context_p);
 
@@ -292,6 +293,8 @@ void mme_app_handle_conn_est_cnf(
     OAILOG_FUNC_OUT(LOG_MME_APP);
   }
   emm_context = ue_context_p->emm_context;
+  // The key caches stay owned by ue_context_p
+  emm_context._security.key_caches = NULL;
   /* Check that if Service Request is recieved in response to SGS Paging for MT
    * SMS */
   if (ue_context_p->sgs_context) {
@@ -453,17 +456,28 @@ void mme_app_handle_conn_est_cnf(
     OAILOG_FUNC_OUT(LOG_MME_APP);
   }
 
-  derive_keNB(
-      emm_context._vector[emm_context._security.vector_index].kasme,
+  // already keyed with this KASME by the security mode control procedure,
+  // unless the UE has been idle since; emm_context is a copy, the key caches
+  // belong to the UE context
+  kdf_context_t one_time_kdf_ctx = {0};
+  kdf_context_t* kdf_ctx =
+      emm_security_context_kdf_context(&ue_context_p->emm_context._security);
+  if (!kdf_ctx) {
+    kdf_ctx = &one_time_kdf_ctx;
+  }
+  kdf_context_set_key(
+      kdf_ctx, emm_context._vector[emm_context._security.vector_index].kasme);
+  derive_keNB_with_context(
+      kdf_ctx,
       emm_context._security.kenb_ul_count.seq_num |
           (emm_context._security.kenb_ul_count.overflow << 8),
       establishment_cnf_p->kenb);
 
   /* Genarate Next HOP key parameter */
-  derive_NH(
-      emm_context._vector[emm_context._security.vector_index].kasme,
-      establishment_cnf_p->kenb, emm_context._security.next_hop,
+  derive_NH_chain(
+      kdf_ctx, establishment_cnf_p->kenb, 1, emm_context._security.next_hop,
       &emm_context._security.next_hop_chaining_count);
+  kdf_context_clear(&one_time_kdf_ctx);
 
   OAILOG_DEBUG_UE(
       LOG_MME_APP, emm_context._imsi64,
@@ -475,6 +489,9 @@ void mme_app_handle_conn_est_cnf(
       establishment_cnf_p->ue_security_capabilities_integrity_algorithms);
 
   message_p->ittiMsgHeader.imsi = ue_context_p->emm_context._imsi64;
+  procedure_trace_span_start(
+      TRACE_KEY_MME_UE_S1AP_ID(ue_context_p->mme_ue_s1ap_id),
+      TRACE_STAGE_ENB);
   send_msg_to_task(&mme_app_task_zmq_ctx, TASK_S1AP, message_p);
 
   /*
@@ -544,7 +561,6 @@ imsi64_t mme_app_handle_initial_ue_message(
     itti_s1ap_initial_ue_message_t* const initial_pP) {
   OAILOG_FUNC_IN(LOG_MME_APP);
   struct ue_mm_context_s* ue_context_p = NULL;
-  bool is_guti_valid                   = false;
   bool is_mm_ctx_new                   = false;
   enb_s1ap_id_key_t enb_s1ap_id_key    = INVALID_ENB_UE_S1AP_ID_KEY;
   imsi64_t imsi64                      = INVALID_IMSI64;
@@ -565,87 +581,79 @@ imsi64_t mme_app_handle_initial_ue_message(
         "INITIAL UE Message: Valid mme_code %u and S-TMSI %u received from "
         "eNB.\n",
         initial_pP->opt_s_tmsi.mme_code, initial_pP->opt_s_tmsi.m_tmsi);
-    guti_t guti = {.gummei.plmn     = {0},
-                   .gummei.mme_gid  = 0,
-                   .gummei.mme_code = 0,
-                   .m_tmsi          = INVALID_M_TMSI};
-    plmn_t plmn;
-    COPY_PLMN(plmn, (initial_pP->tai.plmn));
-    is_guti_valid =
-        mme_app_construct_guti(&plmn, &(initial_pP->opt_s_tmsi), &guti);
-    if (is_guti_valid) {
-      ue_context_p =
-          mme_ue_context_exists_guti(&mme_app_desc_p->mme_ue_contexts, &guti);
-      if (ue_context_p) {
-        initial_pP->mme_ue_s1ap_id = ue_context_p->mme_ue_s1ap_id;
-        if (ue_context_p->enb_s1ap_id_key != INVALID_ENB_UE_S1AP_ID_KEY) {
-          /*
-           * Ideally this should never happen. When UE moves to IDLE,
-           * this key is set to INVALID.
-           * Note - This can happen if eNB detects RLF late and by that time
-           * UE sends Initial NAS message via new RRC connection.
-           * However if this key is valid, remove the key from the hashtable.
-           */
+    if (mme_app_is_served_s_tmsi(
+            &initial_pP->tai.plmn, &initial_pP->opt_s_tmsi)) {
+      ue_context_p = mme_ue_context_exists_s_tmsi(
+          &mme_app_desc_p->mme_ue_contexts, &initial_pP->opt_s_tmsi);
+    } else {
+      OAILOG_DEBUG(
+          LOG_MME_APP,
+          "No MME is configured with MME code %u received in S-TMSI %u from "
+          "UE.\n",
+          initial_pP->opt_s_tmsi.mme_code, initial_pP->opt_s_tmsi.m_tmsi);
+    }
+    if (ue_context_p) {
+      initial_pP->mme_ue_s1ap_id = ue_context_p->mme_ue_s1ap_id;
+      if (ue_context_p->enb_s1ap_id_key != INVALID_ENB_UE_S1AP_ID_KEY) {
+        /*
+         * Ideally this should never happen. When UE moves to IDLE,
+         * this key is set to INVALID.
+         * Note - This can happen if eNB detects RLF late and by that time
+         * UE sends Initial NAS message via new RRC connection.
+         * However if this key is valid, remove the key from the hashtable.
+         */
 
-          OAILOG_ERROR(
-              LOG_MME_APP,
-              "MME_APP_INITAIL_UE_MESSAGE: enb_s1ap_id_key %ld has "
-              "valid value \n",
-              ue_context_p->enb_s1ap_id_key);
-          // Inform s1ap for local cleanup of enb_ue_s1ap_id from ue context
-          ue_context_p->ue_context_rel_cause = S1AP_INVALID_ENB_ID;
-          OAILOG_ERROR(
-              LOG_MME_APP,
-              " Sending UE Context Release to S1AP for ue_id =(%u)\n",
+        OAILOG_ERROR(
+            LOG_MME_APP,
+            "MME_APP_INITAIL_UE_MESSAGE: enb_s1ap_id_key %ld has "
+            "valid value \n",
+            ue_context_p->enb_s1ap_id_key);
+        // Inform s1ap for local cleanup of enb_ue_s1ap_id from ue context
+        ue_context_p->ue_context_rel_cause = S1AP_INVALID_ENB_ID;
+        OAILOG_ERROR(
+            LOG_MME_APP,
+            " Sending UE Context Release to S1AP for ue_id =(%u)\n",
+            ue_context_p->mme_ue_s1ap_id);
+        mme_app_itti_ue_context_release(
+            ue_context_p, ue_context_p->ue_context_rel_cause);
+        hashtable_uint64_ts_remove(
+            mme_app_desc_p->mme_ue_contexts.enb_ue_s1ap_id_ue_context_htbl,
+            (const hash_key_t) ue_context_p->enb_s1ap_id_key);
+        ue_context_p->enb_s1ap_id_key      = INVALID_ENB_UE_S1AP_ID_KEY;
+        ue_context_p->ue_context_rel_cause = S1AP_INVALID_CAUSE;
+      }
+      // Update MME UE context with new enb_ue_s1ap_id
+      ue_context_p->enb_ue_s1ap_id = initial_pP->enb_ue_s1ap_id;
+      // regenerate the enb_s1ap_id_key as enb_ue_s1ap_id is changed.
+      MME_APP_ENB_S1AP_ID_KEY(
+          enb_s1ap_id_key, initial_pP->enb_id, initial_pP->enb_ue_s1ap_id);
+      // Update enb_s1ap_id_key in hashtable
+      mme_ue_context_update_coll_keys(
+          &mme_app_desc_p->mme_ue_contexts, ue_context_p, enb_s1ap_id_key,
+          ue_context_p->mme_ue_s1ap_id, ue_context_p->emm_context._imsi64,
+          ue_context_p->mme_teid_s11, &ue_context_p->emm_context._guti);
+      imsi64 = ue_context_p->emm_context._imsi64;
+      // Check if paging timer exists for UE and remove
+      if (ue_context_p->paging_response_timer.id != MME_APP_TIMER_INACTIVE_ID) {
+        nas_itti_timer_arg_t* timer_argP = NULL;
+        if (timer_remove(
+                ue_context_p->paging_response_timer.id,
+                (void**) &timer_argP)) {
+          OAILOG_ERROR_UE(
+              LOG_MME_APP, imsi64,
+              "Failed to stop paging response timer for UE id %d\n",
               ue_context_p->mme_ue_s1ap_id);
-          mme_app_itti_ue_context_release(
-              ue_context_p, ue_context_p->ue_context_rel_cause);
-          hashtable_uint64_ts_remove(
-              mme_app_desc_p->mme_ue_contexts.enb_ue_s1ap_id_ue_context_htbl,
-              (const hash_key_t) ue_context_p->enb_s1ap_id_key);
-          ue_context_p->enb_s1ap_id_key      = INVALID_ENB_UE_S1AP_ID_KEY;
-          ue_context_p->ue_context_rel_cause = S1AP_INVALID_CAUSE;
         }
-        // Update MME UE context with new enb_ue_s1ap_id
-        ue_context_p->enb_ue_s1ap_id = initial_pP->enb_ue_s1ap_id;
-        // regenerate the enb_s1ap_id_key as enb_ue_s1ap_id is changed.
-        MME_APP_ENB_S1AP_ID_KEY(
-            enb_s1ap_id_key, initial_pP->enb_id, initial_pP->enb_ue_s1ap_id);
-        // Update enb_s1ap_id_key in hashtable
-        mme_ue_context_update_coll_keys(
-            &mme_app_desc_p->mme_ue_contexts, ue_context_p, enb_s1ap_id_key,
-            ue_context_p->mme_ue_s1ap_id, ue_context_p->emm_context._imsi64,
-            ue_context_p->mme_teid_s11, &guti);
-        imsi64 = ue_context_p->emm_context._imsi64;
-        // Check if paging timer exists for UE and remove
-        if (ue_context_p->paging_response_timer.id !=
-            MME_APP_TIMER_INACTIVE_ID) {
-          nas_itti_timer_arg_t* timer_argP = NULL;
-          if (timer_remove(
-                  ue_context_p->paging_response_timer.id,
-                  (void**) &timer_argP)) {
-            OAILOG_ERROR_UE(
-                LOG_MME_APP, imsi64,
-                "Failed to stop paging response timer for UE id %d\n",
-                ue_context_p->mme_ue_s1ap_id);
-          }
-          if (timer_argP) {
-            free_wrapper((void**) &timer_argP);
-          }
-          ue_context_p->paging_response_timer.id = MME_APP_TIMER_INACTIVE_ID;
-          ue_context_p->time_paging_response_timer_started = 0;
-          ue_context_p->paging_retx_count                  = 0;
+        if (timer_argP) {
+          free_wrapper((void**) &timer_argP);
         }
-      } else {
-        OAILOG_DEBUG(
-            LOG_MME_APP, "No UE context found for MME code %u and S-TMSI %u\n",
-            initial_pP->opt_s_tmsi.mme_code, initial_pP->opt_s_tmsi.m_tmsi);
+        ue_context_p->paging_response_timer.id = MME_APP_TIMER_INACTIVE_ID;
+        ue_context_p->time_paging_response_timer_started = 0;
+        ue_context_p->paging_retx_count                  = 0;
       }
     } else {
       OAILOG_DEBUG(
-          LOG_MME_APP,
-          "No MME is configured with MME code %u received in S-TMSI %u from "
-          "UE.\n",
+          LOG_MME_APP, "No UE context found for MME code %u and S-TMSI %u\n",
           initial_pP->opt_s_tmsi.mme_code, initial_pP->opt_s_tmsi.m_tmsi);
     }
   } else {
@@ -720,10 +728,21 @@ imsi64_t mme_app_handle_initial_ue_message(
       ue_context_p->mme_ue_s1ap_id);
 
   mme_ue_s1ap_id_t ue_id = ue_context_p->mme_ue_s1ap_id;
+  // The trace S1AP started under the eNB ids goes on under the MME ones
+  MME_APP_ENB_S1AP_ID_KEY(
+      enb_s1ap_id_key, initial_pP->enb_id, initial_pP->enb_ue_s1ap_id);
+  procedure_trace_alias(
+      TRACE_KEY_ENB_S1AP_ID(enb_s1ap_id_key), TRACE_KEY_MME_UE_S1AP_ID(ue_id));
+  if (ue_context_p->emm_context._imsi64 != INVALID_IMSI64) {
+    procedure_trace_alias(
+        TRACE_KEY_MME_UE_S1AP_ID(ue_id),
+        TRACE_KEY_IMSI(ue_context_p->emm_context._imsi64));
+  }
   nas_proc_establish_ind(
       ue_context_p->mme_ue_s1ap_id, is_mm_ctx_new, initial_pP->tai,
       initial_pP->ecgi, initial_pP->rrc_establishment_cause, s_tmsi,
       &initial_pP->nas);
+  procedure_trace_task_span(TRACE_KEY_MME_UE_S1AP_ID(ue_id), TRACE_STAGE_NAS);
 
   initial_pP->nas = NULL;
   /* In case duplicate attach handling, ue_context_p might be removed
@@ -1039,6 +1058,9 @@ int mme_app_handle_create_sess_resp(
       LOG_MME_APP, ue_context_p->emm_context._imsi64,
       "MME S11 teid = %u, cause = %d, ue_id = %u\n", create_sess_resp_pP->teid,
       create_sess_resp_pP->cause.cause_value, ue_context_p->mme_ue_s1ap_id);
+  procedure_trace_span_end(
+      TRACE_KEY_MME_UE_S1AP_ID(ue_context_p->mme_ue_s1ap_id),
+      TRACE_STAGE_SPGW);
 
   proc_tid_t transaction_identifier = 0;
   pdn_cid_t pdn_cx_id               = 0;
@@ -1558,6 +1580,9 @@ void mme_app_handle_initial_context_setup_rsp(
         initial_ctxt_setup_rsp_p->ue_id);
     OAILOG_FUNC_OUT(LOG_MME_APP);
   }
+  procedure_trace_span_end(
+      TRACE_KEY_MME_UE_S1AP_ID(initial_ctxt_setup_rsp_p->ue_id),
+      TRACE_STAGE_ENB);
 
   /* Stop Initial context setup process guard timer,if running.
    * Do not process the message if timer is not running because
@@ -1599,6 +1624,12 @@ void mme_app_handle_initial_context_setup_rsp(
     if (ue_context_p->location_info_confirmed_in_hss == true) {
       mme_app_send_s6a_update_location_req(ue_context_p);
     }
+    procedure_trace_task_span(
+        TRACE_KEY_MME_UE_S1AP_ID(ue_context_p->mme_ue_s1ap_id),
+        TRACE_STAGE_NAS);
+    procedure_trace_end(
+        TRACE_KEY_MME_UE_S1AP_ID(ue_context_p->mme_ue_s1ap_id),
+        TRACE_PROCEDURE_SERVICE_REQUEST);
     if (ue_context_p->sgs_context) {
       ue_context_p->sgs_context->csfb_service_type = CSFB_SERVICE_NONE;
       // Reset mt_call_in_progress flag
@@ -2013,70 +2044,6 @@ void mme_app_handle_initial_context_setup_failure(
   }
   OAILOG_FUNC_OUT(LOG_MME_APP);
 }
-//------------------------------------------------------------------------------
-static bool mme_app_construct_guti(
-    const plmn_t* const plmn_p, const s_tmsi_t* const s_tmsi_p,
-    guti_t* const guti_p) {
-  /*
-   * This is a helper function to construct GUTI from S-TMSI. It uses PLMN id
-   * and MME Group Id of the serving MME for this purpose.
-   *
-   */
-
-  bool is_guti_valid =
-      false;  // Set to true if serving MME is found and GUTI is constructed
-  uint8_t num_mme         = 0;  // Number of configured MME in the MME pool
-  guti_p->m_tmsi          = s_tmsi_p->m_tmsi;
-  guti_p->gummei.mme_code = s_tmsi_p->mme_code;
-  // Create GUTI by using PLMN Id and MME-Group Id of serving MME
-  OAILOG_DEBUG(
-      LOG_MME_APP,
-      "Construct GUTI using S-TMSI received form UE and MME Group Id and PLMN "
-      "id "
-      "from MME Conf: %u, %u \n",
-      s_tmsi_p->m_tmsi, s_tmsi_p->mme_code);
-  mme_config_read_lock(&mme_config);
-  /*
-   * Check number of MMEs in the pool.
-   * At present it is assumed that one MME is supported in MME pool but in case
-   * there are more than one MME configured then search the serving MME using
-   * MME code. Assumption is that within one PLMN only one pool of MME will be
-   * configured
-   */
-  if (mme_config.gummei.nb > 1) {
-    OAILOG_DEBUG(LOG_MME_APP, "More than one MMEs are configured.");
-  }
-  for (num_mme = 0; num_mme < mme_config.gummei.nb; num_mme++) {
-    /*Verify that the MME code within S-TMSI is same as what is configured in
-     * MME conf*/
-    if ((plmn_p->mcc_digit2 ==
-         mme_config.gummei.gummei[num_mme].plmn.mcc_digit2) &&
-        (plmn_p->mcc_digit1 ==
-         mme_config.gummei.gummei[num_mme].plmn.mcc_digit1) &&
-        (plmn_p->mnc_digit3 ==
-         mme_config.gummei.gummei[num_mme].plmn.mnc_digit3) &&
-        (plmn_p->mcc_digit3 ==
-         mme_config.gummei.gummei[num_mme].plmn.mcc_digit3) &&
-        (plmn_p->mnc_digit2 ==
-         mme_config.gummei.gummei[num_mme].plmn.mnc_digit2) &&
-        (plmn_p->mnc_digit1 ==
-         mme_config.gummei.gummei[num_mme].plmn.mnc_digit1) &&
-        (guti_p->gummei.mme_code ==
-         mme_config.gummei.gummei[num_mme].mme_code)) {
-      break;
-    }
-  }
-  if (num_mme >= mme_config.gummei.nb) {
-    OAILOG_DEBUG(LOG_MME_APP, "No MME serves this UE");
-  } else {
-    guti_p->gummei.plmn    = mme_config.gummei.gummei[num_mme].plmn;
-    guti_p->gummei.mme_gid = mme_config.gummei.gummei[num_mme].mme_gid;
-    is_guti_valid          = true;
-  }
-  mme_config_unlock(&mme_config);
-  return is_guti_valid;
-}
-
 //------------------------------------------------------------------------------
 static void notify_s1ap_new_ue_mme_s1ap_id_association(
     struct ue_mm_context_s* ue_context_p) {
@@ -2981,6 +2948,9 @@ void mme_app_handle_nw_init_ded_bearer_actv_req(
       "Received Dedicated bearer activation Request from SGW for "
       "ue-id " MME_UE_S1AP_ID_FMT " with LBI %u\n",
       ue_context_p->mme_ue_s1ap_id, nw_init_bearer_actv_req_p->lbi);
+  procedure_trace_start(
+      TRACE_KEY_MME_UE_S1AP_ID(ue_context_p->mme_ue_s1ap_id),
+      TRACE_PROCEDURE_DEDICATED_BEARER);
 
   bearer_context_t* linked_bc =
       mme_app_get_bearer_context(ue_context_p, linked_eps_bearer_id);
@@ -3622,9 +3592,12 @@ void mme_app_handle_path_switch_req_ack(
         "Invalid Vector index %d for ue_id %d \n",
         emm_ctx->_security.vector_index, ue_context_p->mme_ue_s1ap_id);
   }
-  derive_NH(
-      emm_ctx->_vector[emm_ctx->_security.vector_index].kasme,
-      emm_ctx->_security.next_hop, emm_ctx->_security.next_hop,
+  kdf_context_t* kdf_ctx =
+      emm_security_context_kdf_context(&emm_ctx->_security);
+  kdf_context_set_key(
+      kdf_ctx, emm_ctx->_vector[emm_ctx->_security.vector_index].kasme);
+  derive_NH_chain(
+      kdf_ctx, emm_ctx->_security.next_hop, 1, emm_ctx->_security.next_hop,
       &emm_ctx->_security.next_hop_chaining_count);
 
   OAILOG_DEBUG_UE(
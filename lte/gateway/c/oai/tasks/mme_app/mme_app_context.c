@@ -56,6 +56,7 @@
 #include "esm_ebr_context.h"
 #include "timer.h"
 #include "mme_app_statistics.h"
+#include "mme_app_ue_eviction.h"
 #include "directoryd.h"
 #include "3gpp_23.003.h"
 #include "3gpp_24.008.h"
@@ -72,6 +73,7 @@
 #include "nas_timer.h"
 #include "obj_hashtable.h"
 #include "s1ap_messages_types.h"
+#include "procedure_trace.h"
 
 /* Obtain a backtrace and print it to stdout. */
 
@@ -235,9 +237,30 @@ void mme_app_ue_sgs_context_free_content(
   }
 }
 
+//------------------------------------------------------------------------------
+void mme_app_set_apn_config_profile(
+    ue_mm_context_t* const ue_context_p,
+    const apn_config_profile_t* const apn_config_profile) {
+  ue_apn_config_profile_t* profile = &ue_context_p->apn_config_profile;
+
+  free_wrapper((void**) &profile->apn_configuration);
+  profile->context_identifier = apn_config_profile->context_identifier;
+  profile->all_apn_conf_ind   = apn_config_profile->all_apn_conf_ind;
+  profile->nb_apns            = apn_config_profile->nb_apns;
+  if (profile->nb_apns) {
+    profile->apn_configuration =
+        calloc(profile->nb_apns, sizeof(struct apn_configuration_s));
+    memcpy(
+        profile->apn_configuration, apn_config_profile->apn_configuration,
+        profile->nb_apns * sizeof(struct apn_configuration_s));
+  }
+}
+
 //------------------------------------------------------------------------------
 void mme_app_ue_context_free_content(ue_mm_context_t* const ue_context_p) {
   bdestroy_wrapper(&ue_context_p->msisdn);
+  free_wrapper((void**) &ue_context_p->apn_config_profile.apn_configuration);
+  ue_context_p->apn_config_profile.nb_apns = 0;
   bdestroy_wrapper(&ue_context_p->ue_radio_capability);
   bdestroy_wrapper(&ue_context_p->apn_oi_replacement);
   nas_itti_timer_arg_t* timer_argP = NULL;
@@ -417,6 +440,19 @@ ue_mm_context_t* mme_ue_context_exists_mme_ue_s1ap_id(
   return ue_context_p;
 }
 
+//------------------------------------------------------------------------------
+// The keys of an evicted UE keep pointing at its mme_ue_s1ap_id
+static ue_mm_context_t* mme_ue_context_get_or_rehydrate(
+    const mme_ue_s1ap_id_t mme_ue_s1ap_id) {
+  ue_mm_context_t* ue_context_p =
+      mme_ue_context_exists_mme_ue_s1ap_id(mme_ue_s1ap_id);
+
+  if (!ue_context_p) {
+    ue_context_p = mme_app_ue_rehydrate(mme_ue_s1ap_id);
+  }
+  return ue_context_p;
+}
+
 //------------------------------------------------------------------------------
 struct ue_mm_context_s* mme_ue_context_exists_imsi(
     mme_ue_context_t* const mme_ue_context_p, const imsi64_t imsi) {
@@ -428,7 +464,7 @@ struct ue_mm_context_s* mme_ue_context_exists_imsi(
       &mme_ue_s1ap_id64);
 
   if (HASH_TABLE_OK == h_rc) {
-    return mme_ue_context_exists_mme_ue_s1ap_id(
+    return mme_ue_context_get_or_rehydrate(
         (mme_ue_s1ap_id_t) mme_ue_s1ap_id64);
   } else {
     OAILOG_WARNING_UE(LOG_MME_APP, imsi, " No IMSI hashtable for this IMSI\n");
@@ -447,7 +483,7 @@ struct ue_mm_context_s* mme_ue_context_exists_s11_teid(
       &mme_ue_s1ap_id64);
 
   if (HASH_TABLE_OK == h_rc) {
-    return mme_ue_context_exists_mme_ue_s1ap_id(
+    return mme_ue_context_get_or_rehydrate(
         (mme_ue_s1ap_id_t) mme_ue_s1ap_id64);
   } else {
     OAILOG_WARNING(
@@ -456,26 +492,136 @@ struct ue_mm_context_s* mme_ue_context_exists_s11_teid(
   return NULL;
 }
 
+//------------------------------------------------------------------------------
+/*
+ * Whether a GUMMEI of the MME config has the PLMN and MME code, and the MME
+ * group id unless it is NULL
+ */
+static bool mme_app_find_served_gummei(
+    const plmn_t* const plmn_p, const mme_gid_t* const mme_gid_p,
+    const mme_code_t mme_code) {
+  bool is_served = false;
+
+  mme_config_read_lock(&mme_config);
+  for (int i = 0; i < mme_config.gummei.nb; i++) {
+    const gummei_t* const gummei_p = &mme_config.gummei.gummei[i];
+    if (IS_PLMN_EQUAL((*plmn_p), gummei_p->plmn) &&
+        (mme_code == gummei_p->mme_code) &&
+        (!mme_gid_p || (*mme_gid_p == gummei_p->mme_gid))) {
+      is_served = true;
+      break;
+    }
+  }
+  mme_config_unlock(&mme_config);
+  return is_served;
+}
+
+//------------------------------------------------------------------------------
+bool mme_app_is_served_gummei(const gummei_t* const gummei_p) {
+  return mme_app_find_served_gummei(
+      &gummei_p->plmn, &gummei_p->mme_gid, gummei_p->mme_code);
+}
+
+//------------------------------------------------------------------------------
+bool mme_app_is_served_s_tmsi(
+    const plmn_t* const plmn_p, const s_tmsi_t* const s_tmsi_p) {
+  return mme_app_find_served_gummei(plmn_p, NULL, s_tmsi_p->mme_code);
+}
+
 //------------------------------------------------------------------------------
 ue_mm_context_t* mme_ue_context_exists_guti(
     mme_ue_context_t* const mme_ue_context_p, const guti_t* const guti_p) {
-  hashtable_rc_t h_rc       = HASH_TABLE_OK;
-  uint64_t mme_ue_s1ap_id64 = 0;
+  s_tmsi_t s_tmsi               = {0};
+  ue_mm_context_t* ue_context_p = NULL;
 
-  h_rc = obj_hashtable_uint64_ts_get(
-      mme_ue_context_p->guti_ue_context_htbl, (const void*) guti_p,
-      sizeof(*guti_p), &mme_ue_s1ap_id64);
+  if (!mme_app_is_served_gummei(&guti_p->gummei)) {
+    OAILOG_DEBUG(
+        LOG_MME_APP, "No MME is configured with the GUMMEI of GUTI " GUTI_FMT
+        "\n", GUTI_ARG(guti_p));
+    return NULL;
+  }
 
-  if (HASH_TABLE_OK == h_rc) {
-    return mme_ue_context_exists_mme_ue_s1ap_id(
-        (mme_ue_s1ap_id_t) mme_ue_s1ap_id64);
-  } else {
-    OAILOG_WARNING(LOG_MME_APP, " No GUTI hashtable for GUTI ");
+  s_tmsi.mme_code = guti_p->gummei.mme_code;
+  s_tmsi.m_tmsi   = guti_p->m_tmsi;
+
+  ue_context_p = mme_ue_context_exists_s_tmsi(mme_ue_context_p, &s_tmsi);
+  if (ue_context_p &&
+      (!IS_PLMN_EQUAL(
+           ue_context_p->emm_context._guti.gummei.plmn,
+           guti_p->gummei.plmn) ||
+       ue_context_p->emm_context._guti.gummei.mme_gid !=
+           guti_p->gummei.mme_gid)) {
+    OAILOG_WARNING(
+        LOG_MME_APP, "No UE context for GUTI " GUTI_FMT "\n",
+        GUTI_ARG(guti_p));
+    return NULL;
   }
+  return ue_context_p;
+}
+
+//------------------------------------------------------------------------------
+ue_mm_context_t* mme_ue_context_exists_s_tmsi(
+    mme_ue_context_t* const mme_ue_context_p, const s_tmsi_t* const s_tmsi_p) {
+  hashtable_rc_t h_rc           = HASH_TABLE_OK;
+  uint64_t mme_ue_s1ap_id64     = 0;
+  ue_mm_context_t* ue_context_p = NULL;
 
+  h_rc = hashtable_uint64_ts_get(
+      mme_ue_context_p->s_tmsi_ue_context_htbl,
+      MME_APP_S_TMSI_KEY(s_tmsi_p->mme_code, s_tmsi_p->m_tmsi),
+      &mme_ue_s1ap_id64);
+
+  if (HASH_TABLE_OK == h_rc) {
+    ue_context_p =
+        mme_ue_context_get_or_rehydrate((mme_ue_s1ap_id_t) mme_ue_s1ap_id64);
+  }
+  // The entry may outlive the GUTI of its UE
+  if (ue_context_p &&
+      ue_context_p->emm_context._guti.gummei.mme_code == s_tmsi_p->mme_code &&
+      ue_context_p->emm_context._guti.m_tmsi == s_tmsi_p->m_tmsi) {
+    return ue_context_p;
+  }
+  OAILOG_WARNING(
+      LOG_MME_APP, "No UE context for S-TMSI %02x|%08x\n",
+      s_tmsi_p->mme_code, s_tmsi_p->m_tmsi);
   return NULL;
 }
 
+//------------------------------------------------------------------------------
+void mme_app_s_tmsi_index_insert(
+    mme_ue_context_t* const mme_ue_context_p, const guti_t* const guti_p,
+    const mme_ue_s1ap_id_t mme_ue_s1ap_id) {
+  hashtable_rc_t h_rc = hashtable_uint64_ts_insert(
+      mme_ue_context_p->s_tmsi_ue_context_htbl,
+      MME_APP_S_TMSI_KEY(guti_p->gummei.mme_code, guti_p->m_tmsi),
+      (uint64_t) mme_ue_s1ap_id);
+
+  // Same S-TMSI allocated under another GUMMEI of this MME
+  if (HASH_TABLE_INSERT_OVERWRITTEN_DATA == h_rc) {
+    OAILOG_WARNING(
+        LOG_MME_APP,
+        "S-TMSI of GUTI " GUTI_FMT
+        " moved to mme_ue_s1ap_id " MME_UE_S1AP_ID_FMT "\n",
+        GUTI_ARG(guti_p), mme_ue_s1ap_id);
+  }
+}
+
+//------------------------------------------------------------------------------
+void mme_app_s_tmsi_index_remove(
+    mme_ue_context_t* const mme_ue_context_p, const guti_t* const guti_p,
+    const mme_ue_s1ap_id_t mme_ue_s1ap_id) {
+  hash_key_t key = MME_APP_S_TMSI_KEY(guti_p->gummei.mme_code, guti_p->m_tmsi);
+  uint64_t owner = 0;
+
+  // Only remove the entry if it was not taken over by another UE
+  if ((HASH_TABLE_OK == hashtable_uint64_ts_get(
+                            mme_ue_context_p->s_tmsi_ue_context_htbl, key,
+                            &owner)) &&
+      (owner == (uint64_t) mme_ue_s1ap_id)) {
+    hashtable_uint64_ts_remove(mme_ue_context_p->s_tmsi_ue_context_htbl, key);
+  }
+}
+
 //------------------------------------------------------------------------------
 void mme_app_move_context(ue_mm_context_t* dst, ue_mm_context_t* src) {
   OAILOG_FUNC_IN(LOG_MME_APP);
@@ -588,6 +734,9 @@ void mme_ue_context_update_coll_keys(
     h_rc = hashtable_uint64_ts_insert(
         mme_ue_context_p->imsi_mme_ue_id_htbl, (const hash_key_t) imsi,
         mme_ue_s1ap_id);
+    // S6A and SPGW trace the procedures of the UE by IMSI
+    procedure_trace_alias(
+        TRACE_KEY_MME_UE_S1AP_ID(mme_ue_s1ap_id), TRACE_KEY_IMSI(imsi));
   } else {
     h_rc = HASH_TABLE_KEY_NOT_EXISTS;
   }
@@ -642,10 +791,14 @@ void mme_ue_context_update_coll_keys(
       h_rc = obj_hashtable_uint64_ts_remove(
           mme_ue_context_p->guti_ue_context_htbl,
           &ue_context_p->emm_context._guti, sizeof(*guti_p));
+      mme_app_s_tmsi_index_remove(
+          mme_ue_context_p, &ue_context_p->emm_context._guti,
+          ue_context_p->mme_ue_s1ap_id);
       if (INVALID_MME_UE_S1AP_ID != mme_ue_s1ap_id) {
         h_rc = obj_hashtable_uint64_ts_insert(
             mme_ue_context_p->guti_ue_context_htbl, (const void* const) guti_p,
             sizeof(*guti_p), (uint64_t) mme_ue_s1ap_id);
+        mme_app_s_tmsi_index_insert(mme_ue_context_p, guti_p, mme_ue_s1ap_id);
       } else {
         h_rc = HASH_TABLE_KEY_NOT_EXISTS;
       }
@@ -694,6 +847,11 @@ void mme_ue_context_dump_coll_keys(const mme_ue_context_t* mme_ue_contexts_p) {
       mme_ue_contexts_p->guti_ue_context_htbl, tmp);
   OAILOG_DEBUG(LOG_MME_APP, "guti_ue_context_htbl %s", bdata(tmp));
 
+  btrunc(tmp, 0);
+  hashtable_uint64_ts_dump_content(
+      mme_ue_contexts_p->s_tmsi_ue_context_htbl, tmp);
+  OAILOG_DEBUG(LOG_MME_APP, "s_tmsi_ue_context_htbl %s", bdata(tmp));
+
   bdestroy(tmp);
 }
 
@@ -816,6 +974,9 @@ int mme_insert_ue_context(
           (const void* const) & ue_context_p->emm_context._guti,
           sizeof(ue_context_p->emm_context._guti),
           ue_context_p->mme_ue_s1ap_id);
+      mme_app_s_tmsi_index_insert(
+          mme_ue_context_p, &ue_context_p->emm_context._guti,
+          ue_context_p->mme_ue_s1ap_id);
 
       if (HASH_TABLE_OK != h_rc) {
         OAILOG_WARNING(
@@ -849,6 +1010,12 @@ void mme_remove_ue_context(
     OAILOG_FUNC_OUT(LOG_MME_APP);
   }
 
+  // A detach ends with the UE context, any other procedure is cut short
+  procedure_trace_end(
+      TRACE_KEY_MME_UE_S1AP_ID(ue_context_p->mme_ue_s1ap_id),
+      TRACE_PROCEDURE_DETACH);
+  procedure_trace_abort(TRACE_KEY_MME_UE_S1AP_ID(ue_context_p->mme_ue_s1ap_id));
+
   // First, notify directoryd of removal
   _directoryd_remove_location(
       ue_context_p->emm_context._imsi64,
@@ -883,6 +1050,9 @@ void mme_remove_ue_context(
         mme_ue_context_p->guti_ue_context_htbl,
         (const void* const) & ue_context_p->emm_context._guti,
         sizeof(ue_context_p->emm_context._guti));
+    mme_app_s_tmsi_index_remove(
+        mme_ue_context_p, &ue_context_p->emm_context._guti,
+        ue_context_p->mme_ue_s1ap_id);
     if (HASH_TABLE_OK != hash_rc)
       OAILOG_ERROR(
           LOG_MME_APP,
@@ -1435,6 +1605,8 @@ void mme_ue_context_update_ue_sig_connection_state(
           ue_context_p->enb_s1ap_id_key, ue_context_p->mme_ue_s1ap_id);
     }
     ue_context_p->enb_s1ap_id_key = INVALID_ENB_UE_S1AP_ID_KEY;
+    // Idle UEs keep no expanded keys, the next connection rebuilds them
+    emm_security_context_free_key_caches(&ue_context_p->emm_context._security);
 
     OAILOG_DEBUG_UE(
         LOG_MME_APP, ue_context_p->emm_context._imsi64,
@@ -1482,6 +1654,7 @@ void mme_ue_context_update_ue_sig_connection_state(
       }
     }
     ue_context_p->ecm_state = ECM_IDLE;
+    mme_app_ue_eviction_ue_idle(ue_context_p);
     // Update Stats
     update_mme_app_stats_connected_ue_sub();
     OAILOG_INFO_UE(
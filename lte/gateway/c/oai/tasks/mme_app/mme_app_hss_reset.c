@@ -32,6 +32,7 @@
 #include "log.h"
 #include "mme_app_ue_context.h"
 #include "mme_app_defs.h"
+#include "mme_app_ue_eviction.h"
 #include "hashtable.h"
 #include "mme_api.h"
 #include "mme_app_desc.h"
@@ -55,6 +56,9 @@ int mme_app_handle_s6a_reset_req(const s6a_reset_req_t* const rsr_pP) {
     OAILOG_FUNC_RETURN(LOG_MME_APP, RETURNerror);
   }
 
+  // Evicted UEs get the flag when they are read back
+  mme_app_ue_eviction_hss_reset();
+
   hashtblP = get_mme_ue_state();
   if (!hashtblP) {
     OAILOG_INFO(LOG_MME_APP, "There is no Ue Context in the MME context \n");
@@ -48,6 +48,7 @@
 #include "esm_data.h"
 #include "mme_app_desc.h"
 #include "s11_messages_types.h"
+#include "procedure_trace.h"
 
 #if EMBEDDED_SGW
 #define TASK_SPGW TASK_SPGW_APP
@@ -379,6 +380,9 @@ int mme_app_send_s11_create_session_req(
       "Sending S11 CREATE SESSION REQ message to SPGW for "
       "ue_id " MME_UE_S1AP_ID_FMT "\n",
       ue_mm_context->mme_ue_s1ap_id);
+  procedure_trace_span_start(
+      TRACE_KEY_MME_UE_S1AP_ID(ue_mm_context->mme_ue_s1ap_id),
+      TRACE_STAGE_SPGW);
   if ((send_msg_to_task(&mme_app_task_zmq_ctx, TASK_SPGW, message_p)) !=
       RETURNok) {
     OAILOG_ERROR_UE(
@@ -37,6 +37,7 @@
 #include "common_defs.h"
 #include "mme_config.h"
 #include "mme_app_ue_context.h"
+#include "mme_app_auth_vector_cache.h"
 #include "mme_app_defs.h"
 #include "timer.h"
 #include "3gpp_23.003.h"
@@ -54,6 +55,7 @@
 #include "emm_cnDef.h"
 #include "emm_proc.h"
 #include "dynamic_memory_check.h"
+#include "procedure_trace.h"
 
 //------------------------------------------------------------------------------
 int mme_app_send_s6a_update_location_req(
@@ -120,6 +122,9 @@ int mme_app_send_s6a_update_location_req(
       LOG_MME_APP,
       "0 S6A_UPDATE_LOCATION_REQ imsi %s with length %d for (ue_id = %u)\n",
       s6a_ulr_p->imsi, s6a_ulr_p->imsi_length, ue_context_p->mme_ue_s1ap_id);
+  procedure_trace_span_start(
+      TRACE_KEY_MME_UE_S1AP_ID(ue_context_p->mme_ue_s1ap_id),
+      TRACE_STAGE_S6A_ULR);
   rc = send_msg_to_task(&mme_app_task_zmq_ctx, TASK_S6A, message_p);
   /*
    * Do not start this timer in case we are sending ULR after receiving HSS
@@ -212,6 +217,9 @@ int mme_app_handle_s6a_update_location_ans(
         LOG_MME_APP, "That's embarrassing as we don't know this IMSI\n");
     OAILOG_FUNC_RETURN(LOG_MME_APP, RETURNerror);
   }
+  procedure_trace_span_end(
+      TRACE_KEY_MME_UE_S1AP_ID(ue_mm_context->mme_ue_s1ap_id),
+      TRACE_STAGE_S6A_ULR);
   if (ula_pP->result.present == S6A_RESULT_BASE) {
     if (ula_pP->result.choice.base != DIAMETER_SUCCESS) {
       /*
@@ -300,10 +308,8 @@ int mme_app_handle_s6a_update_location_ans(
   }
   ue_mm_context->rau_tau_timer       = ula_pP->subscription_data.rau_tau_timer;
   ue_mm_context->network_access_mode = ula_pP->subscription_data.access_mode;
-  memcpy(
-      &ue_mm_context->apn_config_profile,
-      &ula_pP->subscription_data.apn_config_profile,
-      sizeof(apn_config_profile_t));
+  mme_app_set_apn_config_profile(
+      ue_mm_context, &ula_pP->subscription_data.apn_config_profile);
   memcpy(
       &ue_mm_context->default_charging_characteristics,
       &ula_pP->subscription_data.default_charging_characteristics,
@@ -367,6 +373,8 @@ int mme_app_handle_s6a_cancel_location_req(
   OAILOG_DEBUG(
       LOG_MME_APP, "S6a Cancel Location Request for imsi " IMSI_64_FMT "\n",
       imsi);
+  // The UE moved to an MME that gets newer vectors from the HSS
+  mme_app_auth_vector_cache_invalidate(imsi, "cancel_location");
 
   if ((mme_app_send_s6a_cancel_location_ans(
           cla_result, clr_pP->imsi, clr_pP->imsi_length, clr_pP->msg_cla_p)) !=
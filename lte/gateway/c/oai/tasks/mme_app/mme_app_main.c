@@ -40,7 +40,11 @@
 #include "mme_app_ue_context.h"
 #include "mme_app_defs.h"
 #include "mme_app_ha.h"
+#include "mme_app_auth_vector_cache.h"
+#include "mme_app_overload.h"
 #include "mme_app_statistics.h"
+#include "mme_app_ue_eviction.h"
+#include "procedure_trace.h"
 #include "service303_message_utils.h"
 #include "service303.h"
 #include "common_defs.h"
@@ -75,6 +79,9 @@ static int handle_message(zloop_t* loop, zsock_t* reader, void* arg) {
   imsi64_t imsi64                = itti_get_associated_imsi(received_message_p);
   mme_app_desc_t* mme_app_desc_p = get_mme_nas_state(false);
 
+  itti_update_queue_latency(TASK_MME_APP, received_message_p);
+  procedure_trace_task_message(received_message_p->ittiMsgHeader.timestamp);
+
   switch (ITTI_MSG_ID(received_message_p)) {
     case MESSAGE_TEST: {
       OAI_FPRINTF_INFO("TASK_MME_APP received MESSAGE_TEST\n");
@@ -100,6 +107,10 @@ static int handle_message(zloop_t* loop, zsock_t* reader, void* arg) {
           MME_APP_UL_DATA_IND(received_message_p).tai,
           MME_APP_UL_DATA_IND(received_message_p).cgi,
           &MME_APP_UL_DATA_IND(received_message_p).nas_msg);
+      procedure_trace_task_span(
+          TRACE_KEY_MME_UE_S1AP_ID(
+              MME_APP_UL_DATA_IND(received_message_p).ue_id),
+          TRACE_STAGE_NAS);
     } break;
 
     case S11_CREATE_BEARER_REQUEST: {
@@ -459,8 +470,12 @@ static void* mme_app_thread(__attribute__((unused)) void* args) {
   init_task_context(
       TASK_MME_APP,
       (task_id_t[]){TASK_SPGW_APP, TASK_SGS, TASK_SMS_ORC8R, TASK_S11, TASK_S6A,
-                    TASK_S1AP, TASK_SERVICE303, TASK_HA},
-      8, handle_message, &mme_app_task_zmq_ctx);
+                    TASK_S1AP, TASK_SERVICE303, TASK_HA, TASK_MME_APP},
+      9, handle_message, &mme_app_task_zmq_ctx);
+
+  mme_app_overload_start(&mme_app_task_zmq_ctx);
+  mme_app_ue_eviction_start(&mme_app_task_zmq_ctx);
+  mme_app_auth_vector_cache_start();
 
   // Service started, but not healthy yet
   send_app_health_to_service303(&mme_app_task_zmq_ctx, TASK_MME_APP, false);
@@ -506,6 +521,9 @@ static bool _is_mme_app_healthy(void) {
 
 //------------------------------------------------------------------------------
 static void mme_app_exit(void) {
+  mme_app_overload_stop(&mme_app_task_zmq_ctx);
+  mme_app_ue_eviction_stop(&mme_app_task_zmq_ctx);
+  mme_app_auth_vector_cache_stop();
   destroy_task_context(&mme_app_task_zmq_ctx);
   put_mme_nas_state();
   mme_app_edns_exit();
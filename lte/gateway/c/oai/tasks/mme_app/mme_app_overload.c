@@ -0,0 +1,312 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file mme_app_overload.c
+  \brief MME overload control, 3GPP TS 23.401 section 4.3.7.4.1
+
+  Watches the queue latency of TASK_MME_APP and TASK_S6A and the number of
+  attach and TAU procedures running. When overloaded the eNBs are asked to
+  restrict the signalling they send (S1AP Overload Start), attaches that
+  still arrive are rejected before any HSS work with EMM cause #22 and a
+  T3346 back-off, and AIRs are paced by a token bucket at all times.
+*/
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/queue.h>
+
+#include "log.h"
+#include "intertask_interface.h"
+#include "mme_app_defs.h"
+#include "mme_app_overload.h"
+#include "mme_config.h"
+#include "service303.h"
+
+#define USEC_PER_MSEC 1000
+#define AIR_TOKEN 1000
+
+typedef struct deferred_air_s {
+  MessageDef* message;
+  int64_t deferred_usec;
+  STAILQ_ENTRY(deferred_air_s) entries;
+} deferred_air_t;
+
+static mme_app_overload_t _overload;
+static STAILQ_HEAD(deferred_airs_s, deferred_air_s)
+    _deferred_airs = STAILQ_HEAD_INITIALIZER(_deferred_airs);
+static uint32_t _nb_deferred_airs;
+static int _overload_timer_id;
+
+//------------------------------------------------------------------------------
+static uint64_t _air_bucket_size(const overload_config_t* config) {
+  return (config->air_burst ? config->air_burst : config->air_rate) *
+         (uint64_t) AIR_TOKEN;
+}
+
+//------------------------------------------------------------------------------
+// A watermark of 0 disables the signal
+static bool _above(int64_t value, uint32_t high) {
+  return high && value >= high;
+}
+
+static bool _below(int64_t value, uint32_t low, uint32_t high) {
+  return !high || value <= low;
+}
+
+//------------------------------------------------------------------------------
+void mme_app_overload_init(
+    mme_app_overload_t* overload, const overload_config_t* config,
+    int64_t now_usec) {
+  memset(overload, 0, sizeof(*overload));
+  overload->config          = config;
+  overload->air_tokens      = _air_bucket_size(config);
+  overload->air_refill_usec = now_usec;
+}
+
+//------------------------------------------------------------------------------
+bool mme_app_overload_update(
+    mme_app_overload_t* overload, int64_t mme_app_latency_usec,
+    int64_t s6a_latency_usec) {
+  const overload_config_t* config = overload->config;
+  int64_t mme_app_ms              = mme_app_latency_usec / USEC_PER_MSEC;
+  int64_t s6a_ms                  = s6a_latency_usec / USEC_PER_MSEC;
+  bool overloaded                 = false;
+
+  overload->mme_app_latency_usec = mme_app_latency_usec;
+  overload->s6a_latency_usec     = s6a_latency_usec;
+
+  if (!overload->overloaded) {
+    overloaded =
+        _above(mme_app_ms, config->mme_app_latency_high_ms) ||
+        _above(s6a_ms, config->s6a_latency_high_ms) ||
+        _above(overload->procedures, config->procedures_high);
+  } else {
+    overloaded = !(
+        _below(
+            mme_app_ms, config->mme_app_latency_low_ms,
+            config->mme_app_latency_high_ms) &&
+        _below(
+            s6a_ms, config->s6a_latency_low_ms, config->s6a_latency_high_ms) &&
+        _below(
+            overload->procedures, config->procedures_low,
+            config->procedures_high));
+  }
+  if (overloaded == overload->overloaded) {
+    return false;
+  }
+  overload->overloaded = overloaded;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+bool mme_app_overload_take_air_token(
+    mme_app_overload_t* overload, int64_t now_usec) {
+  const overload_config_t* config = overload->config;
+
+  if (!config || !config->air_rate) {
+    return true;
+  }
+  if (now_usec > overload->air_refill_usec) {
+    // air_rate tokens per second is air_rate thousandths of token per msec
+    uint64_t added = (uint64_t)(now_usec - overload->air_refill_usec) *
+                     config->air_rate / USEC_PER_MSEC;
+    // Keep the remainder for the next refill
+    if (added) {
+      overload->air_tokens += added;
+      overload->air_refill_usec = now_usec;
+      if (overload->air_tokens > _air_bucket_size(config)) {
+        overload->air_tokens = _air_bucket_size(config);
+      }
+    }
+  }
+  if (overload->air_tokens < AIR_TOKEN) {
+    return false;
+  }
+  overload->air_tokens -= AIR_TOKEN;
+  return true;
+}
+
+//------------------------------------------------------------------------------
+uint32_t mme_app_overload_spread_t3346(uint32_t t3346_sec, uint32_t random) {
+  return t3346_sec / 2 + random % (t3346_sec + 1);
+}
+
+//------------------------------------------------------------------------------
+static void _send_deferred_airs(int64_t now_usec) {
+  deferred_air_t* air = NULL;
+
+  while ((air = STAILQ_FIRST(&_deferred_airs)) &&
+         mme_app_overload_take_air_token(&_overload, now_usec)) {
+    STAILQ_REMOVE_HEAD(&_deferred_airs, entries);
+    _nb_deferred_airs--;
+    send_msg_to_task(&mme_app_task_zmq_ctx, TASK_S6A, air->message);
+    free(air);
+  }
+}
+
+//------------------------------------------------------------------------------
+static void _notify_enbs(bool overloaded) {
+  MessageDef* message_p = itti_alloc_new_message(
+      TASK_MME_APP, overloaded ? S1AP_OVERLOAD_START : S1AP_OVERLOAD_STOP);
+  itti_s1ap_overload_t* overload = overloaded ?
+                                       &S1AP_OVERLOAD_START(message_p) :
+                                       &S1AP_OVERLOAD_STOP(message_p);
+
+  overload->overload_action        = _overload.config->overload_action;
+  overload->traffic_load_reduction = _overload.config->traffic_load_reduction;
+  send_msg_to_task(&mme_app_task_zmq_ctx, TASK_S1AP, message_p);
+}
+
+//------------------------------------------------------------------------------
+static void _publish_thresholds(const overload_config_t* config) {
+  set_gauge(
+      "mme_overload_watermark", config->mme_app_latency_high_ms, 2, "signal",
+      "mme_app_queue_latency_ms", "level", "high");
+  set_gauge(
+      "mme_overload_watermark", config->mme_app_latency_low_ms, 2, "signal",
+      "mme_app_queue_latency_ms", "level", "low");
+  set_gauge(
+      "mme_overload_watermark", config->s6a_latency_high_ms, 2, "signal",
+      "s6a_queue_latency_ms", "level", "high");
+  set_gauge(
+      "mme_overload_watermark", config->s6a_latency_low_ms, 2, "signal",
+      "s6a_queue_latency_ms", "level", "low");
+  set_gauge(
+      "mme_overload_watermark", config->procedures_high, 2, "signal",
+      "procedures", "level", "high");
+  set_gauge(
+      "mme_overload_watermark", config->procedures_low, 2, "signal",
+      "procedures", "level", "low");
+  set_gauge("s6a_air_rate_limit", config->air_rate, NO_LABELS);
+}
+
+//------------------------------------------------------------------------------
+static void _publish_state(void) {
+  set_gauge("mme_overload", _overload.overloaded, NO_LABELS);
+  set_gauge(
+      "mme_app_queue_latency_ms",
+      (double) _overload.mme_app_latency_usec / USEC_PER_MSEC, NO_LABELS);
+  set_gauge(
+      "s6a_queue_latency_ms",
+      (double) _overload.s6a_latency_usec / USEC_PER_MSEC, NO_LABELS);
+  set_gauge("mme_outstanding_procedures", _overload.procedures, NO_LABELS);
+  set_gauge("s6a_air_deferred", _nb_deferred_airs, NO_LABELS);
+}
+
+//------------------------------------------------------------------------------
+static int _overload_timer_handler(zloop_t* loop, int id, void* arg) {
+  int64_t now_usec         = zclock_usecs();
+  int64_t s6a_latency_usec = itti_get_queue_latency(TASK_S6A);
+  deferred_air_t* oldest   = NULL;
+
+  _send_deferred_airs(now_usec);
+  // AIRs waiting for a token are queued for S6A as much as the ITTI ones
+  if ((oldest = STAILQ_FIRST(&_deferred_airs)) &&
+      now_usec - oldest->deferred_usec > s6a_latency_usec) {
+    s6a_latency_usec = now_usec - oldest->deferred_usec;
+  }
+
+  if (mme_app_overload_update(
+          &_overload, itti_get_queue_latency(TASK_MME_APP),
+          s6a_latency_usec)) {
+    OAILOG_WARNING(
+        LOG_MME_APP,
+        "MME overload %s (MME_APP queue %" PRId64 " us, S6A queue %" PRId64
+        " us, %u procedures)\n",
+        _overload.overloaded ? "start" : "stop",
+        _overload.mme_app_latency_usec, _overload.s6a_latency_usec,
+        _overload.procedures);
+    increment_counter(
+        "mme_overload", 1, 1, "action",
+        _overload.overloaded ? "overload_start" : "overload_stop");
+    _notify_enbs(_overload.overloaded);
+  }
+  _publish_state();
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+void mme_app_overload_start(task_zmq_ctx_t* task_zmq_ctx) {
+  mme_app_overload_init(
+      &_overload, &mme_config.overload_config, zclock_usecs());
+  _publish_thresholds(&mme_config.overload_config);
+  _overload_timer_id = start_timer(
+      task_zmq_ctx, MME_APP_OVERLOAD_TIMER_MS, TIMER_REPEAT_FOREVER,
+      _overload_timer_handler, NULL);
+}
+
+//------------------------------------------------------------------------------
+void mme_app_overload_stop(task_zmq_ctx_t* task_zmq_ctx) {
+  deferred_air_t* air = NULL;
+
+  stop_timer(task_zmq_ctx, _overload_timer_id);
+  while ((air = STAILQ_FIRST(&_deferred_airs))) {
+    STAILQ_REMOVE_HEAD(&_deferred_airs, entries);
+    free(air->message);
+    free(air);
+  }
+  _nb_deferred_airs = 0;
+}
+
+//------------------------------------------------------------------------------
+void mme_app_overload_procedure_started(void) {
+  _overload.procedures++;
+}
+
+//------------------------------------------------------------------------------
+void mme_app_overload_procedure_ended(void) {
+  if (_overload.procedures) {
+    _overload.procedures--;
+  }
+}
+
+//------------------------------------------------------------------------------
+bool mme_app_overload_reject_attach(void) {
+  if (!_overload.overloaded) {
+    return false;
+  }
+  increment_counter("mme_overload_reject", 1, 1, "message", "attach_request");
+  return true;
+}
+
+//------------------------------------------------------------------------------
+void mme_app_overload_send_air(MessageDef* message_p) {
+  int64_t now_usec    = zclock_usecs();
+  deferred_air_t* air = NULL;
+
+  // Keep AIRs in order: nothing overtakes the deferred ones
+  if (STAILQ_EMPTY(&_deferred_airs) &&
+      mme_app_overload_take_air_token(&_overload, now_usec)) {
+    send_msg_to_task(&mme_app_task_zmq_ctx, TASK_S6A, message_p);
+    return;
+  }
+  air = calloc(1, sizeof(*air));
+  if (!air) {
+    OAILOG_ERROR(
+        LOG_MME_APP, "Failed to allocate a deferred AIR, dropping it\n");
+    free(message_p);
+    return;
+  }
+  air->message       = message_p;
+  air->deferred_usec = now_usec;
+  STAILQ_INSERT_TAIL(&_deferred_airs, air, entries);
+  _nb_deferred_airs++;
+  increment_counter("s6a_air_deferred", 1, NO_LABELS);
+}
@@ -18,6 +18,10 @@
 #include "mme_app_state.h"
 #include "mme_app_state_manager.h"
 
+extern "C" {
+#include "procedure_trace.h"
+}
+
 using magma::lte::MmeNasStateManager;
 
 /**
@@ -67,8 +71,12 @@ void put_mme_ue_state(mme_app_desc_t* mme_app_desc_p, imsi64_t imsi64) {
           mme_ue_context_exists_imsi(&mme_app_desc_p->mme_ue_contexts, imsi64);
       if (ue_context) {
         auto imsi_str = MmeNasStateManager::getInstance().get_imsi_str(imsi64);
+        procedure_trace_span_start(
+            TRACE_KEY_IMSI(imsi64), TRACE_STAGE_STATE_WRITE);
         MmeNasStateManager::getInstance().write_ue_state_to_db(
             ue_context, imsi_str);
+        procedure_trace_span_end(
+            TRACE_KEY_IMSI(imsi64), TRACE_STAGE_STATE_WRITE);
       }
     }
   }
@@ -78,3 +86,20 @@ void delete_mme_ue_state(imsi64_t imsi64) {
   auto imsi_str = MmeNasStateManager::getInstance().get_imsi_str(imsi64);
   MmeNasStateManager::getInstance().clear_ue_state_db(imsi_str);
 }
+
+int put_evicted_mme_ue_states(
+    const ue_mm_context_t* const* ue_contexts, int nb_ue_contexts) {
+  return MmeNasStateManager::getInstance().write_evicted_ue_states_to_db(
+      ue_contexts, nb_ue_contexts);
+}
+
+int get_evicted_mme_ue_state(imsi64_t imsi64, ue_mm_context_t* ue_context) {
+  auto imsi_str = MmeNasStateManager::getInstance().get_imsi_str(imsi64);
+  return MmeNasStateManager::getInstance().read_evicted_ue_state_from_db(
+      imsi_str, ue_context);
+}
+
+void delete_evicted_mme_ue_state(imsi64_t imsi64) {
+  auto imsi_str = MmeNasStateManager::getInstance().get_imsi_str(imsi64);
+  MmeNasStateManager::getInstance().clear_evicted_ue_state_db(imsi_str);
+}
@@ -175,7 +175,7 @@ void MmeNasStateConverter::mme_app_convert_string_to_guti(
 
 void MmeNasStateConverter::proto_to_guti_table(
     const google::protobuf::Map<std::string, unsigned long>& proto_map,
-    obj_hash_table_uint64_t* guti_htbl) {
+    obj_hash_table_uint64_t* guti_htbl, hash_table_uint64_ts_t* s_tmsi_htbl) {
   for (auto const& kv : proto_map) {
     mme_ue_s1ap_id_t mme_ue_id = kv.second;
     guti_t* guti_p             = (guti_t*) calloc(1, sizeof(guti_t));
@@ -189,6 +189,10 @@ void MmeNasStateConverter::proto_to_guti_table(
           "Failed to insert mme_ue_s1ap_id %u in GUTI table, error: %s\n",
           mme_ue_id, hashtable_rc_code2string(ht_rc));
     }
+    hashtable_uint64_ts_insert(
+        s_tmsi_htbl,
+        MME_APP_S_TMSI_KEY(guti_p->gummei.mme_code, guti_p->m_tmsi),
+        mme_ue_id);
     free_wrapper((void**) &guti_p);
   }
 }
@@ -508,6 +512,42 @@ void MmeNasStateConverter::proto_to_pdn_context_list(
   }
 }
 
+void MmeNasStateConverter::ue_apn_config_profile_to_proto(
+    const ue_apn_config_profile_t& state_apn_config_profile,
+    oai::ApnConfigProfile* apn_config_profile_proto) {
+  apn_config_profile_proto->set_context_identifier(
+      state_apn_config_profile.context_identifier);
+  apn_config_profile_proto->set_all_apn_conf_ind(
+      state_apn_config_profile.all_apn_conf_ind);
+  for (int i = 0; i < state_apn_config_profile.nb_apns; i++) {
+    apn_configuration_to_proto(
+        state_apn_config_profile.apn_configuration[i],
+        apn_config_profile_proto->add_apn_configs());
+  }
+}
+
+void MmeNasStateConverter::proto_to_ue_apn_config_profile(
+    const oai::ApnConfigProfile& apn_config_profile_proto,
+    ue_apn_config_profile_t* state_apn_config_profile) {
+  state_apn_config_profile->context_identifier =
+      apn_config_profile_proto.context_identifier();
+  state_apn_config_profile->all_apn_conf_ind =
+      (all_apn_conf_ind_t) apn_config_profile_proto.all_apn_conf_ind();
+  state_apn_config_profile->nb_apns =
+      apn_config_profile_proto.apn_configs_size();
+  free(state_apn_config_profile->apn_configuration);
+  state_apn_config_profile->apn_configuration = nullptr;
+  if (state_apn_config_profile->nb_apns) {
+    state_apn_config_profile->apn_configuration = (apn_configuration_t*) calloc(
+        state_apn_config_profile->nb_apns, sizeof(apn_configuration_t));
+  }
+  for (int i = 0; i < state_apn_config_profile->nb_apns; i++) {
+    proto_to_apn_configuration(
+        apn_config_profile_proto.apn_configs(i),
+        &state_apn_config_profile->apn_configuration[i]);
+  }
+}
+
 void MmeNasStateConverter::ue_context_to_proto(
     const ue_mm_context_t* state_ue_context, oai::UeContext* ue_context_proto) {
   OAILOG_FUNC_IN(LOG_MME_APP);
@@ -543,7 +583,7 @@ void MmeNasStateConverter::ue_context_to_proto(
   char lai_bytes[IE_LENGTH_LAI];
   lai_to_bytes(&state_ue_context->lai, lai_bytes);
   ue_context_proto->set_lai(lai_bytes, IE_LENGTH_LAI);
-  StateConverter::apn_config_profile_to_proto(
+  ue_apn_config_profile_to_proto(
       state_ue_context->apn_config_profile,
       ue_context_proto->mutable_apn_config());
   ue_context_proto->set_subscriber_status(state_ue_context->subscriber_status);
@@ -643,7 +683,7 @@ void MmeNasStateConverter::proto_to_ue_mm_context(
   state_ue_mm_context->cell_age = ue_context_proto.cell_age();
   bytes_to_lai(ue_context_proto.lai().c_str(), &state_ue_mm_context->lai);
 
-  StateConverter::proto_to_apn_config_profile(
+  proto_to_ue_apn_config_profile(
       ue_context_proto.apn_config(), &state_ue_mm_context->apn_config_profile);
 
   state_ue_mm_context->subscriber_status =
@@ -806,7 +846,8 @@ void MmeNasStateConverter::proto_to_state(
       mme_ue_ctxt_state->enb_ue_s1ap_id_ue_context_htbl);
   proto_to_guti_table(
       mme_ue_ctxts_proto.guti_ue_id_htbl(),
-      mme_ue_ctxt_state->guti_ue_context_htbl);
+      mme_ue_ctxt_state->guti_ue_context_htbl,
+      mme_ue_ctxt_state->s_tmsi_ue_context_htbl);
   OAILOG_FUNC_OUT(LOG_MME_APP);
 }
 
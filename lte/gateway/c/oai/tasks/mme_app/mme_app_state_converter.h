@@ -86,9 +86,10 @@ class MmeNasStateConverter : public StateConverter {
       const obj_hash_table_uint64_t* guti_htbl,
       google::protobuf::Map<std::string, unsigned long>* proto_map);
 
+  // Also rebuilds the S-TMSI index of the GUTIs, which is not persisted
   static void proto_to_guti_table(
       const google::protobuf::Map<std::string, unsigned long>& proto_map,
-      obj_hash_table_uint64_t* guti_htbl);
+      obj_hash_table_uint64_t* guti_htbl, hash_table_uint64_ts_t* s_tmsi_htbl);
 
   /**********************************************************
    *                 UE Context <-> Proto                    *
@@ -153,6 +154,14 @@ class MmeNasStateConverter : public StateConverter {
       const oai::UeContext& ue_context_proto,
       ue_mm_context_t* state_ue_context);
 
+  static void ue_apn_config_profile_to_proto(
+      const ue_apn_config_profile_t& state_apn_config_profile,
+      oai::ApnConfigProfile* apn_config_profile_proto);
+
+  static void proto_to_ue_apn_config_profile(
+      const oai::ApnConfigProfile& apn_config_profile_proto,
+      ue_apn_config_profile_t* state_apn_config_profile);
+
   static void ue_context_to_proto(
       const ue_mm_context_t* ue_ctxt, oai::UeContext* ue_ctxt_proto);
 
@@ -30,12 +30,15 @@ constexpr char MME_NAS_STATE_KEY[] = "mme_nas_state";
 const int NUM_MAX_UE_HTBL_LISTS    = 6;
 constexpr char UE_ID_UE_CTXT_TABLE_NAME[] =
     "mme_app_mme_ue_s1ap_id_ue_context_htbl";
-constexpr char IMSI_UE_ID_TABLE_NAME[] = "mme_app_imsi_ue_context_htbl";
-constexpr char TUN_UE_ID_TABLE_NAME[]  = "mme_app_tun11_ue_context_htbl";
-constexpr char GUTI_UE_ID_TABLE_NAME[] = "mme_app_tun11_ue_context_htbl";
+constexpr char IMSI_UE_ID_TABLE_NAME[]   = "mme_app_imsi_ue_context_htbl";
+constexpr char TUN_UE_ID_TABLE_NAME[]    = "mme_app_tun11_ue_context_htbl";
+constexpr char GUTI_UE_ID_TABLE_NAME[]   = "mme_app_tun11_ue_context_htbl";
+constexpr char S_TMSI_UE_ID_TABLE_NAME[] = "mme_app_s_tmsi_ue_context_htbl";
 constexpr char ENB_UE_ID_MME_UE_ID_TABLE_NAME[] =
     "mme_app_enb_ue_s1ap_id_ue_context_htbl";
 constexpr char MME_TASK_NAME[] = "MME";
+// Does not match the IMSI*MME* keys read at startup
+constexpr char EVICTED_UE_KEY_PREFIX[] = "EVICTED_";
 }  // namespace
 
 namespace magma {
@@ -72,6 +75,9 @@ int MmeNasStateManager::initialize_state(const mme_config_t* mme_config_p) {
 
   int rc = read_state_from_db();
   read_ue_state_from_db();
+  if (mme_config_p->ue_eviction_config.idle_time_sec) {
+    clear_evicted_ue_states_db();
+  }
   is_initialized = true;
   return rc;
 }
@@ -179,6 +185,11 @@ void MmeNasStateManager::create_hashtables() {
   bassigncstr(b, GUTI_UE_ID_TABLE_NAME);
   state_cache_p->mme_ue_contexts.guti_ue_context_htbl =
       obj_hashtable_uint64_ts_create(max_ue_htbl_lists_, nullptr, nullptr, b);
+  btrunc(b, 0);
+  bassigncstr(b, S_TMSI_UE_ID_TABLE_NAME);
+  state_cache_p->mme_ue_contexts.s_tmsi_ue_context_htbl =
+      hashtable_uint64_ts_create(
+          max_ue_htbl_lists_, hashtable_uint64_mix_hashfunc, b);
   bdestroy_wrapper(&b);
 }
 
@@ -210,6 +221,8 @@ void MmeNasStateManager::clear_mme_nas_hashtables() {
       state_cache_p->mme_ue_contexts.enb_ue_s1ap_id_ue_context_htbl);
   obj_hashtable_uint64_ts_destroy(
       state_cache_p->mme_ue_contexts.guti_ue_context_htbl);
+  hashtable_uint64_ts_destroy(
+      state_cache_p->mme_ue_contexts.s_tmsi_ue_context_htbl);
 }
 
 // Free the memory allocated to state pointer
@@ -255,5 +268,70 @@ int MmeNasStateManager::read_ue_state_from_db() {
   return RETURNok;
 }
 
+std::string MmeNasStateManager::get_evicted_ue_key(
+    const std::string& imsi_str) const {
+  return std::string(EVICTED_UE_KEY_PREFIX) + IMSI_PREFIX + imsi_str + ":" +
+         task_name;
+}
+
+int MmeNasStateManager::write_evicted_ue_states_to_db(
+    const ue_mm_context_t* const* ue_contexts, int nb_ue_contexts) {
+  std::vector<oai::UeContext> ue_protos(nb_ue_contexts);
+  std::vector<std::pair<std::string, const google::protobuf::Message*>>
+      key_protos;
+  for (int i = 0; i < nb_ue_contexts; i++) {
+    MmeNasStateConverter::ue_to_proto(ue_contexts[i], &ue_protos[i]);
+    key_protos.emplace_back(
+        get_evicted_ue_key(
+            get_imsi_str(ue_contexts[i]->emm_context._imsi64)),
+        &ue_protos[i]);
+  }
+  if (redis_client->write_new_protos(key_protos) != RETURNok) {
+    OAILOG_ERROR(
+        log_task, "Failed to write the evicted UE states of %d UEs",
+        nb_ue_contexts);
+    return RETURNerror;
+  }
+  return RETURNok;
+}
+
+int MmeNasStateManager::read_evicted_ue_state_from_db(
+    const std::string& imsi_str, ue_mm_context_t* ue_context) {
+  oai::UeContext ue_proto = oai::UeContext();
+  if (redis_client->read_proto(get_evicted_ue_key(imsi_str), ue_proto) !=
+      RETURNok) {
+    OAILOG_ERROR(
+        log_task, "Failed to read evicted UE state for IMSI %s",
+        imsi_str.c_str());
+    return RETURNerror;
+  }
+  MmeNasStateConverter::proto_to_ue(ue_proto, ue_context);
+  return RETURNok;
+}
+
+void MmeNasStateManager::clear_evicted_ue_state_db(
+    const std::string& imsi_str) {
+  std::vector<std::string> keys = {get_evicted_ue_key(imsi_str)};
+  if (redis_client->clear_keys(keys) != RETURNok) {
+    OAILOG_ERROR(
+        log_task, "Failed to remove evicted UE state for IMSI %s",
+        imsi_str.c_str());
+  }
+}
+
+void MmeNasStateManager::clear_evicted_ue_states_db() {
+  try {
+    auto keys = redis_client->get_keys(
+        std::string(EVICTED_UE_KEY_PREFIX) + IMSI_PREFIX + "*" + task_name);
+    if (!keys.empty() && redis_client->clear_keys(keys) != RETURNok) {
+      OAILOG_ERROR(log_task, "Failed to remove evicted UE states");
+      return;
+    }
+    OAILOG_INFO(log_task, "Removed %zu evicted UE states", keys.size());
+  } catch (const std::runtime_error& e) {
+    OAILOG_ERROR(log_task, "Failed to list evicted UE states: %s", e.what());
+  }
+}
+
 }  // namespace lte
 }  // namespace magma
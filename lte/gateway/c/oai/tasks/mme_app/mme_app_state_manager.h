@@ -63,6 +63,18 @@ class MmeNasStateManager
 
   int read_ue_state_from_db() override;
 
+  /**
+   * Evicted UE contexts are kept under their own keys, the contexts read at
+   * startup are only the ones of the persisted state
+   */
+  int write_evicted_ue_states_to_db(
+      const ue_mm_context_t* const* ue_contexts, int nb_ue_contexts);
+
+  int read_evicted_ue_state_from_db(
+      const std::string& imsi_str, ue_mm_context_t* ue_context);
+
+  void clear_evicted_ue_state_db(const std::string& imsi_str);
+
   /**
    * Copy constructor and assignment operator are marked as deleted functions.
    * Making them public for better debugging/logging.
@@ -89,6 +101,11 @@ class MmeNasStateManager
   // Write an empty value to data store, if needed for debugging
   void clear_db_state();
 
+  // Delete the UE contexts evicted by a previous run
+  void clear_evicted_ue_states_db();
+
+  std::string get_evicted_ue_key(const std::string& imsi_str) const;
+
   /**
    * Initialize memory for MME state before reading from data-store, the state
    * manager owns the memory allocated for MME state and frees it when the
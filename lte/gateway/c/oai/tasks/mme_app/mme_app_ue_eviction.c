@@ -0,0 +1,489 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file mme_app_ue_eviction.c
+  \brief Eviction of the contexts of idle UEs to the data store
+
+  UEs moving to ECM-IDLE are queued in the order they went idle. A periodic
+  timer on the MME_APP loop takes the ones idle for longer than the
+  configured time, writes their context to the data store through the MME
+  state converter, a batch per data store round trip, and frees it, keeping a
+  mme_app_evicted_ue_t stub. The UE is read back when it is looked up by
+  IMSI, S11 TEID, S-TMSI or GUTI: when it leaves ECM-IDLE, is paged, or the
+  HSS or SGW addresses it.
+  The sweep also reads back UEs whose idle mode timers expire, so that their
+  expiry runs as for any other UE.
+*/
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/queue.h>
+#include <time.h>
+
+#include "log.h"
+#include "common_defs.h"
+#include "dynamic_memory_check.h"
+#include "hashtable.h"
+#include "intertask_interface.h"
+#include "mme_app_defs.h"
+#include "mme_app_state.h"
+#include "mme_app_ue_eviction.h"
+#include "mme_config.h"
+#include "nas_timer.h"
+#include "obj_hashtable.h"
+#include "service303.h"
+#include "timer.h"
+
+#define USEC_PER_MSEC 1000
+#define EVICTED_UE_HTBL_SIZE 4096
+
+/* A UE that went idle at idle_since, stale once the UE connected again */
+typedef struct idle_ue_s {
+  mme_ue_s1ap_id_t mme_ue_s1ap_id;
+  time_t idle_since;
+  time_t evict_at;
+  STAILQ_ENTRY(idle_ue_s) entries;
+} idle_ue_t;
+
+static bool _enabled;
+static uint32_t _idle_time_sec;
+static uint32_t _max_per_sweep;
+static int _eviction_timer_id;
+static hash_table_t* _evicted_ues;
+static STAILQ_HEAD(idle_ues_s, idle_ue_s)
+    _idle_ues = STAILQ_HEAD_INITIALIZER(_idle_ues);
+/* Evicted UEs with a timer to run, by wake_at */
+static TAILQ_HEAD(waking_ues_s, mme_app_evicted_ue_s)
+    _waking_ues = TAILQ_HEAD_INITIALIZER(_waking_ues);
+
+//------------------------------------------------------------------------------
+bool mme_app_ue_is_evictable(const ue_mm_context_t* ue_context_p) {
+  const emm_context_t* emm_context = &ue_context_p->emm_context;
+
+  if (ue_context_p->mm_state != UE_REGISTERED ||
+      ue_context_p->ecm_state != ECM_IDLE) {
+    return false;
+  }
+  if (emm_context->emm_procedures || ue_context_p->sgs_context ||
+      emm_context->t3422_arg) {
+    return false;
+  }
+  if (ue_context_p->s11_procedures &&
+      !LIST_EMPTY(ue_context_p->s11_procedures)) {
+    return false;
+  }
+  if (ue_context_p->initial_context_setup_rsp_timer.id !=
+          MME_APP_TIMER_INACTIVE_ID ||
+      ue_context_p->ue_context_modification_timer.id !=
+          MME_APP_TIMER_INACTIVE_ID ||
+      ue_context_p->paging_response_timer.id != MME_APP_TIMER_INACTIVE_ID ||
+      ue_context_p->ulr_response_timer.id != MME_APP_TIMER_INACTIVE_ID) {
+    return false;
+  }
+  if (emm_context->T3422.id != NAS_TIMER_INACTIVE_ID ||
+      emm_context->esm_ctx.T3489.id != NAS_TIMER_INACTIVE_ID) {
+    return false;
+  }
+  for (int i = 0; i < BEARERS_PER_UE; i++) {
+    if (ue_context_p->pending_ded_ber_req[i]) {
+      return false;
+    }
+    if (ue_context_p->bearer_contexts[i] &&
+        ue_context_p->bearer_contexts[i]->esm_ebr_context.timer.id !=
+            NAS_TIMER_INACTIVE_ID) {
+      return false;
+    }
+  }
+  return true;
+}
+
+//------------------------------------------------------------------------------
+static time_t _expiry(time_t started, uint32_t sec) {
+  return started ? started + sec : 0;
+}
+
+time_t mme_app_ue_eviction_wake_time(const ue_mm_context_t* ue_context_p) {
+  time_t mobile_reachability = _expiry(
+      ue_context_p->time_mobile_reachability_timer_started,
+      ue_context_p->mobile_reachability_timer.sec);
+  time_t implicit_detach = _expiry(
+      ue_context_p->time_implicit_detach_timer_started,
+      ue_context_p->implicit_detach_timer.sec);
+
+  if (!mobile_reachability ||
+      (implicit_detach && implicit_detach < mobile_reachability)) {
+    return implicit_detach;
+  }
+  return mobile_reachability;
+}
+
+//------------------------------------------------------------------------------
+static void _publish_state(void) {
+  set_gauge(
+      "mme_evicted_ues", _evicted_ues ? _evicted_ues->num_elements : 0,
+      NO_LABELS);
+}
+
+//------------------------------------------------------------------------------
+static void _queue_idle_ue(
+    mme_ue_s1ap_id_t mme_ue_s1ap_id, time_t idle_since, time_t evict_at) {
+  idle_ue_t* idle_ue = calloc(1, sizeof(*idle_ue));
+
+  idle_ue->mme_ue_s1ap_id = mme_ue_s1ap_id;
+  idle_ue->idle_since     = idle_since;
+  idle_ue->evict_at       = evict_at;
+  STAILQ_INSERT_TAIL(&_idle_ues, idle_ue, entries);
+}
+
+//------------------------------------------------------------------------------
+void mme_app_ue_eviction_ue_idle(ue_mm_context_t* ue_context_p) {
+  time_t now = time(NULL);
+
+  ue_context_p->time_ecm_idle_started = now;
+  if (_enabled) {
+    _queue_idle_ue(ue_context_p->mme_ue_s1ap_id, now, now + _idle_time_sec);
+  }
+}
+
+//------------------------------------------------------------------------------
+// Kept sorted by wake_at, UEs evicted later mostly wake later
+static void _insert_waking_ue(mme_app_evicted_ue_t* evicted_ue) {
+  mme_app_evicted_ue_t* before = NULL;
+
+  TAILQ_FOREACH_REVERSE(before, &_waking_ues, waking_ues_s, wake_entries) {
+    if (before->wake_at <= evicted_ue->wake_at) {
+      TAILQ_INSERT_AFTER(&_waking_ues, before, evicted_ue, wake_entries);
+      return;
+    }
+  }
+  TAILQ_INSERT_HEAD(&_waking_ues, evicted_ue, wake_entries);
+}
+
+//------------------------------------------------------------------------------
+// Once its context is written to the data store
+static void _evict_ue(ue_mm_context_t* ue_context_p, time_t now) {
+  mme_ue_s1ap_id_t mme_ue_s1ap_id  = ue_context_p->mme_ue_s1ap_id;
+  imsi64_t imsi64                  = ue_context_p->emm_context._imsi64;
+  mme_app_evicted_ue_t* evicted_ue = NULL;
+
+  evicted_ue                 = calloc(1, sizeof(*evicted_ue));
+  evicted_ue->mme_ue_s1ap_id = mme_ue_s1ap_id;
+  evicted_ue->mme_teid_s11   = ue_context_p->mme_teid_s11;
+  evicted_ue->imsi64         = imsi64;
+  evicted_ue->guti           = ue_context_p->emm_context._guti;
+  evicted_ue->evicted_at     = now;
+  evicted_ue->wake_at        = mme_app_ue_eviction_wake_time(ue_context_p);
+  hashtable_insert(
+      _evicted_ues, (const hash_key_t) mme_ue_s1ap_id, (void*) evicted_ue);
+  if (evicted_ue->wake_at) {
+    _insert_waking_ue(evicted_ue);
+  }
+
+  // Stops the timers of the UE and frees its context
+  hashtable_ts_free(get_mme_ue_state(), (const hash_key_t) mme_ue_s1ap_id);
+  OAILOG_DEBUG_UE(
+      LOG_MME_APP, imsi64,
+      "Evicted UE context of idle UE id " MME_UE_S1AP_ID_FMT "\n",
+      mme_ue_s1ap_id);
+  increment_counter("mme_ue_eviction", 1, 1, "action", "evict");
+}
+
+//------------------------------------------------------------------------------
+// Takes the next batch of UEs to evict off the idle queue, up to max
+static int _take_evictable_ues(
+    time_t now, int max, idle_ue_t** idle_ues, ue_mm_context_t** contexts) {
+  idle_ue_t* idle_ue          = NULL;
+  ue_mm_context_t* ue_context = NULL;
+  int nb_ues                  = 0;
+
+  while (nb_ues < max && (idle_ue = STAILQ_FIRST(&_idle_ues)) &&
+         idle_ue->evict_at <= now) {
+    STAILQ_REMOVE_HEAD(&_idle_ues, entries);
+    ue_context =
+        mme_ue_context_exists_mme_ue_s1ap_id(idle_ue->mme_ue_s1ap_id);
+    // A UE that went idle twice within a second is queued twice
+    for (int i = 0; ue_context && i < nb_ues; i++) {
+      if (contexts[i] == ue_context) {
+        ue_context = NULL;
+      }
+    }
+    if (!ue_context || ue_context->ecm_state != ECM_IDLE ||
+        ue_context->time_ecm_idle_started != idle_ue->idle_since) {
+      free(idle_ue);
+      continue;
+    }
+    if (!mme_app_ue_is_evictable(ue_context)) {
+      // Still idle, retry once the procedure is over
+      idle_ue->evict_at = now + _idle_time_sec;
+      STAILQ_INSERT_TAIL(&_idle_ues, idle_ue, entries);
+      continue;
+    }
+    idle_ues[nb_ues] = idle_ue;
+    contexts[nb_ues] = ue_context;
+    nb_ues++;
+  }
+  return nb_ues;
+}
+
+//------------------------------------------------------------------------------
+static void _evict_idle_ues(time_t now) {
+  idle_ue_t* idle_ues[MME_APP_UE_EVICTION_BATCH_SIZE];
+  ue_mm_context_t* contexts[MME_APP_UE_EVICTION_BATCH_SIZE];
+  uint32_t evicted = 0;
+  int batch_size   = 0;
+  int nb_ues       = 0;
+
+  do {
+    batch_size = MME_APP_UE_EVICTION_BATCH_SIZE;
+    if (_max_per_sweep &&
+        _max_per_sweep - evicted < MME_APP_UE_EVICTION_BATCH_SIZE) {
+      batch_size = (int) (_max_per_sweep - evicted);
+    }
+    nb_ues = _take_evictable_ues(now, batch_size, idle_ues, contexts);
+    if (!nb_ues) {
+      return;
+    }
+    // One data store round trip per batch, a failed write keeps them all
+    if (put_evicted_mme_ue_states(
+            (const ue_mm_context_t* const*) contexts, nb_ues) != RETURNok) {
+      increment_counter(
+          "mme_ue_eviction_failure", nb_ues, 1, "action", "evict");
+      // Data store unavailable, try again next sweep in the same order
+      for (int i = nb_ues - 1; i >= 0; i--) {
+        STAILQ_INSERT_HEAD(&_idle_ues, idle_ues[i], entries);
+      }
+      return;
+    }
+    for (int i = 0; i < nb_ues; i++) {
+      _evict_ue(contexts[i], now);
+      free(idle_ues[i]);
+    }
+    evicted += nb_ues;
+  } while (nb_ues == batch_size);
+}
+
+//------------------------------------------------------------------------------
+// The context is lost, remove what still points at it
+static void _forget_evicted_ue(const mme_app_evicted_ue_t* evicted_ue) {
+  mme_app_desc_t* mme_app_desc_p = get_mme_nas_state(false);
+  mme_ue_context_t* contexts     = &mme_app_desc_p->mme_ue_contexts;
+
+  hashtable_uint64_ts_remove(
+      contexts->imsi_mme_ue_id_htbl, (const hash_key_t) evicted_ue->imsi64);
+  if (evicted_ue->mme_teid_s11) {
+    hashtable_uint64_ts_remove(
+        contexts->tun11_ue_context_htbl,
+        (const hash_key_t) evicted_ue->mme_teid_s11);
+  }
+  obj_hashtable_uint64_ts_remove(
+      contexts->guti_ue_context_htbl, (const void* const) & evicted_ue->guti,
+      sizeof(evicted_ue->guti));
+  mme_app_s_tmsi_index_remove(
+      contexts, &evicted_ue->guti, evicted_ue->mme_ue_s1ap_id);
+}
+
+//------------------------------------------------------------------------------
+static void _rearm_timer(
+    ue_mm_context_t* ue_context_p, struct mme_app_timer_t* timer,
+    time_t started, time_t now, const char* timer_name,
+    void (*timer_expiry_handler)(void*, imsi64_t*)) {
+  nas_itti_timer_arg_t timer_callback_arg = {0};
+  time_t remaining_sec                    = started + timer->sec - now;
+
+  timer->id = MME_APP_TIMER_INACTIVE_ID;
+  if (!started) {
+    return;
+  }
+  // Expired while evicted, the expiry runs from the loop
+  if (remaining_sec < 1) {
+    remaining_sec = 1;
+  }
+  timer_callback_arg.nas_timer_callback = timer_expiry_handler;
+  timer_callback_arg.nas_timer_callback_arg =
+      (void*) &(ue_context_p->mme_ue_s1ap_id);
+  if (timer_setup(
+          (uint32_t) remaining_sec, 0, TASK_MME_APP, INSTANCE_DEFAULT,
+          TIMER_ONE_SHOT, &timer_callback_arg, sizeof(timer_callback_arg),
+          &(timer->id)) < 0) {
+    OAILOG_ERROR_UE(
+        LOG_MME_APP, ue_context_p->emm_context._imsi64,
+        "Failed to restart %s timer for UE id " MME_UE_S1AP_ID_FMT "\n",
+        timer_name, ue_context_p->mme_ue_s1ap_id);
+    timer->id = MME_APP_TIMER_INACTIVE_ID;
+  }
+}
+
+//------------------------------------------------------------------------------
+ue_mm_context_t* mme_app_ue_rehydrate(mme_ue_s1ap_id_t mme_ue_s1ap_id) {
+  mme_app_evicted_ue_t* evicted_ue = NULL;
+  ue_mm_context_t* ue_context_p    = NULL;
+  int64_t start_usec               = 0;
+  time_t now                       = 0;
+
+  if (!_evicted_ues || !_evicted_ues->num_elements ||
+      hashtable_remove(
+          _evicted_ues, (const hash_key_t) mme_ue_s1ap_id,
+          (void**) &evicted_ue) != HASH_TABLE_OK) {
+    return NULL;
+  }
+  start_usec = zclock_usecs();
+  now        = time(NULL);
+  if (evicted_ue->wake_at) {
+    TAILQ_REMOVE(&_waking_ues, evicted_ue, wake_entries);
+  }
+
+  ue_context_p = calloc(1, sizeof(*ue_context_p));
+  if (get_evicted_mme_ue_state(evicted_ue->imsi64, ue_context_p) !=
+      RETURNok) {
+    OAILOG_ERROR_UE(
+        LOG_MME_APP, evicted_ue->imsi64,
+        "Lost evicted UE context of UE id " MME_UE_S1AP_ID_FMT "\n",
+        mme_ue_s1ap_id);
+    increment_counter("mme_ue_eviction_failure", 1, 1, "action", "rehydrate");
+    _forget_evicted_ue(evicted_ue);
+    free_wrapper((void**) &ue_context_p);
+    free_wrapper((void**) &evicted_ue);
+    _publish_state();
+    return NULL;
+  }
+  delete_evicted_mme_ue_state(evicted_ue->imsi64);
+
+  // Timer ids of the data store are the ones of the evicted context
+  ue_context_p->initial_context_setup_rsp_timer.id = MME_APP_TIMER_INACTIVE_ID;
+  ue_context_p->ue_context_modification_timer.id   = MME_APP_TIMER_INACTIVE_ID;
+  ue_context_p->paging_response_timer.id           = MME_APP_TIMER_INACTIVE_ID;
+  ue_context_p->ulr_response_timer                 = (struct mme_app_timer_t){
+      MME_APP_TIMER_INACTIVE_ID, MME_APP_ULR_RESPONSE_TIMER_VALUE};
+  if (evicted_ue->hss_reset) {
+    ue_context_p->location_info_confirmed_in_hss = true;
+  }
+  hashtable_ts_insert(
+      get_mme_ue_state(), (const hash_key_t) mme_ue_s1ap_id,
+      (void*) ue_context_p);
+  _rearm_timer(
+      ue_context_p, &ue_context_p->mobile_reachability_timer,
+      ue_context_p->time_mobile_reachability_timer_started, now,
+      "Mobile Reachability", mme_app_handle_mobile_reachability_timer_expiry);
+  _rearm_timer(
+      ue_context_p, &ue_context_p->implicit_detach_timer,
+      ue_context_p->time_implicit_detach_timer_started, now, "Implicit Detach",
+      mme_app_handle_implicit_detach_timer_expiry);
+  // Evicted again if it stays idle
+  mme_app_ue_eviction_ue_idle(ue_context_p);
+
+  OAILOG_DEBUG_UE(
+      LOG_MME_APP, evicted_ue->imsi64,
+      "Read back UE context of UE id " MME_UE_S1AP_ID_FMT
+      " evicted %ld s ago\n",
+      mme_ue_s1ap_id, (long) (now - evicted_ue->evicted_at));
+  free_wrapper((void**) &evicted_ue);
+  increment_counter("mme_ue_eviction", 1, 1, "action", "rehydrate");
+  observe_histogram(
+      "mme_ue_rehydration_latency_ms",
+      (double) (zclock_usecs() - start_usec) / USEC_PER_MSEC, NO_LABELS, 6,
+      0.5, 1., 2., 5., 10., 50.);
+  _publish_state();
+  return ue_context_p;
+}
+
+//------------------------------------------------------------------------------
+static void _wake_evicted_ues(time_t now) {
+  mme_app_evicted_ue_t* evicted_ue = NULL;
+
+  while ((evicted_ue = TAILQ_FIRST(&_waking_ues)) &&
+         evicted_ue->wake_at <= now) {
+    mme_app_ue_rehydrate(evicted_ue->mme_ue_s1ap_id);
+  }
+}
+
+//------------------------------------------------------------------------------
+void mme_app_ue_eviction_sweep(time_t now) {
+  if (!_enabled) {
+    return;
+  }
+  _wake_evicted_ues(now);
+  _evict_idle_ues(now);
+  _publish_state();
+}
+
+//------------------------------------------------------------------------------
+static int _eviction_timer_handler(zloop_t* loop, int id, void* arg) {
+  mme_app_ue_eviction_sweep(time(NULL));
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+static bool _mark_hss_reset(
+    hash_key_t key, void* element, void* parameter, void** result) {
+  ((mme_app_evicted_ue_t*) element)->hss_reset = true;
+  return false;
+}
+
+void mme_app_ue_eviction_hss_reset(void) {
+  if (_evicted_ues && _evicted_ues->num_elements) {
+    hashtable_apply_callback_on_elements(
+        _evicted_ues, _mark_hss_reset, NULL, NULL);
+  }
+}
+
+//------------------------------------------------------------------------------
+void mme_app_ue_eviction_start(task_zmq_ctx_t* task_zmq_ctx) {
+  const ue_eviction_config_t* config = &mme_config.ue_eviction_config;
+  bstring b                          = NULL;
+
+  if (!config->idle_time_sec) {
+    return;
+  }
+  // The HA task walks the UE state table from its own thread
+  if (mme_config.use_ha) {
+    OAILOG_WARNING(
+        LOG_MME_APP, "UE context eviction is not supported with HA\n");
+    return;
+  }
+  _idle_time_sec = config->idle_time_sec;
+  _max_per_sweep = config->max_per_sweep;
+  b              = bfromcstr("mme_app_evicted_ue_htbl");
+  _evicted_ues   = hashtable_create(EVICTED_UE_HTBL_SIZE, NULL, NULL, b);
+  bdestroy_wrapper(&b);
+  _enabled           = true;
+  _eviction_timer_id = start_timer(
+      task_zmq_ctx, MME_APP_UE_EVICTION_TIMER_MS, TIMER_REPEAT_FOREVER,
+      _eviction_timer_handler, NULL);
+  _publish_state();
+}
+
+//------------------------------------------------------------------------------
+void mme_app_ue_eviction_stop(task_zmq_ctx_t* task_zmq_ctx) {
+  idle_ue_t* idle_ue = NULL;
+
+  if (!_enabled) {
+    return;
+  }
+  stop_timer(task_zmq_ctx, _eviction_timer_id);
+  _enabled = false;
+  while ((idle_ue = STAILQ_FIRST(&_idle_ues))) {
+    STAILQ_REMOVE_HEAD(&_idle_ues, entries);
+    free(idle_ue);
+  }
+  // Evicted contexts are dropped from the data store on the next start
+  TAILQ_INIT(&_waking_ues);
+  hashtable_destroy(_evicted_ues);
+  _evicted_ues = NULL;
+}
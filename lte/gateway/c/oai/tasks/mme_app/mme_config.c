@@ -59,6 +59,7 @@
 #include "3gpp_23.003.h"
 #include "3gpp_24.008.h"
 #include "3gpp_24.301.h"
+#include "3gpp_36.413.h"
 #include "TrackingAreaIdentity.h"
 #include "bstrlib.h"
 #include "mme_default_values.h"
@@ -67,6 +68,7 @@
 #include "sgw_config.h"
 #endif
 static bool parse_bool(const char* str);
+static uint8_t parse_overload_action(const char* str);
 
 struct mme_config_s mme_config = {.rw_lock = PTHREAD_RWLOCK_INITIALIZER, 0};
 
@@ -151,7 +153,8 @@ void ipv4_config_init(ip_t* ip) {
   ip->if_name_s11       = NULL;
   ip->s11_mme_v4.s_addr = INADDR_ANY;
 
-  ip->port_s11 = 2123;
+  ip->port_s11               = 2123;
+  ip->nb_receive_sockets_s11 = 1;
 }
 
 void s1ap_config_init(s1ap_config_t* s1ap_conf) {
@@ -191,6 +194,7 @@ void nas_config_init(nas_config_t* nas_conf) {
   nas_conf->t3486_sec               = T3486_DEFAULT_VALUE;
   nas_conf->t3489_sec               = T3489_DEFAULT_VALUE;
   nas_conf->t3495_sec               = T3495_DEFAULT_VALUE;
+  nas_conf->t3346_sec               = T3346_DEFAULT_VALUE;
   nas_conf->force_reject_tau        = true;
   nas_conf->force_reject_sr         = true;
   nas_conf->disable_esm_information = false;
@@ -198,6 +202,37 @@ void nas_config_init(nas_config_t* nas_conf) {
   apn_map_config_init(&nas_conf->apn_map_config);
 }
 
+void overload_config_init(overload_config_t* overload_conf) {
+  overload_conf->mme_app_latency_high_ms = MME_APP_QUEUE_LATENCY_HIGH_MS;
+  overload_conf->mme_app_latency_low_ms  = MME_APP_QUEUE_LATENCY_LOW_MS;
+  overload_conf->s6a_latency_high_ms     = S6A_QUEUE_LATENCY_HIGH_MS;
+  overload_conf->s6a_latency_low_ms      = S6A_QUEUE_LATENCY_LOW_MS;
+  overload_conf->procedures_high         = OUTSTANDING_PROCEDURES_HIGH;
+  overload_conf->procedures_low          = OUTSTANDING_PROCEDURES_LOW;
+  overload_conf->overload_action = OVERLOAD_ACTION_REJECT_NON_EMERGENCY_MO_DT;
+  overload_conf->traffic_load_reduction = 0;
+  overload_conf->air_rate               = S6A_AIR_RATE;
+  overload_conf->air_burst              = 0;
+}
+
+void ue_eviction_config_init(ue_eviction_config_t* ue_eviction_conf) {
+  ue_eviction_conf->idle_time_sec = UE_EVICTION_IDLE_TIME_SEC;
+  ue_eviction_conf->max_per_sweep = UE_EVICTION_MAX_PER_SWEEP;
+}
+
+void auth_vector_cache_config_init(
+    auth_vector_cache_config_t* auth_vector_cache_conf) {
+  auth_vector_cache_conf->max_ues         = AUTH_VECTOR_CACHE_MAX_UES;
+  auth_vector_cache_conf->vectors_per_air = AUTH_VECTOR_CACHE_VECTORS_PER_AIR;
+  auth_vector_cache_conf->ttl_sec         = AUTH_VECTOR_CACHE_TTL_SEC;
+}
+
+void procedure_trace_config_init(procedure_trace_config_t* trace_conf) {
+  trace_conf->enabled     = false;
+  trace_conf->sample_rate = PROCEDURE_TRACE_SAMPLE_RATE;
+  trace_conf->file        = bfromcstr(PROCEDURE_TRACE_FILE);
+}
+
 void gummei_config_init(gummei_config_t* gummei_conf) {
   gummei_conf->nb                        = 1;
   gummei_conf->gummei[0].mme_code        = MMEC;
@@ -248,6 +283,10 @@ void mme_config_init(mme_config_t* config) {
   itti_config_init(&config->itti_config);
   sctp_config_init(&config->sctp_config);
   nas_config_init(&config->nas_config);
+  overload_config_init(&config->overload_config);
+  ue_eviction_config_init(&config->ue_eviction_config);
+  auth_vector_cache_config_init(&config->auth_vector_cache_config);
+  procedure_trace_config_init(&config->procedure_trace_config);
   gummei_config_init(&config->gummei);
   served_tai_config_init(&config->served_tai);
   service303_config_init(&config->service303_config);
@@ -267,6 +306,7 @@ void mme_config_exit(void) {
   bdestroy_wrapper(&mme_config.ip.if_name_s11);
   bdestroy_wrapper(&mme_config.s6a_config.conf_file);
   bdestroy_wrapper(&mme_config.itti_config.log_file);
+  bdestroy_wrapper(&mme_config.procedure_trace_config.file);
 
   free_wrapper((void**) &mme_config.served_tai.plmn_mcc);
   free_wrapper((void**) &mme_config.served_tai.plmn_mnc);
@@ -894,6 +934,13 @@ int mme_config_parse_file(mme_config_t* config_pP) {
             bdata(config_pP->ip.if_name_s11));
         bdestroy(cidr);
       }
+      if (config_setting_lookup_int(
+              setting, MME_CONFIG_STRING_MME_RECEIVE_SOCKETS_FOR_S11, &aint)) {
+        AssertFatal(
+            aint >= 1 && aint <= UINT8_MAX,
+            "Bad number of S11 receive sockets: %d\n", aint);
+        config_pP->ip.nb_receive_sockets_s11 = (uint8_t) aint;
+      }
     }
 
     // CSFB SETTING
@@ -974,6 +1021,9 @@ int mme_config_parse_file(mme_config_t* config_pP) {
             else if (strcmp("EIA2", astring) == 0)
               config_pP->nas_config.prefered_integrity_algorithm[i] =
                   EIA2_128_ALG_ID;
+            else if (strcmp("EIA3", astring) == 0)
+              config_pP->nas_config.prefered_integrity_algorithm[i] =
+                  EIA3_128_ALG_ID;
             else
               config_pP->nas_config.prefered_integrity_algorithm[i] =
                   EIA0_ALG_ID;
@@ -1004,6 +1054,9 @@ int mme_config_parse_file(mme_config_t* config_pP) {
             else if (strcmp("EEA2", astring) == 0)
               config_pP->nas_config.prefered_ciphering_algorithm[i] =
                   EEA2_128_ALG_ID;
+            else if (strcmp("EEA3", astring) == 0)
+              config_pP->nas_config.prefered_ciphering_algorithm[i] =
+                  EEA3_128_ALG_ID;
             else
               config_pP->nas_config.prefered_ciphering_algorithm[i] =
                   EEA0_ALG_ID;
@@ -1054,6 +1107,10 @@ int mme_config_parse_file(mme_config_t* config_pP) {
               setting, MME_CONFIG_STRING_NAS_T3495_TIMER, &aint))) {
         config_pP->nas_config.t3495_sec = (uint32_t) aint;
       }
+      if ((config_setting_lookup_int(
+              setting, MME_CONFIG_STRING_NAS_T3346_TIMER, &aint))) {
+        config_pP->nas_config.t3346_sec = (uint32_t) aint;
+      }
       if ((config_setting_lookup_string(
               setting, MME_CONFIG_STRING_NAS_FORCE_REJECT_TAU,
               (const char**) &astring))) {
@@ -1158,6 +1215,124 @@ int mme_config_parse_file(mme_config_t* config_pP) {
         config_pP->sgs_config.ts13_sec = (uint8_t) aint;
       }
     }
+
+    // OVERLOAD CONTROL
+    setting = config_setting_get_member(
+        setting_mme, MME_CONFIG_STRING_OVERLOAD_CONFIG);
+
+    if (setting != NULL) {
+      overload_config_t* overload_config = &config_pP->overload_config;
+
+      if ((config_setting_lookup_int(
+              setting, MME_CONFIG_STRING_MME_APP_QUEUE_LATENCY_HIGH, &aint))) {
+        overload_config->mme_app_latency_high_ms = (uint32_t) aint;
+      }
+      if ((config_setting_lookup_int(
+              setting, MME_CONFIG_STRING_MME_APP_QUEUE_LATENCY_LOW, &aint))) {
+        overload_config->mme_app_latency_low_ms = (uint32_t) aint;
+      }
+      if ((config_setting_lookup_int(
+              setting, MME_CONFIG_STRING_S6A_QUEUE_LATENCY_HIGH, &aint))) {
+        overload_config->s6a_latency_high_ms = (uint32_t) aint;
+      }
+      if ((config_setting_lookup_int(
+              setting, MME_CONFIG_STRING_S6A_QUEUE_LATENCY_LOW, &aint))) {
+        overload_config->s6a_latency_low_ms = (uint32_t) aint;
+      }
+      if ((config_setting_lookup_int(
+              setting, MME_CONFIG_STRING_OUTSTANDING_PROCEDURES_HIGH, &aint))) {
+        overload_config->procedures_high = (uint32_t) aint;
+      }
+      if ((config_setting_lookup_int(
+              setting, MME_CONFIG_STRING_OUTSTANDING_PROCEDURES_LOW, &aint))) {
+        overload_config->procedures_low = (uint32_t) aint;
+      }
+      if ((config_setting_lookup_string(
+              setting, MME_CONFIG_STRING_OVERLOAD_ACTION,
+              (const char**) &astring))) {
+        overload_config->overload_action = parse_overload_action(astring);
+      }
+      if ((config_setting_lookup_int(
+              setting, MME_CONFIG_STRING_TRAFFIC_LOAD_REDUCTION, &aint))) {
+        AssertFatal(
+            aint >= 0 && aint <= 99,
+            "Bad traffic load reduction %d, expected 1..99 or 0 for none\n",
+            aint);
+        overload_config->traffic_load_reduction = (uint8_t) aint;
+      }
+      if ((config_setting_lookup_int(
+              setting, MME_CONFIG_STRING_S6A_AIR_RATE, &aint))) {
+        overload_config->air_rate = (uint32_t) aint;
+      }
+      if ((config_setting_lookup_int(
+              setting, MME_CONFIG_STRING_S6A_AIR_BURST, &aint))) {
+        overload_config->air_burst = (uint32_t) aint;
+      }
+    }
+
+    // UE CONTEXT EVICTION
+    setting = config_setting_get_member(
+        setting_mme, MME_CONFIG_STRING_UE_EVICTION_CONFIG);
+
+    if (setting != NULL) {
+      if ((config_setting_lookup_int(
+              setting, MME_CONFIG_STRING_UE_EVICTION_IDLE_TIME, &aint))) {
+        config_pP->ue_eviction_config.idle_time_sec = (uint32_t) aint;
+      }
+      if ((config_setting_lookup_int(
+              setting, MME_CONFIG_STRING_UE_EVICTION_MAX_PER_SWEEP, &aint))) {
+        config_pP->ue_eviction_config.max_per_sweep = (uint32_t) aint;
+      }
+    }
+
+    // AUTHENTICATION VECTOR CACHE
+    setting = config_setting_get_member(
+        setting_mme, MME_CONFIG_STRING_AUTH_VECTOR_CACHE_CONFIG);
+
+    if (setting != NULL) {
+      auth_vector_cache_config_t* cache_config =
+          &config_pP->auth_vector_cache_config;
+
+      if ((config_setting_lookup_int(
+              setting, MME_CONFIG_STRING_AUTH_VECTOR_CACHE_MAX_UES, &aint))) {
+        cache_config->max_ues = (uint32_t) aint;
+      }
+      if ((config_setting_lookup_int(
+              setting, MME_CONFIG_STRING_AUTH_VECTOR_CACHE_VECTORS_PER_AIR,
+              &aint))) {
+        AssertFatal(
+            aint >= 2 && aint <= MAX_EPS_AUTH_VECTORS_PER_AIR,
+            "Bad vectors per AIR %d, expected 2..%d\n", aint,
+            MAX_EPS_AUTH_VECTORS_PER_AIR);
+        cache_config->vectors_per_air = (uint32_t) aint;
+      }
+      if ((config_setting_lookup_int(
+              setting, MME_CONFIG_STRING_AUTH_VECTOR_CACHE_TTL, &aint))) {
+        cache_config->ttl_sec = (uint32_t) aint;
+      }
+    }
+
+    // PROCEDURE LATENCY TRACE
+    setting = config_setting_get_member(
+        setting_mme, MME_CONFIG_STRING_PROCEDURE_TRACE_CONFIG);
+
+    if (setting != NULL) {
+      if ((config_setting_lookup_string(
+              setting, MME_CONFIG_STRING_PROCEDURE_TRACE_ENABLED,
+              (const char**) &astring))) {
+        config_pP->procedure_trace_config.enabled = parse_bool(astring);
+      }
+      if ((config_setting_lookup_int(
+              setting, MME_CONFIG_STRING_PROCEDURE_TRACE_SAMPLE_RATE,
+              &aint))) {
+        config_pP->procedure_trace_config.sample_rate = (uint32_t) aint;
+      }
+      if ((config_setting_lookup_string(
+              setting, MME_CONFIG_STRING_PROCEDURE_TRACE_FILE,
+              (const char**) &astring))) {
+        bassigncstr(config_pP->procedure_trace_config.file, astring);
+      }
+    }
 #if (!EMBEDDED_SGW)
     // S-GW Setting
     setting =
@@ -1300,6 +1475,9 @@ void mme_config_display(mme_config_t* config_pP) {
       bdata(config_pP->ip.if_name_s11));
   OAILOG_INFO(
       LOG_CONFIG, "    s11 MME port .....: %d\n", config_pP->ip.port_s11);
+  OAILOG_INFO(
+      LOG_CONFIG, "    s11 MME sockets ..: %d\n",
+      config_pP->ip.nb_receive_sockets_s11);
   OAILOG_INFO(
       LOG_CONFIG, "    s11 MME ip .......: %s\n",
       inet_ntoa(*((struct in_addr*) &config_pP->ip.s11_mme_v4)));
@@ -1417,6 +1595,8 @@ void mme_config_display(mme_config_t* config_pP) {
       LOG_CONFIG, "    T3470 ....: %d sec\n", config_pP->nas_config.t3470_sec);
   OAILOG_INFO(
       LOG_CONFIG, "    T3495 ....: %d sec\n", config_pP->nas_config.t3495_sec);
+  OAILOG_INFO(
+      LOG_CONFIG, "    T3346 ....: %d sec\n", config_pP->nas_config.t3346_sec);
   OAILOG_INFO(LOG_CONFIG, "    NAS non standard features .:\n");
   OAILOG_INFO(
       LOG_CONFIG, "      Force reject TAU ............: %s\n",
@@ -1440,6 +1620,56 @@ void mme_config_display(mme_config_t* config_pP) {
         bdata(config_pP->nas_config.apn_map_config.apn_map[j].imsi_prefix),
         bdata(config_pP->nas_config.apn_map_config.apn_map[j].apn_override));
   }
+  OAILOG_INFO(LOG_CONFIG, "- Overload control:\n");
+  OAILOG_INFO(
+      LOG_CONFIG, "    MME_APP queue latency ...: %u / %u ms (high / low)\n",
+      config_pP->overload_config.mme_app_latency_high_ms,
+      config_pP->overload_config.mme_app_latency_low_ms);
+  OAILOG_INFO(
+      LOG_CONFIG, "    S6A queue latency .......: %u / %u ms (high / low)\n",
+      config_pP->overload_config.s6a_latency_high_ms,
+      config_pP->overload_config.s6a_latency_low_ms);
+  OAILOG_INFO(
+      LOG_CONFIG, "    Outstanding procedures ..: %u / %u (high / low)\n",
+      config_pP->overload_config.procedures_high,
+      config_pP->overload_config.procedures_low);
+  OAILOG_INFO(
+      LOG_CONFIG, "    Overload action .........: %u\n",
+      config_pP->overload_config.overload_action);
+  OAILOG_INFO(
+      LOG_CONFIG, "    Traffic load reduction ..: %u %%\n",
+      config_pP->overload_config.traffic_load_reduction);
+  OAILOG_INFO(
+      LOG_CONFIG, "    AIR rate ................: %u/s (burst %u)\n",
+      config_pP->overload_config.air_rate,
+      config_pP->overload_config.air_burst);
+  OAILOG_INFO(LOG_CONFIG, "- UE context eviction:\n");
+  OAILOG_INFO(
+      LOG_CONFIG, "    Idle time ...............: %u s (0 disabled)\n",
+      config_pP->ue_eviction_config.idle_time_sec);
+  OAILOG_INFO(
+      LOG_CONFIG, "    Max evictions per sweep .: %u\n",
+      config_pP->ue_eviction_config.max_per_sweep);
+  OAILOG_INFO(LOG_CONFIG, "- Authentication vector cache:\n");
+  OAILOG_INFO(
+      LOG_CONFIG, "    Max UEs .................: %u (0 disabled)\n",
+      config_pP->auth_vector_cache_config.max_ues);
+  OAILOG_INFO(
+      LOG_CONFIG, "    Vectors per AIR .........: %u\n",
+      config_pP->auth_vector_cache_config.vectors_per_air);
+  OAILOG_INFO(
+      LOG_CONFIG, "    TTL .....................: %u s\n",
+      config_pP->auth_vector_cache_config.ttl_sec);
+  OAILOG_INFO(LOG_CONFIG, "- Procedure latency trace:\n");
+  OAILOG_INFO(
+      LOG_CONFIG, "    Enabled .................: %s\n",
+      config_pP->procedure_trace_config.enabled ? "true" : "false");
+  OAILOG_INFO(
+      LOG_CONFIG, "    Sample rate .............: 1/%u (0 none)\n",
+      config_pP->procedure_trace_config.sample_rate);
+  OAILOG_INFO(
+      LOG_CONFIG, "    Trace file ..............: %s\n",
+      bdata(config_pP->procedure_trace_config.file));
   OAILOG_INFO(LOG_CONFIG, "- S6A:\n");
 #if S6A_OVER_GRPC
   OAILOG_INFO(LOG_CONFIG, "    protocol .........: gRPC\n");
@@ -1598,3 +1828,29 @@ static bool parse_bool(const char* str) {
 
   Fatal("Error in config file: got \"%s\" but expected bool\n", str);
 }
+
+static uint8_t parse_overload_action(const char* str) {
+  if (strcasecmp(
+          str, MME_CONFIG_STRING_OVERLOAD_ACTION_REJECT_NON_EMERGENCY_MO_DT) ==
+      0)
+    return OVERLOAD_ACTION_REJECT_NON_EMERGENCY_MO_DT;
+  if (strcasecmp(
+          str, MME_CONFIG_STRING_OVERLOAD_ACTION_REJECT_RRC_CR_SIGNALLING) == 0)
+    return OVERLOAD_ACTION_REJECT_RRC_CR_SIGNALLING;
+  if (strcasecmp(
+          str,
+          MME_CONFIG_STRING_OVERLOAD_ACTION_PERMIT_EMERGENCY_AND_MT_ONLY) == 0)
+    return OVERLOAD_ACTION_PERMIT_EMERGENCY_AND_MT_ONLY;
+  if (strcasecmp(
+          str,
+          MME_CONFIG_STRING_OVERLOAD_ACTION_PERMIT_HIGH_PRIORITY_AND_MT_ONLY) ==
+      0)
+    return OVERLOAD_ACTION_PERMIT_HIGH_PRIORITY_AND_MT_ONLY;
+  if (strcasecmp(
+          str, MME_CONFIG_STRING_OVERLOAD_ACTION_REJECT_DELAY_TOLERANT_ACCESS) ==
+      0)
+    return OVERLOAD_ACTION_REJECT_DELAY_TOLERANT_ACCESS;
+
+  Fatal(
+      "Error in config file: got \"%s\" but expected overload action\n", str);
+}
@@ -48,13 +48,14 @@
 
 static int _nas_message_plain_decode(
     const unsigned char* buffer, const nas_message_security_header_t* header,
-    nas_message_plain_t* msg, size_t length);
+    nas_message_plain_t* msg, size_t length,
+    nas_message_decode_arena_t* const arena);
 
 static int _nas_message_protected_decode(
     unsigned char* const buffer, nas_message_security_header_t* header,
     nas_message_plain_t* msg, size_t length,
     emm_security_context_t* const emm_security_context,
-    nas_message_decode_status_t* status);
+    nas_message_decode_status_t* status, nas_message_decode_arena_t* arena);
 
 /* Functions used to encode layer 3 NAS messages */
 static int _nas_message_header_encode(
@@ -86,6 +87,15 @@ static uint32_t _nas_message_get_mac(
     const unsigned char* const buffer, size_t const length, int const direction,
     emm_security_context_t* const emm_security_context);
 
+/* 128-EEA2 and 128-EIA2 with the key cache of the security context */
+static void _nas_message_encrypt_eea2(
+    emm_security_context_t* const emm_security_context,
+    nas_stream_cipher_t* const stream_cipher, uint8_t* const out);
+
+static void _nas_message_encrypt_eia2(
+    emm_security_context_t* const emm_security_context,
+    nas_stream_cipher_t* const stream_cipher, uint8_t out[4]);
+
 /****************************************************************************/
 /******************  E X P O R T E D    F U N C T I O N S  ******************/
 /****************************************************************************/
@@ -332,6 +342,38 @@ int nas_message_decrypt(
 int nas_message_decode(
     const unsigned char* const buffer, nas_message_t* msg, size_t length,
     void* security, nas_message_decode_status_t* status) {
+  return nas_message_decode_view(buffer, msg, length, security, status, NULL);
+}
+
+/*
+
+   Name:  nas_message_decode_view()
+
+   Description: Decode layer 3 NAS message without allocating its octet
+       string IEs
+
+   Inputs:  buffer:  Pointer to the buffer containing layer 3
+       NAS message data
+       length:  Number of bytes that should be decoded
+       security:  security context
+       arena:  storage for the plain message and its octet
+         string IEs, NULL to decode them into heap copies
+       Others:  None
+
+   Outputs:   msg:   L3 NAS message structure to be filled; its
+         octet string IEs are views into the arena, valid
+         as long as it is, unless the message does not fit
+         into the arena
+       Return:  The number of bytes in the buffer if the
+         data have been successfully decoded;
+         A negative error code otherwise.
+       Others:  Return the computed mac if security context is established
+
+*/
+int nas_message_decode_view(
+    const unsigned char* const buffer, nas_message_t* msg, size_t length,
+    void* security, nas_message_decode_status_t* status,
+    nas_message_decode_arena_t* const arena) {
   OAILOG_FUNC_IN(LOG_NAS);
   emm_security_context_t* emm_security_context =
       (emm_security_context_t*) security;
@@ -491,13 +533,21 @@ int nas_message_decode(
     // LG WARNING  msg->plain versus msg->security.plain.
     bytes = _nas_message_protected_decode(
         (unsigned char* const)(buffer + size), &msg->header, &msg->plain,
-        length - size, emm_security_context, status);
+        length - size, emm_security_context, status, arena);
+  } else if ((arena) && (length <= sizeof(arena->buffer))) {
+    /*
+     * Decode plain NAS message from the arena, the caller may release
+     * the received buffer before it is done with the message
+     */
+    memcpy(arena->buffer, buffer, length);
+    bytes = _nas_message_plain_decode(
+        arena->buffer, &msg->header, &msg->plain, length, arena);
   } else {
     /*
      * Decode plain NAS message
      */
-    bytes =
-        _nas_message_plain_decode(buffer, &msg->header, &msg->plain, length);
+    bytes = _nas_message_plain_decode(
+        buffer, &msg->header, &msg->plain, length, NULL);
   }
 
   if (bytes < 0) {
@@ -756,9 +806,15 @@ int nas_message_header_decode(
  ***************************************************************************/
 static int _nas_message_plain_decode(
     const unsigned char* buffer, const nas_message_security_header_t* header,
-    nas_message_plain_t* msg, size_t length) {
+    nas_message_plain_t* msg, size_t length,
+    nas_message_decode_arena_t* const arena) {
   OAILOG_FUNC_IN(LOG_NAS);
-  int bytes = TLV_PROTOCOL_NOT_SUPPORTED;
+  int bytes                    = TLV_PROTOCOL_NOT_SUPPORTED;
+  tlv_decode_arena_t* previous = NULL;
+
+  if (arena) {
+    previous = tlv_decode_arena_install(&arena->tlv);
+  }
 
   if (header->protocol_discriminator == EPS_MOBILITY_MANAGEMENT_MESSAGE) {
     /*
@@ -781,6 +837,9 @@ static int _nas_message_plain_decode(
         header->protocol_discriminator);
   }
 
+  if (arena) {
+    tlv_decode_arena_install(previous);
+  }
   OAILOG_FUNC_RETURN(LOG_NAS, bytes);
 }
 
@@ -808,11 +867,18 @@ static int _nas_message_protected_decode(
     unsigned char* const buffer, nas_message_security_header_t* header,
     nas_message_plain_t* msg, size_t length,
     emm_security_context_t* const emm_security_context,
-    nas_message_decode_status_t* const status) {
+    nas_message_decode_status_t* const status,
+    nas_message_decode_arena_t* arena) {
   OAILOG_FUNC_IN(LOG_NAS);
-  int bytes                      = TLV_BUFFER_TOO_SHORT;
-  unsigned char* const plain_msg = (unsigned char*) calloc(1, length);
+  int bytes                = TLV_BUFFER_TOO_SHORT;
+  unsigned char* plain_msg = NULL;
 
+  if ((arena) && (length <= sizeof(arena->buffer))) {
+    plain_msg = arena->buffer;
+  } else {
+    arena     = NULL;
+    plain_msg = (unsigned char*) calloc(1, length);
+  }
   if (plain_msg) {
     /*
      * Decrypt the security protected NAS message
@@ -824,8 +890,10 @@ static int _nas_message_protected_decode(
     /*
      * Decode the decrypted message as plain NAS message
      */
-    bytes = _nas_message_plain_decode(plain_msg, header, msg, length);
-    free_wrapper((void**) &plain_msg);
+    bytes = _nas_message_plain_decode(plain_msg, header, msg, length, arena);
+    if (!arena) {
+      free_wrapper((void**) &plain_msg);
+    }
   }
 
   OAILOG_FUNC_RETURN(LOG_NAS, bytes);
@@ -1148,7 +1216,54 @@ static int _nas_message_decrypt(
              * length in bits
              */
             stream_cipher.blength = length << 3;
-            nas_stream_encrypt_eea2(&stream_cipher, (uint8_t*) dest);
+            _nas_message_encrypt_eea2(
+                emm_security_context, &stream_cipher, (uint8_t*) dest);
+            /*
+             * Decode the first octet (security header type or EPS bearer
+             * identity,
+             * * * * and protocol discriminator)
+             */
+            DECODE_U8(dest, *(uint8_t*) (&header), size);
+            OAILOG_FUNC_RETURN(LOG_NAS, header.protocol_discriminator);
+          } break;
+
+          case NAS_SECURITY_ALGORITHMS_EEA3: {
+            if (0 == status->mac_matched) {
+              OAILOG_ERROR(LOG_NAS, "MAC integrity failed\n");
+              OAILOG_FUNC_RETURN(LOG_NAS, 0);
+            }
+            if (direction == SECU_DIRECTION_UPLINK) {
+              count = 0x00000000 |
+                      ((emm_security_context->ul_count.overflow & 0x0000FFFF)
+                       << 8) |
+                      (emm_security_context->ul_count.seq_num & 0x000000FF);
+            } else {
+              count = 0x00000000 |
+                      ((emm_security_context->dl_count.overflow & 0x0000FFFF)
+                       << 8) |
+                      (emm_security_context->dl_count.seq_num & 0x000000FF);
+            }
+
+            OAILOG_DEBUG(
+                LOG_NAS,
+                "NAS_SECURITY_ALGORITHMS_EEA3 dir %s count.seq_num %u count "
+                "%u\n",
+                (direction == SECU_DIRECTION_UPLINK) ? "UPLINK" : "DOWNLINK",
+                (direction == SECU_DIRECTION_UPLINK) ?
+                    emm_security_context->ul_count.seq_num :
+                    emm_security_context->dl_count.seq_num,
+                count);
+            stream_cipher.key        = emm_security_context->knas_enc;
+            stream_cipher.key_length = AUTH_KNAS_ENC_SIZE;
+            stream_cipher.count      = count;
+            stream_cipher.bearer     = 0x00;  // 33.401 section 8.1.1
+            stream_cipher.direction  = direction;
+            stream_cipher.message    = (uint8_t*) src;
+            /*
+             * length in bits
+             */
+            stream_cipher.blength = length << 3;
+            nas_stream_encrypt_eea3(&stream_cipher, (uint8_t*) dest);
             /*
              * Decode the first octet (security header type or EPS bearer
              * identity,
@@ -1328,7 +1443,43 @@ static int _nas_message_encrypt(
            * length in bits
            */
           stream_cipher.blength = length << 3;
-          nas_stream_encrypt_eea2(&stream_cipher, (uint8_t*) dest);
+          _nas_message_encrypt_eea2(
+              emm_security_context, &stream_cipher, (uint8_t*) dest);
+          OAILOG_FUNC_RETURN(LOG_NAS, length);
+        } break;
+
+        case NAS_SECURITY_ALGORITHMS_EEA3: {
+          if (direction == SECU_DIRECTION_UPLINK) {
+            count =
+                0x00000000 |
+                ((emm_security_context->ul_count.overflow & 0x0000FFFF) << 8) |
+                (emm_security_context->ul_count.seq_num & 0x000000FF);
+          } else {
+            count =
+                0x00000000 |
+                ((emm_security_context->dl_count.overflow & 0x0000FFFF) << 8) |
+                (emm_security_context->dl_count.seq_num & 0x000000FF);
+          }
+
+          OAILOG_DEBUG(
+              LOG_NAS,
+              "NAS_SECURITY_ALGORITHMS_EEA3 dir %s count.seq_num %u count %u\n",
+              (direction == SECU_DIRECTION_UPLINK) ? "UPLINK" : "DOWNLINK",
+              (direction == SECU_DIRECTION_UPLINK) ?
+                  emm_security_context->ul_count.seq_num :
+                  emm_security_context->dl_count.seq_num,
+              count);
+          stream_cipher.key        = emm_security_context->knas_enc;
+          stream_cipher.key_length = AUTH_KNAS_ENC_SIZE;
+          stream_cipher.count      = count;
+          stream_cipher.bearer     = 0x00;  // 33.401 section 8.1.1
+          stream_cipher.direction  = direction;
+          stream_cipher.message    = (uint8_t*) src;
+          /*
+           * length in bits
+           */
+          stream_cipher.blength = length << 3;
+          nas_stream_encrypt_eea3(&stream_cipher, (uint8_t*) dest);
           OAILOG_FUNC_RETURN(LOG_NAS, length);
         } break;
 
@@ -1480,7 +1631,7 @@ static uint32_t _nas_message_get_mac(
        * length in bits
        */
       stream_cipher.blength = length << 3;
-      nas_stream_encrypt_eia2(&stream_cipher, mac);
+      _nas_message_encrypt_eia2(emm_security_context, &stream_cipher, mac);
       OAILOG_DEBUG(
           LOG_NAS,
           "NAS_SECURITY_ALGORITHMS_EIA2 returned MAC %x.%x.%x.%x(%u) for "
@@ -1492,6 +1643,52 @@ static uint32_t _nas_message_get_mac(
       OAILOG_FUNC_RETURN(LOG_NAS, ntohl(*mac32));
     } break;
 
+    case NAS_SECURITY_ALGORITHMS_EIA3: {
+      uint8_t mac[4];
+      nas_stream_cipher_t stream_cipher;
+      uint32_t count;
+      uint32_t* mac32;
+
+      if (direction == SECU_DIRECTION_UPLINK) {
+        count = 0x00000000 |
+                ((emm_security_context->ul_count.overflow & 0x0000FFFF) << 8) |
+                (emm_security_context->ul_count.seq_num & 0x000000FF);
+      } else {
+        count = 0x00000000 |
+                ((emm_security_context->dl_count.overflow & 0x0000FFFF) << 8) |
+                (emm_security_context->dl_count.seq_num & 0x000000FF);
+      }
+
+      OAILOG_DEBUG(
+          LOG_NAS,
+          "NAS_SECURITY_ALGORITHMS_EIA3 dir %s count.seq_num %u count %u\n",
+          (direction == SECU_DIRECTION_UPLINK) ? "UPLINK" : "DOWNLINK",
+          (direction == SECU_DIRECTION_UPLINK) ?
+              emm_security_context->ul_count.seq_num :
+              emm_security_context->dl_count.seq_num,
+          count);
+      stream_cipher.key        = emm_security_context->knas_int;
+      stream_cipher.key_length = AUTH_KNAS_INT_SIZE;
+      stream_cipher.count      = count;
+      stream_cipher.bearer     = 0x00;  // 33.401 section 8.1.1
+      stream_cipher.direction  = direction;
+      stream_cipher.message    = (uint8_t*) buffer;
+      /*
+       * length in bits
+       */
+      stream_cipher.blength = length << 3;
+      nas_stream_encrypt_eia3(&stream_cipher, mac);
+      OAILOG_DEBUG(
+          LOG_NAS,
+          "NAS_SECURITY_ALGORITHMS_EIA3 returned MAC %x.%x.%x.%x(%u) for "
+          "length "
+          "%lu direction %d, count %d\n",
+          mac[0], mac[1], mac[2], mac[3], *((uint32_t*) &mac), length,
+          direction, count);
+      mac32 = (uint32_t*) &mac;
+      OAILOG_FUNC_RETURN(LOG_NAS, ntohl(*mac32));
+    } break;
+
     case NAS_SECURITY_ALGORITHMS_EIA0:
       OAILOG_DEBUG(
           LOG_NAS, "NAS_SECURITY_ALGORITHMS_EIA0 dir %s count.seq_num %u\n",
@@ -1511,3 +1708,35 @@ static uint32_t _nas_message_get_mac(
 
   OAILOG_FUNC_RETURN(LOG_NAS, 0);
 }
+
+/*
+   -----------------------------------------------------------------------------
+      Keyed with the key cache of the security context, or with a one-time key
+      schedule when the cache cannot be allocated
+   -----------------------------------------------------------------------------
+*/
+static void _nas_message_encrypt_eea2(
+    emm_security_context_t* const emm_security_context,
+    nas_stream_cipher_t* const stream_cipher, uint8_t* const out) {
+  nas_stream_key_cache_t* key_cache =
+      emm_security_context_key_cache(emm_security_context);
+
+  if (key_cache) {
+    nas_stream_encrypt_eea2_cached(key_cache, stream_cipher, out);
+  } else {
+    nas_stream_encrypt_eea2(stream_cipher, out);
+  }
+}
+
+static void _nas_message_encrypt_eia2(
+    emm_security_context_t* const emm_security_context,
+    nas_stream_cipher_t* const stream_cipher, uint8_t out[4]) {
+  nas_stream_key_cache_t* key_cache =
+      emm_security_context_key_cache(emm_security_context);
+
+  if (key_cache) {
+    nas_stream_encrypt_eia2_cached(key_cache, stream_cipher, out);
+  } else {
+    nas_stream_encrypt_eia2(stream_cipher, out);
+  }
+}
@@ -46,6 +46,7 @@ Description Defines the layer 3 messages supported by the NAS sublayer
 #include "emm_data.h"
 #include "esm_msg.h"
 #include "3gpp_24.007.h"
+#include "TLVDecoder.h"
 
 /****************************************************************************/
 /*********************  G L O B A L    C O N S T A N T S  *******************/
@@ -100,6 +101,21 @@ typedef struct nas_message_decode_status_s {
   int emm_cause;
 } nas_message_decode_status_t;
 
+/* Largest plain NAS message decoded without any allocation */
+#define NAS_MESSAGE_DECODE_ARENA_SIZE 1024
+
+/*
+ * Storage for nas_message_decode_view(): the plain (deciphered) message and
+ * the views its octet string IEs are decoded into. The views of a message are
+ * overwritten by the next decode into the same arena, and the arena is
+ * installed process-wide for the duration of the decode (see
+ * tlv_decode_arena_install()), so it is only used from the MME_APP task.
+ */
+typedef struct nas_message_decode_arena_s {
+  tlv_decode_arena_t tlv;
+  unsigned char buffer[NAS_MESSAGE_DECODE_ARENA_SIZE];
+} nas_message_decode_arena_t;
+
 /****************************************************************************/
 /********************  G L O B A L    V A R I A B L E S  ********************/
 /****************************************************************************/
@@ -125,6 +141,11 @@ int nas_message_decode(
     const unsigned char* const buffer, nas_message_t* msg, size_t length,
     void* security, nas_message_decode_status_t* status);
 
+int nas_message_decode_view(
+    const unsigned char* const buffer, nas_message_t* msg, size_t length,
+    void* security, nas_message_decode_status_t* status,
+    nas_message_decode_arena_t* const arena);
+
 int nas_message_encode(
     unsigned char* buffer, const nas_message_t* const msg, size_t length,
     void* security);
@@ -67,6 +67,7 @@
 #include "mme_app_ue_context.h"
 #include "mme_app_itti_messaging.h"
 #include "mme_config.h"
+#include "mme_app_overload.h"
 #include "mme_events.h"
 #include "nas_procedures.h"
 #include "nas_message.h"
@@ -98,6 +99,7 @@
 #include "EpsNetworkFeatureSupport.h"
 #include "TrackingAreaIdentity.h"
 #include "TrackingAreaIdentityList.h"
+#include "procedure_trace.h"
 
 /****************************************************************************/
 /****************  E X T E R N A L    D E F I N I T I O N S  ****************/
@@ -817,6 +819,10 @@ int emm_proc_attach_complete(
       emm_proc_emm_informtion(ue_mm_context);
       increment_counter("ue_attach", 1, 1, "result", "attach_proc_successful");
       attach_success_event(ue_mm_context->emm_context._imsi64);
+      procedure_trace_task_span(
+          TRACE_KEY_MME_UE_S1AP_ID(ue_id), TRACE_STAGE_NAS);
+      procedure_trace_end(
+          TRACE_KEY_MME_UE_S1AP_ID(ue_id), TRACE_PROCEDURE_ATTACH);
     }
   } else if (esm_sap.err != ESM_SAP_DISCARDED) {
     /*
@@ -1014,6 +1020,7 @@ int _emm_attach_reject(
   emm_sap_t emm_sap = {0};
   struct nas_emm_attach_proc_s* attach_proc =
       (struct nas_emm_attach_proc_s*) nas_base_proc;
+  uint32_t t3346_sec = 0;
 
   OAILOG_WARNING(
       LOG_NAS_EMM,
@@ -1031,6 +1038,17 @@ int _emm_attach_reject(
   emm_sap.u.emm_as.u.establish.emm_cause = attach_proc->emm_cause;
   emm_sap.u.emm_as.u.establish.nas_info  = EMM_AS_NAS_INFO_ATTACH;
 
+  /*
+   * 3GPP TS 24.301, section 5.5.1.2.5: with cause #22 the UE starts T3346
+   * and does not retry the attach before it expires
+   */
+  if (attach_proc->emm_cause == EMM_CAUSE_CONGESTION &&
+      mme_config.nas_config.t3346_sec) {
+    t3346_sec = mme_app_overload_spread_t3346(
+        mme_config.nas_config.t3346_sec, (uint32_t) rand());
+    emm_sap.u.emm_as.u.establish.t3346 = &t3346_sec;
+  }
+
   if (attach_proc->emm_cause != EMM_CAUSE_ESM_FAILURE) {
     emm_sap.u.emm_as.u.establish.nas_msg = NULL;
   } else if (attach_proc->esm_msg_out) {
@@ -54,6 +54,9 @@
 #include "security_types.h"
 #include "intertask_interface.h"
 #include "nas_proc.h"
+#include "mme_app_auth_vector_cache.h"
+#include "mme_app_overload.h"
+#include "procedure_trace.h"
 
 /****************************************************************************/
 /****************  E X T E R N A L    D E F I N I T I O N S  ****************/
@@ -1500,7 +1503,14 @@ static void _nas_itti_auth_info_req(
         auth_info_req->resync_param, auts_pP->data,
         sizeof auth_info_req->resync_param);
   }
-  send_msg_to_task(&mme_app_task_zmq_ctx, TASK_S6A, message_p);
+  procedure_trace_span_start(
+      TRACE_KEY_MME_UE_S1AP_ID(ue_id), TRACE_STAGE_S6A_AIR);
+  // Vectors kept from an earlier AIR of the UE save the HSS round trip
+  if (mme_app_auth_vector_cache_answer_air(message_p)) {
+    OAILOG_FUNC_OUT(LOG_NAS);
+  }
+  // Paced towards the HSS by the overload control
+  mme_app_overload_send_air(message_p);
   OAILOG_FUNC_OUT(LOG_NAS);
 }
 
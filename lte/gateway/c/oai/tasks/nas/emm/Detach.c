@@ -43,6 +43,7 @@
 #include "mme_api.h"
 #include "mme_events.h"
 #include "nas_procedures.h"
+#include "procedure_trace.h"
 
 /****************************************************************************/
 /****************  E X T E R N A L    D E F I N I T I O N S  ****************/
@@ -334,6 +335,8 @@ int emm_proc_detach_request(
       "EMM-PROC  - Detach type = %s (%d) requested"
       " (ue_id=" MME_UE_S1AP_ID_FMT ")\n",
       _emm_detach_type_str[params->type], params->type, ue_id);
+  procedure_trace_start(
+      TRACE_KEY_MME_UE_S1AP_ID(ue_id), TRACE_PROCEDURE_DETACH);
   /*
    * Get the UE emm context
    */
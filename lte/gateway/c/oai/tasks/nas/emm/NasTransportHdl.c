@@ -97,7 +97,8 @@
  **      Others:    _emm_data                                  **
  **                                                                        **
  ***************************************************************************/
-int emm_proc_uplink_nas_transport(mme_ue_s1ap_id_t ue_id, bstring nas_msg_pP) {
+int emm_proc_uplink_nas_transport(
+    mme_ue_s1ap_id_t ue_id, const_bstring nas_msg_pP) {
   int rc                                     = RETURNok;
   emm_context_t* emm_ctxt_p                  = NULL;
   imeisv_t* p_imeisv                         = NULL;
@@ -134,9 +135,11 @@ int emm_proc_uplink_nas_transport(mme_ue_s1ap_id_t ue_id, bstring nas_msg_pP) {
 
         IMSI_TO_STRING(&emm_ctxt_p->_imsi, imsi_str, IMSI_BCD_DIGITS_MAX + 1);
 
+        // the message container is owned by the caller
         nas_itti_sgsap_uplink_unitdata(
-            imsi_str, strlen(imsi_str), nas_msg_pP, p_imeisv, p_mob_st_clsMark2,
-            &emm_ctxt_p->originating_tai, &ue_mm_context_p->e_utran_cgi,
+            imsi_str, strlen(imsi_str), bstrcpy(nas_msg_pP), p_imeisv,
+            p_mob_st_clsMark2, &emm_ctxt_p->originating_tai,
+            &ue_mm_context_p->e_utran_cgi,
             _esm_data.conf.features & MME_API_SMS_ORC8R_SUPPORTED);
       } else {
         if (emm_ctxt_p->is_imsi_only_detach == true) {
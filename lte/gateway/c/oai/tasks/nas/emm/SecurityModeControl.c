@@ -243,16 +243,39 @@ int emm_proc_security_mode_control(
       emm_ctx_set_security_type(emm_ctx, SECURITY_CTX_TYPE_FULL_NATIVE);
       AssertFatal(
           KSI_NO_KEY_AVAILABLE > emm_ctx->_security.eksi, "eksi not valid");
-      derive_key_nas(
-          NAS_INT_ALG, emm_ctx->_security.selected_algorithms.integrity,
+      /*
+       * Key HMAC with KASME once for the NAS keys, and later KeNB and NH
+       */
+      kdf_context_t one_time_kdf_ctx = {0};
+      kdf_context_t* kdf_ctx =
+          emm_security_context_kdf_context(&emm_ctx->_security);
+      if (!kdf_ctx) {
+        kdf_ctx = &one_time_kdf_ctx;
+      }
+      kdf_context_set_key(
+          kdf_ctx,
           emm_ctx->_vector[emm_ctx->_security.eksi % MAX_EPS_AUTH_VECTORS]
-              .kasme,
+              .kasme);
+      derive_key_nas_with_context(
+          kdf_ctx, NAS_INT_ALG,
+          emm_ctx->_security.selected_algorithms.integrity,
           emm_ctx->_security.knas_int);
-      derive_key_nas(
-          NAS_ENC_ALG, emm_ctx->_security.selected_algorithms.encryption,
-          emm_ctx->_vector[emm_ctx->_security.eksi % MAX_EPS_AUTH_VECTORS]
-              .kasme,
+      derive_key_nas_with_context(
+          kdf_ctx, NAS_ENC_ALG,
+          emm_ctx->_security.selected_algorithms.encryption,
           emm_ctx->_security.knas_enc);
+      kdf_context_clear(&one_time_kdf_ctx);
+      /*
+       * Expand the NAS keys once, so that NAS messages of this security
+       * context are ciphered and integrity protected without re-keying
+       */
+      nas_stream_key_cache_t* key_cache =
+          emm_security_context_key_cache(&emm_ctx->_security);
+      if (key_cache) {
+        nas_stream_key_cache_init(
+            key_cache, emm_ctx->_security.knas_enc,
+            emm_ctx->_security.knas_int);
+      }
       /*
        * Set new security context indicator
        */
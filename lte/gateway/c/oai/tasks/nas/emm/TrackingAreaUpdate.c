@@ -52,6 +52,7 @@
 #include "nas_procedures.h"
 #include "mme_app_itti_messaging.h"
 #include "mme_app_defs.h"
+#include "procedure_trace.h"
 
 /****************************************************************************/
 /****************  E X T E R N A L    D E F I N I T I O N S  ****************/
@@ -700,6 +701,10 @@ static int _emm_tracking_area_update_accept(
           emm_context->_security.selected_algorithms.integrity);
 
       rc = emm_sap_send(&emm_sap);
+      if (rc != RETURNerror) {
+        procedure_trace_end(
+            TRACE_KEY_MME_UE_S1AP_ID(tau_proc->ue_id), TRACE_PROCEDURE_TAU);
+      }
 
       // Check if new TMSI is allocated as part of Combined TAU
       if (rc != RETURNerror) {
@@ -781,6 +786,10 @@ static int _emm_tracking_area_update_accept(
        */
       emm_sap.primitive = EMMAS_DATA_REQ;
       rc                = emm_sap_send(&emm_sap);
+      if (rc != RETURNerror) {
+        procedure_trace_end(
+            TRACE_KEY_MME_UE_S1AP_ID(tau_proc->ue_id), TRACE_PROCEDURE_TAU);
+      }
       increment_counter(
           "tracking_area_update", 1, 1, "action", "tau_accept_sent");
 
@@ -40,6 +40,7 @@ Description Defines internal private data handled by EPS Mobility
 #include "hashtable.h"
 #include "obj_hashtable.h"
 #include "nas/securityDef.h"
+#include "secu_defs.h"
 #include "TrackingAreaIdentityList.h"
 #include "emm_fsm.h"
 #include "nas_timer.h"
@@ -108,8 +109,21 @@ typedef struct emm_security_context_s {
   // security keys for HO
   uint8_t next_hop[AUTH_NEXT_HOP_SIZE]; /* Next HOP security parameter */
   uint8_t next_hop_chaining_count;      /* Next Hop Chaining Count */
+  // key caches, not persisted: allocated on first use, released when the UE
+  // leaves ECM-CONNECTED, see emm_security_context_key_cache(). Owned by the
+  // context, a copy of it has to reset the pointer
+  struct emm_security_key_caches_s* key_caches;
 } emm_security_context_t;
 
+/* Derived key material of an EPS security context, only kept while the UE
+ * is connected: about 1 kB per UE that idle UEs do not pay for */
+typedef struct emm_security_key_caches_s {
+  // expanded knas_enc/knas_int, rebuilt on first use if absent
+  nas_stream_key_cache_t key_cache;
+  // HMAC state keyed with KASME, rebuilt on first use if absent
+  kdf_context_t kdf_context;
+} emm_security_key_caches_t;
+
 /*
  * --------------------------------------------------------------------------
  *  EMM internal data handled by EPS Mobility Management sublayer in the MME
@@ -257,8 +271,8 @@ typedef struct emm_context_s {
                     context may exist simultaneously with a native non-current
                     EPS security context.*/
 
-  // Requirement MME24.301R10_4.4.2.1_2
-  emm_security_context_t
+  // Requirement MME24.301R10_4.4.2.1_2, NULL unless there is one
+  emm_security_context_t*
       _non_current_security; /* Non-current EPS security context: A native EPS
                                 security context that is not the current one. A
                                 non-current EPS security context may be stored
@@ -489,6 +503,15 @@ void emm_ctx_clear_non_current_security_vector_index(emm_context_t* const ctxt)
 void emm_ctx_set_non_current_security_vector_index(
     emm_context_t* const ctxt, int vector_index) __attribute__((nonnull));
 
+/* Key caches of sc, allocated on first use: NULL if that fails, in which case
+ * the caller keys a one-time cache or KDF context instead */
+nas_stream_key_cache_t* emm_security_context_key_cache(
+    emm_security_context_t* const sc) __attribute__((nonnull));
+kdf_context_t* emm_security_context_kdf_context(
+    emm_security_context_t* const sc) __attribute__((nonnull));
+void emm_security_context_free_key_caches(emm_security_context_t* const sc)
+    __attribute__((nonnull));
+
 void emm_ctx_clear_ue_nw_cap(emm_context_t* const ctxt)
     __attribute__((nonnull));
 void emm_ctx_set_ue_nw_cap(
@@ -355,6 +355,7 @@ inline void emm_ctx_clear_auth_vector(emm_context_t* const ctxt, ksi_t eksi) {
 //------------------------------------------------------------------------------
 /* Clear security  */
 inline void emm_ctx_clear_security(emm_context_t* const ctxt) {
+  emm_security_context_free_key_caches(&ctxt->_security);
   memset(&ctxt->_security, 0, sizeof(ctxt->_security));
   emm_ctx_set_security_type(ctxt, SECURITY_CTX_TYPE_NOT_AVAILABLE);
   emm_ctx_set_security_eksi(ctxt, KSI_NO_KEY_AVAILABLE);
@@ -416,13 +417,10 @@ inline void emm_ctx_set_security_vector_index(
 //------------------------------------------------------------------------------
 /* Clear non current security  */
 inline void emm_ctx_clear_non_current_security(emm_context_t* const ctxt) {
-  memset(&ctxt->_non_current_security, 0, sizeof(ctxt->_non_current_security));
-  ctxt->_non_current_security.sc_type = SECURITY_CTX_TYPE_NOT_AVAILABLE;
-  ctxt->_non_current_security.eksi    = KSI_NO_KEY_AVAILABLE;
-  ctxt->_non_current_security.selected_algorithms.encryption =
-      NAS_SECURITY_ALGORITHMS_EEA0;
-  ctxt->_non_current_security.selected_algorithms.integrity =
-      NAS_SECURITY_ALGORITHMS_EIA0;
+  if (ctxt->_non_current_security) {
+    emm_security_context_free_key_caches(ctxt->_non_current_security);
+    free_wrapper((void**) &ctxt->_non_current_security);
+  }
   emm_ctx_clear_attribute_present(ctxt, EMM_CTXT_MEMBER_NON_CURRENT_SECURITY);
   ctxt->_security.direction_decode = SECU_DIRECTION_UPLINK;
   ctxt->_security.direction_encode = SECU_DIRECTION_DOWNLINK;
@@ -433,6 +431,45 @@ inline void emm_ctx_clear_non_current_security(emm_context_t* const ctxt) {
           ->mme_ue_s1ap_id);
 }
 
+//------------------------------------------------------------------------------
+static emm_security_key_caches_t* _emm_security_context_key_caches(
+    emm_security_context_t* const sc) {
+  if (!sc->key_caches) {
+    sc->key_caches = calloc(1, sizeof(*sc->key_caches));
+    if (!sc->key_caches) {
+      OAILOG_ERROR(
+          LOG_NAS_EMM, "Failed to allocate the security context key caches\n");
+    }
+  }
+  return sc->key_caches;
+}
+
+//------------------------------------------------------------------------------
+nas_stream_key_cache_t* emm_security_context_key_cache(
+    emm_security_context_t* const sc) {
+  emm_security_key_caches_t* key_caches = _emm_security_context_key_caches(sc);
+
+  return key_caches ? &key_caches->key_cache : NULL;
+}
+
+//------------------------------------------------------------------------------
+kdf_context_t* emm_security_context_kdf_context(
+    emm_security_context_t* const sc) {
+  emm_security_key_caches_t* key_caches = _emm_security_context_key_caches(sc);
+
+  return key_caches ? &key_caches->kdf_context : NULL;
+}
+
+//------------------------------------------------------------------------------
+/* Free the key caches, the next NAS message or key derivation rebuilds them */
+void emm_security_context_free_key_caches(emm_security_context_t* const sc) {
+  if (sc->key_caches) {
+    nas_stream_key_cache_clear(&sc->key_caches->key_cache);
+    kdf_context_clear(&sc->key_caches->kdf_context);
+    free_wrapper((void**) &sc->key_caches);
+  }
+}
+
 //------------------------------------------------------------------------------
 /* Clear UE network capability IE   */
 inline void emm_ctx_clear_ue_nw_cap(emm_context_t* const ctxt) {
@@ -619,6 +656,8 @@ void free_emm_ctx_memory(
     return;
   }
   nas_delete_all_emm_procedures(ctxt);
+  emm_security_context_free_key_caches(&ctxt->_security);
+  emm_ctx_clear_non_current_security(ctxt);
   free_esm_context_content(&ctxt->esm_ctx);
   bdestroy_wrapper(&ctxt->esm_msg);
 }
@@ -68,6 +68,16 @@ int decode_attach_reject(
             ATTACH_REJECT_ESM_MESSAGE_CONTAINER_PRESENT;
         break;
 
+      case ATTACH_REJECT_T3346_VALUE_IEI:
+        if ((decoded_result = decode_gprs_timer2_ie(
+                 &attach_reject->t3346value, ATTACH_REJECT_T3346_VALUE_IEI,
+                 buffer + decoded, len - decoded)) <= 0)
+          return decoded_result;
+
+        decoded += decoded_result;
+        attach_reject->presencemask |= ATTACH_REJECT_T3346_VALUE_PRESENT;
+        break;
+
       default:
         errorCodeDecoder = TLV_UNEXPECTED_IEI;
         return TLV_UNEXPECTED_IEI;
@@ -108,5 +118,15 @@ int encode_attach_reject(
       encoded += encode_result;
   }
 
+  if ((attach_reject->presencemask & ATTACH_REJECT_T3346_VALUE_PRESENT) ==
+      ATTACH_REJECT_T3346_VALUE_PRESENT) {
+    if ((encode_result = encode_gprs_timer2_ie(
+             &attach_reject->t3346value, ATTACH_REJECT_T3346_VALUE_IEI,
+             buffer + encoded, len - encoded)) < 0)
+      return encode_result;
+    else
+      encoded += encode_result;
+  }
+
   return encoded;
 }
@@ -33,15 +33,18 @@
 
 /* Maximum length macro. Formed by maximum length of each field */
 #define ATTACH_REJECT_MAXIMUM_LENGTH                                           \
-  (EMM_CAUSE_MAXIMUM_LENGTH + ESM_MESSAGE_CONTAINER_MAXIMUM_LENGTH)
+  (EMM_CAUSE_MAXIMUM_LENGTH + ESM_MESSAGE_CONTAINER_MAXIMUM_LENGTH +           \
+   GPRS_TIMER2_IE_MAX_LENGTH)
 
 /* If an optional value is present and should be encoded, the corresponding
  * Bit mask should be set to 1.
  */
 #define ATTACH_REJECT_ESM_MESSAGE_CONTAINER_PRESENT (1 << 0)
+#define ATTACH_REJECT_T3346_VALUE_PRESENT (1 << 1)
 
 typedef enum attach_reject_iei_tag {
   ATTACH_REJECT_ESM_MESSAGE_CONTAINER_IEI = 0x78, /* 0x78 = 120 */
+  ATTACH_REJECT_T3346_VALUE_IEI           = GPRS_C_TIMER_3346_VALUE_IEI,
 } attach_reject_iei;
 
 /*
@@ -61,6 +64,7 @@ typedef struct attach_reject_msg_tag {
   /* Optional fields */
   uint32_t presencemask;
   EsmMessageContainer esmmessagecontainer;
+  gprs_timer_t t3346value;
 } attach_reject_msg;
 
 int decode_attach_reject(
@@ -293,6 +293,8 @@ static int _emm_as_recv(
   nas_message_t nas_msg = {.security_protected.header           = {0},
                            .security_protected.plain.emm.header = {0},
                            .security_protected.plain.esm.header = {0}};
+  // backs the octet string IEs of nas_msg, see nas_message_decode_view()
+  nas_message_decode_arena_t decode_arena;
   emm_security_context_t* emm_security_context =
       NULL; /* Current EPS NAS security context     */
 
@@ -334,8 +336,9 @@ static int _emm_as_recv(
   /*
    * Decode the received message
    */
-  decoder_rc = nas_message_decode(
-      msg->data, &nas_msg, len, emm_security_context, decode_status);
+  decoder_rc = nas_message_decode_view(
+      msg->data, &nas_msg, len, emm_security_context, decode_status,
+      &decode_arena);
 
   if (decoder_rc < 0) {
     OAILOG_ERROR(
@@ -742,6 +745,8 @@ static int _emm_as_establish_req(emm_as_establish_t* msg, int* emm_cause) {
   nas_message_t nas_msg = {.security_protected.header           = {0},
                            .security_protected.plain.emm.header = {0},
                            .security_protected.plain.esm.header = {0}};
+  // backs the octet string IEs of nas_msg, see nas_message_decode_view()
+  nas_message_decode_arena_t decode_arena;
 
   ue_mm_context_t* ue_mm_context =
       mme_ue_context_exists_mme_ue_s1ap_id(msg->ue_id);
@@ -765,9 +770,9 @@ static int _emm_as_establish_req(emm_as_establish_t* msg, int* emm_cause) {
       LOG_NAS_EMM,
       "EMMAS-SAP - Decoding Initial NAS message for ue_id = (%u)\n",
       msg->ue_id);
-  decoder_rc = nas_message_decode(
+  decoder_rc = nas_message_decode_view(
       msg->nas_msg->data, &nas_msg, blength(msg->nas_msg), emm_security_context,
-      &decode_status);
+      &decode_status, &decode_arena);
   bdestroy_wrapper(&msg->nas_msg);
 
   // TODO conditional IE error
@@ -1065,7 +1070,7 @@ static int _emm_as_encode(
   OAILOG_FUNC_IN(LOG_NAS_EMM);
   int bytes = 0;
 
-  /* Ciphering algorithms, EEA1 and EEA2 expects length to be mode of 4,
+  /* Ciphering algorithms, EEA1, EEA2 and EEA3 expect length to be mode of 4,
    * so length is modified such that it will be mode of 4
    */
   EMM_GET_BYTE_ALIGNED_LENGTH(length);
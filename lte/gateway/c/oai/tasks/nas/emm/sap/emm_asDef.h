@@ -202,6 +202,7 @@ typedef struct emm_as_establish_s {
   int* combined_tau_emm_cause;    /* TAU EMM failure cause code   */
   uint32_t* t3402;                /* TAU GPRS T3402 timer   */
   uint32_t* t3423;                /* TAU GPRS T3423 timer   */
+  uint32_t* t3346;                /* Congestion back-off T3346 (seconds) */
   void* equivalent_plmns;         /* TAU Equivalent PLMNs   */
   void* emergency_number_list;    /* TAU Emergency number list   */
   uint8_t* eps_network_feature_support; /* TAU Network feature support   */
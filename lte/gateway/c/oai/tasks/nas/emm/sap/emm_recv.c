@@ -25,6 +25,7 @@
 #include "emm_recv.h"
 #include "common_defs.h"
 #include "log.h"
+#include "dynamic_memory_check.h"
 #include "emm_cause.h"
 #include "emm_proc.h"
 #include "3gpp_requirements_24.301.h"
@@ -49,6 +50,9 @@
 #include "emm_data.h"
 #include "mme_api.h"
 #include "mme_app_ue_context.h"
+#include "mme_app_overload.h"
+#include "TLVDecoder.h"
+#include "procedure_trace.h"
 
 /****************************************************************************/
 /****************  E X T E R N A L    D E F I N I T I O N S  ****************/
@@ -168,6 +172,21 @@ int emm_recv_attach_request(
     OAILOG_FUNC_RETURN(LOG_NAS_EMM, rc);
   }
 
+  /*
+   * Reject new attaches while the MME is overloaded, before any HSS
+   * signalling, the UE backs off for T3346 (3GPP TS 24.301 5.5.1.2.5)
+   */
+  if (is_initial && msg->epsattachtype != EPS_ATTACH_TYPE_EMERGENCY &&
+      mme_app_overload_reject_attach()) {
+    OAILOG_WARNING(
+        LOG_NAS_EMM,
+        "EMMAS-SAP - Sending Attach Reject for ue_id = (%08x), MME "
+        "overloaded\n",
+        ue_id);
+    rc = emm_proc_attach_reject(ue_id, EMM_CAUSE_CONGESTION);
+    OAILOG_FUNC_RETURN(LOG_NAS_EMM, rc);
+  }
+
   emm_attach_request_ies_t* params = calloc(1, sizeof(*params));
   /*
    * Message processing
@@ -319,8 +338,8 @@ int emm_recv_attach_request(
   if (msg->presencemask & ATTACH_REQUEST_ADDITIONAL_UPDATE_TYPE_PRESENT) {
     params->additional_update_type = msg->additionalupdatetype;
   }
-  params->esm_msg          = msg->esmmessagecontainer;
-  msg->esmmessagecontainer = NULL;
+  // kept by the attach procedure beyond the decoded message
+  params->esm_msg = tlv_decode_take_bstring(&msg->esmmessagecontainer);
 
   params->decode_status = *decode_status;
 
@@ -599,10 +618,8 @@ int emm_recv_tracking_area_update_request(
   }
   if (msg->presencemask &
       TRACKING_AREA_UPDATE_REQUEST_SUPPORTED_CODECS_PRESENT) {
-    ies->supported_codecs = calloc(1, sizeof(*ies->supported_codecs));
-    memcpy(
-        ies->supported_codecs, &msg->supportedcodecs,
-        sizeof(*ies->supported_codecs));
+    ies->supported_codecs  = calloc(1, sizeof(*ies->supported_codecs));
+    *ies->supported_codecs = tlv_decode_take_bstring(&msg->supportedcodecs);
   }
   if (msg->presencemask &
       TRACKING_AREA_UPDATE_REQUEST_ADDITIONAL_UPDATE_TYPE_PRESENT) {
@@ -650,6 +667,8 @@ int emm_recv_service_request(
   OAILOG_INFO(
       LOG_NAS_EMM,
       "EMMAS-SAP - Received Service Request message for (ue_id = %u)\n", ue_id);
+  procedure_trace_start(
+      TRACE_KEY_MME_UE_S1AP_ID(ue_id), TRACE_PROCEDURE_SERVICE_REQUEST);
   OAILOG_DEBUG(
       LOG_NAS_EMM,
       "Service Request message for (ue_id = %u)\n"
@@ -1227,5 +1246,6 @@ int emm_recv_uplink_nas_transport(
    * Execute the uplink nas transport procedure completion
    */
   rc = emm_proc_uplink_nas_transport(ue_id, msg->nasmessagecontainer);
+  bdestroy_wrapper(&msg->nasmessagecontainer);
   OAILOG_FUNC_RETURN(LOG_NAS_EMM, rc);
 }
@@ -801,6 +801,15 @@ int emm_send_attach_reject(
     emm_msg->esmmessagecontainer = msg->nas_msg;
   }
 
+  /*
+   * Optional - T3346 value
+   */
+  if (msg->t3346) {
+    size += GPRS_TIMER2_IE_MAX_LENGTH;
+    emm_msg->presencemask |= ATTACH_REJECT_T3346_VALUE_PRESENT;
+    gprs_timer_set_seconds(&emm_msg->t3346value, *msg->t3346);
+  }
+
   OAILOG_FUNC_RETURN(LOG_NAS_EMM, size);
 }
 
@@ -41,6 +41,7 @@
 #include "emm_data.h"
 #include "mme_config.h"
 #include "dynamic_memory_check.h"
+#include "TLVDecoder.h"
 
 /****************************************************************************/
 /****************  E X T E R N A L    D E F I N I T I O N S  ****************/
@@ -342,6 +343,9 @@ static int _esm_sap_recv(
   int rc                             = RETURNerror;
   int decoder_rc;
   ESM_msg esm_msg;
+  // octet string IEs of esm_msg are views into req
+  tlv_decode_arena_t decode_arena;
+  tlv_decode_arena_t* previous_arena = NULL;
 
   memset(&esm_msg, 0, sizeof(ESM_msg));
   /*
@@ -349,7 +353,9 @@ static int _esm_sap_recv(
    */
 
   OAILOG_DEBUG(LOG_NAS_ESM, "ESM-SAP   - Decoding ESM Message \n");
+  previous_arena = tlv_decode_arena_install(&decode_arena);
   decoder_rc = esm_msg_decode(&esm_msg, (uint8_t*) bdata(req), blength(req));
+  tlv_decode_arena_install(previous_arena);
 
   /*
    * Process decoding errors
@@ -55,8 +55,10 @@
 #include "emm_data.h"
 #include "hashtable.h"
 #include "mme_api.h"
+#include "mme_app_auth_vector_cache.h"
 #include "mme_app_state.h"
 #include "nas_procedures.h"
+#include "procedure_trace.h"
 #include "service303.h"
 #include "sgs_messages_types.h"
 
@@ -360,6 +362,8 @@ int nas_proc_authentication_info_answer(
   }
 
   mme_ue_s1ap_id_t mme_ue_s1ap_id = ue_mm_context_p->mme_ue_s1ap_id;
+  procedure_trace_span_end(
+      TRACE_KEY_MME_UE_S1AP_ID(mme_ue_s1ap_id), TRACE_STAGE_S6A_AIR);
   OAILOG_INFO(
       LOG_NAS_EMM,
       "Received Authentication Information Answer from S6A for"
@@ -372,17 +376,25 @@ int nas_proc_authentication_info_answer(
      * elements
      */
     DevCheck(
-        aia->auth_info.nb_of_vectors <= MAX_EPS_AUTH_VECTORS,
-        aia->auth_info.nb_of_vectors, MAX_EPS_AUTH_VECTORS, 0);
+        aia->auth_info.nb_of_vectors <= MAX_EPS_AUTH_VECTORS_PER_AIR,
+        aia->auth_info.nb_of_vectors, MAX_EPS_AUTH_VECTORS_PER_AIR, 0);
     DevCheck(
         aia->auth_info.nb_of_vectors > 0, aia->auth_info.nb_of_vectors, 1, 0);
 
     OAILOG_DEBUG(
         LOG_NAS_EMM, "INFORMING NAS ABOUT AUTH RESP SUCCESS got %u vector(s)\n",
         aia->auth_info.nb_of_vectors);
+    uint8_t nb_vectors = aia->auth_info.nb_of_vectors;
+    // The UE context takes the oldest vectors, the others are kept for the
+    // next attaches of the UE
+    if (nb_vectors > MAX_EPS_AUTH_VECTORS) {
+      mme_app_auth_vector_cache_store(
+          imsi64, nb_vectors - MAX_EPS_AUTH_VECTORS,
+          &aia->auth_info.eutran_vector[MAX_EPS_AUTH_VECTORS]);
+      nb_vectors = MAX_EPS_AUTH_VECTORS;
+    }
     rc = nas_proc_auth_param_res(
-        mme_ue_s1ap_id, aia->auth_info.nb_of_vectors,
-        aia->auth_info.eutran_vector);
+        mme_ue_s1ap_id, nb_vectors, aia->auth_info.eutran_vector);
   } else {
     OAILOG_ERROR(LOG_NAS_EMM, "INFORMING NAS ABOUT AUTH RESP ERROR CODE\n");
     increment_counter(
@@ -41,9 +41,11 @@
 #include "emm_proc.h"
 #include "emm_data.h"
 #include "mme_config.h"
+#include "mme_app_overload.h"
 #include "digest.h"
 #include "nas_procedures.h"
 #include "common_defs.h"
+#include "procedure_trace.h"
 
 static nas_emm_common_proc_t* get_nas_common_procedure(
     const struct emm_context_s* const ctxt, emm_common_proc_type_t proc_type);
@@ -435,6 +437,7 @@ void nas_delete_attach_procedure(struct emm_context_s* emm_context) {
     nas_delete_child_procedures(emm_context, (nas_base_proc_t*) proc);
 
     free_wrapper((void**) &emm_context->emm_procedures->emm_specific_proc);
+    mme_app_overload_procedure_ended();
     nas_emm_procedure_gc(emm_context);
   }
 }
@@ -458,6 +461,7 @@ void nas_delete_tau_procedure(struct emm_context_s* emm_context) {
     nas_delete_child_procedures(emm_context, (nas_base_proc_t*) proc);
 
     free_wrapper((void**) &emm_context->emm_procedures->emm_specific_proc);
+    mme_app_overload_procedure_ended();
     nas_emm_procedure_gc(emm_context);
   }
 }
@@ -602,6 +606,12 @@ nas_emm_attach_proc_t* nas_new_attach_procedure(
   proc->T3450.sec = mme_config.nas_config.t3450_sec;
   proc->T3450.id  = NAS_TIMER_INACTIVE_ID;
 
+  mme_app_overload_procedure_started();
+  procedure_trace_start(
+      TRACE_KEY_MME_UE_S1AP_ID(
+          PARENT_STRUCT(emm_context, struct ue_mm_context_s, emm_context)
+              ->mme_ue_s1ap_id),
+      TRACE_PROCEDURE_ATTACH);
   OAILOG_TRACE(LOG_NAS_EMM, "New EMM_SPEC_PROC_TYPE_ATTACH\n");
   return proc;
 }
@@ -637,6 +647,12 @@ nas_emm_tau_proc_t* nas_new_tau_procedure(
   proc->T3450.sec = mme_config.nas_config.t3450_sec;
   proc->T3450.id  = NAS_TIMER_INACTIVE_ID;
 
+  mme_app_overload_procedure_started();
+  procedure_trace_start(
+      TRACE_KEY_MME_UE_S1AP_ID(
+          PARENT_STRUCT(emm_context, struct ue_mm_context_s, emm_context)
+              ->mme_ue_s1ap_id),
+      TRACE_PROCEDURE_TAU);
   return proc;
 }
 
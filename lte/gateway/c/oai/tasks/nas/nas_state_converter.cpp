@@ -1532,6 +1532,8 @@ void NasStateConverter::proto_to_emm_security_context(
       emm_security_context_proto.next_hop().c_str(), AUTH_NEXT_HOP_SIZE);
   state_emm_security_context->next_hop_chaining_count =
       emm_security_context_proto.next_hop_chaining_count();
+  // Not persisted, rebuilt on first use
+  state_emm_security_context->key_caches = NULL;
 }
 
 void NasStateConverter::nw_detach_data_to_proto(
@@ -1593,9 +1595,11 @@ void NasStateConverter::emm_context_to_proto(
       state_emm_context->_vector, num_auth_vectors, emm_context_proto);
   emm_security_context_to_proto(
       &state_emm_context->_security, emm_context_proto->mutable_security());
-  emm_security_context_to_proto(
-      &state_emm_context->_non_current_security,
-      emm_context_proto->mutable__non_current_security());
+  if (state_emm_context->_non_current_security) {
+    emm_security_context_to_proto(
+        state_emm_context->_non_current_security,
+        emm_context_proto->mutable__non_current_security());
+  }
   emm_context_proto->set_is_dynamic(state_emm_context->is_dynamic);
   emm_context_proto->set_is_attached(state_emm_context->is_attached);
   emm_context_proto->set_is_initial_identity_imsi(
@@ -1681,9 +1685,16 @@ void NasStateConverter::proto_to_emm_context(
   state_emm_context->remaining_vectors = MAX_EPS_AUTH_VECTORS - num_vectors;
   proto_to_emm_security_context(
       emm_context_proto.security(), &state_emm_context->_security);
-  proto_to_emm_security_context(
-      emm_context_proto._non_current_security(),
-      &state_emm_context->_non_current_security);
+  // Older states always carry one, empty unless it has a type
+  if (emm_context_proto.has__non_current_security() &&
+      emm_context_proto._non_current_security().sc_type() !=
+          SECURITY_CTX_TYPE_NOT_AVAILABLE) {
+    state_emm_context->_non_current_security = (emm_security_context_t*) calloc(
+        1, sizeof(emm_security_context_t));
+    proto_to_emm_security_context(
+        emm_context_proto._non_current_security(),
+        state_emm_context->_non_current_security);
+  }
   state_emm_context->is_dynamic  = emm_context_proto.is_dynamic();
   state_emm_context->is_attached = emm_context_proto.is_attached();
   state_emm_context->is_initial_identity_imsi =
@@ -292,12 +292,14 @@ static int handle_message(zloop_t* loop, zsock_t* reader, void* arg) {
 
 //------------------------------------------------------------------------------
 static int s11_send_init_udp(
-    struct in_addr* address, struct in6_addr* address6, uint16_t port_number) {
+    struct in_addr* address, struct in6_addr* address6, uint16_t port_number,
+    uint8_t nb_receive_sockets) {
   MessageDef* message_p = itti_alloc_new_message(TASK_S11, UDP_INIT);
   if (message_p == NULL) {
     return RETURNerror;
   }
-  message_p->ittiMsg.udp_init.port = port_number;
+  message_p->ittiMsg.udp_init.port               = port_number;
+  message_p->ittiMsg.udp_init.nb_receive_sockets = nb_receive_sockets;
   if (address && address->s_addr) {
     message_p->ittiMsg.udp_init.in_addr = address;
     char ipv4[INET_ADDRSTRLEN];
@@ -363,8 +365,9 @@ static void* s11_mme_thread(void* args) {
 
   s11_send_init_udp(
       &mme_config.ip.s11_mme_v4, &mme_config.ip.s11_mme_v6,
-      udp.gtpv2cStandardPort);
-  s11_send_init_udp(&mme_config.ip.s11_mme_v4, &mme_config.ip.s11_mme_v6, 0);
+      udp.gtpv2cStandardPort, mme_config.ip.nb_receive_sockets_s11);
+  s11_send_init_udp(
+      &mme_config.ip.s11_mme_v4, &mme_config.ip.s11_mme_v6, 0, 1);
 
   bstring b = bfromcstr("s11_mme_teid_2_gtv2c_teid_handle");
   s11_mme_teid_2_gtv2c_teid_handle = hashtable_ts_create(
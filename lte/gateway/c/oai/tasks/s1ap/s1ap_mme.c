@@ -47,6 +47,7 @@
 #include "service303.h"
 #include "dynamic_memory_check.h"
 #include "mme_config.h"
+#include "procedure_trace.h"
 #include "timer.h"
 #include "itti_free_defined_msg.h"
 #include "S1ap_TimeToWait.h"
@@ -114,6 +115,7 @@ static int handle_message(zloop_t* loop, zsock_t* reader, void* arg) {
 
   imsi64_t imsi64 = itti_get_associated_imsi(received_message_p);
   state           = get_s1ap_state(false);
+  procedure_trace_task_message(received_message_p->ittiMsgHeader.timestamp);
   AssertFatal(state != NULL, "failed to retrieve s1ap state (was null)");
 
   switch (ITTI_MSG_ID(received_message_p)) {
@@ -216,6 +218,15 @@ static int handle_message(zloop_t* loop, zsock_t* reader, void* arg) {
       }
     } break;
 
+    case S1AP_OVERLOAD_START: {
+      s1ap_handle_overload_start(
+          state, &S1AP_OVERLOAD_START(received_message_p));
+    } break;
+
+    case S1AP_OVERLOAD_STOP: {
+      s1ap_handle_overload_stop(state);
+    } break;
+
     case S1AP_UE_CONTEXT_MODIFICATION_REQUEST: {
       s1ap_handle_ue_context_mod_req(
           state, &received_message_p->ittiMsg.s1ap_ue_context_mod_request,
@@ -110,6 +110,15 @@ int s1ap_generate_s1_setup_response(
 
 bool is_all_erabId_same(S1ap_PathSwitchRequest_t* container);
 
+static int s1ap_send_overload(
+    s1ap_state_t* state, const enb_description_t* enb_association,
+    bool overload_start);
+
+/* Overload Start last requested by MME_APP, also sent to eNBs that connect
+   while it is active */
+static bool s1ap_overload_active;
+static itti_s1ap_overload_t s1ap_overload;
+
 /* Handlers matrix. Only mme related procedures present here.
  */
 s1ap_message_handler_t message_handlers[][3] = {
@@ -583,6 +592,9 @@ int s1ap_mme_handle_s1_setup_request(
     set_gauge("s1_connection", 1, 1, "enb_name", enb_association->enb_name);
     increment_counter("s1_setup", 1, 1, "result", "success");
     s1_setup_success_event(enb_name, enb_id);
+    if (s1ap_overload_active) {
+      s1ap_send_overload(state, enb_association, true);
+    }
   }
   OAILOG_FUNC_RETURN(LOG_S1AP, rc);
 }
@@ -3101,6 +3113,124 @@ int s1ap_handle_paging_request(
   OAILOG_FUNC_RETURN(LOG_S1AP, rc);
 }
 
+//------------------------------------------------------------------------------
+int s1ap_mme_generate_overload(
+    const itti_s1ap_overload_t* overload, uint8_t** buffer, uint32_t* length) {
+  S1ap_S1AP_PDU_t pdu         = {0};
+  S1ap_OverloadStartIEs_t* ie = NULL;
+
+  pdu.present = S1ap_S1AP_PDU_PR_initiatingMessage;
+  pdu.choice.initiatingMessage.criticality = S1ap_Criticality_ignore;
+  if (overload) {
+    S1ap_OverloadStart_t* out = NULL;
+
+    pdu.choice.initiatingMessage.procedureCode =
+        S1ap_ProcedureCode_id_OverloadStart;
+    pdu.choice.initiatingMessage.value.present =
+        S1ap_InitiatingMessage__value_PR_OverloadStart;
+    out = &pdu.choice.initiatingMessage.value.choice.OverloadStart;
+
+    ie = (S1ap_OverloadStartIEs_t*) calloc(1, sizeof(S1ap_OverloadStartIEs_t));
+    ie->id            = S1ap_ProtocolIE_ID_id_OverloadResponse;
+    ie->criticality   = S1ap_Criticality_reject;
+    ie->value.present = S1ap_OverloadStartIEs__value_PR_OverloadResponse;
+    ie->value.choice.OverloadResponse.present =
+        S1ap_OverloadResponse_PR_overloadAction;
+    ie->value.choice.OverloadResponse.choice.overloadAction =
+        overload->overload_action;
+    ASN_SEQUENCE_ADD(&out->protocolIEs.list, ie);
+
+    // Optional, INTEGER (1..99)
+    if (overload->traffic_load_reduction) {
+      ie =
+          (S1ap_OverloadStartIEs_t*) calloc(1, sizeof(S1ap_OverloadStartIEs_t));
+      ie->id          = S1ap_ProtocolIE_ID_id_TrafficLoadReductionIndication;
+      ie->criticality = S1ap_Criticality_ignore;
+      ie->value.present =
+          S1ap_OverloadStartIEs__value_PR_TrafficLoadReductionIndication;
+      ie->value.choice.TrafficLoadReductionIndication =
+          overload->traffic_load_reduction;
+      ASN_SEQUENCE_ADD(&out->protocolIEs.list, ie);
+    }
+  } else {
+    // The only IE, GUMMEI List, is optional: stop applies to all GUMMEIs
+    pdu.choice.initiatingMessage.procedureCode =
+        S1ap_ProcedureCode_id_OverloadStop;
+    pdu.choice.initiatingMessage.value.present =
+        S1ap_InitiatingMessage__value_PR_OverloadStop;
+  }
+
+  if (s1ap_mme_encode_pdu(&pdu, buffer, length) < 0 || *length <= 0) {
+    return RETURNerror;
+  }
+  return RETURNok;
+}
+
+//------------------------------------------------------------------------------
+// Sends Overload Start/Stop to enb_association, or to all eNBs when NULL
+static int s1ap_send_overload(
+    s1ap_state_t* state, const enb_description_t* enb_association,
+    bool overload_start) {
+  hashtable_element_array_t* enb_array = NULL;
+  enb_description_t* enb_ref_p         = NULL;
+  uint8_t* buffer_p                    = NULL;
+  uint32_t length                      = 0;
+  uint32_t idx                         = 0;
+  int rc                               = RETURNok;
+
+  OAILOG_FUNC_IN(LOG_S1AP);
+  if (s1ap_mme_generate_overload(
+          overload_start ? &s1ap_overload : NULL, &buffer_p, &length) !=
+      RETURNok) {
+    OAILOG_ERROR(
+        LOG_S1AP, "Failed to encode overload %s\n",
+        overload_start ? "start" : "stop");
+    OAILOG_FUNC_RETURN(LOG_S1AP, RETURNerror);
+  }
+
+  if (enb_association) {
+    bstring b = blk2bstr(buffer_p, length);
+    // Stream id 0 for non UE related S1AP message
+    rc = s1ap_mme_itti_send_sctp_request(
+        &b, enb_association->sctp_assoc_id, 0, 0);
+  } else if ((enb_array = hashtable_ts_get_elements(&state->enbs))) {
+    for (idx = 0; idx < enb_array->num_elements; idx++) {
+      enb_ref_p = (enb_description_t*) enb_array->elements[idx];
+      if (enb_ref_p->s1_state == S1AP_READY) {
+        bstring b = blk2bstr(buffer_p, length);
+        if (s1ap_mme_itti_send_sctp_request(
+                &b, enb_ref_p->sctp_assoc_id, 0, 0) != RETURNok) {
+          rc = RETURNerror;
+        }
+      }
+    }
+    free_wrapper((void**) &enb_array->elements);
+    free_wrapper((void**) &enb_array);
+  }
+  free(buffer_p);
+  increment_counter(
+      "s1ap_overload", 1, 1, "action", overload_start ? "start" : "stop");
+  OAILOG_FUNC_RETURN(LOG_S1AP, rc);
+}
+
+//------------------------------------------------------------------------------
+int s1ap_handle_overload_start(
+    s1ap_state_t* state, const itti_s1ap_overload_t* overload) {
+  OAILOG_INFO(
+      LOG_S1AP, "Sending overload start, action %u, traffic reduction %u%%\n",
+      overload->overload_action, overload->traffic_load_reduction);
+  s1ap_overload_active = true;
+  s1ap_overload        = *overload;
+  return s1ap_send_overload(state, NULL, true);
+}
+
+//------------------------------------------------------------------------------
+int s1ap_handle_overload_stop(s1ap_state_t* state) {
+  OAILOG_INFO(LOG_S1AP, "Sending overload stop\n");
+  s1ap_overload_active = false;
+  return s1ap_send_overload(state, NULL, false);
+}
+
 //----------------------------------------------------------------
 int s1ap_mme_handle_enb_configuration_transfer(
     s1ap_state_t* state, const sctp_assoc_id_t assoc_id,
@@ -133,6 +133,16 @@ int s1ap_handle_paging_request(
     s1ap_state_t* state, const itti_s1ap_paging_request_t* paging_request,
     imsi64_t imsi64);
 
+int s1ap_handle_overload_start(
+    s1ap_state_t* state, const itti_s1ap_overload_t* overload);
+
+int s1ap_handle_overload_stop(s1ap_state_t* state);
+
+/* Encodes Overload Start with the action and traffic load reduction of
+ * overload, or Overload Stop when it is NULL */
+int s1ap_mme_generate_overload(
+    const itti_s1ap_overload_t* overload, uint8_t** buffer, uint32_t* length);
+
 int s1ap_mme_handle_ue_context_modification_response(
     s1ap_state_t* state, const sctp_assoc_id_t assoc_id,
     const sctp_stream_id_t stream, S1ap_S1AP_PDU_t* message_p);
@@ -30,6 +30,7 @@
 
 #include "bstrlib.h"
 #include "log.h"
+#include "procedure_trace.h"
 #include "assertions.h"
 #include "intertask_interface.h"
 #include "s1ap_mme_itti_messaging.h"
@@ -92,6 +93,7 @@ int s1ap_mme_itti_nas_uplink_ind(
   MME_APP_UL_DATA_IND(message_p).tai     = *tai;
   MME_APP_UL_DATA_IND(message_p).cgi     = *cgi;
 
+  procedure_trace_task_span(TRACE_KEY_MME_UE_S1AP_ID(ue_id), TRACE_STAGE_S1AP);
   message_p->ittiMsgHeader.imsi = imsi64;
   return send_msg_to_task(&s1ap_task_zmq_ctx, TASK_MME_APP, message_p);
 }
@@ -153,7 +155,8 @@ void s1ap_mme_itti_s1ap_initial_ue_message(
     const void const* opt_cell_gw_transport_address,  // unused
     const void const* opt_relay_node_indicator)       // unused
 {
-  MessageDef* message_p = NULL;
+  MessageDef* message_p             = NULL;
+  enb_s1ap_id_key_t enb_s1ap_id_key = INVALID_ENB_UE_S1AP_ID_KEY;
 
   OAILOG_FUNC_IN(LOG_S1AP);
   AssertFatal(
@@ -208,6 +211,13 @@ void s1ap_mme_itti_s1ap_initial_ue_message(
       enb_ue_s1ap_id;
   S1AP_INITIAL_UE_MESSAGE(message_p).transparent.e_utran_cgi = *ecgi;
 
+  // Traced under the eNB ids until MME_APP allocates the mme_ue_s1ap_id
+  MME_APP_ENB_S1AP_ID_KEY(enb_s1ap_id_key, enb_id, enb_ue_s1ap_id);
+  procedure_trace_start(
+      TRACE_KEY_ENB_S1AP_ID(enb_s1ap_id_key), TRACE_PROCEDURE_NONE);
+  procedure_trace_task_span(
+      TRACE_KEY_ENB_S1AP_ID(enb_s1ap_id_key), TRACE_STAGE_S1AP);
+
   send_msg_to_task(&s1ap_task_zmq_ctx, TASK_MME_APP, message_p);
   OAILOG_FUNC_OUT(LOG_S1AP);
 }
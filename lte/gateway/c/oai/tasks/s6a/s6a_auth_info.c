@@ -171,7 +171,8 @@ static inline int s6a_parse_authentication_info_avp(
 
     switch (hdr->avp_code) {
       case AVP_CODE_E_UTRAN_VECTOR: {
-        DevAssert(MAX_EPS_AUTH_VECTORS > authentication_info->nb_of_vectors);
+        DevAssert(
+            MAX_EPS_AUTH_VECTORS_PER_AIR > authentication_info->nb_of_vectors);
         CHECK_FCT(s6a_parse_e_utran_vector(
             avp, &authentication_info
                       ->eutran_vector[authentication_info->nb_of_vectors]));
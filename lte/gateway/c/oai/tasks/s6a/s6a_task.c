@@ -61,6 +61,8 @@ static int handle_message(zloop_t* loop, zsock_t* reader, void* arg) {
   MessageDef* received_message_p = (MessageDef*) zframe_data(msg_frame);
   int rc                         = RETURNerror;
 
+  itti_update_queue_latency(TASK_S6A, received_message_p);
+
   switch (ITTI_MSG_ID(received_message_p)) {
     case MESSAGE_TEST: {
       OAI_FPRINTF_INFO("TASK_S6A received MESSAGE_TEST\n");
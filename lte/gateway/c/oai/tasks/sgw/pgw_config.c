@@ -44,6 +44,7 @@
 
 #include "bstrlib.h"
 #include "assertions.h"
+#include "async_system.h"
 #include "dynamic_memory_check.h"
 #include "log.h"
 #include "common_defs.h"
@@ -66,17 +67,15 @@ void pgw_config_init(pgw_config_t* config_pP) {
 
 //------------------------------------------------------------------------------
 int pgw_config_process(pgw_config_t* config_pP) {
+  bstring batch = NULL;
 #if (!EMBEDDED_SGW)
-  async_system_command(
-      TASK_ASYNC_SYSTEM, PGW_ABORT_ON_ERROR, "iptables -t mangle -F OUTPUT");
-  async_system_command(
-      TASK_ASYNC_SYSTEM, PGW_ABORT_ON_ERROR,
-      "iptables -t mangle -F POSTROUTING");
+  async_system_batch_add(&batch, "iptables -t mangle -F OUTPUT");
+  async_system_batch_add(&batch, "iptables -t mangle -F POSTROUTING");
 
   if (config_pP->masquerade_SGI) {
-    async_system_command(
-        TASK_ASYNC_SYSTEM, PGW_ABORT_ON_ERROR, "iptables -t nat -F PREROUTING");
+    async_system_batch_add(&batch, "iptables -t nat -F PREROUTING");
   }
+  async_system_batch_send(TASK_ASYNC_SYSTEM, PGW_ABORT_ON_ERROR, &batch);
 #endif
 
   // Get ipv4 address
@@ -161,8 +160,8 @@ int pgw_config_process(pgw_config_t* config_pP) {
 
 #if (!EMBEDDED_SGW)
     if (config_pP->masquerade_SGI) {
-      async_system_command(
-          TASK_ASYNC_SYSTEM, PGW_ABORT_ON_ERROR,
+      async_system_batch_add(
+          &batch,
           "iptables -t nat -I POSTROUTING -s %s/%d -o %s  ! --protocol sctp -j "
           "SNAT --to-source %s",
           inet_ntoa(netaddr), netmask, bdata(config_pP->ipv4.if_name_SGI),
@@ -175,14 +174,14 @@ int pgw_config_process(pgw_config_t* config_pP) {
       min_mtu = config_pP->ipv4.mtu_S5_S8 - 36;
     }
     if (config_pP->ue_tcp_mss_clamp) {
-      async_system_command(
-          TASK_ASYNC_SYSTEM, PGW_ABORT_ON_ERROR,
+      async_system_batch_add(
+          &batch,
           "iptables -t mangle -I FORWARD -s %s/%d   -p tcp --tcp-flags SYN,RST "
           "SYN -j TCPMSS --set-mss %u",
           inet_ntoa(netaddr), netmask, min_mtu - 40);
 
-      async_system_command(
-          TASK_ASYNC_SYSTEM, PGW_ABORT_ON_ERROR,
+      async_system_batch_add(
+          &batch,
           "iptables -t mangle -I FORWARD -d %s/%d -p tcp --tcp-flags SYN,RST "
           "SYN "
           "-j TCPMSS --set-mss %u",
@@ -195,6 +194,7 @@ int pgw_config_process(pgw_config_t* config_pP) {
 
   // TODO: Fix me: Add tc support
 
+  async_system_batch_send(TASK_ASYNC_SYSTEM, PGW_ABORT_ON_ERROR, &batch);
   return 0;
 }
 
@@ -218,13 +218,14 @@ int pgw_config_parse_file(pgw_config_t* config_pP) {
   int i                         = 0;
   unsigned char buf_in_addr[sizeof(struct in_addr)];
   struct in_addr addr_start;
-  bstring system_cmd  = NULL;
-  libconfig_int mtu   = 0;
-  int prefix_mask     = 0;
-  char* pcscf_ipv4    = NULL;
-  char* pcscf_ipv6    = NULL;
-  char* dns_ipv6_addr = NULL;
-  char* nat_enabled   = NULL;
+  bstring system_cmd            = NULL;
+  libconfig_int mtu             = 0;
+  libconfig_int lease_pool_size = 0;
+  int prefix_mask               = 0;
+  char* pcscf_ipv4              = NULL;
+  char* pcscf_ipv6              = NULL;
+  char* dns_ipv6_addr           = NULL;
+  char* nat_enabled             = NULL;
 
   config_init(&cfg);
 
@@ -456,6 +457,18 @@ int pgw_config_parse_file(pgw_config_t* config_pP) {
     }
     OAILOG_DEBUG(LOG_SPGW_APP, "UE MTU : %u\n", config_pP->ue_mtu);
 
+    if (config_setting_lookup_int(
+            setting_pgw, PGW_CONFIG_STRING_UE_IP_LEASE_POOL_SIZE,
+            &lease_pool_size)) {
+      AssertFatal(
+          lease_pool_size >= 0, "Bad %s value %d\n",
+          PGW_CONFIG_STRING_UE_IP_LEASE_POOL_SIZE, lease_pool_size);
+      config_pP->ue_ip_lease_pool_size = lease_pool_size;
+    }
+    OAILOG_DEBUG(
+        LOG_SPGW_APP, "UE IP lease pool size : %u\n",
+        config_pP->ue_ip_lease_pool_size);
+
     subsetting = config_setting_get_member(setting_pgw, PGW_CONFIG_STRING_PCEF);
     if (subsetting) {
       if ((config_setting_lookup_string(
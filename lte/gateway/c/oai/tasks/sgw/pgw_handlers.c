@@ -58,6 +58,7 @@
 #include "sgw_context_manager.h"
 #include "sgw_ie_defs.h"
 #include "pgw_procedures.h"
+#include "procedure_trace.h"
 #include "spgw_types.h"
 #include "conversions.h"
 
@@ -160,6 +161,11 @@ void handle_s5_create_session_request(
   apn = (char*) new_bearer_ctxt_info_p->sgw_eps_bearer_context_information
             .pdn_connection.apn_in_use;
 
+  // Ended by PCEF when mobilityd answers
+  procedure_trace_span_start(
+      TRACE_KEY_IMSI(
+          new_bearer_ctxt_info_p->sgw_eps_bearer_context_information.imsi64),
+      TRACE_STAGE_MOBILITYD);
   switch (sgi_create_endpoint_resp.paa.pdn_type) {
     case IPv4:
       // Use NAS by default if no preference is set.
@@ -46,6 +46,10 @@
 #include "pgw_types.h"
 #include "spgw_config.h"
 
+static void _apply_rule(
+    spgw_state_t* state_p, const sdf_id_t sdf_id,
+    const pgw_config_t* const pgw_config_p, bstring* batch);
+
 /*
  * Function that adds predefined PCC rules to PGW struct,
  * it returns an error or success code after adding rules.
@@ -54,6 +58,7 @@ int pgw_pcef_emulation_init(
     spgw_state_t* state_p, const pgw_config_t* const pgw_config_p) {
   int rc             = RETURNok;
   hashtable_rc_t hrc = HASH_TABLE_OK;
+  bstring batch      = NULL;
 
   //--------------------------
   // Predefined PCC rules
@@ -339,29 +344,31 @@ int pgw_pcef_emulation_init(
     }
   }
 
+  // Rules of all the preloaded PCC rules in one batch
   for (int i = 0; i < (SDF_ID_MAX - 1); i++) {
     if (pgw_config_p->pcef.preload_static_sdf_identifiers[i]) {
-      pgw_pcef_emulation_apply_rule(
+      _apply_rule(
           state_p, pgw_config_p->pcef.preload_static_sdf_identifiers[i],
-          pgw_config_p);
+          pgw_config_p, &batch);
     } else
       break;
   }
 
   if (pgw_config_p->pcef.automatic_push_dedicated_bearer_sdf_identifier) {
-    pgw_pcef_emulation_apply_rule(
+    _apply_rule(
         state_p,
         pgw_config_p->pcef.automatic_push_dedicated_bearer_sdf_identifier,
-        pgw_config_p);
+        pgw_config_p, &batch);
   }
+  async_system_batch_send(TASK_ASYNC_SYSTEM, false, &batch);
   return rc;
 }
 
 //------------------------------------------------------------------------------
 // may change sdf_id to PCC_rule name ?
-void pgw_pcef_emulation_apply_rule(
+static void _apply_rule(
     spgw_state_t* state_p, const sdf_id_t sdf_id,
-    const pgw_config_t* const pgw_config_p) {
+    const pgw_config_t* const pgw_config_p, bstring* batch) {
   pcc_rule_t* pcc_rule = NULL;
   hashtable_rc_t hrc   = hashtable_ts_get(
       state_p->deactivated_predefined_pcc_rules, sdf_id, (void**) &pcc_rule);
@@ -374,16 +381,26 @@ void pgw_pcef_emulation_apply_rule(
            sdff_i < pcc_rule->sdf_template.number_of_packet_filters; sdff_i++) {
         pgw_pcef_emulation_apply_sdf_filter(
             &pcc_rule->sdf_template.sdf_filter[sdff_i], pcc_rule->sdf_id,
-            pgw_config_p);
+            pgw_config_p, batch);
       }
     }
   }
 }
 
+//------------------------------------------------------------------------------
+void pgw_pcef_emulation_apply_rule(
+    spgw_state_t* state_p, const sdf_id_t sdf_id,
+    const pgw_config_t* const pgw_config_p) {
+  bstring batch = NULL;
+
+  _apply_rule(state_p, sdf_id, pgw_config_p, &batch);
+  async_system_batch_send(TASK_ASYNC_SYSTEM, false, &batch);
+}
+
 //------------------------------------------------------------------------------
 void pgw_pcef_emulation_apply_sdf_filter(
     sdf_filter_t* const sdf_f, const sdf_id_t sdf_id,
-    const pgw_config_t* const pgw_config_p) {
+    const pgw_config_t* const pgw_config_p, bstring* batch) {
   if ((TRAFFIC_FLOW_TEMPLATE_BIDIRECTIONAL == sdf_f->direction) ||
       (TRAFFIC_FLOW_TEMPLATE_DOWNLINK_ONLY == sdf_f->direction)) {
     bstring filter = pgw_pcef_emulation_packet_filter_2_iptable_string(
@@ -407,7 +424,7 @@ void pgw_pcef_emulation_apply_sdf_filter(
           pgw_config_p->ue_pool_mask[0], bdata(filter), sdf_id);
     }
     bdestroy_wrapper(&filter);
-    async_system_command(TASK_ASYNC_SYSTEM, false, bdata(marking_command));
+    async_system_batch_add(batch, "%s", bdata(marking_command));
     bdestroy_wrapper(&marking_command);
 
     // for UE <-> PGW traffic
@@ -429,7 +446,7 @@ void pgw_pcef_emulation_apply_sdf_filter(
           pgw_config_p->ue_pool_mask[0], bdata(filter), sdf_id);
     }
     bdestroy_wrapper(&filter);
-    async_system_command(TASK_ASYNC_SYSTEM, false, bdata(marking_command));
+    async_system_batch_add(batch, "%s", bdata(marking_command));
     bdestroy_wrapper(&marking_command);
   }
 }
@@ -38,8 +38,10 @@ int pgw_pcef_emulation_init(
     spgw_state_t* state_p, const pgw_config_t* pgw_config_p);
 void pgw_pcef_emulation_apply_rule(
     spgw_state_t* state_p, sdf_id_t sdf_id, const pgw_config_t* pgw_config_p);
+// Appends the iptables commands of the filter to *batch, see async_system.h
 void pgw_pcef_emulation_apply_sdf_filter(
-    sdf_filter_t* sdf_f, sdf_id_t sdf_id, const pgw_config_t* pgw_config_p);
+    sdf_filter_t* sdf_f, sdf_id_t sdf_id, const pgw_config_t* pgw_config_p,
+    bstring* batch);
 bstring pgw_pcef_emulation_packet_filter_2_iptable_string(
     packet_filter_contents_t* packetfiltercontents, uint8_t direction);
 int pgw_pcef_get_sdf_parameters(
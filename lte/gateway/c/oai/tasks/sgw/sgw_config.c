@@ -54,6 +54,8 @@
 void sgw_config_init(sgw_config_t* config_pP) {
   memset(config_pP, 0, sizeof(*config_pP));
   pthread_rwlock_init(&config_pP->rw_lock, NULL);
+  config_pP->ovs_config.paging_suppression_window =
+      OVS_PAGING_SUPPRESSION_WINDOW_DEFAULT;
 }
 //------------------------------------------------------------------------------
 int sgw_config_process(sgw_config_t* config_pP) {
@@ -352,6 +354,39 @@ int sgw_config_parse_file(sgw_config_t* config_pP)
     } else {
       AssertFatal(false, "Couldn't find all ovs settings in spgw config\n");
     }
+    libconfig_int paging_suppression_window = 0;
+    libconfig_int paging_rate               = 0;
+    libconfig_int paging_burst              = 0;
+    if (config_setting_lookup_int(
+            ovs_settings, SGW_CONFIG_STRING_OVS_PAGING_SUPPRESSION_WINDOW,
+            &paging_suppression_window)) {
+      AssertFatal(
+          paging_suppression_window > 0,
+          "Bad OVS %s value %d, must be at least 1 second\n",
+          SGW_CONFIG_STRING_OVS_PAGING_SUPPRESSION_WINDOW,
+          paging_suppression_window);
+      config_pP->ovs_config.paging_suppression_window =
+          paging_suppression_window;
+    }
+    if (config_setting_lookup_int(
+            ovs_settings, SGW_CONFIG_STRING_OVS_PAGING_RATE, &paging_rate)) {
+      AssertFatal(
+          paging_rate >= 0, "Bad OVS %s value %d\n",
+          SGW_CONFIG_STRING_OVS_PAGING_RATE, paging_rate);
+      config_pP->ovs_config.paging_rate = paging_rate;
+    }
+    if (config_setting_lookup_int(
+            ovs_settings, SGW_CONFIG_STRING_OVS_PAGING_BURST, &paging_burst)) {
+      AssertFatal(
+          paging_burst >= 0, "Bad OVS %s value %d\n",
+          SGW_CONFIG_STRING_OVS_PAGING_BURST, paging_burst);
+      config_pP->ovs_config.paging_burst = paging_burst;
+    }
+    OAILOG_INFO(
+        LOG_SPGW_APP,
+        "Paging suppression window: %u s, paging rate: %u/s, burst: %u\n",
+        config_pP->ovs_config.paging_suppression_window,
+        config_pP->ovs_config.paging_rate, config_pP->ovs_config.paging_burst);
 #endif
   }
   config_destroy(&cfg);
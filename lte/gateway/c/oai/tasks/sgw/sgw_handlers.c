@@ -50,6 +50,7 @@
 #include "pgw_ue_ip_address_alloc.h"
 #include "pgw_pcef_emulation.h"
 #include "pgw_procedures.h"
+#include "procedure_trace.h"
 #include "service303.h"
 #include "pcef_handlers.h"
 #include "3gpp_23.003.h"
@@ -66,6 +67,7 @@
 #include "conversions.h"
 #include "mme_config.h"
 #include "spgw_state.h"
+#include "spgw_ue_ip_index.h"
 
 extern spgw_config_t spgw_config;
 extern struct gtp_tunnel_ops* gtp_tunnel_ops;
@@ -362,6 +364,7 @@ int sgw_handle_sgi_endpoint_created(
           sizeof(eps_bearer_ctxt_p->paa) == sizeof(resp_pP->paa),
           "Mismatch in lengths");  // sceptic mode
       memcpy(&eps_bearer_ctxt_p->paa, &resp_pP->paa, sizeof(paa_t));
+      spgw_add_ue_ip_imsi(&resp_pP->paa, imsi64);
       memcpy(&create_session_response_p->paa, &resp_pP->paa, sizeof(paa_t));
       copy_protocol_configuration_options(
           &create_session_response_p->pco, &resp_pP->pco);
@@ -558,10 +561,13 @@ static void sgw_add_gtp_tunnel(
             eps_bearer_ctxt_p->enb_teid_S1u);
       }
 
+      procedure_trace_span_start(
+          TRACE_KEY_IMSI(imsi64), TRACE_STAGE_GTP_TUNNEL);
       rv = gtpv1u_add_tunnel(
           ue_ipv4, ue_ipv6, vlan, enb,
           eps_bearer_ctxt_p->s_gw_teid_S1u_S12_S4_up,
           eps_bearer_ctxt_p->enb_teid_S1u, imsi, NULL, DEFAULT_PRECEDENCE);
+      procedure_trace_span_end(TRACE_KEY_IMSI(imsi64), TRACE_STAGE_GTP_TUNNEL);
       if (rv < 0) {
         OAILOG_ERROR_UE(
             LOG_SPGW_APP, imsi64, "ERROR in setting up TUNNEL err=%d\n", rv);
@@ -785,6 +791,7 @@ int sgw_handle_sgi_endpoint_deleted(
                  .imsi.digit;
       apn = (char*) new_bearer_ctxt_info_p->sgw_eps_bearer_context_information
                 .pdn_connection.apn_in_use;
+      spgw_remove_ue_ip_imsi(&resp_pP->paa, imsi64);
       switch (resp_pP->paa.pdn_type) {
         case IPv4:
           inaddr = resp_pP->paa.ipv4_address;
@@ -1859,6 +1866,25 @@ int sgw_handle_nw_initiated_deactv_bearer_rsp(
       s11_pcrf_ded_bearer_deactv_rsp->cause, ebi);
   OAILOG_FUNC_RETURN(LOG_SPGW_APP, rc);
 }
+
+//------------------------------------------------------------------------------
+// Result of the OVS flows of a GTP tunnel, reported by the openflow
+// controller once the switch answered for their batch
+void sgw_handle_tunnel_flows_resp(
+    bool add, uint8_t status, teid_t s1u_teid, imsi64_t imsi64) {
+  OAILOG_FUNC_IN(LOG_SPGW_APP);
+  increment_counter(
+      "spgw_tunnel_flows", 1, 2, "action", add ? "add" : "delete", "result",
+      status ? "failure" : "success");
+  if (status) {
+    OAILOG_ERROR_UE(
+        LOG_SPGW_APP, imsi64,
+        "Failed to %s flow rules of tunnel " TEID_FMT " in the switch\n",
+        add ? "install" : "remove", s1u_teid);
+  }
+  OAILOG_FUNC_OUT(LOG_SPGW_APP);
+}
+
 bool is_enb_ip_address_same(const fteid_t* fte_p, ip_address_t* ip_p) {
   bool rc = true;
 
@@ -2120,3 +2146,94 @@ static bool does_bearer_context_hold_valid_enb_ip(
   }
   OAILOG_FUNC_RETURN(LOG_SPGW_APP, false);
 }
+
+//------------------------------------------------------------------------------
+/* Collects the tunnel of a restored bearer for the datapath reconciliation,
+ * with the flows sgw_add_gtp_tunnel and _add_tunnel_helper install
+ */
+static void _reconcile_bearer_tunnel(
+    s_plus_p_gw_eps_bearer_context_information_t* spgw_context,
+    sgw_eps_bearer_ctxt_t* eps_bearer_ctxt_p) {
+  struct in_addr enb = {.s_addr = 0};
+  enb.s_addr =
+      eps_bearer_ctxt_p->enb_ip_address_S1u.address.ipv4_address.s_addr;
+  struct in_addr ue_ipv4   = {.s_addr = 0};
+  ue_ipv4.s_addr           = eps_bearer_ctxt_p->paa.ipv4_address.s_addr;
+  struct in6_addr* ue_ipv6 = NULL;
+  if ((eps_bearer_ctxt_p->paa.pdn_type == IPv6) ||
+      (eps_bearer_ctxt_p->paa.pdn_type == IPv4_AND_v6)) {
+    ue_ipv6 = &eps_bearer_ctxt_p->paa.ipv6_address;
+  }
+  int vlan    = eps_bearer_ctxt_p->paa.vlan;
+  Imsi_t imsi = spgw_context->sgw_eps_bearer_context_information.imsi;
+
+  if (eps_bearer_ctxt_p->eps_bearer_id ==
+      spgw_context->sgw_eps_bearer_context_information.pdn_connection
+          .default_bearer) {
+    gtp_tunnel_ops->reconcile_add_tunnel(
+        ue_ipv4, ue_ipv6, vlan, enb, eps_bearer_ctxt_p->s_gw_teid_S1u_S12_S4_up,
+        eps_bearer_ctxt_p->enb_teid_S1u, imsi, NULL, DEFAULT_PRECEDENCE);
+    return;
+  }
+  for (int i = 0; i < eps_bearer_ctxt_p->tft.numberofpacketfilters; ++i) {
+    struct ip_flow_dl dlflow = {0};
+    _generate_dl_flow(
+        &(eps_bearer_ctxt_p->tft.packetfilterlist.createnewtft[i]
+              .packetfiltercontents),
+        ue_ipv4.s_addr, ue_ipv6, &dlflow);
+    gtp_tunnel_ops->reconcile_add_tunnel(
+        ue_ipv4, ue_ipv6, vlan, enb, eps_bearer_ctxt_p->s_gw_teid_S1u_S12_S4_up,
+        eps_bearer_ctxt_p->enb_teid_S1u, imsi, &dlflow,
+        eps_bearer_ctxt_p->tft.packetfilterlist.createnewtft[i]
+            .eval_precedence);
+  }
+}
+
+//------------------------------------------------------------------------------
+static bool _reconcile_ue_tunnels(
+    __attribute__((unused)) const hash_key_t keyP, void* const elementP,
+    void* parameterP, __attribute__((unused)) void** resultP) {
+  spgw_ue_context_t* ue_context_p = (spgw_ue_context_t*) elementP;
+  uint32_t* nb_tunnels            = (uint32_t*) parameterP;
+  sgw_s11_teid_t* s11_teid_p      = NULL;
+
+  LIST_FOREACH(s11_teid_p, &ue_context_p->sgw_s11_teid_list, entries) {
+    s_plus_p_gw_eps_bearer_context_information_t* spgw_context =
+        sgw_cm_get_spgw_context(s11_teid_p->sgw_s11_teid);
+    if (!spgw_context) {
+      continue;
+    }
+    for (int ebx = 0; ebx < BEARERS_PER_UE; ebx++) {
+      sgw_eps_bearer_ctxt_t* eps_bearer_ctxt =
+          spgw_context->sgw_eps_bearer_context_information.pdn_connection
+              .sgw_eps_bearers_array[ebx];
+      // Bearers of idle UEs have no eNB side and no tunnel
+      if (eps_bearer_ctxt && eps_bearer_ctxt->enb_teid_S1u != INVALID_TEID &&
+          does_bearer_context_hold_valid_enb_ip(
+              eps_bearer_ctxt->enb_ip_address_S1u)) {
+        _reconcile_bearer_tunnel(spgw_context, eps_bearer_ctxt);
+        (*nb_tunnels)++;
+      }
+    }
+  }
+  return false;
+}
+
+//------------------------------------------------------------------------------
+void sgw_reconcile_gtp_tunnels(spgw_state_t* spgw_state) {
+  OAILOG_FUNC_IN(LOG_SPGW_APP);
+  uint32_t nb_tunnels = 0;
+
+  if (!gtp_tunnel_ops->reconcile_add_tunnel ||
+      !gtp_tunnel_ops->reconcile_tunnels) {
+    OAILOG_FUNC_OUT(LOG_SPGW_APP);
+  }
+  hashtable_ts_apply_callback_on_elements(
+      spgw_state->imsi_ue_context_htbl, _reconcile_ue_tunnels, &nb_tunnels,
+      NULL);
+  OAILOG_INFO(
+      LOG_SPGW_APP, "Reconciling the datapath with %u restored GTP tunnels\n",
+      nb_tunnels);
+  gtp_tunnel_ops->reconcile_tunnels();
+  OAILOG_FUNC_OUT(LOG_SPGW_APP);
+}
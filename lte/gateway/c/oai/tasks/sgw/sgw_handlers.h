@@ -65,6 +65,14 @@ int sgw_handle_nw_initiated_deactv_bearer_rsp(
     const itti_s11_nw_init_deactv_bearer_rsp_t* const
         s11_pcrf_ded_bearer_deactv_rsp,
     imsi64_t imsi64);
+void sgw_handle_tunnel_flows_resp(
+    bool add, uint8_t status, teid_t s1u_teid, imsi64_t imsi64);
 bool is_enb_ip_address_same(const fteid_t* fte_p, ip_address_t* ip_p);
 uint32_t sgw_get_new_s1u_teid(spgw_state_t* state);
+/*
+ * Brings the datapath in line with the bearers restored from the persisted
+ * state: installs their missing tunnels and removes the tunnels of bearers
+ * that are gone
+ */
+void sgw_reconcile_gtp_tunnels(spgw_state_t* spgw_state);
 #endif /* FILE_SGW_HANDLERS_SEEN */
@@ -22,25 +22,37 @@
 #include <sys/socket.h>
 #include <conversions.h>
 
+#include "common_defs.h"
 #include "intertask_interface.h"
 #include "log.h"
-#include "MobilityClientAPI.h"
 #include "sgw_defs.h"
 #include "sgw_paging.h"
 #include "intertask_interface_types.h"
 #include "itti_types.h"
 #include "s11_messages_types.h"
+#include "service303.h"
+#include "spgw_ue_ip_index.h"
 
 int sgw_send_paging_request(const struct in_addr* dest_ip) {
-  char* imsi;
-  int ret = get_subscriber_id_from_ipv4(dest_ip, &imsi);
-  if (ret > 0) {
+  char imsi[IMSI_BCD_DIGITS_MAX + 1] = {0};
+  imsi64_t imsi64                    = INVALID_IMSI64;
+  bool from_mobilityd                = false;
+  int ret                            = RETURNok;
+
+  // Runs on the OpenFlow controller thread, a blocking call to mobilityd
+  // there delays every other packet-in: only make it on an index miss
+  ret = spgw_resolve_imsi_from_ue_ipv4(dest_ip, &imsi64, &from_mobilityd);
+  increment_counter(
+      "spgw_paging_imsi_lookup", 1, 1, "source",
+      from_mobilityd ? "mobilityd" : "local");
+  if (ret != RETURNok) {
     char ip_str[INET_ADDRSTRLEN];
     inet_ntop(AF_INET, &(dest_ip->s_addr), ip_str, INET_ADDRSTRLEN);
     OAILOG_ERROR(
         TASK_SPGW_APP, "Subscriber could not be found for ip %s\n", ip_str);
     return ret;
   }
+  IMSI64_TO_STRING(imsi64, imsi, IMSI_BCD_DIGITS_MAX);
   OAILOG_DEBUG(TASK_SPGW_APP, "Paging procedure initiated for IMSI%s\n", imsi);
   MessageDef* message_p                       = NULL;
   itti_s11_paging_request_t* paging_request_p = NULL;
@@ -49,9 +61,8 @@ int sgw_send_paging_request(const struct in_addr* dest_ip) {
   paging_request_p = &message_p->ittiMsg.s11_paging_request;
   memset((void*) paging_request_p, 0, sizeof(itti_s11_paging_request_t));
   paging_request_p->imsi = strdup(imsi);
-  free(imsi);
 
-  IMSI_STRING_TO_IMSI64(imsi, &message_p->ittiMsgHeader.imsi);
+  message_p->ittiMsgHeader.imsi = imsi64;
   ret = send_msg_to_task(&spgw_app_task_zmq_ctx, TASK_MME_APP, message_p);
   return ret;
 }
@@ -46,6 +46,7 @@
 #include "pgw_ue_ip_address_alloc.h"
 #include "pgw_pcef_emulation.h"
 #include "spgw_config.h"
+#include "MobilityClientAPI.h"
 
 static void spgw_app_exit(void);
 
@@ -165,6 +166,21 @@ static int handle_message(zloop_t* loop, zsock_t* reader, void* arg) {
          */
       }
     } break;
+
+    case GTPV1U_CREATE_TUNNEL_RESP: {
+      sgw_handle_tunnel_flows_resp(
+          true, received_message_p->ittiMsg.gtpv1uCreateTunnelResp.status,
+          received_message_p->ittiMsg.gtpv1uCreateTunnelResp.S1u_teid,
+          imsi64);
+    } break;
+
+    case GTPV1U_DELETE_TUNNEL_RESP: {
+      sgw_handle_tunnel_flows_resp(
+          false, received_message_p->ittiMsg.gtpv1uDeleteTunnelResp.status,
+          received_message_p->ittiMsg.gtpv1uDeleteTunnelResp.S1u_teid,
+          imsi64);
+    } break;
+
     case TERMINATE_MESSAGE: {
       itti_free_msg_content(received_message_p);
       zframe_destroy(&msg_frame);
@@ -211,11 +227,15 @@ int spgw_app_init(spgw_config_t* spgw_config_pP, bool persist_state) {
 
   // Read SPGW state for subscribers from db
   read_spgw_ue_state_db();
+  ue_ip_lease_pool_init(spgw_config_pP->pgw_config.ue_ip_lease_pool_size);
 
   if (gtpv1u_init(spgw_state_p, spgw_config_pP, persist_state) < 0) {
     OAILOG_ALERT(LOG_SPGW_APP, "Initializing GTPv1-U ERROR\n");
     return RETURNerror;
   }
+  if (persist_state) {
+    sgw_reconcile_gtp_tunnels(spgw_state_p);
+  }
 
   if (RETURNerror ==
       pgw_pcef_emulation_init(spgw_state_p, &spgw_config_pP->pgw_config)) {
@@ -25,7 +25,9 @@ extern "C" {
 #include "bstrlib.h"
 #include "dynamic_memory_check.h"
 #include "pgw_procedures.h"
+#include "procedure_trace.h"
 #include "sgw_context_manager.h"
+#include "spgw_ue_ip_index.h"
 }
 
 #include "spgw_state_manager.h"
@@ -33,6 +35,10 @@ extern "C" {
 using magma::lte::SpgwStateManager;
 
 int spgw_state_init(bool persist_state, const spgw_config_t* config) {
+  // Filled in as the UE state is read from the data store
+  if (spgw_ue_ip_index_init() != RETURNok) {
+    return RETURNerror;
+  }
   SpgwStateManager::getInstance().init(persist_state, config);
   return RETURNok;
 }
@@ -51,6 +57,7 @@ int read_spgw_ue_state_db() {
 
 void spgw_state_exit() {
   SpgwStateManager::getInstance().free_state();
+  spgw_ue_ip_index_exit();
 }
 
 void put_spgw_state() {
@@ -65,8 +72,11 @@ void put_spgw_ue_state(spgw_state_t* spgw_state, imsi64_t imsi64) {
         (void**) &ue_context_p);
     if (ue_context_p) {
       auto imsi_str = SpgwStateManager::getInstance().get_imsi_str(imsi64);
+      procedure_trace_span_start(
+          TRACE_KEY_IMSI(imsi64), TRACE_STAGE_STATE_WRITE);
       SpgwStateManager::getInstance().write_ue_state_to_db(
           ue_context_p, imsi_str);
+      procedure_trace_span_end(TRACE_KEY_IMSI(imsi64), TRACE_STAGE_STATE_WRITE);
     }
   }
 }
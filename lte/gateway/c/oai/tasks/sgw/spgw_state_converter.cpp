@@ -21,6 +21,7 @@ extern "C" {
 }
 
 #include "spgw_state_converter.h"
+#include "spgw_ue_ip_index.h"
 
 using magma::lte::oai::CreateSessionMessage;
 using magma::lte::oai::GTPV1uData;
@@ -949,6 +950,16 @@ void SpgwStateConverter::proto_to_ue(
     spgw_update_teid_in_ue_context(
         spgw_state, spgw_context_p->sgw_eps_bearer_context_information.imsi64,
         spgw_context_p->sgw_eps_bearer_context_information.s_gw_teid_S11_S4);
+
+    sgw_pdn_connection_t* pdn_connection_p =
+        &spgw_context_p->sgw_eps_bearer_context_information.pdn_connection;
+    sgw_eps_bearer_ctxt_t* default_bearer_p = sgw_cm_get_eps_bearer_entry(
+        pdn_connection_p, pdn_connection_p->default_bearer);
+    if (default_bearer_p) {
+      spgw_add_ue_ip_imsi(
+          &default_bearer_p->paa,
+          spgw_context_p->sgw_eps_bearer_context_information.imsi64);
+    }
   }
   OAILOG_FUNC_OUT(LOG_SPGW_APP);
 }
@@ -0,0 +1,140 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bstrlib.h"
+#include "common_defs.h"
+#include "conversions.h"
+#include "dynamic_memory_check.h"
+#include "hashtable.h"
+#include "MobilityClientAPI.h"
+#include "spgw_ue_ip_index.h"
+
+#define UE_IP_INDEX_HT_SIZE 512
+#define UE_IPV4_IMSI_HT_NAME "ue_ipv4_imsi_htbl"
+#define UE_IPV6_IMSI_HT_NAME "ue_ipv6_imsi_htbl"
+
+// IPv4 keys are the address, IPv6 keys the /64 prefix allocated to the UE
+static hash_table_uint64_ts_t* ue_ipv4_imsi_htbl = NULL;
+static hash_table_uint64_ts_t* ue_ipv6_imsi_htbl = NULL;
+
+int spgw_ue_ip_index_init(void) {
+  bstring ipv4_b    = bfromcstr(UE_IPV4_IMSI_HT_NAME);
+  ue_ipv4_imsi_htbl = hashtable_uint64_ts_create(
+      UE_IP_INDEX_HT_SIZE, hashtable_uint64_mix_hashfunc, ipv4_b);
+  bdestroy_wrapper(&ipv4_b);
+  bstring ipv6_b    = bfromcstr(UE_IPV6_IMSI_HT_NAME);
+  ue_ipv6_imsi_htbl = hashtable_uint64_ts_create(
+      UE_IP_INDEX_HT_SIZE, hashtable_uint64_mix_hashfunc, ipv6_b);
+  bdestroy_wrapper(&ipv6_b);
+  if (!ue_ipv4_imsi_htbl || !ue_ipv6_imsi_htbl) {
+    spgw_ue_ip_index_exit();
+    return RETURNerror;
+  }
+  return RETURNok;
+}
+
+void spgw_ue_ip_index_exit(void) {
+  if (ue_ipv4_imsi_htbl) {
+    hashtable_uint64_ts_destroy(ue_ipv4_imsi_htbl);
+    ue_ipv4_imsi_htbl = NULL;
+  }
+  if (ue_ipv6_imsi_htbl) {
+    hashtable_uint64_ts_destroy(ue_ipv6_imsi_htbl);
+    ue_ipv6_imsi_htbl = NULL;
+  }
+}
+
+// The IPv6 prefix allocated to a UE is a /64, TS 23.401 section 5.3.1.2.2
+static hash_key_t ue_ipv6_prefix_key(const struct in6_addr* ue_ipv6) {
+  uint64_t prefix = 0;
+  memcpy(&prefix, ue_ipv6->s6_addr, sizeof(prefix));
+  return prefix;
+}
+
+void spgw_add_ue_ip_imsi(const paa_t* paa, imsi64_t imsi64) {
+  if ((paa->pdn_type == IPv4) || (paa->pdn_type == IPv4_AND_v6)) {
+    hashtable_uint64_ts_insert(
+        ue_ipv4_imsi_htbl, paa->ipv4_address.s_addr, imsi64);
+  }
+  if ((paa->pdn_type == IPv6) || (paa->pdn_type == IPv4_AND_v6)) {
+    hashtable_uint64_ts_insert(
+        ue_ipv6_imsi_htbl, ue_ipv6_prefix_key(&paa->ipv6_address), imsi64);
+  }
+}
+
+static void remove_ue_ip_imsi(
+    hash_table_uint64_ts_t* htbl, hash_key_t key, imsi64_t imsi64) {
+  uint64_t indexed_imsi64 = 0;
+  if ((hashtable_uint64_ts_get(htbl, key, &indexed_imsi64) ==
+       HASH_TABLE_OK) &&
+      (indexed_imsi64 == imsi64)) {
+    hashtable_uint64_ts_remove(htbl, key);
+  }
+}
+
+void spgw_remove_ue_ip_imsi(const paa_t* paa, imsi64_t imsi64) {
+  if ((paa->pdn_type == IPv4) || (paa->pdn_type == IPv4_AND_v6)) {
+    remove_ue_ip_imsi(ue_ipv4_imsi_htbl, paa->ipv4_address.s_addr, imsi64);
+  }
+  if ((paa->pdn_type == IPv6) || (paa->pdn_type == IPv4_AND_v6)) {
+    remove_ue_ip_imsi(
+        ue_ipv6_imsi_htbl, ue_ipv6_prefix_key(&paa->ipv6_address), imsi64);
+  }
+}
+
+int spgw_get_imsi_from_ue_ipv4(
+    const struct in_addr* ue_ipv4, imsi64_t* imsi64) {
+  if (hashtable_uint64_ts_get(ue_ipv4_imsi_htbl, ue_ipv4->s_addr, imsi64) !=
+      HASH_TABLE_OK) {
+    return RETURNerror;
+  }
+  return RETURNok;
+}
+
+int spgw_get_imsi_from_ue_ipv6(
+    const struct in6_addr* ue_ipv6, imsi64_t* imsi64) {
+  if (hashtable_uint64_ts_get(
+          ue_ipv6_imsi_htbl, ue_ipv6_prefix_key(ue_ipv6), imsi64) !=
+      HASH_TABLE_OK) {
+    return RETURNerror;
+  }
+  return RETURNok;
+}
+
+int spgw_resolve_imsi_from_ue_ipv4(
+    const struct in_addr* ue_ipv4, imsi64_t* imsi64, bool* from_mobilityd) {
+  char* mobilityd_imsi = NULL;
+  int rc               = RETURNok;
+
+  *from_mobilityd = false;
+  if (spgw_get_imsi_from_ue_ipv4(ue_ipv4, imsi64) == RETURNok) {
+    return RETURNok;
+  }
+  *from_mobilityd = true;
+  rc              = get_subscriber_id_from_ipv4(ue_ipv4, &mobilityd_imsi);
+  if (rc == RETURNok && !mobilityd_imsi) {
+    rc = RETURNerror;
+  }
+  if (rc == RETURNok && IMSI_STRING_TO_IMSI64(mobilityd_imsi, imsi64) != 1) {
+    rc = RETURNerror;
+  }
+  free(mobilityd_imsi);
+  return rc;
+}
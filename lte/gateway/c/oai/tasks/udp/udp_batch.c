@@ -0,0 +1,136 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file udp_batch.c
+  \brief Batched datagram receive and send for the UDP task
+*/
+
+#define _GNU_SOURCE
+#include <errno.h>
+#include <poll.h>
+#include <stdbool.h>
+#include <string.h>
+#include <sys/socket.h>
+
+#include "udp_batch.h"
+
+//------------------------------------------------------------------------------
+void udp_recv_batch_set_slot(
+    udp_recv_batch_t* batch, int slot, void* buffer, size_t length,
+    udp_address_t* address) {
+  struct msghdr* hdr = &batch->hdrs[slot].msg_hdr;
+
+  batch->iovs[slot].iov_base = buffer;
+  batch->iovs[slot].iov_len  = length;
+  memset(hdr, 0, sizeof(*hdr));
+  hdr->msg_iov     = &batch->iovs[slot];
+  hdr->msg_iovlen  = 1;
+  hdr->msg_name    = address;
+  hdr->msg_namelen = sizeof(*address);
+}
+
+//------------------------------------------------------------------------------
+int udp_recv_batch(int sd, udp_recv_batch_t* batch, int flags) {
+  int nb_datagrams = 0;
+
+  // The kernel overwrites the name lengths with the ones received
+  for (int i = 0; i < UDP_BATCH_SIZE; i++) {
+    batch->hdrs[i].msg_hdr.msg_namelen = sizeof(udp_address_t);
+  }
+  do {
+    nb_datagrams = recvmmsg(sd, batch->hdrs, UDP_BATCH_SIZE, flags, NULL);
+  } while (nb_datagrams < 0 && errno == EINTR);
+  if (nb_datagrams < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+    return 0;
+  }
+  return nb_datagrams;
+}
+
+//------------------------------------------------------------------------------
+int udp_send_batch_add(
+    udp_send_batch_t* batch, const uint8_t* buffer, uint32_t length,
+    const struct sockaddr* address) {
+  int i                 = batch->nb_datagrams;
+  struct msghdr* hdr    = NULL;
+  socklen_t address_len = address->sa_family == AF_INET6 ?
+                              sizeof(struct sockaddr_in6) :
+                              sizeof(struct sockaddr_in);
+
+  if (i == UDP_BATCH_SIZE || length > sizeof(batch->buffers[i])) {
+    return -1;
+  }
+  hdr = &batch->hdrs[i].msg_hdr;
+  memcpy(batch->buffers[i], buffer, length);
+  memcpy(&batch->addresses[i], address, address_len);
+  batch->iovs[i].iov_base = batch->buffers[i];
+  batch->iovs[i].iov_len  = length;
+  memset(hdr, 0, sizeof(*hdr));
+  hdr->msg_iov     = &batch->iovs[i];
+  hdr->msg_iovlen  = 1;
+  hdr->msg_name    = &batch->addresses[i];
+  hdr->msg_namelen = address_len;
+  batch->nb_datagrams++;
+  return 0;
+}
+
+//------------------------------------------------------------------------------
+// Returns true once the socket takes datagrams again
+static bool udp_wait_writable(int sd) {
+  struct pollfd pfd = {.fd = sd, .events = POLLOUT};
+  int rc            = 0;
+
+  do {
+    rc = poll(&pfd, 1, UDP_SEND_DRAIN_TIMEOUT_MS);
+  } while (rc < 0 && errno == EINTR);
+  return rc > 0;
+}
+
+//------------------------------------------------------------------------------
+int udp_send_batch_flush(int sd, udp_send_batch_t* batch) {
+  int nb_failed = 0;
+  int sent      = 0;
+  bool waited   = false;
+
+  while (sent < batch->nb_datagrams) {
+    int rc = sendmmsg(
+        sd, &batch->hdrs[sent], batch->nb_datagrams - sent, MSG_DONTWAIT);
+
+    if (rc < 0 && errno == EINTR) {
+      continue;
+    }
+    // The send buffer is full, block until it drains rather than drop the
+    // rest, once per progress so that a stuck socket can't hold the task
+    if (rc < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+      if (!waited && udp_wait_writable(sd)) {
+        waited = true;
+        continue;
+      }
+      errno = EAGAIN;
+      nb_failed += batch->nb_datagrams - sent;
+      break;
+    }
+    // Skip the datagram sendmmsg() stopped at
+    if (rc <= 0) {
+      nb_failed++;
+      rc = 1;
+    }
+    sent += rc;
+    waited = false;
+  }
+  batch->nb_datagrams = 0;
+  return nb_failed;
+}
@@ -0,0 +1,85 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+
+/*! \file udp_batch.h
+  \brief Batched datagram receive and send for the UDP task
+*/
+
+#ifndef FILE_UDP_BATCH_SEEN
+#define FILE_UDP_BATCH_SEEN
+
+// struct mmsghdr needs _GNU_SOURCE, defined by the C files including this
+#include <netinet/in.h>
+#include <stdint.h>
+#include <sys/socket.h>
+
+#include "udp_messages_types.h"
+
+/* Datagrams per recvmmsg() and per sendmmsg() */
+#define UDP_BATCH_SIZE 32
+/* Longest a flush blocks on a full socket send buffer before dropping */
+#define UDP_SEND_DRAIN_TIMEOUT_MS 100
+
+typedef union udp_address_u {
+  struct sockaddr sa;
+  struct sockaddr_in in;
+  struct sockaddr_in6 in6;
+} udp_address_t;
+
+/*
+ * Receive slots, each pointing at a buffer and an address the caller owns,
+ * so that datagrams land where they are consumed
+ */
+typedef struct udp_recv_batch_s {
+  struct mmsghdr hdrs[UDP_BATCH_SIZE];
+  struct iovec iovs[UDP_BATCH_SIZE];
+} udp_recv_batch_t;
+
+void udp_recv_batch_set_slot(
+    udp_recv_batch_t* batch, int slot, void* buffer, size_t length,
+    udp_address_t* address);
+
+/*
+ * Receives up to UDP_BATCH_SIZE datagrams in one system call, the length of
+ * the one in slot i is hdrs[i].msg_len. Returns their number, 0 when none
+ * is waiting and -1 on error.
+ */
+int udp_recv_batch(int sd, udp_recv_batch_t* batch, int flags);
+
+/* Datagrams queued for one socket, copied out of the caller's buffers */
+typedef struct udp_send_batch_s {
+  int nb_datagrams;
+  struct mmsghdr hdrs[UDP_BATCH_SIZE];
+  struct iovec iovs[UDP_BATCH_SIZE];
+  udp_address_t addresses[UDP_BATCH_SIZE];
+  uint8_t buffers[UDP_BATCH_SIZE][UDP_DATA_MAX_MSG_LEN];
+} udp_send_batch_t;
+
+/* Returns -1 when the batch is full or the datagram too long */
+int udp_send_batch_add(
+    udp_send_batch_t* batch, const uint8_t* buffer, uint32_t length,
+    const struct sockaddr* address);
+
+/*
+ * Sends the queued datagrams with as few sendmmsg() as the socket takes and
+ * empties the batch. A full send buffer is waited on, for up to
+ * UDP_SEND_DRAIN_TIMEOUT_MS without progress. Returns the number of
+ * datagrams that failed, errno is the one of the last failure.
+ */
+int udp_send_batch_flush(int sd, udp_send_batch_t* batch);
+
+#endif /* FILE_UDP_BATCH_SEEN */
@@ -22,6 +22,7 @@
   \email: lionel.gauthier@eurecom.fr
 */
 
+#define _GNU_SOURCE
 #include <arpa/inet.h>
 #include <errno.h>
 #include <fcntl.h>
@@ -44,28 +45,41 @@
 #include "itti_free_defined_msg.h"
 #include "log.h"
 #include "queue.h"
+#include "udp_batch.h"
 #include "udp_primitives_server.h"
 
+/* recvmmsg() calls per wake-up of the task, to let its own queue in */
+#define UDP_RECV_BUDGET 8
+
 task_zmq_ctx_t udp_task_zmq_ctx;
 
 struct udp_socket_desc_s {
-  uint8_t buffer[4096];
   int sd; /* Socket descriptor to use */
 
-  pthread_t listener_thread; /* Thread affected to recv */
+  /* Thread affected to recv, for the extra SO_REUSEPORT sockets only */
+  pthread_t listener_thread;
+  bool is_listener;
+  task_zmq_ctx_t listener_zmq_ctx;
 
-  struct sockaddr local_addr; /* Local ipv4 or ipv6 address to use */
-  uint16_t local_port;        /* Local port to use */
+  udp_address_t local_addr; /* Local ipv4 or ipv6 address to use */
+  uint16_t local_port;      /* Local port to use */
 
   task_id_t task_id; /* Task who has requested the new endpoint */
+
+  /* UDP_DATA_IND messages the next datagrams are received into */
+  MessageDef* recv_messages[UDP_BATCH_SIZE];
+  udp_recv_batch_t recv_batch;
+  /* UDP_DATA_REQ datagrams queued while the task drains its queue */
+  udp_send_batch_t send_batch;
   STAILQ_ENTRY(udp_socket_desc_s) entries;
 };
 
 static STAILQ_HEAD(udp_socket_list_s, udp_socket_desc_s) udp_socket_list;
 static pthread_mutex_t udp_socket_list_mutex = PTHREAD_MUTEX_INITIALIZER;
 
-static void udp_server_receive_and_process(
-    struct udp_socket_desc_s* udp_sock_pP);
+static int udp_server_receive_and_process(
+    struct udp_socket_desc_s* udp_sock_pP, task_zmq_ctx_t* task_zmq_ctx_p,
+    int flags);
 
 /* @brief Retrieve the descriptor associated with the task_id
  */
@@ -75,8 +89,8 @@ static struct udp_socket_desc_s* udp_server_get_socket_desc(
 
   OAILOG_DEBUG(LOG_UDP, "Looking for task %d\n", task_id);
   STAILQ_FOREACH(udp_sock_p, &udp_socket_list, entries) {
-    if (udp_sock_p->task_id == task_id &&
-        udp_sock_p->local_addr.sa_family == sa_family) {
+    if (udp_sock_p->task_id == task_id && !udp_sock_p->is_listener &&
+        udp_sock_p->local_addr.sa.sa_family == sa_family) {
       if (local_port) {
         if (udp_sock_p->local_port == local_port) {
           OAILOG_DEBUG(LOG_UDP, "Found matching local port %d. \n", local_port);
@@ -114,66 +128,80 @@ static struct udp_socket_desc_s* udp_server_get_socket_desc_by_sd(int sdP) {
   return udp_sock_p;
 }
 
-static void udp_server_receive_and_process(
-    struct udp_socket_desc_s* udp_sock_pP) {
-  OAILOG_DEBUG(
-      LOG_UDP, "Inserting new descriptor for task %d, sd %d\n",
-      udp_sock_pP->task_id, udp_sock_pP->sd);
-  {
-    int bytes_received = 0;
-    socklen_t from_len;
-    struct sockaddr_in addr;
-    struct sockaddr_in6 addr6;
-
-    bool ipv6 = udp_sock_pP->local_addr.sa_family == AF_INET6;
-
-    if (ipv6) {
-      from_len = (socklen_t) sizeof(struct sockaddr_in6);
-      memset(&addr, 0, sizeof(struct sockaddr_in6));
-    } else {
-      from_len = (socklen_t) sizeof(struct sockaddr_in);
-      memset(&addr6, 0, sizeof(struct sockaddr_in));
-    }
+/* Receives datagrams straight into UDP_DATA_IND messages, UDP_BATCH_SIZE at
+ * a time, until the socket is drained or the budget spent. Returns the number
+ * of datagrams received, -1 on error.
+ */
+static int udp_server_receive_and_process(
+    struct udp_socket_desc_s* udp_sock_pP, task_zmq_ctx_t* task_zmq_ctx_p,
+    int flags) {
+  bool ipv6          = udp_sock_pP->local_addr.sa.sa_family == AF_INET6;
+  int total_received = 0;
+
+  for (int budget = UDP_RECV_BUDGET; budget > 0; budget--) {
+    int nb_received = 0;
 
-    if ((bytes_received = recvfrom(
-             udp_sock_pP->sd, udp_sock_pP->buffer, sizeof(udp_sock_pP->buffer),
-             0, ipv6 ? (struct sockaddr*) &addr6 : (struct sockaddr*) &addr,
-             &from_len)) <= 0) {
-      OAILOG_ERROR(LOG_UDP, "Recvfrom failed %s\n", strerror(errno));
-      // break;
-    } else {
-      MessageDef* message_p = NULL;
-      udp_data_ind_t* udp_data_ind_p;
-      AssertFatal(
-          sizeof(udp_sock_pP->buffer) >= bytes_received, "UDP BUFFER OVERFLOW");
+    for (int i = 0; i < UDP_BATCH_SIZE; i++) {
+      MessageDef* message_p = udp_sock_pP->recv_messages[i];
+
+      if (message_p) {
+        continue;
+      }
       message_p = itti_alloc_new_message(TASK_UDP, UDP_DATA_IND);
       DevAssert(message_p != NULL);
-      udp_data_ind_p = &message_p->ittiMsg.udp_data_ind;
-      memcpy(udp_data_ind_p->msgBuf, udp_sock_pP->buffer, bytes_received);
+      udp_sock_pP->recv_messages[i] = message_p;
+      udp_recv_batch_set_slot(
+          &udp_sock_pP->recv_batch, i, message_p->ittiMsg.udp_data_ind.msgBuf,
+          UDP_DATA_MAX_MSG_LEN,
+          (udp_address_t*) &message_p->ittiMsg.udp_data_ind.sock_addr);
+    }
+
+    if ((nb_received = udp_recv_batch(
+             udp_sock_pP->sd, &udp_sock_pP->recv_batch, flags)) < 0) {
+      OAILOG_ERROR(LOG_UDP, "Recvmmsg failed %s\n", strerror(errno));
+      return -1;
+    }
 
-      udp_data_ind_p->buffer_length = bytes_received;
+    for (int i = 0; i < nb_received; i++) {
+      struct mmsghdr* hdr            = &udp_sock_pP->recv_batch.hdrs[i];
+      MessageDef* message_p          = udp_sock_pP->recv_messages[i];
+      udp_data_ind_t* udp_data_ind_p = &message_p->ittiMsg.udp_data_ind;
+
+      if (hdr->msg_hdr.msg_flags & MSG_TRUNC) {
+        OAILOG_ERROR(
+            LOG_UDP, "Dropping datagram longer than %d bytes\n",
+            UDP_DATA_MAX_MSG_LEN);
+        continue;
+      }
+      udp_data_ind_p->buffer_length = hdr->msg_len;
       udp_data_ind_p->local_port    = udp_sock_pP->local_port;
       udp_data_ind_p->peer_port =
-          ipv6 ? htons(addr6.sin6_port) : htons(addr.sin_port);
-      memcpy(
-          (void*) &udp_data_ind_p->sock_addr,
-          (ipv6) ? (void*) &addr6 : (void*) &addr,
-          (ipv6) ? sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in));
+          ipv6 ? htons(udp_data_ind_p->sock_addr.addrv6.sin6_port) :
+                 htons(udp_data_ind_p->sock_addr.addrv4.sin_port);
 
       OAILOG_DEBUG(
-          LOG_UDP, "Msg of length %d received from %s:%u\n", bytes_received,
-          (!ipv6) ? inet_ntoa(addr.sin_addr) : "TODO_IPV6",
-          ntohs(addr.sin_port));
-
-      if (send_msg_to_task(&udp_task_zmq_ctx, udp_sock_pP->task_id, message_p) <
+          LOG_UDP, "Msg of length %u received from %s:%u\n", hdr->msg_len,
+          (!ipv6) ? inet_ntoa(udp_data_ind_p->sock_addr.addrv4.sin_addr) :
+                    "TODO_IPV6",
+          udp_data_ind_p->peer_port);
+
+      // The message is freed once sent, its slot gets a new one
+      udp_sock_pP->recv_messages[i] = NULL;
+      if (send_msg_to_task(task_zmq_ctx_p, udp_sock_pP->task_id, message_p) <
           0) {
         OAILOG_DEBUG(
             LOG_UDP, "Failed to send message %d to task %d\n", UDP_DATA_IND,
             udp_sock_pP->task_id);
-        // break;
       }
     }
+    total_received += nb_received;
+    if (nb_received < UDP_BATCH_SIZE) {
+      break;
+    }
+    // A listener only blocks for the first datagram
+    flags = (flags & ~MSG_WAITFORONE) | MSG_DONTWAIT;
   }
+  return total_received;
 }
 
 static int udp_socket_handler(zloop_t* loop, zmq_pollitem_t* item, void* arg) {
@@ -183,7 +211,8 @@ static int udp_socket_handler(zloop_t* loop, zmq_pollitem_t* item, void* arg) {
   udp_sock_p = udp_server_get_socket_desc_by_sd(item->fd);
 
   if (udp_sock_p != NULL) {
-    udp_server_receive_and_process(udp_sock_p);
+    udp_server_receive_and_process(
+        udp_sock_p, &udp_task_zmq_ctx, MSG_DONTWAIT);
   } else {
     OAILOG_ERROR(
         LOG_UDP, "Failed to retrieve the udp socket descriptor %d", item->fd);
@@ -194,9 +223,57 @@ static int udp_socket_handler(zloop_t* loop, zmq_pollitem_t* item, void* arg) {
   return 0;
 }
 
+//------------------------------------------------------------------------------
+// Reads one of the extra SO_REUSEPORT sockets, with its own push sockets
+static void* udp_listener_thread(void* args) {
+  struct udp_socket_desc_s* udp_sock_p = (struct udp_socket_desc_s*) args;
+
+  init_task_context(
+      TASK_UDP, (task_id_t[]){TASK_MME_APP, TASK_S11}, 2, NULL,
+      &udp_sock_p->listener_zmq_ctx);
+  // Ends on udp_exit() shutdown of the socket
+  while (udp_server_receive_and_process(
+             udp_sock_p, &udp_sock_p->listener_zmq_ctx, MSG_WAITFORONE) > 0) {
+  }
+  destroy_task_context(&udp_sock_p->listener_zmq_ctx);
+  return NULL;
+}
+
+//------------------------------------------------------------------------------
+static void udp_server_start_receive(
+    struct udp_socket_desc_s* socket_desc_p, bool is_listener) {
+  socket_desc_p->is_listener = is_listener;
+  pthread_mutex_lock(&udp_socket_list_mutex);
+  STAILQ_INSERT_TAIL(&udp_socket_list, socket_desc_p, entries);
+  pthread_mutex_unlock(&udp_socket_list_mutex);
+
+  if (is_listener) {
+    pthread_create(
+        &socket_desc_p->listener_thread, NULL, udp_listener_thread,
+        socket_desc_p);
+    return;
+  }
+  zmq_pollitem_t item = {0, socket_desc_p->sd, ZMQ_POLLIN, 0};
+  zloop_poller(udp_task_zmq_ctx.event_loop, &item, udp_socket_handler, NULL);
+}
+
+//------------------------------------------------------------------------------
+static int udp_server_set_reuse_port(int sd) {
+  int enable = 1;
+
+  if (setsockopt(sd, SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)) < 0) {
+    OAILOG_ERROR(
+        LOG_UDP, "setsockopt SO_REUSEPORT failed (%s)\n", strerror(errno));
+    close(sd);
+    return -1;
+  }
+  return 0;
+}
+
 //------------------------------------------------------------------------------
 static int udp_server_create_socket_v4(
-    uint16_t port, struct in_addr* address, task_id_t task_id) {
+    uint16_t port, struct in_addr* address, task_id_t task_id, bool reuse_port,
+    bool is_listener) {
   struct sockaddr_in addr;
   int sd;
   struct udp_socket_desc_s* socket_desc_p = NULL;
@@ -219,6 +296,10 @@ static int udp_server_create_socket_v4(
   addr.sin_port   = htons(port);
   addr.sin_addr   = *address;
 
+  if (reuse_port && udp_server_set_reuse_port(sd) < 0) {
+    return -1;
+  }
+
   char ipv4[INET_ADDRSTRLEN];
   inet_ntop(AF_INET, (void*) &addr.sin_addr, ipv4, INET_ADDRSTRLEN);
   OAILOG_DEBUG(
@@ -248,9 +329,9 @@ static int udp_server_create_socket_v4(
    * Add the socket to list of fd monitored by ITTI
    */
   /*
-   * Mark the socket as non-blocking
+   * Mark the socket as non-blocking, listener threads block on theirs
    */
-  if (fcntl(sd, F_SETFL, O_NONBLOCK) < 0) {
+  if (!is_listener && fcntl(sd, F_SETFL, O_NONBLOCK) < 0) {
     OAILOG_ERROR(
         LOG_UDP, "fcntl F_SETFL O_NONBLOCK failed for IPv4: %s\n",
         strerror(errno));
@@ -260,27 +341,23 @@ static int udp_server_create_socket_v4(
 
   socket_desc_p = calloc(1, sizeof(struct udp_socket_desc_s));
   DevAssert(socket_desc_p != NULL);
-  socket_desc_p->sd                                            = sd;
-  ((struct sockaddr_in*) &socket_desc_p->local_addr)->sin_addr = *address;
-  socket_desc_p->local_addr.sa_family                          = AF_INET;
+  socket_desc_p->sd                      = sd;
+  socket_desc_p->local_addr.in.sin_addr  = *address;
+  socket_desc_p->local_addr.sa.sa_family = AF_INET;
   socket_desc_p->local_port = ntohs(addr_check.sin_port);
   socket_desc_p->task_id    = task_id;
   OAILOG_DEBUG(
       LOG_UDP, "(IPv4) Inserting new descriptor for task %d, sd %d\n",
       socket_desc_p->task_id, socket_desc_p->sd);
-  pthread_mutex_lock(&udp_socket_list_mutex);
-  STAILQ_INSERT_TAIL(&udp_socket_list, socket_desc_p, entries);
-  pthread_mutex_unlock(&udp_socket_list_mutex);
-
-  zmq_pollitem_t item = {0, sd, ZMQ_POLLIN, 0};
-  zloop_poller(udp_task_zmq_ctx.event_loop, &item, udp_socket_handler, NULL);
+  udp_server_start_receive(socket_desc_p, is_listener);
 
   return sd;
 }
 
 //------------------------------------------------------------------------------
 static int udp_server_create_socket_v6(
-    uint16_t port, struct in6_addr* address, task_id_t task_id) {
+    uint16_t port, struct in6_addr* address, task_id_t task_id, bool reuse_port,
+    bool is_listener) {
   struct sockaddr_in6 addr;
   int sd;
   struct udp_socket_desc_s* socket_desc_p = NULL;
@@ -302,6 +379,10 @@ static int udp_server_create_socket_v6(
   addr.sin6_port   = htons(port);
   addr.sin6_addr   = *address;
 
+  if (reuse_port && udp_server_set_reuse_port(sd) < 0) {
+    return -1;
+  }
+
   char ipv6[INET6_ADDRSTRLEN];
   inet_ntop(AF_INET6, (void*) &addr, ipv6, INET6_ADDRSTRLEN);
   OAILOG_DEBUG(
@@ -329,9 +410,9 @@ static int udp_server_create_socket_v6(
    * Add the socket to list of fd monitored by ITTI
    */
   /*
-   * Mark the socket as non-blocking
+   * Mark the socket as non-blocking, listener threads block on theirs
    */
-  if (fcntl(sd, F_SETFL, O_NONBLOCK) < 0) {
+  if (!is_listener && fcntl(sd, F_SETFL, O_NONBLOCK) < 0) {
     OAILOG_ERROR(
         LOG_UDP, "fcntl F_SETFL O_NONBLOCK failed: %s\n", strerror(errno));
     close(sd);
@@ -340,9 +421,9 @@ static int udp_server_create_socket_v6(
 
   socket_desc_p = calloc(1, sizeof(struct udp_socket_desc_s));
   DevAssert(socket_desc_p != NULL);
-  socket_desc_p->sd                                              = sd;
-  ((struct sockaddr_in6*) &socket_desc_p->local_addr)->sin6_addr = *address;
-  socket_desc_p->local_addr.sa_family                            = AF_INET6;
+  socket_desc_p->sd                       = sd;
+  socket_desc_p->local_addr.in6.sin6_addr = *address;
+  socket_desc_p->local_addr.sa.sa_family  = AF_INET6;
 
   //  ((struct sockaddr_in6*)&socket_desc_p->local_addr)->sin6_family = AF_INET;
   socket_desc_p->local_port = ntohs(addr_check.sin_port);
@@ -350,145 +431,133 @@ static int udp_server_create_socket_v6(
   OAILOG_DEBUG(
       LOG_UDP, "(IPv6) Inserting new descriptor for task %d, sd %d\n",
       socket_desc_p->task_id, socket_desc_p->sd);
+  udp_server_start_receive(socket_desc_p, is_listener);
+
+  return sd;
+}
+
+//------------------------------------------------------------------------------
+// The first socket of a port serves the task, the extra receive sockets share
+// the port through SO_REUSEPORT and are read by their own thread
+static void udp_server_create_sockets(
+    udp_init_t* udp_init_p, task_id_t task_id) {
+  int nb_sockets = 1;
+
+  if (udp_init_p->port && udp_init_p->nb_receive_sockets > 1) {
+    nb_sockets = udp_init_p->nb_receive_sockets;
+  }
+  for (int i = 0; i < nb_sockets; i++) {
+    if (udp_init_p->in_addr)
+      udp_server_create_socket_v4(
+          udp_init_p->port, udp_init_p->in_addr, task_id, nb_sockets > 1,
+          i > 0);
+    if (udp_init_p->in6_addr)
+      udp_server_create_socket_v6(
+          udp_init_p->port, udp_init_p->in6_addr, task_id, nb_sockets > 1,
+          i > 0);
+  }
+}
+
+//------------------------------------------------------------------------------
+static void udp_server_queue_send(
+    udp_data_req_t* udp_data_req_p, task_id_t task_id) {
+  struct udp_socket_desc_s* udp_sock_p = NULL;
+  udp_address_t peer_addr;
+  int sa_family = udp_data_req_p->peer_address->sa_family;
+
+  memset(&peer_addr, 0, sizeof(peer_addr));
+  if (sa_family == AF_INET) {
+    peer_addr.in.sin_family = AF_INET;
+    peer_addr.in.sin_port   = htons(udp_data_req_p->peer_port);
+    peer_addr.in.sin_addr =
+        ((struct sockaddr_in*) udp_data_req_p->peer_address)->sin_addr;
+    OAILOG_DEBUG(
+        LOG_UDP, "Sending message of size %u to " IN_ADDR_FMT " and port %u\n",
+        udp_data_req_p->buffer_length, PRI_IN_ADDR(peer_addr.in.sin_addr),
+        udp_data_req_p->peer_port);
+  } else if (sa_family == AF_INET6) {
+    peer_addr.in6.sin6_family = AF_INET6;
+    peer_addr.in6.sin6_port   = htons(udp_data_req_p->peer_port);
+    peer_addr.in6.sin6_addr =
+        ((struct sockaddr_in6*) udp_data_req_p->peer_address)->sin6_addr;
+  } else {
+    OAILOG_DEBUG(LOG_UDP, "Unknown address type");
+    return;
+  }
+
   pthread_mutex_lock(&udp_socket_list_mutex);
-  STAILQ_INSERT_TAIL(&udp_socket_list, socket_desc_p, entries);
+  udp_sock_p = udp_server_get_socket_desc(
+      task_id, udp_data_req_p->local_port, udp_data_req_p->peer_port,
+      sa_family);
+  if (udp_sock_p == NULL) {
+    OAILOG_ERROR(
+        LOG_UDP,
+        "Failed to retrieve the udp socket descriptor for %s associated with "
+        "task %d\n",
+        sa_family == AF_INET ? "IPv4" : "IPv6", task_id);
+    pthread_mutex_unlock(&udp_socket_list_mutex);
+    return;
+  }
+  // The datagram is copied, udp_data_req_p->buffer is freed with the message
+  while (udp_send_batch_add(
+             &udp_sock_p->send_batch,
+             &udp_data_req_p->buffer[udp_data_req_p->buffer_offset],
+             udp_data_req_p->buffer_length, &peer_addr.sa) < 0) {
+    if (udp_sock_p->send_batch.nb_datagrams == 0) {
+      OAILOG_ERROR(
+          LOG_UDP, "Dropping datagram of %u bytes, longer than %d\n",
+          udp_data_req_p->buffer_length, UDP_DATA_MAX_MSG_LEN);
+      break;
+    }
+    udp_send_batch_flush(udp_sock_p->sd, &udp_sock_p->send_batch);
+  }
   pthread_mutex_unlock(&udp_socket_list_mutex);
+}
 
-  zmq_pollitem_t item = {0, sd, ZMQ_POLLIN, 0};
-  zloop_poller(udp_task_zmq_ctx.event_loop, &item, udp_socket_handler, NULL);
+//------------------------------------------------------------------------------
+// Sends the datagrams queued on every socket, one sendmmsg() per socket
+static void udp_server_flush_sends(void) {
+  struct udp_socket_desc_s* udp_sock_p = NULL;
 
-  return sd;
+  pthread_mutex_lock(&udp_socket_list_mutex);
+  STAILQ_FOREACH(udp_sock_p, &udp_socket_list, entries) {
+    if (udp_sock_p->send_batch.nb_datagrams == 0) {
+      continue;
+    }
+    int nb_failed =
+        udp_send_batch_flush(udp_sock_p->sd, &udp_sock_p->send_batch);
+    if (nb_failed) {
+      OAILOG_ERROR(
+          LOG_UDP,
+          "There was an error while writing %d datagrams to socket %d "
+          "(%d:%s)\n",
+          nb_failed, udp_sock_p->sd, errno, strerror(errno));
+    }
+  }
+  pthread_mutex_unlock(&udp_socket_list_mutex);
 }
 
-static int handle_message(zloop_t* loop, zsock_t* reader, void* arg) {
-  zframe_t* msg_frame = zframe_recv(reader);
-  assert(msg_frame);
-  MessageDef* received_message_p = (MessageDef*) zframe_data(msg_frame);
-
+//------------------------------------------------------------------------------
+static int handle_one_message(MessageDef* received_message_p) {
   switch (ITTI_MSG_ID(received_message_p)) {
     case MESSAGE_TEST: {
       OAI_FPRINTF_INFO("TASK_UDP received MESSAGE_TEST\n");
     } break;
 
     case TERMINATE_MESSAGE: {
-      itti_free_msg_content(received_message_p);
-      zframe_destroy(&msg_frame);
-      udp_exit();
+      return -1;
     } break;
 
     case UDP_INIT: {
-      udp_init_t* udp_init_p = &received_message_p->ittiMsg.udp_init;
-      if (udp_init_p->in_addr)
-        udp_server_create_socket_v4(
-            udp_init_p->port, udp_init_p->in_addr,
-            ITTI_MSG_ORIGIN_ID(received_message_p));
-      if (udp_init_p->in6_addr)
-        udp_server_create_socket_v6(
-            udp_init_p->port, udp_init_p->in6_addr,
-            ITTI_MSG_ORIGIN_ID(received_message_p));
+      udp_server_create_sockets(
+          &received_message_p->ittiMsg.udp_init,
+          ITTI_MSG_ORIGIN_ID(received_message_p));
     } break;
 
     case UDP_DATA_REQ: {
-      int udp_sd = -1;
-      ssize_t bytes_written;
-      struct udp_socket_desc_s* udp_sock_p = NULL;
-      udp_data_req_t* udp_data_req_p;
-      struct sockaddr_in peer_addr;
-      struct sockaddr_in6 peer_addr6;
-
-      udp_data_req_p = &received_message_p->ittiMsg.udp_data_req;
-      // UDP_DEBUG("-- UDP_DATA_REQ
-      // -----------------------------------------------------\n%s :\n",
-      //        __FUNCTION__);
-      // udp_print_hex_octets(&udp_data_req_p->buffer[udp_data_req_p->buffer_offset],
-      //        udp_data_req_p->buffer_length);
-      if (udp_data_req_p->peer_address->sa_family == AF_INET) {
-        memset(&peer_addr, 0, sizeof(struct sockaddr_in));
-        peer_addr.sin_family = AF_INET;
-        peer_addr.sin_port   = htons(udp_data_req_p->peer_port);
-        peer_addr.sin_addr =
-            ((struct sockaddr_in*) udp_data_req_p->peer_address)->sin_addr;
-        pthread_mutex_lock(&udp_socket_list_mutex);
-        udp_sock_p = udp_server_get_socket_desc(
-            ITTI_MSG_ORIGIN_ID(received_message_p), udp_data_req_p->local_port,
-            udp_data_req_p->peer_port, AF_INET);
-
-        if (udp_sock_p == NULL) {
-          OAILOG_ERROR(
-              LOG_UDP,
-              "Failed to retrieve the udp socket descriptor for IPv4 "
-              "associated with task %d\n",
-              ITTI_MSG_ORIGIN_ID(received_message_p));
-          pthread_mutex_unlock(&udp_socket_list_mutex);
-          // no free udp_data_req_p->buffer, statically allocated
-          break;
-        }
-
-        udp_sd = udp_sock_p->sd;
-        pthread_mutex_unlock(&udp_socket_list_mutex);
-        OAILOG_DEBUG(
-            LOG_UDP,
-            "[%d] Sending message of size %u to " IN_ADDR_FMT " and port %u\n",
-            udp_sd, udp_data_req_p->buffer_length,
-            PRI_IN_ADDR(
-                ((struct sockaddr_in*) udp_data_req_p->peer_address)->sin_addr),
-            udp_data_req_p->peer_port);
-        bytes_written = sendto(
-            udp_sd, &udp_data_req_p->buffer[udp_data_req_p->buffer_offset],
-            udp_data_req_p->buffer_length, 0, (struct sockaddr*) &peer_addr,
-            sizeof(struct sockaddr_in));
-        // no free udp_data_req_p->buffer, statically allocated
-
-        if (bytes_written != udp_data_req_p->buffer_length) {
-          OAILOG_ERROR(
-              LOG_UDP,
-              "There was an error while writing to socket "
-              "(%d:%s)\n",
-              errno, strerror(errno));
-        }
-      } else if (udp_data_req_p->peer_address->sa_family == AF_INET6) {
-        memset(&peer_addr6, 0, sizeof(struct sockaddr_in6));
-        peer_addr6.sin6_family = AF_INET6;
-        peer_addr6.sin6_port   = htons(udp_data_req_p->peer_port);
-        peer_addr6.sin6_addr =
-            ((struct sockaddr_in6*) udp_data_req_p->peer_address)->sin6_addr;
-        pthread_mutex_lock(&udp_socket_list_mutex);
-        udp_sock_p = udp_server_get_socket_desc(
-            ITTI_MSG_ORIGIN_ID(received_message_p), udp_data_req_p->local_port,
-            udp_data_req_p->peer_port, AF_INET6);
-
-        if (udp_sock_p == NULL) {
-          OAILOG_ERROR(
-              LOG_UDP,
-              "Failed to retrieve the udp socket descriptor for IPv6 "
-              "associated with task %d\n",
-              ITTI_MSG_ORIGIN_ID(received_message_p));
-          pthread_mutex_unlock(&udp_socket_list_mutex);
-          // no free udp_data_req_p->buffer, statically allocated
-          break;
-        }
-
-        udp_sd = udp_sock_p->sd;
-        pthread_mutex_unlock(&udp_socket_list_mutex);
-        bytes_written = sendto(
-            udp_sd, &udp_data_req_p->buffer[udp_data_req_p->buffer_offset],
-            udp_data_req_p->buffer_length, 0, (struct sockaddr*) &peer_addr6,
-            sizeof(struct sockaddr_in6));
-        // no free udp_data_req_p->buffer, statically allocated
-
-        if (bytes_written != udp_data_req_p->buffer_length) {
-          OAILOG_ERROR(
-              LOG_UDP,
-              "There was an error while writing to socket "
-              "(%d:%s)\n",
-              errno, strerror(errno));
-        }
-      }
-
-      else {
-        OAILOG_DEBUG(LOG_UDP, "Unknown address type");
-      }
-
+      udp_server_queue_send(
+          &received_message_p->ittiMsg.udp_data_req,
+          ITTI_MSG_ORIGIN_ID(received_message_p));
     } break;
 
     default: {
@@ -497,18 +566,42 @@ static int handle_message(zloop_t* loop, zsock_t* reader, void* arg) {
           ITTI_MSG_ID(received_message_p), ITTI_MSG_NAME(received_message_p));
     } break;
   }
+  return 0;
+}
 
-  itti_free_msg_content(received_message_p);
-  zframe_destroy(&msg_frame);
+/*
+ * Drains up to UDP_BATCH_SIZE queued messages before writing, so that the
+ * UDP_DATA_REQs of a burst leave in one sendmmsg() per socket
+ */
+static int handle_message(zloop_t* loop, zsock_t* reader, void* arg) {
+  int nb_messages = 0;
+
+  do {
+    zframe_t* msg_frame = zframe_recv(reader);
+    assert(msg_frame);
+    MessageDef* received_message_p = (MessageDef*) zframe_data(msg_frame);
+
+    if (handle_one_message(received_message_p) < 0) {
+      udp_server_flush_sends();
+      itti_free_msg_content(received_message_p);
+      zframe_destroy(&msg_frame);
+      udp_exit();
+    }
+    itti_free_msg_content(received_message_p);
+    zframe_destroy(&msg_frame);
+  } while (++nb_messages < UDP_BATCH_SIZE &&
+           (zsock_events(reader) & ZMQ_POLLIN));
+
+  udp_server_flush_sends();
   return 0;
 }
 
 //------------------------------------------------------------------------------
 static void* udp_thread(void* args) {
-  itti_mark_task_ready(TASK_UDP);
   init_task_context(
       TASK_UDP, (task_id_t[]){TASK_MME_APP, TASK_S11}, 2, handle_message,
       &udp_task_zmq_ctx);
+  itti_mark_task_ready(TASK_UDP);
 
   zloop_start(udp_task_zmq_ctx.event_loop);
   udp_exit();
@@ -532,12 +625,23 @@ int udp_init(void) {
 //------------------------------------------------------------------------------
 void udp_exit(void) {
   struct udp_socket_desc_s* socket_desc_p = NULL;
+
+  // Wake up the listener threads blocked in recvmmsg() and wait for them
+  STAILQ_FOREACH(socket_desc_p, &udp_socket_list, entries) {
+    if (socket_desc_p->is_listener) {
+      shutdown(socket_desc_p->sd, SHUT_RDWR);
+      pthread_join(socket_desc_p->listener_thread, NULL);
+    }
+  }
   while ((socket_desc_p = STAILQ_FIRST(&udp_socket_list))) {
     close(socket_desc_p->sd);
-    pthread_mutex_destroy(&udp_socket_list_mutex);
+    for (int i = 0; i < UDP_BATCH_SIZE; i++) {
+      free_wrapper((void**) &socket_desc_p->recv_messages[i]);
+    }
     STAILQ_REMOVE_HEAD(&udp_socket_list, entries);
     free_wrapper((void**) &socket_desc_p);
   }
+  pthread_mutex_destroy(&udp_socket_list_mutex);
 
   destroy_task_context(&udp_task_zmq_ctx);
   OAI_FPRINTF_INFO("TASK_UDP terminated\n");
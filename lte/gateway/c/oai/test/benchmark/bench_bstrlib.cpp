@@ -0,0 +1,115 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <vector>
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "bstrlib.h"
+}
+
+/*
+ * bstrlib operations the NAS and S1AP paths run per message: copies of IEs
+ * and NAS PDUs, APN handling and comparisons.
+ */
+namespace {
+
+void BM_Blk2bstr(benchmark::State& state) {
+  std::vector<uint8_t> blk(state.range(0), 0x5a);
+
+  for (auto _ : state) {
+    bstring b = blk2bstr(blk.data(), blk.size());
+    benchmark::DoNotOptimize(b);
+    bdestroy(b);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Bstrcpy(benchmark::State& state) {
+  std::vector<uint8_t> blk(state.range(0), 0x5a);
+  bstring src = blk2bstr(blk.data(), blk.size());
+
+  for (auto _ : state) {
+    bstring b = bstrcpy(src);
+    benchmark::DoNotOptimize(b);
+    bdestroy(b);
+  }
+  bdestroy(src);
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Bcatblk(benchmark::State& state) {
+  std::vector<uint8_t> blk(state.range(0), 0x5a);
+
+  for (auto _ : state) {
+    bstring b = blk2bstr(blk.data(), 2);
+    bcatblk(b, blk.data(), blk.size());
+    benchmark::DoNotOptimize(b);
+    bdestroy(b);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+// Label encoded APN to dotted form, as done when decoding the APN IE
+void BM_ApnToDotted(benchmark::State& state) {
+  const uint8_t apn[] = {0x08, 'i', 'n', 't', 'e', 'r', 'n', 'e', 't', 0x06,
+                         'm',  'n', 'c', '0', '0', '1', 0x06, 'm', 'c', 'c',
+                         '0',  '0', '1', 0x04, 'g', 'p', 'r', 's'};
+
+  for (auto _ : state) {
+    bstring b = blk2bstr(&apn[1], apn[0]);
+    for (size_t i = apn[0] + 1; i < sizeof(apn); i += apn[i] + 1) {
+      bconchar(b, '.');
+      bcatblk(b, &apn[i + 1], apn[i]);
+    }
+    benchmark::DoNotOptimize(b);
+    bdestroy(b);
+  }
+}
+
+void BM_Bstricmp(benchmark::State& state) {
+  bstring apn        = bfromcstr("internet.mnc001.mcc001.gprs");
+  bstring configured = bfromcstr("Internet.MNC001.MCC001.GPRS");
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(bstricmp(apn, configured));
+  }
+  bdestroy(apn);
+  bdestroy(configured);
+}
+
+void BM_Biseq(benchmark::State& state) {
+  std::vector<uint8_t> blk(state.range(0), 0x5a);
+  bstring b0 = blk2bstr(blk.data(), blk.size());
+  bstring b1 = blk2bstr(blk.data(), blk.size());
+
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(biseq(b0, b1));
+  }
+  bdestroy(b0);
+  bdestroy(b1);
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+// From an APN to a full NAS PDU
+BENCHMARK(BM_Blk2bstr)->Arg(8)->Arg(32)->Arg(128)->Arg(512);
+BENCHMARK(BM_Bstrcpy)->Arg(8)->Arg(32)->Arg(128)->Arg(512);
+BENCHMARK(BM_Bcatblk)->Arg(8)->Arg(32)->Arg(128)->Arg(512);
+BENCHMARK(BM_ApnToDotted);
+BENCHMARK(BM_Bstricmp);
+BENCHMARK(BM_Biseq)->Arg(8)->Arg(32)->Arg(128)->Arg(512);
@@ -0,0 +1,213 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <cstring>
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "NwGtpv2c.h"
+#include "NwGtpv2cIe.h"
+#include "NwGtpv2cMsg.h"
+}
+
+/*
+ * Echo round trips between two nw-gtpv2c stacks over loopback, wired up the
+ * way nw-egtping does it. Each iteration sends GTPV2C_ECHO_WINDOW echo
+ * requests from the first stack, on tunnels picked in turn among
+ * state.range(0) local tunnels, and waits for all their responses, so the
+ * tunnel and outstanding transaction tables, the object pools and the
+ * retransmission timers are all on the path.
+ */
+namespace {
+
+#define GTPV2C_ECHO_WINDOW 64
+#define GTPV2C_MAX_DATAGRAM 4096
+
+class Gtpv2cNode {
+ public:
+  Gtpv2cNode() : responses_(0) {
+    socklen_t len          = sizeof(local_);
+    struct timeval timeout = {1, 0};
+    nw_gtpv2c_ulp_entity_t ulp;
+    nw_gtpv2c_udp_entity_t udp;
+    nw_gtpv2c_timer_mgr_entity_t tmr_mgr;
+
+    memset(&local_, 0, sizeof(local_));
+    local_.sin_family      = AF_INET;
+    local_.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    sd_                    = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    bind(sd_, reinterpret_cast<struct sockaddr*>(&local_), sizeof(local_));
+    getsockname(sd_, reinterpret_cast<struct sockaddr*>(&local_), &len);
+    // A lost datagram fails the run instead of hanging it
+    setsockopt(sd_, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    peer_ = local_;
+
+    nwGtpv2cInitialize(&stack_);
+
+    memset(&ulp, 0, sizeof(ulp));
+    ulp.hUlp           = reinterpret_cast<nw_gtpv2c_ulp_handle_t>(this);
+    ulp.ulpReqCallback = UlpReq;
+    nwGtpv2cSetUlpEntity(stack_, &ulp);
+
+    memset(&udp, 0, sizeof(udp));
+    udp.hUdp               = reinterpret_cast<nw_gtpv2c_udp_handle_t>(this);
+    udp.udpDataReqCallback = UdpDataReq;
+    nwGtpv2cSetUdpEntity(stack_, &udp);
+
+    // Nothing times out within a round trip on loopback
+    memset(&tmr_mgr, 0, sizeof(tmr_mgr));
+    tmr_mgr.tmrStartCallback = TimerStart;
+    tmr_mgr.tmrStopCallback  = TimerStop;
+    nwGtpv2cSetTimerMgrEntity(stack_, &tmr_mgr);
+  }
+
+  ~Gtpv2cNode() {
+    nwGtpv2cFinalize(stack_);
+    close(sd_);
+  }
+
+  void Connect(const Gtpv2cNode& peer) { peer_ = peer.local_; }
+
+  void CreateLocalTunnel(uint32_t teid) {
+    nw_gtpv2c_ulp_api_t ulp_req;
+
+    memset(&ulp_req, 0, sizeof(ulp_req));
+    ulp_req.apiType = NW_GTPV2C_ULP_CREATE_LOCAL_TUNNEL;
+    ulp_req.u_api_info.createLocalTunnelInfo.teidLocal = teid;
+    ulp_req.u_api_info.createLocalTunnelInfo.peerIp    = peer();
+    nwGtpv2cProcessUlpReq(stack_, &ulp_req);
+  }
+
+  void SendEchoRequest(uint32_t teid) {
+    nw_gtpv2c_ulp_api_t ulp_req;
+
+    memset(&ulp_req, 0, sizeof(ulp_req));
+    ulp_req.apiType = NW_GTPV2C_ULP_API_INITIAL_REQ;
+    ulp_req.u_api_info.initialReqInfo.teidLocal    = teid;
+    ulp_req.u_api_info.initialReqInfo.edns_peer_ip = peer();
+    nwGtpv2cMsgNew(stack_, false, NW_GTP_ECHO_REQ, 0, 0, &ulp_req.hMsg);
+    nwGtpv2cMsgAddIeTV1(ulp_req.hMsg, NW_GTPV2C_IE_RECOVERY, 0, 0);
+    nwGtpv2cProcessUlpReq(stack_, &ulp_req);
+  }
+
+  // Hands up to count datagrams to the stack, returns how many came in time
+  int Receive(int count) {
+    uint8_t buffer[GTPV2C_MAX_DATAGRAM];
+    struct sockaddr_in from;
+    int received = 0;
+
+    for (; received < count; received++) {
+      socklen_t len = sizeof(from);
+      ssize_t bytes = recvfrom(
+          sd_, buffer, sizeof(buffer), 0,
+          reinterpret_cast<struct sockaddr*>(&from), &len);
+      if (bytes <= 0) {
+        break;
+      }
+      nwGtpv2cProcessUdpReq(
+          stack_, buffer, bytes, ntohs(local_.sin_port), ntohs(from.sin_port),
+          reinterpret_cast<struct sockaddr*>(&from));
+    }
+    return received;
+  }
+
+  uint64_t responses() const { return responses_; }
+
+ private:
+  struct sockaddr* peer() {
+    return reinterpret_cast<struct sockaddr*>(&peer_);
+  }
+
+  static nw_rc_t UlpReq(
+      nw_gtpv2c_ulp_handle_t hUlp, nw_gtpv2c_ulp_api_t* pUlpApi) {
+    Gtpv2cNode* node = reinterpret_cast<Gtpv2cNode*>(hUlp);
+
+    if (pUlpApi->apiType == NW_GTPV2C_ULP_API_TRIGGERED_RSP_IND) {
+      node->responses_++;
+    }
+    if (pUlpApi->hMsg) {
+      nwGtpv2cMsgDelete(node->stack_, pUlpApi->hMsg);
+    }
+    return NW_OK;
+  }
+
+  // Both stacks listen on ephemeral ports, not on the GTPv2-C one
+  static nw_rc_t UdpDataReq(
+      nw_gtpv2c_udp_handle_t hUdp, uint8_t* dataBuf, uint32_t dataSize,
+      uint16_t localPort, struct sockaddr* peerIp, uint16_t peerPort) {
+    Gtpv2cNode* node = reinterpret_cast<Gtpv2cNode*>(hUdp);
+
+    sendto(
+        node->sd_, dataBuf, dataSize, 0, node->peer(), sizeof(node->peer_));
+    return NW_OK;
+  }
+
+  static nw_rc_t TimerStart(
+      nw_gtpv2c_timer_mgr_handle_t tmrMgrHandle, uint32_t timeoutSec,
+      uint32_t timeoutUsec, uint32_t tmrType, void* tmrArg,
+      nw_gtpv2c_timer_handle_t* tmrHandle) {
+    *tmrHandle = 1;
+    return NW_OK;
+  }
+
+  static nw_rc_t TimerStop(
+      nw_gtpv2c_timer_mgr_handle_t tmrMgrHandle,
+      nw_gtpv2c_timer_handle_t tmrHandle) {
+    return NW_OK;
+  }
+
+  nw_gtpv2c_stack_handle_t stack_;
+  int sd_;
+  struct sockaddr_in local_;
+  struct sockaddr_in peer_;
+  uint64_t responses_;
+};
+
+void BM_Gtpv2cEchoRoundTrip(benchmark::State& state) {
+  Gtpv2cNode mme;
+  Gtpv2cNode sgw;
+  uint32_t nb_tunnels = state.range(0);
+  uint32_t next       = 0;
+
+  mme.Connect(sgw);
+  sgw.Connect(mme);
+  for (uint32_t teid = 1; teid <= nb_tunnels; teid++) {
+    mme.CreateLocalTunnel(teid);
+  }
+  for (auto _ : state) {
+    for (int i = 0; i < GTPV2C_ECHO_WINDOW; i++) {
+      mme.SendEchoRequest(1 + next++ % nb_tunnels);
+    }
+    if (sgw.Receive(GTPV2C_ECHO_WINDOW) != GTPV2C_ECHO_WINDOW ||
+        mme.Receive(GTPV2C_ECHO_WINDOW) != GTPV2C_ECHO_WINDOW) {
+      state.SkipWithError("Echo datagram lost");
+      break;
+    }
+  }
+  if (mme.responses() != uint64_t(state.iterations()) * GTPV2C_ECHO_WINDOW) {
+    state.SkipWithError("Echo response not matched to its request");
+  }
+  state.SetItemsProcessed(state.iterations() * GTPV2C_ECHO_WINDOW);
+}
+
+}  // namespace
+
+BENCHMARK(BM_Gtpv2cEchoRoundTrip)->Arg(1000)->Arg(100000);
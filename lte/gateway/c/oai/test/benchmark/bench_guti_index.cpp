@@ -0,0 +1,193 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <random>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "bstrlib.h"
+#include "hashtable.h"
+#include "obj_hashtable.h"
+#include "mme_app_ue_context.h"
+}
+
+/*
+ * Lookup of an idle UE by the GUTI or the S-TMSI it sends, in a table of
+ * state.range(0) UEs sized like the MME ones (one bucket per UE): the GUTI
+ * table with its byte-wise hash and memcmp, against the S-TMSI index.
+ */
+namespace {
+
+struct Ues {
+  std::vector<guti_t> gutis;
+  obj_hash_table_uint64_t* guti_htbl;
+  hash_table_uint64_ts_t* s_tmsi_htbl;
+
+  Ues(int nb_ues, hash_size_t (*hashfunc)(const hash_key_t)) {
+    std::mt19937 random(1);
+    bstring name = bfromcstr("bench");
+
+    gutis.resize(nb_ues);
+    guti_htbl   = obj_hashtable_uint64_ts_create(nb_ues, NULL, NULL, name);
+    s_tmsi_htbl = hashtable_uint64_ts_create(nb_ues, hashfunc, name);
+    for (int i = 0; i < nb_ues; i++) {
+      guti_t* guti                 = &gutis[i];
+      guti->gummei.plmn.mcc_digit1 = 0;
+      guti->gummei.plmn.mcc_digit2 = 0;
+      guti->gummei.plmn.mcc_digit3 = 1;
+      guti->gummei.plmn.mnc_digit1 = 0;
+      guti->gummei.plmn.mnc_digit2 = 1;
+      guti->gummei.plmn.mnc_digit3 = 0xf;
+      guti->gummei.mme_gid         = 1;
+      guti->gummei.mme_code        = 1;
+      guti->m_tmsi                 = random();
+      obj_hashtable_uint64_ts_insert(guti_htbl, guti, sizeof(*guti), i);
+      hashtable_uint64_ts_insert(
+          s_tmsi_htbl,
+          MME_APP_S_TMSI_KEY(guti->gummei.mme_code, guti->m_tmsi), i);
+    }
+    bdestroy(name);
+  }
+
+  ~Ues() {
+    obj_hashtable_uint64_ts_destroy(guti_htbl);
+    hashtable_uint64_ts_destroy(s_tmsi_htbl);
+  }
+};
+
+void BM_GutiLookupGutiTable(benchmark::State& state) {
+  Ues ues(state.range(0), hashtable_uint64_mix_hashfunc);
+  uint64_t mme_ue_s1ap_id = 0;
+  size_t i                = 0;
+
+  for (auto _ : state) {
+    const guti_t* guti = &ues.gutis[i++ % ues.gutis.size()];
+    obj_hashtable_uint64_ts_get(
+        ues.guti_htbl, guti, sizeof(*guti), &mme_ue_s1ap_id);
+    benchmark::DoNotOptimize(mme_ue_s1ap_id);
+  }
+}
+
+void BM_GutiLookupSTmsiIndex(benchmark::State& state) {
+  Ues ues(state.range(0), hashtable_uint64_mix_hashfunc);
+  uint64_t mme_ue_s1ap_id = 0;
+  size_t i                = 0;
+
+  for (auto _ : state) {
+    const guti_t* guti = &ues.gutis[i++ % ues.gutis.size()];
+    hashtable_uint64_ts_get(
+        ues.s_tmsi_htbl,
+        MME_APP_S_TMSI_KEY(guti->gummei.mme_code, guti->m_tmsi),
+        &mme_ue_s1ap_id);
+    benchmark::DoNotOptimize(mme_ue_s1ap_id);
+  }
+}
+
+// Service request: the GUTI is rebuilt from the S-TMSI and the GUMMEI
+void BM_STmsiLookupGutiTable(benchmark::State& state) {
+  Ues ues(state.range(0), hashtable_uint64_mix_hashfunc);
+  uint64_t mme_ue_s1ap_id = 0;
+  size_t i                = 0;
+
+  for (auto _ : state) {
+    const guti_t* ue = &ues.gutis[i++ % ues.gutis.size()];
+    s_tmsi_t s_tmsi  = {ue->gummei.mme_code, ue->m_tmsi};
+    guti_t guti      = {0};
+
+    guti.gummei = ues.gutis[0].gummei;
+    guti.m_tmsi = s_tmsi.m_tmsi;
+    obj_hashtable_uint64_ts_get(
+        ues.guti_htbl, &guti, sizeof(guti), &mme_ue_s1ap_id);
+    benchmark::DoNotOptimize(mme_ue_s1ap_id);
+  }
+}
+
+void BM_STmsiLookupSTmsiIndex(benchmark::State& state) {
+  Ues ues(state.range(0), hashtable_uint64_mix_hashfunc);
+  uint64_t mme_ue_s1ap_id = 0;
+  size_t i                = 0;
+
+  for (auto _ : state) {
+    const guti_t* ue = &ues.gutis[i++ % ues.gutis.size()];
+    s_tmsi_t s_tmsi  = {ue->gummei.mme_code, ue->m_tmsi};
+
+    hashtable_uint64_ts_get(
+        ues.s_tmsi_htbl, MME_APP_S_TMSI_KEY(s_tmsi.mme_code, s_tmsi.m_tmsi),
+        &mme_ue_s1ap_id);
+    benchmark::DoNotOptimize(mme_ue_s1ap_id);
+  }
+}
+
+// Same index with the default identity hash of hashtable_uint64
+void BM_STmsiLookupSTmsiIndexIdentityHash(benchmark::State& state) {
+  Ues ues(state.range(0), NULL);
+  uint64_t mme_ue_s1ap_id = 0;
+  size_t i                = 0;
+
+  for (auto _ : state) {
+    const guti_t* ue = &ues.gutis[i++ % ues.gutis.size()];
+
+    hashtable_uint64_ts_get(
+        ues.s_tmsi_htbl, MME_APP_S_TMSI_KEY(ue->gummei.mme_code, ue->m_tmsi),
+        &mme_ue_s1ap_id);
+    benchmark::DoNotOptimize(mme_ue_s1ap_id);
+  }
+}
+
+// GUTI reallocation: the old GUTI is removed and the new one inserted
+void BM_GutiReallocationGutiTable(benchmark::State& state) {
+  Ues ues(state.range(0), hashtable_uint64_mix_hashfunc);
+  size_t i = 0;
+
+  for (auto _ : state) {
+    guti_t* guti = &ues.gutis[i % ues.gutis.size()];
+
+    obj_hashtable_uint64_ts_remove(ues.guti_htbl, guti, sizeof(*guti));
+    guti->m_tmsi++;
+    obj_hashtable_uint64_ts_insert(ues.guti_htbl, guti, sizeof(*guti), i++);
+  }
+}
+
+void BM_GutiReallocationSTmsiIndex(benchmark::State& state) {
+  Ues ues(state.range(0), hashtable_uint64_mix_hashfunc);
+  size_t i = 0;
+
+  for (auto _ : state) {
+    guti_t* guti = &ues.gutis[i % ues.gutis.size()];
+
+    hashtable_uint64_ts_remove(
+        ues.s_tmsi_htbl,
+        MME_APP_S_TMSI_KEY(guti->gummei.mme_code, guti->m_tmsi));
+    guti->m_tmsi++;
+    hashtable_uint64_ts_insert(
+        ues.s_tmsi_htbl,
+        MME_APP_S_TMSI_KEY(guti->gummei.mme_code, guti->m_tmsi), i++);
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_GutiLookupGutiTable)->Arg(1000)->Arg(10000)->Arg(100000);
+BENCHMARK(BM_GutiLookupSTmsiIndex)->Arg(1000)->Arg(10000)->Arg(100000);
+BENCHMARK(BM_STmsiLookupGutiTable)->Arg(1000)->Arg(10000)->Arg(100000);
+BENCHMARK(BM_STmsiLookupSTmsiIndex)->Arg(1000)->Arg(10000)->Arg(100000);
+BENCHMARK(BM_STmsiLookupSTmsiIndexIdentityHash)
+    ->Arg(1000)
+    ->Arg(10000)
+    ->Arg(100000);
+BENCHMARK(BM_GutiReallocationGutiTable)->Arg(10000);
+BENCHMARK(BM_GutiReallocationSTmsiIndex)->Arg(10000);
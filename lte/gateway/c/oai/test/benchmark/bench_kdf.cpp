@@ -0,0 +1,157 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <vector>
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "secu_defs.h"
+#include "security_types.h"
+#include "3gpp_33.401.h"
+}
+
+/*
+ * Key derivation cost of 3GPP TS 33.401 Annex A, as run for each UE on
+ * attach (KNASenc, KNASint, KeNB) and on each handover (NH), re-keying HMAC
+ * for each key or from the KDF context of the EPS security context.
+ */
+namespace {
+
+const uint8_t kasme[] = {
+    0x23, 0x8e, 0x45, 0x7e, 0x0f, 0x75, 0x8b, 0xad, 0xbc, 0xa8, 0xd3,
+    0x4b, 0xb2, 0x61, 0x2c, 0x10, 0x42, 0x8d, 0x42, 0x6c, 0xb7, 0x6b,
+    0x37, 0x97, 0x1d, 0x56, 0x7d, 0x86, 0x61, 0x73, 0x3a, 0x7c};
+
+void BM_Kdf(benchmark::State& state) {
+  uint8_t s[7]    = {FC_ALG_KEY_DER, NAS_ENC_ALG, 0x00, 0x01,
+                     EEA2_128_ALG_ID, 0x00, 0x01};
+  uint8_t out[32] = {0};
+
+  for (auto _ : state) {
+    kdf(kasme, sizeof(kasme), s, sizeof(s), out, sizeof(out));
+    benchmark::DoNotOptimize(out);
+  }
+}
+
+void BM_DeriveKeyNas(benchmark::State& state) {
+  uint8_t knas[16] = {0};
+
+  for (auto _ : state) {
+    derive_key_nas_enc(EEA2_128_ALG_ID, kasme, knas);
+    benchmark::DoNotOptimize(knas);
+  }
+}
+
+void BM_DeriveKeNB(benchmark::State& state) {
+  uint8_t kenb[32]   = {0};
+  uint32_t nas_count = 0;
+
+  for (auto _ : state) {
+    derive_keNB(kasme, nas_count++, kenb);
+    benchmark::DoNotOptimize(kenb);
+  }
+}
+
+void BM_DeriveNH(benchmark::State& state) {
+  uint8_t next_hop[32]            = {0};
+  uint8_t next_hop_chaining_count = 0;
+
+  derive_keNB(kasme, 0, next_hop);
+  for (auto _ : state) {
+    derive_NH(kasme, next_hop, next_hop, &next_hop_chaining_count);
+    benchmark::DoNotOptimize(next_hop);
+  }
+}
+
+// Keys derived from KASME when a UE attaches
+void BM_AttachKeyDerivation(benchmark::State& state) {
+  uint8_t knas_enc[16] = {0};
+  uint8_t knas_int[16] = {0};
+  uint8_t kenb[32]     = {0};
+  uint8_t next_hop[32] = {0};
+  uint8_t ncc          = 0;
+
+  for (auto _ : state) {
+    derive_key_nas_enc(EEA2_128_ALG_ID, kasme, knas_enc);
+    derive_key_nas_int(EIA2_128_ALG_ID, kasme, knas_int);
+    derive_keNB(kasme, 0, kenb);
+    derive_NH(kasme, kenb, next_hop, &ncc);
+    benchmark::DoNotOptimize(knas_enc);
+    benchmark::DoNotOptimize(knas_int);
+    benchmark::DoNotOptimize(next_hop);
+  }
+}
+
+void BM_AttachKeyDerivationWithContext(benchmark::State& state) {
+  kdf_context_t ctx    = {0};
+  uint8_t knas_enc[16] = {0};
+  uint8_t knas_int[16] = {0};
+  uint8_t kenb[32]     = {0};
+  uint8_t next_hop[32] = {0};
+  uint8_t ncc          = 0;
+
+  for (auto _ : state) {
+    kdf_context_clear(&ctx);
+    kdf_context_set_key(&ctx, kasme);
+    derive_key_nas_with_context(&ctx, NAS_ENC_ALG, EEA2_128_ALG_ID, knas_enc);
+    derive_key_nas_with_context(&ctx, NAS_INT_ALG, EIA2_128_ALG_ID, knas_int);
+    derive_keNB_with_context(&ctx, 0, kenb);
+    derive_NH_chain(&ctx, kenb, 1, next_hop, &ncc);
+    benchmark::DoNotOptimize(knas_enc);
+    benchmark::DoNotOptimize(knas_int);
+    benchmark::DoNotOptimize(next_hop);
+  }
+}
+
+// NH chain of state.range(0) handovers, one derive_NH() per hop
+void BM_NHChainOneShot(benchmark::State& state) {
+  std::vector<uint8_t> next_hops(32 * (state.range(0) + 1));
+  uint8_t ncc = 0;
+
+  derive_keNB(kasme, 0, next_hops.data());
+  for (auto _ : state) {
+    for (int i = 0; i < state.range(0); i++) {
+      derive_NH(kasme, &next_hops[32 * i], &next_hops[32 * (i + 1)], &ncc);
+    }
+    benchmark::DoNotOptimize(next_hops.data());
+  }
+}
+
+void BM_NHChain(benchmark::State& state) {
+  std::vector<uint8_t> next_hops(32 * (state.range(0) + 1));
+  kdf_context_t ctx = {0};
+  uint8_t ncc       = 0;
+
+  derive_keNB(kasme, 0, next_hops.data());
+  for (auto _ : state) {
+    kdf_context_clear(&ctx);
+    kdf_context_set_key(&ctx, kasme);
+    derive_NH_chain(
+        &ctx, next_hops.data(), state.range(0), &next_hops[32], &ncc);
+    benchmark::DoNotOptimize(next_hops.data());
+  }
+}
+
+}  // namespace
+
+BENCHMARK(BM_Kdf);
+BENCHMARK(BM_DeriveKeyNas);
+BENCHMARK(BM_DeriveKeNB);
+BENCHMARK(BM_DeriveNH);
+BENCHMARK(BM_AttachKeyDerivation);
+BENCHMARK(BM_AttachKeyDerivationWithContext);
+BENCHMARK(BM_NHChainOneShot)->Arg(1)->Arg(4)->Arg(8);
+BENCHMARK(BM_NHChain)->Arg(1)->Arg(4)->Arg(8);
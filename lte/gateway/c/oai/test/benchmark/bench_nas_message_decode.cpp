@@ -0,0 +1,124 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <string.h>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "bstrlib.h"
+#include "nas_message.h"
+#include "3gpp_24.008.h"
+}
+
+/*
+ * Decoding cost of the uplink NAS messages that dominate signalling load,
+ * with octet string IEs decoded into heap copies (nas_message_decode()) or
+ * into views backed by a decode arena (nas_message_decode_view()).
+ */
+namespace {
+
+// Attach Request, IMSI 001010000000001, ESM container holding a PDN
+// Connectivity Request with ESM information transfer flag and PCO
+const std::vector<uint8_t> attach_request = {
+    0x07, 0x41, 0x71, 0x08, 0x09, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x10,
+    0x02, 0xe0, 0xe0, 0x00, 0x21, 0x02, 0x01, 0xd0, 0x11, 0xd1, 0x27, 0x1a,
+    0x80, 0x80, 0x21, 0x10, 0x01, 0x00, 0x00, 0x10, 0x81, 0x06, 0x00, 0x00,
+    0x00, 0x00, 0x83, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0d, 0x00, 0x00,
+    0x0a, 0x00, 0x52, 0x00, 0xf1, 0x10, 0x00, 0x01, 0x5c, 0x0a, 0x00, 0x31,
+    0x03, 0xe5, 0xe0, 0x3e, 0x5d, 0x01, 0x03};
+
+// Integrity protected Tracking Area Update Request, old GUTI
+const std::vector<uint8_t> tau_request = {
+    0x17, 0x00, 0x00, 0x00, 0x00, 0x01, 0x07, 0x48, 0x00, 0x0b, 0xf6, 0x00,
+    0xf1, 0x10, 0x80, 0x01, 0x01, 0xc2, 0x00, 0x00, 0x01, 0x58, 0x02, 0xe0,
+    0xe0, 0x52, 0x00, 0xf1, 0x10, 0x00, 0x01, 0x5c, 0x0a, 0x00, 0x57, 0x02,
+    0x20, 0x00, 0x31, 0x03, 0xe5, 0xe0, 0x3e, 0x5d, 0x01, 0x03};
+
+// Standalone PDN Connectivity Request, APN "internet" and PCO
+const std::vector<uint8_t> pdn_connectivity_request = {
+    0x02, 0x01, 0xd0, 0x11, 0x28, 0x09, 0x08, 0x69, 0x6e, 0x74, 0x65,
+    0x72, 0x6e, 0x65, 0x74, 0x27, 0x1a, 0x80, 0x80, 0x21, 0x10, 0x01,
+    0x00, 0x00, 0x10, 0x81, 0x06, 0x00, 0x00, 0x00, 0x00, 0x83, 0x06,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x0d, 0x00, 0x00, 0x0a, 0x00};
+
+// Releases what the decoder may have allocated, no-op for views
+void clear_message(nas_message_t* msg) {
+  // Security protected messages are decoded into msg->plain as well
+  EMM_msg* emm = &msg->plain.emm;
+  ESM_msg* esm = &msg->plain.esm;
+
+  if (emm->header.protocol_discriminator == EPS_MOBILITY_MANAGEMENT_MESSAGE) {
+    if (emm->header.message_type == ATTACH_REQUEST) {
+      bdestroy(emm->attach_request.esmmessagecontainer);
+    } else if (emm->header.message_type == TRACKING_AREA_UPDATE_REQUEST) {
+      bdestroy(emm->tracking_area_update_request.supportedcodecs);
+    }
+  } else if (esm->header.message_type == PDN_CONNECTIVITY_REQUEST) {
+    bdestroy(esm->pdn_connectivity_request.accesspointname);
+    clear_protocol_configuration_options(
+        &esm->pdn_connectivity_request.protocolconfigurationoptions);
+  }
+}
+
+void BM_NasMessageDecode(
+    benchmark::State& state, const std::vector<uint8_t>* pdu) {
+  nas_message_decode_status_t status;
+  nas_message_t msg;
+
+  for (auto _ : state) {
+    memset(&msg, 0, sizeof(msg));
+    memset(&status, 0, sizeof(status));
+    if (nas_message_decode(pdu->data(), &msg, pdu->size(), NULL, &status) <
+        0) {
+      state.SkipWithError("decoding failed");
+      break;
+    }
+    clear_message(&msg);
+  }
+  state.SetBytesProcessed(state.iterations() * pdu->size());
+}
+
+void BM_NasMessageDecodeView(
+    benchmark::State& state, const std::vector<uint8_t>* pdu) {
+  nas_message_decode_arena_t arena;
+  nas_message_decode_status_t status;
+  nas_message_t msg;
+
+  for (auto _ : state) {
+    memset(&msg, 0, sizeof(msg));
+    memset(&status, 0, sizeof(status));
+    if (nas_message_decode_view(
+            pdu->data(), &msg, pdu->size(), NULL, &status, &arena) < 0) {
+      state.SkipWithError("decoding failed");
+      break;
+    }
+    clear_message(&msg);
+  }
+  state.SetBytesProcessed(state.iterations() * pdu->size());
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(BM_NasMessageDecode, attach_request, &attach_request);
+BENCHMARK_CAPTURE(BM_NasMessageDecodeView, attach_request, &attach_request);
+BENCHMARK_CAPTURE(BM_NasMessageDecode, tau_request, &tau_request);
+BENCHMARK_CAPTURE(BM_NasMessageDecodeView, tau_request, &tau_request);
+BENCHMARK_CAPTURE(
+    BM_NasMessageDecode, pdn_connectivity_request, &pdn_connectivity_request);
+BENCHMARK_CAPTURE(
+    BM_NasMessageDecodeView, pdn_connectivity_request,
+    &pdn_connectivity_request);
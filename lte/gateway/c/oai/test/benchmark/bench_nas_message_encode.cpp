@@ -0,0 +1,124 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <string.h>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "bstrlib.h"
+#include "nas_message.h"
+#include "emm_data.h"
+#include "3gpp_24.301.h"
+}
+
+/*
+ * Encoding cost of the downlink NAS messages of the attach procedure, sent
+ * plain or integrity protected and ciphered with 128-EIA2/128-EEA2.
+ * Messages are built once by decoding a reference PDU.
+ */
+namespace {
+
+// Authentication Request, KSI 0
+const std::vector<uint8_t> authentication_request = {
+    0x07, 0x52, 0x00, 0x01, 0x23, 0x45, 0x67, 0x89, 0xab, 0xcd, 0xef,
+    0xfe, 0xdc, 0xba, 0x98, 0x76, 0x54, 0x32, 0x10, 0x10, 0x55, 0x66,
+    0x77, 0x88, 0x99, 0xaa, 0xbb, 0xcc, 0xdd, 0xee, 0xff, 0x00, 0x11,
+    0x22, 0x33, 0x44};
+
+// Security Mode Command selecting 128-EEA2/128-EIA2, IMEISV requested
+const std::vector<uint8_t> security_mode_command = {
+    0x07, 0x5d, 0x22, 0x00, 0x02, 0xe0, 0xe0, 0xc1};
+
+// Attach Accept with GUTI, ESM container holding an Activate Default EPS
+// Bearer Context Request for APN "internet"
+const std::vector<uint8_t> attach_accept = {
+    0x07, 0x42, 0x01, 0x21, 0x06, 0x20, 0x00, 0xf1, 0x10, 0x00, 0x01, 0x00,
+    0x15, 0x52, 0x01, 0xc1, 0x01, 0x09, 0x09, 0x08, 0x69, 0x6e, 0x74, 0x65,
+    0x72, 0x6e, 0x65, 0x74, 0x05, 0x01, 0xc0, 0xa8, 0x80, 0x02, 0x50, 0x0b,
+    0xf6, 0x00, 0xf1, 0x10, 0x80, 0x01, 0x01, 0xc2, 0x00, 0x00, 0x01};
+
+// Activate Default EPS Bearer Context Request for APN "internet"
+const std::vector<uint8_t> activate_default_eps_bearer_context_request = {
+    0x52, 0x01, 0xc1, 0x01, 0x09, 0x09, 0x08, 0x69, 0x6e, 0x74, 0x65,
+    0x72, 0x6e, 0x65, 0x74, 0x05, 0x01, 0xc0, 0xa8, 0x80, 0x02};
+
+const uint8_t knas[] = {0xd3, 0xc5, 0xd5, 0x92, 0x32, 0x7f, 0xb1, 0x1c,
+                        0x40, 0x35, 0xc6, 0x68, 0x0a, 0xf8, 0xc6, 0xd1};
+
+void init_security_context(emm_security_context_t* security) {
+  memset(security, 0, sizeof(*security));
+  security->selected_algorithms.encryption = NAS_SECURITY_ALGORITHMS_EEA2;
+  security->selected_algorithms.integrity  = NAS_SECURITY_ALGORITHMS_EIA2;
+  security->direction_encode               = SECU_DIRECTION_DOWNLINK;
+  security->direction_decode               = SECU_DIRECTION_UPLINK;
+  security->activated                      = 1;
+  memcpy(security->knas_enc, knas, sizeof(knas));
+  memcpy(security->knas_int, knas, sizeof(knas));
+}
+
+void BM_NasMessageEncode(
+    benchmark::State& state, const std::vector<uint8_t>* pdu,
+    uint8_t security_header_type) {
+  std::vector<uint8_t> buffer(256);
+  emm_security_context_t security;
+  nas_message_decode_status_t status = {0};
+  nas_message_t decoded              = {0};
+  nas_message_t msg                  = {0};
+
+  if (nas_message_decode(
+          pdu->data(), &decoded, pdu->size(), NULL, &status) < 0) {
+    state.SkipWithError("decoding failed");
+    return;
+  }
+  init_security_context(&security);
+  if (security_header_type == SECURITY_HEADER_TYPE_NOT_PROTECTED) {
+    msg = decoded;
+  } else {
+    msg.header.protocol_discriminator = EPS_MOBILITY_MANAGEMENT_MESSAGE;
+    msg.header.security_header_type   = security_header_type;
+    msg.security_protected.plain      = decoded.plain;
+  }
+  for (auto _ : state) {
+    security.dl_count.seq_num++;
+    if (nas_message_encode(buffer.data(), &msg, buffer.size(), &security) <=
+        0) {
+      state.SkipWithError("encoding failed");
+      break;
+    }
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  state.SetBytesProcessed(state.iterations() * pdu->size());
+}
+
+}  // namespace
+
+BENCHMARK_CAPTURE(
+    BM_NasMessageEncode, authentication_request, &authentication_request,
+    SECURITY_HEADER_TYPE_NOT_PROTECTED);
+BENCHMARK_CAPTURE(
+    BM_NasMessageEncode, security_mode_command, &security_mode_command,
+    SECURITY_HEADER_TYPE_INTEGRITY_PROTECTED_NEW);
+BENCHMARK_CAPTURE(
+    BM_NasMessageEncode, attach_accept, &attach_accept,
+    SECURITY_HEADER_TYPE_INTEGRITY_PROTECTED_CYPHERED);
+BENCHMARK_CAPTURE(
+    BM_NasMessageEncode, attach_accept_plain, &attach_accept,
+    SECURITY_HEADER_TYPE_NOT_PROTECTED);
+BENCHMARK_CAPTURE(
+    BM_NasMessageEncode, activate_default_eps_bearer_context_request,
+    &activate_default_eps_bearer_context_request,
+    SECURITY_HEADER_TYPE_NOT_PROTECTED);
@@ -0,0 +1,273 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <arpa/inet.h>
+#include <endian.h>
+#include <string.h>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <benchmark/benchmark.h>
+#include <fluid/of13msg.hh>
+
+#include "BatchingMessenger.h"
+#include "GTPApplication.h"
+#include "OpenflowController.h"
+
+/*
+ * Flow programming of GTP tunnel adds by the GTP application, through the
+ * default messenger writing each flow mod on its own and through the
+ * batching messenger cutting batches of state.range(0) messages. The mock
+ * connection appends each write to its output buffer under a lock, as
+ * bufferevent_write() does for a libfluid connection, and the switch
+ * answers each barrier right away.
+ *
+ * Reconciliation of state.range(0) GTP tunnels after a restart with
+ * persisted state, where the switch kept 95% of them and 5% more that are
+ * gone from the SPGW state, against adding every tunnel back. The flow stats
+ * reply of the switch is built beforehand, in parts of up to 64 KB.
+ */
+namespace {
+
+using namespace openflow;
+
+struct MockConnection {
+  fluid_base::OFConnection ofconn;
+  std::mutex output_mutex;
+  std::vector<uint8_t> output;
+  uint64_t writes;
+  uint64_t bytes;
+
+  MockConnection() : ofconn(nullptr, nullptr), writes(0), bytes(0) {}
+
+  void write(const uint8_t* data, size_t len) {
+    std::lock_guard<std::mutex> lock(output_mutex);
+    // Drained by the socket
+    if (output.size() > (1 << 20)) {
+      output.clear();
+    }
+    output.insert(output.end(), data, data + len);
+    writes++;
+    bytes += len;
+  }
+};
+
+class UnbatchedMessenger : public DefaultMessenger {
+ public:
+  explicit UnbatchedMessenger(MockConnection* conn) : conn_(conn) {}
+
+  void send_of_msg(
+      fluid_msg::OFMsg& of_msg, fluid_base::OFConnection* ofconn) const {
+    uint8_t* buffer = of_msg.pack();
+    conn_->write(buffer, of_msg.length());
+    fluid_msg::OFMsg::free_buffer(buffer);
+  }
+
+ private:
+  MockConnection* conn_;
+};
+
+class MockBatchingMessenger : public BatchingMessenger {
+ public:
+  MockBatchingMessenger(uint32_t max_batch_size, MockConnection* conn)
+      : BatchingMessenger(max_batch_size), conn_(conn) {}
+
+  // Answers the barriers of the batches written so far
+  void reply_barriers() {
+    std::vector<uint32_t> xids;
+    xids.swap(barrier_xids_);
+    for (uint32_t xid : xids) {
+      handle_barrier_reply(xid);
+    }
+  }
+
+ protected:
+  void write(
+      fluid_base::OFConnection* ofconn, uint8_t* data,
+      size_t len) const override {
+    auto barrier = reinterpret_cast<const struct ofp_header*>(
+        data + len - sizeof(struct ofp_header));
+    conn_->write(data, len);
+    barrier_xids_.push_back(ntohl(barrier->xid));
+  }
+
+ private:
+  MockConnection* conn_;
+  mutable std::vector<uint32_t> barrier_xids_;
+};
+
+void add_tunnels(
+    benchmark::State& state, OpenflowController* ctrl,
+    MockConnection* conn, MockBatchingMessenger* batching_messenger) {
+  GTPApplication gtp_app("1.2.3.4.5.6", 32768, 15577, 15578, 201, 1);
+  struct in_addr ue_ip;
+  struct in_addr enb_ip;
+  uint32_t tei = 1;
+
+  ctrl->register_for_event(&gtp_app, EVENT_ADD_GTP_TUNNEL);
+  inet_pton(AF_INET, "192.168.128.12", &ue_ip);
+  inet_pton(AF_INET, "10.0.2.1", &enb_ip);
+  for (auto _ : state) {
+    AddGTPTunnelEvent add_tunnel(
+        ue_ip, nullptr, 0, enb_ip, tei, tei, "001010000000001", 32768);
+    add_tunnel.set_of_connection(&conn->ofconn);
+    ctrl->dispatch_event(add_tunnel);
+    if (batching_messenger) {
+      batching_messenger->on_batch_completion(
+          &conn->ofconn, [](bool success) {});
+      batching_messenger->reply_barriers();
+    }
+    tei++;
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.counters["writes_per_tunnel"] =
+      (double) conn->writes / state.iterations();
+}
+
+void BM_AddTunnelUnbatched(benchmark::State& state) {
+  MockConnection conn;
+  std::shared_ptr<UnbatchedMessenger> messenger(
+      new UnbatchedMessenger(&conn));
+  OpenflowController ctrl("127.0.0.1", 6654, 1, false, messenger);
+
+  add_tunnels(state, &ctrl, &conn, nullptr);
+}
+
+void BM_AddTunnelBatched(benchmark::State& state) {
+  MockConnection conn;
+  std::shared_ptr<MockBatchingMessenger> messenger(
+      new MockBatchingMessenger(state.range(0), &conn));
+  OpenflowController ctrl("127.0.0.1", 6654, 1, false, messenger);
+
+  add_tunnels(state, &ctrl, &conn, messenger.get());
+}
+
+std::shared_ptr<AddGTPTunnelEvent> tunnel_event(
+    uint32_t tei, MockConnection* conn) {
+  struct in_addr ue_ip;
+  struct in_addr enb_ip;
+
+  ue_ip.s_addr = htonl(0xc0a80000 + tei);
+  inet_pton(AF_INET, "10.0.2.1", &enb_ip);
+  auto tunnel = std::make_shared<AddGTPTunnelEvent>(
+      ue_ip, nullptr, 0, enb_ip, tei, tei, "001010000000001", 32768);
+  tunnel->set_of_connection(&conn->ofconn);
+  return tunnel;
+}
+
+void append_flow_stats(std::vector<uint8_t>& part, uint64_t cookie) {
+  // Flow stats with an empty match, on table 0
+  uint8_t stats[56]  = {0};
+  uint16_t length    = htons(sizeof(stats));
+  uint16_t priority  = htons(10);
+  uint64_t be_cookie = htobe64(cookie);
+  uint16_t match_len = htons(4);
+  memcpy(&stats[0], &length, sizeof(length));
+  memcpy(&stats[12], &priority, sizeof(priority));
+  memcpy(&stats[24], &be_cookie, sizeof(be_cookie));
+  stats[49] = 1;
+  memcpy(&stats[50], &match_len, sizeof(match_len));
+  part.insert(part.end(), stats, stats + sizeof(stats));
+}
+
+/*
+ * Flow stats reply of a switch with the flows of the tunnels of TEI 1 to
+ * nb_tunnels, but every 20th, and of nb_tunnels / 20 tunnels after them
+ */
+std::vector<std::vector<uint8_t>> flow_stats_reply(uint32_t nb_tunnels) {
+  std::vector<std::vector<uint8_t>> parts;
+  for (uint32_t tei = 1; tei <= nb_tunnels + nb_tunnels / 20; tei++) {
+    if (tei <= nb_tunnels && tei % 20 == 0) {
+      continue;
+    }
+    if (parts.empty() || parts.back().size() > 65535 - 5 * 56) {
+      parts.emplace_back(16, 0);
+      parts.back()[1] = 19;
+      parts.back()[9] = 1;
+    }
+    struct in_addr ue_ip;
+    ue_ip.s_addr = htonl(0xc0a80000 + tei);
+    for (int i = 0; i < 3; i++) {
+      append_flow_stats(parts.back(), GTPApplication::tunnel_cookie(tei));
+    }
+    for (int i = 0; i < 2; i++) {
+      append_flow_stats(parts.back(), GTPApplication::arp_cookie(ue_ip));
+    }
+  }
+  for (size_t i = 0; i < parts.size(); i++) {
+    uint16_t length = htons(parts[i].size());
+    memcpy(&parts[i][2], &length, sizeof(length));
+    // OFPMPF_REPLY_MORE
+    parts[i][11] = i + 1 < parts.size();
+  }
+  return parts;
+}
+
+void BM_ReconcileTunnels(benchmark::State& state) {
+  MockConnection conn;
+  std::shared_ptr<MockBatchingMessenger> messenger(
+      new MockBatchingMessenger(
+          BatchingMessenger::DEFAULT_MAX_BATCH_SIZE, &conn));
+  GTPApplication gtp_app("1.2.3.4.5.6", 32768, 15577, 15578, 201, 1);
+  auto reply = flow_stats_reply(state.range(0));
+
+  for (auto _ : state) {
+    std::vector<std::shared_ptr<AddGTPTunnelEvent>> tunnels;
+    for (uint32_t tei = 1; tei <= state.range(0); tei++) {
+      tunnels.push_back(tunnel_event(tei, &conn));
+    }
+    ReconcileGTPTunnelsEvent reconcile(std::move(tunnels));
+    reconcile.set_of_connection(&conn.ofconn);
+    gtp_app.start_reconciliation(reconcile, *messenger);
+    messenger->flush(&conn.ofconn);
+    for (const auto& part : reply) {
+      gtp_app.handle_flow_stats_reply(
+          &conn.ofconn, part.data(), part.size(), *messenger);
+    }
+    messenger->flush(&conn.ofconn);
+    messenger->reply_barriers();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["bytes_written"] = (double) conn.bytes / state.iterations();
+}
+
+void BM_ReaddTunnels(benchmark::State& state) {
+  MockConnection conn;
+  std::shared_ptr<MockBatchingMessenger> messenger(
+      new MockBatchingMessenger(
+          BatchingMessenger::DEFAULT_MAX_BATCH_SIZE, &conn));
+  OpenflowController ctrl("127.0.0.1", 6654, 1, false, messenger);
+  GTPApplication gtp_app("1.2.3.4.5.6", 32768, 15577, 15578, 201, 1);
+
+  ctrl.register_for_event(&gtp_app, EVENT_ADD_GTP_TUNNEL);
+  for (auto _ : state) {
+    for (uint32_t tei = 1; tei <= state.range(0); tei++) {
+      ctrl.dispatch_event(*tunnel_event(tei, &conn));
+      messenger->on_batch_completion(&conn.ofconn, [](bool success) {});
+    }
+    messenger->flush(&conn.ofconn);
+    messenger->reply_barriers();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["bytes_written"] = (double) conn.bytes / state.iterations();
+}
+
+}  // namespace
+
+BENCHMARK(BM_AddTunnelUnbatched);
+BENCHMARK(BM_AddTunnelBatched)->Arg(1)->Arg(16)->Arg(128)->Arg(512);
+BENCHMARK(BM_ReconcileTunnels)->Arg(50000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ReaddTunnels)->Arg(50000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,76 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <vector>
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "bstrlib.h"
+#include "TLVDecoder.h"
+#include "TLVEncoder.h"
+}
+
+/*
+ * Cost of the octet string helpers every NAS IE codec goes through, for IE
+ * sizes from an APN to an ESM message container.
+ */
+namespace {
+
+void BM_EncodeBstring(benchmark::State& state) {
+  std::vector<uint8_t> value(state.range(0), 0x5a);
+  std::vector<uint8_t> buffer(state.range(0));
+  bstring str = blk2bstr(value.data(), value.size());
+
+  for (auto _ : state) {
+    encode_bstring(str, buffer.data(), buffer.size());
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  bdestroy(str);
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void BM_DecodeBstring(benchmark::State& state) {
+  std::vector<uint8_t> buffer(state.range(0), 0x5a);
+  bstring str = NULL;
+
+  for (auto _ : state) {
+    decode_bstring(&str, buffer.size(), buffer.data(), buffer.size());
+    benchmark::DoNotOptimize(str);
+    bdestroy(str);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+void BM_DecodeBstringView(benchmark::State& state) {
+  std::vector<uint8_t> buffer(state.range(0), 0x5a);
+  tlv_decode_arena_t arena;
+  tlv_decode_arena_t* previous = NULL;
+  bstring str                  = NULL;
+
+  for (auto _ : state) {
+    previous = tlv_decode_arena_install(&arena);
+    decode_bstring(&str, buffer.size(), buffer.data(), buffer.size());
+    benchmark::DoNotOptimize(str);
+    tlv_decode_arena_install(previous);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+}  // namespace
+
+BENCHMARK(BM_EncodeBstring)->Arg(8)->Arg(32)->Arg(128)->Arg(512);
+BENCHMARK(BM_DecodeBstring)->Arg(8)->Arg(32)->Arg(128)->Arg(512);
+BENCHMARK(BM_DecodeBstringView)->Arg(8)->Arg(32)->Arg(128)->Arg(512);
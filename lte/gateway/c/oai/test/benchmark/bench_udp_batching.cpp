@@ -0,0 +1,118 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cstring>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+extern "C" {
+#include "udp_batch.h"
+}
+
+/*
+ * S11 datagrams through loopback, one sendto()/recvfrom() per datagram
+ * against the sendmmsg()/recvmmsg() batches of the UDP task. Each iteration
+ * moves UDP_BATCH_SIZE datagrams of state.range(0) bytes.
+ */
+namespace {
+
+class Loopback {
+ public:
+  Loopback() {
+    socklen_t len = sizeof(peer_);
+
+    memset(&peer_, 0, sizeof(peer_));
+    peer_.sin_family      = AF_INET;
+    peer_.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    tx_ = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    rx_ = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    bind(rx_, reinterpret_cast<struct sockaddr*>(&peer_), sizeof(peer_));
+    getsockname(rx_, reinterpret_cast<struct sockaddr*>(&peer_), &len);
+  }
+
+  ~Loopback() {
+    close(tx_);
+    close(rx_);
+  }
+
+  const struct sockaddr* peer() const {
+    return reinterpret_cast<const struct sockaddr*>(&peer_);
+  }
+
+  int tx_;
+  int rx_;
+
+ private:
+  struct sockaddr_in peer_;
+};
+
+void BM_UdpPerDatagram(benchmark::State& state) {
+  Loopback loopback;
+  std::vector<uint8_t> datagram(state.range(0), 0x48);
+  uint8_t buffer[UDP_DATA_MAX_MSG_LEN];
+  udp_address_t from;
+
+  for (auto _ : state) {
+    for (int i = 0; i < UDP_BATCH_SIZE; i++) {
+      sendto(
+          loopback.tx_, datagram.data(), datagram.size(), 0, loopback.peer(),
+          sizeof(struct sockaddr_in));
+    }
+    for (int i = 0; i < UDP_BATCH_SIZE; i++) {
+      socklen_t len = sizeof(from);
+      recvfrom(loopback.rx_, buffer, sizeof(buffer), 0, &from.sa, &len);
+    }
+    benchmark::DoNotOptimize(buffer);
+  }
+  state.SetItemsProcessed(state.iterations() * UDP_BATCH_SIZE);
+}
+
+void BM_UdpBatched(benchmark::State& state) {
+  Loopback loopback;
+  std::vector<uint8_t> datagram(state.range(0), 0x48);
+  std::vector<uint8_t> buffers(UDP_BATCH_SIZE * UDP_DATA_MAX_MSG_LEN);
+  std::vector<udp_address_t> from(UDP_BATCH_SIZE);
+  udp_send_batch_t* send_batch = new udp_send_batch_t();
+  udp_recv_batch_t recv_batch;
+
+  for (int i = 0; i < UDP_BATCH_SIZE; i++) {
+    udp_recv_batch_set_slot(
+        &recv_batch, i, &buffers[i * UDP_DATA_MAX_MSG_LEN],
+        UDP_DATA_MAX_MSG_LEN, &from[i]);
+  }
+  for (auto _ : state) {
+    for (int i = 0; i < UDP_BATCH_SIZE; i++) {
+      udp_send_batch_add(
+          send_batch, datagram.data(), datagram.size(), loopback.peer());
+    }
+    udp_send_batch_flush(loopback.tx_, send_batch);
+    for (int received = 0; received < UDP_BATCH_SIZE;) {
+      received += udp_recv_batch(loopback.rx_, &recv_batch, 0);
+    }
+    benchmark::DoNotOptimize(buffers.data());
+  }
+  state.SetItemsProcessed(state.iterations() * UDP_BATCH_SIZE);
+  delete send_batch;
+}
+
+}  // namespace
+
+BENCHMARK(BM_UdpPerDatagram)->Arg(120)->Arg(1400);
+BENCHMARK(BM_UdpBatched)->Arg(120)->Arg(1400);
@@ -0,0 +1,171 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <arpa/inet.h>
+#include <gtest/gtest.h>
+
+#include "UeIpLeasePool.h"
+
+using ::testing::Test;
+using magma::lte::UeIpLeasePool;
+
+namespace {
+
+const std::string APN  = "internet";
+const std::string IMSI = "001010000000001";
+
+UeIpLeasePool::Lease make_lease(const std::string& lease_id, const char* ip) {
+  UeIpLeasePool::Lease lease;
+  lease.lease_id = lease_id;
+  inet_pton(AF_INET, ip, &lease.addr);
+  return lease;
+}
+
+void reserve_all(UeIpLeasePool* pool, uint32_t* next_ip) {
+  for (const auto& lease_id : pool->leases_to_reserve(APN)) {
+    std::string ip = "192.168.128." + std::to_string((*next_ip)++);
+    UeIpLeasePool::Lease lease = make_lease(lease_id, ip.c_str());
+    pool->reserved(APN, &lease);
+  }
+}
+
+TEST(UeIpLeasePoolTest, TestDisabled) {
+  UeIpLeasePool pool(0);
+  UeIpLeasePool::Lease lease;
+
+  EXPECT_FALSE(pool.enabled());
+  EXPECT_TRUE(pool.leases_to_reserve(APN).empty());
+  EXPECT_FALSE(pool.take(APN, IMSI, &lease));
+}
+
+TEST(UeIpLeasePoolTest, TestRefill) {
+  UeIpLeasePool pool(4);
+  UeIpLeasePool::Lease lease;
+  uint32_t next_ip = 1;
+
+  EXPECT_FALSE(pool.take(APN, IMSI, &lease));
+  auto lease_ids = pool.leases_to_reserve(APN);
+  ASSERT_EQ(lease_ids.size(), 4);
+  EXPECT_TRUE(UeIpLeasePool::is_lease_id(lease_ids[0]));
+  EXPECT_NE(lease_ids[0], lease_ids[1]);
+  // Pending reservations count as available
+  EXPECT_TRUE(pool.leases_to_reserve(APN).empty());
+  for (const auto& lease_id : lease_ids) {
+    std::string ip = "192.168.128." + std::to_string(next_ip++);
+    UeIpLeasePool::Lease reserved = make_lease(lease_id, ip.c_str());
+    pool.reserved(APN, &reserved);
+  }
+  EXPECT_EQ(pool.free_leases(APN), 4);
+
+  EXPECT_TRUE(pool.take(APN, IMSI, &lease));
+  EXPECT_TRUE(pool.leases_to_reserve(APN).empty());
+  EXPECT_TRUE(pool.take(APN, IMSI, &lease));
+  // Half of the pool gone
+  EXPECT_EQ(pool.leases_to_reserve(APN).size(), 2);
+  EXPECT_EQ(pool.leased(), 2);
+}
+
+TEST(UeIpLeasePoolTest, TestFailedReservation) {
+  UeIpLeasePool pool(2);
+
+  EXPECT_EQ(pool.leases_to_reserve(APN).size(), 2);
+  pool.reserved(APN, nullptr);
+  pool.reserved(APN, nullptr);
+  EXPECT_EQ(pool.free_leases(APN), 0);
+  EXPECT_EQ(pool.leases_to_reserve(APN).size(), 2);
+}
+
+TEST(UeIpLeasePoolTest, TestGiveBackAndRelease) {
+  UeIpLeasePool pool(2);
+  UeIpLeasePool::Lease lease;
+  struct in_addr other;
+  uint32_t next_ip = 1;
+  std::vector<UeIpLeasePool::Lease> leases;
+
+  inet_pton(AF_INET, "10.0.0.1", &other);
+  EXPECT_FALSE(pool.give_back(APN, other));
+
+  // Take 5 leases, the pool refilling as it goes
+  for (int i = 0; i < 5; i++) {
+    reserve_all(&pool, &next_ip);
+    ASSERT_TRUE(pool.take(APN, IMSI, &lease));
+    leases.push_back(lease);
+  }
+  EXPECT_TRUE(pool.leases_to_release(APN).empty());
+  for (const auto& taken : leases) {
+    EXPECT_TRUE(pool.give_back(APN, taken.addr));
+    EXPECT_FALSE(pool.give_back(APN, taken.addr));
+  }
+  EXPECT_EQ(pool.leased(), 0);
+  // Above twice the pool size, released down to the pool size
+  uint32_t free_leases = pool.free_leases(APN);
+  ASSERT_GT(free_leases, 4);
+  EXPECT_EQ(pool.leases_to_release(APN).size(), free_leases - 2);
+  EXPECT_EQ(pool.free_leases(APN), 2);
+}
+
+TEST(UeIpLeasePoolTest, TestFindSubscriber) {
+  UeIpLeasePool pool(2);
+  UeIpLeasePool::Lease lease;
+  std::string subscriber_id;
+  uint32_t next_ip = 1;
+
+  reserve_all(&pool, &next_ip);
+  ASSERT_TRUE(pool.take(APN, IMSI, &lease));
+  EXPECT_EQ(lease.subscriber_id, IMSI);
+  EXPECT_TRUE(pool.find_subscriber(lease.addr, &subscriber_id));
+  EXPECT_EQ(subscriber_id, IMSI);
+
+  // Free leases are not handed to anyone
+  EXPECT_TRUE(pool.give_back(APN, lease.addr));
+  EXPECT_FALSE(pool.find_subscriber(lease.addr, &subscriber_id));
+  ASSERT_TRUE(pool.take(APN, "001010000000002", &lease));
+  EXPECT_TRUE(pool.find_subscriber(lease.addr, &subscriber_id));
+  EXPECT_EQ(subscriber_id, "001010000000002");
+}
+
+TEST(UeIpLeasePoolTest, TestAdopt) {
+  UeIpLeasePool pool(2);
+  UeIpLeasePool::Lease lease;
+
+  EXPECT_FALSE(UeIpLeasePool::is_lease_id("IMSI001010000000001"));
+  lease               = make_lease("LEASE7", "192.168.128.7");
+  lease.subscriber_id = IMSI;
+  pool.adopt(APN, lease, true);
+  pool.adopt(APN, make_lease("LEASE3", "192.168.128.3"), false);
+  EXPECT_EQ(pool.leased(), 1);
+  EXPECT_EQ(pool.free_leases(APN), 1);
+
+  // New lease IDs do not collide with the adopted ones
+  auto lease_ids = pool.leases_to_reserve(APN);
+  ASSERT_EQ(lease_ids.size(), 1);
+  EXPECT_EQ(lease_ids[0], "LEASE8");
+
+  EXPECT_TRUE(pool.take(APN, IMSI, &lease));
+  EXPECT_EQ(lease.lease_id, "LEASE3");
+  lease = make_lease("", "192.168.128.7");
+  std::string subscriber_id;
+  EXPECT_TRUE(pool.find_subscriber(lease.addr, &subscriber_id));
+  EXPECT_EQ(subscriber_id, IMSI);
+  EXPECT_TRUE(pool.give_back(APN, lease.addr));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
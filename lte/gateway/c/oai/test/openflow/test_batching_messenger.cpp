@@ -0,0 +1,205 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <vector>
+#include <gtest/gtest.h>
+#include <fluid/of13msg.hh>
+#include "BatchingMessenger.h"
+
+using ::testing::Test;
+using namespace fluid_msg;
+using namespace openflow;
+
+namespace {
+
+const uint8_t OFPT_FLOW_MOD_TYPE        = 14;
+const uint8_t OFPT_BARRIER_REQUEST_TYPE = 20;
+
+struct Message {
+  uint8_t type;
+  uint32_t xid;
+};
+
+/**
+ * Batching messenger keeping the messages of each write
+ */
+class RecordingMessenger : public BatchingMessenger {
+ public:
+  explicit RecordingMessenger(uint32_t max_batch_size)
+      : BatchingMessenger(max_batch_size) {}
+
+  std::vector<std::vector<Message>> writes;
+
+ protected:
+  void write(
+      fluid_base::OFConnection* ofconn, uint8_t* data,
+      size_t len) const override {
+    std::vector<Message> messages;
+    size_t offset = 0;
+    while (offset < len) {
+      auto header = reinterpret_cast<struct ofp_header*>(data + offset);
+      messages.push_back({header->type, ntohl(header->xid)});
+      offset += ntohs(header->length);
+    }
+    const_cast<RecordingMessenger*>(this)->writes.push_back(messages);
+  }
+};
+
+class BatchingMessengerTest : public ::testing::Test {
+ protected:
+  BatchingMessengerTest()
+      : ofconn(nullptr, nullptr), other_ofconn(nullptr, nullptr) {}
+
+  void send_flow_mods(
+      RecordingMessenger& messenger, fluid_base::OFConnection* conn, int n) {
+    for (int i = 0; i < n; i++) {
+      of13::FlowMod fm =
+          messenger.create_default_flow_mod(0, of13::OFPFC_ADD, 10);
+      messenger.send_of_msg(fm, conn);
+    }
+  }
+
+  fluid_base::OFConnection ofconn;
+  fluid_base::OFConnection other_ofconn;
+};
+
+TEST_F(BatchingMessengerTest, TestCoalesce) {
+  RecordingMessenger messenger(512);
+
+  send_flow_mods(messenger, &ofconn, 3);
+  send_flow_mods(messenger, &other_ofconn, 1);
+  EXPECT_TRUE(messenger.writes.empty());
+
+  messenger.flush(&ofconn);
+  ASSERT_EQ(messenger.writes.size(), 1);
+  const auto batch = messenger.writes[0];
+  ASSERT_EQ(batch.size(), 4);
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(batch[i].type, OFPT_FLOW_MOD_TYPE);
+    EXPECT_EQ(batch[i].xid, batch[3].xid);
+  }
+  EXPECT_EQ(batch[3].type, OFPT_BARRIER_REQUEST_TYPE);
+  EXPECT_EQ(messenger.batches_in_flight(), 1);
+
+  // Nothing left for the connection
+  messenger.flush(&ofconn);
+  EXPECT_EQ(messenger.writes.size(), 1);
+
+  messenger.flush(&other_ofconn);
+  ASSERT_EQ(messenger.writes.size(), 2);
+  EXPECT_EQ(messenger.writes[1].size(), 2);
+  EXPECT_NE(messenger.writes[1][0].xid, batch[3].xid);
+}
+
+TEST_F(BatchingMessengerTest, TestCompletion) {
+  RecordingMessenger messenger(512);
+  std::vector<bool> results;
+  auto record = [&results](bool success) { results.push_back(success); };
+
+  // Nothing sent: complete right away
+  messenger.on_batch_completion(&ofconn, record);
+  ASSERT_EQ(results.size(), 1);
+  EXPECT_TRUE(results[0]);
+
+  send_flow_mods(messenger, &ofconn, 2);
+  messenger.on_batch_completion(&ofconn, record);
+  send_flow_mods(messenger, &ofconn, 1);
+  messenger.on_batch_completion(&ofconn, record);
+  messenger.flush(&ofconn);
+  EXPECT_EQ(results.size(), 1);
+
+  uint32_t xid = messenger.writes[0].back().xid;
+  messenger.handle_barrier_reply(xid + 1);
+  EXPECT_EQ(results.size(), 1);
+  messenger.handle_barrier_reply(xid);
+  ASSERT_EQ(results.size(), 3);
+  EXPECT_TRUE(results[1]);
+  EXPECT_TRUE(results[2]);
+  EXPECT_EQ(messenger.batches_in_flight(), 0);
+}
+
+TEST_F(BatchingMessengerTest, TestError) {
+  RecordingMessenger messenger(512);
+  std::vector<bool> results;
+  auto record = [&results](bool success) { results.push_back(success); };
+
+  send_flow_mods(messenger, &ofconn, 2);
+  messenger.on_batch_completion(&ofconn, record);
+  messenger.flush(&ofconn);
+  send_flow_mods(messenger, &ofconn, 2);
+  messenger.on_batch_completion(&ofconn, record);
+  messenger.flush(&ofconn);
+
+  // The switch answers the barrier after the error of the failed flow mod
+  uint32_t failed_xid = messenger.writes[0].back().xid;
+  messenger.handle_error(failed_xid);
+  messenger.handle_barrier_reply(failed_xid);
+  messenger.handle_barrier_reply(messenger.writes[1].back().xid);
+  ASSERT_EQ(results.size(), 2);
+  EXPECT_FALSE(results[0]);
+  EXPECT_TRUE(results[1]);
+}
+
+TEST_F(BatchingMessengerTest, TestMaxBatchSize) {
+  RecordingMessenger messenger(4);
+  std::vector<bool> results;
+  auto record = [&results](bool success) { results.push_back(success); };
+
+  // Batches are cut between events only
+  send_flow_mods(messenger, &ofconn, 3);
+  messenger.on_batch_completion(&ofconn, record);
+  EXPECT_TRUE(messenger.writes.empty());
+  send_flow_mods(messenger, &ofconn, 3);
+  messenger.on_batch_completion(&ofconn, record);
+  ASSERT_EQ(messenger.writes.size(), 1);
+  EXPECT_EQ(messenger.writes[0].size(), 7);
+
+  send_flow_mods(messenger, &ofconn, 1);
+  messenger.on_batch_completion(&ofconn, record);
+  EXPECT_EQ(messenger.writes.size(), 1);
+}
+
+TEST_F(BatchingMessengerTest, TestSwitchDown) {
+  RecordingMessenger messenger(512);
+  std::vector<bool> results;
+  auto record = [&results](bool success) { results.push_back(success); };
+
+  send_flow_mods(messenger, &ofconn, 1);
+  messenger.on_batch_completion(&ofconn, record);
+  messenger.flush(&ofconn);
+  send_flow_mods(messenger, &ofconn, 1);
+  messenger.on_batch_completion(&ofconn, record);
+  send_flow_mods(messenger, &other_ofconn, 1);
+  messenger.on_batch_completion(&other_ofconn, record);
+
+  messenger.handle_switch_down(&ofconn);
+  ASSERT_EQ(results.size(), 2);
+  EXPECT_FALSE(results[0]);
+  EXPECT_FALSE(results[1]);
+
+  // The batch of the switch down connection is not written afterwards
+  messenger.flush(&ofconn);
+  EXPECT_EQ(messenger.writes.size(), 1);
+  messenger.flush(&other_ofconn);
+  EXPECT_EQ(messenger.writes.size(), 2);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -14,7 +14,9 @@
  * For more information about the OpenAirInterface (OAI) Software Alliance:
  *      contact@openairinterface.org
  */
+#include <endian.h>
 #include <string.h>
+#include <vector>
 #include <gtest/gtest.h>
 #include <fluid/of10msg.hh>
 #include <fluid/of13msg.hh>
@@ -883,6 +885,173 @@ TEST_F(GTPApplicationTest, TestDeleteTunnelDlFlowIpv6) {
   controller->dispatch_event(del_tunnel);
 }
 
+// Matchers for the reconciliation, on messages of any type
+
+MATCHER_P2(CheckFlowModCookie, command_type, cookie, "") {
+  if (arg.type() != of13::OFPT_FLOW_MOD) {
+    return false;
+  }
+  auto msg = static_cast<of13::FlowMod*>(&arg);
+  return msg->command() == command_type && msg->cookie() == cookie;
+}
+
+MATCHER(IsMultipartRequest, "") {
+  return arg.type() == of13::OFPT_MULTIPART_REQUEST;
+}
+
+/*
+ * Builds a flow stats multipart reply, flows are appended with
+ * append_flow_stats
+ */
+static std::vector<uint8_t> flow_stats_reply() {
+  std::vector<uint8_t> reply(16, 0);
+  reply[0] = 4;   // OpenFlow 1.3
+  reply[1] = 19;  // OFPT_MULTIPART_REPLY
+  reply[9] = 1;   // OFPMP_FLOW
+  return reply;
+}
+
+static void append_flow_stats(
+    std::vector<uint8_t>& reply, uint64_t cookie, uint16_t priority,
+    const std::vector<uint8_t>& oxm_fields = {}) {
+  // ofp_match of type OXM, padded to 8 bytes
+  uint16_t match_len = 4 + oxm_fields.size();
+  std::vector<uint8_t> stats(48 + (match_len + 7) / 8 * 8, 0);
+  uint16_t length       = htons(stats.size());
+  uint16_t be_priority  = htons(priority);
+  uint64_t be_cookie    = htobe64(cookie);
+  uint16_t be_match_len = htons(match_len);
+  memcpy(&stats[0], &length, sizeof(length));
+  memcpy(&stats[12], &be_priority, sizeof(be_priority));
+  memcpy(&stats[24], &be_cookie, sizeof(be_cookie));
+  stats[49] = 1;
+  memcpy(&stats[50], &be_match_len, sizeof(be_match_len));
+  std::copy(oxm_fields.begin(), oxm_fields.end(), stats.begin() + 52);
+  reply.insert(reply.end(), stats.begin(), stats.end());
+  uint16_t reply_len = htons(reply.size());
+  memcpy(&reply[2], &reply_len, sizeof(reply_len));
+}
+
+static std::shared_ptr<AddGTPTunnelEvent> reconciled_tunnel(
+    const char* ue, uint32_t in_tei) {
+  struct in_addr ue_ip;
+  ue_ip.s_addr = inet_addr(ue);
+  struct in_addr enb_ip;
+  enb_ip.s_addr = inet_addr("192.168.60.141");
+  return std::make_shared<AddGTPTunnelEvent>(
+      ue_ip, nullptr, 0, enb_ip, in_tei, in_tei + 100, "001010000000013", 0);
+}
+
+/*
+ * Test that reconciliation adds the tunnels missing from the switch,
+ * deletes the stale ones and the flows without cookie, and leaves the
+ * installed ones alone
+ */
+TEST_F(GTPApplicationTest, TestReconcileTunnels) {
+  struct in_addr ue_ip1, ue_ip2, ue_ip3;
+  ue_ip1.s_addr = inet_addr("192.168.128.1");
+  ue_ip2.s_addr = inet_addr("192.168.128.2");
+  ue_ip3.s_addr = inet_addr("192.168.128.3");
+  controller->register_for_event(
+      gtp_app, openflow::EVENT_RECONCILE_GTP_TUNNELS);
+  ReconcileGTPTunnelsEvent reconcile(
+      {reconciled_tunnel("192.168.128.1", 1),
+       reconciled_tunnel("192.168.128.2", 2)});
+
+  std::vector<uint8_t> reply = flow_stats_reply();
+  for (int i = 0; i < 3; i++) {
+    append_flow_stats(reply, GTPApplication::tunnel_cookie(1), 10);
+  }
+  append_flow_stats(reply, GTPApplication::arp_cookie(ue_ip1), 10);
+  append_flow_stats(reply, GTPApplication::arp_cookie(ue_ip1), 10);
+  append_flow_stats(reply, GTPApplication::tunnel_cookie(3), 10);
+  append_flow_stats(reply, GTPApplication::arp_cookie(ue_ip3), 10);
+  // Downlink flow of UE 3 from before the cookies, on IPv4 destination
+  append_flow_stats(
+      reply, 0, 10, {0x80, 0x00, 0x18, 0x04, 192, 168, 128, 3});
+  // Paging and discard flows
+  append_flow_stats(reply, 0, 5);
+  append_flow_stats(reply, 1, 11);
+
+  EXPECT_CALL(*messenger, send_of_msg(IsMultipartRequest(), _)).Times(1);
+  EXPECT_CALL(
+      *messenger,
+      send_of_msg(
+          CheckFlowModCookie(
+              of13::OFPFC_ADD, GTPApplication::tunnel_cookie(2)),
+          _))
+      .Times(3);
+  EXPECT_CALL(
+      *messenger,
+      send_of_msg(
+          CheckFlowModCookie(
+              of13::OFPFC_ADD, GTPApplication::arp_cookie(ue_ip2)),
+          _))
+      .Times(2);
+  EXPECT_CALL(
+      *messenger,
+      send_of_msg(
+          CheckFlowModCookie(
+              of13::OFPFC_DELETE, GTPApplication::tunnel_cookie(3)),
+          _))
+      .Times(1);
+  EXPECT_CALL(
+      *messenger,
+      send_of_msg(
+          CheckFlowModCookie(
+              of13::OFPFC_DELETE, GTPApplication::arp_cookie(ue_ip3)),
+          _))
+      .Times(1);
+  EXPECT_CALL(
+      *messenger,
+      send_of_msg(
+          AllOf(
+              CheckFlowModCookie(of13::OFPFC_DELETE_STRICT, 0),
+              CheckIPv4Dst(ue_ip3)),
+          _))
+      .Times(1);
+
+  controller->dispatch_event(reconcile);
+  gtp_app->handle_flow_stats_reply(
+      nullptr, reply.data(), reply.size(), *messenger);
+}
+
+/*
+ * Test that reconciliation leaves alone the tunnels SPGW changed while the
+ * switch flows were being dumped
+ */
+TEST_F(GTPApplicationTest, TestReconcileSkipsChangedTunnels) {
+  struct in_addr ue_ip;
+  ue_ip.s_addr = inet_addr("192.168.128.2");
+  controller->register_for_event(
+      gtp_app, openflow::EVENT_RECONCILE_GTP_TUNNELS);
+  ReconcileGTPTunnelsEvent reconcile(
+      {reconciled_tunnel("192.168.128.2", 2)});
+  DeleteGTPTunnelEvent del_tunnel(ue_ip, NULL, 2, 0);
+
+  EXPECT_CALL(*messenger, send_of_msg(IsMultipartRequest(), _)).Times(1);
+  EXPECT_CALL(
+      *messenger,
+      send_of_msg(
+          CheckFlowModCookie(
+              of13::OFPFC_DELETE, GTPApplication::tunnel_cookie(2)),
+          _))
+      .Times(3);
+  EXPECT_CALL(
+      *messenger,
+      send_of_msg(
+          CheckFlowModCookie(
+              of13::OFPFC_DELETE, GTPApplication::arp_cookie(ue_ip)),
+          _))
+      .Times(2);
+
+  controller->dispatch_event(reconcile);
+  controller->dispatch_event(del_tunnel);
+  std::vector<uint8_t> reply = flow_stats_reply();
+  gtp_app->handle_flow_stats_reply(
+      nullptr, reply.data(), reply.size(), *messenger);
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,368 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <folly/json.h>
+#include <gtest/gtest.h>
+
+#include "OvsdbClient.h"
+
+using ::testing::Test;
+using folly::dynamic;
+using namespace openflow;
+
+namespace {
+
+const std::chrono::milliseconds TIMEOUT(2000);
+
+/**
+ * ovsdb-server answering monitor, select and the add-port transaction on a
+ * unix socket, with one Interface table
+ */
+class FakeOvsdbServer {
+ public:
+  explicit FakeOvsdbServer(const std::string& path)
+      : path_(path), conn_fd_(-1), next_ofport_(1), echo_replies_(0) {
+    struct sockaddr_un addr = {0};
+    addr.sun_family         = AF_UNIX;
+    strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    unlink(path.c_str());
+    listen_fd_ = socket(AF_UNIX, SOCK_STREAM, 0);
+    bind(listen_fd_, (struct sockaddr*) &addr, sizeof(addr));
+    listen(listen_fd_, 1);
+    thread_ = std::thread(&FakeOvsdbServer::run, this);
+  }
+
+  ~FakeOvsdbServer() {
+    shutdown(listen_fd_, SHUT_RDWR);
+    drop_connection();
+    thread_.join();
+    close(listen_fd_);
+    unlink(path_.c_str());
+  }
+
+  void add_interface(const std::string& name, int64_t ofport) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    interfaces_[name] = ofport;
+    send_update(name, row(name, ofport));
+  }
+
+  void delete_interface(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    interfaces_.erase(name);
+    send_update(name, nullptr);
+  }
+
+  void send_echo() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    send(dynamic::object("method", "echo")("params", dynamic::array())(
+        "id", "echo"));
+  }
+
+  void drop_connection() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (conn_fd_ >= 0) {
+      shutdown(conn_fd_, SHUT_RDWR);
+    }
+  }
+
+  int echo_replies() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return echo_replies_;
+  }
+
+  std::vector<dynamic> transactions() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return transactions_;
+  }
+
+ private:
+  const std::string path_;
+  int listen_fd_;
+  std::thread thread_;
+  std::mutex mutex_;
+  int conn_fd_;
+  std::map<std::string, int64_t> interfaces_;
+  int64_t next_ofport_;
+  int echo_replies_;
+  std::vector<dynamic> transactions_;
+
+  static dynamic row(const std::string& name, int64_t ofport) {
+    return dynamic::object("name", name)("ofport", ofport);
+  }
+
+  void run() {
+    int fd;
+    while ((fd = accept(listen_fd_, nullptr, nullptr)) >= 0) {
+      JsonRpcStream stream;
+      std::vector<std::string> messages;
+      char buffer[1024];
+      ssize_t n;
+
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        conn_fd_ = fd;
+      }
+      while ((n = recv(fd, buffer, sizeof(buffer), 0)) > 0) {
+        messages.clear();
+        stream.feed(buffer, n, &messages);
+        for (const auto& message : messages) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          handle(folly::parseJson(message));
+        }
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      conn_fd_ = -1;
+      close(fd);
+    }
+  }
+
+  void send(const dynamic& message) {
+    std::string json = folly::toJson(message);
+    if (conn_fd_ >= 0) {
+      ::send(conn_fd_, json.data(), json.size(), MSG_NOSIGNAL);
+    }
+  }
+
+  void reply(const dynamic& request, const dynamic& result) {
+    send(dynamic::object("result", result)("error", nullptr)(
+        "id", request["id"]));
+  }
+
+  void send_update(const std::string& name, const dynamic& new_row) {
+    dynamic update = dynamic::object();
+    if (!new_row.isNull()) {
+      update["new"] = new_row;
+    }
+    send(dynamic::object("method", "update")("id", nullptr)(
+        "params", dynamic::array(
+                      "interfaces", dynamic::object(
+                                        "Interface",
+                                        dynamic::object(
+                                            "uuid-" + name, update)))));
+  }
+
+  void handle(const dynamic& message) {
+    if (message.get_ptr("result")) {
+      if (message["id"] == "echo") {
+        echo_replies_++;
+      }
+      return;
+    }
+    if (message["method"] == "monitor") {
+      dynamic rows = dynamic::object();
+      for (const auto& interface : interfaces_) {
+        rows["uuid-" + interface.first] =
+            dynamic::object("new", row(interface.first, interface.second));
+      }
+      reply(message, dynamic::object("Interface", rows));
+      return;
+    }
+    const dynamic& ops = message["params"];
+    transactions_.push_back(ops);
+    if (ops[1]["op"] == "select") {
+      dynamic types = dynamic::array("geneve", "gtpu", "vxlan");
+      reply(
+          message,
+          dynamic::array(dynamic::object(
+              "rows", dynamic::array(dynamic::object(
+                          "iface_types", dynamic::array("set", types))))));
+      return;
+    }
+    // Add-port transaction: wait, insert Interface, insert Port, mutate
+    // Bridge and Open_vSwitch
+    std::string name = ops[1]["where"][0][2].getString();
+    if (interfaces_.count(name)) {
+      reply(message, dynamic::array(dynamic::object("error", "timed out")));
+      return;
+    }
+    if (ops[4]["where"][0][2] != "gtp_br0") {
+      reply(
+          message, dynamic::array(
+                       dynamic::object(), dynamic::object(), dynamic::object(),
+                       dynamic::object("count", 0), dynamic::object()));
+      return;
+    }
+    reply(
+        message, dynamic::array(
+                     dynamic::object(), dynamic::object(), dynamic::object(),
+                     dynamic::object("count", 1), dynamic::object("count", 1)));
+    // OVS numbers the port once ovs-vswitchd added it
+    interfaces_[name] = next_ofport_;
+    send_update(name, row(name, next_ofport_++));
+  }
+};
+
+bool eventually(std::function<bool()> condition) {
+  auto deadline = std::chrono::steady_clock::now() + TIMEOUT;
+  while (!condition()) {
+    if (std::chrono::steady_clock::now() > deadline) {
+      return false;
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  return true;
+}
+
+class OvsdbClientTest : public Test {
+ protected:
+  virtual void SetUp() {
+    path   = "/tmp/ovsdb_client_test_" + std::to_string(getpid()) + ".sock";
+    server = std::make_unique<FakeOvsdbServer>(path);
+    server->add_interface("gtp0", 32768);
+    client = std::make_unique<OvsdbClient>(path);
+  }
+
+  virtual void TearDown() {
+    client.reset();
+    server.reset();
+  }
+
+  std::string path;
+  std::unique_ptr<FakeOvsdbServer> server;
+  std::unique_ptr<OvsdbClient> client;
+};
+
+TEST(JsonRpcStreamTest, TestSplitsMessages) {
+  JsonRpcStream stream;
+  std::vector<std::string> messages;
+  std::string data =
+      "{\"id\":1,\"result\":[]}\n{\"method\":\"echo\",\"params\":"
+      "[\"}{\\\"\"],\"id\":\"echo\"}{\"id\":2";
+
+  // Byte by byte, braces in strings and escaped quotes do not count
+  for (char c : data) {
+    stream.feed(&c, 1, &messages);
+  }
+  ASSERT_EQ(messages.size(), 2);
+  EXPECT_EQ(folly::parseJson(messages[0])["id"], 1);
+  EXPECT_EQ(folly::parseJson(messages[1])["params"][0], "}{\"");
+
+  stream.feed(",\"result\":{}}", 13, &messages);
+  ASSERT_EQ(messages.size(), 3);
+  EXPECT_EQ(folly::parseJson(messages[2])["id"], 2);
+}
+
+TEST_F(OvsdbClientTest, TestLoadsInterfacesOnStart) {
+  ASSERT_TRUE(client->start(TIMEOUT));
+  EXPECT_EQ(client->get_ofport("gtp0"), 32768);
+  EXPECT_EQ(client->get_ofport("g_100000a"), 0);
+}
+
+TEST_F(OvsdbClientTest, TestFollowsUpdates) {
+  ASSERT_TRUE(client->start(TIMEOUT));
+
+  server->add_interface("g_200000a", 7);
+  EXPECT_TRUE(eventually([this] { return client->get_ofport("g_200000a"); }));
+  EXPECT_EQ(client->get_ofport("g_200000a"), 7);
+
+  server->delete_interface("gtp0");
+  EXPECT_TRUE(eventually([this] { return !client->get_ofport("gtp0"); }));
+  EXPECT_EQ(client->get_ofport("g_200000a"), 7);
+}
+
+TEST_F(OvsdbClientTest, TestAddTunnelPort) {
+  ASSERT_TRUE(client->start(TIMEOUT));
+
+  EXPECT_EQ(
+      client->add_tunnel_port(
+          "gtp_br0", "g_100000a", "gtpu", "10.0.0.1", TIMEOUT),
+      1);
+  EXPECT_EQ(client->get_ofport("g_100000a"), 1);
+
+  auto transactions = server->transactions();
+  ASSERT_EQ(transactions.size(), 1);
+  const dynamic& iface = transactions[0][2]["row"];
+  EXPECT_EQ(iface["name"], "g_100000a");
+  EXPECT_EQ(iface["type"], "gtpu");
+  EXPECT_EQ(
+      iface["options"],
+      dynamic::array(
+          "map", dynamic::array(
+                     dynamic::array("remote_ip", "10.0.0.1"),
+                     dynamic::array("key", "flow"))));
+
+  // Cached from then on
+  EXPECT_EQ(
+      client->add_tunnel_port(
+          "gtp_br0", "g_100000a", "gtpu", "10.0.0.1", TIMEOUT),
+      1);
+  EXPECT_EQ(server->transactions().size(), 1);
+}
+
+TEST_F(OvsdbClientTest, TestAddTunnelPortToMissingBridge) {
+  ASSERT_TRUE(client->start(TIMEOUT));
+
+  EXPECT_EQ(
+      client->add_tunnel_port(
+          "br0", "g_100000a", "gtpu", "10.0.0.1", TIMEOUT),
+      0);
+}
+
+TEST_F(OvsdbClientTest, TestHasInterfaceType) {
+  ASSERT_TRUE(client->start(TIMEOUT));
+
+  EXPECT_TRUE(client->has_interface_type("gtpu", TIMEOUT));
+  EXPECT_FALSE(client->has_interface_type("gtp", TIMEOUT));
+}
+
+TEST_F(OvsdbClientTest, TestAnswersEcho) {
+  ASSERT_TRUE(client->start(TIMEOUT));
+
+  server->send_echo();
+  EXPECT_TRUE(eventually([this] { return server->echo_replies() == 1; }));
+}
+
+TEST_F(OvsdbClientTest, TestReloadsOnReconnect) {
+  ASSERT_TRUE(client->start(TIMEOUT));
+
+  server->drop_connection();
+  server->add_interface("g_200000a", 7);
+  EXPECT_TRUE(eventually([this] { return client->get_ofport("g_200000a"); }));
+  EXPECT_EQ(client->get_ofport("gtp0"), 32768);
+}
+
+TEST(OvsdbClientNoServerTest, TestFailsWithoutServer) {
+  OvsdbClient client("/tmp/ovsdb_client_test_none.sock");
+
+  EXPECT_FALSE(client.start(std::chrono::milliseconds(100)));
+  EXPECT_EQ(client.get_ofport("gtp0"), 0);
+  EXPECT_EQ(
+      client.add_tunnel_port(
+          "gtp_br0", "g_100000a", "gtpu", "10.0.0.1", TIMEOUT),
+      0);
+  EXPECT_FALSE(client.has_interface_type("gtpu", TIMEOUT));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,85 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <gtest/gtest.h>
+#include "PagingApplication.h"
+
+using ::testing::Test;
+using namespace openflow;
+
+namespace {
+
+const uint32_t UE_IP       = 0x0100a8c0;  // 192.168.0.1
+const uint32_t OTHER_UE_IP = 0x0200a8c0;  // 192.168.0.2
+
+TEST(PagingApplicationTest, TestSuppressionWindow) {
+  PagingApplication paging_app(30);
+
+  EXPECT_EQ(paging_app.decide_paging(UE_IP, 1000), PagingApplication::PAGE);
+  // Packet-ins queued before the clamping flow was installed
+  EXPECT_EQ(
+      paging_app.decide_paging(UE_IP, 1001), PagingApplication::SUPPRESS);
+  EXPECT_EQ(
+      paging_app.decide_paging(UE_IP, 30999), PagingApplication::SUPPRESS);
+  EXPECT_EQ(
+      paging_app.decide_paging(OTHER_UE_IP, 2000), PagingApplication::PAGE);
+  // Clamping timed out, paging failed: page again
+  EXPECT_EQ(paging_app.decide_paging(UE_IP, 31000), PagingApplication::PAGE);
+  EXPECT_EQ(
+      paging_app.decide_paging(OTHER_UE_IP, 31000),
+      PagingApplication::SUPPRESS);
+}
+
+TEST(PagingApplicationTest, TestRateLimit) {
+  PagingApplication paging_app(30, 10, 2);
+  int64_t now_ms = 0;
+  int paged      = 0;
+  uint32_t ue_ip = 0;
+
+  // Burst
+  EXPECT_EQ(paging_app.decide_paging(ue_ip++, now_ms), PagingApplication::PAGE);
+  EXPECT_EQ(paging_app.decide_paging(ue_ip++, now_ms), PagingApplication::PAGE);
+  EXPECT_EQ(
+      paging_app.decide_paging(ue_ip, now_ms), PagingApplication::RATE_LIMIT);
+  // A rate limited UE IP is not suppressed: it pages once there is a token
+  now_ms += 100;
+  EXPECT_EQ(paging_app.decide_paging(ue_ip++, now_ms), PagingApplication::PAGE);
+
+  // 10 pagings per second for 10 s, with a new UE IP every ms
+  for (now_ms = 1000; now_ms < 11000; now_ms++) {
+    if (paging_app.decide_paging(ue_ip++, now_ms) == PagingApplication::PAGE) {
+      paged++;
+    }
+  }
+  EXPECT_GE(paged, 100);
+  EXPECT_LE(paged, 102);
+}
+
+TEST(PagingApplicationTest, TestNoRateLimit) {
+  PagingApplication paging_app;
+  uint32_t ue_ip = 0;
+
+  for (ue_ip = 0; ue_ip < 10000; ue_ip++) {
+    EXPECT_EQ(paging_app.decide_paging(ue_ip, 0), PagingApplication::PAGE);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,138 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <string.h>
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "secu_defs.h"
+#include "security_types.h"
+#include "3gpp_33.401.h"
+}
+
+namespace {
+
+// RFC 4231 HMAC-SHA-256 Test Case 2
+const uint8_t hmac_key[]    = {'J', 'e', 'f', 'e'};
+const uint8_t hmac_data[]   = "what do ya want for nothing?";
+const uint8_t hmac_digest[] = {
+    0x5b, 0xdc, 0xc1, 0x46, 0xbf, 0x60, 0x75, 0x4e, 0x6a, 0x04, 0x24,
+    0x26, 0x08, 0x95, 0x75, 0xc7, 0x5a, 0x00, 0x3f, 0x08, 0x9d, 0x27,
+    0x39, 0x83, 0x9d, 0xec, 0x58, 0xb9, 0x64, 0xec, 0x38, 0x43};
+
+const uint8_t kasme[] = {
+    0x23, 0x8e, 0x45, 0x7e, 0x0f, 0x75, 0x8b, 0xad, 0xbc, 0xa8, 0xd3,
+    0x4b, 0xb2, 0x61, 0x2c, 0x10, 0x42, 0x8d, 0x42, 0x6c, 0xb7, 0x6b,
+    0x37, 0x97, 0x1d, 0x56, 0x7d, 0x86, 0x61, 0x73, 0x3a, 0x7c};
+
+class KdfTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() { kdf_context_clear(&ctx); }
+
+  virtual void TearDown() { kdf_context_clear(&ctx); }
+
+  kdf_context_t ctx;
+};
+
+TEST_F(KdfTest, TestKdfHmacSha256) {
+  uint8_t out[32] = {0};
+
+  kdf(
+      hmac_key, sizeof(hmac_key), (uint8_t*) hmac_data, sizeof(hmac_data) - 1,
+      out, sizeof(out));
+  EXPECT_EQ(0, memcmp(out, hmac_digest, sizeof(out)));
+}
+
+/*
+ * The context stays keyed after each derivation: deriving the attach keys
+ * in any order has to match the one-shot functions
+ */
+TEST_F(KdfTest, TestContextMatchesOneShot) {
+  uint8_t expected[32] = {0};
+  uint8_t out[32]      = {0};
+
+  kdf_context_set_key(&ctx, kasme);
+  for (int i = 0; i < 2; i++) {
+    derive_key_nas_int(EIA2_128_ALG_ID, kasme, expected);
+    derive_key_nas_with_context(&ctx, NAS_INT_ALG, EIA2_128_ALG_ID, out);
+    EXPECT_EQ(0, memcmp(out, expected, 16));
+
+    derive_key_nas_enc(EEA2_128_ALG_ID, kasme, expected);
+    derive_key_nas_with_context(&ctx, NAS_ENC_ALG, EEA2_128_ALG_ID, out);
+    EXPECT_EQ(0, memcmp(out, expected, 16));
+
+    derive_keNB(kasme, 0x1234, expected);
+    derive_keNB_with_context(&ctx, 0x1234, out);
+    EXPECT_EQ(0, memcmp(out, expected, sizeof(out)));
+  }
+}
+
+TEST_F(KdfTest, TestContextRekeysOnKeyChange) {
+  uint8_t other_kasme[32] = {0};
+  uint8_t expected[32]    = {0};
+  uint8_t out[32]         = {0};
+
+  for (int i = 0; i < 32; i++) other_kasme[i] = kasme[i] ^ 0x5a;
+  kdf_context_set_key(&ctx, kasme);
+  kdf_context_set_key(&ctx, other_kasme);
+  derive_keNB(other_kasme, 7, expected);
+  derive_keNB_with_context(&ctx, 7, out);
+  EXPECT_EQ(0, memcmp(out, expected, sizeof(out)));
+  EXPECT_EQ(0, memcmp(ctx.key, other_kasme, sizeof(other_kasme)));
+}
+
+// NH = KDF(KASME, FC_NH || SYNC-input || 0x00 0x20), 3GPP TS 33.401 A.4
+void compute_nh(const uint8_t* sync_input, uint8_t* next_hop) {
+  uint8_t s[35] = {FC_NH};
+
+  memcpy(&s[1], sync_input, 32);
+  s[34] = 0x20;
+  kdf(kasme, sizeof(kasme), s, sizeof(s), next_hop, 32);
+}
+
+TEST_F(KdfTest, TestNHChain) {
+  uint8_t kenb[32]         = {0};
+  uint8_t expected[8][32]  = {{0}};
+  uint8_t next_hops[8][32] = {{0}};
+  uint8_t ncc              = 0;
+
+  derive_keNB(kasme, 0, kenb);
+  compute_nh(kenb, expected[0]);
+  for (int i = 1; i < 8; i++) compute_nh(expected[i - 1], expected[i]);
+
+  kdf_context_set_key(&ctx, kasme);
+  derive_NH_chain(&ctx, kenb, 8, next_hops[0], &ncc);
+  EXPECT_EQ(0, memcmp(next_hops, expected, sizeof(next_hops)));
+  EXPECT_EQ(0, ncc);
+
+  // in place, as done on path switch
+  compute_nh(expected[7], expected[0]);
+  derive_NH_chain(&ctx, next_hops[7], 1, next_hops[7], &ncc);
+  EXPECT_EQ(0, memcmp(next_hops[7], expected[0], sizeof(next_hops[7])));
+  EXPECT_EQ(1, ncc);
+
+  derive_NH(kasme, next_hops[7], next_hops[0], &ncc);
+  compute_nh(next_hops[7], expected[0]);
+  EXPECT_EQ(0, memcmp(next_hops[0], expected[0], sizeof(next_hops[0])));
+  EXPECT_EQ(2, ncc);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,147 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <string.h>
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "secu_defs.h"
+}
+
+namespace {
+
+// 3GPP TS 33.401 Annex C.1, 128-EEA2 Test Set 1
+const uint8_t eea2_key[] = {0xd3, 0xc5, 0xd5, 0x92, 0x32, 0x7f, 0xb1, 0x1c,
+                            0x40, 0x35, 0xc6, 0x68, 0x0a, 0xf8, 0xc6, 0xd1};
+const uint8_t eea2_plaintext[] = {
+    0x98, 0x1b, 0xa6, 0x82, 0x4c, 0x1b, 0xfb, 0x1a, 0xb4, 0x85, 0x47,
+    0x20, 0x29, 0xb7, 0x1d, 0x80, 0x8c, 0xe3, 0x3e, 0x2c, 0xc3, 0xc0,
+    0xb5, 0xfc, 0x1f, 0x3d, 0xe8, 0xa6, 0xdc, 0x66, 0xb1, 0xf0};
+const uint8_t eea2_ciphertext[] = {
+    0xe9, 0xfe, 0xd8, 0xa6, 0x3d, 0x15, 0x53, 0x04, 0xd7, 0x1d, 0xf2,
+    0x0b, 0xf3, 0xe8, 0x22, 0x14, 0xb2, 0x0e, 0xd7, 0xda, 0xd2, 0xf2,
+    0x33, 0xdc, 0x3c, 0x22, 0xd7, 0xbd, 0xee, 0xed, 0x8e, 0x78};
+
+// 3GPP TS 33.401 Annex C.2, 128-EIA2 Test Set 1
+const uint8_t eia2_key[] = {0xd3, 0xc5, 0xd5, 0x92, 0x32, 0x7f, 0xb1, 0x1c,
+                            0x40, 0x35, 0xc6, 0x68, 0x0a, 0xf8, 0xc6, 0xd1};
+const uint8_t eia2_message[] = {0x48, 0x45, 0x83, 0xd5,
+                                0xaf, 0xe0, 0x82, 0xae};
+const uint8_t eia2_mac[]     = {0xb9, 0x37, 0x87, 0xe6};
+
+class NasStreamEia2Eea2Test : public ::testing::Test {
+ protected:
+  virtual void SetUp() { nas_stream_key_cache_clear(&cache); }
+
+  virtual void TearDown() { nas_stream_key_cache_clear(&cache); }
+
+  nas_stream_key_cache_t cache;
+};
+
+TEST_F(NasStreamEia2Eea2Test, TestEea2TestSet1) {
+  uint8_t out[sizeof(eea2_plaintext)] = {0};
+  nas_stream_cipher_t stream_cipher   = {0};
+
+  stream_cipher.key        = (uint8_t*) eea2_key;
+  stream_cipher.key_length = sizeof(eea2_key);
+  stream_cipher.count      = 0x398a59b4;
+  stream_cipher.bearer     = 0x15;
+  stream_cipher.direction  = 1;
+  stream_cipher.message    = (uint8_t*) eea2_plaintext;
+  stream_cipher.blength    = 253;
+
+  nas_stream_encrypt_eea2(&stream_cipher, out);
+  EXPECT_EQ(0, memcmp(out, eea2_ciphertext, sizeof(out)));
+
+  memset(out, 0, sizeof(out));
+  nas_stream_encrypt_eea2_cached(&cache, &stream_cipher, out);
+  EXPECT_EQ(0, memcmp(out, eea2_ciphertext, sizeof(out)));
+}
+
+TEST_F(NasStreamEia2Eea2Test, TestEea2InPlace) {
+  uint8_t buffer[sizeof(eea2_plaintext)] = {0};
+  nas_stream_cipher_t stream_cipher      = {0};
+
+  memcpy(buffer, eea2_plaintext, sizeof(buffer));
+  stream_cipher.key        = (uint8_t*) eea2_key;
+  stream_cipher.key_length = sizeof(eea2_key);
+  stream_cipher.count      = 0x398a59b4;
+  stream_cipher.bearer     = 0x15;
+  stream_cipher.direction  = 1;
+  stream_cipher.message    = buffer;
+  stream_cipher.blength    = 253;
+
+  nas_stream_encrypt_eea2_cached(&cache, &stream_cipher, buffer);
+  EXPECT_EQ(0, memcmp(buffer, eea2_ciphertext, sizeof(buffer)));
+}
+
+TEST_F(NasStreamEia2Eea2Test, TestEia2TestSet1) {
+  uint8_t mac[4]                    = {0};
+  nas_stream_cipher_t stream_cipher = {0};
+
+  stream_cipher.key        = (uint8_t*) eia2_key;
+  stream_cipher.key_length = sizeof(eia2_key);
+  stream_cipher.count      = 0x398a59b4;
+  stream_cipher.bearer     = 0x1a;
+  stream_cipher.direction  = 1;
+  stream_cipher.message    = (uint8_t*) eia2_message;
+  stream_cipher.blength    = 64;
+
+  nas_stream_encrypt_eia2(&stream_cipher, mac);
+  EXPECT_EQ(0, memcmp(mac, eia2_mac, sizeof(mac)));
+
+  memset(mac, 0, sizeof(mac));
+  nas_stream_encrypt_eia2_cached(&cache, &stream_cipher, mac);
+  EXPECT_EQ(0, memcmp(mac, eia2_mac, sizeof(mac)));
+}
+
+/*
+ * The cache must follow the key it is given: a message protected after a key
+ * change has to match the one-shot computation with the new key
+ */
+TEST_F(NasStreamEia2Eea2Test, TestCacheRekeysOnKeyChange) {
+  uint8_t other_key[16]             = {0};
+  uint8_t message[200]              = {0};
+  uint8_t expected[4]               = {0};
+  uint8_t mac[4]                    = {0};
+  nas_stream_cipher_t stream_cipher = {0};
+
+  for (int i = 0; i < 200; i++) message[i] = (uint8_t) i;
+  for (int i = 0; i < 16; i++) other_key[i] = eia2_key[i] ^ 0x5a;
+
+  nas_stream_key_cache_init(&cache, eea2_key, eia2_key);
+
+  stream_cipher.key        = other_key;
+  stream_cipher.key_length = sizeof(other_key);
+  stream_cipher.count      = 7;
+  stream_cipher.direction  = SECU_DIRECTION_DOWNLINK;
+  stream_cipher.message    = message;
+  // every remainder of the last CMAC block, complete block included
+  for (uint32_t length = 1; length <= sizeof(message); length++) {
+    stream_cipher.blength = length << 3;
+    nas_stream_encrypt_eia2(&stream_cipher, expected);
+    nas_stream_encrypt_eia2_cached(&cache, &stream_cipher, mac);
+    EXPECT_EQ(0, memcmp(mac, expected, sizeof(mac))) << "length " << length;
+  }
+  EXPECT_EQ(0, memcmp(cache.eia2_key, other_key, sizeof(other_key)));
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
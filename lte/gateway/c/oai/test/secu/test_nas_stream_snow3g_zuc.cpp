@@ -0,0 +1,187 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <string.h>
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "secu_defs.h"
+#include "zuc.h"
+}
+
+namespace {
+
+// 3GPP TS 33.401 Annex C.1, 128-EEA1 Test Set 1
+const uint8_t eea1_key[] = {0xd3, 0xc5, 0xd5, 0x92, 0x32, 0x7f, 0xb1, 0x1c,
+                            0x40, 0x35, 0xc6, 0x68, 0x0a, 0xf8, 0xc6, 0xd1};
+const uint8_t eea1_plaintext[] = {
+    0x98, 0x1b, 0xa6, 0x82, 0x4c, 0x1b, 0xfb, 0x1a, 0xb4, 0x85, 0x47,
+    0x20, 0x29, 0xb7, 0x1d, 0x80, 0x8c, 0xe3, 0x3e, 0x2c, 0xc3, 0xc0,
+    0xb5, 0xfc, 0x1f, 0x3d, 0xe8, 0xa6, 0xdc, 0x66, 0xb1, 0xf0};
+const uint8_t eea1_ciphertext[] = {
+    0x5d, 0x5b, 0xfe, 0x75, 0xeb, 0x04, 0xf6, 0x8c, 0xe0, 0xa1, 0x23,
+    0x77, 0xea, 0x00, 0xb3, 0x7d, 0x47, 0xc6, 0xa0, 0xba, 0x06, 0x30,
+    0x91, 0x55, 0x08, 0x6a, 0x85, 0x9c, 0x43, 0x41, 0xb3, 0x78};
+
+// 3GPP TS 33.401 Annex C.3, 128-EIA1 Test Set 1
+const uint8_t eia1_key[] = {0x2b, 0xd6, 0x45, 0x9f, 0x82, 0xc5, 0xb3, 0x00,
+                            0x95, 0x2c, 0x49, 0x10, 0x48, 0x81, 0xff, 0x48};
+const uint8_t eia1_message[] = {0x33, 0x32, 0x34, 0x62, 0x63, 0x39,
+                                0x38, 0x61, 0x37, 0x34, 0x79};
+const uint8_t eia1_mac[]     = {0x73, 0x1f, 0x11, 0x65};
+
+// 3GPP TS 33.401 Annex C.4, 128-EEA3 Test Set 1
+const uint8_t eea3_key[] = {0x17, 0x3d, 0x14, 0xba, 0x50, 0x03, 0x73, 0x1d,
+                            0x7a, 0x60, 0x04, 0x94, 0x70, 0xf0, 0x0a, 0x29};
+const uint8_t eea3_plaintext[] = {
+    0x6c, 0xf6, 0x53, 0x40, 0x73, 0x55, 0x52, 0xab, 0x0c, 0x97,
+    0x52, 0xfa, 0x6f, 0x90, 0x25, 0xfe, 0x0b, 0xd6, 0x75, 0xd9,
+    0x00, 0x58, 0x75, 0xb2, 0x00, 0x00, 0x00, 0x00};
+const uint8_t eea3_ciphertext[] = {
+    0xa6, 0xc8, 0x5f, 0xc6, 0x6a, 0xfb, 0x85, 0x33, 0xaa, 0xfc,
+    0x25, 0x18, 0xdf, 0xe7, 0x84, 0x94, 0x0e, 0xe1, 0xe4, 0xb0,
+    0x30, 0x23, 0x8c, 0xc8, 0x00, 0x00, 0x00, 0x00};
+
+// 3GPP TS 33.401 Annex C.5, 128-EIA3 Test Set 1
+const uint8_t eia3_key[] = {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                            0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+const uint8_t eia3_message[] = {0x00};
+const uint8_t eia3_mac[]     = {0xc8, 0xa9, 0x59, 0x5e};
+
+TEST(NasStreamSnow3gZucTest, TestEea1TestSet1) {
+  uint8_t out[sizeof(eea1_plaintext)] = {0};
+  nas_stream_cipher_t stream_cipher   = {0};
+
+  stream_cipher.key        = (uint8_t*) eea1_key;
+  stream_cipher.key_length = sizeof(eea1_key);
+  stream_cipher.count      = 0x398a59b4;
+  stream_cipher.bearer     = 0x15;
+  stream_cipher.direction  = 1;
+  stream_cipher.message    = (uint8_t*) eea1_plaintext;
+  stream_cipher.blength    = 253;
+
+  nas_stream_encrypt_eea1(&stream_cipher, out);
+  EXPECT_EQ(0, memcmp(out, eea1_ciphertext, sizeof(out)));
+  // the message is no longer used as scratch space
+  EXPECT_EQ(0x98, eea1_plaintext[0]);
+}
+
+TEST(NasStreamSnow3gZucTest, TestEia1TestSet1) {
+  uint8_t mac[4]                    = {0};
+  nas_stream_cipher_t stream_cipher = {0};
+
+  stream_cipher.key        = (uint8_t*) eia1_key;
+  stream_cipher.key_length = sizeof(eia1_key);
+  stream_cipher.count      = 0x38a6f056;
+  stream_cipher.bearer     = 0x1f;
+  stream_cipher.direction  = 0;
+  stream_cipher.message    = (uint8_t*) eia1_message;
+  stream_cipher.blength    = 88;
+
+  nas_stream_encrypt_eia1(&stream_cipher, mac);
+  EXPECT_EQ(0, memcmp(mac, eia1_mac, sizeof(mac)));
+}
+
+TEST(NasStreamSnow3gZucTest, TestEea3TestSet1) {
+  uint8_t out[sizeof(eea3_plaintext)] = {0};
+  nas_stream_cipher_t stream_cipher   = {0};
+
+  stream_cipher.key        = (uint8_t*) eea3_key;
+  stream_cipher.key_length = sizeof(eea3_key);
+  stream_cipher.count      = 0x66035492;
+  stream_cipher.bearer     = 0x0f;
+  stream_cipher.direction  = 0;
+  stream_cipher.message    = (uint8_t*) eea3_plaintext;
+  stream_cipher.blength    = 193;
+
+  nas_stream_encrypt_eea3(&stream_cipher, out);
+  EXPECT_EQ(0, memcmp(out, eea3_ciphertext, sizeof(out)));
+}
+
+TEST(NasStreamSnow3gZucTest, TestEia3TestSet1) {
+  uint8_t mac[4]                    = {0};
+  nas_stream_cipher_t stream_cipher = {0};
+
+  stream_cipher.key        = (uint8_t*) eia3_key;
+  stream_cipher.key_length = sizeof(eia3_key);
+  stream_cipher.count      = 0;
+  stream_cipher.bearer     = 0;
+  stream_cipher.direction  = 0;
+  stream_cipher.message    = (uint8_t*) eia3_message;
+  stream_cipher.blength    = 1;
+
+  nas_stream_encrypt_eia3(&stream_cipher, mac);
+  EXPECT_EQ(0, memcmp(mac, eia3_mac, sizeof(mac)));
+}
+
+// ZUC specification, version 1.6, test vectors for the keystream generator
+TEST(NasStreamSnow3gZucTest, TestZucKeystream) {
+  uint8_t k[16]  = {0};
+  uint8_t iv[16] = {0};
+  uint32_t z[2]  = {0};
+  zuc_context_t zuc;
+
+  zuc_initialize(k, iv, &zuc);
+  zuc_generate_key_stream(2, z, &zuc);
+  EXPECT_EQ(0x27bede74u, z[0]);
+  EXPECT_EQ(0x018082dau, z[1]);
+
+  memset(k, 0xff, sizeof(k));
+  memset(iv, 0xff, sizeof(iv));
+  zuc_initialize(k, iv, &zuc);
+  zuc_generate_key_stream(2, z, &zuc);
+  EXPECT_EQ(0x0657cfa0u, z[0]);
+  EXPECT_EQ(0x7096398bu, z[1]);
+}
+
+/*
+ * Ciphering is an involution whatever the length: deciphering the output has
+ * to give the input back, bits past blength included since they are zeroed
+ */
+TEST(NasStreamSnow3gZucTest, TestEea1Eea3RoundTrip) {
+  uint8_t message[200]              = {0};
+  uint8_t cipher[200]               = {0};
+  uint8_t plain[200]                = {0};
+  nas_stream_cipher_t stream_cipher = {0};
+
+  for (int i = 0; i < 200; i++) message[i] = (uint8_t) (i * 7);
+
+  stream_cipher.key        = (uint8_t*) eea1_key;
+  stream_cipher.key_length = sizeof(eea1_key);
+  stream_cipher.count      = 3;
+  stream_cipher.direction  = SECU_DIRECTION_UPLINK;
+  for (uint32_t length = 1; length <= sizeof(message); length++) {
+    stream_cipher.blength = length << 3;
+    stream_cipher.message = message;
+    nas_stream_encrypt_eea1(&stream_cipher, cipher);
+    stream_cipher.message = cipher;
+    nas_stream_encrypt_eea1(&stream_cipher, plain);
+    EXPECT_EQ(0, memcmp(plain, message, length)) << "eea1 length " << length;
+
+    stream_cipher.message = message;
+    nas_stream_encrypt_eea3(&stream_cipher, cipher);
+    stream_cipher.message = cipher;
+    nas_stream_encrypt_eea3(&stream_cipher, plain);
+    EXPECT_EQ(0, memcmp(plain, message, length)) << "eea3 length " << length;
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,199 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <check.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "async_system.h"
+#include "bstrlib.h"
+#include "dynamic_memory_check.h"
+
+#define RESTORED "/tmp/test_async_system_restored"
+
+/*
+ * Stands for iptables-restore: keeps the transactions it gets in RESTORED
+ * and fails the ones with an --invalid rule
+ */
+#define FAKE_IPTABLES_RESTORE                                                  \
+  "sh -c 'in=$(cat); echo \"$in\" >> " RESTORED                               \
+  "; ! echo \"$in\" | grep -q -- --invalid'"
+
+static async_system_executor_t executor;
+
+static void setup(void) {
+  unlink(RESTORED);
+  executor                  = (async_system_executor_t){0};
+  executor.iptables_restore = FAKE_IPTABLES_RESTORE;
+  ck_assert_int_eq(async_system_executor_start(&executor), 0);
+}
+
+// As when the helper shell cannot be spawned
+static void setup_no_helper(void) {
+  unlink(RESTORED);
+  executor                  = (async_system_executor_t){0};
+  executor.iptables_restore = FAKE_IPTABLES_RESTORE;
+}
+
+static void teardown(void) {
+  async_system_executor_stop(&executor);
+  unlink(RESTORED);
+}
+
+static int run(bstring* batch, int* statuses, int nb_statuses) {
+  int nb_commands =
+      async_system_executor_run(&executor, *batch, statuses, nb_statuses);
+
+  bdestroy_wrapper(batch);
+  return nb_commands;
+}
+
+static int count_lines(const char* path, const char* line) {
+  char buf[256];
+  int count = 0;
+  FILE* fp  = fopen(path, "r");
+
+  if (!fp) {
+    return 0;
+  }
+  while (fgets(buf, sizeof(buf), fp)) {
+    count += !strcmp(buf, line);
+  }
+  fclose(fp);
+  return count;
+}
+
+START_TEST(async_system_shell_test) {
+  bstring batch = NULL;
+  int statuses[8];
+
+  async_system_batch_add(&batch, "true");
+  async_system_batch_add(&batch, "false");
+  async_system_batch_add(&batch, "   ");
+  async_system_batch_add(&batch, "sh -c 'exit %d'", 4);
+  // Commands do not read the helper shell input
+  async_system_batch_add(&batch, "cat");
+  async_system_batch_add(&batch, "sync");
+  ck_assert_int_eq(run(&batch, statuses, 8), 5);
+  ck_assert_int_eq(statuses[0], 0);
+  ck_assert_int_eq(statuses[1], 1);
+  ck_assert_int_eq(statuses[2], 4);
+  ck_assert_int_eq(statuses[3], 0);
+  ck_assert_int_eq(statuses[4], 0);
+
+  // The helper shell is restarted when a command exits it
+  async_system_batch_add(&batch, "exit 0");
+  async_system_batch_add(&batch, "true");
+  ck_assert_int_eq(run(&batch, statuses, 8), 2);
+  ck_assert_int_eq(statuses[0], -1);
+  ck_assert_int_eq(statuses[1], 0);
+}
+END_TEST
+
+START_TEST(async_system_iptables_test) {
+  bstring batch = NULL;
+  int statuses[8];
+
+  async_system_batch_add(&batch, "iptables -t mangle -F OUTPUT");
+  async_system_batch_add(&batch, "iptables  -t nat  -I POSTROUTING -j SNAT");
+  async_system_batch_add(
+      &batch, "iptables -I OUTPUT -t mangle -j MARK --set-mark %d", 1);
+  async_system_batch_add(&batch, "iptables -I FORWARD -j ACCEPT");
+  ck_assert_int_eq(run(&batch, statuses, 8), 4);
+  for (int i = 0; i < 4; i++) {
+    ck_assert_int_eq(statuses[i], 0);
+  }
+  // One transaction per table, rules in order
+  ck_assert_int_eq(count_lines(RESTORED, "*mangle\n"), 1);
+  ck_assert_int_eq(count_lines(RESTORED, "*nat\n"), 1);
+  ck_assert_int_eq(count_lines(RESTORED, "*filter\n"), 1);
+  ck_assert_int_eq(count_lines(RESTORED, "COMMIT\n"), 3);
+  ck_assert_int_eq(count_lines(RESTORED, "-I POSTROUTING -j SNAT\n"), 1);
+
+  // A failed transaction is replayed rule by rule
+  unlink(RESTORED);
+  async_system_batch_add(&batch, "iptables -t mangle -I OUTPUT -j ACCEPT");
+  async_system_batch_add(&batch, "iptables -t mangle -I OUTPUT --invalid");
+  async_system_batch_add(&batch, "iptables -t mangle -I OUTPUT -j RETURN");
+  ck_assert_int_eq(run(&batch, statuses, 8), 3);
+  ck_assert_int_eq(statuses[0], 0);
+  ck_assert_int_ne(statuses[1], 0);
+  ck_assert_int_eq(statuses[2], 0);
+  ck_assert_int_eq(count_lines(RESTORED, "*mangle\n"), 4);
+
+  // Shell syntax is left to the helper shell
+  async_system_batch_add(&batch, "iptables -L -n > /dev/null; true");
+  ck_assert_int_eq(run(&batch, statuses, 8), 1);
+  ck_assert_int_eq(statuses[0], 0);
+}
+END_TEST
+
+START_TEST(async_system_no_helper_test) {
+  bstring batch = NULL;
+  int statuses[8];
+
+  async_system_batch_add(&batch, "true");
+  async_system_batch_add(&batch, "sh -c 'exit %d'", 4);
+  async_system_batch_add(&batch, "iptables -t mangle -I OUTPUT -j ACCEPT");
+  async_system_batch_add(&batch, "iptables -t mangle -I OUTPUT --invalid");
+  async_system_batch_add(&batch, "exit 0");
+  async_system_batch_add(&batch, "true");
+  ck_assert_int_eq(run(&batch, statuses, 8), 6);
+  ck_assert_int_eq(statuses[0], 0);
+  ck_assert_int_eq(statuses[1], 4);
+  ck_assert_int_eq(statuses[2], 0);
+  ck_assert_int_ne(statuses[3], 0);
+  ck_assert_int_eq(statuses[4], 0);
+  ck_assert_int_eq(statuses[5], 0);
+  ck_assert_int_eq(count_lines(RESTORED, "*mangle\n"), 3);
+}
+END_TEST
+
+Suite* async_system_suite(void) {
+  Suite* s;
+  TCase* tc_core;
+
+  s = suite_create("Async system tests");
+
+  tc_core = tcase_create("Executor");
+  tcase_add_checked_fixture(tc_core, setup, teardown);
+  tcase_add_test(tc_core, async_system_shell_test);
+  tcase_add_test(tc_core, async_system_iptables_test);
+  suite_add_tcase(s, tc_core);
+
+  tc_core = tcase_create("No helper shell");
+  tcase_add_checked_fixture(tc_core, setup_no_helper, teardown);
+  tcase_add_test(tc_core, async_system_no_helper_test);
+  suite_add_tcase(s, tc_core);
+
+  return s;
+}
+
+int main(void) {
+  int number_failed;
+  Suite* s;
+  SRunner* sr;
+
+  s  = async_system_suite();
+  sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
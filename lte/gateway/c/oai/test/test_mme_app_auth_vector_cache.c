@@ -0,0 +1,180 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <check.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "mme_app_auth_vector_cache.h"
+#include "mme_config.h"
+
+#define USEC_PER_SEC 1000000
+#define IMSI_1 ((imsi64_t) 1010000000001)
+#define IMSI_2 ((imsi64_t) 1010000000002)
+#define IMSI_3 ((imsi64_t) 1010000000003)
+
+// Vectors told apart by their RAND
+static void fill_vectors(eutran_vector_t* vectors, int nb, uint8_t first) {
+  int i = 0;
+
+  memset(vectors, 0, nb * sizeof(eutran_vector_t));
+  for (i = 0; i < nb; i++) {
+    vectors[i].rand[0] = first + i;
+  }
+}
+
+START_TEST(auth_vector_cache_order_test) {
+  auth_vector_cache_config_t config = {.max_ues = 10, .ttl_sec = 60};
+  auth_vector_cache_t cache;
+  eutran_vector_t vectors[AUTH_VECTOR_CACHE_MAX_VECTORS];
+  eutran_vector_t vector;
+  int i = 0;
+
+  auth_vector_cache_init(&cache, &config);
+  fill_vectors(vectors, AUTH_VECTOR_CACHE_MAX_VECTORS, 1);
+  auth_vector_cache_put(
+      &cache, IMSI_1, AUTH_VECTOR_CACHE_MAX_VECTORS, vectors, 0);
+
+  // Oldest first, each vector once
+  for (i = 0; i < AUTH_VECTOR_CACHE_MAX_VECTORS; i++) {
+    ck_assert_int_eq(
+        auth_vector_cache_take(&cache, IMSI_1, &vector, i),
+        AUTH_VECTOR_CACHE_HIT);
+    ck_assert_int_eq(vector.rand[0], 1 + i);
+  }
+  ck_assert_int_eq(
+      auth_vector_cache_take(&cache, IMSI_1, &vector, i),
+      AUTH_VECTOR_CACHE_MISS);
+  ck_assert_uint_eq(cache.nb_ues, 0);
+
+  // A newer AIA replaces the vectors left
+  auth_vector_cache_put(&cache, IMSI_1, 2, vectors, 0);
+  ck_assert_int_eq(
+      auth_vector_cache_take(&cache, IMSI_1, &vector, 0),
+      AUTH_VECTOR_CACHE_HIT);
+  fill_vectors(vectors, 2, 10);
+  auth_vector_cache_put(&cache, IMSI_1, 2, vectors, 0);
+  ck_assert_int_eq(
+      auth_vector_cache_take(&cache, IMSI_1, &vector, 0),
+      AUTH_VECTOR_CACHE_HIT);
+  ck_assert_int_eq(vector.rand[0], 10);
+
+  // Re-synchronisation
+  auth_vector_cache_drop(&cache, IMSI_1, "resync");
+  ck_assert_int_eq(
+      auth_vector_cache_take(&cache, IMSI_1, &vector, 0),
+      AUTH_VECTOR_CACHE_MISS);
+  ck_assert_uint_eq(cache.nb_ues, 0);
+  auth_vector_cache_free(&cache);
+}
+END_TEST
+
+START_TEST(auth_vector_cache_ttl_test) {
+  auth_vector_cache_config_t config = {.max_ues = 10, .ttl_sec = 60};
+  auth_vector_cache_t cache;
+  eutran_vector_t vectors[AUTH_VECTOR_CACHE_MAX_VECTORS];
+  eutran_vector_t vector;
+
+  auth_vector_cache_init(&cache, &config);
+  fill_vectors(vectors, 2, 1);
+  auth_vector_cache_put(&cache, IMSI_1, 2, vectors, USEC_PER_SEC);
+  ck_assert_int_eq(
+      auth_vector_cache_take(&cache, IMSI_1, &vector, 60 * USEC_PER_SEC),
+      AUTH_VECTOR_CACHE_HIT);
+  ck_assert_int_eq(
+      auth_vector_cache_take(&cache, IMSI_1, &vector, 61 * USEC_PER_SEC),
+      AUTH_VECTOR_CACHE_EXPIRED);
+  ck_assert_int_eq(
+      auth_vector_cache_take(&cache, IMSI_1, &vector, 61 * USEC_PER_SEC),
+      AUTH_VECTOR_CACHE_MISS);
+
+  // Expired vectors go when making room even if there is some
+  auth_vector_cache_put(&cache, IMSI_1, 2, vectors, 0);
+  auth_vector_cache_put(&cache, IMSI_2, 2, vectors, 60 * USEC_PER_SEC);
+  ck_assert_uint_eq(cache.nb_ues, 1);
+  auth_vector_cache_free(&cache);
+}
+END_TEST
+
+START_TEST(auth_vector_cache_lru_test) {
+  auth_vector_cache_config_t config = {.max_ues = 2, .ttl_sec = 60};
+  auth_vector_cache_t cache;
+  eutran_vector_t vectors[AUTH_VECTOR_CACHE_MAX_VECTORS];
+  eutran_vector_t vector;
+
+  auth_vector_cache_init(&cache, &config);
+  fill_vectors(vectors, AUTH_VECTOR_CACHE_MAX_VECTORS, 1);
+  auth_vector_cache_put(&cache, IMSI_1, 3, vectors, 0);
+  auth_vector_cache_put(&cache, IMSI_2, 3, vectors, 0);
+  // IMSI_2 is now the least recently used
+  ck_assert_int_eq(
+      auth_vector_cache_take(&cache, IMSI_1, &vector, 0),
+      AUTH_VECTOR_CACHE_HIT);
+  auth_vector_cache_put(&cache, IMSI_3, 3, vectors, 0);
+  ck_assert_uint_eq(cache.nb_ues, 2);
+  ck_assert_int_eq(
+      auth_vector_cache_take(&cache, IMSI_2, &vector, 0),
+      AUTH_VECTOR_CACHE_MISS);
+  ck_assert_int_eq(
+      auth_vector_cache_take(&cache, IMSI_1, &vector, 0),
+      AUTH_VECTOR_CACHE_HIT);
+  ck_assert_int_eq(vector.rand[0], 2);
+  ck_assert_int_eq(
+      auth_vector_cache_take(&cache, IMSI_3, &vector, 0),
+      AUTH_VECTOR_CACHE_HIT);
+  auth_vector_cache_free(&cache);
+
+  // Disabled
+  config.max_ues = 0;
+  auth_vector_cache_init(&cache, &config);
+  auth_vector_cache_put(&cache, IMSI_1, 3, vectors, 0);
+  ck_assert_int_eq(
+      auth_vector_cache_take(&cache, IMSI_1, &vector, 0),
+      AUTH_VECTOR_CACHE_MISS);
+  auth_vector_cache_free(&cache);
+}
+END_TEST
+
+Suite* auth_vector_cache_suite(void) {
+  Suite* s;
+  TCase* tc_core;
+
+  s = suite_create("MME authentication vector cache tests");
+
+  tc_core = tcase_create("Authentication vector cache");
+  tcase_add_test(tc_core, auth_vector_cache_order_test);
+  tcase_add_test(tc_core, auth_vector_cache_ttl_test);
+  tcase_add_test(tc_core, auth_vector_cache_lru_test);
+  suite_add_tcase(s, tc_core);
+
+  return s;
+}
+
+int main(void) {
+  int number_failed;
+  Suite* s;
+  SRunner* sr;
+
+  s  = auth_vector_cache_suite();
+  sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,292 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <check.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "mme_app_overload.h"
+#include "mme_config.h"
+
+#define USEC_PER_MSEC 1000
+#define USEC_PER_SEC 1000000
+
+START_TEST(overload_hysteresis_test) {
+  overload_config_t config = {
+      .mme_app_latency_high_ms = 200,
+      .mme_app_latency_low_ms  = 50,
+      .s6a_latency_high_ms     = 300,
+      .s6a_latency_low_ms      = 100,
+      .procedures_high         = 0,
+  };
+  mme_app_overload_t overload;
+
+  mme_app_overload_init(&overload, &config, 0);
+  ck_assert(!mme_app_overload_update(&overload, 199 * USEC_PER_MSEC, 0));
+  ck_assert(mme_app_overload_update(&overload, 200 * USEC_PER_MSEC, 0));
+  ck_assert(overload.overloaded);
+
+  // Stays overloaded until every signal is under its low watermark
+  ck_assert(!mme_app_overload_update(
+      &overload, 100 * USEC_PER_MSEC, 200 * USEC_PER_MSEC));
+  ck_assert(!mme_app_overload_update(
+      &overload, 50 * USEC_PER_MSEC, 200 * USEC_PER_MSEC));
+  ck_assert(mme_app_overload_update(
+      &overload, 50 * USEC_PER_MSEC, 100 * USEC_PER_MSEC));
+  ck_assert(!overload.overloaded);
+
+  // Disabled signal
+  overload.procedures = 100000;
+  ck_assert(!mme_app_overload_update(&overload, 0, 0));
+  config.procedures_high = 1000;
+  config.procedures_low  = 800;
+  ck_assert(mme_app_overload_update(&overload, 0, 0));
+  overload.procedures = 801;
+  ck_assert(!mme_app_overload_update(&overload, 0, 0));
+  overload.procedures = 800;
+  ck_assert(mme_app_overload_update(&overload, 0, 0));
+}
+END_TEST
+
+START_TEST(overload_air_token_bucket_test) {
+  overload_config_t config = {.air_rate = 100, .air_burst = 10};
+  mme_app_overload_t overload;
+  int64_t now_usec = 0;
+  int sent         = 0;
+
+  mme_app_overload_init(&overload, &config, now_usec);
+  while (mme_app_overload_take_air_token(&overload, now_usec)) {
+    sent++;
+  }
+  ck_assert_int_eq(sent, 10);
+
+  // 100 AIR/s for 10 s, with a try every 3 ms
+  sent = 0;
+  for (now_usec = 1; now_usec <= 10 * USEC_PER_SEC; now_usec += 3000) {
+    if (mme_app_overload_take_air_token(&overload, now_usec)) {
+      sent++;
+    }
+  }
+  ck_assert_int_ge(sent, 999);
+  ck_assert_int_le(sent, 1001);
+
+  config.air_rate = 0;
+  ck_assert(mme_app_overload_take_air_token(&overload, now_usec));
+}
+END_TEST
+
+START_TEST(overload_spread_t3346_test) {
+  uint32_t random;
+
+  for (random = 0; random < 1000; random++) {
+    uint32_t t3346 = mme_app_overload_spread_t3346(60, random);
+    ck_assert_uint_ge(t3346, 30);
+    ck_assert_uint_le(t3346, 90);
+  }
+  ck_assert_uint_eq(mme_app_overload_spread_t3346(0, 12345), 0);
+}
+END_TEST
+
+/*
+ * Attach storm: UEs of a rebooted site attach at twice the rate the MME can
+ * serve. Attach requests wait in the MME_APP queue, an attach takes
+ * ATTACH_COST_MS of the MME and a reject REJECT_COST_MS. A UE with no answer
+ * T3410 after its attach request retries T3411 later, so an answer to an
+ * older request is wasted work. Goodput is the rate of attaches that
+ * complete while their UE still waits for them.
+ */
+#define NB_UES 12000
+#define STORM_MS 60000
+#define SIMULATION_MS 180000
+#define ATTACH_COST_MS 10
+#define REJECT_COST_MS 1
+#define T3410_MS 15000
+#define T3411_MS 10000
+#define T3346_SEC 60
+#define CAPACITY_PER_SEC (1000 / ATTACH_COST_MS)
+#define WINDOW_MS 10000
+#define NB_WINDOWS (SIMULATION_MS / WINDOW_MS)
+#define QUEUE_SIZE (1 << 20)
+
+typedef struct simulated_ue_s {
+  bool waiting; /* for the answer to the attach request sent at sent_ms */
+  bool attached;
+  int64_t sent_ms;
+  int next_attach; /* UEs attaching at the same ms */
+  int next_timeout;
+} simulated_ue_t;
+
+typedef struct attach_request_s {
+  int ue;
+  int64_t sent_ms;
+} attach_request_t;
+
+static simulated_ue_t ues[NB_UES];
+static int attach_at[SIMULATION_MS];
+static int timeout_at[SIMULATION_MS];
+static attach_request_t queue[QUEUE_SIZE];
+
+static void schedule_attach(int ue, int64_t at_ms) {
+  if (at_ms < SIMULATION_MS) {
+    ues[ue].next_attach = attach_at[at_ms];
+    attach_at[at_ms]    = ue;
+  }
+}
+
+static void send_attach(int ue, int64_t now, uint32_t* tail) {
+  simulated_ue_t* u = &ues[ue];
+
+  u->waiting = true;
+  u->sent_ms = now;
+  if (now + T3410_MS < SIMULATION_MS) {
+    u->next_timeout            = timeout_at[now + T3410_MS];
+    timeout_at[now + T3410_MS] = ue;
+  }
+  queue[(*tail)++ % QUEUE_SIZE] = (attach_request_t){ue, now};
+}
+
+static void simulate_attach_storm(
+    bool overload_control, uint32_t goodput[NB_WINDOWS]) {
+  overload_config_t config = {
+      .mme_app_latency_high_ms = 200,
+      .mme_app_latency_low_ms  = 50,
+  };
+  mme_app_overload_t overload;
+  uint32_t head           = 0;
+  uint32_t tail           = 0;
+  int64_t busy_until_ms   = 0;
+  int64_t latency_usec    = 0;
+  int64_t latency_updated = 0;
+  int64_t now             = 0;
+  int ue                  = 0;
+
+  srand(1);
+  mme_app_overload_init(&overload, &config, 0);
+  for (now = 0; now < SIMULATION_MS; now++) {
+    attach_at[now]  = -1;
+    timeout_at[now] = -1;
+  }
+  for (ue = 0; ue < NB_UES; ue++) {
+    ues[ue] = (simulated_ue_t){0};
+    schedule_attach(ue, (int64_t) ue * STORM_MS / NB_UES);
+  }
+  for (now = 0; now < SIMULATION_MS; now++) {
+    for (ue = timeout_at[now]; ue >= 0; ue = ues[ue].next_timeout) {
+      if (ues[ue].waiting && ues[ue].sent_ms + T3410_MS == now) {
+        ues[ue].waiting = false;
+        schedule_attach(ue, now + T3411_MS);
+      }
+    }
+    for (ue = attach_at[now]; ue >= 0; ue = ues[ue].next_attach) {
+      send_attach(ue, now, &tail);
+    }
+    ck_assert_uint_lt(tail - head, QUEUE_SIZE);
+
+    // Same sampling as the MME_APP task: EWMA of the queueing delay,
+    // forgotten after a second without any message
+    if (now % MME_APP_OVERLOAD_TIMER_MS == 0 && overload_control) {
+      mme_app_overload_update(
+          &overload, now - latency_updated > 1000 ? 0 : latency_usec, 0);
+    }
+
+    while (busy_until_ms <= now && head != tail) {
+      attach_request_t* request = &queue[head++ % QUEUE_SIZE];
+      simulated_ue_t* u         = &ues[request->ue];
+      bool answered       = u->waiting && u->sent_ms == request->sent_ms;
+      int64_t wait_usec   = (now - request->sent_ms) * USEC_PER_MSEC;
+
+      latency_usec    = latency_usec + (wait_usec - latency_usec) / 8;
+      latency_updated = now;
+      if (overload_control && overload.overloaded) {
+        busy_until_ms = now + REJECT_COST_MS;
+        if (answered) {
+          uint32_t t3346_sec =
+              mme_app_overload_spread_t3346(T3346_SEC, (uint32_t) rand());
+
+          u->waiting = false;
+          schedule_attach(request->ue, now + (int64_t) t3346_sec * 1000);
+        }
+        continue;
+      }
+      busy_until_ms = now + ATTACH_COST_MS;
+      if (answered && busy_until_ms - request->sent_ms < T3410_MS) {
+        u->waiting  = false;
+        u->attached = true;
+        goodput[busy_until_ms / WINDOW_MS]++;
+      }
+    }
+  }
+}
+
+START_TEST(overload_attach_storm_test) {
+  uint32_t without_control[NB_WINDOWS + 1] = {0};
+  uint32_t with_control[NB_WINDOWS + 1]    = {0};
+  uint32_t attached                        = 0;
+  int window                               = 0;
+
+  simulate_attach_storm(false, without_control);
+  simulate_attach_storm(true, with_control);
+
+  // Without control the MME only serves requests the UEs gave up on
+  for (window = 3; window < NB_WINDOWS; window++) {
+    ck_assert_uint_lt(
+        without_control[window], CAPACITY_PER_SEC * WINDOW_MS / 1000 / 10);
+  }
+  // With control goodput stays flat through the storm and its retries
+  for (window = 0; window < 12; window++) {
+    ck_assert_uint_gt(
+        with_control[window], CAPACITY_PER_SEC * WINDOW_MS / 1000 * 3 / 5);
+    attached += with_control[window];
+  }
+  ck_assert_uint_gt(attached, NB_UES * 3 / 4);
+}
+END_TEST
+
+Suite* overload_suite(void) {
+  Suite* s;
+  TCase* tc_core;
+  TCase* tc_load;
+
+  s = suite_create("MME overload tests");
+
+  tc_core = tcase_create("Overload control");
+  tcase_add_test(tc_core, overload_hysteresis_test);
+  tcase_add_test(tc_core, overload_air_token_bucket_test);
+  tcase_add_test(tc_core, overload_spread_t3346_test);
+  suite_add_tcase(s, tc_core);
+
+  tc_load = tcase_create("Overload load");
+  tcase_set_timeout(tc_load, 300);
+  tcase_add_test(tc_load, overload_attach_storm_test);
+  suite_add_tcase(s, tc_load);
+
+  return s;
+}
+
+int main(void) {
+  int number_failed;
+  Suite* s;
+  SRunner* sr;
+
+  s  = overload_suite();
+  sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,195 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <check.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bstrlib.h"
+#include "dynamic_memory_check.h"
+#include "hashtable.h"
+#include "mme_app_ue_context.h"
+#include "mme_config.h"
+
+#define UE_ID_1 ((mme_ue_s1ap_id_t) 1)
+#define UE_ID_2 ((mme_ue_s1ap_id_t) 2)
+
+// PLMN 001/01, the GUMMEI served in the tests
+static const plmn_t served_plmn = {.mcc_digit1 = 0,
+                                   .mcc_digit2 = 0,
+                                   .mcc_digit3 = 1,
+                                   .mnc_digit1 = 0,
+                                   .mnc_digit2 = 1,
+                                   .mnc_digit3 = 0xf};
+static const plmn_t unserved_plmn = {.mcc_digit1 = 3,
+                                     .mcc_digit2 = 1,
+                                     .mcc_digit3 = 0,
+                                     .mnc_digit1 = 1,
+                                     .mnc_digit2 = 5,
+                                     .mnc_digit3 = 0xf};
+
+static mme_ue_context_t mme_ue_contexts;
+
+static void setup(void) {
+  bstring b = bfromcstr("test_s_tmsi_ue_context_htbl");
+
+  memset(&mme_ue_contexts, 0, sizeof(mme_ue_contexts));
+  mme_ue_contexts.s_tmsi_ue_context_htbl =
+      hashtable_uint64_ts_create(16, hashtable_uint64_mix_hashfunc, b);
+  bdestroy_wrapper(&b);
+
+  mme_config.gummei.nb                 = 1;
+  mme_config.gummei.gummei[0].plmn     = served_plmn;
+  mme_config.gummei.gummei[0].mme_gid  = 4;
+  mme_config.gummei.gummei[0].mme_code = 1;
+}
+
+static void teardown(void) {
+  hashtable_uint64_ts_destroy(mme_ue_contexts.s_tmsi_ue_context_htbl);
+  mme_config.gummei.nb = 0;
+}
+
+static guti_t make_guti(
+    const plmn_t plmn, mme_gid_t mme_gid, mme_code_t mme_code,
+    tmsi_t m_tmsi) {
+  guti_t guti          = {0};
+  guti.gummei.plmn     = plmn;
+  guti.gummei.mme_gid  = mme_gid;
+  guti.gummei.mme_code = mme_code;
+  guti.m_tmsi          = m_tmsi;
+  return guti;
+}
+
+// Returns the UE the index has for the S-TMSI of a GUTI, or 0
+static mme_ue_s1ap_id_t indexed_ue(const guti_t* const guti) {
+  uint64_t mme_ue_s1ap_id64 = 0;
+
+  if (hashtable_uint64_ts_get(
+          mme_ue_contexts.s_tmsi_ue_context_htbl,
+          MME_APP_S_TMSI_KEY(guti->gummei.mme_code, guti->m_tmsi),
+          &mme_ue_s1ap_id64) != HASH_TABLE_OK) {
+    return 0;
+  }
+  return (mme_ue_s1ap_id_t) mme_ue_s1ap_id64;
+}
+
+START_TEST(s_tmsi_index_insert_test) {
+  guti_t guti       = make_guti(served_plmn, 4, 1, 0x12345678);
+  guti_t other_guti = make_guti(served_plmn, 4, 2, 0x12345678);
+
+  mme_app_s_tmsi_index_insert(&mme_ue_contexts, &guti, UE_ID_1);
+  ck_assert_int_eq(indexed_ue(&guti), UE_ID_1);
+  // The MME code is part of the key
+  ck_assert_int_eq(indexed_ue(&other_guti), 0);
+
+  // GUTI reallocation
+  guti_t new_guti = make_guti(served_plmn, 4, 1, 0x9abcdef0);
+  mme_app_s_tmsi_index_remove(&mme_ue_contexts, &guti, UE_ID_1);
+  mme_app_s_tmsi_index_insert(&mme_ue_contexts, &new_guti, UE_ID_1);
+  ck_assert_int_eq(indexed_ue(&guti), 0);
+  ck_assert_int_eq(indexed_ue(&new_guti), UE_ID_1);
+}
+END_TEST
+
+START_TEST(s_tmsi_index_replace_test) {
+  guti_t guti = make_guti(served_plmn, 4, 1, 0x12345678);
+  // Same S-TMSI under another MME group
+  guti_t other_guti = make_guti(served_plmn, 5, 1, 0x12345678);
+
+  mme_app_s_tmsi_index_insert(&mme_ue_contexts, &guti, UE_ID_1);
+  mme_app_s_tmsi_index_insert(&mme_ue_contexts, &other_guti, UE_ID_2);
+  ck_assert_int_eq(indexed_ue(&guti), UE_ID_2);
+  ck_assert_int_eq(mme_ue_contexts.s_tmsi_ue_context_htbl->num_elements, 1);
+}
+END_TEST
+
+START_TEST(s_tmsi_index_remove_test) {
+  guti_t guti = make_guti(served_plmn, 4, 1, 0x12345678);
+
+  mme_app_s_tmsi_index_insert(&mme_ue_contexts, &guti, UE_ID_1);
+  // The S-TMSI was allocated to another UE since
+  mme_app_s_tmsi_index_insert(&mme_ue_contexts, &guti, UE_ID_2);
+  mme_app_s_tmsi_index_remove(&mme_ue_contexts, &guti, UE_ID_1);
+  ck_assert_int_eq(indexed_ue(&guti), UE_ID_2);
+
+  mme_app_s_tmsi_index_remove(&mme_ue_contexts, &guti, UE_ID_2);
+  ck_assert_int_eq(indexed_ue(&guti), 0);
+  // Removing a missing entry is a no-op
+  mme_app_s_tmsi_index_remove(&mme_ue_contexts, &guti, UE_ID_2);
+  ck_assert_int_eq(indexed_ue(&guti), 0);
+}
+END_TEST
+
+START_TEST(s_tmsi_index_served_test) {
+  guti_t guti      = make_guti(served_plmn, 4, 1, 0x12345678);
+  s_tmsi_t s_tmsi  = {.mme_code = 1, .m_tmsi = 0x12345678};
+  s_tmsi_t s_tmsi2 = {.mme_code = 2, .m_tmsi = 0x12345678};
+
+  ck_assert(mme_app_is_served_gummei(&guti.gummei));
+  ck_assert(mme_app_is_served_s_tmsi(&served_plmn, &s_tmsi));
+  ck_assert(!mme_app_is_served_s_tmsi(&served_plmn, &s_tmsi2));
+  ck_assert(!mme_app_is_served_s_tmsi(&unserved_plmn, &s_tmsi));
+
+  guti.gummei.mme_gid = 5;
+  ck_assert(!mme_app_is_served_gummei(&guti.gummei));
+  guti.gummei.mme_gid  = 4;
+  guti.gummei.mme_code = 2;
+  ck_assert(!mme_app_is_served_gummei(&guti.gummei));
+}
+END_TEST
+
+START_TEST(s_tmsi_index_unserved_plmn_test) {
+  guti_t guti = make_guti(unserved_plmn, 4, 1, 0x12345678);
+
+  // The index does not key the PLMN, the GUTI is rejected before
+  mme_app_s_tmsi_index_insert(&mme_ue_contexts, &guti, UE_ID_1);
+  ck_assert(!mme_app_is_served_gummei(&guti.gummei));
+  ck_assert_ptr_eq(mme_ue_context_exists_guti(&mme_ue_contexts, &guti), NULL);
+}
+END_TEST
+
+Suite* s_tmsi_index_suite(void) {
+  Suite* s;
+  TCase* tc_core;
+
+  s = suite_create("MME S-TMSI index tests");
+
+  tc_core = tcase_create("S-TMSI index");
+  tcase_add_checked_fixture(tc_core, setup, teardown);
+  tcase_add_test(tc_core, s_tmsi_index_insert_test);
+  tcase_add_test(tc_core, s_tmsi_index_replace_test);
+  tcase_add_test(tc_core, s_tmsi_index_remove_test);
+  tcase_add_test(tc_core, s_tmsi_index_served_test);
+  tcase_add_test(tc_core, s_tmsi_index_unserved_plmn_test);
+  suite_add_tcase(s, tc_core);
+
+  return s;
+}
+
+int main(void) {
+  int number_failed;
+  Suite* s;
+  SRunner* sr;
+
+  s  = s_tmsi_index_suite();
+  sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
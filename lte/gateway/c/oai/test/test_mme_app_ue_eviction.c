@@ -0,0 +1,324 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <check.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "bstrlib.h"
+#include "common_defs.h"
+#include "dynamic_memory_check.h"
+#include "hashtable.h"
+#include "intertask_interface.h"
+#include "mme_app_state.h"
+#include "mme_app_ue_context.h"
+#include "mme_app_ue_eviction.h"
+#include "mme_config.h"
+#include "nas_timer.h"
+
+#define UE_ID ((mme_ue_s1ap_id_t) 7)
+#define UE_IMSI64 ((imsi64_t) 1010000000001)
+#define UE_S11_TEID ((teid_t) 0x1234)
+#define IDLE_TIME_SEC 60
+#define MAX_STORED_UES 4
+
+/*
+ * Stand for the MME state and its data store, only the evicted UE states
+ * are stored
+ */
+static mme_app_desc_t mme_app_desc;
+static hash_table_ts_t* ue_state;
+static ue_mm_context_t* stored_ues[MAX_STORED_UES];
+static int stored_ue_reads;
+
+int mme_nas_state_init(const mme_config_t* mme_config_p) {
+  return RETURNok;
+}
+
+mme_app_desc_t* get_mme_nas_state(bool read_from_db) {
+  return &mme_app_desc;
+}
+
+void put_mme_nas_state(void) {}
+
+void clear_mme_nas_state(void) {}
+
+hash_table_ts_t* get_mme_ue_state(void) {
+  return ue_state;
+}
+
+void put_mme_ue_state(mme_app_desc_t* mme_app_desc_p, imsi64_t imsi64) {}
+
+void delete_mme_ue_state(imsi64_t imsi64) {}
+
+static ue_mm_context_t** stored_ue(imsi64_t imsi64) {
+  for (int i = 0; i < MAX_STORED_UES; i++) {
+    if (stored_ues[i] && stored_ues[i]->emm_context._imsi64 == imsi64) {
+      return &stored_ues[i];
+    }
+  }
+  return NULL;
+}
+
+int put_evicted_mme_ue_states(
+    const ue_mm_context_t* const* ue_contexts, int nb_ue_contexts) {
+  for (int i = 0; i < nb_ue_contexts; i++) {
+    ue_mm_context_t** slot = NULL;
+
+    for (int j = 0; !slot && j < MAX_STORED_UES; j++) {
+      if (!stored_ues[j]) {
+        slot = &stored_ues[j];
+      }
+    }
+    ck_assert_ptr_ne(slot, NULL);
+    *slot = malloc(sizeof(ue_mm_context_t));
+    memcpy(*slot, ue_contexts[i], sizeof(ue_mm_context_t));
+  }
+  return RETURNok;
+}
+
+int get_evicted_mme_ue_state(imsi64_t imsi64, ue_mm_context_t* ue_context) {
+  ue_mm_context_t** slot = stored_ue(imsi64);
+
+  stored_ue_reads++;
+  if (!slot) {
+    return RETURNerror;
+  }
+  memcpy(ue_context, *slot, sizeof(*ue_context));
+  return RETURNok;
+}
+
+void delete_evicted_mme_ue_state(imsi64_t imsi64) {
+  ue_mm_context_t** slot = stored_ue(imsi64);
+
+  if (slot) {
+    free_wrapper((void**) slot);
+  }
+}
+
+static void idle_ue_init(ue_mm_context_t* ue_context_p) {
+  memset(ue_context_p, 0, sizeof(*ue_context_p));
+  ue_context_p->mm_state                           = UE_REGISTERED;
+  ue_context_p->ecm_state                          = ECM_IDLE;
+  ue_context_p->initial_context_setup_rsp_timer.id = MME_APP_TIMER_INACTIVE_ID;
+  ue_context_p->ue_context_modification_timer.id   = MME_APP_TIMER_INACTIVE_ID;
+  ue_context_p->paging_response_timer.id           = MME_APP_TIMER_INACTIVE_ID;
+  ue_context_p->ulr_response_timer.id              = MME_APP_TIMER_INACTIVE_ID;
+  ue_context_p->emm_context.T3422.id               = NAS_TIMER_INACTIVE_ID;
+  ue_context_p->emm_context.esm_ctx.T3489.id       = NAS_TIMER_INACTIVE_ID;
+}
+
+START_TEST(ue_eviction_evictable_test) {
+  ue_mm_context_t* ue_context_p = calloc(1, sizeof(*ue_context_p));
+  bearer_context_t bearer       = {0};
+
+  idle_ue_init(ue_context_p);
+  ck_assert(mme_app_ue_is_evictable(ue_context_p));
+
+  ue_context_p->ecm_state = ECM_CONNECTED;
+  ck_assert(!mme_app_ue_is_evictable(ue_context_p));
+  ue_context_p->ecm_state = ECM_IDLE;
+  ue_context_p->mm_state  = UE_UNREGISTERED;
+  ck_assert(!mme_app_ue_is_evictable(ue_context_p));
+  ue_context_p->mm_state = UE_REGISTERED;
+
+  // Paging in progress
+  ue_context_p->paging_response_timer.id = 1;
+  ck_assert(!mme_app_ue_is_evictable(ue_context_p));
+  ue_context_p->paging_response_timer.id = MME_APP_TIMER_INACTIVE_ID;
+
+  // Network initiated detach in progress
+  ue_context_p->emm_context.T3422.id = 1;
+  ck_assert(!mme_app_ue_is_evictable(ue_context_p));
+  ue_context_p->emm_context.T3422.id = NAS_TIMER_INACTIVE_ID;
+
+  // Bearer procedure in progress
+  bearer.esm_ebr_context.timer.id  = NAS_TIMER_INACTIVE_ID;
+  ue_context_p->bearer_contexts[5] = &bearer;
+  ck_assert(mme_app_ue_is_evictable(ue_context_p));
+  bearer.esm_ebr_context.timer.id = 1;
+  ck_assert(!mme_app_ue_is_evictable(ue_context_p));
+
+  free(ue_context_p);
+}
+END_TEST
+
+START_TEST(ue_eviction_wake_time_test) {
+  ue_mm_context_t* ue_context_p = calloc(1, sizeof(*ue_context_p));
+
+  idle_ue_init(ue_context_p);
+  ck_assert_int_eq(mme_app_ue_eviction_wake_time(ue_context_p), 0);
+
+  ue_context_p->mobile_reachability_timer.sec          = 3240;
+  ue_context_p->time_mobile_reachability_timer_started = 1000;
+  ck_assert_int_eq(mme_app_ue_eviction_wake_time(ue_context_p), 4240);
+
+  // Implicit detach runs after the mobile reachability timer expired
+  ue_context_p->time_mobile_reachability_timer_started = 0;
+  ue_context_p->implicit_detach_timer.sec              = 3240;
+  ue_context_p->time_implicit_detach_timer_started     = 5000;
+  ck_assert_int_eq(mme_app_ue_eviction_wake_time(ue_context_p), 8240);
+
+  ue_context_p->time_mobile_reachability_timer_started = 4000;
+  ck_assert_int_eq(mme_app_ue_eviction_wake_time(ue_context_p), 7240);
+
+  free(ue_context_p);
+}
+END_TEST
+
+static task_zmq_ctx_t task_zmq_ctx;
+
+static void eviction_setup(void) {
+  mme_ue_context_t* contexts = &mme_app_desc.mme_ue_contexts;
+  bstring b                  = bfromcstr("test_ue_state");
+
+  memset(&mme_app_desc, 0, sizeof(mme_app_desc));
+  stored_ue_reads = 0;
+  ue_state        = hashtable_ts_create(16, NULL, free_wrapper, b);
+  btrunc(b, 0);
+  bcatcstr(b, "test_imsi_mme_ue_id_htbl");
+  contexts->imsi_mme_ue_id_htbl = hashtable_uint64_ts_create(16, NULL, b);
+  btrunc(b, 0);
+  bcatcstr(b, "test_tun11_ue_context_htbl");
+  contexts->tun11_ue_context_htbl = hashtable_uint64_ts_create(16, NULL, b);
+  bdestroy_wrapper(&b);
+
+  mme_config.ue_eviction_config.idle_time_sec = IDLE_TIME_SEC;
+  mme_config.ue_eviction_config.max_per_sweep = 0;
+  task_zmq_ctx.event_loop                     = zloop_new();
+  mme_app_ue_eviction_start(&task_zmq_ctx);
+}
+
+static void eviction_teardown(void) {
+  mme_ue_context_t* contexts = &mme_app_desc.mme_ue_contexts;
+
+  mme_app_ue_eviction_stop(&task_zmq_ctx);
+  zloop_destroy(&task_zmq_ctx.event_loop);
+  mme_config.ue_eviction_config.idle_time_sec = 0;
+  hashtable_ts_destroy(ue_state);
+  hashtable_uint64_ts_destroy(contexts->imsi_mme_ue_id_htbl);
+  hashtable_uint64_ts_destroy(contexts->tun11_ue_context_htbl);
+  for (int i = 0; i < MAX_STORED_UES; i++) {
+    free_wrapper((void**) &stored_ues[i]);
+  }
+}
+
+// Adds an idle UE to the MME state and evicts it
+static void evict_ue(void) {
+  mme_ue_context_t* contexts    = &mme_app_desc.mme_ue_contexts;
+  ue_mm_context_t* ue_context_p = calloc(1, sizeof(*ue_context_p));
+
+  idle_ue_init(ue_context_p);
+  ue_context_p->mme_ue_s1ap_id      = UE_ID;
+  ue_context_p->emm_context._imsi64 = UE_IMSI64;
+  ue_context_p->mme_teid_s11        = UE_S11_TEID;
+  hashtable_ts_insert(ue_state, (const hash_key_t) UE_ID, ue_context_p);
+  hashtable_uint64_ts_insert(
+      contexts->imsi_mme_ue_id_htbl, (const hash_key_t) UE_IMSI64, UE_ID);
+  hashtable_uint64_ts_insert(
+      contexts->tun11_ue_context_htbl, (const hash_key_t) UE_S11_TEID, UE_ID);
+
+  mme_app_ue_eviction_ue_idle(ue_context_p);
+  mme_app_ue_eviction_sweep(time(NULL) + IDLE_TIME_SEC);
+  ck_assert_ptr_eq(mme_ue_context_exists_mme_ue_s1ap_id(UE_ID), NULL);
+  ck_assert_ptr_ne(stored_ue(UE_IMSI64), NULL);
+}
+
+// The HSS addresses the UE by IMSI: Cancel Location, detach, new attach
+START_TEST(ue_eviction_imsi_lookup_test) {
+  mme_ue_context_t* contexts    = &mme_app_desc.mme_ue_contexts;
+  ue_mm_context_t* ue_context_p = NULL;
+
+  evict_ue();
+  ck_assert_ptr_eq(mme_ue_context_exists_imsi(contexts, UE_IMSI64 + 1), NULL);
+  ck_assert_int_eq(stored_ue_reads, 0);
+
+  ue_context_p = mme_ue_context_exists_imsi(contexts, UE_IMSI64);
+  ck_assert_ptr_ne(ue_context_p, NULL);
+  ck_assert_int_eq(ue_context_p->mme_ue_s1ap_id, UE_ID);
+  ck_assert_uint_eq(ue_context_p->emm_context._imsi64, UE_IMSI64);
+  ck_assert_ptr_eq(mme_ue_context_exists_mme_ue_s1ap_id(UE_ID), ue_context_p);
+  // Read back once, the data store record is gone
+  ck_assert_ptr_eq(stored_ue(UE_IMSI64), NULL);
+  ck_assert_ptr_eq(
+      mme_ue_context_exists_imsi(contexts, UE_IMSI64), ue_context_p);
+  ck_assert_int_eq(stored_ue_reads, 1);
+}
+END_TEST
+
+// The SGW addresses the UE by S11 TEID: Create and Delete Bearer Request
+START_TEST(ue_eviction_s11_teid_lookup_test) {
+  mme_ue_context_t* contexts    = &mme_app_desc.mme_ue_contexts;
+  ue_mm_context_t* ue_context_p = NULL;
+
+  evict_ue();
+  ue_context_p = mme_ue_context_exists_s11_teid(contexts, UE_S11_TEID);
+  ck_assert_ptr_ne(ue_context_p, NULL);
+  ck_assert_int_eq(ue_context_p->mme_ue_s1ap_id, UE_ID);
+  ck_assert_uint_eq(ue_context_p->mme_teid_s11, UE_S11_TEID);
+  ck_assert_ptr_eq(stored_ue(UE_IMSI64), NULL);
+
+  // Evicted again once idle again, and found by IMSI
+  mme_app_ue_eviction_sweep(time(NULL) + IDLE_TIME_SEC);
+  ck_assert_ptr_eq(mme_ue_context_exists_mme_ue_s1ap_id(UE_ID), NULL);
+  ck_assert_ptr_ne(mme_ue_context_exists_imsi(contexts, UE_IMSI64), NULL);
+  ck_assert_int_eq(stored_ue_reads, 2);
+}
+END_TEST
+
+// What an idle UE keeps in memory, before and after its eviction
+START_TEST(ue_eviction_footprint_test) {
+  ck_assert_uint_lt(sizeof(mme_app_evicted_ue_t) * 10, sizeof(ue_mm_context_t));
+}
+END_TEST
+
+Suite* ue_eviction_suite(void) {
+  Suite* s;
+  TCase* tc_core;
+  TCase* tc_lookup;
+
+  s = suite_create("MME UE eviction tests");
+
+  tc_core = tcase_create("UE eviction");
+  tcase_add_test(tc_core, ue_eviction_evictable_test);
+  tcase_add_test(tc_core, ue_eviction_wake_time_test);
+  tcase_add_test(tc_core, ue_eviction_footprint_test);
+  suite_add_tcase(s, tc_core);
+
+  tc_lookup = tcase_create("Evicted UE lookups");
+  tcase_add_checked_fixture(tc_lookup, eviction_setup, eviction_teardown);
+  tcase_add_test(tc_lookup, ue_eviction_imsi_lookup_test);
+  tcase_add_test(tc_lookup, ue_eviction_s11_teid_lookup_test);
+  suite_add_tcase(s, tc_lookup);
+
+  return s;
+}
+
+int main(void) {
+  int number_failed;
+  Suite* s;
+  SRunner* sr;
+
+  s  = ue_eviction_suite();
+  sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,284 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <check.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bstrlib.h"
+#include "TLVDecoder.h"
+#include "nas_message.h"
+#include "3gpp_24.008.h"
+
+/*
+ * nas_message_decode_view() has to decode the same message as
+ * nas_message_decode(), with its octet string IEs as views instead of
+ * heap copies
+ */
+
+// Attach Request, IMSI 001010000000001, ESM container holding a PDN
+// Connectivity Request with ESM information transfer flag and PCO
+static const uint8_t attach_request[] = {
+    0x07, 0x41, 0x71, 0x08, 0x09, 0x10, 0x10, 0x00, 0x00, 0x00, 0x00, 0x10,
+    0x02, 0xe0, 0xe0, 0x00, 0x21, 0x02, 0x01, 0xd0, 0x11, 0xd1, 0x27, 0x1a,
+    0x80, 0x80, 0x21, 0x10, 0x01, 0x00, 0x00, 0x10, 0x81, 0x06, 0x00, 0x00,
+    0x00, 0x00, 0x83, 0x06, 0x00, 0x00, 0x00, 0x00, 0x00, 0x0d, 0x00, 0x00,
+    0x0a, 0x00, 0x52, 0x00, 0xf1, 0x10, 0x00, 0x01, 0x5c, 0x0a, 0x00, 0x31,
+    0x03, 0xe5, 0xe0, 0x3e, 0x5d, 0x01, 0x03};
+
+// Integrity protected Tracking Area Update Request, old GUTI and supported
+// codecs
+static const uint8_t tau_request[] = {
+    0x17, 0x00, 0x00, 0x00, 0x00, 0x01, 0x07, 0x48, 0x00, 0x0b, 0xf6,
+    0x00, 0xf1, 0x10, 0x80, 0x01, 0x01, 0xc2, 0x00, 0x00, 0x01, 0x58,
+    0x02, 0xe0, 0xe0, 0x52, 0x00, 0xf1, 0x10, 0x00, 0x01, 0x5c, 0x0a,
+    0x00, 0x57, 0x02, 0x20, 0x00, 0x31, 0x03, 0xe5, 0xe0, 0x3e, 0x40,
+    0x04, 0x04, 0x02, 0x60, 0x04, 0x5d, 0x01, 0x03};
+
+// Standalone PDN Connectivity Request, APN "internet" and PCO
+static const uint8_t pdn_connectivity_request[] = {
+    0x02, 0x01, 0xd0, 0x11, 0x28, 0x09, 0x08, 0x69, 0x6e, 0x74, 0x65,
+    0x72, 0x6e, 0x65, 0x74, 0x27, 0x1a, 0x80, 0x80, 0x21, 0x10, 0x01,
+    0x00, 0x00, 0x10, 0x81, 0x06, 0x00, 0x00, 0x00, 0x00, 0x83, 0x06,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x0d, 0x00, 0x00, 0x0a, 0x00};
+
+static nas_message_decode_arena_t arena;
+static nas_message_t heap_msg;
+static nas_message_t view_msg;
+static nas_message_decode_status_t heap_status;
+static nas_message_decode_status_t view_status;
+
+static void setup(void) {
+  memset(&heap_msg, 0, sizeof(heap_msg));
+  memset(&view_msg, 0, sizeof(view_msg));
+  memset(&heap_status, 0, sizeof(heap_status));
+  memset(&view_status, 0, sizeof(view_status));
+}
+
+// Decodes pdu both ways, the results have to match
+static void decode_both(const uint8_t* pdu, size_t length) {
+  int heap_rc = nas_message_decode(pdu, &heap_msg, length, NULL, &heap_status);
+  int view_rc = nas_message_decode_view(
+      pdu, &view_msg, length, NULL, &view_status, &arena);
+
+  ck_assert_int_gt(heap_rc, 0);
+  ck_assert_int_eq(view_rc, heap_rc);
+  ck_assert_int_eq(memcmp(&view_status, &heap_status, sizeof(heap_status)), 0);
+  ck_assert_int_eq(
+      memcmp(&view_msg.header, &heap_msg.header, sizeof(heap_msg.header)), 0);
+}
+
+// view has to be a write-protected view into pdu or the arena
+static void assert_view(const_bstring view, const uint8_t* pdu, size_t length) {
+  ck_assert_ptr_ne(view, NULL);
+  ck_assert_int_le(view->mlen, 0);
+  ck_assert(
+      ((view->data >= pdu) && (view->data + view->slen <= pdu + length)) ||
+      ((view->data >= arena.buffer) &&
+       (view->data + view->slen <= arena.buffer + sizeof(arena.buffer))));
+}
+
+// heap has to be an owned copy with the contents of view
+static void assert_same_octets(const_bstring heap, const_bstring view) {
+  ck_assert_ptr_ne(heap, NULL);
+  ck_assert_int_gt(heap->mlen, 0);
+  ck_assert_ptr_ne(heap->data, view->data);
+  ck_assert_int_eq(biseq(heap, view), 1);
+}
+
+static void assert_same_pco(
+    const protocol_configuration_options_t* heap,
+    const protocol_configuration_options_t* view, const uint8_t* pdu,
+    size_t length) {
+  ck_assert_int_gt(heap->num_protocol_or_container_id, 0);
+  ck_assert_int_eq(
+      view->num_protocol_or_container_id, heap->num_protocol_or_container_id);
+  for (int i = 0; i < heap->num_protocol_or_container_id; i++) {
+    const pco_protocol_or_container_id_t* heap_id =
+        &heap->protocol_or_container_ids[i];
+    const pco_protocol_or_container_id_t* view_id =
+        &view->protocol_or_container_ids[i];
+
+    ck_assert_int_eq(view_id->id, heap_id->id);
+    ck_assert_int_eq(view_id->length, heap_id->length);
+    if (!heap_id->contents) {
+      // Empty contents are not decoded
+      ck_assert_ptr_eq(view_id->contents, NULL);
+      continue;
+    }
+    assert_view(view_id->contents, pdu, length);
+    assert_same_octets(heap_id->contents, view_id->contents);
+  }
+}
+
+START_TEST(nas_message_decode_view_attach_request_test) {
+  decode_both(attach_request, sizeof(attach_request));
+
+  attach_request_msg* heap = &heap_msg.plain.emm.attach_request;
+  attach_request_msg* view = &view_msg.plain.emm.attach_request;
+  ck_assert_int_eq(view->messagetype, ATTACH_REQUEST);
+  ck_assert_int_eq(
+      memcmp(
+          &view->oldgutiorimsi, &heap->oldgutiorimsi,
+          sizeof(heap->oldgutiorimsi)),
+      0);
+  ck_assert_int_eq(
+      memcmp(
+          &view->uenetworkcapability, &heap->uenetworkcapability,
+          sizeof(heap->uenetworkcapability)),
+      0);
+  assert_view(
+      view->esmmessagecontainer, attach_request, sizeof(attach_request));
+  assert_same_octets(heap->esmmessagecontainer, view->esmmessagecontainer);
+
+  // Views are not freed, owned copies are
+  bdestroy(view->esmmessagecontainer);
+  bdestroy(heap->esmmessagecontainer);
+}
+END_TEST
+
+START_TEST(nas_message_decode_view_tau_request_test) {
+  decode_both(tau_request, sizeof(tau_request));
+
+  tracking_area_update_request_msg* heap =
+      &heap_msg.plain.emm.tracking_area_update_request;
+  tracking_area_update_request_msg* view =
+      &view_msg.plain.emm.tracking_area_update_request;
+  ck_assert_int_eq(view->messagetype, TRACKING_AREA_UPDATE_REQUEST);
+  ck_assert_int_eq(
+      memcmp(&view->oldguti, &heap->oldguti, sizeof(heap->oldguti)), 0);
+  ck_assert_int_eq(view->presencemask, heap->presencemask);
+  assert_view(view->supportedcodecs, tau_request, sizeof(tau_request));
+  assert_same_octets(heap->supportedcodecs, view->supportedcodecs);
+
+  bdestroy(heap->supportedcodecs);
+}
+END_TEST
+
+START_TEST(nas_message_decode_view_pdn_connectivity_request_test) {
+  decode_both(pdn_connectivity_request, sizeof(pdn_connectivity_request));
+
+  pdn_connectivity_request_msg* heap =
+      &heap_msg.plain.esm.pdn_connectivity_request;
+  pdn_connectivity_request_msg* view =
+      &view_msg.plain.esm.pdn_connectivity_request;
+  ck_assert_int_eq(view->messagetype, PDN_CONNECTIVITY_REQUEST);
+  ck_assert_int_eq(view->pdntype, heap->pdntype);
+  ck_assert_int_eq(view->requesttype, heap->requesttype);
+  ck_assert_int_eq(view->presencemask, heap->presencemask);
+  assert_same_pco(
+      &heap->protocolconfigurationoptions, &view->protocolconfigurationoptions,
+      pdn_connectivity_request, sizeof(pdn_connectivity_request));
+  // The APN is rebuilt from its labels, an owned string either way
+  ck_assert_int_gt(view->accesspointname->mlen, 0);
+  ck_assert_int_eq(biseq(view->accesspointname, heap->accesspointname), 1);
+
+  bdestroy(heap->accesspointname);
+  bdestroy(view->accesspointname);
+  clear_protocol_configuration_options(&heap->protocolconfigurationoptions);
+  clear_protocol_configuration_options(&view->protocolconfigurationoptions);
+}
+END_TEST
+
+START_TEST(nas_message_decode_view_take_test) {
+  decode_both(pdn_connectivity_request, sizeof(pdn_connectivity_request));
+  pdn_connectivity_request_msg* heap =
+      &heap_msg.plain.esm.pdn_connectivity_request;
+  pdn_connectivity_request_msg* view =
+      &view_msg.plain.esm.pdn_connectivity_request;
+  bstring* heap_ipcp = &heap->protocolconfigurationoptions
+                            .protocol_or_container_ids[0]
+                            .contents;
+  bstring* view_ipcp = &view->protocolconfigurationoptions
+                            .protocol_or_container_ids[0]
+                            .contents;
+
+  // A taken view is copied, a taken owned string handed over
+  bstring heap_contents  = *heap_ipcp;
+  bstring taken_contents = tlv_decode_take_bstring(view_ipcp);
+  ck_assert_ptr_eq(*view_ipcp, NULL);
+  assert_same_octets(taken_contents, heap_contents);
+  ck_assert_ptr_eq(tlv_decode_take_bstring(heap_ipcp), heap_contents);
+  ck_assert_ptr_eq(*heap_ipcp, NULL);
+
+  // The copy outlives the next decode into the arena, which reuses its views
+  bdestroy(heap->accesspointname);
+  bdestroy(view->accesspointname);
+  clear_protocol_configuration_options(&heap->protocolconfigurationoptions);
+  memset(&view_msg, 0, sizeof(view_msg));
+  ck_assert_int_gt(
+      nas_message_decode_view(
+          attach_request, &view_msg, sizeof(attach_request), NULL,
+          &view_status, &arena),
+      0);
+  ck_assert_int_eq(biseq(taken_contents, heap_contents), 1);
+
+  bdestroy(taken_contents);
+  bdestroy(heap_contents);
+}
+END_TEST
+
+START_TEST(nas_message_decode_view_uninstalls_arena_test) {
+  const uint8_t octets[] = {0x01, 0x02, 0x03};
+  bstring decoded        = NULL;
+
+  decode_both(attach_request, sizeof(attach_request));
+  bdestroy(heap_msg.plain.emm.attach_request.esmmessagecontainer);
+
+  // Outside of nas_message_decode_view() the arena is not installed anymore
+  ck_assert_int_eq(
+      decode_bstring(&decoded, sizeof(octets), octets, sizeof(octets)),
+      sizeof(octets));
+  ck_assert_ptr_ne(decoded, NULL);
+  ck_assert_int_gt(decoded->mlen, 0);
+  ck_assert_ptr_ne(decoded->data, octets);
+  bdestroy(decoded);
+}
+END_TEST
+
+Suite* nas_message_decode_view_suite(void) {
+  Suite* s;
+  TCase* tc_core;
+
+  s = suite_create("NAS message decode view tests");
+
+  tc_core = tcase_create("Decode");
+  tcase_add_checked_fixture(tc_core, setup, NULL);
+  tcase_add_test(tc_core, nas_message_decode_view_attach_request_test);
+  tcase_add_test(tc_core, nas_message_decode_view_tau_request_test);
+  tcase_add_test(
+      tc_core, nas_message_decode_view_pdn_connectivity_request_test);
+  tcase_add_test(tc_core, nas_message_decode_view_take_test);
+  tcase_add_test(tc_core, nas_message_decode_view_uninstalls_arena_test);
+  suite_add_tcase(s, tc_core);
+
+  return s;
+}
+
+int main(void) {
+  int number_failed;
+  Suite* s;
+  SRunner* sr;
+
+  s  = nas_message_decode_view_suite();
+  sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,229 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <check.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "bstrlib.h"
+#include "common_defs.h"
+#include "procedure_trace.h"
+
+/* Every trace is sampled, the ended ones are the lines of TRACES */
+#define TRACES "/tmp/test_procedure_trace.json"
+#define MAX_TRACES 4
+
+#define IMSI64 1010000000001
+#define MME_UE_S1AP_ID 7
+#define ENB_S1AP_ID_KEY 0x1234
+
+#define NB_THREADS 4
+#define NB_THREAD_PROCEDURES 10000
+
+static char traces[MAX_TRACES][1024];
+
+static void setup(void) {
+  procedure_trace_config_t config = {0};
+
+  unlink(TRACES);
+  config.enabled     = true;
+  config.sample_rate = 1;
+  config.file        = bfromcstr(TRACES);
+  ck_assert_int_eq(procedure_trace_init(&config), RETURNok);
+  bdestroy(config.file);
+}
+
+static void teardown(void) {
+  procedure_trace_exit();
+  unlink(TRACES);
+}
+
+// Reads the ended traces into traces, returns their number
+static int read_traces(void) {
+  int nb_traces = 0;
+  FILE* fp      = fopen(TRACES, "r");
+
+  if (!fp) {
+    return 0;
+  }
+  while (nb_traces < MAX_TRACES &&
+         fgets(traces[nb_traces], sizeof(traces[nb_traces]), fp)) {
+    nb_traces++;
+  }
+  fclose(fp);
+  return nb_traces;
+}
+
+START_TEST(procedure_trace_end_test) {
+  trace_key_t key = TRACE_KEY_MME_UE_S1AP_ID(MME_UE_S1AP_ID);
+
+  procedure_trace_start(key, TRACE_PROCEDURE_ATTACH);
+  procedure_trace_span_start(key, TRACE_STAGE_S6A_AIR);
+  procedure_trace_span_end(key, TRACE_STAGE_S6A_AIR);
+  // Only a started span ends
+  procedure_trace_span_end(key, TRACE_STAGE_S6A_ULR);
+  procedure_trace_task_message(1);
+  procedure_trace_task_span(key, TRACE_STAGE_NAS);
+  procedure_trace_task_message(0);
+
+  // Another procedure does not end the trace
+  procedure_trace_end(key, TRACE_PROCEDURE_DETACH);
+  ck_assert_int_eq(read_traces(), 0);
+
+  procedure_trace_end(key, TRACE_PROCEDURE_ATTACH);
+  ck_assert_int_eq(read_traces(), 1);
+  ck_assert(strstr(traces[0], "\"procedure\":\"attach\""));
+  ck_assert(strstr(traces[0], "\"mme_ue_s1ap_id\":7"));
+  ck_assert(strstr(traces[0], "\"stage\":\"s6a_air\""));
+  ck_assert(strstr(traces[0], "\"stage\":\"nas\""));
+  ck_assert(!strstr(traces[0], "\"stage\":\"s6a_ulr\""));
+
+  // It ends once
+  procedure_trace_end(key, TRACE_PROCEDURE_ATTACH);
+  ck_assert_int_eq(read_traces(), 1);
+}
+END_TEST
+
+START_TEST(procedure_trace_alias_test) {
+  trace_key_t enb_key  = TRACE_KEY_ENB_S1AP_ID(ENB_S1AP_ID_KEY);
+  trace_key_t mme_key  = TRACE_KEY_MME_UE_S1AP_ID(MME_UE_S1AP_ID);
+  trace_key_t imsi_key = TRACE_KEY_IMSI(IMSI64);
+
+  // The procedure is only known once NAS decoded the message
+  procedure_trace_start(enb_key, TRACE_PROCEDURE_NONE);
+  procedure_trace_alias(enb_key, mme_key);
+  procedure_trace_start(mme_key, TRACE_PROCEDURE_ATTACH);
+  // Another procedure of the UE is not traced meanwhile
+  procedure_trace_start(mme_key, TRACE_PROCEDURE_SERVICE_REQUEST);
+  procedure_trace_alias(mme_key, imsi_key);
+
+  procedure_trace_end(imsi_key, TRACE_PROCEDURE_SERVICE_REQUEST);
+  ck_assert_int_eq(read_traces(), 0);
+  procedure_trace_end(imsi_key, TRACE_PROCEDURE_ATTACH);
+  ck_assert_int_eq(read_traces(), 1);
+  ck_assert(strstr(traces[0], "\"procedure\":\"attach\""));
+  ck_assert(strstr(traces[0], "\"imsi\":\"001010000000001\""));
+  ck_assert(strstr(traces[0], "\"mme_ue_s1ap_id\":7"));
+
+  // All the keys of an ended trace are released
+  procedure_trace_start(imsi_key, TRACE_PROCEDURE_TAU);
+  procedure_trace_end(mme_key, TRACE_PROCEDURE_TAU);
+  procedure_trace_end(enb_key, TRACE_PROCEDURE_TAU);
+  ck_assert_int_eq(read_traces(), 1);
+  procedure_trace_end(imsi_key, TRACE_PROCEDURE_TAU);
+  ck_assert_int_eq(read_traces(), 2);
+  ck_assert(strstr(traces[1], "\"procedure\":\"tau\""));
+  ck_assert(!strstr(traces[1], "\"mme_ue_s1ap_id\""));
+}
+END_TEST
+
+START_TEST(procedure_trace_abort_test) {
+  trace_key_t mme_key  = TRACE_KEY_MME_UE_S1AP_ID(MME_UE_S1AP_ID);
+  trace_key_t imsi_key = TRACE_KEY_IMSI(IMSI64);
+
+  procedure_trace_start(mme_key, TRACE_PROCEDURE_ATTACH);
+  procedure_trace_alias(mme_key, imsi_key);
+  procedure_trace_abort(imsi_key);
+  procedure_trace_end(mme_key, TRACE_PROCEDURE_ATTACH);
+  ck_assert_int_eq(read_traces(), 0);
+
+  // Aliasing to the key of another trace drops that trace
+  procedure_trace_start(imsi_key, TRACE_PROCEDURE_DETACH);
+  procedure_trace_start(mme_key, TRACE_PROCEDURE_ATTACH);
+  procedure_trace_alias(mme_key, imsi_key);
+  procedure_trace_end(imsi_key, TRACE_PROCEDURE_DETACH);
+  ck_assert_int_eq(read_traces(), 0);
+  procedure_trace_end(imsi_key, TRACE_PROCEDURE_ATTACH);
+  ck_assert_int_eq(read_traces(), 1);
+  ck_assert(strstr(traces[0], "\"procedure\":\"attach\""));
+}
+END_TEST
+
+static void* trace_procedures(void* args) {
+  uint32_t first = *(uint32_t*) args;
+  uint32_t i     = 0;
+
+  for (i = first; i < first + NB_THREAD_PROCEDURES; i++) {
+    trace_key_t key = TRACE_KEY_MME_UE_S1AP_ID(i);
+
+    procedure_trace_start(key, TRACE_PROCEDURE_SERVICE_REQUEST);
+    procedure_trace_span_start(key, TRACE_STAGE_ENB);
+    procedure_trace_span_end(key, TRACE_STAGE_ENB);
+    procedure_trace_end(key, TRACE_PROCEDURE_SERVICE_REQUEST);
+  }
+  return NULL;
+}
+
+START_TEST(procedure_trace_exit_test) {
+  pthread_t threads[NB_THREADS];
+  uint32_t firsts[NB_THREADS];
+  int i = 0;
+
+  // The tasks may still be tracing when the MME exits
+  for (i = 0; i < NB_THREADS; i++) {
+    firsts[i] = i * NB_THREAD_PROCEDURES;
+    ck_assert_int_eq(
+        pthread_create(&threads[i], NULL, trace_procedures, &firsts[i]), 0);
+  }
+  usleep(1000);
+  procedure_trace_exit();
+  for (i = 0; i < NB_THREADS; i++) {
+    pthread_join(threads[i], NULL);
+  }
+
+  // Tracing is a no-op afterwards
+  unlink(TRACES);
+  procedure_trace_start(
+      TRACE_KEY_MME_UE_S1AP_ID(MME_UE_S1AP_ID), TRACE_PROCEDURE_ATTACH);
+  procedure_trace_end(
+      TRACE_KEY_MME_UE_S1AP_ID(MME_UE_S1AP_ID), TRACE_PROCEDURE_ATTACH);
+  ck_assert_int_eq(read_traces(), 0);
+}
+END_TEST
+
+Suite* procedure_trace_suite(void) {
+  Suite* s;
+  TCase* tc_core;
+
+  s = suite_create("Procedure trace tests");
+
+  tc_core = tcase_create("Trace");
+  tcase_add_checked_fixture(tc_core, setup, teardown);
+  tcase_add_test(tc_core, procedure_trace_end_test);
+  tcase_add_test(tc_core, procedure_trace_alias_test);
+  tcase_add_test(tc_core, procedure_trace_abort_test);
+  tcase_add_test(tc_core, procedure_trace_exit_test);
+  suite_add_tcase(s, tc_core);
+
+  return s;
+}
+
+int main(void) {
+  int number_failed;
+  Suite* s;
+  SRunner* sr;
+
+  s  = procedure_trace_suite();
+  sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
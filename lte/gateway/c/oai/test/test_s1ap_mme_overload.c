@@ -0,0 +1,130 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <check.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "3gpp_36.413.h"
+#include "bstrlib.h"
+#include "common_defs.h"
+#include "log.h"
+#include "s1ap_common.h"
+#include "s1ap_messages_types.h"
+#include "s1ap_mme_decoder.h"
+#include "s1ap_mme_handlers.h"
+
+// Encodes the overload PDU the eNBs are sent, and decodes it back into pdu
+static void encode_decode_overload(
+    const itti_s1ap_overload_t* overload, S1ap_S1AP_PDU_t* pdu) {
+  uint8_t* buffer = NULL;
+  uint32_t length = 0;
+  bstring raw     = NULL;
+
+  ck_assert_int_eq(
+      s1ap_mme_generate_overload(overload, &buffer, &length), RETURNok);
+  ck_assert_ptr_ne(buffer, NULL);
+  ck_assert_uint_gt(length, 0);
+
+  raw = blk2bstr(buffer, length);
+  free(buffer);
+  memset(pdu, 0, sizeof(*pdu));
+  ck_assert_int_eq(s1ap_mme_decode_pdu(pdu, raw), RETURNok);
+  bdestroy(raw);
+  ck_assert_int_eq(pdu->present, S1ap_S1AP_PDU_PR_initiatingMessage);
+}
+
+START_TEST(s1ap_overload_start_test) {
+  itti_s1ap_overload_t overload = {
+      .overload_action        = OVERLOAD_ACTION_REJECT_NON_EMERGENCY_MO_DT,
+      .traffic_load_reduction = 50};
+  S1ap_S1AP_PDU_t pdu;
+  S1ap_OverloadStart_t* container = NULL;
+  S1ap_OverloadStartIEs_t* ie     = NULL;
+
+  encode_decode_overload(&overload, &pdu);
+  ck_assert_int_eq(
+      pdu.choice.initiatingMessage.procedureCode,
+      S1ap_ProcedureCode_id_OverloadStart);
+  container = &pdu.choice.initiatingMessage.value.choice.OverloadStart;
+
+  S1AP_FIND_PROTOCOLIE_BY_ID(
+      S1ap_OverloadStartIEs_t, ie, container,
+      S1ap_ProtocolIE_ID_id_OverloadResponse, true);
+  ck_assert_ptr_ne(ie, NULL);
+  ck_assert_int_eq(
+      ie->value.choice.OverloadResponse.choice.overloadAction,
+      OVERLOAD_ACTION_REJECT_NON_EMERGENCY_MO_DT);
+  S1AP_FIND_PROTOCOLIE_BY_ID(
+      S1ap_OverloadStartIEs_t, ie, container,
+      S1ap_ProtocolIE_ID_id_TrafficLoadReductionIndication, false);
+  ck_assert_ptr_ne(ie, NULL);
+  ck_assert_int_eq(ie->value.choice.TrafficLoadReductionIndication, 50);
+  ASN_STRUCT_FREE_CONTENTS_ONLY(asn_DEF_S1ap_S1AP_PDU, &pdu);
+
+  // The traffic load reduction is optional
+  overload.traffic_load_reduction = 0;
+  encode_decode_overload(&overload, &pdu);
+  container = &pdu.choice.initiatingMessage.value.choice.OverloadStart;
+  S1AP_FIND_PROTOCOLIE_BY_ID(
+      S1ap_OverloadStartIEs_t, ie, container,
+      S1ap_ProtocolIE_ID_id_TrafficLoadReductionIndication, false);
+  ck_assert_ptr_eq(ie, NULL);
+  ASN_STRUCT_FREE_CONTENTS_ONLY(asn_DEF_S1ap_S1AP_PDU, &pdu);
+}
+END_TEST
+
+START_TEST(s1ap_overload_stop_test) {
+  S1ap_S1AP_PDU_t pdu;
+
+  encode_decode_overload(NULL, &pdu);
+  ck_assert_int_eq(
+      pdu.choice.initiatingMessage.procedureCode,
+      S1ap_ProcedureCode_id_OverloadStop);
+  ck_assert_int_eq(
+      pdu.choice.initiatingMessage.value.present,
+      S1ap_InitiatingMessage__value_PR_OverloadStop);
+  ASN_STRUCT_FREE_CONTENTS_ONLY(asn_DEF_S1ap_S1AP_PDU, &pdu);
+}
+END_TEST
+
+Suite* s1ap_overload_suite(void) {
+  Suite* s;
+  TCase* tc_core;
+
+  s = suite_create("S1AP overload tests");
+
+  tc_core = tcase_create("Overload encoding");
+  tcase_add_test(tc_core, s1ap_overload_start_test);
+  tcase_add_test(tc_core, s1ap_overload_stop_test);
+  suite_add_tcase(s, tc_core);
+
+  return s;
+}
+
+int main(void) {
+  int number_failed;
+  Suite* s;
+  SRunner* sr;
+
+  s  = s1ap_overload_suite();
+  sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
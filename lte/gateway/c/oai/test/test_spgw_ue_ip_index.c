@@ -0,0 +1,190 @@
+/*
+ * Licensed to the OpenAirInterface (OAI) Software Alliance under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.
+ * The OpenAirInterface Software Alliance licenses this file to You under
+ * the terms found in the LICENSE file in the root of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *-------------------------------------------------------------------------------
+ * For more information about the OpenAirInterface (OAI) Software Alliance:
+ *      contact@openairinterface.org
+ */
+#include <check.h>
+#include <arpa/inet.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "common_defs.h"
+#include "spgw_ue_ip_index.h"
+
+#define IMSI64_1 ((imsi64_t) 1010000000001)
+#define IMSI64_2 ((imsi64_t) 1010000000002)
+
+/*
+ * Stands for mobilityd: answers with mobilityd_imsi, or with mobilityd_rc
+ * when it is an error
+ */
+static int mobilityd_calls;
+static int mobilityd_rc;
+static const char* mobilityd_imsi;
+
+int get_subscriber_id_from_ipv4(
+    const struct in_addr* addr, char** subscriber_id) {
+  mobilityd_calls++;
+  if (mobilityd_rc) {
+    return mobilityd_rc;
+  }
+  *subscriber_id = strdup(mobilityd_imsi);
+  return 0;
+}
+
+static void setup(void) {
+  mobilityd_calls = 0;
+  mobilityd_rc    = 0;
+  mobilityd_imsi  = "001010000000009";
+  ck_assert_int_eq(spgw_ue_ip_index_init(), RETURNok);
+}
+
+static void teardown(void) {
+  spgw_ue_ip_index_exit();
+}
+
+static paa_t make_paa(
+    pdn_type_value_t pdn_type, const char* ipv4, const char* ipv6) {
+  paa_t paa    = {0};
+  paa.pdn_type = pdn_type;
+  if (ipv4) {
+    inet_pton(AF_INET, ipv4, &paa.ipv4_address);
+  }
+  if (ipv6) {
+    inet_pton(AF_INET6, ipv6, &paa.ipv6_address);
+  }
+  return paa;
+}
+
+START_TEST(spgw_ue_ip_index_lookup_test) {
+  paa_t paa_v4   = make_paa(IPv4, "192.168.128.11", NULL);
+  paa_t paa_v4v6 = make_paa(IPv4_AND_v6, "192.168.128.12", "2001:db8:0:1::");
+  struct in_addr ue_ipv4;
+  struct in6_addr ue_ipv6;
+  imsi64_t imsi64 = INVALID_IMSI64;
+
+  spgw_add_ue_ip_imsi(&paa_v4, IMSI64_1);
+  spgw_add_ue_ip_imsi(&paa_v4v6, IMSI64_2);
+
+  ck_assert_int_eq(
+      spgw_get_imsi_from_ue_ipv4(&paa_v4.ipv4_address, &imsi64), RETURNok);
+  ck_assert_uint_eq(imsi64, IMSI64_1);
+  ck_assert_int_eq(
+      spgw_get_imsi_from_ue_ipv4(&paa_v4v6.ipv4_address, &imsi64), RETURNok);
+  ck_assert_uint_eq(imsi64, IMSI64_2);
+
+  // Any address in the /64 prefix of the UE
+  inet_pton(AF_INET6, "2001:db8:0:1:a:b:c:d", &ue_ipv6);
+  ck_assert_int_eq(spgw_get_imsi_from_ue_ipv6(&ue_ipv6, &imsi64), RETURNok);
+  ck_assert_uint_eq(imsi64, IMSI64_2);
+  inet_pton(AF_INET6, "2001:db8:0:2::1", &ue_ipv6);
+  ck_assert_int_eq(spgw_get_imsi_from_ue_ipv6(&ue_ipv6, &imsi64), RETURNerror);
+
+  inet_pton(AF_INET, "192.168.128.13", &ue_ipv4);
+  ck_assert_int_eq(spgw_get_imsi_from_ue_ipv4(&ue_ipv4, &imsi64), RETURNerror);
+}
+END_TEST
+
+START_TEST(spgw_ue_ip_index_remove_test) {
+  paa_t paa       = make_paa(IPv4_AND_v6, "192.168.128.11", "2001:db8:0:1::");
+  imsi64_t imsi64 = INVALID_IMSI64;
+
+  spgw_add_ue_ip_imsi(&paa, IMSI64_1);
+  // The address was allocated to another IMSI since
+  spgw_add_ue_ip_imsi(&paa, IMSI64_2);
+  spgw_remove_ue_ip_imsi(&paa, IMSI64_1);
+  ck_assert_int_eq(
+      spgw_get_imsi_from_ue_ipv4(&paa.ipv4_address, &imsi64), RETURNok);
+  ck_assert_uint_eq(imsi64, IMSI64_2);
+  ck_assert_int_eq(
+      spgw_get_imsi_from_ue_ipv6(&paa.ipv6_address, &imsi64), RETURNok);
+  ck_assert_uint_eq(imsi64, IMSI64_2);
+
+  spgw_remove_ue_ip_imsi(&paa, IMSI64_2);
+  ck_assert_int_eq(
+      spgw_get_imsi_from_ue_ipv4(&paa.ipv4_address, &imsi64), RETURNerror);
+  ck_assert_int_eq(
+      spgw_get_imsi_from_ue_ipv6(&paa.ipv6_address, &imsi64), RETURNerror);
+}
+END_TEST
+
+START_TEST(spgw_ue_ip_index_resolve_test) {
+  paa_t paa           = make_paa(IPv4, "192.168.128.11", NULL);
+  struct in_addr ue_ipv4;
+  imsi64_t imsi64     = INVALID_IMSI64;
+  bool from_mobilityd = true;
+
+  // Indexed addresses are resolved without mobilityd
+  spgw_add_ue_ip_imsi(&paa, IMSI64_1);
+  ck_assert_int_eq(
+      spgw_resolve_imsi_from_ue_ipv4(
+          &paa.ipv4_address, &imsi64, &from_mobilityd),
+      RETURNok);
+  ck_assert_uint_eq(imsi64, IMSI64_1);
+  ck_assert(!from_mobilityd);
+  ck_assert_int_eq(mobilityd_calls, 0);
+
+  // Others are asked to mobilityd
+  inet_pton(AF_INET, "192.168.128.12", &ue_ipv4);
+  ck_assert_int_eq(
+      spgw_resolve_imsi_from_ue_ipv4(&ue_ipv4, &imsi64, &from_mobilityd),
+      RETURNok);
+  ck_assert_uint_eq(imsi64, 1010000000009);
+  ck_assert(from_mobilityd);
+  ck_assert_int_eq(mobilityd_calls, 1);
+
+  // Its errors are passed on
+  mobilityd_rc = 5;
+  ck_assert_int_eq(
+      spgw_resolve_imsi_from_ue_ipv4(&ue_ipv4, &imsi64, &from_mobilityd), 5);
+  ck_assert(from_mobilityd);
+  ck_assert_int_eq(mobilityd_calls, 2);
+
+  mobilityd_rc   = 0;
+  mobilityd_imsi = "not an IMSI";
+  ck_assert_int_eq(
+      spgw_resolve_imsi_from_ue_ipv4(&ue_ipv4, &imsi64, &from_mobilityd),
+      RETURNerror);
+}
+END_TEST
+
+Suite* spgw_ue_ip_index_suite(void) {
+  Suite* s;
+  TCase* tc_core;
+
+  s = suite_create("SPGW UE IP index tests");
+
+  tc_core = tcase_create("Index");
+  tcase_add_checked_fixture(tc_core, setup, teardown);
+  tcase_add_test(tc_core, spgw_ue_ip_index_lookup_test);
+  tcase_add_test(tc_core, spgw_ue_ip_index_remove_test);
+  tcase_add_test(tc_core, spgw_ue_ip_index_resolve_test);
+  suite_add_tcase(s, tc_core);
+
+  return s;
+}
+
+int main(void) {
+  int number_failed;
+  Suite* s;
+  SRunner* sr;
+
+  s  = spgw_ue_ip_index_suite();
+  sr = srunner_create(s);
+
+  srunner_run_all(sr, CK_NORMAL);
+  number_failed = srunner_ntests_failed(sr);
+  srunner_free(sr);
+  return (number_failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE;
+}
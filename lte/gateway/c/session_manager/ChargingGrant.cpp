@@ -180,7 +180,8 @@ CreditUsage ChargingGrant::get_credit_usage(
 }
 
 bool ChargingGrant::get_update_type(
-    CreditUsage::UpdateType* update_type) const {
+    CreditUsage::UpdateType* update_type,
+    std::chrono::milliseconds reporting_lead_time) const {
   if (credit.is_reporting()) {
     MLOG(MDEBUG) << "is_reporting is True , not sending update";
     return false;  // No update
@@ -202,6 +203,15 @@ bool ChargingGrant::get_update_type(
     *update_type = CreditUsage::QUOTA_EXHAUSTED;
     return true;
   }
+  if (reporting_lead_time > std::chrono::milliseconds::zero() &&
+      credit.get_time_to_exhaustion() < reporting_lead_time) {
+    MLOG(MDEBUG) << "Quota is predicted to be exhausted in "
+                 << credit.get_time_to_exhaustion().count()
+                 << "ms, under the reporting lead time of "
+                 << reporting_lead_time.count() << "ms";
+    *update_type = CreditUsage::QUOTA_EXHAUSTED;
+    return true;
+  }
   return false;
 }
 
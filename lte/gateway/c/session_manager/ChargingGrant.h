@@ -78,7 +78,13 @@ struct ChargingGrant {
   // Return true if an update is required, with the update_type set to indicate
   // the reason.
   // Return false otherwise. In this case, update_type is untouched.
-  bool get_update_type(CreditUsage::UpdateType* update_type) const;
+  // If reporting_lead_time is set, quota that is predicted to run out within
+  // it at the current usage rate is also reported as exhausted, so that the
+  // next grant can arrive before it does.
+  bool get_update_type(
+      CreditUsage::UpdateType* update_type,
+      std::chrono::milliseconds reporting_lead_time =
+          std::chrono::milliseconds::zero()) const;
 
   // get_action returns the action to take on the credit based on the last
   // update. If no action needs to take place, CONTINUE_SERVICE is returned.
@@ -11,6 +11,8 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <numeric>
 #include <string>
 #include <time.h>
 #include <utility>
@@ -33,6 +35,7 @@ namespace magma {
 uint32_t LocalEnforcer::BEARER_CREATION_DELAY_ON_SESSION_INIT = 2000;
 uint32_t LocalEnforcer::REDIRECT_FLOW_PRIORITY                = 2000;
 bool LocalEnforcer::SEND_ACCESS_TIMEZONE                      = false;
+uint32_t LocalEnforcer::PREDICTIVE_REPORTING_MARGIN_MS        = 0;
 
 using google::protobuf::RepeatedPtrField;
 using google::protobuf::util::TimeUtil;
@@ -77,6 +80,7 @@ LocalEnforcer::LocalEnforcer(
       quota_exhaustion_termination_on_init_ms_(
           quota_exhaustion_termination_on_init_ms),
       retry_timeout_(2000),
+      update_round_trip_(0),
       mconfig_(mconfig),
       access_timezone_(compute_access_timezone()) {}
 
@@ -231,32 +235,62 @@ void LocalEnforcer::sync_sessions_on_restart(std::time_t current_time) {
 void LocalEnforcer::aggregate_records(
     SessionMap& session_map, const RuleRecordTable& records,
     SessionUpdate& session_update) {
-  // Insert the IMSI+SessionID for sessions we received a rule record into a set
-  // for easy access
-  std::unordered_set<ImsiAndSessionID> sessions_with_reporting_flows;
+  // Group the records by IMSI and IP first, so that each session is looked up
+  // once however many of its rules are reported. A subscriber only has a few
+  // IPs, which are compared in turn.
+  std::unordered_map<
+      std::string,
+      std::vector<std::pair<std::string, std::vector<const RuleRecord*>>>>
+      records_by_session;
   for (const RuleRecord& record : records.records()) {
-    const std::string &imsi = record.sid(), &ip = record.ue_ipv4();
-    // TODO IPv6 add ipv6 to search criteria
-    SessionSearchCriteria criteria(imsi, IMSI_AND_UE_IPV4_OR_IPV6, ip);
-    auto session_it = session_store_.find_session(session_map, criteria);
-    if (!session_it) {
-      MLOG(MERROR) << "Could not find session for " << imsi << " and " << ip
-                   << " during record aggregation";
-      continue;
+    auto& records_by_ip = records_by_session[record.sid()];
+    auto it             = records_by_ip.begin();
+    while (it != records_by_ip.end() && it->first != record.ue_ipv4()) {
+      ++it;
     }
-    auto& session          = **session_it;
-    const auto& session_id = session->get_session_id();
-    if (record.bytes_tx() > 0 || record.bytes_rx() > 0) {
-      sessions_with_reporting_flows.insert(ImsiAndSessionID(imsi, session_id));
-      MLOG(MINFO) << session_id << " used " << record.bytes_tx()
-                  << " tx bytes and " << record.bytes_rx()
-                  << " rx bytes for rule " << record.rule_id();
+    if (it != records_by_ip.end()) {
+      it->second.push_back(&record);
+      continue;
     }
-    SessionStateUpdateCriteria& uc = session_update[imsi][session_id];
+    records_by_ip.emplace_back(
+        record.ue_ipv4(), std::vector<const RuleRecord*>{&record});
+  }
 
-    session->add_rule_usage(
-        record.rule_id(), record.bytes_tx(), record.bytes_rx(),
-        record.dropped_tx(), record.dropped_rx(), uc);
+  // Insert the IMSI+SessionID for sessions we received a rule record into a set
+  // for easy access
+  std::unordered_set<ImsiAndSessionID> sessions_with_reporting_flows;
+  for (const auto& imsi_records : records_by_session) {
+    const std::string& imsi = imsi_records.first;
+    for (const auto& ip_records : imsi_records.second) {
+      const std::string& ip = ip_records.first;
+      // TODO IPv6 add ipv6 to search criteria
+      SessionSearchCriteria criteria(imsi, IMSI_AND_UE_IPV4_OR_IPV6, ip);
+      auto session_it = session_store_.find_session(session_map, criteria);
+      if (!session_it) {
+        MLOG(MERROR) << "Could not find session for " << imsi << " and " << ip
+                     << " during record aggregation";
+        continue;
+      }
+      auto& session                  = **session_it;
+      const auto session_id          = session->get_session_id();
+      SessionStateUpdateCriteria& uc = session_update[imsi][session_id];
+      bool has_reporting_flows       = false;
+      for (const RuleRecord* record : ip_records.second) {
+        if (record->bytes_tx() > 0 || record->bytes_rx() > 0) {
+          has_reporting_flows = true;
+          MLOG(MINFO) << session_id << " used " << record->bytes_tx()
+                      << " tx bytes and " << record->bytes_rx()
+                      << " rx bytes for rule " << record->rule_id();
+        }
+        session->add_rule_usage(
+            record->rule_id(), record->bytes_tx(), record->bytes_rx(),
+            record->dropped_tx(), record->dropped_rx(), uc);
+      }
+      if (has_reporting_flows) {
+        sessions_with_reporting_flows.insert(
+            ImsiAndSessionID(imsi, session_id));
+      }
+    }
   }
   complete_termination_for_released_sessions(
       session_map, sessions_with_reporting_flows, session_update);
@@ -264,21 +298,22 @@ void LocalEnforcer::aggregate_records(
 
 void LocalEnforcer::complete_termination_for_released_sessions(
     SessionMap& session_map,
-    std::unordered_set<ImsiAndSessionID> sessions_with_reporting_flows,
+    const std::unordered_set<ImsiAndSessionID>& sessions_with_reporting_flows,
     SessionUpdate& session_update) {
   // Iterate through sessions and notify that report has finished. Terminate any
   // sessions that can be terminated.
   std::vector<ImsiAndSessionID> sessions_to_terminate;
   for (const auto& session_pair : session_map) {
-    const std::string imsi = session_pair.first;
     for (const auto& session : session_pair.second) {
-      const std::string session_id = session->get_session_id();
+      if (session->get_state() != SESSION_RELEASED) {
+        continue;
+      }
       // If we did not receive a rule record for the session, this means
       // PipelineD has reported all usage for the session
-      auto imsi_and_session_id = ImsiAndSessionID(imsi, session_id);
-      if (session->get_state() == SESSION_RELEASED &&
-          sessions_with_reporting_flows.find(imsi_and_session_id) ==
-              sessions_with_reporting_flows.end()) {
+      auto imsi_and_session_id =
+          ImsiAndSessionID(session_pair.first, session->get_session_id());
+      if (sessions_with_reporting_flows.find(imsi_and_session_id) ==
+          sessions_with_reporting_flows.end()) {
         sessions_to_terminate.push_back(imsi_and_session_id);
       }
     }
@@ -605,22 +640,66 @@ void LocalEnforcer::cancel_final_unit_action(
   }
 }
 
+static void sort_updates_by_time_to_exhaustion(
+    UpdateSessionRequest& request,
+    const std::vector<std::chrono::milliseconds>& times_to_exhaustion) {
+  if (std::is_sorted(times_to_exhaustion.begin(), times_to_exhaustion.end())) {
+    return;
+  }
+  std::vector<int> order(request.updates_size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+    return times_to_exhaustion[a] < times_to_exhaustion[b];
+  });
+  RepeatedPtrField<CreditUsageUpdate> sorted;
+  for (int i : order) {
+    sorted.Add()->Swap(request.mutable_updates(i));
+  }
+  request.mutable_updates()->Swap(&sorted);
+}
+
 UpdateSessionRequest LocalEnforcer::collect_updates(
     SessionMap& session_map,
     std::vector<std::unique_ptr<ServiceAction>>& actions,
     SessionUpdate& session_update) const {
   UpdateSessionRequest request;
+  auto reporting_lead_time = get_reporting_lead_time();
+  std::vector<std::chrono::milliseconds> times_to_exhaustion;
   for (const auto& session_pair : session_map) {
     for (const auto& session : session_pair.second) {
       std::string imsi = session_pair.first;
       std::string sid  = session->get_session_id();
       auto& uc         = session_update[imsi][sid];
-      session->get_updates(request, &actions, uc);
+      session->get_updates(request, &actions, uc, reporting_lead_time);
+      for (int i = times_to_exhaustion.size(); i < request.updates_size();
+           i++) {
+        CreditKey key(request.updates(i).usage());
+        times_to_exhaustion.push_back(session->get_time_to_exhaustion(key));
+      }
     }
   }
+  // Send the credits that run out first ahead of the others
+  sort_updates_by_time_to_exhaustion(request, times_to_exhaustion);
   return request;
 }
 
+void LocalEnforcer::record_update_round_trip(
+    std::chrono::milliseconds round_trip) {
+  if (update_round_trip_ == std::chrono::milliseconds::zero()) {
+    update_round_trip_ = round_trip;
+    return;
+  }
+  update_round_trip_ = (round_trip + 3 * update_round_trip_) / 4;
+}
+
+std::chrono::milliseconds LocalEnforcer::get_reporting_lead_time() const {
+  if (PREDICTIVE_REPORTING_MARGIN_MS == 0) {
+    return std::chrono::milliseconds::zero();
+  }
+  return update_round_trip_ +
+         std::chrono::milliseconds(PREDICTIVE_REPORTING_MARGIN_MS);
+}
+
 void LocalEnforcer::handle_update_failure(
     SessionMap& session_map, const UpdateRequestsBySession& failed_request,
     SessionUpdate& updates) {
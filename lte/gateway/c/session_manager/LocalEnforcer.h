@@ -126,7 +126,7 @@ class LocalEnforcer {
   /**
    * Insert a group of rule usage into the monitor and update credit manager
    * Assumes records are aggregates, as in the usages sent are cumulative and
-   * not differences.
+   * not differences. Records are grouped by session before they are applied.
    *
    * @param records - a RuleRecordTable protobuf with a vector of RuleRecords
    */
@@ -149,7 +149,10 @@ class LocalEnforcer {
 
   /**
    * Collect any credit keys that are either exhausted, timed out, or terminated
-   * and apply actions to the services if need be
+   * and apply actions to the services if need be. Credits predicted to be
+   * exhausted within the reporting lead time are collected too, and the
+   * charging updates are ordered by how soon their credit is predicted to be
+   * exhausted.
    * @param updates_out (out) - vector to add usage updates to, if they exist
    */
   UpdateSessionRequest collect_updates(
@@ -157,6 +160,20 @@ class LocalEnforcer {
       std::vector<std::unique_ptr<ServiceAction>>& actions,
       SessionUpdate& session_update) const;
 
+  /**
+   * Record how long an UpdateSession request took to get its response, to
+   * estimate how long the next ones will take
+   */
+  void record_update_round_trip(std::chrono::milliseconds round_trip);
+
+  /**
+   * Returns how far ahead of their predicted exhaustion credits are reported:
+   * the estimated UpdateSession round trip plus
+   * PREDICTIVE_REPORTING_MARGIN_MS, or zero if predictive reporting is
+   * disabled
+   */
+  std::chrono::milliseconds get_reporting_lead_time() const;
+
   /**
    * Perform any rule installs/removals that need to be executed given a
    * CreateSessionResponse.
@@ -293,6 +310,10 @@ class LocalEnforcer {
   // If this is set to true, we will send the timezone along with
   // CreateSessionRequest
   static bool SEND_ACCESS_TIMEZONE;
+  // Time added to the UpdateSession round trip to report credits before they
+  // are predicted to be exhausted. It should cover the interval of the usage
+  // reports from pipelined. 0 disables predictive reporting.
+  static uint32_t PREDICTIVE_REPORTING_MARGIN_MS;
 
  private:
   std::shared_ptr<SessionReporter> reporter_;
@@ -309,6 +330,8 @@ class LocalEnforcer {
   // session after it is created without any monitoring quota
   long quota_exhaustion_termination_on_init_ms_;
   std::chrono::milliseconds retry_timeout_;
+  // Moving average of the UpdateSession round trip
+  std::chrono::milliseconds update_round_trip_;
   magma::mconfig::SessionD mconfig_;
   std::unique_ptr<Timezone> access_timezone_;
 
@@ -325,7 +348,7 @@ class LocalEnforcer {
    */
   void complete_termination_for_released_sessions(
       SessionMap& session_map,
-      std::unordered_set<ImsiAndSessionID> sessions_with_active_flows,
+      const std::unordered_set<ImsiAndSessionID>& sessions_with_active_flows,
       SessionUpdate& session_update);
 
   void filter_rule_installs(
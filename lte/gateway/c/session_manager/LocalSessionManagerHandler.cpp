@@ -105,7 +105,8 @@ void LocalSessionManagerHandlerImpl::check_usage_for_reporting(
   reporter_->report_updates(
       request,
       [this, request, session_uc,
-       session_map_ptr = std::make_shared<SessionMap>(std::move(session_map))](
+       session_map_ptr = std::make_shared<SessionMap>(std::move(session_map)),
+       sent_time = std::chrono::steady_clock::now()](
           Status status, UpdateSessionResponse response) mutable {
         PrintGrpcMessage(
             static_cast<const google::protobuf::Message&>(response));
@@ -126,6 +127,9 @@ void LocalSessionManagerHandlerImpl::check_usage_for_reporting(
           return;
         }
         // Success!
+        enforcer_->record_update_round_trip(
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - sent_time));
         enforcer_->update_session_credits_and_rules(
             *session_map_ptr, response, session_uc);
         report_session_update_event(*session_map_ptr, updates_by_session);
@@ -51,7 +51,7 @@ SessionMap MemoryStoreClient::read_all_sessions() {
   return session_map;
 }
 
-bool MemoryStoreClient::write_sessions(SessionMap session_map) {
+bool MemoryStoreClient::write_sessions(const SessionMap& session_map) {
   for (auto& it : session_map) {
     auto sessions = std::vector<StoredSessionState>{};
     for (auto const& session : it.second) {
@@ -36,7 +36,7 @@ class MemoryStoreClient final : public StoreClient {
 
   SessionMap read_all_sessions();
 
-  bool write_sessions(SessionMap session_map);
+  bool write_sessions(const SessionMap& session_map);
 
  private:
   std::unordered_map<std::string, std::vector<StoredSessionState>> session_map_;
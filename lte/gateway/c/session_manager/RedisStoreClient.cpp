@@ -21,7 +21,10 @@ namespace lte {
 RedisStoreClient::RedisStoreClient(
     std::shared_ptr<cpp_redis::client> client, const std::string& redis_table,
     std::shared_ptr<StaticRuleStore> rule_store)
-    : client_(client), redis_table_(redis_table), rule_store_(rule_store) {}
+    : client_(client),
+      redis_table_(redis_table),
+      rule_store_(rule_store),
+      layout_(redis_table) {}
 
 bool RedisStoreClient::try_redis_connect() {
   ServiceConfigLoader loader;
@@ -65,6 +68,7 @@ SessionMap RedisStoreClient::read_sessions(
   client_->sync_commit();
 
   SessionMap session_map;
+  std::vector<std::pair<std::string, std::string>> values;
   for (const std::string& key : subscriber_ids) {
     auto reply = futures[key].get();
     if (reply.is_null()) {
@@ -76,9 +80,12 @@ SessionMap RedisStoreClient::read_sessions(
     } else if (!reply.is_string()) {
       session_map[key] = SessionVector{};
     } else {
-      session_map[key] = std::move(deserialize_session_vec(reply.as_string()));
+      values.emplace_back(key, reply.as_string());
     }
   }
+  for (auto& it : read_subscribers(values)) {
+    session_map[it.first] = std::move(it.second);
+  }
   return session_map;
 }
 
@@ -98,6 +105,7 @@ SessionMap RedisStoreClient::read_all_sessions() {
     MLOG(MERROR) << "unable to read all sessions from redis";
     return session_map;
   }
+  std::vector<std::pair<std::string, std::string>> values;
   auto array = reply.as_array();
   for (size_t i = 0; i < array.size(); i += 2) {
     auto key_reply = array[i];
@@ -111,30 +119,117 @@ SessionMap RedisStoreClient::read_all_sessions() {
       MLOG(MERROR) << "RedisStoreClient: Unable to get value for key " << key;
       session_map[key] = SessionVector{};
     } else {
-      session_map[key] =
-          std::move(deserialize_session_vec(value_reply.as_string()));
+      values.emplace_back(key, value_reply.as_string());
+    }
+  }
+  for (auto& it : read_subscribers(values)) {
+    session_map[it.first] = std::move(it.second);
+  }
+  return session_map;
+}
+
+SessionMap RedisStoreClient::read_subscribers(
+    const std::vector<std::pair<std::string, std::string>>& values) {
+  SessionMap session_map;
+  std::unordered_map<std::string, std::vector<std::string>> session_ids;
+  std::unordered_map<std::string, std::future<cpp_redis::reply>> futures;
+  for (const auto& it : values) {
+    std::vector<StoredSessionState> stored_sessions;
+    auto& ids         = session_ids[it.first];
+    auto& session_vec = session_map[it.first];
+    try {
+      layout_.read_subscriber(it.first, it.second, stored_sessions, ids);
+      for (auto& stored_session : stored_sessions) {
+        session_vec.push_back(
+            SessionState::unmarshal(stored_session, *rule_store_));
+      }
+    } catch (std::exception const& e) {
+      // Very rare but we've seen a crash here
+      MLOG(MERROR) << "Exception " << e.what()
+                   << " parsing serialized states of " << it.first;
+    }
+    for (const auto& session_id : ids) {
+      futures[session_id] =
+          client_->hgetall(layout_.get_session_key(session_id));
+    }
+  }
+  if (futures.empty()) {
+    return session_map;
+  }
+
+  client_->sync_commit();
+
+  for (const auto& it : session_ids) {
+    auto& session_vec = session_map[it.first];
+    for (const auto& session_id : it.second) {
+      auto reply = futures[session_id].get();
+      if (reply.is_error() || !reply.is_array()) {
+        MLOG(MERROR) << "RedisStoreClient: Unable to get session "
+                     << session_id;
+        continue;
+      }
+      // Field names and values alternate, only the values are needed
+      std::vector<std::string> fields;
+      auto array = reply.as_array();
+      for (size_t i = 1; i < array.size(); i += 2) {
+        if (array[i].is_string()) {
+          fields.push_back(array[i].as_string());
+        }
+      }
+      if (fields.empty()) {
+        MLOG(MERROR) << "Session " << session_id << " of " << it.first
+                     << " missing from redis";
+        continue;
+      }
+      try {
+        auto stored_session = layout_.read_session(fields);
+        session_vec.push_back(
+            SessionState::unmarshal(stored_session, *rule_store_));
+      } catch (std::exception const& e) {
+        MLOG(MERROR) << "Exception " << e.what()
+                     << " parsing serialized state of " << session_id;
+      }
     }
   }
   return session_map;
 }
 
-bool RedisStoreClient::write_sessions(SessionMap session_map) {
+bool RedisStoreClient::write_sessions(const SessionMap& session_map) {
+  return write_session_updates(session_map, SessionUpdate{});
+}
+
+bool RedisStoreClient::write_session_updates(
+    const SessionMap& session_map, const SessionUpdate& session_update) {
   // Writes should happen via a transaction, otherwise the state inside in
   // Redis may not be recoverable or consistent.
   // For reference, see https://redis.io/topics/transactions
-
-  // First we need to watch the keys that we intend to write to.
-  // If we don't, then one HSET might succeed but another will fail.
   if (!client_->is_connected()) {
     auto connected = try_redis_connect();
     if (!connected) {
+      // The sessions are already updated, their next write has to catch up
+      layout_.set_write_failed(session_map);
       throw RedisWriteFailed();
     }
   }
+  auto writes = layout_.get_writes(session_map, session_update);
+
+  // First we need to watch the keys that we intend to write to.
+  // If we don't, then one HSET might succeed but another will fail.
   std::vector<std::string> keys;
-  for (auto& it : session_map) {
+  if (!writes.subscribers.empty()) {
+    keys.push_back(redis_table_);
+  }
+  keys.insert(
+      keys.end(), writes.deleted_keys.begin(), writes.deleted_keys.end());
+  for (const auto& it : writes.set_fields) {
+    keys.push_back(it.first);
+  }
+  for (const auto& it : writes.deleted_fields) {
     keys.push_back(it.first);
   }
+  if (keys.empty()) {
+    return true;
+  }
   client_->watch(keys);
 
   // Set MULTI command.
@@ -143,60 +238,48 @@ bool RedisStoreClient::write_sessions(SessionMap session_map) {
   // the entire EXEC does not execute.
   client_->multi();
 
-  // Queue up HSET commands after we've set up some sort of safety
-  // guarantees.
+  // Queue up the writes after we've set up some sort of safety guarantees.
   std::vector<std::string> keys_to_delete;
-  for (auto& it : session_map) {
+  for (const auto& it : writes.subscribers) {
     if (it.second.empty()) {
       // if session is empty we shouldn't write back this subs anymore
       keys_to_delete.push_back(it.first);
       continue;
     }
-    client_->hset(redis_table_, it.first, serialize_session_vec(it.second));
+    client_->hset(redis_table_, it.first, it.second);
   }
   if (!keys_to_delete.empty()) {
     client_->hdel(redis_table_, keys_to_delete);
   }
+  if (!writes.deleted_keys.empty()) {
+    client_->del(writes.deleted_keys);
+  }
+  for (const auto& it : writes.set_fields) {
+    client_->hmset(it.first, it.second);
+  }
+  for (const auto& it : writes.deleted_fields) {
+    client_->hdel(it.first, it.second);
+  }
   auto exec_future = client_->exec();
-  client_->sync_commit();
-
-  auto reply = exec_future.get();
+  cpp_redis::reply reply;
+  try {
+    // Everything above goes out in a single round trip
+    client_->sync_commit();
+    reply = exec_future.get();
+  } catch (...) {
+    layout_.set_write_failed(session_map);
+    throw;
+  }
   if (!reply.ok()) {
     MLOG(MERROR) << "Failed to write sessions to Redis.";
+    layout_.set_write_failed(session_map);
     return false;
   }
+  layout_.set_written(session_map);
+  MLOG(MDEBUG) << "Wrote " << writes.get_bytes() << " bytes of sessions to "
+               << keys.size() << " Redis keys";
   return true;
 }
 
-std::string RedisStoreClient::serialize_session_vec(
-    SessionVector& session_vec) {
-  folly::dynamic marshaled = folly::dynamic::array;
-  for (auto& session_ptr : session_vec) {
-    auto stored_session = session_ptr->marshal();
-    marshaled.push_back(serialize_stored_session(stored_session));
-  }
-  std::string serialized = folly::toJson(marshaled);
-  return serialized;
-}
-
-SessionVector RedisStoreClient::deserialize_session_vec(
-    std::string serialized) {
-  SessionVector session_vec;
-  auto folly_serialized = folly::StringPiece(serialized);
-  try {
-    folly::dynamic marshaled = folly::parseJson(folly_serialized);
-    for (auto& it : marshaled) {
-      auto stored_session = deserialize_stored_session(it.getString());
-      session_vec.push_back(
-          SessionState::unmarshal(stored_session, *rule_store_));
-    }
-  } catch (std::exception const& e) {
-    // Very rare but we've seen a crash here
-    MLOG(MERROR) << "Exception " << e.what()
-                 << " parsing serialized states as JSON " << folly_serialized;
-  }
-  return session_vec;
-}
-
 }  // namespace lte
 }  // namespace magma
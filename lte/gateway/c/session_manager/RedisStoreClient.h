@@ -19,6 +19,7 @@
 #include <folly/json.h>
 
 #include "StoreClient.h"
+#include "StoredSessionLayout.h"
 #include "StoredState.h"
 #include "ServiceConfigLoader.h"
 
@@ -36,7 +37,9 @@ class RedisWriteFailed : public std::exception {
 };
 
 /**
- * Persistent StoreClient used to allow stateless session_manager to function
+ * Persistent StoreClient used to allow stateless session_manager to function.
+ * Sessions are laid out as StoredSessionLayout describes, so that updates
+ * only write what they change.
  */
 class RedisStoreClient final : public StoreClient {
  public:
@@ -54,17 +57,24 @@ class RedisStoreClient final : public StoreClient {
 
   SessionMap read_all_sessions();
 
-  bool write_sessions(SessionMap session_map);
+  bool write_sessions(const SessionMap& session_map);
+
+  bool write_session_updates(
+      const SessionMap& session_map, const SessionUpdate& session_update);
 
  private:
   std::shared_ptr<cpp_redis::client> client_;
   std::string redis_table_;
   std::shared_ptr<StaticRuleStore> rule_store_;
+  StoredSessionLayout layout_;
 
  private:
-  std::string serialize_session_vec(SessionVector& session_vec);
-
-  SessionVector deserialize_session_vec(std::string serialized);
+  /**
+   * Decode the sessions table values of the subscribers, and read the
+   * sessions stored in hashes of their own in one more round trip
+   */
+  SessionMap read_subscribers(
+      const std::vector<std::pair<std::string, std::string>>& values);
 };
 
 }  // namespace lte
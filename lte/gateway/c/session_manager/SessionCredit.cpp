@@ -11,6 +11,7 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <limits>
 
 #include "DiameterCodes.h"
@@ -24,6 +25,8 @@ namespace magma {
 float SessionCredit::USAGE_REPORTING_THRESHOLD             = 0.8;
 bool SessionCredit::TERMINATE_SERVICE_WHEN_QUOTA_EXHAUSTED = true;
 uint64_t SessionCredit::DEFAULT_REQUESTED_UNITS            = 200000;
+uint64_t SessionCredit::USAGE_RATE_WINDOW_MS               = 1000;
+float SessionCredit::USAGE_RATE_WEIGHT                     = 0.3;
 
 // by default, enable service & finite credit
 SessionCredit::SessionCredit() : SessionCredit(SERVICE_ENABLED, FINITE) {}
@@ -39,7 +42,8 @@ SessionCredit::SessionCredit(
       grant_tracking_type_(TRACKING_UNSET),
       report_last_credit_(false),
       time_of_first_usage_(0),
-      time_of_last_usage_(0) {}
+      time_of_last_usage_(0),
+      usage_rate_{0, 0, 0} {}
 
 SessionCredit::SessionCredit(const StoredSessionCredit& marshaled) {
   reporting_              = marshaled.reporting;
@@ -49,6 +53,7 @@ SessionCredit::SessionCredit(const StoredSessionCredit& marshaled) {
   report_last_credit_     = marshaled.report_last_credit;
   time_of_first_usage_    = marshaled.time_of_first_usage;
   time_of_last_usage_     = marshaled.time_of_last_usage;
+  usage_rate_             = marshaled.usage_rate;
 
   for (int bucket_int = USED_TX; bucket_int != MAX_VALUES; bucket_int++) {
     Bucket bucket = static_cast<Bucket>(bucket_int);
@@ -67,6 +72,7 @@ StoredSessionCredit SessionCredit::marshal() {
   marshaled.report_last_credit     = report_last_credit_;
   marshaled.time_of_first_usage    = time_of_first_usage_;
   marshaled.time_of_last_usage     = time_of_last_usage_;
+  marshaled.usage_rate             = usage_rate_;
 
   for (int bucket_int = USED_TX; bucket_int != MAX_VALUES; bucket_int++) {
     Bucket bucket             = static_cast<Bucket>(bucket_int);
@@ -83,6 +89,7 @@ SessionCreditUpdateCriteria SessionCredit::get_update_criteria() {
   uc.report_last_credit     = report_last_credit_;
   uc.time_of_first_usage    = time_of_first_usage_;
   uc.time_of_last_usage     = time_of_last_usage_;
+  uc.usage_rate             = usage_rate_;
 
   for (int bucket_int = USED_TX; bucket_int != MAX_VALUES; bucket_int++) {
     Bucket bucket            = static_cast<Bucket>(bucket_int);
@@ -94,20 +101,27 @@ SessionCreditUpdateCriteria SessionCredit::get_update_criteria() {
 void SessionCredit::add_used_credit(
     uint64_t used_tx, uint64_t used_rx,
     SessionCreditUpdateCriteria& credit_uc) {
+  add_used_credit(
+      used_tx, used_rx, magma::get_time_in_ms_since_epoch(), credit_uc);
+}
+
+void SessionCredit::add_used_credit(
+    uint64_t used_tx, uint64_t used_rx, uint64_t now_ms,
+    SessionCreditUpdateCriteria& credit_uc) {
   if (used_tx > 0 || used_rx > 0) {
     buckets_[USED_TX] += used_tx;
     buckets_[USED_RX] += used_rx;
     credit_uc.bucket_deltas[USED_TX] += used_tx;
     credit_uc.bucket_deltas[USED_RX] += used_rx;
-    update_usage_timestamps(credit_uc);
+    update_usage_timestamps(now_ms / 1000, credit_uc);
   }
+  update_usage_rate(used_tx + used_rx, now_ms, credit_uc);
 
   log_quota_and_usage();
 }
 
 void SessionCredit::update_usage_timestamps(
-    SessionCreditUpdateCriteria& credit_uc) {
-  auto now = magma::get_time_in_sec_since_epoch();
+    uint64_t now, SessionCreditUpdateCriteria& credit_uc) {
   if (time_of_first_usage_ == 0) {
     time_of_first_usage_          = now;
     credit_uc.time_of_first_usage = now;
@@ -116,6 +130,33 @@ void SessionCredit::update_usage_timestamps(
   credit_uc.time_of_last_usage = now;
 }
 
+void SessionCredit::update_usage_rate(
+    uint64_t used, uint64_t now_ms, SessionCreditUpdateCriteria& credit_uc) {
+  if (usage_rate_.window_start == 0 || now_ms < usage_rate_.window_start) {
+    // It isn't known over how long the first usage was accumulated, so it
+    // only starts a window
+    usage_rate_.window_start = now_ms;
+    usage_rate_.window_bytes = 0;
+    credit_uc.usage_rate     = usage_rate_;
+    return;
+  }
+  usage_rate_.window_bytes += used;
+  uint64_t elapsed = now_ms - usage_rate_.window_start;
+  if (elapsed >= USAGE_RATE_WINDOW_MS) {
+    double sample = usage_rate_.window_bytes * 1000.0 / elapsed;
+    if (usage_rate_.bytes_per_sec == 0) {
+      usage_rate_.bytes_per_sec = sample;
+    } else {
+      usage_rate_.bytes_per_sec =
+          USAGE_RATE_WEIGHT * sample +
+          (1 - USAGE_RATE_WEIGHT) * usage_rate_.bytes_per_sec;
+    }
+    usage_rate_.window_start = now_ms;
+    usage_rate_.window_bytes = 0;
+  }
+  credit_uc.usage_rate = usage_rate_;
+}
+
 void SessionCredit::reset_reporting_credit(SessionCreditUpdateCriteria* uc) {
   buckets_[REPORTING_RX] = 0;
   buckets_[REPORTING_TX] = 0;
@@ -311,6 +352,51 @@ bool SessionCredit::is_quota_exhausted(float threshold) const {
   return is_exhausted;
 }
 
+double SessionCredit::get_usage_rate() const {
+  return usage_rate_.bytes_per_sec;
+}
+
+std::chrono::milliseconds SessionCredit::get_time_to_exhaustion() const {
+  if (credit_limit_type_ != FINITE || usage_rate_.bytes_per_sec <= 0) {
+    return std::chrono::milliseconds::max();
+  }
+  auto remaining = [](uint64_t allowed, uint64_t used) -> uint64_t {
+    return allowed > used ? allowed - used : 0;
+  };
+  uint64_t rx_remaining    = remaining(buckets_[ALLOWED_RX], buckets_[USED_RX]);
+  uint64_t tx_remaining    = remaining(buckets_[ALLOWED_TX], buckets_[USED_TX]);
+  uint64_t total_remaining = remaining(
+      buckets_[ALLOWED_TOTAL], buckets_[USED_TX] + buckets_[USED_RX]);
+
+  uint64_t remaining_credit;
+  switch (grant_tracking_type_) {
+    case ALL_TOTAL_TX_RX:
+      remaining_credit =
+          std::min(std::min(rx_remaining, tx_remaining), total_remaining);
+      break;
+    case RX_ONLY:
+      remaining_credit = rx_remaining;
+      break;
+    case TX_ONLY:
+      remaining_credit = tx_remaining;
+      break;
+    case TX_AND_RX:
+      remaining_credit = std::min(rx_remaining, tx_remaining);
+      break;
+    case TOTAL_ONLY:
+      remaining_credit = total_remaining;
+      break;
+    default:
+      // TRACKING_UNSET is already exhausted for is_quota_exhausted
+      return std::chrono::milliseconds::max();
+  }
+  double time_ms = remaining_credit * 1000.0 / usage_rate_.bytes_per_sec;
+  if (time_ms >= std::chrono::milliseconds::max().count()) {
+    return std::chrono::milliseconds::max();
+  }
+  return std::chrono::milliseconds(static_cast<int64_t>(time_ms));
+}
+
 SessionCredit::Usage SessionCredit::get_all_unreported_usage_for_reporting(
     SessionCreditUpdateCriteria& update_criteria) {
   auto usage = get_unreported_usage();
@@ -536,6 +622,15 @@ void SessionCredit::merge(SessionCreditUpdateCriteria& credit_uc) {
   time_of_last_usage_     = credit_uc.time_of_last_usage;
   // DO NOT UPDATE reporting_. (done by LocalSessionManagerHandler)
 
+  // Criteria applied a round trip after they were collected, like the ones
+  // of a report, hold an older usage rate window than the credit
+  const auto& rate = credit_uc.usage_rate;
+  if (rate.window_start > usage_rate_.window_start ||
+      (rate.window_start == usage_rate_.window_start &&
+       rate.window_bytes > usage_rate_.window_bytes)) {
+    usage_rate_ = rate;
+  }
+
   // add credit
   for (int i = USED_TX; i != MAX_VALUES; i++) {
     Bucket bucket = static_cast<Bucket>(i);
@@ -12,6 +12,8 @@
  */
 #pragma once
 
+#include <chrono>
+
 #include <lte/protos/session_manager.grpc.pb.h>
 
 #include "StoredState.h"
@@ -59,6 +61,14 @@ class SessionCredit {
       uint64_t used_tx, uint64_t used_rx,
       SessionCreditUpdateCriteria& credit_uc);
 
+  /**
+   * add_used_credit for usage reported at now_ms, in ms since epoch. Usage
+   * also updates the usage rate, even when there is none.
+   */
+  void add_used_credit(
+      uint64_t used_tx, uint64_t used_rx, uint64_t now_ms,
+      SessionCreditUpdateCriteria& credit_uc);
+
   /**
    * reset_reporting_credit resets the REPORTING_* to 0
    * Also marks the session as not in reporting.
@@ -139,7 +149,9 @@ class SessionCredit {
       SessionCreditUpdateCriteria& update_criteria);
 
   /**
-   * Merges SessionCredit UpdateCriteria with credit
+   * Merges SessionCredit UpdateCriteria with credit. The usage rate is only
+   * taken when the criteria hold a newer window than the credit, so criteria
+   * collected before a report don't roll it back.
    * */
   void merge(SessionCreditUpdateCriteria& uc);
 
@@ -165,6 +177,24 @@ class SessionCredit {
 
   bool current_grant_contains_zero() const;
 
+  /**
+   * Returns the moving average of the usage of this credit in bytes per
+   * second, 0 if it isn't known yet
+   */
+  double get_usage_rate() const;
+
+  /**
+   * get_time_to_exhaustion predicts how long the remaining quota (Allowed -
+   * Used) lasts at the current usage rate, on the legs that
+   * grant_tracking_type_ selects. The rate is of tx and rx together, so a
+   * grant tracking a single direction is predicted to run out early rather
+   * than late.
+   *
+   * @return std::chrono::milliseconds::max() if the credit is not finite or
+   *         the usage rate isn't known yet
+   */
+  std::chrono::milliseconds get_time_to_exhaustion() const;
+
   /**
    * A threshold represented as a ratio for triggering usage update before
    * an user completely used up the quota
@@ -187,6 +217,13 @@ class SessionCredit {
    */
   static uint64_t DEFAULT_REQUESTED_UNITS;
 
+  /**
+   * Minimum time over which usage is summed into a sample of the usage rate,
+   * and the weight of each new sample in the moving average
+   */
+  static uint64_t USAGE_RATE_WINDOW_MS;
+  static float USAGE_RATE_WEIGHT;
+
  private:
   uint64_t buckets_[MAX_VALUES];
   bool reporting_;
@@ -201,6 +238,7 @@ class SessionCredit {
   // Timestamp for the most recent IP packet to be transmitted and mapped to
   // this service data container (TS 132 298 - V8.4.0 : 5.1.2.2.22A)
   uint64_t time_of_last_usage_;
+  UsageRate usage_rate_;
 
  private:
   void log_quota_and_usage() const;
@@ -234,7 +272,11 @@ class SessionCredit {
   uint64_t calculate_delta_allowed(
       uint64_t gsu_volume, Bucket allowed, uint64_t volume_used);
 
-  void update_usage_timestamps(SessionCreditUpdateCriteria& credit_uc);
+  void update_usage_timestamps(
+      uint64_t now, SessionCreditUpdateCriteria& credit_uc);
+
+  void update_usage_rate(
+      uint64_t used, uint64_t now_ms, SessionCreditUpdateCriteria& credit_uc);
 };
 
 }  // namespace magma
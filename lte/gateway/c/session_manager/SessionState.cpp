@@ -684,9 +684,11 @@ void SessionState::add_common_fields_to_usage_monitor_update(
 void SessionState::get_updates(
     UpdateSessionRequest& update_request_out,
     std::vector<std::unique_ptr<ServiceAction>>* actions_out,
-    SessionStateUpdateCriteria& update_criteria) {
+    SessionStateUpdateCriteria& update_criteria,
+    std::chrono::milliseconds reporting_lead_time) {
   if (curr_state_ != SESSION_ACTIVE) return;
-  get_charging_updates(update_request_out, actions_out, update_criteria);
+  get_charging_updates(
+      update_request_out, actions_out, update_criteria, reporting_lead_time);
   get_monitor_updates(update_request_out, actions_out, update_criteria);
   get_event_trigger_updates(update_request_out, actions_out, update_criteria);
 }
@@ -1385,6 +1387,15 @@ uint64_t SessionState::get_charging_credit(
   return it->second->credit.get_credit(bucket);
 }
 
+std::chrono::milliseconds SessionState::get_time_to_exhaustion(
+    const CreditKey& key) const {
+  auto it = credit_map_.find(key);
+  if (it == credit_map_.end()) {
+    return std::chrono::milliseconds::max();
+  }
+  return it->second->credit.get_time_to_exhaustion();
+}
+
 bool SessionState::set_credit_reporting(
     const CreditKey& key, bool reporting,
     SessionStateUpdateCriteria* session_uc) {
@@ -1509,7 +1520,8 @@ CreditUsageUpdate SessionState::make_credit_usage_update_req(
 void SessionState::get_charging_updates(
     UpdateSessionRequest& update_request_out,
     std::vector<std::unique_ptr<ServiceAction>>* actions_out,
-    SessionStateUpdateCriteria& uc) {
+    SessionStateUpdateCriteria& uc,
+    std::chrono::milliseconds reporting_lead_time) {
   for (auto& credit_pair : credit_map_) {
     auto& key      = credit_pair.first;
     auto& grant    = credit_pair.second;
@@ -1521,7 +1533,7 @@ void SessionState::get_charging_updates(
       case CONTINUE_SERVICE: {
         CreditUsage::UpdateType update_type;
 
-        if (!grant->get_update_type(&update_type)) {
+        if (!grant->get_update_type(&update_type, reporting_lead_time)) {
           break;  // no update
         }
         if (curr_state_ == SESSION_RELEASED) {
@@ -198,11 +198,15 @@ class SessionState {
    * Only updates request number
    * @param update_request (out) - request to add new updates to
    * @param actions (out) - actions to take on services
+   * @param reporting_lead_time - time it takes for an update to get a
+   *        response, see ChargingGrant::get_update_type
    */
   void get_updates(
       UpdateSessionRequest& update_request_out,
       std::vector<std::unique_ptr<ServiceAction>>* actions_out,
-      SessionStateUpdateCriteria& update_criteria);
+      SessionStateUpdateCriteria& update_criteria,
+      std::chrono::milliseconds reporting_lead_time =
+          std::chrono::milliseconds::zero());
 
   bool is_terminating();
 
@@ -233,6 +237,12 @@ class SessionState {
 
   uint64_t get_charging_credit(const CreditKey& key, Bucket bucket) const;
 
+  /**
+   * Returns the predicted time until the charging credit of key is exhausted,
+   * std::chrono::milliseconds::max() if it can't be predicted
+   */
+  std::chrono::milliseconds get_time_to_exhaustion(const CreditKey& key) const;
+
   bool set_credit_reporting(
       const CreditKey& key, bool reporting,
       SessionStateUpdateCriteria* update_criteria);
@@ -620,7 +630,8 @@ class SessionState {
   void get_charging_updates(
       UpdateSessionRequest& update_request_out,
       std::vector<std::unique_ptr<ServiceAction>>* actions_out,
-      SessionStateUpdateCriteria& uc);
+      SessionStateUpdateCriteria& uc,
+      std::chrono::milliseconds reporting_lead_time);
 
   void fill_service_action(
       std::unique_ptr<ServiceAction>& action, ServiceActionType action_type,
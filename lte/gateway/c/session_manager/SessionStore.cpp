@@ -19,36 +19,236 @@
 namespace magma {
 namespace lte {
 
+namespace {
+
+// True when applying the update criteria would leave the session unchanged,
+// as it does for the default criteria of sessions without usage
+bool is_empty_update(const SessionStateUpdateCriteria& uc) {
+  return !uc.is_session_ended && !uc.is_fsm_updated &&
+         !uc.is_config_updated && !uc.is_current_version_updated &&
+         !uc.is_local_teid_updated && !uc.is_pending_event_triggers_updated &&
+         !uc.is_bearer_mapping_updated && !uc.is_session_level_key_updated &&
+         uc.updated_pdp_end_time == 0 && !has_rule_updates(uc) &&
+         uc.charging_credit_map.empty() &&
+         uc.charging_credit_to_install.empty() &&
+         uc.monitor_credit_map.empty() && uc.monitor_credit_to_install.empty();
+}
+
+// Update criteria of a change of request number only
+SessionStateUpdateCriteria get_request_number_update(uint32_t increment) {
+  auto uc                     = get_default_update_criteria();
+  uc.request_number_increment = increment;
+  return uc;
+}
+
+// True when find_session would return the session for the criteria
+bool is_session_match(
+    SessionState& session, const SessionSearchCriteria& criteria) {
+  if (criteria.search_type == IMSI_AND_SESSION_ID) {
+    return session.get_session_id() == criteria.secondary_key;
+  }
+  const auto config   = session.get_config();
+  const auto& context = config.common_context;
+  switch (criteria.search_type) {
+    case IMSI_AND_APN:
+      return context.apn() == criteria.secondary_key;
+
+    case IMSI_AND_UE_IPV4:
+      return context.ue_ipv4() == criteria.secondary_key;
+
+    case IMSI_AND_UE_IPV4_OR_IPV6:
+      // cwag case (cwag doesn't store ip)
+      if (context.rat_type() == RATType::TGPP_WLAN) {
+        return true;
+      }
+      // other case(lte,5g)
+      return context.ue_ipv4() == criteria.secondary_key ||
+             context.ue_ipv6() == criteria.secondary_key;
+
+    case IMSI_AND_BEARER:
+      switch (context.rat_type()) {
+        case RATType::TGPP_LTE:
+          // lte case
+          return config.rat_specific_context.lte_context().bearer_id() ==
+                     criteria.secondary_key_unit32 &&
+                 session.is_active();
+        case RATType::TGPP_WLAN:
+          return true;
+        default:
+        case RATType::TGPP_NR:
+          MLOG(MERROR) << "Search criteria for IMSI_AND_BEARER "
+                          "not implemented for this RAT "
+                       << context.rat_type();
+          return false;
+      }
+
+    case IMSI_AND_TEID:
+      switch (context.rat_type()) {
+        case RATType::TGPP_WLAN:
+          return true;
+        case RATType::TGPP_LTE:
+          return context.teids().enb_teid() == criteria.secondary_key_unit32 ||
+                 context.teids().agw_teid() == criteria.secondary_key_unit32;
+        case RATType::TGPP_NR:
+          return session.get_local_teid() == criteria.secondary_key_unit32;
+        default:
+          MLOG(MERROR) << "Search criteria for IMSI_AND_TEID not implemented"
+                          "for this RAT "
+                       << context.rat_type();
+          return false;
+      }
+
+    default:
+      return false;
+  }
+}
+
+template <typename Key>
+optional<size_t> find_position(
+    const std::unordered_map<Key, size_t>& positions, const Key& key) {
+  auto it = positions.find(key);
+  if (it == positions.end()) {
+    return {};
+  }
+  return it->second;
+}
+
+}  // namespace
+
 SessionStore::SessionStore(std::shared_ptr<StaticRuleStore> rule_store)
     : rule_store_(rule_store),
       store_client_(std::make_shared<MemoryStoreClient>(rule_store)),
-      metering_reporter_(std::make_shared<MeteringReporter>()) {}
+      metering_reporter_(std::make_shared<MeteringReporter>()),
+      is_loaded_(false) {}
 
 SessionStore::SessionStore(
     std::shared_ptr<StaticRuleStore> rule_store,
-    std::shared_ptr<RedisStoreClient> store_client)
+    std::shared_ptr<StoreClient> store_client)
     : rule_store_(rule_store),
       store_client_(store_client),
-      metering_reporter_(std::make_shared<MeteringReporter>()) {}
+      metering_reporter_(std::make_shared<MeteringReporter>()),
+      is_loaded_(false) {}
+
+void SessionStore::load_sessions() {
+  if (is_loaded_) {
+    return;
+  }
+  session_map_ = store_client_->read_all_sessions();
+  for (auto it = session_map_.begin(); it != session_map_.end();) {
+    if (it->second.empty()) {
+      it = session_map_.erase(it);
+      continue;
+    }
+    index_sessions(it->first);
+    ++it;
+  }
+  is_loaded_ = true;
+  MLOG(MINFO) << "Loaded sessions of " << session_map_.size()
+              << " subscribers from storage";
+}
+
+SessionVector SessionStore::copy_sessions(const SessionVector& sessions) {
+  SessionVector copies;
+  copies.reserve(sessions.size());
+  for (const auto& session : sessions) {
+    copies.push_back(SessionState::unmarshal(session->marshal(), *rule_store_));
+  }
+  return copies;
+}
+
+bool SessionStore::write_through(
+    const std::set<std::string>& subscriber_ids,
+    const SessionUpdate& session_update) {
+  // Subscribers whose last write failed catch up whole with this one, as
+  // the update criteria applied to them since are not known anymore
+  std::set<std::string> written_ids = subscriber_ids;
+  written_ids.insert(unwritten_ids_.begin(), unwritten_ids_.end());
+  if (written_ids.empty()) {
+    return true;
+  }
+  SessionUpdate written_update;
+  for (const auto& it : session_update) {
+    if (unwritten_ids_.count(it.first) == 0) {
+      written_update.insert(it);
+    }
+  }
+
+  // Lend the live sessions to the store client instead of copying them
+  SessionMap session_map;
+  for (const std::string& imsi : written_ids) {
+    auto it = session_map_.find(imsi);
+    session_map[imsi] =
+        it == session_map_.end() ? SessionVector{} : std::move(it->second);
+  }
+  auto give_back = [this, &session_map]() {
+    for (auto& it : session_map) {
+      if (!it.second.empty()) {
+        session_map_[it.first] = std::move(it.second);
+      }
+      // Every change to the live sessions is written through here
+      index_sessions(it.first);
+    }
+  };
+  bool success = false;
+  try {
+    success = store_client_->write_session_updates(session_map, written_update);
+  } catch (...) {
+    give_back();
+    unwritten_ids_ = written_ids;
+    throw;
+  }
+  give_back();
+  if (!success) {
+    MLOG(MERROR) << "Failed to write the sessions of " << written_ids.size()
+                 << " subscribers to storage, they will be written again with "
+                 << "the next update";
+    unwritten_ids_ = written_ids;
+    return false;
+  }
+  unwritten_ids_.clear();
+  return true;
+}
 
 bool SessionStore::raw_write_sessions(SessionMap session_map) {
-  // return true;
-  return store_client_->write_sessions(std::move(session_map));
+  load_sessions();
+  std::set<std::string> subscriber_ids;
+  for (auto& it : session_map) {
+    subscriber_ids.insert(it.first);
+    if (it.second.empty()) {
+      session_map_.erase(it.first);
+      continue;
+    }
+    session_map_[it.first] = std::move(it.second);
+  }
+  return write_through(subscriber_ids);
 }
 
 SessionMap SessionStore::read_sessions(const SessionRead& req) {
-  return store_client_->read_sessions(req);
+  load_sessions();
+  SessionMap session_map;
+  for (const std::string& imsi : req) {
+    auto it = session_map_.find(imsi);
+    session_map[imsi] = it == session_map_.end() ? SessionVector{} :
+                                                   copy_sessions(it->second);
+  }
+  return session_map;
 }
 
 SessionMap SessionStore::read_all_sessions() {
-  return store_client_->read_all_sessions();
+  load_sessions();
+  SessionMap session_map;
+  for (const auto& it : session_map_) {
+    session_map[it.first] = copy_sessions(it.second);
+  }
+  return session_map;
 }
 
 void SessionStore::set_and_save_reporting_flag(
     bool value, const UpdateSessionRequest& update_session_request,
     SessionUpdate& session_uc) {
   MLOG(MDEBUG) << "saving flag is_reporting = " << value << " on session store";
-  auto session_map = store_client_->read_all_sessions();
+  load_sessions();
+  std::set<std::string> subscriber_ids;
 
   for (const CreditUsageUpdate& credit_update :
        update_session_request.updates()) {
@@ -58,7 +258,7 @@ void SessionStore::set_and_save_reporting_flag(
     const std::string mkey       = credit_update.usage().monitoring_key();
 
     SessionSearchCriteria criteria(imsi, IMSI_AND_SESSION_ID, session_id);
-    auto session_it = find_session(session_map, criteria);
+    auto session_it = find_session(session_map_, criteria);
     if (!session_it) {
       MLOG(MERROR) << session_id
                    << " not found when setting set_and_save_reporting_flag";
@@ -73,7 +273,9 @@ void SessionStore::set_and_save_reporting_flag(
           << session_id
           << " set_and_save_reporting_flag couldn't set reporting for ckey "
           << ckey;
+      continue;
     }
+    subscriber_ids.insert(imsi);
   }
 
   for (const UsageMonitoringUpdateRequest& monitor_update :
@@ -83,7 +285,7 @@ void SessionStore::set_and_save_reporting_flag(
     const auto mkey              = monitor_update.update().monitoring_key();
 
     SessionSearchCriteria criteria(imsi, IMSI_AND_SESSION_ID, session_id);
-    auto session_it = find_session(session_map, criteria);
+    auto session_it = find_session(session_map_, criteria);
     if (!session_it) {
       MLOG(MERROR) << session_id
                    << " not found when setting set_and_save_reporting_flag";
@@ -97,183 +299,233 @@ void SessionStore::set_and_save_reporting_flag(
           << session_id
           << " set_and_save_reporting_flag couldn't set monitors for mkey:"
           << mkey;
+      continue;
     }
+    subscriber_ids.insert(imsi);
   }
 
-  store_client_->write_sessions(std::move(session_map));
+  write_through(subscriber_ids, session_uc);
 }
 
 void SessionStore::sync_request_numbers(const SessionUpdate& update_criteria) {
-  // Read the current stored state
-  auto subscriber_ids = std::set<std::string>{};
-  for (const auto& it : update_criteria) {
-    subscriber_ids.insert(it.first);
-  }
-  auto session_map = store_client_->read_sessions(subscriber_ids);
+  load_sessions();
+  std::set<std::string> subscriber_ids;
+  SessionUpdate written;
 
-  // Sync stored state so that subsequent reads have the right request_number
+  // Sync the live sessions so that subsequent reads have the right
+  // request_number
   MLOG(MDEBUG) << "Syncing request numbers into existing sessions";
-  for (auto& it : session_map) {
-    auto imsi = it.first;
-    auto it2  = it.second.begin();
-    while (it2 != it.second.end()) {
-      auto updates    = update_criteria.find(it.first)->second;
-      auto session_id = (*it2)->get_session_id();
-      if (updates.find(session_id) != updates.end()) {
-        (*it2)->increment_request_number(
-            updates[session_id].request_number_increment);
+  for (const auto& it : update_criteria) {
+    auto sm_it = session_map_.find(it.first);
+    if (sm_it == session_map_.end()) {
+      continue;
+    }
+    for (auto& session : sm_it->second) {
+      auto uc_it = it.second.find(session->get_session_id());
+      if (uc_it == it.second.end() ||
+          uc_it->second.request_number_increment == 0) {
+        continue;
       }
-      ++it2;
+      session->increment_request_number(
+          uc_it->second.request_number_increment);
+      subscriber_ids.insert(it.first);
+      written[it.first][session->get_session_id()] =
+          get_request_number_update(uc_it->second.request_number_increment);
     }
   }
   MLOG(MDEBUG) << "sync_request_numbers: Writing into session store";
-  store_client_->write_sessions(std::move(session_map));
+  write_through(subscriber_ids, written);
 }
 
 SessionMap SessionStore::read_sessions_for_deletion(const SessionRead& req) {
-  auto session_map   = store_client_->read_sessions(req);
-  auto session_map_2 = store_client_->read_sessions(req);
+  auto session_map = read_sessions(req);
+  std::set<std::string> subscriber_ids;
+  SessionUpdate written;
   // For all sessions of the subscriber, increment the request numbers
   for (const std::string& imsi : req) {
-    for (auto& session : session_map_2[imsi]) {
+    auto it = session_map_.find(imsi);
+    if (it == session_map_.end()) {
+      continue;
+    }
+    for (auto& session : it->second) {
       session->increment_request_number(1);
+      written[imsi][session->get_session_id()] = get_request_number_update(1);
     }
+    subscriber_ids.insert(imsi);
   }
-  store_client_->write_sessions(std::move(session_map_2));
+  write_through(subscriber_ids, written);
   return session_map;
 }
 
 bool SessionStore::create_sessions(
     const std::string& subscriber_id, SessionVector sessions) {
-  auto session_map           = SessionMap{};
-  session_map[subscriber_id] = std::move(sessions);
-  store_client_->write_sessions(std::move(session_map));
+  load_sessions();
+  if (sessions.empty()) {
+    session_map_.erase(subscriber_id);
+  } else {
+    session_map_[subscriber_id] = std::move(sessions);
+  }
+  write_through({subscriber_id});
   return true;
 }
 
 bool SessionStore::update_sessions(const SessionUpdate& update_criteria) {
-  // Read the current state
-  auto subscriber_ids = std::set<std::string>{};
+  load_sessions();
+  // Try the updates that can be rejected on copies first, so that an invalid
+  // update leaves all sessions as they were
+  std::unordered_map<SessionState*, std::unique_ptr<SessionState>> updated;
   for (const auto& it : update_criteria) {
-    subscriber_ids.insert(it.first);
+    auto sm_it = session_map_.find(it.first);
+    if (sm_it == session_map_.end()) {
+      continue;
+    }
+    for (auto& session : sm_it->second) {
+      auto uc_it = it.second.find(session->get_session_id());
+      if (uc_it == it.second.end() || !has_rule_updates(uc_it->second)) {
+        continue;
+      }
+      auto update = uc_it->second;
+      auto copy   = SessionState::unmarshal(session->marshal(), *rule_store_);
+      if (!copy->apply_update_criteria(update)) {
+        return false;
+      }
+      updated[session.get()] = std::move(copy);
+    }
   }
-  auto session_map = store_client_->read_sessions(subscriber_ids);
-  // Now attempt to modify the state
-  for (auto& it : session_map) {
-    auto imsi = it.first;
-    auto it2  = it.second.begin();
-    while (it2 != it.second.end()) {
-      auto updates    = update_criteria.find(it.first)->second;
+
+  // Now modify the live sessions
+  std::set<std::string> subscriber_ids;
+  SessionUpdate written;
+  for (const auto& it : update_criteria) {
+    auto imsi  = it.first;
+    auto sm_it = session_map_.find(imsi);
+    if (sm_it == session_map_.end()) {
+      continue;
+    }
+    auto& sessions = sm_it->second;
+    auto it2       = sessions.begin();
+    while (it2 != sessions.end()) {
       auto session_id = (*it2)->get_session_id();
-      if (updates.find(session_id) != updates.end()) {
-        auto update = updates[session_id];
-        if (!(*it2)->apply_update_criteria(update)) {
-          return false;
-        }
-        metering_reporter_->report_usage(imsi, session_id, update);
-
-        if (update.is_session_ended) {
-          // TODO: Instead of deleting from session_map, mark as ended and
-          //       no longer mark on read
-          it2 = it.second.erase(it2);
-          continue;
-        }
+      auto uc_it      = it.second.find(session_id);
+      if (uc_it == it.second.end() || is_empty_update(uc_it->second)) {
+        ++it2;
+        continue;
+      }
+      auto update  = uc_it->second;
+      auto copy_it = updated.find(it2->get());
+      if (copy_it != updated.end()) {
+        *it2 = std::move(copy_it->second);
+      } else {
+        (*it2)->apply_update_criteria(update);
+      }
+      metering_reporter_->report_usage(imsi, session_id, update);
+      subscriber_ids.insert(imsi);
+      written[imsi][session_id] = update;
+
+      if (update.is_session_ended) {
+        // TODO: Instead of deleting from session_map, mark as ended and
+        //       no longer mark on read
+        it2 = sessions.erase(it2);
+        continue;
       }
       ++it2;
     }
+    if (sessions.empty()) {
+      session_map_.erase(sm_it);
+    }
   }
-  return store_client_->write_sessions(std::move(session_map));
+  return write_through(subscriber_ids, written);
 }
 
 optional<SessionVector::iterator> SessionStore::find_session(
-    SessionMap& session_map, SessionSearchCriteria criteria) {
+    SessionMap& session_map, const SessionSearchCriteria& criteria) {
   auto sm_it = session_map.find(criteria.imsi);
   if (sm_it == session_map.end()) {
     return {};
   }
   auto& sessions = sm_it->second;
+  // The session map is usually a copy of the live sessions, in the same order,
+  // so the index of the live sessions has the position of the session. It is
+  // checked in case the sessions changed since.
+  auto position = find_indexed_session(criteria);
+  if (position && *position < sessions.size() &&
+      is_session_match(*sessions[*position], criteria)) {
+    return sessions.begin() + *position;
+  }
   for (auto it = sessions.begin(); it != sessions.end(); ++it) {
-    const auto& context = (*it)->get_config().common_context;
-    switch (criteria.search_type) {
-      case IMSI_AND_SESSION_ID:
-        if ((*it)->get_session_id() == criteria.secondary_key) {
-          return it;
-        }
-        break;
+    if (is_session_match(**it, criteria)) {
+      return it;
+    }
+  }
+  return {};
+}
 
-      case IMSI_AND_APN:
-        if (context.apn() == criteria.secondary_key) {
-          return it;
-        }
-        break;
+optional<size_t> SessionStore::find_indexed_session(
+    const SessionSearchCriteria& criteria) {
+  auto index_it = session_index_.find(criteria.imsi);
+  if (index_it == session_index_.end()) {
+    return {};
+  }
+  const auto& index = index_it->second;
+  switch (criteria.search_type) {
+    case IMSI_AND_SESSION_ID:
+      return find_position(index.by_session_id, criteria.secondary_key);
+    case IMSI_AND_UE_IPV4_OR_IPV6:
+      if (index.has_wlan) {
+        return {};
+      }
+      return find_position(index.by_ue_ip, criteria.secondary_key);
+    case IMSI_AND_BEARER:
+      if (index.has_wlan) {
+        return {};
+      }
+      return find_position(index.by_bearer, criteria.secondary_key_unit32);
+    case IMSI_AND_TEID:
+      if (index.has_wlan) {
+        return {};
+      }
+      return find_position(index.by_teid, criteria.secondary_key_unit32);
+    default:
+      return {};
+  }
+}
 
-      case IMSI_AND_UE_IPV4:
-        if (context.ue_ipv4() == criteria.secondary_key) {
-          return it;
-        }
+void SessionStore::index_sessions(const std::string& subscriber_id) {
+  auto it = session_map_.find(subscriber_id);
+  if (it == session_map_.end()) {
+    session_index_.erase(subscriber_id);
+    return;
+  }
+  SessionIndex index{};
+  for (size_t i = 0; i < it->second.size(); i++) {
+    auto& session       = it->second[i];
+    const auto config   = session->get_config();
+    const auto& context = config.common_context;
+    index.by_session_id.emplace(session->get_session_id(), i);
+    if (!context.ue_ipv4().empty()) {
+      index.by_ue_ip.emplace(context.ue_ipv4(), i);
+    }
+    if (!context.ue_ipv6().empty()) {
+      index.by_ue_ip.emplace(context.ue_ipv6(), i);
+    }
+    switch (context.rat_type()) {
+      case RATType::TGPP_WLAN:
+        index.has_wlan = true;
         break;
-
-      case IMSI_AND_UE_IPV4_OR_IPV6:
-        // cwag case (cwag doesn't store ip)
-        if (context.rat_type() == RATType::TGPP_WLAN) {
-          return it;
-        }
-        // other case(lte,5g)
-        if (context.ue_ipv4() == criteria.secondary_key ||
-            context.ue_ipv6() == criteria.secondary_key) {
-          return it;
-        }
+      case RATType::TGPP_LTE:
+        index.by_bearer.emplace(
+            config.rat_specific_context.lte_context().bearer_id(), i);
+        index.by_teid.emplace(context.teids().enb_teid(), i);
+        index.by_teid.emplace(context.teids().agw_teid(), i);
+        break;
+      case RATType::TGPP_NR:
+        index.by_teid.emplace(session->get_local_teid(), i);
+        break;
+      default:
         break;
-
-      case IMSI_AND_BEARER:
-        switch (context.rat_type()) {
-          case RATType::TGPP_LTE:
-            // lte case
-            if ((*it)->get_config()
-                        .rat_specific_context.lte_context()
-                        .bearer_id() == criteria.secondary_key_unit32 &&
-                (*it)->is_active()) {
-              return it;
-            }
-            break;
-          case RATType::TGPP_WLAN:
-            return it;
-          default:
-          case RATType::TGPP_NR:
-            MLOG(MERROR) << "Search criteria for IMSI_AND_BEARER "
-                            "not implemented for this RAT "
-                         << context.rat_type();
-            break;
-        }
-        break;  // break IMSI_AND_BEARER
-
-      case IMSI_AND_TEID:
-        switch (context.rat_type()) {
-          case RATType::TGPP_WLAN:
-            return it;
-            break;
-          case RATType::TGPP_LTE:
-            if (context.teids().enb_teid() == criteria.secondary_key_unit32 ||
-                context.teids().agw_teid() == criteria.secondary_key_unit32) {
-              return it;
-            }
-            break;
-          case RATType::TGPP_NR:
-            if ((*it)->get_local_teid() == criteria.secondary_key_unit32) {
-              return it;
-            }
-            break;
-          default:
-            MLOG(MERROR) << "Search criteria for IMSI_AND_TEID not implemented"
-                            "for this RAT "
-                         << context.rat_type();
-            break;
-        }
-        break;  // break IMSI_AND_TEID
     }
-    continue;
   }
-  return {};
+  session_index_[subscriber_id] = std::move(index);
 }
 
 SessionUpdate SessionStore::get_default_session_update(
@@ -13,6 +13,8 @@
 #pragma once
 
 #include <memory>
+#include <set>
+#include <unordered_map>
 #include <experimental/optional>
 
 #include <lte/protos/session_manager.grpc.pb.h>
@@ -31,9 +33,6 @@ using std::experimental::optional;
 
 // Value int represents the request numbers needed for requests to PCRF
 typedef std::set<std::string> SessionRead;
-typedef std::unordered_map<
-    std::string, std::unordered_map<std::string, SessionStateUpdateCriteria>>
-    SessionUpdate;
 
 enum SessionSearchCriteriaType {
   IMSI_AND_APN             = 0,
@@ -64,17 +63,35 @@ struct SessionSearchCriteria {
 };
 
 /**
- * SessionStore acts as a broker to storage of sessiond state.
+ * Positions of the sessions of a subscriber in its SessionVector, by the
+ * secondary keys of SessionSearchCriteria. Where sessions share a key, the
+ * position of the first one is kept, as find_session returns it.
+ */
+struct SessionIndex {
+  std::unordered_map<std::string, size_t> by_session_id;
+  // IPv4 and IPv6 addresses
+  std::unordered_map<std::string, size_t> by_ue_ip;
+  // eNB and AGW TEIDs of LTE sessions, local TEID of 5G ones
+  std::unordered_map<uint32_t, size_t> by_teid;
+  // Default bearer of LTE sessions
+  std::unordered_map<uint32_t, size_t> by_bearer;
+  // WLAN sessions match any IP, TEID and bearer
+  bool has_wlan;
+};
+
+/**
+ * SessionStore owns the state of all sessions in sessiond.
  *
- * This allows sessiond to service gRPC requests in a stateless manner.
- * Instead of keeping state in memory, sessiond uses the request parameters and
- * fetches state through SessionStore, handles the request, then writes back
- * to SessionStore, and responds to the gRPC request.
+ * The live SessionMap is kept in memory and is the source of truth: it is
+ * loaded from the StoreClient once, on first use, and every change made
+ * through SessionStore is then written through to the StoreClient for the
+ * subscribers it touched, so that sessiond can be restarted from storage.
  *
- * SessionStore is intended to be a thread-safe singleton. Each gRPC request
+ * Callers get copies of the sessions they read, handle the request on them,
+ * and commit the changes they made as SessionUpdate criteria, which
+ * SessionStore applies to the live sessions in place. Each gRPC request
  * should make a single read from SessionStore, and make a single write after
- * the request is serviced. The transactional nature of how requests should be
- * handled is intended to keep sessiond restartable in case of crashes.
+ * the request is serviced.
  */
 class SessionStore {
  public:
@@ -84,30 +101,27 @@ class SessionStore {
 
   SessionStore(
       std::shared_ptr<StaticRuleStore> rule_store,
-      std::shared_ptr<RedisStoreClient> store_client);
+      std::shared_ptr<StoreClient> store_client);
 
   /**
-   * Writes the session map directly to the store. Note that the existing map
-   * will be overwriten
+   * Replaces all the sessions of the subscribers in the session map with the
+   * given ones
    * @param session_map
    * @return
    */
   bool raw_write_sessions(SessionMap session_map);
 
   /**
-   * Read the last written values for the requested sessions through the
-   * storage interface.
+   * Copy the current state of the requested sessions.
    * @param req
-   * @return Last written values for requested sessions. Returns an empty vector
+   * @return Copies of the requested sessions. Returns an empty vector
    *         for subscribers that do not have active sessions.
    */
   SessionMap read_sessions(const SessionRead& req);
 
   /**
-   * Read the last written values for all existing sessions through the
-   * storage interface.
-   * @return Last written values for all sessions. Returns an empty vector
-   *         for subscribers that do not have active sessions.
+   * Copy the current state of all existing sessions.
+   * @return Copies of all sessions
    */
   SessionMap read_all_sessions();
 
@@ -136,18 +150,17 @@ class SessionStore {
       SessionUpdate& session_uc);
 
   /**
-   * Read the last written values for the requested sessions through the
-   * storage interface. This also modifies the request_numbers stored before
-   * returning the SessionMap to the caller, incremented by one for each
-   * session.
+   * Copy the current state of the requested sessions. This also modifies the
+   * request_numbers stored before returning the SessionMap to the caller,
+   * incremented by one for each session.
    * NOTE: It is assumed that the correct number of request_numbers are
    *       reserved on each read_sessions call. If more requests are made to
    *       the OCS/PCRF than are requested, this can cause undefined behavior.
    * NOTE: Here, it is expected that the caller will use one additional
    *       request_number for each session.
    * @param req
-   * @return Last written values for requested sessions. Returns an empty vector
-   *         for subscribers that do not have active sessions.
+   * @return Copies of the requested sessions, before the increment. Returns an
+   *         empty vector for subscribers that do not have active sessions.
    */
   SessionMap read_sessions_for_deletion(const SessionRead& req);
 
@@ -163,10 +176,14 @@ class SessionStore {
   /**
    * Attempt to update sessions with update criteria. If any update to any of
    * the sessions is invalid, the whole update request is assumed to be invalid,
-   * and nothing in storage will be overwritten.
+   * and no session is modified. Only the subscribers with a non-empty update
+   * are written to storage.
    * NOTE: Will not update request_number. Use sync_request_numbers.
    * @param update_criteria
-   * @return true if successful, otherwise the update to storage is discarded.
+   * @return true if successful. false if the update is invalid, in which case
+   *         no session is modified, or if the write to storage failed, in
+   *         which case the update is applied in memory but not persisted. The
+   *         subscribers are then written whole with the next write.
    */
   bool update_sessions(const SessionUpdate& update_criteria);
 
@@ -175,6 +192,8 @@ class SessionStore {
    * @param id
    * @return If the session that meets the criteria is found, then it returns an
    * optional of the iterator. Otherwise, it returns an empty value.
+   * Searches by session ID, IP, bearer and TEID go through the index of the
+   * live sessions first, and only scan the subscriber's sessions on a miss.
    *
    * Usage Example
    * SessionSearchCriteria criteria(IMSI1, IMSI_AND_SESSION_ID,
@@ -185,12 +204,53 @@ class SessionStore {
    * auto& session = **session_it; // First deference optional, then iterator
    */
   optional<SessionVector::iterator> find_session(
-      SessionMap& session_map, SessionSearchCriteria criteria);
+      SessionMap& session_map, const SessionSearchCriteria& criteria);
 
  private:
   std::shared_ptr<StaticRuleStore> rule_store_;
   std::shared_ptr<StoreClient> store_client_;
   std::shared_ptr<MeteringReporter> metering_reporter_;
+  SessionMap session_map_;
+  // Index of the sessions of each subscriber in session_map_
+  std::unordered_map<std::string, SessionIndex> session_index_;
+  // Subscribers changed in memory whose write to storage failed
+  std::set<std::string> unwritten_ids_;
+  bool is_loaded_;
+
+ private:
+  /**
+   * Read all sessions from storage into session_map_, the first time only
+   */
+  void load_sessions();
+
+  SessionVector copy_sessions(const SessionVector& sessions);
+
+  /**
+   * Rebuild the index of the subscriber's sessions in session_map_
+   */
+  void index_sessions(const std::string& subscriber_id);
+
+  /**
+   * Position of the session matching the criteria among the subscriber's
+   * sessions in session_map_, according to the index. Criteria the index
+   * can't answer, or answers with a scan, give an empty value.
+   */
+  optional<size_t> find_indexed_session(const SessionSearchCriteria& criteria);
+
+  /**
+   * Write the current sessions of the subscribers to storage. Subscribers
+   * without sessions left are deleted from it.
+   * @param session_update update criteria applied to the sessions since their
+   *                       last write, so that the store client can write only
+   *                       what changed. Subscribers without any are written
+   *                       whole.
+   * @return true if the write to storage succeeded. Otherwise the sessions
+   *         stay updated in memory only, and the subscribers are written
+   *         whole with the next call, along with its own.
+   */
+  bool write_through(
+      const std::set<std::string>& subscriber_ids,
+      const SessionUpdate& session_update = SessionUpdate{});
 };
 
 }  // namespace lte
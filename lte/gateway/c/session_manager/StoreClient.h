@@ -23,6 +23,9 @@ namespace lte {
 
 typedef std::vector<std::unique_ptr<SessionState>> SessionVector;
 typedef std::unordered_map<std::string, SessionVector> SessionMap;
+typedef std::unordered_map<
+    std::string, std::unordered_map<std::string, SessionStateUpdateCriteria>>
+    SessionUpdate;
 
 /**
  * StoreClient is responsible for reading/writing sessions to/from storage.
@@ -55,7 +58,21 @@ class StoreClient {
    * @param sessions Sessions to write into storage
    * @return True if writes have completed successfully for all sessions.
    */
-  virtual bool write_sessions(SessionMap sessions) = 0;
+  virtual bool write_sessions(const SessionMap& sessions) = 0;
+
+  /**
+   * Write the subscriber sessions into storage like write_sessions. For the
+   * sessions with update criteria in session_update, only the parts the
+   * criteria mark as changed need to be written.
+   *
+   * @param sessions Sessions to write into storage
+   * @param session_update Update criteria already applied to the sessions
+   * @return True if writes have completed successfully for all sessions.
+   */
+  virtual bool write_session_updates(
+      const SessionMap& sessions, const SessionUpdate& session_update) {
+    return write_sessions(sessions);
+  }
 };
 
 }  // namespace lte
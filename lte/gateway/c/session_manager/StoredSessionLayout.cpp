@@ -0,0 +1,304 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+
+#include "StoredSessionLayout.h"
+
+namespace magma {
+namespace lte {
+
+namespace {
+
+const std::string SESSION_FIELD = "session";
+
+bool contains(
+    const std::vector<std::string>& session_ids,
+    const std::string& session_id) {
+  return std::find(session_ids.begin(), session_ids.end(), session_id) !=
+         session_ids.end();
+}
+
+std::string get_credit_field(const CreditKey& key) {
+  return "credit:" + std::to_string(key.rating_group) + ":" +
+         std::to_string(key.service_identifier);
+}
+
+std::string get_monitor_field(const std::string& monitoring_key) {
+  return "monitor:" + monitoring_key;
+}
+
+// Update criteria that change more of a session than its credits and
+// monitors
+bool is_session_field_updated(const SessionStateUpdateCriteria& uc) {
+  if (uc.is_fsm_updated || uc.is_config_updated || uc.is_local_teid_updated ||
+      uc.is_pending_event_triggers_updated || uc.is_bearer_mapping_updated ||
+      uc.is_session_level_key_updated || uc.updated_pdp_end_time > 0 ||
+      uc.request_number_increment > 0 || has_rule_updates(uc)) {
+    return true;
+  }
+  // Deleting the session level monitor also resets the session level key
+  for (const auto& it : uc.monitor_credit_map) {
+    if (it.second.deleted) {
+      return true;
+    }
+  }
+  return false;
+}
+
+std::string write_session_field(const StoredSessionState& stored) {
+  SessionRecords records;
+  records.set_version(STORED_SESSIONS_VERSION);
+  auto record = records.add_sessions();
+  serialize_stored_session(stored, record);
+  record->clear_charging_grants();
+  record->clear_monitors();
+  return records.SerializeAsString();
+}
+
+std::string write_credit_field(
+    const CreditKey& key, const StoredChargingGrant& grant) {
+  SessionRecords records;
+  records.set_version(STORED_SESSIONS_VERSION);
+  serialize_stored_charging_grant(
+      key, grant, records.add_sessions()->add_charging_grants());
+  return records.SerializeAsString();
+}
+
+std::string write_monitor_field(
+    const std::string& monitoring_key, const StoredMonitor& monitor) {
+  SessionRecords records;
+  records.set_version(STORED_SESSIONS_VERSION);
+  serialize_stored_monitor(
+      monitoring_key, monitor, records.add_sessions()->add_monitors());
+  return records.SerializeAsString();
+}
+
+void write_session(
+    const StoredSessionState& stored,
+    std::vector<std::pair<std::string, std::string>>& fields) {
+  fields.emplace_back(SESSION_FIELD, write_session_field(stored));
+  for (const auto& credit_pair : stored.credit_map) {
+    fields.emplace_back(
+        get_credit_field(credit_pair.first),
+        write_credit_field(credit_pair.first, credit_pair.second));
+  }
+  for (const auto& monitor_pair : stored.monitor_map) {
+    fields.emplace_back(
+        get_monitor_field(monitor_pair.first),
+        write_monitor_field(monitor_pair.first, monitor_pair.second));
+  }
+}
+
+}  // namespace
+
+uint64_t StoreWrites::get_bytes() const {
+  uint64_t bytes = 0;
+  for (const auto& it : subscribers) {
+    bytes += it.first.size() + it.second.size();
+  }
+  for (const auto& key : deleted_keys) {
+    bytes += key.size();
+  }
+  for (const auto& it : set_fields) {
+    bytes += it.first.size();
+    for (const auto& field : it.second) {
+      bytes += field.first.size() + field.second.size();
+    }
+  }
+  for (const auto& it : deleted_fields) {
+    bytes += it.first.size();
+    for (const auto& field : it.second) {
+      bytes += field.size();
+    }
+  }
+  return bytes;
+}
+
+StoredSessionLayout::StoredSessionLayout(const std::string& table)
+    : table_(table) {}
+
+std::string StoredSessionLayout::get_session_key(
+    const std::string& session_id) const {
+  return table_ + ":" + session_id;
+}
+
+void StoredSessionLayout::read_subscriber(
+    const std::string& subscriber_id, const std::string& value,
+    std::vector<StoredSessionState>& sessions,
+    std::vector<std::string>& session_ids) {
+  // Inline values are written whole on the next write
+  session_ids_.erase(subscriber_id);
+  unwritten_.erase(subscriber_id);
+  if (!value.empty() && value[0] == '[') {
+    sessions = deserialize_stored_session_vec(value);
+    return;
+  }
+  SessionRecords records;
+  parse_session_records(value, &records);
+  for (const auto& record : records.sessions()) {
+    sessions.push_back(deserialize_stored_session(record));
+  }
+  if (records.session_ids_size() > 0) {
+    session_ids.assign(
+        records.session_ids().begin(), records.session_ids().end());
+    session_ids_[subscriber_id] = session_ids;
+  }
+}
+
+StoredSessionState StoredSessionLayout::read_session(
+    const std::vector<std::string>& values) {
+  // Each field holds a part of the session, and merging them puts it back
+  // together
+  SessionRecord record;
+  for (const auto& value : values) {
+    SessionRecords records;
+    parse_session_records(value, &records);
+    for (const auto& part : records.sessions()) {
+      record.MergeFrom(part);
+    }
+  }
+  return deserialize_stored_session(record);
+}
+
+StoreWrites StoredSessionLayout::get_writes(
+    const SessionMap& session_map, const SessionUpdate& session_update) {
+  StoreWrites writes;
+  for (const auto& it : session_map) {
+    const std::string& imsi = it.first;
+    std::vector<std::string> session_ids;
+    for (const auto& session : it.second) {
+      session_ids.push_back(session->get_session_id());
+    }
+
+    auto ids_it    = session_ids_.find(imsi);
+    auto update_it = session_update.find(imsi);
+    bool is_stored = ids_it != session_ids_.end();
+    bool is_update = is_stored && update_it != session_update.end() &&
+                     unwritten_.count(imsi) == 0;
+    if (is_stored) {
+      for (const auto& session_id : ids_it->second) {
+        if (!contains(session_ids, session_id)) {
+          writes.deleted_keys.push_back(get_session_key(session_id));
+        }
+      }
+    }
+    if (!is_update || session_ids != ids_it->second) {
+      std::string value;
+      if (!session_ids.empty()) {
+        SessionRecords records;
+        records.set_version(STORED_SESSIONS_VERSION);
+        for (const auto& session_id : session_ids) {
+          records.add_session_ids(session_id);
+        }
+        value = records.SerializeAsString();
+      }
+      writes.subscribers[imsi] = value;
+    }
+
+    for (const auto& session : it.second) {
+      const std::string& session_id = session->get_session_id();
+      std::string key               = get_session_key(session_id);
+      if (!is_update || !contains(ids_it->second, session_id)) {
+        writes.deleted_keys.push_back(key);
+        write_session(session->marshal(), writes.set_fields[key]);
+        continue;
+      }
+      auto uc_it = update_it->second.find(session_id);
+      if (uc_it == update_it->second.end()) {
+        continue;
+      }
+
+      // Only write what the update criteria change, from the session itself
+      const auto& uc       = uc_it->second;
+      auto stored          = session->marshal();
+      auto& set_fields     = writes.set_fields[key];
+      auto& deleted_fields = writes.deleted_fields[key];
+      if (is_session_field_updated(uc)) {
+        set_fields.emplace_back(SESSION_FIELD, write_session_field(stored));
+      }
+      auto write_credit = [&](const CreditKey& credit_key) {
+        auto credit_it = stored.credit_map.find(credit_key);
+        if (credit_it == stored.credit_map.end()) {
+          deleted_fields.push_back(get_credit_field(credit_key));
+          return;
+        }
+        set_fields.emplace_back(
+            get_credit_field(credit_key),
+            write_credit_field(credit_key, credit_it->second));
+      };
+      for (const auto& credit_pair : uc.charging_credit_map) {
+        write_credit(credit_pair.first);
+      }
+      for (const auto& credit_pair : uc.charging_credit_to_install) {
+        write_credit(credit_pair.first);
+      }
+      auto write_monitor = [&](const std::string& monitoring_key) {
+        auto monitor_it = stored.monitor_map.find(monitoring_key);
+        if (monitor_it == stored.monitor_map.end()) {
+          deleted_fields.push_back(get_monitor_field(monitoring_key));
+          return;
+        }
+        set_fields.emplace_back(
+            get_monitor_field(monitoring_key),
+            write_monitor_field(monitoring_key, monitor_it->second));
+      };
+      for (const auto& monitor_pair : uc.monitor_credit_map) {
+        write_monitor(monitor_pair.first);
+      }
+      for (const auto& monitor_pair : uc.monitor_credit_to_install) {
+        write_monitor(monitor_pair.first);
+      }
+      if (set_fields.empty()) {
+        writes.set_fields.erase(key);
+      }
+      if (deleted_fields.empty()) {
+        writes.deleted_fields.erase(key);
+      }
+    }
+  }
+  return writes;
+}
+
+void StoredSessionLayout::set_written(const SessionMap& session_map) {
+  for (const auto& it : session_map) {
+    unwritten_.erase(it.first);
+    if (it.second.empty()) {
+      session_ids_.erase(it.first);
+      continue;
+    }
+    auto& session_ids = session_ids_[it.first];
+    session_ids.clear();
+    for (const auto& session : it.second) {
+      session_ids.push_back(session->get_session_id());
+    }
+  }
+}
+
+void StoredSessionLayout::set_write_failed(const SessionMap& session_map) {
+  for (const auto& it : session_map) {
+    unwritten_.insert(it.first);
+    // Either the old or the new sessions may be stored, so the next write
+    // has to delete the hashes of both that it doesn't write
+    auto& session_ids = session_ids_[it.first];
+    for (const auto& session : it.second) {
+      const std::string& session_id = session->get_session_id();
+      if (!contains(session_ids, session_id)) {
+        session_ids.push_back(session_id);
+      }
+    }
+  }
+}
+
+}  // namespace lte
+}  // namespace magma
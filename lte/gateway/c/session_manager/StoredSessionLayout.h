@@ -0,0 +1,112 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "StoreClient.h"
+#include "StoredState.h"
+
+namespace magma {
+namespace lte {
+
+/**
+ * Commands that bring the store up to date with a set of sessions, in the
+ * order they have to be run
+ */
+struct StoreWrites {
+  // Value of each subscriber in the sessions table, empty to delete it
+  std::unordered_map<std::string, std::string> subscribers;
+  // Session hashes to delete, before their fields are set again for the
+  // sessions written whole
+  std::vector<std::string> deleted_keys;
+  std::unordered_map<
+      std::string, std::vector<std::pair<std::string, std::string>>>
+      set_fields;
+  std::unordered_map<std::string, std::vector<std::string>> deleted_fields;
+
+  // Bytes of the keys, fields and values written
+  uint64_t get_bytes() const;
+};
+
+/**
+ * StoredSessionLayout lays sessions out so that an update only rewrites what
+ * it changes. The sessions table maps each subscriber to the ids of its
+ * sessions, and each session is a hash of its own, <table>:<session_id>, with
+ * a field for the state outside of its credits and monitors, and a field per
+ * credit and per monitor.
+ *
+ * Subscribers stored inline by older sessiond are read as such, and moved to
+ * the new layout on their next write.
+ */
+class StoredSessionLayout {
+ public:
+  StoredSessionLayout(const std::string& table);
+
+  std::string get_session_key(const std::string& session_id) const;
+
+  /**
+   * Decode the value of a subscriber in the sessions table
+   * @param sessions sessions the value holds inline
+   * @param session_ids ids of the sessions stored in their own hash, to read
+   *                    with read_session
+   * @throws std::exception if the value is malformed or from a newer version
+   */
+  void read_subscriber(
+      const std::string& subscriber_id, const std::string& value,
+      std::vector<StoredSessionState>& sessions,
+      std::vector<std::string>& session_ids);
+
+  /**
+   * Decode a session from the values of the fields of its hash
+   * @throws std::exception if a value is malformed or from a newer version
+   */
+  StoredSessionState read_session(const std::vector<std::string>& values);
+
+  /**
+   * Get the writes that store the sessions of session_map. For subscribers
+   * already in this layout, the sessions with update criteria in
+   * session_update only get the fields the criteria change written, and the
+   * sessions with none are left as they are. Everything else is written
+   * whole.
+   */
+  StoreWrites get_writes(
+      const SessionMap& session_map, const SessionUpdate& session_update);
+
+  /**
+   * Record that the writes of session_map are committed to the store
+   */
+  void set_written(const SessionMap& session_map);
+
+  /**
+   * Record that the writes of session_map may not have been committed, so
+   * that its subscribers are written whole on their next write, whatever
+   * update criteria they come with
+   */
+  void set_write_failed(const SessionMap& session_map);
+
+ private:
+  std::string table_;
+  // Ids of the sessions of the subscribers stored in this layout. After a
+  // failed write, they include the ids of both the old and the new sessions
+  std::unordered_map<std::string, std::vector<std::string>> session_ids_;
+  // Subscribers whose last write may not have been committed
+  std::unordered_set<std::string> unwritten_;
+};
+
+}  // namespace lte
+}  // namespace magma
@@ -11,6 +11,8 @@
  * limitations under the License.
  */
 
+#include <stdexcept>
+
 #include <google/protobuf/timestamp.pb.h>
 #include <google/protobuf/util/time_util.h>
 
@@ -67,6 +69,17 @@ SessionStateUpdateCriteria get_default_update_criteria() {
   return uc;
 }
 
+bool has_rule_updates(const SessionStateUpdateCriteria& uc) {
+  return !uc.static_rules_to_install.empty() ||
+         !uc.static_rules_to_uninstall.empty() ||
+         !uc.new_scheduled_static_rules.empty() ||
+         !uc.dynamic_rules_to_install.empty() ||
+         !uc.dynamic_rules_to_uninstall.empty() ||
+         !uc.new_scheduled_dynamic_rules.empty() ||
+         !uc.gy_dynamic_rules_to_install.empty() ||
+         !uc.gy_dynamic_rules_to_uninstall.empty();
+}
+
 std::string serialize_stored_session_config(const SessionConfig& stored) {
   folly::dynamic marshaled    = folly::dynamic::object;
   marshaled["common_context"] = stored.common_context.SerializeAsString();
@@ -509,6 +522,248 @@ StoredSessionState deserialize_stored_session(std::string& serialized) {
   return stored;
 }
 
+void serialize_stored_session_credit(
+    const StoredSessionCredit& stored, CreditRecord* record) {
+  record->set_reporting(stored.reporting);
+  record->set_credit_limit_type(stored.credit_limit_type);
+  for (int bucket_int = USED_TX; bucket_int != MAX_VALUES; bucket_int++) {
+    auto it = stored.buckets.find(static_cast<Bucket>(bucket_int));
+    record->add_buckets(it == stored.buckets.end() ? 0 : it->second);
+  }
+  record->set_grant_tracking_type(stored.grant_tracking_type);
+  *record->mutable_received_granted_units() = stored.received_granted_units;
+  record->set_report_last_credit(stored.report_last_credit);
+  record->set_time_of_first_usage(stored.time_of_first_usage);
+  record->set_time_of_last_usage(stored.time_of_last_usage);
+  record->set_usage_rate(stored.usage_rate.bytes_per_sec);
+  record->set_usage_rate_window_start(stored.usage_rate.window_start);
+  record->set_usage_rate_window_bytes(stored.usage_rate.window_bytes);
+}
+
+StoredSessionCredit deserialize_stored_session_credit(
+    const CreditRecord& record) {
+  auto stored              = StoredSessionCredit{};
+  stored.reporting         = record.reporting();
+  stored.credit_limit_type = record.credit_limit_type();
+  stored.grant_tracking_type =
+      static_cast<GrantTrackingType>(record.grant_tracking_type());
+  stored.received_granted_units   = record.received_granted_units();
+  stored.report_last_credit       = record.report_last_credit();
+  stored.time_of_first_usage      = record.time_of_first_usage();
+  stored.time_of_last_usage       = record.time_of_last_usage();
+  stored.usage_rate.bytes_per_sec = record.usage_rate();
+  stored.usage_rate.window_start  = record.usage_rate_window_start();
+  stored.usage_rate.window_bytes  = record.usage_rate_window_bytes();
+
+  for (int bucket_int = USED_TX; bucket_int != MAX_VALUES; bucket_int++) {
+    Bucket bucket          = static_cast<Bucket>(bucket_int);
+    stored.buckets[bucket] =
+        bucket_int < record.buckets_size() ? record.buckets(bucket_int) : 0;
+  }
+  return stored;
+}
+
+void serialize_stored_charging_grant(
+    const CreditKey& key, const StoredChargingGrant& stored,
+    ChargingGrantRecord* record) {
+  record->set_rating_group(key.rating_group);
+  record->set_service_identifier(key.service_identifier);
+  serialize_stored_session_credit(stored.credit, record->mutable_credit());
+  record->set_is_final(stored.is_final);
+
+  auto final_action_info = record->mutable_final_action_info();
+  final_action_info->set_final_action(stored.final_action_info.final_action);
+  *final_action_info->mutable_redirect_server() =
+      stored.final_action_info.redirect_server;
+  for (const auto& rule_id : stored.final_action_info.restrict_rules) {
+    final_action_info->add_restrict_rules(rule_id);
+  }
+
+  record->set_reauth_state(stored.reauth_state);
+  record->set_service_state(stored.service_state);
+  record->set_expiry_time(stored.expiry_time);
+  record->set_suspended(stored.suspended);
+}
+
+StoredChargingGrant deserialize_stored_charging_grant(
+    const ChargingGrantRecord& record) {
+  auto stored     = StoredChargingGrant{};
+  stored.credit   = deserialize_stored_session_credit(record.credit());
+  stored.is_final = record.is_final();
+
+  const auto& final_action_info = record.final_action_info();
+  stored.final_action_info.final_action = final_action_info.final_action();
+  stored.final_action_info.redirect_server =
+      final_action_info.redirect_server();
+  stored.final_action_info.restrict_rules.assign(
+      final_action_info.restrict_rules().begin(),
+      final_action_info.restrict_rules().end());
+
+  stored.reauth_state  = static_cast<ReAuthState>(record.reauth_state());
+  stored.service_state = static_cast<ServiceState>(record.service_state());
+  stored.expiry_time   = static_cast<std::time_t>(record.expiry_time());
+  stored.suspended     = record.suspended();
+  return stored;
+}
+
+void serialize_stored_monitor(
+    const std::string& monitoring_key, const StoredMonitor& stored,
+    MonitorRecord* record) {
+  record->set_monitoring_key(monitoring_key);
+  serialize_stored_session_credit(stored.credit, record->mutable_credit());
+  record->set_level(stored.level);
+}
+
+StoredMonitor deserialize_stored_monitor(const MonitorRecord& record) {
+  auto stored   = StoredMonitor{};
+  stored.credit = deserialize_stored_session_credit(record.credit());
+  stored.level  = record.level();
+  return stored;
+}
+
+void serialize_stored_session(
+    const StoredSessionState& stored, SessionRecord* record) {
+  record->set_fsm_state(stored.fsm_state);
+  *record->mutable_common_context()       = stored.config.common_context;
+  *record->mutable_rat_specific_context() = stored.config.rat_specific_context;
+  for (const auto& credit_pair : stored.credit_map) {
+    serialize_stored_charging_grant(
+        credit_pair.first, credit_pair.second, record->add_charging_grants());
+  }
+  for (const auto& monitor_pair : stored.monitor_map) {
+    serialize_stored_monitor(
+        monitor_pair.first, monitor_pair.second, record->add_monitors());
+  }
+  record->set_session_level_key(stored.session_level_key);
+  record->set_imsi(stored.imsi);
+  record->set_session_id(stored.session_id);
+  record->set_local_teid(stored.local_teid);
+  record->set_subscriber_quota_state(stored.subscriber_quota_state);
+  *record->mutable_create_session_response() = stored.create_session_response;
+  *record->mutable_tgpp_context()            = stored.tgpp_context;
+  record->set_pdp_start_time(stored.pdp_start_time);
+  record->set_pdp_end_time(stored.pdp_end_time);
+
+  auto& pending_event_triggers = *record->mutable_pending_event_triggers();
+  for (const auto& trigger_pair : stored.pending_event_triggers) {
+    pending_event_triggers[int(trigger_pair.first)] = trigger_pair.second;
+  }
+  *record->mutable_revalidation_time() = stored.revalidation_time;
+
+  for (const auto& pair : stored.bearer_id_by_policy) {
+    auto bearer_id_by_policy = record->add_bearer_id_by_policy();
+    bearer_id_by_policy->set_policy_type(pair.first.policy_type);
+    bearer_id_by_policy->set_rule_id(pair.first.rule_id);
+    bearer_id_by_policy->set_bearer_id(pair.second);
+  }
+
+  for (const auto& rule_id : stored.static_rule_ids) {
+    record->add_static_rule_ids(rule_id);
+  }
+  for (const auto& rule : stored.dynamic_rules) {
+    *record->add_dynamic_rules() = rule;
+  }
+  for (const auto& rule : stored.gy_dynamic_rules) {
+    *record->add_gy_dynamic_rules() = rule;
+  }
+  record->set_request_number(stored.request_number);
+}
+
+StoredSessionState deserialize_stored_session(const SessionRecord& record) {
+  auto stored      = StoredSessionState{};
+  stored.fsm_state = static_cast<SessionFsmState>(record.fsm_state());
+  stored.config.common_context       = record.common_context();
+  stored.config.rat_specific_context = record.rat_specific_context();
+
+  stored.credit_map = StoredChargingCreditMap(4, &ccHash, &ccEqual);
+  for (const auto& grant : record.charging_grants()) {
+    auto key = CreditKey(grant.rating_group(), grant.service_identifier());
+    stored.credit_map[key] = deserialize_stored_charging_grant(grant);
+  }
+  for (const auto& monitor : record.monitors()) {
+    stored.monitor_map[monitor.monitoring_key()] =
+        deserialize_stored_monitor(monitor);
+  }
+  stored.session_level_key       = record.session_level_key();
+  stored.imsi                    = record.imsi();
+  stored.session_id              = record.session_id();
+  stored.local_teid              = record.local_teid();
+  stored.subscriber_quota_state  = record.subscriber_quota_state();
+  stored.create_session_response = record.create_session_response();
+  stored.tgpp_context            = record.tgpp_context();
+  stored.pdp_start_time          = record.pdp_start_time();
+  stored.pdp_end_time            = record.pdp_end_time();
+
+  for (const auto& trigger_pair : record.pending_event_triggers()) {
+    auto event_trigger = magma::lte::EventTrigger(trigger_pair.first);
+    stored.pending_event_triggers[event_trigger] =
+        EventTriggerState(trigger_pair.second);
+  }
+  stored.revalidation_time = record.revalidation_time();
+
+  for (const auto& bearer_id_by_policy : record.bearer_id_by_policy()) {
+    PolicyType policy_type = PolicyType(bearer_id_by_policy.policy_type());
+    stored.bearer_id_by_policy[PolicyID(
+        policy_type, bearer_id_by_policy.rule_id())] =
+        bearer_id_by_policy.bearer_id();
+  }
+
+  stored.static_rule_ids.assign(
+      record.static_rule_ids().begin(), record.static_rule_ids().end());
+  stored.dynamic_rules.assign(
+      record.dynamic_rules().begin(), record.dynamic_rules().end());
+  stored.gy_dynamic_rules.assign(
+      record.gy_dynamic_rules().begin(), record.gy_dynamic_rules().end());
+  stored.request_number = record.request_number();
+  return stored;
+}
+
+void parse_session_records(
+    const std::string& serialized, SessionRecords* records) {
+  if (!records->ParseFromString(serialized)) {
+    throw std::runtime_error("Malformed session records");
+  }
+  if (records->version() > STORED_SESSIONS_VERSION) {
+    throw std::runtime_error(
+        "Session records version " + std::to_string(records->version()) +
+        " is newer than " + std::to_string(STORED_SESSIONS_VERSION));
+  }
+}
+
+std::string serialize_stored_session_vec(
+    const std::vector<StoredSessionState>& stored) {
+  SessionRecords records;
+  records.set_version(STORED_SESSIONS_VERSION);
+  for (const auto& session : stored) {
+    serialize_stored_session(session, records.add_sessions());
+  }
+  return records.SerializeAsString();
+}
+
+std::vector<StoredSessionState> deserialize_stored_session_vec(
+    const std::string& serialized) {
+  std::vector<StoredSessionState> stored;
+  // A SessionRecords message never starts with '[', which would be the tag of
+  // a field 11 group
+  if (!serialized.empty() && serialized[0] == '[') {
+    folly::dynamic marshaled = folly::parseJson(serialized);
+    for (auto& it : marshaled) {
+      stored.push_back(deserialize_stored_session(it.getString()));
+    }
+    return stored;
+  }
+
+  SessionRecords records;
+  parse_session_records(serialized, &records);
+  if (records.session_ids_size() > 0) {
+    throw std::runtime_error("Sessions stored in hashes of their own");
+  }
+  for (const auto& record : records.sessions()) {
+    stored.push_back(deserialize_stored_session(record));
+  }
+  return stored;
+}
+
 RuleLifetime::RuleLifetime(const StaticRuleInstall& rule_install) {
   activation_time =
       std::time_t(TimeUtil::TimestampToSeconds(rule_install.activation_time()));
@@ -22,9 +22,13 @@
 #include <lte/protos/pipelined.grpc.pb.h>
 #include <lte/protos/session_manager.grpc.pb.h>
 #include <lte/protos/session_manager.grpc.pb.h>
+#include <lte/protos/sessiond_state.pb.h>
 
 #include "CreditKey.h"
 
+// Version of the SessionRecords encoding written to the store
+#define STORED_SESSIONS_VERSION 2
+
 namespace magma {
 struct SessionConfig {
   CommonSessionContext common_context;
@@ -133,6 +137,19 @@ enum SessionFsmState {
   RELEASE                       = 11,
 };
 
+/**
+ * Moving average of the rate at which a credit is used, sampled over windows
+ * of at least SessionCredit::USAGE_RATE_WINDOW_MS
+ */
+struct UsageRate {
+  // Bytes per second, 0 until the first window is complete
+  double bytes_per_sec;
+  // Start of the current window in ms since epoch, 0 before any usage
+  uint64_t window_start;
+  // Bytes used since the start of the current window
+  uint64_t window_bytes;
+};
+
 struct StoredSessionCredit {
   bool reporting;
   CreditLimitType credit_limit_type;
@@ -142,6 +159,7 @@ struct StoredSessionCredit {
   bool report_last_credit;
   uint64_t time_of_first_usage;
   uint64_t time_of_last_usage;
+  UsageRate usage_rate;
 };
 
 struct StoredMonitor {
@@ -259,6 +277,7 @@ struct SessionCreditUpdateCriteria {
 
   uint64_t time_of_first_usage;
   uint64_t time_of_last_usage;
+  UsageRate usage_rate;
 
   bool suspended;
 };
@@ -313,6 +332,13 @@ struct SessionStateUpdateCriteria {
 
 SessionStateUpdateCriteria get_default_update_criteria();
 
+/**
+ * Rule changes are the only part of the update criteria that
+ * SessionState::apply_update_criteria can reject, after it already applied
+ * the rest
+ */
+bool has_rule_updates(const SessionStateUpdateCriteria& uc);
+
 std::string serialize_stored_session_config(const SessionConfig& stored);
 
 SessionConfig deserialize_stored_session_config(const std::string& serialized);
@@ -350,4 +376,55 @@ std::string serialize_bearer_id_by_policy(BearerIDByPolicyID bearer_map);
 std::string serialize_stored_session(StoredSessionState& stored);
 
 StoredSessionState deserialize_stored_session(std::string& serialized);
+
+/**
+ * Binary encoding of the stored state, written by the store since it is more
+ * compact and cheaper to parse than the JSON one above, which has nested
+ * structures serialized as escaped JSON strings. The JSON functions are kept
+ * to read what older sessiond wrote.
+ */
+void serialize_stored_session_credit(
+    const StoredSessionCredit& stored, CreditRecord* record);
+
+StoredSessionCredit deserialize_stored_session_credit(
+    const CreditRecord& record);
+
+void serialize_stored_charging_grant(
+    const CreditKey& key, const StoredChargingGrant& stored,
+    ChargingGrantRecord* record);
+
+StoredChargingGrant deserialize_stored_charging_grant(
+    const ChargingGrantRecord& record);
+
+void serialize_stored_monitor(
+    const std::string& monitoring_key, const StoredMonitor& stored,
+    MonitorRecord* record);
+
+StoredMonitor deserialize_stored_monitor(const MonitorRecord& record);
+
+void serialize_stored_session(
+    const StoredSessionState& stored, SessionRecord* record);
+
+StoredSessionState deserialize_stored_session(const SessionRecord& record);
+
+/**
+ * Parse a SessionRecords message
+ * @throws std::exception if it is malformed or from a newer version
+ */
+void parse_session_records(
+    const std::string& serialized, SessionRecords* records);
+
+/**
+ * Encode the sessions of a subscriber as a versioned SessionRecords message
+ */
+std::string serialize_stored_session_vec(
+    const std::vector<StoredSessionState>& stored);
+
+/**
+ * Decode the sessions of a subscriber. Values written as a JSON array of
+ * serialize_stored_session strings are migrated transparently.
+ * @throws std::exception if the value is malformed or from a newer version
+ */
+std::vector<StoredSessionState> deserialize_stored_session_vec(
+    const std::string& serialized);
 }  // namespace magma
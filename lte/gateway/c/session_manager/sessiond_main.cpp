@@ -129,6 +129,10 @@ void set_consts(const YAML::Node& config) {
     magma::SessionCredit::DEFAULT_REQUESTED_UNITS =
         config["default_requested_units"].as<uint64_t>();
   }
+  if (config["predictive_reporting_margin_ms"].IsDefined()) {
+    magma::LocalEnforcer::PREDICTIVE_REPORTING_MARGIN_MS =
+        config["predictive_reporting_margin_ms"].as<uint32_t>();
+  }
 }
 
 magma::SessionStore* create_session_store(
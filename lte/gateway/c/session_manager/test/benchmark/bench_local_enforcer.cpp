@@ -0,0 +1,111 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+
+#include <benchmark/benchmark.h>
+
+#include "LocalEnforcer.h"
+#include "ProtobufCreators.h"
+#include "RuleStore.h"
+#include "SessionState.h"
+#include "SessionStore.h"
+#include "SessiondMocks.h"
+
+/*
+ * Record aggregation of one ReportRuleStats: every session reports the usage
+ * of each of its rules, as pipelined does, and the records are aggregated
+ * into the sessions read from SessionStore.
+ */
+namespace magma {
+namespace {
+
+#define RULES_PER_SESSION 10
+
+std::string get_rule_id(int i) {
+  return "rule" + std::to_string(i);
+}
+
+std::string get_ip(int i) {
+  return "10.0." + std::to_string(i / 250) + "." + std::to_string(i % 250 + 1);
+}
+
+std::unique_ptr<SessionState> make_session(
+    const std::string& imsi, const std::string& ip,
+    StaticRuleStore& rule_store) {
+  SessionConfig cfg;
+  cfg.common_context = build_common_context(
+      imsi, ip, "", Teids{}, "magma.ipv4", "", TGPP_LTE);
+  auto session_id = imsi + "-1";
+  auto session    = std::make_unique<SessionState>(
+      imsi, session_id, cfg, rule_store, TgppContext{}, 0,
+      CreateSessionResponse{});
+
+  auto uc = get_default_update_criteria();
+  CreditUpdateResponse credit;
+  create_credit_update_response(
+      imsi, session_id, 1, uint64_t(1) << 40, &credit);
+  session->receive_charging_credit(credit, uc);
+  RuleLifetime lifetime{};
+  for (int i = 0; i < RULES_PER_SESSION; i++) {
+    session->activate_static_rule(get_rule_id(i), lifetime, uc);
+  }
+  return session;
+}
+
+void BM_AggregateRecords(benchmark::State& state) {
+  auto rule_store = std::make_shared<StaticRuleStore>();
+  SessionStore session_store(rule_store);
+  LocalEnforcer local_enforcer(
+      std::make_shared<MockSessionReporter>(), rule_store, session_store,
+      std::make_shared<MockPipelinedClient>(),
+      std::make_shared<MockDirectorydClient>(),
+      std::make_shared<MockEventsReporter>(),
+      std::make_shared<MockSpgwServiceClient>(),
+      std::make_shared<MockAAAClient>(), 0, 0, get_default_mconfig());
+  for (int i = 0; i < RULES_PER_SESSION; i++) {
+    PolicyRule rule;
+    create_policy_rule(get_rule_id(i), "", 1, &rule);
+    rule_store->insert_rule(rule);
+  }
+
+  RuleRecordTable records;
+  for (int i = 0; i < state.range(0); i++) {
+    auto imsi     = "IMSI00101" + std::to_string(1000000000 + i);
+    auto ip       = get_ip(i);
+    auto sessions = SessionVector{};
+    sessions.push_back(make_session(imsi, ip, *rule_store));
+    session_store.create_sessions(imsi, std::move(sessions));
+    for (int j = 0; j < RULES_PER_SESSION; j++) {
+      create_rule_record(
+          imsi, ip, get_rule_id(j), 1000, 2000, records.add_records());
+    }
+  }
+
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto session_map = session_store.read_all_sessions();
+    auto update      = SessionStore::get_default_session_update(session_map);
+    state.ResumeTiming();
+    local_enforcer.aggregate_records(session_map, records, update);
+  }
+  state.SetItemsProcessed(state.iterations() * records.records_size());
+}
+
+}  // namespace
+}  // namespace magma
+
+BENCHMARK(magma::BM_AggregateRecords)
+    ->Arg(20000)
+    ->Unit(benchmark::kMillisecond);
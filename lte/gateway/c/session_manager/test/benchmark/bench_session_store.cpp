@@ -0,0 +1,259 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "RuleStore.h"
+#include "SessionState.h"
+#include "SessionStore.h"
+#include "StoreClient.h"
+#include "StoredSessionLayout.h"
+#include "StoredState.h"
+
+/*
+ * One ReportRuleStats cycle: read all sessions, record the usage of one
+ * session in USAGE_PERIOD, and commit the update criteria. The storage is
+ * kept in process, serialized as RedisStoreClient does it, so the numbers
+ * leave out the Redis round trips. bytes_per_cycle counts what a cycle
+ * writes to storage.
+ */
+namespace magma {
+namespace {
+
+#define USAGE_PERIOD 10
+
+const std::string MONITORING_KEY = "mk1";
+
+// RedisStoreClient without Redis: the sessions table and the session hashes
+// are kept in process, laid out by StoredSessionLayout. With write_updates
+// false, update criteria are ignored and subscribers are written whole.
+class LocalStoreClient final : public StoreClient {
+ public:
+  LocalStoreClient(
+      std::shared_ptr<StaticRuleStore> rule_store, bool write_updates)
+      : rule_store_(rule_store),
+        write_updates_(write_updates),
+        layout_("sessions"),
+        bytes_written_(0) {}
+
+  SessionMap read_sessions(std::set<std::string> subscriber_ids) {
+    SessionMap session_map;
+    for (const std::string& imsi : subscriber_ids) {
+      auto it = table_.find(imsi);
+      if (it == table_.end()) {
+        session_map[imsi] = SessionVector{};
+        continue;
+      }
+      session_map[imsi] = read_subscriber(imsi, it->second);
+    }
+    return session_map;
+  }
+
+  SessionMap read_all_sessions() {
+    SessionMap session_map;
+    for (const auto& it : table_) {
+      session_map[it.first] = read_subscriber(it.first, it.second);
+    }
+    return session_map;
+  }
+
+  bool write_sessions(const SessionMap& session_map) {
+    return write_session_updates(session_map, SessionUpdate{});
+  }
+
+  bool write_session_updates(
+      const SessionMap& session_map, const SessionUpdate& session_update) {
+    auto writes = layout_.get_writes(
+        session_map, write_updates_ ? session_update : SessionUpdate{});
+    bytes_written_ += writes.get_bytes();
+    for (const auto& it : writes.subscribers) {
+      if (it.second.empty()) {
+        table_.erase(it.first);
+      } else {
+        table_[it.first] = it.second;
+      }
+    }
+    for (const auto& key : writes.deleted_keys) {
+      hashes_.erase(key);
+    }
+    for (const auto& it : writes.set_fields) {
+      for (const auto& field : it.second) {
+        hashes_[it.first][field.first] = field.second;
+      }
+    }
+    for (const auto& it : writes.deleted_fields) {
+      for (const auto& field : it.second) {
+        hashes_[it.first].erase(field);
+      }
+    }
+    layout_.set_written(session_map);
+    return true;
+  }
+
+  uint64_t get_bytes_written() const { return bytes_written_; }
+
+ private:
+  SessionVector read_subscriber(
+      const std::string& imsi, const std::string& value) {
+    std::vector<StoredSessionState> stored_sessions;
+    std::vector<std::string> session_ids;
+    layout_.read_subscriber(imsi, value, stored_sessions, session_ids);
+    for (const auto& session_id : session_ids) {
+      std::vector<std::string> values;
+      for (const auto& field : hashes_[layout_.get_session_key(session_id)]) {
+        values.push_back(field.second);
+      }
+      stored_sessions.push_back(layout_.read_session(values));
+    }
+    SessionVector sessions;
+    for (auto& stored_session : stored_sessions) {
+      sessions.push_back(SessionState::unmarshal(stored_session, *rule_store_));
+    }
+    return sessions;
+  }
+
+  std::shared_ptr<StaticRuleStore> rule_store_;
+  bool write_updates_;
+  StoredSessionLayout layout_;
+  uint64_t bytes_written_;
+  std::unordered_map<std::string, std::string> table_;
+  std::unordered_map<std::string, std::unordered_map<std::string, std::string>>
+      hashes_;
+};
+
+std::unique_ptr<SessionState> make_session(
+    const std::string& imsi, StaticRuleStore& rule_store) {
+  SessionConfig cfg;
+  cfg.common_context.mutable_sid()->set_id(imsi);
+  cfg.common_context.set_apn("magma.ipv4");
+  cfg.common_context.set_rat_type(TGPP_LTE);
+  auto session = std::make_unique<SessionState>(
+      imsi, imsi + "-1", cfg, rule_store, TgppContext{}, 0,
+      CreateSessionResponse{});
+
+  UsageMonitoringUpdateResponse monitor;
+  monitor.set_success(true);
+  monitor.set_sid(imsi);
+  monitor.set_session_id(imsi + "-1");
+  auto credit = monitor.mutable_credit();
+  credit->set_monitoring_key(MONITORING_KEY);
+  credit->set_level(SESSION_LEVEL);
+  credit->set_action(UsageMonitoringCredit::CONTINUE);
+  auto total = credit->mutable_granted_units()->mutable_total();
+  total->set_is_valid(true);
+  total->set_volume(uint64_t(1) << 40);
+  auto uc = get_default_update_criteria();
+  session->receive_monitor(monitor, uc);
+  return session;
+}
+
+void create_sessions(
+    SessionStore& session_store, int nb_sessions, StaticRuleStore& rule_store) {
+  for (int i = 0; i < nb_sessions; i++) {
+    auto imsi     = "IMSI00101" + std::to_string(1000000000 + i);
+    auto sessions = SessionVector{};
+    sessions.push_back(make_session(imsi, rule_store));
+    session_store.create_sessions(imsi, std::move(sessions));
+  }
+}
+
+void record_usage(SessionMap& session_map, SessionUpdate& update) {
+  int i = 0;
+  for (auto& it : session_map) {
+    for (auto& session : it.second) {
+      if (i++ % USAGE_PERIOD == 0) {
+        session->add_to_monitor(
+            MONITORING_KEY, 1000, 2000,
+            update[it.first][session->get_session_id()]);
+      }
+    }
+  }
+}
+
+// What a report cost when SessionStore read everything back from storage and
+// rewrote every subscriber on update
+void BM_ReportCycleThroughStorage(benchmark::State& state) {
+  auto rule_store   = std::make_shared<StaticRuleStore>();
+  auto store_client = std::make_shared<LocalStoreClient>(rule_store, false);
+  SessionStore session_store(rule_store, store_client);
+  create_sessions(session_store, state.range(0), *rule_store);
+  auto bytes_written = store_client->get_bytes_written();
+
+  for (auto _ : state) {
+    auto session_map = store_client->read_all_sessions();
+    auto update      = SessionStore::get_default_session_update(session_map);
+    record_usage(session_map, update);
+
+    auto stored_map = store_client->read_all_sessions();
+    for (auto& it : stored_map) {
+      for (auto& session : it.second) {
+        auto uc = update[it.first][session->get_session_id()];
+        session->apply_update_criteria(uc);
+      }
+    }
+    store_client->write_sessions(stored_map);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["bytes_per_cycle"] =
+      (store_client->get_bytes_written() - bytes_written) / state.iterations();
+}
+
+void report_cycle_in_memory(benchmark::State& state, bool write_updates) {
+  auto rule_store = std::make_shared<StaticRuleStore>();
+  auto store_client =
+      std::make_shared<LocalStoreClient>(rule_store, write_updates);
+  SessionStore session_store(rule_store, store_client);
+  create_sessions(session_store, state.range(0), *rule_store);
+  auto bytes_written = store_client->get_bytes_written();
+
+  for (auto _ : state) {
+    auto session_map = session_store.read_all_sessions();
+    auto update      = SessionStore::get_default_session_update(session_map);
+    record_usage(session_map, update);
+    session_store.update_sessions(update);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["bytes_per_cycle"] =
+      (store_client->get_bytes_written() - bytes_written) / state.iterations();
+}
+
+// Subscribers with usage written whole
+void BM_ReportCycleInMemory(benchmark::State& state) {
+  report_cycle_in_memory(state, false);
+}
+
+// Only the monitors with usage written
+void BM_ReportCycleInMemoryUpdates(benchmark::State& state) {
+  report_cycle_in_memory(state, true);
+}
+
+}  // namespace
+}  // namespace magma
+
+BENCHMARK(magma::BM_ReportCycleThroughStorage)
+    ->Arg(10000)
+    ->Arg(50000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(magma::BM_ReportCycleInMemory)
+    ->Arg(10000)
+    ->Arg(50000)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(magma::BM_ReportCycleInMemoryUpdates)
+    ->Arg(10000)
+    ->Arg(50000)
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,144 @@
+/**
+ * Copyright 2020 The Magma Authors.
+ *
+ * This source code is licensed under the BSD-style license found in the
+ * LICENSE file in the root directory of this source tree.
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+#include <folly/dynamic.h>
+#include <folly/json.h>
+
+#include "StoredState.h"
+
+/*
+ * Encoding and decoding of the value RedisStoreClient keeps for a subscriber
+ * with one session, in the JSON encoding older sessiond wrote and in the
+ * SessionRecords one. The session has two Gy credits, a session level and a
+ * rule level monitor, and a few rules installed, like a typical LTE session.
+ */
+namespace magma {
+namespace {
+
+StoredSessionCredit make_credit() {
+  StoredSessionCredit credit{};
+  credit.credit_limit_type   = FINITE;
+  credit.grant_tracking_type = TOTAL_ONLY;
+  credit.received_granted_units.mutable_total()->set_is_valid(true);
+  credit.received_granted_units.mutable_total()->set_volume(100000000);
+  credit.time_of_first_usage = 1600000000;
+  credit.time_of_last_usage  = 1600000300;
+  for (int bucket_int = USED_TX; bucket_int != MAX_VALUES; bucket_int++) {
+    credit.buckets[static_cast<Bucket>(bucket_int)] = 1234567 * bucket_int;
+  }
+  return credit;
+}
+
+StoredSessionState make_stored_session() {
+  StoredSessionState stored{};
+  stored.imsi       = "IMSI001010000000001";
+  stored.session_id = stored.imsi + "-1";
+  stored.fsm_state  = SESSION_ACTIVE;
+  stored.local_teid = 1000;
+
+  auto common_context = &stored.config.common_context;
+  common_context->mutable_sid()->set_id(stored.imsi);
+  common_context->set_ue_ipv4("192.168.128.11");
+  common_context->set_apn("magma.ipv4");
+  common_context->set_msisdn("5100001234");
+  common_context->set_rat_type(TGPP_LTE);
+  auto lte_context = stored.config.rat_specific_context.mutable_lte_context();
+  lte_context->set_spgw_ipv4("192.168.60.142");
+  lte_context->set_imei("123456789012345");
+  lte_context->set_plmn_id("00101");
+  lte_context->set_bearer_id(5);
+  lte_context->mutable_qos_info()->set_apn_ambr_ul(100000000);
+  lte_context->mutable_qos_info()->set_apn_ambr_dl(200000000);
+
+  stored.credit_map = StoredChargingCreditMap(4, &ccHash, &ccEqual);
+  for (uint32_t rating_group = 1; rating_group <= 2; rating_group++) {
+    StoredChargingGrant grant{};
+    grant.credit                         = make_credit();
+    grant.expiry_time                    = 1600003600;
+    grant.final_action_info.final_action = ChargingCredit_FinalAction_TERMINATE;
+    stored.credit_map[CreditKey(rating_group)] = grant;
+  }
+  stored.monitor_map["session_level"] = {make_credit(), SESSION_LEVEL};
+  stored.monitor_map["rule_level"]    = {make_credit(), PCC_RULE_LEVEL};
+  stored.session_level_key            = "session_level";
+
+  stored.tgpp_context.set_gx_dest_host("pcrf.magma.com");
+  stored.tgpp_context.set_gy_dest_host("ocs.magma.com");
+  stored.pdp_start_time  = 1600000000;
+  stored.request_number  = 12;
+  stored.static_rule_ids = {"allowlist_sid", "rule_rg_1", "rule_rg_2"};
+  PolicyRule dynamic_rule;
+  dynamic_rule.set_id("dynamic_rule_1");
+  dynamic_rule.set_priority(10);
+  dynamic_rule.set_rating_group(1);
+  dynamic_rule.set_monitoring_key("rule_level");
+  auto ip_dst = dynamic_rule.add_flow_list()->mutable_match()->mutable_ip_dst();
+  ip_dst->set_version(IPAddress::IPV4);
+  ip_dst->set_address("192.168.0.0/24");
+  stored.dynamic_rules.push_back(dynamic_rule);
+  stored.bearer_id_by_policy[PolicyID(DYNAMIC, "dynamic_rule_1")] = 6;
+  return stored;
+}
+
+// What RedisStoreClient wrote before SessionRecords
+std::string serialize_json(StoredSessionState& stored) {
+  folly::dynamic marshaled = folly::dynamic::array;
+  marshaled.push_back(serialize_stored_session(stored));
+  return folly::toJson(marshaled);
+}
+
+void BM_SerializeSessionJson(benchmark::State& state) {
+  auto stored = make_stored_session();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(serialize_json(stored));
+  }
+  state.counters["bytes"] = serialize_json(stored).size();
+}
+
+void BM_DeserializeSessionJson(benchmark::State& state) {
+  auto stored     = make_stored_session();
+  auto serialized = serialize_json(stored);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(deserialize_stored_session_vec(serialized));
+  }
+  state.counters["bytes"] = serialized.size();
+}
+
+void BM_SerializeSessionProto(benchmark::State& state) {
+  auto stored = std::vector<StoredSessionState>{make_stored_session()};
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(serialize_stored_session_vec(stored));
+  }
+  state.counters["bytes"] = serialize_stored_session_vec(stored).size();
+}
+
+void BM_DeserializeSessionProto(benchmark::State& state) {
+  auto stored     = std::vector<StoredSessionState>{make_stored_session()};
+  auto serialized = serialize_stored_session_vec(stored);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(deserialize_stored_session_vec(serialized));
+  }
+  state.counters["bytes"] = serialized.size();
+}
+
+}  // namespace
+}  // namespace magma
+
+BENCHMARK(magma::BM_SerializeSessionJson);
+BENCHMARK(magma::BM_DeserializeSessionJson);
+BENCHMARK(magma::BM_SerializeSessionProto);
+BENCHMARK(magma::BM_DeserializeSessionProto);
@@ -53,6 +53,54 @@ class ChargingGrantTest : public ::testing::Test {
     }
     return fa;
   }
+
+  // Simulate a user using rate bytes per second for 10 minutes, with
+  // pipelined reporting usage every 2 seconds and updates getting a new grant
+  // of grant_volume bytes 3 seconds after they are sent. Returns the number of
+  // times the user ran out of quota before a new grant arrived.
+  int simulate_quota_exhaustions(
+      uint64_t rate, uint64_t grant_volume,
+      std::chrono::milliseconds reporting_lead_time) {
+    const uint64_t tick_ms       = 100;
+    const uint64_t poll_ms       = 2000;
+    const uint64_t round_trip_ms = 3000;
+    const uint64_t start_ms      = 1600000000000;
+
+    ChargingGrant grant = get_default_grant();
+    GrantedUnits gsu;
+    create_granted_units(&grant_volume, NULL, NULL, &gsu);
+    auto uc = grant.get_update_criteria();
+    grant.credit.receive_credit(gsu, &uc);
+
+    uint64_t used        = 0;
+    uint64_t reported    = 0;
+    uint64_t response_ms = 0;
+    bool exhausted       = false;
+    int exhaustions      = 0;
+    for (uint64_t t = tick_ms; t <= 600000; t += tick_ms) {
+      uint64_t now_ms = start_ms + t;
+      if (response_ms != 0 && now_ms >= response_ms) {
+        grant.credit.receive_credit(gsu, &uc);
+        response_ms = 0;
+      }
+      used += rate * tick_ms / 1000;
+      if (t % poll_ms == 0) {
+        grant.credit.add_used_credit(used - reported, 0, now_ms, uc);
+        reported = used;
+        CreditUsage::UpdateType update_type;
+        if (grant.get_update_type(&update_type, reporting_lead_time)) {
+          grant.get_credit_usage(update_type, uc, false);
+          response_ms = now_ms + round_trip_ms;
+        }
+      }
+      bool is_exhausted = used >= grant.credit.get_credit(ALLOWED_TOTAL);
+      if (is_exhausted && !exhausted) {
+        exhaustions++;
+      }
+      exhausted = is_exhausted;
+    }
+    return exhaustions;
+  }
 };
 
 TEST_F(ChargingGrantTest, test_marshal) {
@@ -336,6 +384,51 @@ TEST_F(ChargingGrantTest, test_tolerance_quota_exhausted) {
   EXPECT_FALSE(grant.get_update_type(&update_type));
 }
 
+TEST_F(ChargingGrantTest, test_get_update_type_predicted_exhaustion) {
+  ChargingGrant grant = get_default_grant();
+  GrantedUnits gsu;
+  uint64_t total_grant = 10000;
+  create_granted_units(&total_grant, NULL, NULL, &gsu);
+  auto uc = grant.get_update_criteria();
+  grant.credit.receive_credit(gsu, &uc);
+
+  // Use 1000 bytes per second, leaving 6000 bytes for 6 more seconds
+  uint64_t now_ms = 1600000000000;
+  grant.credit.add_used_credit(2000, 0, now_ms, uc);
+  grant.credit.add_used_credit(1000, 1000, now_ms + 2000, uc);
+  EXPECT_FALSE(grant.credit.is_quota_exhausted(0.8));
+
+  CreditUsage::UpdateType update_type;
+  EXPECT_FALSE(grant.get_update_type(&update_type));
+  EXPECT_FALSE(
+      grant.get_update_type(&update_type, std::chrono::milliseconds(5000)));
+  // The quota runs out before an update sent now would get a response
+  EXPECT_TRUE(
+      grant.get_update_type(&update_type, std::chrono::milliseconds(7000)));
+  EXPECT_EQ(update_type, CreditUsage::QUOTA_EXHAUSTED);
+
+  // Final grants are not reported early
+  grant.is_final_grant = true;
+  EXPECT_FALSE(
+      grant.get_update_type(&update_type, std::chrono::milliseconds(7000)));
+}
+
+TEST_F(ChargingGrantTest, test_predicted_exhaustion_simulation) {
+  // Grants of 4MB last 8 seconds at 500KB/s. The 80% threshold leaves 1.6
+  // seconds to get the next one, less than an update takes.
+  uint64_t rate         = 500000;
+  uint64_t grant_volume = 4000000;
+  int threshold_exhaustions =
+      simulate_quota_exhaustions(rate, grant_volume, std::chrono::seconds(0));
+  // Report 3 seconds of round trip plus 2 seconds of poll interval ahead
+  int predicted_exhaustions =
+      simulate_quota_exhaustions(rate, grant_volume, std::chrono::seconds(5));
+  // Each grant runs out with the threshold alone, and none does with the
+  // prediction
+  EXPECT_EQ(threshold_exhaustions, 60);
+  EXPECT_EQ(predicted_exhaustions, 0);
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
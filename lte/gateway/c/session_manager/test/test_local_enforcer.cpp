@@ -477,6 +477,25 @@ TEST_F(LocalEnforcerTest, test_collect_updates) {
       0);
 }
 
+TEST_F(LocalEnforcerTest, test_reporting_lead_time) {
+  // Predictive reporting is disabled without a margin
+  local_enforcer->record_update_round_trip(std::chrono::milliseconds(1000));
+  EXPECT_EQ(
+      local_enforcer->get_reporting_lead_time(),
+      std::chrono::milliseconds::zero());
+
+  LocalEnforcer::PREDICTIVE_REPORTING_MARGIN_MS = 2000;
+  EXPECT_EQ(
+      local_enforcer->get_reporting_lead_time(),
+      std::chrono::milliseconds(3000));
+  // Round trips are averaged
+  local_enforcer->record_update_round_trip(std::chrono::milliseconds(2000));
+  EXPECT_EQ(
+      local_enforcer->get_reporting_lead_time(),
+      std::chrono::milliseconds(3250));
+  LocalEnforcer::PREDICTIVE_REPORTING_MARGIN_MS = 0;
+}
+
 TEST_F(LocalEnforcerTest, test_update_session_credits_and_rules) {
   insert_static_rule(1, "", "rule1");
 
@@ -433,6 +433,98 @@ TEST(test_get_credit_summary, test_session_credit) {
   EXPECT_GT(summary.time_of_last_usage, summary.time_of_first_usage);
 }
 
+TEST(test_usage_rate, test_session_credit) {
+  SessionCredit credit;
+  auto uc         = credit.get_update_criteria();
+  uint64_t now_ms = 1600000000000;
+
+  // It isn't known how long the first usage took, so it only starts a window
+  credit.add_used_credit(1000, 0, now_ms, uc);
+  EXPECT_EQ(credit.get_usage_rate(), 0);
+
+  // Usage is summed until the window is over
+  credit.add_used_credit(1000, 0, now_ms + 500, uc);
+  EXPECT_EQ(credit.get_usage_rate(), 0);
+  credit.add_used_credit(1000, 2000, now_ms + 2000, uc);
+  EXPECT_EQ(credit.get_usage_rate(), 2000);
+
+  // Next windows are averaged in, including the ones without usage
+  credit.add_used_credit(500, 500, now_ms + 3000, uc);
+  EXPECT_NEAR(credit.get_usage_rate(), 0.3 * 1000 + 0.7 * 2000, 0.01);
+  credit.add_used_credit(0, 0, now_ms + 4000, uc);
+  EXPECT_NEAR(credit.get_usage_rate(), 0.7 * 1700, 0.01);
+
+  // The rate is kept through the update criteria and marshaling
+  EXPECT_EQ(uc.usage_rate.bytes_per_sec, credit.get_usage_rate());
+  EXPECT_EQ(uc.usage_rate.window_start, now_ms + 4000);
+  SessionCredit merged;
+  merged.merge(uc);
+  EXPECT_EQ(merged.get_usage_rate(), credit.get_usage_rate());
+  SessionCredit unmarshaled(credit.marshal());
+  EXPECT_EQ(unmarshaled.get_usage_rate(), credit.get_usage_rate());
+}
+
+TEST(test_usage_rate_merge_stale, test_session_credit) {
+  SessionCredit credit;
+  auto uc         = credit.get_update_criteria();
+  uint64_t now_ms = 1600000000000;
+  credit.add_used_credit(1000, 0, now_ms, uc);
+  credit.add_used_credit(1000, 0, now_ms + 1000, uc);
+  EXPECT_EQ(credit.get_usage_rate(), 1000);
+
+  // Criteria collected for a report, applied once the answer is back
+  auto stale = credit.get_update_criteria();
+  credit.add_used_credit(300, 0, now_ms + 1500, uc);
+  credit.merge(stale);
+  EXPECT_EQ(credit.get_usage_rate(), 1000);
+  EXPECT_EQ(credit.get_update_criteria().usage_rate.window_bytes, 300);
+
+  // Nor does it roll back a rate sampled since
+  credit.add_used_credit(1700, 0, now_ms + 2000, uc);
+  EXPECT_NEAR(credit.get_usage_rate(), 0.3 * 2000 + 0.7 * 1000, 0.01);
+  credit.merge(stale);
+  EXPECT_NEAR(credit.get_usage_rate(), 0.3 * 2000 + 0.7 * 1000, 0.01);
+  EXPECT_EQ(
+      credit.get_update_criteria().usage_rate.window_start, now_ms + 2000);
+
+  // Newer criteria are still taken
+  SessionCredit merged;
+  merged.merge(stale);
+  EXPECT_EQ(merged.get_usage_rate(), 1000);
+  merged.merge(uc);
+  EXPECT_EQ(merged.get_usage_rate(), credit.get_usage_rate());
+}
+
+TEST(test_get_time_to_exhaustion, test_session_credit) {
+  SessionCredit credit;
+  auto uc = credit.get_update_criteria();
+  GrantedUnits gsu;
+  uint64_t total_grant = 10000;
+  create_granted_units(&total_grant, NULL, NULL, &gsu);
+  credit.receive_credit(gsu, &uc);
+
+  // Nothing to predict from before the usage rate is known
+  uint64_t now_ms = 1600000000000;
+  credit.add_used_credit(1000, 1000, now_ms, uc);
+  EXPECT_EQ(credit.get_time_to_exhaustion(), std::chrono::milliseconds::max());
+
+  // 6000 bytes remaining at 2000 bytes per second
+  credit.add_used_credit(1000, 1000, now_ms + 1000, uc);
+  EXPECT_EQ(credit.get_time_to_exhaustion(), std::chrono::milliseconds(3000));
+
+  credit.add_used_credit(3000, 3000, now_ms + 2000, uc);
+  EXPECT_EQ(credit.get_time_to_exhaustion(), std::chrono::milliseconds::zero());
+
+  // Infinite credit is never exhausted
+  SessionCredit infinite_credit(SERVICE_ENABLED, INFINITE_UNMETERED);
+  uc = infinite_credit.get_update_criteria();
+  infinite_credit.add_used_credit(1000, 1000, now_ms, uc);
+  infinite_credit.add_used_credit(1000, 1000, now_ms + 1000, uc);
+  EXPECT_EQ(
+      infinite_credit.get_time_to_exhaustion(),
+      std::chrono::milliseconds::max());
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
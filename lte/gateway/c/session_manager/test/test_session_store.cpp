@@ -12,6 +12,7 @@
  */
 
 #include <memory>
+#include <set>
 
 #include <glog/logging.h>
 #include <gtest/gtest.h>
@@ -31,6 +32,41 @@ using ::testing::Test;
 
 namespace magma {
 
+// StoreClient over a MemoryStoreClient that fails its writes on demand
+class FailingStoreClient : public StoreClient {
+ public:
+  FailingStoreClient(std::shared_ptr<StaticRuleStore> rule_store)
+      : store_client_(rule_store), fail_writes(false) {}
+
+  SessionMap read_sessions(std::set<std::string> subscriber_ids) {
+    return store_client_.read_sessions(subscriber_ids);
+  }
+
+  SessionMap read_all_sessions() { return store_client_.read_all_sessions(); }
+
+  bool write_sessions(const SessionMap& session_map) {
+    return write_session_updates(session_map, SessionUpdate{});
+  }
+
+  bool write_session_updates(
+      const SessionMap& session_map, const SessionUpdate& session_update) {
+    last_written.clear();
+    for (const auto& it : session_map) {
+      last_written.insert(it.first);
+    }
+    last_update = session_update;
+    return !fail_writes && store_client_.write_sessions(session_map);
+  }
+
+ private:
+  MemoryStoreClient store_client_;
+
+ public:
+  bool fail_writes;
+  std::set<std::string> last_written;
+  SessionUpdate last_update;
+};
+
 class SessionStoreTest : public ::testing::Test {
  protected:
   SessionIDGenerator id_gen_;
@@ -493,6 +529,99 @@ TEST_F(SessionStoreTest, test_sync_request_numbers) {
   EXPECT_EQ(session_map_2[IMSI1].front()->get_request_number(), 4);
 }
 
+/**
+ * SessionStore keeps the live sessions in memory and writes them through to
+ * its StoreClient.
+ * 1) Create a SessionStore over a shared MemoryStoreClient, with one session
+ * 2) Reject an update that uninstalls a rule that is not installed, along
+ *    with a valid change to the same session
+ * 3) Verify that none of the rejected update was applied
+ * 4) Apply it without the uninstall and verify that it reached storage
+ * 5) Verify that a new SessionStore loads the sessions from the StoreClient
+ */
+TEST_F(SessionStoreTest, test_write_through) {
+  // 1) Create a SessionStore over a shared MemoryStoreClient
+  auto rule_store    = std::make_shared<StaticRuleStore>();
+  auto store_client  = std::make_shared<MemoryStoreClient>(rule_store);
+  auto session_store = std::make_unique<SessionStore>(rule_store, store_client);
+  auto session_vec   = SessionVector{};
+  session_vec.push_back(get_session(IMSI1, SESSION_ID_1, rule_store));
+  session_store->create_sessions(IMSI1, std::move(session_vec));
+
+  // 2) Reject an update that uninstalls a rule that is not installed
+  auto session_update     = SessionUpdate{};
+  auto uc                 = get_default_update_criteria();
+  uc.updated_pdp_end_time = 156789;
+  uc.static_rules_to_uninstall.insert(rule_id_2);
+  session_update[IMSI1][SESSION_ID_1] = uc;
+  EXPECT_FALSE(session_store->update_sessions(session_update));
+
+  // 3) Verify that none of the rejected update was applied
+  auto session_map = session_store->read_sessions(SessionRead{IMSI1});
+  EXPECT_EQ(session_map[IMSI1].size(), 1);
+  EXPECT_EQ(session_map[IMSI1].front()->get_pdp_end_time(), 0);
+
+  // 4) Apply it without the uninstall and verify that it reached storage
+  uc.static_rules_to_uninstall.clear();
+  session_update[IMSI1][SESSION_ID_1] = uc;
+  EXPECT_TRUE(session_store->update_sessions(session_update));
+  auto stored_map = store_client->read_sessions({IMSI1});
+  EXPECT_EQ(stored_map[IMSI1].size(), 1);
+  EXPECT_EQ(stored_map[IMSI1].front()->get_pdp_end_time(), 156789);
+
+  // 5) Verify that a new SessionStore loads the sessions from the StoreClient
+  session_store = std::make_unique<SessionStore>(rule_store, store_client);
+  session_map   = session_store->read_all_sessions();
+  EXPECT_EQ(session_map.size(), 1);
+  EXPECT_EQ(session_map[IMSI1].front()->get_session_id(), SESSION_ID_1);
+  EXPECT_EQ(session_map[IMSI1].front()->get_pdp_end_time(), 156789);
+}
+
+/**
+ * An update whose write to storage fails stays applied in memory, and the
+ * subscriber is written whole with the next write.
+ */
+TEST_F(SessionStoreTest, test_write_through_failed) {
+  auto rule_store    = std::make_shared<StaticRuleStore>();
+  auto store_client  = std::make_shared<FailingStoreClient>(rule_store);
+  auto session_store = std::make_unique<SessionStore>(rule_store, store_client);
+  auto session_vec   = SessionVector{};
+  session_vec.push_back(get_session(IMSI1, SESSION_ID_1, rule_store));
+  session_store->create_sessions(IMSI1, std::move(session_vec));
+  session_vec = SessionVector{};
+  session_vec.push_back(get_session(IMSI2, SESSION_ID_2, rule_store));
+  session_store->create_sessions(IMSI2, std::move(session_vec));
+
+  // The write fails, but the update is applied in memory
+  store_client->fail_writes = true;
+  auto session_update       = SessionUpdate{};
+  auto uc                   = get_default_update_criteria();
+  uc.updated_pdp_end_time   = 156789;
+  session_update[IMSI1][SESSION_ID_1] = uc;
+  EXPECT_FALSE(session_store->update_sessions(session_update));
+  auto session_map = session_store->read_sessions(SessionRead{IMSI1});
+  EXPECT_EQ(session_map[IMSI1].front()->get_pdp_end_time(), 156789);
+  auto stored_map = store_client->read_sessions({IMSI1});
+  EXPECT_EQ(stored_map[IMSI1].front()->get_pdp_end_time(), 0);
+
+  // The next write, for another subscriber, writes IMSI1 along, whole
+  store_client->fail_writes = false;
+  session_update.clear();
+  uc.updated_pdp_end_time             = 256789;
+  session_update[IMSI2][SESSION_ID_2] = uc;
+  EXPECT_TRUE(session_store->update_sessions(session_update));
+  EXPECT_EQ(store_client->last_written, std::set<std::string>({IMSI1, IMSI2}));
+  EXPECT_EQ(store_client->last_update.count(IMSI1), 0);
+  EXPECT_EQ(store_client->last_update.count(IMSI2), 1);
+  stored_map = store_client->read_sessions({IMSI1, IMSI2});
+  EXPECT_EQ(stored_map[IMSI1].front()->get_pdp_end_time(), 156789);
+  EXPECT_EQ(stored_map[IMSI2].front()->get_pdp_end_time(), 256789);
+
+  // Once written, IMSI1 is not written again
+  EXPECT_TRUE(session_store->update_sessions(session_update));
+  EXPECT_EQ(store_client->last_written, std::set<std::string>({IMSI2}));
+}
+
 TEST_F(SessionStoreTest, test_get_default_session_update) {
   // 1) Create a SessionMap with a few sessions
   auto rule_store        = std::make_shared<StaticRuleStore>();
@@ -649,6 +778,62 @@ TEST_F(SessionStoreTest, test_get_session) {
   EXPECT_FALSE(optional_it7);
 }
 
+/**
+ * 1) Create two LTE sessions for a subscriber in SessionStore
+ * 2) Find them by session ID, IP and TEID through the index
+ * 3) End the first session, which moves the second one in the index
+ * 4) Verify that sessions are still found in a copy read before the update
+ */
+TEST_F(SessionStoreTest, test_find_session_indexed) {
+  // 1) Create two LTE sessions for a subscriber in SessionStore
+  auto rule_store = std::make_shared<StaticRuleStore>();
+  SessionStore session_store(rule_store);
+  Teids teid3;
+  teid3.set_enb_teid(TEID_3_DL);
+  teid3.set_agw_teid(TEID_3_UL);
+  Teids teid4;
+  teid4.set_enb_teid(TEID_4_DL);
+  teid4.set_agw_teid(TEID_4_UL);
+  auto session_vec = SessionVector{};
+  session_vec.push_back(get_lte_session(
+      IMSI3, SESSION_ID_3, IP3, IPv6_3, teid3, "APN2", rule_store));
+  session_vec.push_back(get_lte_session(
+      IMSI3, SESSION_ID_4, IP4, IPv6_4, teid4, "APN2", rule_store));
+  session_store.create_sessions(IMSI3, std::move(session_vec));
+
+  // 2) Find them by session ID, IP and TEID through the index
+  auto session_map = session_store.read_all_sessions();
+  SessionSearchCriteria by_id(IMSI3, IMSI_AND_SESSION_ID, SESSION_ID_4);
+  SessionSearchCriteria by_ip(IMSI3, IMSI_AND_UE_IPV4_OR_IPV6, IPv6_4);
+  SessionSearchCriteria by_teid(IMSI3, IMSI_AND_TEID, TEID_4_UL);
+  SessionSearchCriteria by_missing_teid(IMSI3, IMSI_AND_TEID, 99);
+  for (const auto& criteria : {by_id, by_ip, by_teid}) {
+    auto session_it = session_store.find_session(session_map, criteria);
+    EXPECT_TRUE(session_it);
+    EXPECT_EQ((**session_it)->get_session_id(), SESSION_ID_4);
+  }
+  EXPECT_FALSE(session_store.find_session(session_map, by_missing_teid));
+
+  // 3) End the first session, which moves the second one in the index
+  auto session_update = SessionStore::get_default_session_update(session_map);
+  session_update[IMSI3][SESSION_ID_3].is_session_ended = true;
+  EXPECT_TRUE(session_store.update_sessions(session_update));
+  auto updated_map = session_store.read_all_sessions();
+  EXPECT_EQ(updated_map[IMSI3].size(), 1);
+  for (const auto& criteria : {by_id, by_ip, by_teid}) {
+    auto session_it = session_store.find_session(updated_map, criteria);
+    EXPECT_TRUE(session_it);
+    EXPECT_EQ((**session_it)->get_session_id(), SESSION_ID_4);
+  }
+  SessionSearchCriteria by_ended_id(IMSI3, IMSI_AND_SESSION_ID, SESSION_ID_3);
+  EXPECT_FALSE(session_store.find_session(updated_map, by_ended_id));
+
+  // 4) Verify that sessions are still found in a copy read before the update
+  for (const auto& criteria : {by_id, by_ip, by_teid, by_ended_id}) {
+    EXPECT_TRUE(session_store.find_session(session_map, criteria));
+  }
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -11,6 +11,7 @@
  * limitations under the License.
  */
 
+#include <map>
 #include <memory>
 
 #include <glog/logging.h>
@@ -21,6 +22,7 @@
 #include "RuleStore.h"
 #include "SessionID.h"
 #include "SessionState.h"
+#include "StoredSessionLayout.h"
 #include "magma_logging.h"
 #include "Consts.h"
 
@@ -29,8 +31,57 @@ using ::testing::Test;
 namespace magma {
 
 class StoreClientTest : public ::testing::Test {
+ protected:
+  // Run the writes like RedisStoreClient does, on a table and hashes in
+  // memory
+  void apply_writes(const StoreWrites& writes) {
+    for (const auto& it : writes.subscribers) {
+      if (it.second.empty()) {
+        table_.erase(it.first);
+      } else {
+        table_[it.first] = it.second;
+      }
+    }
+    for (const auto& key : writes.deleted_keys) {
+      hashes_.erase(key);
+    }
+    for (const auto& it : writes.set_fields) {
+      for (const auto& field : it.second) {
+        hashes_[it.first][field.first] = field.second;
+      }
+    }
+    for (const auto& it : writes.deleted_fields) {
+      for (const auto& field : it.second) {
+        hashes_[it.first].erase(field);
+      }
+    }
+  }
+
+  std::vector<StoredSessionState> read_subscriber(
+      StoredSessionLayout& layout, const std::string& imsi) {
+    std::vector<StoredSessionState> sessions;
+    std::vector<std::string> session_ids;
+    layout.read_subscriber(imsi, table_[imsi], sessions, session_ids);
+    for (const auto& session_id : session_ids) {
+      std::vector<std::string> values;
+      for (const auto& field : hashes_[layout.get_session_key(session_id)]) {
+        values.push_back(field.second);
+      }
+      sessions.push_back(layout.read_session(values));
+    }
+    return sessions;
+  }
+
+  std::string to_string(const StoredSessionState& stored) {
+    SessionRecord record;
+    serialize_stored_session(stored, &record);
+    return record.DebugString();
+  }
+
  protected:
   SessionIDGenerator id_gen_;
+  std::map<std::string, std::string> table_;
+  std::map<std::string, std::map<std::string, std::string>> hashes_;
 };
 
 /**
@@ -147,6 +198,178 @@ TEST_F(StoreClientTest, test_read_and_write) {
       response3.DebugString());
 }
 
+/**
+ * StoredSessionLayout writes a new subscriber whole, then only the parts of
+ * its sessions that the update criteria change, and reads back the same
+ * sessions.
+ */
+TEST_F(StoreClientTest, test_stored_session_layout) {
+  std::string imsi = "IMSI1";
+  auto sid         = id_gen_.gen_session_id(imsi);
+  auto sid2        = id_gen_.gen_session_id(imsi);
+  auto rule_store  = std::make_shared<StaticRuleStore>();
+  SessionConfig cfg;
+  cfg.common_context =
+      build_common_context(imsi, "128.0.0.1", "", Teids{}, "APN", "", TGPP_LTE);
+
+  StoredSessionLayout layout("sessions");
+  SessionMap session_map;
+  session_map[imsi].push_back(std::make_unique<SessionState>(
+      imsi, sid, cfg, *rule_store, TgppContext{}, 0, CreateSessionResponse{}));
+  session_map[imsi].push_back(std::make_unique<SessionState>(
+      imsi, sid2, cfg, *rule_store, TgppContext{}, 0, CreateSessionResponse{}));
+  auto& session = session_map[imsi].front();
+  auto key      = layout.get_session_key(sid);
+  auto uc       = get_default_update_criteria();
+  CreditUpdateResponse charge_resp;
+  create_credit_update_response(imsi, sid, 1, 1000, &charge_resp);
+  session->receive_charging_credit(charge_resp, uc);
+  create_credit_update_response(imsi, sid, 2, 2000, &charge_resp);
+  session->receive_charging_credit(charge_resp, uc);
+
+  // A new subscriber is written whole
+  auto writes = layout.get_writes(session_map, SessionUpdate{});
+  EXPECT_EQ(writes.subscribers.count(imsi), 1);
+  EXPECT_EQ(writes.set_fields[key].size(), 3);
+  auto whole_bytes = writes.get_bytes();
+  apply_writes(writes);
+  layout.set_written(session_map);
+
+  // Only the credit the update criteria change is written
+  uc = get_default_update_criteria();
+  EXPECT_TRUE(session->set_credit_reporting(CreditKey(1), true, &uc));
+  SessionUpdate update;
+  update[imsi][sid] = uc;
+  writes            = layout.get_writes(session_map, update);
+  EXPECT_EQ(writes.subscribers.size(), 0);
+  EXPECT_EQ(writes.deleted_keys.size(), 0);
+  EXPECT_EQ(writes.deleted_fields.size(), 0);
+  EXPECT_EQ(writes.set_fields.size(), 1);
+  EXPECT_EQ(writes.set_fields[key].size(), 1);
+  EXPECT_EQ(writes.set_fields[key].front().first, "credit:1:0");
+  EXPECT_LT(writes.get_bytes(), whole_bytes);
+  apply_writes(writes);
+  layout.set_written(session_map);
+
+  // After a restart, the sessions read back are the ones written
+  StoredSessionLayout restarted_layout("sessions");
+  auto stored_sessions = read_subscriber(restarted_layout, imsi);
+  EXPECT_EQ(stored_sessions.size(), 2);
+  EXPECT_EQ(to_string(stored_sessions[0]), to_string(session->marshal()));
+  EXPECT_EQ(
+      to_string(stored_sessions[1]),
+      to_string(session_map[imsi].back()->marshal()));
+  EXPECT_TRUE(stored_sessions[0].credit_map[CreditKey(1)].credit.reporting);
+
+  // Ending a session deletes its hash and updates the subscriber
+  uc                  = get_default_update_criteria();
+  uc.is_session_ended = true;
+  update.clear();
+  update[imsi][sid] = uc;
+  session_map[imsi].erase(session_map[imsi].begin());
+  writes = restarted_layout.get_writes(session_map, update);
+  EXPECT_EQ(writes.subscribers.count(imsi), 1);
+  EXPECT_EQ(writes.deleted_keys, std::vector<std::string>{key});
+  EXPECT_EQ(writes.set_fields.size(), 0);
+  apply_writes(writes);
+  restarted_layout.set_written(session_map);
+  EXPECT_EQ(hashes_.count(key), 0);
+  EXPECT_EQ(read_subscriber(restarted_layout, imsi).size(), 1);
+
+  // Subscribers stored inline by older sessiond are written whole
+  std::vector<StoredSessionState> inline_sessions;
+  inline_sessions.push_back(session_map[imsi].front()->marshal());
+  table_[imsi] = serialize_stored_session_vec(inline_sessions);
+  hashes_.clear();
+  stored_sessions = read_subscriber(restarted_layout, imsi);
+  EXPECT_EQ(stored_sessions.size(), 1);
+  update.clear();
+  update[imsi][sid2] = get_default_update_criteria();
+  writes             = restarted_layout.get_writes(session_map, update);
+  EXPECT_EQ(writes.subscribers.count(imsi), 1);
+  EXPECT_EQ(writes.set_fields[layout.get_session_key(sid2)].size(), 1);
+}
+
+/**
+ * After a failed write, StoredSessionLayout writes the subscriber whole, as
+ * the update criteria of the failed write are not written again
+ */
+TEST_F(StoreClientTest, test_stored_session_layout_write_failed) {
+  std::string imsi = "IMSI1";
+  auto sid         = id_gen_.gen_session_id(imsi);
+  auto sid2        = id_gen_.gen_session_id(imsi);
+  auto rule_store  = std::make_shared<StaticRuleStore>();
+  SessionConfig cfg;
+  cfg.common_context =
+      build_common_context(imsi, "128.0.0.1", "", Teids{}, "APN", "", TGPP_LTE);
+
+  StoredSessionLayout layout("sessions");
+  SessionMap session_map;
+  session_map[imsi].push_back(std::make_unique<SessionState>(
+      imsi, sid, cfg, *rule_store, TgppContext{}, 0, CreateSessionResponse{}));
+  auto& session = session_map[imsi].front();
+  auto key      = layout.get_session_key(sid);
+  auto uc       = get_default_update_criteria();
+  CreditUpdateResponse charge_resp;
+  create_credit_update_response(imsi, sid, 1, 1000, &charge_resp);
+  session->receive_charging_credit(charge_resp, uc);
+  create_credit_update_response(imsi, sid, 2, 2000, &charge_resp);
+  session->receive_charging_credit(charge_resp, uc);
+  apply_writes(layout.get_writes(session_map, SessionUpdate{}));
+  layout.set_written(session_map);
+
+  // The write of the change to credit 1 fails
+  uc = get_default_update_criteria();
+  EXPECT_TRUE(session->set_credit_reporting(CreditKey(1), true, &uc));
+  SessionUpdate update;
+  update[imsi][sid] = uc;
+  auto writes       = layout.get_writes(session_map, update);
+  EXPECT_EQ(writes.set_fields[key].size(), 1);
+  layout.set_write_failed(session_map);
+
+  // The next write only comes with the change to credit 2, but the
+  // subscriber is written whole
+  uc = get_default_update_criteria();
+  EXPECT_TRUE(session->set_credit_reporting(CreditKey(2), true, &uc));
+  update.clear();
+  update[imsi][sid] = uc;
+  writes            = layout.get_writes(session_map, update);
+  EXPECT_EQ(writes.subscribers.count(imsi), 1);
+  EXPECT_EQ(writes.deleted_keys, std::vector<std::string>{key});
+  EXPECT_EQ(writes.set_fields[key].size(), 3);
+  apply_writes(writes);
+  layout.set_written(session_map);
+  auto stored_sessions = read_subscriber(layout, imsi);
+  EXPECT_EQ(stored_sessions.size(), 1);
+  EXPECT_EQ(to_string(stored_sessions[0]), to_string(session->marshal()));
+  EXPECT_TRUE(stored_sessions[0].credit_map[CreditKey(1)].credit.reporting);
+
+  // Once written, only the changes are written again
+  writes = layout.get_writes(session_map, update);
+  EXPECT_EQ(writes.subscribers.size(), 0);
+  EXPECT_EQ(writes.set_fields[key].size(), 1);
+
+  // A write replacing the session fails, whether or not it was committed.
+  // The next write deletes the hashes of both sessions it doesn't write
+  session_map[imsi].clear();
+  session_map[imsi].push_back(std::make_unique<SessionState>(
+      imsi, sid2, cfg, *rule_store, TgppContext{}, 0, CreateSessionResponse{}));
+  apply_writes(layout.get_writes(session_map, SessionUpdate{}));
+  layout.set_write_failed(session_map);
+  update.clear();
+  update[imsi][sid2] = get_default_update_criteria();
+  session_map[imsi].clear();
+  writes = layout.get_writes(session_map, update);
+  EXPECT_EQ(writes.subscribers.count(imsi), 1);
+  EXPECT_EQ(
+      writes.deleted_keys,
+      std::vector<std::string>({key, layout.get_session_key(sid2)}));
+  apply_writes(writes);
+  layout.set_written(session_map);
+  EXPECT_EQ(hashes_.size(), 0);
+  EXPECT_EQ(table_.count(imsi), 0);
+}
+
 TEST_F(StoreClientTest, test_lambdas) {
   auto sm = std::make_unique<int>(1);
 
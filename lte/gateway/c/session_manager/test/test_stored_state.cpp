@@ -349,6 +349,78 @@ TEST_F(StoredStateTest, test_stored_session) {
   EXPECT_EQ(deserialized.pdp_end_time, 332211);
 }
 
+TEST_F(StoredStateTest, test_stored_session_vec) {
+  auto stored = std::vector<StoredSessionState>{get_stored_session()};
+  PolicyRule dynamic_rule;
+  dynamic_rule.set_id("rule2");
+  stored[0].dynamic_rules.push_back(dynamic_rule);
+  stored[0].static_rule_ids.push_back("rule1");
+
+  auto serialized   = serialize_stored_session_vec(stored);
+  auto deserialized = deserialize_stored_session_vec(serialized);
+  EXPECT_EQ(deserialized.size(), 1);
+  // The binary encoding is a fraction of the JSON one
+  EXPECT_LT(2 * serialized.size(), serialize_stored_session(stored[0]).size());
+
+  auto& session               = deserialized[0];
+  auto stored_charging_credit = session.credit_map[CreditKey(1, 2)];
+  EXPECT_EQ(stored_charging_credit.is_final, true);
+  EXPECT_EQ(
+      stored_charging_credit.final_action_info.redirect_server
+          .redirect_server_address(),
+      "redirect_server_address");
+  EXPECT_EQ(stored_charging_credit.reauth_state, REAUTH_REQUIRED);
+  EXPECT_EQ(stored_charging_credit.service_state, SERVICE_NEEDS_ACTIVATION);
+  EXPECT_EQ(stored_charging_credit.expiry_time, 32);
+  EXPECT_EQ(stored_charging_credit.credit.buckets[USED_TX], 12345);
+  EXPECT_EQ(stored_charging_credit.credit.buckets[ALLOWED_TOTAL], 54321);
+  EXPECT_EQ(stored_charging_credit.credit.grant_tracking_type, TX_ONLY);
+
+  auto stored_monitor = session.monitor_map["mk1"];
+  EXPECT_EQ(stored_monitor.credit.reporting, true);
+  EXPECT_EQ(stored_monitor.credit.credit_limit_type, INFINITE_METERED);
+  EXPECT_EQ(stored_monitor.level, MonitoringLevel::PCC_RULE_LEVEL);
+
+  EXPECT_EQ(session.session_level_key, "session_level_key");
+  EXPECT_EQ(session.imsi, "IMSI1");
+  EXPECT_EQ(session.session_id, "session_id");
+  EXPECT_EQ(
+      session.config.common_context.SerializeAsString(),
+      stored[0].config.common_context.SerializeAsString());
+  EXPECT_EQ(session.fsm_state, SESSION_RELEASED);
+  EXPECT_EQ(session.tgpp_context.gy_dest_host(), "gy");
+  EXPECT_EQ(session.pending_event_triggers[REVALIDATION_TIMEOUT], READY);
+  EXPECT_EQ(session.revalidation_time.seconds(), 32);
+  EXPECT_EQ(session.bearer_id_by_policy[PolicyID(DYNAMIC, "rule1")], 32);
+  EXPECT_EQ(session.bearer_id_by_policy[PolicyID(STATIC, "rule1")], 64);
+  EXPECT_EQ(session.static_rule_ids, stored[0].static_rule_ids);
+  EXPECT_EQ(session.dynamic_rules.size(), 1);
+  EXPECT_EQ(session.dynamic_rules[0].id(), "rule2");
+  EXPECT_EQ(session.request_number, 1);
+  EXPECT_EQ(session.pdp_start_time, 112233);
+  EXPECT_EQ(session.pdp_end_time, 332211);
+}
+
+TEST_F(StoredStateTest, test_stored_session_vec_migration) {
+  // Value written by sessiond before the binary encoding
+  auto stored              = get_stored_session();
+  folly::dynamic marshaled = folly::dynamic::array;
+  marshaled.push_back(serialize_stored_session(stored));
+
+  auto deserialized = deserialize_stored_session_vec(folly::toJson(marshaled));
+  EXPECT_EQ(deserialized.size(), 1);
+  EXPECT_EQ(deserialized[0].imsi, "IMSI1");
+  EXPECT_EQ(deserialized[0].credit_map[CreditKey(1, 2)].expiry_time, 32);
+  EXPECT_EQ(deserialized[0].monitor_map["mk1"].credit.buckets[USED_TX], 12345);
+  EXPECT_EQ(deserialized[0].request_number, 1);
+
+  // Records of a later version can't be read
+  SessionRecords records;
+  records.set_version(STORED_SESSIONS_VERSION + 1);
+  EXPECT_ANY_THROW(deserialize_stored_session_vec(records.SerializeAsString()));
+  EXPECT_ANY_THROW(deserialize_stored_session_vec("\xff\xff"));
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -27,6 +27,7 @@ from magma.mobilityd.serialize_utils import deserialize_ip_block, \
 
 from lte.protos.keyval_pb2 import IPDesc
 from lte.protos.policydb_pb2 import PolicyRule, InstalledPolicies
+from lte.protos.sessiond_state_pb2 import SessionRecords
 from lte.protos.oai.mme_nas_state_pb2 import MmeNasState, UeContext
 from lte.protos.oai.spgw_state_pb2 import SpgwState, S11BearerContext
 from lte.protos.oai.s1ap_state_pb2 import S1apState, UeDescription
@@ -37,6 +38,7 @@ NO_DESERIAL_MSG = "No deserializer exists for type '{}'"
 def _deserialize_session_json(serialized_json_str: bytes) -> str:
     """
     Helper function to deserialize sessiond:sessions hash list values
+    written as JSON by older sessiond
     :param serialized_json_str
     """
     res = _deserialize_generic_json(str(serialized_json_str, 'utf-8', 'ignore'))
@@ -44,6 +46,18 @@ def _deserialize_session_json(serialized_json_str: bytes) -> str:
     return dumped
 
 
+def _deserialize_session(serialized: bytes) -> Union[str, SessionRecords]:
+    """
+    Helper function to deserialize sessiond:sessions hash list values
+    :param serialized: SessionRecords, or JSON array of sessions
+    """
+    if serialized.startswith(b'['):
+        return _deserialize_session_json(serialized)
+    records = SessionRecords()
+    records.ParseFromString(serialized)
+    return records
+
+
 def _deserialize_generic_json(
         element: Union[str, dict, list])-> Union[str, dict, list]:
     """
@@ -83,7 +97,7 @@ class StateCLI(object):
     STATE_DESERIALIZERS = {
         'assigned_ip_blocks': deserialize_ip_block,
         'ip_states': deserialize_ip_desc,
-        'sessions': _deserialize_session_json,
+        'sessions': _deserialize_session,
         'rule_names': get_json_deserializer(),
         'rule_ids': get_json_deserializer(),
         'rule_versions': get_json_deserializer(),